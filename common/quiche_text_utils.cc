@@ -4,6 +4,11 @@
 
 #include "common/quiche_text_utils.h"
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#include "absl/strings/ascii.h"
 #include "absl/strings/escaping.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
@@ -40,6 +45,29 @@ absl::optional<std::string> QuicheTextUtils::Base64Decode(
 }
 
 // static
+bool QuicheTextUtils::ContainsUpperCase(absl::string_view data) {
+  constexpr uint64_t kOnes = 0x0101010101010101u;
+  constexpr uint64_t kHighBits = kOnes * 0x80;
+  constexpr uint64_t kLowBits = kOnes * 0x7f;
+  const char* next = data.data();
+  const char* const end = data.data() + data.size();
+  for (; end - next >= 8; next += 8) {
+    uint64_t word;
+    memcpy(&word, next, sizeof(word));
+    // Sets the high bit of each byte which is greater than 'A' - 1, less than
+    // 'Z' + 1 and has its own high bit clear.  No byte borrows from or carries
+    // into its neighbours, as the high bits are masked out first.  See
+    // "Determine if a word has a byte between m and n" in Bit Twiddling Hacks.
+    const uint64_t low = word & kLowBits;
+    const uint64_t below_z = kOnes * (0x7f + 'Z' + 1) - low;
+    const uint64_t above_a = low + kOnes * (0x7f - ('A' - 1));
+    if (below_z & above_a & ~word & kHighBits) {
+      return true;
+    }
+  }
+  return std::any_of(next, end, absl::ascii_isupper);
+}
+
 std::string QuicheTextUtils::HexDump(absl::string_view binary_data) {
   const int kBytesPerLine = 16;  // Maximum bytes dumped per line.
   int offset = 0;
@@ -44,10 +44,9 @@ class QUICHE_EXPORT QuicheTextUtils {
   // "0x0000:  4865 6c6c 6f2c 2051 5549 4321 0102 0304  Hello,.QUIC!...."
   static std::string HexDump(absl::string_view binary_data);
 
-  // Returns true if |data| contains any uppercase characters.
-  static bool ContainsUpperCase(absl::string_view data) {
-    return std::any_of(data.begin(), data.end(), absl::ascii_isupper);
-  }
+  // Returns true if |data| contains any uppercase characters.  Checks eight
+  // characters at a time, as it is called on every received header name.
+  static bool ContainsUpperCase(absl::string_view data);
 
   // Returns true if |data| contains only decimal digits.
   static bool IsAllDigits(absl::string_view data) {
@@ -6,7 +6,9 @@
 
 #include <string>
 
+#include "absl/strings/ascii.h"
 #include "absl/strings/escaping.h"
+#include "absl/strings/string_view.h"
 #include "common/platform/api/quiche_test.h"
 
 namespace quiche {
@@ -88,5 +90,23 @@ TEST(QuicheTextUtilsTest, ContainsUpperCase) {
   EXPECT_TRUE(quiche::QuicheTextUtils::ContainsUpperCase("aBc"));
 }
 
+TEST(QuicheTextUtilsTest, ContainsUpperCaseEveryByteAndPosition) {
+  // Long enough to be checked both eight bytes at a time and in the tail.
+  std::string data(19, 'a');
+  for (size_t position = 0; position < data.size(); ++position) {
+    for (int c = 0; c < 256; ++c) {
+      data[position] = static_cast<char>(c);
+      EXPECT_EQ(absl::ascii_isupper(static_cast<unsigned char>(c)),
+                quiche::QuicheTextUtils::ContainsUpperCase(data))
+          << "position " << position << " byte " << c;
+      EXPECT_EQ(absl::ascii_isupper(static_cast<unsigned char>(c)),
+                quiche::QuicheTextUtils::ContainsUpperCase(
+                    absl::string_view(data).substr(0, position + 1)))
+          << "position " << position << " byte " << c;
+    }
+    data[position] = 'a';
+  }
+}
+
 }  // namespace test
 }  // namespace quiche
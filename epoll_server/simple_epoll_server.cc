@@ -107,7 +107,8 @@ SimpleEpollServer::SimpleEpollServer()
       write_fd_(-1),
       in_wait_for_events_and_execute_callbacks_(false),
       in_shutdown_(false),
-      last_delay_in_usec_(0) {
+      last_delay_in_usec_(0),
+      profiling_enabled_(false) {
   // ensure that the epoll_fd_ is valid.
   CHECK_NE(epoll_fd_, -1);
   LIST_INIT(&ready_list_);
@@ -352,10 +353,15 @@ void SimpleEpollServer::WaitForEventsAndExecuteCallbacks() {
   }
   AutoReset<bool> recursion_guard(&in_wait_for_events_and_execute_callbacks_,
                                   true);
+  const int64_t iteration_start_us = profiling_enabled_ ? NowInUsec() : 0;
   if (alarm_map_.empty()) {
     // no alarms, this is business as usual.
     WaitForEventsAndCallHandleEvents(timeout_in_us_, events_, events_size_);
     recorded_now_in_us_ = 0;
+    if (profiling_enabled_) {
+      ++loop_stats_.iterations;
+      loop_stats_.iteration_time_us += NowInUsec() - iteration_start_us;
+    }
     return;
   }
 
@@ -392,6 +398,10 @@ void SimpleEpollServer::WaitForEventsAndExecuteCallbacks() {
   WaitForEventsAndCallHandleEvents(wait_time_in_us, events_, events_size_);
   CallAndReregisterAlarmEvents();
   recorded_now_in_us_ = 0;
+  if (profiling_enabled_) {
+    ++loop_stats_.iterations;
+    loop_stats_.iteration_time_us += NowInUsec() - iteration_start_us;
+  }
 }
 
 void SimpleEpollServer::SetFDReady(int fd, int events_to_fake) {
@@ -633,7 +643,8 @@ void SimpleEpollServer::WaitForEventsAndCallHandleEvents(
     }
   }
   const int timeout_in_ms = timeout_in_us / 1000;
-  int64_t expected_wakeup_us = NowInUsec() + timeout_in_us;
+  const int64_t wait_start_us = NowInUsec();
+  int64_t expected_wakeup_us = wait_start_us + timeout_in_us;
 
   int nfds = epoll_wait_impl(epoll_fd_, events, events_size, timeout_in_ms);
   EPOLL_VLOG(3) << "nfds=" << nfds;
@@ -650,6 +661,9 @@ void SimpleEpollServer::WaitForEventsAndCallHandleEvents(
   // done epoll_wait, which guarantees that the maximum error is the amount of
   // time it takes to process all the events generated by epoll_wait.
   recorded_now_in_us_ = NowInUsec();
+  if (profiling_enabled_) {
+    loop_stats_.wait_time_us += recorded_now_in_us_ - wait_start_us;
+  }
 
   if (timeout_in_us > 0) {
     int64_t delta = NowInUsec() - expected_wakeup_us;
@@ -708,7 +722,11 @@ void SimpleEpollServer::CallReadyListCallbacks() {
         // invalidating the cb_and_mask object (by deleting the object in the
         // map to which cb_and_mask refers)
         AutoReset<bool> in_use_guard(&(cb_and_mask->in_use), true);
+        const int64_t start_us = profiling_enabled_ ? NowInUsec() : 0;
         cb_and_mask->cb->OnEvent(cb_and_mask->fd, &event);
+        if (profiling_enabled_) {
+          RecordFDCallback(*cb_and_mask, start_us);
+        }
       }
 
       // Since OnEvent may have called UnregisterFD, we must check here that
@@ -747,7 +765,11 @@ void SimpleEpollServer::CallAndReregisterAlarmEvents() {
       continue;
     }
     all_alarms_.erase(cb);
+    const int64_t start_us = profiling_enabled_ ? NowInUsec() : 0;
     const int64_t new_timeout_time_in_us = cb->OnAlarm();
+    if (profiling_enabled_) {
+      RecordAlarm(i->first, start_us);
+    }
 
     erase_it = i;
     ++i;
@@ -770,6 +792,64 @@ void SimpleEpollServer::CallAndReregisterAlarmEvents() {
   alarms_reregistered_and_should_be_skipped_.clear();
 }
 
+void SimpleEpollServer::RecordFDCallback(const CBAndEventMask& cb_and_mask,
+                                         int64_t start_us) {
+  const int64_t duration_us = NowInUsec() - start_us;
+  ++loop_stats_.num_fd_callbacks;
+  loop_stats_.fd_callback_time_us += duration_us;
+
+  // Name() is only called for callbacks which make it into the list, which
+  // keeps the common case free of allocations.
+  std::vector<LoopStats::SlowCallback>& slowest =
+      loop_stats_.slowest_callbacks;
+  if (slowest.size() == LoopStats::kMaxSlowestCallbacks &&
+      duration_us <= slowest.back().duration_us) {
+    return;
+  }
+  LoopStats::SlowCallback slow_callback;
+  slow_callback.name =
+      cb_and_mask.cb == NULL ? "(unregistered)" : cb_and_mask.cb->Name();
+  slow_callback.fd = cb_and_mask.fd;
+  slow_callback.duration_us = duration_us;
+  auto it = std::upper_bound(
+      slowest.begin(), slowest.end(), duration_us,
+      [](int64_t duration, const LoopStats::SlowCallback& other) {
+        return duration > other.duration_us;
+      });
+  slowest.insert(it, std::move(slow_callback));
+  if (slowest.size() > LoopStats::kMaxSlowestCallbacks) {
+    slowest.pop_back();
+  }
+}
+
+void SimpleEpollServer::RecordAlarm(int64_t scheduled_time_us,
+                                    int64_t start_us) {
+  const int64_t duration_us = NowInUsec() - start_us;
+  ++loop_stats_.num_alarms;
+  loop_stats_.alarm_time_us += duration_us;
+  loop_stats_.max_alarm_time_us =
+      std::max(loop_stats_.max_alarm_time_us, duration_us);
+
+  const int64_t lateness_us =
+      std::max(start_us - scheduled_time_us, static_cast<int64_t>(0));
+  loop_stats_.max_alarm_lateness_us =
+      std::max(loop_stats_.max_alarm_lateness_us, lateness_us);
+  int bucket = 0;
+  for (int64_t remaining = lateness_us;
+       remaining > 0 && bucket < LoopStats::kNumAlarmLatenessBuckets - 1;
+       remaining >>= 1) {
+    ++bucket;
+  }
+  ++loop_stats_.alarm_lateness_histogram[bucket];
+}
+
+double SimpleEpollServer::LoopStats::Utilization() const {
+  if (iteration_time_us <= 0) {
+    return 0;
+  }
+  return 1.0 - static_cast<double>(wait_time_us) / iteration_time_us;
+}
+
 EpollAlarm::EpollAlarm() : eps_(NULL), registered_(false) {}
 
 EpollAlarm::~EpollAlarm() { UnregisterIfRegistered(); }
@@ -501,6 +501,60 @@ class EPOLL_EXPORT_PRIVATE SimpleEpollServer {
 
   int64_t LastDelayInUsec() const { return last_delay_in_usec_; }
 
+  // Summary:
+  //   Accounting of the work done by WaitForEventsAndExecuteCallbacks(),
+  //   collected while profiling is enabled.  All times are in microseconds as
+  //   measured by NowInUsec().
+  struct EPOLL_EXPORT_PRIVATE LoopStats {
+    // Maximum number of entries kept in |slowest_callbacks|.
+    static constexpr size_t kMaxSlowestCallbacks = 8;
+    // Alarm lateness is recorded in power-of-two buckets: bucket 0 counts
+    // alarms which ran on time, bucket i > 0 counts alarms which ran between
+    // 2^(i-1) and 2^i - 1 microseconds late.  The last bucket also counts
+    // everything later than that.
+    static constexpr int kNumAlarmLatenessBuckets = 24;
+
+    struct SlowCallback {
+      // The Name() of the callback, or "(unregistered)" if the callback
+      // unregistered itself from within OnEvent().
+      std::string name;
+      int fd;
+      int64_t duration_us;
+    };
+
+    // Returns the fraction of the time spent in
+    // WaitForEventsAndExecuteCallbacks() which was not spent in epoll_wait.
+    double Utilization() const;
+
+    int64_t iterations = 0;
+    // Total time spent in WaitForEventsAndExecuteCallbacks().
+    int64_t iteration_time_us = 0;
+    // Time spent in epoll_wait.
+    int64_t wait_time_us = 0;
+    // Time spent in EpollCallbackInterface::OnEvent().
+    int64_t fd_callback_time_us = 0;
+    // Time spent in EpollAlarmCallbackInterface::OnAlarm().
+    int64_t alarm_time_us = 0;
+    int64_t num_fd_callbacks = 0;
+    int64_t num_alarms = 0;
+    int64_t max_alarm_time_us = 0;
+    int64_t max_alarm_lateness_us = 0;
+    int64_t alarm_lateness_histogram[kNumAlarmLatenessBuckets] = {};
+    // The slowest OnEvent() calls seen, slowest first.
+    std::vector<SlowCallback> slowest_callbacks;
+  };
+
+  // Summary:
+  //   Enables or disables collection of LoopStats.  Profiling adds two
+  //   NowInUsec() calls per callback and alarm, and is disabled by default.
+  void set_profiling_enabled(bool profiling_enabled) {
+    profiling_enabled_ = profiling_enabled;
+  }
+  bool profiling_enabled() const { return profiling_enabled_; }
+
+  const LoopStats& loop_stats() const { return loop_stats_; }
+  void ResetLoopStats() { loop_stats_ = LoopStats(); }
+
  protected:
   virtual void SetNonblocking(int fd);
 
@@ -944,6 +998,10 @@ class EPOLL_EXPORT_PRIVATE SimpleEpollServer {
   void CleanupFDToCBMap();
   void CleanupTimeToAlarmCBMap();
 
+  // Helper functions used to collect LoopStats.
+  void RecordFDCallback(const CBAndEventMask& cb_and_mask, int64_t start_us);
+  void RecordAlarm(int64_t scheduled_time_us, int64_t start_us);
+
   // The callback registered to the fds below.  As the purpose of their
   // registration is to wake the epoll server it just clears the pipe and
   // returns.
@@ -964,6 +1022,9 @@ class EPOLL_EXPORT_PRIVATE SimpleEpollServer {
   // Returns true when the SimpleEpollServer() is being destroyed.
   bool in_shutdown_;
   int64_t last_delay_in_usec_;
+
+  bool profiling_enabled_;
+  LoopStats loop_stats_;
 };
 
 class EpollAlarmCallbackInterface {
@@ -2515,6 +2515,131 @@ TEST(SimpleEpollServerAlarmTest, TestThatSameAlarmCanNotBeRegisteredTwice) {
                    "Alarm already exists");
 }
 
+// A callback which advances the fake clock by a fixed amount in OnEvent().
+class AdvanceClockOnEvent : public EpollCallbackInterface {
+ public:
+  explicit AdvanceClockOnEvent(int64_t cost_us)
+      : feps_(nullptr), cost_us_(cost_us) {}
+
+  void OnRegistration(SimpleEpollServer* /*eps*/, int /*fd*/,
+                      int /*event_mask*/) override {}
+  void OnModification(int /*fd*/, int /*event_mask*/) override {}
+  void OnEvent(int /*fd*/, EpollEvent* /*event*/) override {
+    feps_->AdvanceBy(cost_us_);
+  }
+  void OnUnregistration(int /*fd*/, bool /*replaced*/) override {}
+  void OnShutdown(SimpleEpollServer* /*eps*/, int /*fd*/) override {}
+  std::string Name() const override { return "AdvanceClockOnEvent"; }
+
+  void set_fakeepollserver(FakeSimpleEpollServer* feps) { feps_ = feps; }
+
+ private:
+  FakeSimpleEpollServer* feps_;
+  int64_t cost_us_;
+};
+
+// An alarm which advances the fake clock by a fixed amount in OnAlarm().
+class AdvanceClockOnAlarm : public EpollAlarm {
+ public:
+  AdvanceClockOnAlarm(FakeSimpleEpollServer* feps, int64_t cost_us)
+      : feps_(feps), cost_us_(cost_us) {}
+
+  int64_t OnAlarm() override {
+    feps_->AdvanceBy(cost_us_);
+    return EpollAlarm::OnAlarm();
+  }
+
+ private:
+  FakeSimpleEpollServer* feps_;
+  int64_t cost_us_;
+};
+
+TEST(SimpleEpollServerTest, LoopStats) {
+  const int kFd = 11111;
+  AdvanceClockOnEvent cb(200);
+  FakeSimpleEpollServer epoll_server;
+  cb.set_fakeepollserver(&epoll_server);
+  AdvanceClockOnAlarm alarm(&epoll_server, 300);
+  epoll_server.RegisterFD(kFd, &cb, EPOLLIN);
+  epoll_server.set_timeout_in_us(10000);
+  epoll_server.set_now_in_usec(1000);
+  epoll_server.RegisterAlarm(2000, &alarm);
+
+  epoll_event ee;
+  ee.data.fd = kFd;
+  ee.events = EPOLLIN;
+
+  // Nothing is recorded while profiling is disabled.
+  EXPECT_FALSE(epoll_server.profiling_enabled());
+  epoll_server.AddEvent(1000, ee);
+  epoll_server.WaitForEventsAndExecuteCallbacks();
+  EXPECT_EQ(0, epoll_server.loop_stats().iterations);
+  EXPECT_EQ(0, epoll_server.loop_stats().num_fd_callbacks);
+
+  // The event is delivered immediately and takes 200us to handle.
+  epoll_server.set_profiling_enabled(true);
+  epoll_server.set_now_in_usec(1000);
+  epoll_server.AddEvent(1000, ee);
+  epoll_server.WaitForEventsAndExecuteCallbacks();
+  EXPECT_EQ(1200, epoll_server.NowInUsec());
+  EXPECT_TRUE(alarm.registered());
+
+  // epoll_wait sleeps for 1ms, after which the alarm runs 200us late and
+  // takes 300us.
+  epoll_server.WaitForEventsAndExecuteCallbacks();
+  EXPECT_EQ(2500, epoll_server.NowInUsec());
+  EXPECT_FALSE(alarm.registered());
+
+  const SimpleEpollServer::LoopStats& stats = epoll_server.loop_stats();
+  EXPECT_EQ(2, stats.iterations);
+  EXPECT_EQ(1500, stats.iteration_time_us);
+  EXPECT_EQ(1000, stats.wait_time_us);
+  EXPECT_EQ(1, stats.num_fd_callbacks);
+  EXPECT_EQ(200, stats.fd_callback_time_us);
+  EXPECT_EQ(1, stats.num_alarms);
+  EXPECT_EQ(300, stats.alarm_time_us);
+  EXPECT_EQ(300, stats.max_alarm_time_us);
+  EXPECT_EQ(200, stats.max_alarm_lateness_us);
+  // 200us falls into the [128, 255] bucket.
+  EXPECT_EQ(1, stats.alarm_lateness_histogram[8]);
+  EXPECT_NEAR(1.0 / 3, stats.Utilization(), 1e-9);
+  ASSERT_EQ(1u, stats.slowest_callbacks.size());
+  EXPECT_EQ("AdvanceClockOnEvent", stats.slowest_callbacks[0].name);
+  EXPECT_EQ(kFd, stats.slowest_callbacks[0].fd);
+  EXPECT_EQ(200, stats.slowest_callbacks[0].duration_us);
+
+  epoll_server.ResetLoopStats();
+  EXPECT_EQ(0, epoll_server.loop_stats().iterations);
+  EXPECT_TRUE(epoll_server.loop_stats().slowest_callbacks.empty());
+}
+
+TEST(SimpleEpollServerTest, LoopStatsKeepsSlowestCallbacks) {
+  std::vector<std::unique_ptr<AdvanceClockOnEvent>> callbacks;
+  FakeSimpleEpollServer epoll_server;
+  epoll_server.set_profiling_enabled(true);
+  const size_t kNumCallbacks =
+      SimpleEpollServer::LoopStats::kMaxSlowestCallbacks + 4;
+  for (size_t i = 0; i < kNumCallbacks; ++i) {
+    const int fd = 100 + i;
+    callbacks.push_back(EpollMakeUnique<AdvanceClockOnEvent>(10 * (i + 1)));
+    callbacks.back()->set_fakeepollserver(&epoll_server);
+    epoll_server.RegisterFD(fd, callbacks.back().get(), EPOLLIN);
+    epoll_server.SetFDReady(fd, EPOLLIN);
+  }
+  epoll_server.CallReadyListCallbacks();
+
+  const SimpleEpollServer::LoopStats& stats = epoll_server.loop_stats();
+  EXPECT_EQ(static_cast<int64_t>(kNumCallbacks), stats.num_fd_callbacks);
+  ASSERT_EQ(SimpleEpollServer::LoopStats::kMaxSlowestCallbacks,
+            stats.slowest_callbacks.size());
+  for (size_t i = 0; i < stats.slowest_callbacks.size(); ++i) {
+    EXPECT_EQ(static_cast<int64_t>(10 * (kNumCallbacks - i)),
+              stats.slowest_callbacks[i].duration_us);
+    EXPECT_EQ(static_cast<int>(100 + kNumCallbacks - 1 - i),
+              stats.slowest_callbacks[i].fd);
+  }
+}
+
 }  // namespace
 
 }  // namespace test
@@ -8,6 +8,14 @@ namespace adapter {
 
 namespace {
 
+// Opaque data of the PINGs sent to sample the bandwidth-delay product, so that
+// their ACKs can be told apart from those of PINGs sent by the application.
+const spdy::SpdyPingId kBdpPingId = 0x6264705f70696e67;  // "bdp_ping"
+
+// Raising the receive windows must increase the bandwidth by this factor for
+// them to be raised again.
+const double kMinBdpBandwidthGain = 1.25;
+
 // TODO(birenroy): Consider incorporating spdy::FlagsSerializionVisitor here.
 class FrameAttributeCollector : public spdy::SpdyFrameVisitor {
  public:
@@ -425,13 +433,8 @@ int32_t OgHttp2Session::SubmitRequest(
   auto frame =
       absl::make_unique<spdy::SpdyHeadersIR>(stream_id, ToHeaderBlock(headers));
   // Add data source and user data to stream state
-  WindowManager::WindowUpdateListener listener =
-      [this, stream_id](size_t window_update_delta) {
-        SendWindowUpdate(stream_id, window_update_delta);
-      };
-  auto [iter, inserted] = stream_map_.try_emplace(
-      stream_id,
-      StreamState(stream_receive_window_limit_, std::move(listener)));
+  auto [iter, inserted] =
+      stream_map_.try_emplace(stream_id, CreateStreamState(stream_id));
   if (!inserted) {
     QUICHE_LOG(DFATAL) << "Stream " << stream_id << " already exists!";
     return -501;  // NGHTTP2_ERR_INVALID_ARGUMENT
@@ -449,6 +452,9 @@ int32_t OgHttp2Session::SubmitRequest(
   write_scheduler_.MarkStreamReady(stream_id, false);
   // Enqueue headers frame
   EnqueueFrame(std::move(frame));
+  // The stream is open once its HEADERS are sent, so only then may its window
+  // be raised.
+  MaybeRaiseStreamReceiveWindow(iter->second);
   return stream_id;
 }
 
@@ -612,6 +618,11 @@ void OgHttp2Session::OnSettingsAck() {
 }
 
 void OgHttp2Session::OnPing(spdy::SpdyPingId unique_id, bool is_ack) {
+  if (is_ack && bdp_ping_outstanding_ && unique_id == kBdpPingId) {
+    // The visitor did not send this PING, so it need not know of the ACK.
+    OnBdpPingAck();
+    return;
+  }
   visitor_.OnPing(unique_id, is_ack);
 }
 
@@ -635,14 +646,13 @@ void OgHttp2Session::OnHeaders(spdy::SpdyStreamId stream_id,
                                bool fin,
                                bool end) {
   if (options_.perspective == Perspective::kServer) {
-    WindowManager::WindowUpdateListener listener =
-        [this, stream_id](size_t window_update_delta) {
-          SendWindowUpdate(stream_id, window_update_delta);
-        };
     // TODO(birenroy): Factor out a CreateStream() method from here and
     // SubmitRequest().
-    stream_map_.try_emplace(stream_id, StreamState(stream_receive_window_limit_,
-                                                   std::move(listener)));
+    auto [iter, inserted] =
+        stream_map_.try_emplace(stream_id, CreateStreamState(stream_id));
+    if (inserted) {
+      MaybeRaiseStreamReceiveWindow(iter->second);
+    }
     // Add the stream to the write scheduler.
     const WriteScheduler::StreamPrecedenceType precedence(3);
     write_scheduler_.RegisterStream(stream_id, precedence);
@@ -761,6 +771,73 @@ void OgHttp2Session::MarkDataBuffered(Http2StreamId stream_id, size_t bytes) {
   if (auto it = stream_map_.find(stream_id); it != stream_map_.end()) {
     it->second.window_manager.MarkDataBuffered(bytes);
   }
+  MaybeSampleBdp(bytes);
+}
+
+OgHttp2Session::StreamState OgHttp2Session::CreateStreamState(
+    Http2StreamId stream_id) {
+  WindowManager::WindowUpdateListener listener =
+      [this, stream_id](size_t window_update_delta) {
+        SendWindowUpdate(stream_id, window_update_delta);
+      };
+  return StreamState(stream_receive_window_limit_, std::move(listener));
+}
+
+void OgHttp2Session::MaybeRaiseStreamReceiveWindow(StreamState& state) {
+  // Once the peer has ended the stream, it needs no more window.
+  if (state.half_closed_remote) {
+    return;
+  }
+  if (static_cast<size_t>(tuned_receive_window_limit_) >
+      state.window_manager.WindowSizeLimit()) {
+    state.window_manager.SetWindowSizeLimit(tuned_receive_window_limit_);
+  }
+}
+
+void OgHttp2Session::MaybeSampleBdp(size_t bytes) {
+  if (!options_.auto_tune_receive_window ||
+      tuned_receive_window_limit_ >= options_.max_receive_window_size) {
+    return;
+  }
+  if (bdp_ping_outstanding_) {
+    bdp_sample_bytes_ += bytes;
+    return;
+  }
+  bdp_ping_outstanding_ = true;
+  bdp_sample_bytes_ = 0;
+  bdp_ping_sent_time_ = options_.clock();
+  EnqueueFrame(absl::make_unique<spdy::SpdyPingIR>(kBdpPingId));
+}
+
+void OgHttp2Session::OnBdpPingAck() {
+  bdp_ping_outstanding_ = false;
+  // Unless the peer sent most of the window in a round trip, it is not limited
+  // by the window. And unless the bandwidth is clearly higher than when the
+  // windows were last raised, the larger windows only filled a queue on the
+  // path.
+  const size_t bdp = bdp_sample_bytes_;
+  const double rtt_seconds =
+      absl::ToDoubleSeconds(options_.clock() - bdp_ping_sent_time_);
+  const double bandwidth = rtt_seconds > 0 ? bdp / rtt_seconds : 0;
+  if (3 * bdp < 2 * static_cast<size_t>(tuned_receive_window_limit_) ||
+      bandwidth <= kMinBdpBandwidthGain * bdp_bandwidth_) {
+    return;
+  }
+  bdp_bandwidth_ = bandwidth;
+  const int new_limit = static_cast<int>(std::min<size_t>(
+      2 * bdp, std::min(options_.max_receive_window_size,
+                        spdy::kSpdyMaximumWindowSize)));
+  if (new_limit <= tuned_receive_window_limit_) {
+    return;
+  }
+  QUICHE_VLOG(1) << "Raising receive windows from "
+                 << tuned_receive_window_limit_ << " to " << new_limit
+                 << " for a BDP sample of " << bdp << " bytes";
+  tuned_receive_window_limit_ = new_limit;
+  connection_window_manager_.SetWindowSizeLimit(new_limit);
+  for (auto& [stream_id, state] : stream_map_) {
+    MaybeRaiseStreamReceiveWindow(state);
+  }
 }
 
 }  // namespace adapter
@@ -1,8 +1,11 @@
 #ifndef QUICHE_HTTP2_ADAPTER_OGHTTP2_SESSION_H_
 #define QUICHE_HTTP2_ADAPTER_OGHTTP2_SESSION_H_
 
+#include <functional>
 #include <list>
 
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
 #include "http2/adapter/data_source.h"
 #include "http2/adapter/http2_session.h"
 #include "http2/adapter/http2_util.h"
@@ -22,6 +25,19 @@ class OgHttp2Session : public Http2Session,
  public:
   struct Options {
     Perspective perspective = Perspective::kClient;
+    // If true, the stream and connection receive windows grow beyond the
+    // HTTP/2 default when the peer is limited by them. The bytes received
+    // during the round trip of a PING are taken as the bandwidth-delay product
+    // of the connection, and the windows are set to twice that when it
+    // approaches the connection window and the bandwidth it implies is higher
+    // than before, i.e. when the larger window was not just filling a queue.
+    bool auto_tune_receive_window = false;
+    // Upper bound on auto-tuned receive windows. Since all data received counts
+    // against the connection window, this also bounds the data the session
+    // buffers.
+    int max_receive_window_size = 16 * 1024 * 1024;
+    // Times the round trips of the PINGs sent for auto-tuning.
+    std::function<absl::Time()> clock = absl::Now;
   };
 
   OgHttp2Session(Http2VisitorInterface& visitor, Options options);
@@ -208,6 +224,18 @@ class OgHttp2Session : public Http2Session,
   // Performs flow control accounting for data sent by the peer.
   void MarkDataBuffered(Http2StreamId stream_id, size_t bytes);
 
+  // Creates the receive window of a new stream. The window starts at the
+  // initial window size known to the peer, and is raised to the auto-tuned
+  // size by MaybeRaiseStreamReceiveWindow() once the stream is open.
+  StreamState CreateStreamState(Http2StreamId stream_id);
+  void MaybeRaiseStreamReceiveWindow(StreamState& state);
+
+  // Samples the bandwidth-delay product of the connection for receive window
+  // auto-tuning: sends a PING when data is received and none is outstanding,
+  // and counts the bytes received until its ACK.
+  void MaybeSampleBdp(size_t bytes);
+  void OnBdpPingAck();
+
   // Receives events when inbound frames are parsed.
   Http2VisitorInterface& visitor_;
 
@@ -245,6 +273,15 @@ class OgHttp2Session : public Http2Session,
   int connection_send_window_ = kInitialFlowControlWindowSize;
   // The initial flow control receive window size for any newly created streams.
   int stream_receive_window_limit_ = kInitialFlowControlWindowSize;
+  // The receive window size chosen by auto-tuning, for the connection and for
+  // every stream.
+  int tuned_receive_window_limit_ = kInitialFlowControlWindowSize;
+  // Bytes received since the outstanding BDP PING was queued, and when it was.
+  size_t bdp_sample_bytes_ = 0;
+  absl::Time bdp_ping_sent_time_;
+  bool bdp_ping_outstanding_ = false;
+  // Bytes per second received in the BDP sample which last raised the windows.
+  double bdp_bandwidth_ = 0;
   int max_frame_payload_ = 16384;
   Options options_;
   bool received_goaway_ = false;
@@ -1,5 +1,11 @@
 #include "http2/adapter/oghttp2_session.h"
 
+#include <list>
+#include <string>
+
+#include "absl/memory/memory.h"
+#include "absl/strings/str_cat.h"
+#include "absl/time/time.h"
 #include "http2/adapter/mock_http2_visitor.h"
 #include "http2/adapter/test_frame_sequence.h"
 #include "http2/adapter/test_utils.h"
@@ -918,6 +924,161 @@ TEST(OgHttp2SessionTest, ServerQueuesTrailersWithResponse) {
                             SpdyFrameType::HEADERS}));
 }
 
+namespace {
+
+// One end of an upload over a simulated link. Buffers the bytes written by its
+// session, consumes received DATA immediately and acknowledges PINGs.
+class LinkEndpointVisitor : public testing::NiceMock<MockHttp2Visitor> {
+ public:
+  void set_session(OgHttp2Session* session) { session_ = session; }
+
+  ssize_t OnReadyToSend(absl::string_view data) override {
+    absl::StrAppend(&outbox_, data);
+    return data.size();
+  }
+  void OnDataForStream(Http2StreamId stream_id,
+                       absl::string_view data) override {
+    body_bytes_received_ += data.size();
+    session_->Consume(stream_id, data.size());
+  }
+  void OnPing(Http2PingId ping_id, bool is_ack) override {
+    if (!is_ack) {
+      auto ack = absl::make_unique<spdy::SpdyPingIR>(ping_id);
+      ack->set_is_ack(true);
+      session_->EnqueueFrame(std::move(ack));
+    }
+  }
+
+  std::string& outbox() { return outbox_; }
+  size_t body_bytes_received() const { return body_bytes_received_; }
+
+ private:
+  OgHttp2Session* session_ = nullptr;
+  std::string outbox_;
+  size_t body_bytes_received_ = 0;
+};
+
+// Uploads a request body from a client to a server over a link of
+// kLinkBytesPerMs bandwidth from the client and kRttMs round trip time,
+// simulated one millisecond at a time.
+class SimulatedUpload {
+ public:
+  static constexpr size_t kLinkBytesPerMs = 2500;  // 20 Mbit/s
+  static constexpr int kRttMs = 100;
+
+  explicit SimulatedUpload(OgHttp2Session::Options server_options)
+      : client_(client_visitor_,
+                OgHttp2Session::Options{.perspective = Perspective::kClient}),
+        server_(server_visitor_, WithSimulatedClock(server_options)) {
+    client_visitor_.set_session(&client_);
+    server_visitor_.set_session(&server_);
+    client_.SubmitRequest(
+        ToHeaders({{":method", "POST"},
+                   {":scheme", "http"},
+                   {":authority", "example.com"},
+                   {":path", "/upload"}}),
+        absl::make_unique<TestDataFrameSource>(
+            client_visitor_, std::string(16 * 1024 * 1024, 'a')),
+        nullptr);
+  }
+
+  // Runs the upload for |duration_ms| and returns the body bytes received by
+  // the server.
+  size_t Run(int duration_ms) {
+    for (int now = 0; now < duration_ms; ++now) {
+      now_ms_ = now;
+      Deliver(now, to_server_, server_);
+      Deliver(now, to_client_, client_);
+      client_.Send();
+      server_.Send();
+      std::string& client_outbox = client_visitor_.outbox();
+      const size_t bytes = std::min(kLinkBytesPerMs, client_outbox.size());
+      if (bytes > 0) {
+        to_server_.push_back(
+            {now + kRttMs / 2, client_outbox.substr(0, bytes)});
+        client_outbox.erase(0, bytes);
+      }
+      if (!server_visitor_.outbox().empty()) {
+        to_client_.push_back({now + kRttMs / 2, server_visitor_.outbox()});
+        server_visitor_.outbox().clear();
+      }
+    }
+    return server_visitor_.body_bytes_received();
+  }
+
+  OgHttp2Session& server() { return server_; }
+
+ private:
+  struct InFlight {
+    int arrival_ms;
+    std::string bytes;
+  };
+
+  OgHttp2Session::Options WithSimulatedClock(OgHttp2Session::Options options) {
+    options.clock = [this] {
+      return absl::UnixEpoch() + absl::Milliseconds(now_ms_);
+    };
+    return options;
+  }
+
+  static void Deliver(int now, std::list<InFlight>& link,
+                      OgHttp2Session& session) {
+    while (!link.empty() && link.front().arrival_ms <= now) {
+      EXPECT_EQ(static_cast<ssize_t>(link.front().bytes.size()),
+                session.ProcessBytes(link.front().bytes));
+      link.pop_front();
+    }
+  }
+
+  int now_ms_ = 0;
+  LinkEndpointVisitor client_visitor_;
+  LinkEndpointVisitor server_visitor_;
+  OgHttp2Session client_;
+  OgHttp2Session server_;
+  std::list<InFlight> to_server_;
+  std::list<InFlight> to_client_;
+};
+
+}  // namespace
+
+// Over a link with a bandwidth-delay product of 250 KB, the default windows
+// limit an upload to 64 KB per round trip, while auto-tuned windows grow until
+// the upload fills the link, but not much further since the client queues
+// whatever the window allows.
+TEST(OgHttp2SessionTest, ServerAutoTunesReceiveWindow) {
+  const int kDurationMs = 3000;
+  const size_t kLinkCapacity = SimulatedUpload::kLinkBytesPerMs * kDurationMs;
+
+  SimulatedUpload untuned(
+      OgHttp2Session::Options{.perspective = Perspective::kServer});
+  const size_t untuned_bytes = untuned.Run(kDurationMs);
+  EXPECT_LE(untuned_bytes, kDurationMs / SimulatedUpload::kRttMs *
+                               kInitialFlowControlWindowSize);
+  EXPECT_EQ(kInitialFlowControlWindowSize,
+            untuned.server().GetStreamReceiveWindowLimit(1));
+
+  SimulatedUpload tuned(OgHttp2Session::Options{
+      .perspective = Perspective::kServer, .auto_tune_receive_window = true});
+  const size_t tuned_bytes = tuned.Run(kDurationMs);
+  EXPECT_GT(tuned_bytes, 3 * untuned_bytes);
+  EXPECT_GT(tuned_bytes, kLinkCapacity * 3 / 4);
+  EXPECT_GT(tuned.server().GetStreamReceiveWindowLimit(1),
+            kInitialFlowControlWindowSize);
+  EXPECT_LT(tuned.server().GetStreamReceiveWindowLimit(1), 1024 * 1024);
+}
+
+// Auto-tuned windows do not grow beyond max_receive_window_size.
+TEST(OgHttp2SessionTest, ServerAutoTunedReceiveWindowIsCapped) {
+  const int kMaxWindow = 128 * 1024;
+  SimulatedUpload upload(
+      OgHttp2Session::Options{.perspective = Perspective::kServer,
+                              .auto_tune_receive_window = true,
+                              .max_receive_window_size = kMaxWindow});
+  upload.Run(3000);
+  EXPECT_EQ(kMaxWindow, upload.server().GetStreamReceiveWindowLimit(1));
+  EXPECT_LE(upload.server().GetReceiveWindowSize(), kMaxWindow);
+}
+
 }  // namespace test
 }  // namespace adapter
 }  // namespace http2
@@ -152,6 +152,13 @@ QuicBatchWriterBase::FlushImplResult QuicBatchWriterBase::CheckedFlush() {
   return flush_result;
 }
 
+std::unique_ptr<QuicBatchWriterBuffer> QuicBatchWriterBase::ReplaceBatchBuffer(
+    std::unique_ptr<QuicBatchWriterBuffer> batch_buffer) {
+  QUICHE_DCHECK(buffered_writes().empty());
+  std::swap(batch_buffer_, batch_buffer);
+  return batch_buffer;
+}
+
 WriteResult QuicBatchWriterBase::Flush() {
   size_t num_buffered_packets = buffered_writes().size();
   FlushImplResult flush_result = CheckedFlush();
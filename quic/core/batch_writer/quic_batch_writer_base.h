@@ -64,6 +64,11 @@ class QUIC_EXPORT_PRIVATE QuicBatchWriterBase : public QuicPacketWriter {
     return batch_buffer_->buffered_writes();
   }
 
+  // Replaces the batch buffer with |batch_buffer| and returns the previous
+  // one.  Must only be called while there are no buffered writes.
+  std::unique_ptr<QuicBatchWriterBuffer> ReplaceBatchBuffer(
+      std::unique_ptr<QuicBatchWriterBuffer> batch_buffer);
+
   // Given the release delay in |options| and the state of |batch_buffer_|, get
   // the absolute release time.
   struct QUIC_NO_EXPORT ReleaseTime {
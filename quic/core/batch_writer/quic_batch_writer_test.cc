@@ -4,7 +4,9 @@
 
 #include "quic/core/batch_writer/quic_batch_writer_test.h"
 #include "quic/core/batch_writer/quic_gso_batch_writer.h"
+#include "quic/core/batch_writer/quic_io_uring_batch_writer.h"
 #include "quic/core/batch_writer/quic_sendmmsg_batch_writer.h"
+#include "quic/core/batch_writer/quic_zero_copy_batch_writer.h"
 
 namespace quic {
 namespace test {
@@ -72,6 +74,55 @@ INSTANTIATE_TEST_SUITE_P(
     testing::ValuesIn(MakeQuicBatchWriterTestParams<
                       QuicSendmmsgBatchWriterIOTestDelegate>()));
 
+class QuicIoUringBatchWriterIOTestDelegate
+    : public QuicGsoBatchWriterIOTestDelegate {
+ public:
+  bool ShouldSkip(const QuicUdpBatchWriterIOTestParams& params) override {
+    if (!QuicIoUring::IsSupported()) {
+      QUIC_LOG(WARNING) << "Test skipped since io_uring is not supported.";
+      return true;
+    }
+    return QuicGsoBatchWriterIOTestDelegate::ShouldSkip(params);
+  }
+
+  void ResetWriter(int fd) override {
+    writer_ = std::make_unique<QuicIoUringBatchWriter>(fd);
+    ASSERT_TRUE(writer_->Initialize());
+  }
+
+  QuicUdpBatchWriter* GetWriter() override { return writer_.get(); }
+
+ private:
+  std::unique_ptr<QuicIoUringBatchWriter> writer_;
+};
+
+INSTANTIATE_TEST_SUITE_P(
+    QuicIoUringBatchWriterTest,
+    QuicUdpBatchWriterIOTest,
+    testing::ValuesIn(MakeQuicBatchWriterTestParams<
+                      QuicIoUringBatchWriterIOTestDelegate>()));
+
+class QuicZeroCopyBatchWriterIOTestDelegate
+    : public QuicGsoBatchWriterIOTestDelegate {
+ public:
+  void ResetWriter(int fd) override {
+    writer_ = std::make_unique<QuicZeroCopyBatchWriter>(fd);
+    // Falls back to copying sends if SO_ZEROCOPY is unsupported.
+    writer_->Initialize();
+  }
+
+  QuicUdpBatchWriter* GetWriter() override { return writer_.get(); }
+
+ private:
+  std::unique_ptr<QuicZeroCopyBatchWriter> writer_;
+};
+
+INSTANTIATE_TEST_SUITE_P(
+    QuicZeroCopyBatchWriterTest,
+    QuicUdpBatchWriterIOTest,
+    testing::ValuesIn(MakeQuicBatchWriterTestParams<
+                      QuicZeroCopyBatchWriterIOTestDelegate>()));
+
 }  // namespace
 }  // namespace test
 }  // namespace quic
@@ -71,12 +71,17 @@ QuicGsoBatchWriter::CanBatchResult QuicGsoBatchWriter::CanBatch(
   // [4] Length of already buffered writes must >= length of the new write.
   // [5] The new packet can be released without delay, or it has the same
   //     release time as buffered writes.
+  // [6] It has the same ECN codepoint as buffered writes.
   const BufferedWrite& first = buffered_writes().front();
   const BufferedWrite& last = buffered_writes().back();
   // Whether this packet can be sent without delay, regardless of release time.
   const bool can_burst = !SupportsReleaseTime() || !options ||
                          options->release_time_delay.IsZero() ||
                          options->allow_burst;
+  const QuicEcnCodepoint ecn_codepoint =
+      options == nullptr ? ECN_NOT_ECT : options->ecn_codepoint;
+  const QuicEcnCodepoint buffered_ecn_codepoint =
+      first.options == nullptr ? ECN_NOT_ECT : first.options->ecn_codepoint;
   size_t max_segments = MaxSegments(first.buf_len);
   bool can_batch =
       buffered_writes().size() < max_segments &&                    // [0]
@@ -85,7 +90,8 @@ QuicGsoBatchWriter::CanBatchResult QuicGsoBatchWriter::CanBatch(
       batch_buffer().SizeInUse() + buf_len <= kMaxGsoPacketSize &&  // [2]
       first.buf_len == last.buf_len &&                              // [3]
       first.buf_len >= buf_len &&                                   // [4]
-      (can_burst || first.release_time == release_time);            // [5]
+      (can_burst || first.release_time == release_time) &&          // [5]
+      ecn_codepoint == buffered_ecn_codepoint;                      // [6]
 
   // A flush is required if any of the following is true:
   // [a] The new write can't be batched.
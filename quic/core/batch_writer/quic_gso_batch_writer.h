@@ -52,15 +52,18 @@ class QUIC_EXPORT_PRIVATE QuicGsoBatchWriter : public QuicUdpBatchWriter {
     return gso_size <= 2 ? 16 : 45;
   }
 
-  static const int kCmsgSpace =
-      kCmsgSpaceForIp + kCmsgSpaceForSegmentSize + kCmsgSpaceForTxTime;
+  static const int kCmsgSpace = kCmsgSpaceForIp + kCmsgSpaceForSegmentSize +
+                                kCmsgSpaceForTxTime + kCmsgSpaceForEcn;
   static void BuildCmsg(QuicMsgHdr* hdr,
                         const QuicIpAddress& self_address,
                         uint16_t gso_size,
                         uint64_t release_time);
 
+  // Sends all buffered writes as one GSO packet, passing |send_flags| to
+  // sendmsg().
   template <size_t CmsgSpace, typename CmsgBuilderT>
-  FlushImplResult InternalFlushImpl(CmsgBuilderT cmsg_builder) {
+  FlushImplResult InternalFlushImpl(CmsgBuilderT cmsg_builder,
+                                    int send_flags = 0) {
     QUICHE_DCHECK(!IsWriteBlocked());
     QUICHE_DCHECK(!buffered_writes().empty());
 
@@ -76,8 +79,12 @@ class QUIC_EXPORT_PRIVATE QuicGsoBatchWriter : public QuicUdpBatchWriter {
 
     uint16_t gso_size = buffered_writes().size() > 1 ? first.buf_len : 0;
     cmsg_builder(&hdr, first.self_address, gso_size, first.release_time);
+    // All segments of a GSO batch have the same ECN codepoint, see CanBatch.
+    if (first.options != nullptr) {
+      hdr.SetEcnInNextCmsg(first.options->ecn_codepoint);
+    }
 
-    write_result = QuicLinuxSocketUtils::WritePacket(fd(), hdr);
+    write_result = QuicLinuxSocketUtils::WritePacket(fd(), hdr, send_flags);
     QUIC_DVLOG(1) << "Write GSO packet result: " << write_result
                   << ", fd: " << fd()
                   << ", self_address: " << first.self_address.ToString()
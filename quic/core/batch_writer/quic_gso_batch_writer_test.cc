@@ -467,6 +467,38 @@ TEST_F(QuicGsoBatchWriterTest, ReleaseTime) {
   EXPECT_EQ(result.send_time_offset, QuicTime::Delta::Zero());
 }
 
+TEST_F(QuicGsoBatchWriterTest, EcnCodepoint) {
+  TestQuicGsoBatchWriter writer(/*fd=*/-1);
+  TestPerPacketOptions options;
+  options.ecn_codepoint = ECN_ECT0;
+
+  ASSERT_EQ(WriteResult(WRITE_STATUS_OK, 0),
+            WritePacketWithOptions(&writer, &options));
+  ASSERT_EQ(WriteResult(WRITE_STATUS_OK, 0),
+            WritePacketWithOptions(&writer, &options));
+
+  // A packet with a different ECN codepoint flushes the buffered packets,
+  // which are sent with an IP_TOS cmsg.
+  EXPECT_CALL(mock_syscalls_, Sendmsg(_, _, _))
+      .WillOnce(Invoke([](int /*sockfd*/, const msghdr* msg, int /*flags*/) {
+        EXPECT_EQ(2700u, PacketLength(msg));
+        bool found_tos = false;
+        for (cmsghdr* cmsg = CMSG_FIRSTHDR(msg); cmsg != nullptr;
+             cmsg = CMSG_NXTHDR(const_cast<msghdr*>(msg), cmsg)) {
+          if (cmsg->cmsg_level == IPPROTO_IP && cmsg->cmsg_type == IP_TOS) {
+            found_tos = true;
+            EXPECT_EQ(ECN_ECT0, *reinterpret_cast<int*>(CMSG_DATA(cmsg)));
+          }
+        }
+        EXPECT_TRUE(found_tos);
+        return 2700;
+      }));
+  options.ecn_codepoint = ECN_NOT_ECT;
+  ASSERT_EQ(WriteResult(WRITE_STATUS_OK, 2700),
+            WritePacketWithOptions(&writer, &options));
+  ASSERT_EQ(1u, writer.buffered_writes().size());
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace quic
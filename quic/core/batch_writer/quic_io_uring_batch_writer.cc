@@ -0,0 +1,212 @@
+// Copyright (c) 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "quic/core/batch_writer/quic_io_uring_batch_writer.h"
+
+#include <poll.h>
+
+#include <cerrno>
+#include <cstring>
+
+#include "quic/platform/api/quic_bug_tracker.h"
+#include "quic/platform/api/quic_logging.h"
+
+namespace quic {
+
+namespace {
+
+#if QUIC_HAS_IO_URING
+// user_data of the SQEs which are not sends.
+const uint64_t kPollUserData = ~uint64_t{0};
+const uint64_t kCancelUserData = ~uint64_t{0} - 1;
+#endif
+
+// Each send may be preceded by a linked poll.
+const uint32_t kNumSqes = 2 * QuicIoUringBatchWriter::kNumSendSlots;
+
+}  // namespace
+
+QuicIoUringBatchWriter::QuicIoUringBatchWriter(int fd)
+    : QuicGsoBatchWriter(fd), slots_(new SendSlot[kNumSendSlots]) {
+  free_slots_.reserve(kNumSendSlots);
+  for (size_t i = kNumSendSlots; i > 0; --i) {
+    free_slots_.push_back(i - 1);
+  }
+}
+
+QuicIoUringBatchWriter::~QuicIoUringBatchWriter() {
+  if (!ring_.initialized() || num_sends_in_flight() == 0) {
+    return;
+  }
+  // The kernel may still read from the slots of sends in flight, so cancel
+  // the ones waiting for the socket and wait for all of them to complete.
+  SubmitQueuedSends();
+#if QUIC_HAS_IO_URING
+  io_uring_sqe* sqe = ring_.GetSqe();
+  if (sqe != nullptr) {
+    sqe->opcode = IORING_OP_ASYNC_CANCEL;
+    sqe->fd = -1;
+    sqe->cancel_flags = IORING_ASYNC_CANCEL_ANY;
+    sqe->user_data = kCancelUserData;
+  }
+#endif
+  while (num_sends_in_flight() > 0) {
+    int rc = ring_.Submit(/*min_completions=*/1);
+    if (rc < 0 && rc != -EINTR) {
+      QUIC_LOG(ERROR) << "Failed to wait for io_uring sends: "
+                      << strerror(-rc);
+      return;
+    }
+    ReapCompletions(/*retry_blocked_sends=*/false);
+  }
+}
+
+bool QuicIoUringBatchWriter::Initialize() {
+  return ring_.Initialize(kNumSqes, kNumSqes);
+}
+
+WriteResult QuicIoUringBatchWriter::Flush() {
+  WriteResult result = QuicGsoBatchWriter::Flush();
+  SubmitQueuedSends();
+  return result;
+}
+
+QuicIoUringBatchWriter::FlushImplResult QuicIoUringBatchWriter::FlushImpl() {
+  QUICHE_DCHECK(ring_.initialized());
+  QUICHE_DCHECK(!IsWriteBlocked());
+  QUICHE_DCHECK(!buffered_writes().empty());
+
+  FlushImplResult result = {WriteResult(WRITE_STATUS_OK, 0),
+                            /*num_packets_sent=*/0, /*bytes_written=*/0};
+  if (free_slots_.empty()) {
+    SubmitQueuedSends();
+    ReapCompletions(/*retry_blocked_sends=*/true);
+    if (free_slots_.empty()) {
+      QUIC_DVLOG(1) << "All io_uring send slots in flight";
+      result.write_result = WriteResult(WRITE_STATUS_BLOCKED, EAGAIN);
+      return result;
+    }
+  }
+  const size_t slot_index = free_slots_.back();
+  free_slots_.pop_back();
+  SendSlot& slot = slots_[slot_index];
+
+  const size_t total_bytes = batch_buffer().SizeInUse();
+  const BufferedWrite& first = buffered_writes().front();
+  memcpy(slot.buffer, first.buffer, total_bytes);
+  slot.hdr.emplace(slot.buffer, total_bytes, first.peer_address, slot.cbuf,
+                   sizeof(slot.cbuf));
+  const uint16_t gso_size = buffered_writes().size() > 1 ? first.buf_len : 0;
+  BuildCmsg(&*slot.hdr, first.self_address, gso_size, first.release_time);
+  // All segments of a GSO batch have the same ECN codepoint, see CanBatch.
+  if (first.options != nullptr) {
+    slot.hdr->SetEcnInNextCmsg(first.options->ecn_codepoint);
+  }
+  QueueSend(slot_index, /*wait_for_writable=*/false);
+  QUIC_DVLOG(1) << "Queued GSO packet in slot " << slot_index
+                << ", peer_address: " << first.peer_address.ToString()
+                << ", num_segments: " << buffered_writes().size()
+                << ", total_bytes: " << total_bytes
+                << ", gso_size: " << gso_size;
+
+  result.num_packets_sent = buffered_writes().size();
+  result.write_result.bytes_written = total_bytes;
+  result.bytes_written = total_bytes;
+  batch_buffer().PopBufferedWrite(buffered_writes().size());
+  return result;
+}
+
+void QuicIoUringBatchWriter::ProcessCompletions() {
+  ReapCompletions(/*retry_blocked_sends=*/true);
+  SubmitQueuedSends();
+}
+
+#if QUIC_HAS_IO_URING
+void QuicIoUringBatchWriter::QueueSend(size_t slot_index,
+                                       bool wait_for_writable) {
+  if (wait_for_writable) {
+    io_uring_sqe* poll_sqe = ring_.GetSqe();
+    if (poll_sqe != nullptr) {
+      poll_sqe->opcode = IORING_OP_POLL_ADD;
+      poll_sqe->fd = fd();
+      poll_sqe->poll32_events = POLLOUT;
+      poll_sqe->flags = IOSQE_IO_LINK;
+      poll_sqe->user_data = kPollUserData;
+    }
+  }
+  io_uring_sqe* sqe = ring_.GetSqe();
+  // There are two SQEs per send slot, and each slot has at most one send
+  // queued.
+  QUIC_BUG_IF(quic_bug_12974_1, sqe == nullptr)
+      << "io_uring submission queue full, num_pending_sqes: "
+      << ring_.num_pending_sqes();
+  if (sqe == nullptr) {
+    ++stats_.send_errors;
+    slots_[slot_index].hdr.reset();
+    free_slots_.push_back(slot_index);
+    return;
+  }
+  sqe->opcode = IORING_OP_SENDMSG;
+  sqe->fd = fd();
+  sqe->addr = reinterpret_cast<uint64_t>(slots_[slot_index].hdr->hdr());
+  sqe->len = 1;
+  sqe->user_data = slot_index;
+  ++stats_.sendmsg_sqes;
+}
+#else  // QUIC_HAS_IO_URING
+void QuicIoUringBatchWriter::QueueSend(size_t /*slot_index*/,
+                                       bool /*wait_for_writable*/) {
+  QUIC_NOTREACHED();
+}
+#endif  // QUIC_HAS_IO_URING
+
+void QuicIoUringBatchWriter::SubmitQueuedSends() {
+  if (ring_.num_pending_sqes() == 0) {
+    return;
+  }
+  ++stats_.submit_calls;
+  const int rc = ring_.Submit();
+  if (rc < 0) {
+    // The SQEs stay queued and are submitted by the next Flush().
+    QUIC_LOG_FIRST_N(ERROR, 10)
+        << "Failed to submit io_uring sends: " << strerror(-rc);
+  }
+}
+
+#if QUIC_HAS_IO_URING
+void QuicIoUringBatchWriter::ReapCompletions(bool retry_blocked_sends) {
+  while (const io_uring_cqe* cqe = ring_.PeekCqe()) {
+    const uint64_t user_data = cqe->user_data;
+    const int res = cqe->res;
+    ring_.ConsumeCqe();
+    if (user_data == kPollUserData || user_data == kCancelUserData) {
+      continue;
+    }
+    if (user_data >= kNumSendSlots) {
+      QUIC_BUG(quic_bug_12974_2) << "Unexpected io_uring completion "
+                                 << user_data << ", res: " << res;
+      continue;
+    }
+    const size_t slot_index = static_cast<size_t>(user_data);
+    if (res == -EAGAIN && retry_blocked_sends) {
+      ++stats_.send_retries;
+      QueueSend(slot_index, /*wait_for_writable=*/true);
+      continue;
+    }
+    if (res < 0) {
+      ++stats_.send_errors;
+      QUIC_LOG_FIRST_N(ERROR, 10)
+          << "io_uring send failed: " << strerror(-res);
+    }
+    slots_[slot_index].hdr.reset();
+    free_slots_.push_back(slot_index);
+  }
+}
+#else  // QUIC_HAS_IO_URING
+void QuicIoUringBatchWriter::ReapCompletions(bool /*retry_blocked_sends*/) {
+  QUIC_NOTREACHED();
+}
+#endif  // QUIC_HAS_IO_URING
+
+}  // namespace quic
@@ -0,0 +1,102 @@
+// Copyright (c) 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef QUICHE_QUIC_CORE_BATCH_WRITER_QUIC_IO_URING_BATCH_WRITER_H_
+#define QUICHE_QUIC_CORE_BATCH_WRITER_QUIC_IO_URING_BATCH_WRITER_H_
+
+#include <memory>
+#include <vector>
+
+#include "absl/types/optional.h"
+#include "quic/core/batch_writer/quic_gso_batch_writer.h"
+#include "quic/core/quic_io_uring.h"
+#include "quic/core/quic_linux_socket_utils.h"
+
+namespace quic {
+
+// QuicIoUringBatchWriter is a QuicGsoBatchWriter which sends its GSO batches
+// with io_uring instead of sendmsg().  Each flushed batch is copied into a
+// send slot and queued as an IORING_OP_SENDMSG SQE, with the same GSO,
+// SO_TXTIME and ECN cmsgs as QuicGsoBatchWriter.  Queued batches are
+// submitted together by the next Flush(), so a burst of writes to many peers
+// costs a single io_uring_enter() and never blocks on the socket.
+//
+// Since sends complete asynchronously, send errors are only logged and
+// counted, the same as packets dropped by the network.  Sends that fail with
+// EAGAIN are retried once the socket becomes writable.
+//
+// The writer is write blocked while all send slots are in flight.  The owner
+// must register ring_fd() with its event loop, call ProcessCompletions() when
+// it becomes readable and then call OnCanWrite() on the writer's users if it
+// was blocked.
+class QUIC_EXPORT_PRIVATE QuicIoUringBatchWriter : public QuicGsoBatchWriter {
+ public:
+  // Maximum number of GSO batches in flight.
+  static constexpr size_t kNumSendSlots = 64;
+
+  struct QUIC_EXPORT_PRIVATE Stats {
+    // Number of io_uring_enter() calls that submitted sends.
+    uint64_t submit_calls = 0;
+    // Number of IORING_OP_SENDMSG SQEs submitted, including retries.
+    uint64_t sendmsg_sqes = 0;
+    // Number of sends retried after EAGAIN.
+    uint64_t send_retries = 0;
+    // Number of GSO batches which failed to be sent.
+    uint64_t send_errors = 0;
+  };
+
+  explicit QuicIoUringBatchWriter(int fd);
+  ~QuicIoUringBatchWriter() override;
+
+  // Sets up the io_uring instance.  Returns false if io_uring is unavailable,
+  // in which case the writer must not be used.
+  bool Initialize();
+
+  // Flushes the buffered packets, and submits all queued GSO batches.
+  WriteResult Flush() override;
+
+  FlushImplResult FlushImpl() override;
+
+  // The fd of the io_uring instance, which is readable when sends complete.
+  int ring_fd() const { return ring_.ring_fd(); }
+
+  // Handles completed sends and frees their send slots.
+  void ProcessCompletions();
+
+  // Number of GSO batches queued or being sent.
+  size_t num_sends_in_flight() const {
+    return kNumSendSlots - free_slots_.size();
+  }
+
+  const Stats& stats() const { return stats_; }
+
+ private:
+  struct QUIC_EXPORT_PRIVATE SendSlot {
+    ABSL_CACHELINE_ALIGNED char buffer[QuicBatchWriterBuffer::kBufferSize];
+    char cbuf[kCmsgSpace];
+    absl::optional<QuicMsgHdr> hdr;
+  };
+
+  // Queues a sendmsg SQE for |slot_index|.  If |wait_for_writable| is true,
+  // it is linked after a poll for the socket to become writable.
+  void QueueSend(size_t slot_index, bool wait_for_writable);
+
+  // Submits all queued SQEs.
+  void SubmitQueuedSends();
+
+  // Reaps all available completions.  Sends which failed with EAGAIN are
+  // queued again if |retry_blocked_sends| is true.
+  void ReapCompletions(bool retry_blocked_sends);
+
+  std::unique_ptr<SendSlot[]> slots_;
+  std::vector<size_t> free_slots_;
+  // Declared after |slots_|, so that the ring is torn down before the slots
+  // it may reference are freed.
+  QuicIoUring ring_;
+  Stats stats_;
+};
+
+}  // namespace quic
+
+#endif  // QUICHE_QUIC_CORE_BATCH_WRITER_QUIC_IO_URING_BATCH_WRITER_H_
@@ -0,0 +1,147 @@
+// Copyright (c) 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "quic/core/batch_writer/quic_io_uring_batch_writer.h"
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <memory>
+
+#include "quic/core/quic_udp_socket.h"
+#include "quic/platform/api/quic_test.h"
+
+namespace quic {
+namespace test {
+namespace {
+
+const size_t kPacketSize = 1000;
+
+class QuicIoUringBatchWriterTest : public QuicTest {
+ protected:
+  ~QuicIoUringBatchWriterTest() override {
+    writer_.reset();
+    for (int fd : {self_fd_, peer1_fd_, peer2_fd_}) {
+      if (fd >= 0) {
+        close(fd);
+      }
+    }
+  }
+
+  // Returns false if io_uring is not supported.
+  bool Initialize() {
+    if (!QuicIoUring::IsSupported()) {
+      QUIC_LOG(WARNING) << "Test skipped since io_uring is not supported.";
+      return false;
+    }
+    self_fd_ = CreateSocket(&self_address_);
+    peer1_fd_ = CreateSocket(&peer1_address_);
+    peer2_fd_ = CreateSocket(&peer2_address_);
+    writer_ = std::make_unique<QuicIoUringBatchWriter>(self_fd_);
+    EXPECT_TRUE(writer_->Initialize());
+    return true;
+  }
+
+  int CreateSocket(QuicSocketAddress* address) {
+    QuicUdpSocketApi socket_api;
+    int fd = socket_api.Create(AF_INET, kDefaultSocketReceiveBuffer,
+                               kDefaultSocketReceiveBuffer);
+    EXPECT_GE(fd, 0);
+    EXPECT_TRUE(
+        socket_api.Bind(fd, QuicSocketAddress(QuicIpAddress::Loopback4(), 0)));
+    EXPECT_EQ(0, address->FromSocket(fd));
+    return fd;
+  }
+
+  WriteResult WritePacket(const QuicSocketAddress& peer_address) {
+    char buffer[kPacketSize];
+    memset(buffer, 'a', sizeof(buffer));
+    return writer_->WritePacket(buffer, sizeof(buffer), self_address_.host(),
+                                peer_address, nullptr);
+  }
+
+  // Returns the number of packets read from |fd|.
+  int ReadPackets(int fd) {
+    int packets = 0;
+    char buffer[kPacketSize + 1];
+    while (recv(fd, buffer, sizeof(buffer), MSG_DONTWAIT) ==
+           static_cast<ssize_t>(kPacketSize)) {
+      ++packets;
+    }
+    return packets;
+  }
+
+  QuicSocketAddress self_address_;
+  QuicSocketAddress peer1_address_;
+  QuicSocketAddress peer2_address_;
+  int self_fd_ = -1;
+  int peer1_fd_ = -1;
+  int peer2_fd_ = -1;
+  std::unique_ptr<QuicIoUringBatchWriter> writer_;
+};
+
+TEST_F(QuicIoUringBatchWriterTest, BatchesSubmittedOnFlush) {
+  if (!Initialize()) {
+    return;
+  }
+
+  // Packets to different peers are sent in different GSO batches, which are
+  // queued until the writer is flushed.
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ(WRITE_STATUS_OK, WritePacket(peer1_address_).status);
+  }
+  for (int i = 0; i < 2; ++i) {
+    EXPECT_EQ(WRITE_STATUS_OK, WritePacket(peer2_address_).status);
+  }
+  EXPECT_EQ(1u, writer_->num_sends_in_flight());
+  EXPECT_EQ(0u, writer_->stats().submit_calls);
+
+  WriteResult result = writer_->Flush();
+  EXPECT_EQ(WRITE_STATUS_OK, result.status);
+  EXPECT_EQ(2 * kPacketSize, result.bytes_written);
+  EXPECT_EQ(1u, writer_->stats().submit_calls);
+  EXPECT_EQ(2u, writer_->stats().sendmsg_sqes);
+
+  // Sends on a writable socket complete during submission.
+  writer_->ProcessCompletions();
+  EXPECT_EQ(0u, writer_->num_sends_in_flight());
+  EXPECT_EQ(0u, writer_->stats().send_errors);
+  EXPECT_EQ(3, ReadPackets(peer1_fd_));
+  EXPECT_EQ(2, ReadPackets(peer2_fd_));
+}
+
+TEST_F(QuicIoUringBatchWriterTest, SlotsReclaimedWhenAllInFlight) {
+  if (!Initialize()) {
+    return;
+  }
+
+  // Alternating peers flushes a batch on every write.
+  for (size_t i = 0; i < QuicIoUringBatchWriter::kNumSendSlots; ++i) {
+    EXPECT_EQ(WRITE_STATUS_OK,
+              WritePacket(i % 2 == 0 ? peer1_address_ : peer2_address_)
+                  .status);
+  }
+  EXPECT_EQ(QuicIoUringBatchWriter::kNumSendSlots - 1,
+            writer_->num_sends_in_flight());
+  EXPECT_EQ(WRITE_STATUS_OK, WritePacket(peer1_address_).status);
+  EXPECT_EQ(QuicIoUringBatchWriter::kNumSendSlots,
+            writer_->num_sends_in_flight());
+
+  // The queued sends are submitted and reaped to make room for the next
+  // batch.
+  EXPECT_EQ(WRITE_STATUS_OK, WritePacket(peer2_address_).status);
+  EXPECT_FALSE(writer_->IsWriteBlocked());
+  EXPECT_EQ(1u, writer_->stats().submit_calls);
+  EXPECT_EQ(1u, writer_->num_sends_in_flight());
+
+  EXPECT_EQ(WRITE_STATUS_OK, writer_->Flush().status);
+  writer_->ProcessCompletions();
+  EXPECT_EQ(0u, writer_->num_sends_in_flight());
+  EXPECT_EQ(33, ReadPackets(peer1_fd_));
+  EXPECT_EQ(33, ReadPackets(peer2_fd_));
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace quic
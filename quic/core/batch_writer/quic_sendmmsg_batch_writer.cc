@@ -23,9 +23,12 @@ QuicSendmmsgBatchWriter::CanBatchResult QuicSendmmsgBatchWriter::CanBatch(
 
 QuicSendmmsgBatchWriter::FlushImplResult QuicSendmmsgBatchWriter::FlushImpl() {
   return InternalFlushImpl(
-      kCmsgSpaceForIp,
+      kCmsgSpaceForIp + kCmsgSpaceForEcn,
       [](QuicMMsgHdr* mhdr, int i, const BufferedWrite& buffered_write) {
         mhdr->SetIpInNextCmsg(i, buffered_write.self_address);
+        if (buffered_write.options != nullptr) {
+          mhdr->SetEcnInNextCmsg(i, buffered_write.options->ecn_codepoint);
+        }
       });
 }
 
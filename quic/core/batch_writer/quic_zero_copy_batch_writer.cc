@@ -0,0 +1,159 @@
+// Copyright (c) 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "quic/core/batch_writer/quic_zero_copy_batch_writer.h"
+
+#include <linux/errqueue.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+
+#include <cerrno>
+#include <cstring>
+
+#include "quic/core/quic_linux_socket_utils.h"
+#include "quic/platform/api/quic_logging.h"
+
+namespace quic {
+
+namespace {
+
+// How long the destructor waits for the kernel to complete sends in flight.
+const int kMaxDestructorWaitMs = 100;
+
+}  // namespace
+
+QuicZeroCopyBatchWriter::QuicZeroCopyBatchWriter(int fd)
+    : QuicGsoBatchWriter(fd), zero_copy_enabled_(false), next_send_id_(0) {}
+
+QuicZeroCopyBatchWriter::~QuicZeroCopyBatchWriter() {
+  // Freeing a buffer the kernel is still sending from could corrupt the
+  // packets on the wire, so give the kernel a moment to complete the sends.
+  for (int i = 0; i < kMaxDestructorWaitMs && !sends_in_flight_.empty(); ++i) {
+    ProcessCompletions();
+    if (sends_in_flight_.empty()) {
+      break;
+    }
+    pollfd poll_fd = {fd(), /*events=*/0, /*revents=*/0};
+    if (poll(&poll_fd, 1, /*timeout=*/1) > 0 && (poll_fd.revents & POLLNVAL)) {
+      break;
+    }
+  }
+  QUIC_LOG_IF(WARNING, !sends_in_flight_.empty())
+      << "Destroying writer with " << sends_in_flight_.size()
+      << " zero copy sends in flight";
+}
+
+bool QuicZeroCopyBatchWriter::Initialize() {
+  zero_copy_enabled_ = QuicLinuxSocketUtils::EnableZeroCopy(fd());
+  return zero_copy_enabled_;
+}
+
+QuicZeroCopyBatchWriter::FlushImplResult QuicZeroCopyBatchWriter::FlushImpl() {
+  if (!zero_copy_enabled_ || batch_buffer().SizeInUse() < kMinZeroCopyBytes) {
+    return QuicGsoBatchWriter::FlushImpl();
+  }
+  std::unique_ptr<QuicBatchWriterBuffer> spare_buffer = GetSpareBuffer();
+  if (spare_buffer == nullptr) {
+    ++stats_.copied_sends;
+    return QuicGsoBatchWriter::FlushImpl();
+  }
+
+  FlushImplResult result =
+      InternalFlushImpl<kCmsgSpace>(BuildCmsg, MSG_ZEROCOPY);
+  if (result.write_result.status == WRITE_STATUS_OK) {
+    // The kernel owns the sent buffer until the send completes.
+    sends_in_flight_.push_back(
+        {next_send_id_++, /*completed=*/false,
+         ReplaceBatchBuffer(std::move(spare_buffer))});
+    ++stats_.zero_copy_sends;
+    return result;
+  }
+  spare_buffers_.push_back(std::move(spare_buffer));
+  if (result.write_result.status == WRITE_STATUS_ERROR &&
+      result.write_result.error_code == ENOBUFS) {
+    // The socket is out of memory for tracking zero copy sends.
+    QUIC_DVLOG(1) << "Zero copy send failed with ENOBUFS, copying instead";
+    ++stats_.copied_sends;
+    return QuicGsoBatchWriter::FlushImpl();
+  }
+  return result;
+}
+
+void QuicZeroCopyBatchWriter::ProcessCompletions() {
+  while (!sends_in_flight_.empty()) {
+    char control[CMSG_SPACE(sizeof(sock_extended_err) + sizeof(sockaddr_in6))];
+    msghdr hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    hdr.msg_control = control;
+    hdr.msg_controllen = sizeof(control);
+    int rc;
+    do {
+      rc = recvmsg(fd(), &hdr, MSG_ERRQUEUE | MSG_DONTWAIT);
+    } while (rc < 0 && errno == EINTR);
+    if (rc < 0) {
+      if (errno != EAGAIN && errno != EWOULDBLOCK) {
+        QUIC_LOG_FIRST_N(ERROR, 10)
+            << "Failed to read zero copy completions: " << strerror(errno);
+      }
+      return;
+    }
+    for (cmsghdr* cmsg = CMSG_FIRSTHDR(&hdr); cmsg != nullptr;
+         cmsg = CMSG_NXTHDR(&hdr, cmsg)) {
+      if (!(cmsg->cmsg_level == IPPROTO_IP && cmsg->cmsg_type == IP_RECVERR) &&
+          !(cmsg->cmsg_level == IPPROTO_IPV6 &&
+            cmsg->cmsg_type == IPV6_RECVERR)) {
+        continue;
+      }
+      sock_extended_err error;
+      memcpy(&error, CMSG_DATA(cmsg), sizeof(error));
+      if (error.ee_origin != SO_EE_ORIGIN_ZEROCOPY || error.ee_errno != 0) {
+        continue;
+      }
+      // A completion covers the range of send IDs [ee_info, ee_data].
+      OnSendsCompleted(error.ee_info, error.ee_data,
+                       error.ee_code & SO_EE_CODE_ZEROCOPY_COPIED);
+    }
+  }
+}
+
+void QuicZeroCopyBatchWriter::OnSendsCompleted(uint32_t first_id,
+                                               uint32_t last_id,
+                                               bool copied) {
+  for (SendInFlight& send : sends_in_flight_) {
+    // Unsigned arithmetic, so that ranges wrapping around 2^32 work.
+    if (send.id - first_id <= last_id - first_id && !send.completed) {
+      send.completed = true;
+      ++stats_.completed_sends;
+      if (copied) {
+        ++stats_.kernel_copied_sends;
+      }
+    }
+  }
+  // Sends normally complete in order, buffers of sends completed out of order
+  // are reclaimed along with the sends before them.
+  while (!sends_in_flight_.empty() && sends_in_flight_.front().completed) {
+    spare_buffers_.push_back(std::move(sends_in_flight_.front().buffer));
+    sends_in_flight_.pop_front();
+  }
+}
+
+std::unique_ptr<QuicBatchWriterBuffer>
+QuicZeroCopyBatchWriter::GetSpareBuffer() {
+  if (spare_buffers_.empty()) {
+    if (sends_in_flight_.size() < kMaxBuffersInFlight) {
+      return std::make_unique<QuicBatchWriterBuffer>();
+    }
+    ProcessCompletions();
+    if (spare_buffers_.empty()) {
+      return nullptr;
+    }
+  }
+  std::unique_ptr<QuicBatchWriterBuffer> buffer =
+      std::move(spare_buffers_.back());
+  spare_buffers_.pop_back();
+  return buffer;
+}
+
+}  // namespace quic
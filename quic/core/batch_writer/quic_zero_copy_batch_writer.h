@@ -0,0 +1,93 @@
+// Copyright (c) 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef QUICHE_QUIC_CORE_BATCH_WRITER_QUIC_ZERO_COPY_BATCH_WRITER_H_
+#define QUICHE_QUIC_CORE_BATCH_WRITER_QUIC_ZERO_COPY_BATCH_WRITER_H_
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "quic/core/batch_writer/quic_gso_batch_writer.h"
+#include "common/quiche_circular_deque.h"
+
+namespace quic {
+
+// QuicZeroCopyBatchWriter is a QuicGsoBatchWriter which sends large GSO
+// batches with MSG_ZEROCOPY, so that the kernel transmits them straight from
+// the batch buffer the packets were serialized into instead of copying them.
+//
+// The kernel holds on to the pages of a zero copy send until it reports the
+// send as completed on the socket's error queue, so every zero copy send hands
+// its batch buffer over to the kernel and continues with a spare one.  The
+// buffers of completed sends are reclaimed by ProcessCompletions(), which the
+// writer calls itself once kMaxBuffersInFlight sends are in flight.  Owners
+// may also call it when the socket reports EPOLLERR, to release the buffers
+// sooner.  When no spare buffer is available, batches are sent with a regular
+// copying sendmsg().
+class QUIC_EXPORT_PRIVATE QuicZeroCopyBatchWriter : public QuicGsoBatchWriter {
+ public:
+  // Batches smaller than this are copied, since pinning their pages and
+  // handling the completion costs more than the copy.
+  static constexpr size_t kMinZeroCopyBytes = 16 * 1024;
+  // Maximum number of batch buffers owned by the kernel at once.
+  static constexpr size_t kMaxBuffersInFlight = 16;
+
+  struct QUIC_EXPORT_PRIVATE Stats {
+    // Number of GSO batches sent with MSG_ZEROCOPY.
+    uint64_t zero_copy_sends = 0;
+    // Number of large batches sent with a copy since no buffer was available,
+    // or the kernel refused a zero copy send.
+    uint64_t copied_sends = 0;
+    // Number of zero copy sends completed by the kernel.
+    uint64_t completed_sends = 0;
+    // Number of completed zero copy sends for which the kernel copied the
+    // data anyway, e.g. because the packets were looped back.
+    uint64_t kernel_copied_sends = 0;
+  };
+
+  explicit QuicZeroCopyBatchWriter(int fd);
+  ~QuicZeroCopyBatchWriter() override;
+
+  // Enables SO_ZEROCOPY on the socket.  Returns false if zero copy sends are
+  // unsupported, in which case the writer behaves as a QuicGsoBatchWriter.
+  bool Initialize();
+
+  FlushImplResult FlushImpl() override;
+
+  // Reads zero copy completions from the socket's error queue and reclaims
+  // the batch buffers of completed sends.
+  void ProcessCompletions();
+
+  // Number of batch buffers owned by the kernel.
+  size_t num_sends_in_flight() const { return sends_in_flight_.size(); }
+
+  const Stats& stats() const { return stats_; }
+
+ private:
+  struct QUIC_EXPORT_PRIVATE SendInFlight {
+    // The kernel's ID for this send, which is assigned sequentially.
+    uint32_t id;
+    bool completed;
+    std::unique_ptr<QuicBatchWriterBuffer> buffer;
+  };
+
+  // Marks the sends with IDs in [first_id, last_id] as completed.
+  void OnSendsCompleted(uint32_t first_id, uint32_t last_id, bool copied);
+
+  // Returns a spare batch buffer, or nullptr if kMaxBuffersInFlight buffers
+  // are in flight.
+  std::unique_ptr<QuicBatchWriterBuffer> GetSpareBuffer();
+
+  bool zero_copy_enabled_;
+  // ID of the next zero copy send.
+  uint32_t next_send_id_;
+  quiche::QuicheCircularDeque<SendInFlight> sends_in_flight_;
+  std::vector<std::unique_ptr<QuicBatchWriterBuffer>> spare_buffers_;
+  Stats stats_;
+};
+
+}  // namespace quic
+
+#endif  // QUICHE_QUIC_CORE_BATCH_WRITER_QUIC_ZERO_COPY_BATCH_WRITER_H_
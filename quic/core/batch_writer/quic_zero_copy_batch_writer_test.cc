@@ -0,0 +1,151 @@
+// Copyright (c) 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "quic/core/batch_writer/quic_zero_copy_batch_writer.h"
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <memory>
+
+#include "quic/core/quic_udp_socket.h"
+#include "quic/platform/api/quic_test.h"
+
+namespace quic {
+namespace test {
+namespace {
+
+const size_t kPacketSize = 1000;
+// Enough packets for a GSO batch to be sent with zero copy.
+const size_t kPacketsPerLargeBatch =
+    QuicZeroCopyBatchWriter::kMinZeroCopyBytes / kPacketSize + 1;
+
+class QuicZeroCopyBatchWriterTest : public QuicTest {
+ protected:
+  ~QuicZeroCopyBatchWriterTest() override {
+    writer_.reset();
+    for (int fd : {self_fd_, peer_fd_}) {
+      if (fd >= 0) {
+        close(fd);
+      }
+    }
+  }
+
+  // Returns false if zero copy sends are not supported.
+  bool Initialize() {
+    self_fd_ = CreateSocket(&self_address_);
+    peer_fd_ = CreateSocket(&peer_address_);
+    writer_ = std::make_unique<QuicZeroCopyBatchWriter>(self_fd_);
+    if (!writer_->Initialize()) {
+      QUIC_LOG(WARNING) << "Test skipped since SO_ZEROCOPY is not supported.";
+      return false;
+    }
+    return true;
+  }
+
+  int CreateSocket(QuicSocketAddress* address) {
+    QuicUdpSocketApi socket_api;
+    int fd = socket_api.Create(AF_INET, kDefaultSocketReceiveBuffer,
+                               kDefaultSocketReceiveBuffer);
+    EXPECT_GE(fd, 0);
+    EXPECT_TRUE(
+        socket_api.Bind(fd, QuicSocketAddress(QuicIpAddress::Loopback4(), 0)));
+    EXPECT_EQ(0, address->FromSocket(fd));
+    return fd;
+  }
+
+  // Writes |num_packets| packets to the peer and flushes them as one batch.
+  void WriteBatch(size_t num_packets) {
+    char buffer[kPacketSize];
+    memset(buffer, 'a', sizeof(buffer));
+    for (size_t i = 0; i < num_packets; ++i) {
+      ASSERT_EQ(WRITE_STATUS_OK,
+                writer_
+                    ->WritePacket(buffer, sizeof(buffer), self_address_.host(),
+                                  peer_address_, nullptr)
+                    .status);
+    }
+    ASSERT_EQ(WRITE_STATUS_OK, writer_->Flush().status);
+  }
+
+  // Waits for all zero copy sends to complete.
+  void WaitForCompletions() {
+    for (int i = 0; i < 1000 && writer_->num_sends_in_flight() > 0; ++i) {
+      pollfd poll_fd = {self_fd_, /*events=*/0, /*revents=*/0};
+      poll(&poll_fd, 1, /*timeout=*/1);
+      writer_->ProcessCompletions();
+    }
+    ASSERT_EQ(0u, writer_->num_sends_in_flight());
+  }
+
+  // Returns the number of packets read from the peer socket.
+  int ReadPackets() {
+    int packets = 0;
+    char buffer[kPacketSize + 1];
+    while (recv(peer_fd_, buffer, sizeof(buffer), MSG_DONTWAIT) ==
+           static_cast<ssize_t>(kPacketSize)) {
+      ++packets;
+    }
+    return packets;
+  }
+
+  QuicSocketAddress self_address_;
+  QuicSocketAddress peer_address_;
+  int self_fd_ = -1;
+  int peer_fd_ = -1;
+  std::unique_ptr<QuicZeroCopyBatchWriter> writer_;
+};
+
+TEST_F(QuicZeroCopyBatchWriterTest, SmallBatchesAreCopied) {
+  if (!Initialize()) {
+    return;
+  }
+
+  WriteBatch(3);
+  EXPECT_EQ(0u, writer_->stats().zero_copy_sends);
+  EXPECT_EQ(0u, writer_->num_sends_in_flight());
+  EXPECT_EQ(3, ReadPackets());
+}
+
+TEST_F(QuicZeroCopyBatchWriterTest, LargeBatchesSentWithZeroCopy) {
+  if (!Initialize()) {
+    return;
+  }
+
+  WriteBatch(kPacketsPerLargeBatch);
+  EXPECT_EQ(1u, writer_->stats().zero_copy_sends);
+  EXPECT_EQ(0u, writer_->stats().copied_sends);
+  EXPECT_EQ(1u, writer_->num_sends_in_flight());
+
+  WaitForCompletions();
+  EXPECT_EQ(1u, writer_->stats().completed_sends);
+  EXPECT_EQ(static_cast<int>(kPacketsPerLargeBatch), ReadPackets());
+}
+
+TEST_F(QuicZeroCopyBatchWriterTest, BuffersReclaimed) {
+  if (!Initialize()) {
+    return;
+  }
+
+  // Once all buffers are in flight, completed sends are reclaimed to make room
+  // for the next batch.
+  const size_t kNumBatches = 2 * QuicZeroCopyBatchWriter::kMaxBuffersInFlight;
+  for (size_t i = 0; i < kNumBatches; ++i) {
+    WriteBatch(kPacketsPerLargeBatch);
+    EXPECT_LE(writer_->num_sends_in_flight(),
+              QuicZeroCopyBatchWriter::kMaxBuffersInFlight);
+    // Keep the peer's receive buffer from overflowing.
+    EXPECT_EQ(static_cast<int>(kPacketsPerLargeBatch), ReadPackets());
+  }
+  WaitForCompletions();
+  EXPECT_EQ(kNumBatches, writer_->stats().zero_copy_sends +
+                             writer_->stats().copied_sends);
+  EXPECT_EQ(writer_->stats().zero_copy_sends,
+            writer_->stats().completed_sends);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace quic
@@ -170,6 +170,10 @@ void Bbr2NetworkModel::OnCongestionEventStart(
     inflight_latest_ = sample.sample_max_inflight;
   }
 
+  if (congestion_event->end_of_round_trip) {
+    UpdateEcnAlpha();
+  }
+
   // Adapt lower bounds(bandwidth_lo and inflight_lo).
   AdaptLowerBounds(*congestion_event);
 
@@ -212,6 +216,18 @@ void Bbr2NetworkModel::AdaptLowerBounds(
       inflight_lo_ = std::max<QuicByteCount>(
           inflight_latest_, inflight_lo_ * (1.0 - Params().beta));
     }
+
+    if (ce_marks_in_round_ > 0 && Params().ecn_factor > 0 &&
+        !Params().ignore_inflight_lo) {
+      // Cut inflight_lo in proportion to the recent fraction of CE marks, as
+      // DCTCP does, rather than by beta as upon losses.
+      if (inflight_lo_ == inflight_lo_default()) {
+        inflight_lo_ = congestion_event.prior_cwnd;
+      }
+      inflight_lo_ = inflight_lo_ * (1.0 - ecn_alpha_ * Params().ecn_factor);
+      QUIC_DVLOG(3) << "inflight_lo_ updated to " << inflight_lo_
+                    << " upon CE marks, ecn_alpha_ is " << ecn_alpha_;
+    }
     return;
   }
 
@@ -344,6 +360,15 @@ bool Bbr2NetworkModel::IsInflightTooHigh(
     return false;
   }
 
+  if (ce_marks_in_round_ > 0 &&
+      ce_marks_in_round_ >
+          ect_packets_acked_in_round_ * Params().ecn_threshold) {
+    QUIC_DVLOG(3) << "IsInflightTooHigh: ce_marks_in_round:"
+                  << ce_marks_in_round_ << ", ect_packets_acked_in_round:"
+                  << ect_packets_acked_in_round_;
+    return true;
+  }
+
   if (loss_events_in_round() < max_loss_events) {
     return false;
   }
@@ -377,9 +402,22 @@ void Bbr2NetworkModel::RestartRoundEarly() {
   round_trip_counter_.RestartRound();
 }
 
+void Bbr2NetworkModel::UpdateEcnAlpha() {
+  if (Params().ecn_factor == 0 || ect_packets_acked_in_round_ == 0) {
+    return;
+  }
+  const float ce_fraction =
+      std::min(1.0f, static_cast<float>(ce_marks_in_round_) /
+                         ect_packets_acked_in_round_);
+  ecn_alpha_ = (1 - Params().ecn_alpha_gain) * ecn_alpha_ +
+               Params().ecn_alpha_gain * ce_fraction;
+}
+
 void Bbr2NetworkModel::OnNewRound() {
   bytes_lost_in_round_ = 0;
   loss_events_in_round_ = 0;
+  ect_packets_acked_in_round_ = 0;
+  ce_marks_in_round_ = 0;
   max_bytes_delivered_in_round_ = 0;
 }
 
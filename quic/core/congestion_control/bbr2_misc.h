@@ -136,6 +136,12 @@ struct QUIC_EXPORT_PRIVATE Bbr2Params {
   float probe_bw_default_pacing_gain = 1.0;
 
   float probe_bw_cwnd_gain = 2.0;
+  // The cwnd gain in the PROBE_UP phase, other phases use probe_bw_cwnd_gain.
+  float probe_bw_probe_up_cwnd_gain = 2.0;
+
+  // If true, PROBE_UP checks whether a queue is building up once it has lasted
+  // a min rtt, as TCP BBR does, instead of after a full round.
+  bool probe_bw_check_queuing_after_min_rtt = false;
 
   /*
    * PROBE_RTT parameters.
@@ -160,10 +166,24 @@ struct QUIC_EXPORT_PRIVATE Bbr2Params {
   // Estimate startup/bw probing has gone too far if loss rate exceeds this.
   float loss_threshold = GetQuicFlag(FLAGS_quic_bbr2_default_loss_threshold);
 
+  // Estimate startup/bw probing has gone too far if the fraction of
+  // ECN-capable packets acked in a round that were CE-marked exceeds this.
+  float ecn_threshold = 0.5;
+
   // A common factor for multiplicative decreases. Used for adjusting
   // bandwidth_lo, inflight_lo and inflight_hi upon losses.
   float beta = 0.3;
 
+  // If non-zero, inflight_lo is cut at the end of each round with CE marks by
+  // ecn_factor times a moving average of the fraction of CE-marked packets,
+  // which is updated with a gain of ecn_alpha_gain once per round.
+  float ecn_factor = 0.0;
+  float ecn_alpha_gain = 1.0 / 16;
+
+  // Fraction of the bandwidth estimate which is left unused when pacing, so
+  // that pacing at the estimate doesn't build a standing queue.
+  float pacing_margin = 0.0;
+
   Limits<QuicByteCount> cwnd_limits;
 
   /*
@@ -455,6 +475,20 @@ class QUIC_EXPORT_PRIVATE Bbr2NetworkModel {
 
   int64_t loss_events_in_round() const { return loss_events_in_round_; }
 
+  // Called before OnCongestionEventStart with the ECN feedback of the ack
+  // frame that caused the congestion event.
+  void OnEcnFeedback(QuicPacketCount newly_acked_ect,
+                     QuicPacketCount newly_acked_ce) {
+    ect_packets_acked_in_round_ += newly_acked_ect;
+    ce_marks_in_round_ += newly_acked_ce;
+  }
+
+  QuicPacketCount ce_marks_in_round() const { return ce_marks_in_round_; }
+
+  // Moving average of the fraction of ECN-capable packets acked per round
+  // which were CE-marked. Only updated if Params().ecn_factor is non-zero.
+  float ecn_alpha() const { return ecn_alpha_; }
+
   QuicByteCount max_bytes_delivered_in_round() const {
     return max_bytes_delivered_in_round_;
   }
@@ -506,6 +540,9 @@ class QUIC_EXPORT_PRIVATE Bbr2NetworkModel {
   // Called when a new round trip starts.
   void OnNewRound();
 
+  // Called at the end of a round, before its ECN counts are cleared.
+  void UpdateEcnAlpha();
+
   const Bbr2Params& Params() const { return *params_; }
   const Bbr2Params* const params_;
   RoundTripCounter round_trip_counter_;
@@ -523,6 +560,13 @@ class QUIC_EXPORT_PRIVATE Bbr2NetworkModel {
   // Number of loss marking events in the current round.
   int64_t loss_events_in_round_ = 0;
 
+  // ECN-capable packets acked in the current round, and how many of them were
+  // CE-marked.
+  QuicPacketCount ect_packets_acked_in_round_ = 0;
+  QuicPacketCount ce_marks_in_round_ = 0;
+  // Starts at 1, as in DCTCP, so that the first CE marks get a full response.
+  float ecn_alpha_ = 1.0;
+
   // A max of bytes delivered among all congestion events in the current round.
   // A congestions event's bytes delivered is the total bytes acked between time
   // Ts and Ta, which is the time when the largest acked packet(within the
@@ -73,7 +73,7 @@ Bbr2Mode Bbr2ProbeBwMode::OnCongestionEvent(
   // when Bbr2ProbeRttMode::Enter is called.
   if (!switch_to_probe_rtt) {
     model_->set_pacing_gain(PacingGainForPhase(cycle_.phase));
-    model_->set_cwnd_gain(Params().probe_bw_cwnd_gain);
+    model_->set_cwnd_gain(CwndGainForPhase(cycle_.phase));
   }
 
   return switch_to_probe_rtt ? Bbr2Mode::PROBE_RTT : Bbr2Mode::PROBE_BW;
@@ -430,7 +430,9 @@ void Bbr2ProbeBwMode::UpdateProbeUp(
                   << ", inflight_hi:" << model_->inflight_hi();
     // TCP uses min_rtt instead of a full round:
     //   HasPhaseLasted(model_->MinRtt(), congestion_event)
-  } else if (cycle_.rounds_in_phase > 0) {
+  } else if (Params().probe_bw_check_queuing_after_min_rtt
+                 ? HasPhaseLasted(model_->MinRtt(), congestion_event)
+                 : cycle_.rounds_in_phase > 0) {
     const QuicByteCount bdp = model_->BDP();
     QuicByteCount queuing_threshold_extra_bytes = 2 * kDefaultTCPMSS;
     if (Params().add_ack_height_to_queueing_threshold) {
@@ -617,4 +619,12 @@ float Bbr2ProbeBwMode::PacingGainForPhase(
   return Params().probe_bw_default_pacing_gain;
 }
 
+float Bbr2ProbeBwMode::CwndGainForPhase(
+    Bbr2ProbeBwMode::CyclePhase phase) const {
+  if (phase == Bbr2ProbeBwMode::CyclePhase::PROBE_UP) {
+    return Params().probe_bw_probe_up_cwnd_gain;
+  }
+  return Params().probe_bw_cwnd_gain;
+}
+
 }  // namespace quic
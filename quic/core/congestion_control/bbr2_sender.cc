@@ -28,6 +28,16 @@ const QuicByteCount kDefaultMinimumCongestionWindow = 4 * kMaxSegmentSize;
 
 const float kInitialPacingGain = 2.885f;
 
+// BBRv3 gains. The STARTUP pacing gain is the lowest one which doubles the
+// sending rate every round, 4 * ln(2).
+const float kBbr3StartupPacingGain = 2.773f;
+const float kBbr3DrainPacingGain = 0.35f;
+const float kBbr3ProbeDownPacingGain = 0.9f;
+const float kBbr3ProbeUpCwndGain = 2.25f;
+const float kBbr3PacingMargin = 0.01f;
+const float kBbr3EcnFactor = 1.0f / 3;
+const int64_t kBbr3StartupFullLossCount = 6;
+
 const int kMaxModeChangesPerCongestionEvent = 4;
 }  // namespace
 
@@ -160,6 +170,26 @@ void Bbr2Sender::ApplyConnectionOptions(
   }
 }
 
+void Bbr2Sender::EnableBbr3Model() {
+  QUICHE_DCHECK_EQ(mode_, Bbr2Mode::STARTUP);
+  bbr3_model_ = true;
+
+  params_.startup_pacing_gain = kBbr3StartupPacingGain;
+  params_.startup_full_loss_count = kBbr3StartupFullLossCount;
+  params_.always_exit_startup_on_excess_loss = true;
+  params_.drain_pacing_gain = kBbr3DrainPacingGain;
+  params_.probe_bw_probe_down_pacing_gain = kBbr3ProbeDownPacingGain;
+  params_.probe_bw_probe_up_cwnd_gain = kBbr3ProbeUpCwndGain;
+  params_.probe_bw_check_queuing_after_min_rtt = true;
+  params_.pacing_margin = kBbr3PacingMargin;
+  params_.ecn_factor = kBbr3EcnFactor;
+
+  model_.set_pacing_gain(params_.startup_pacing_gain);
+  pacing_rate_ = params_.startup_pacing_gain *
+                 QuicBandwidth::FromBytesAndTimeDelta(
+                     cwnd_, rtt_stats_->SmoothedOrInitialRtt());
+}
+
 Limits<QuicByteCount> Bbr2Sender::GetCwndLimitsByMode() const {
   switch (mode_) {
     case Bbr2Mode::STARTUP:
@@ -318,7 +348,9 @@ void Bbr2Sender::UpdatePacingRate(QuicByteCount bytes_acked) {
     return;
   }
 
-  QuicBandwidth target_rate = model_.pacing_gain() * model_.BandwidthEstimate();
+  QuicBandwidth target_rate = model_.pacing_gain() *
+                              (1 - Params().pacing_margin) *
+                              model_.BandwidthEstimate();
   if (model_.full_bandwidth_reached()) {
     pacing_rate_ = target_rate;
     return;
@@ -434,6 +466,14 @@ void Bbr2Sender::PopulateConnectionStats(QuicConnectionStats* stats) const {
   stats->num_ack_aggregation_epochs = model_.num_ack_aggregation_epochs();
 }
 
+void Bbr2Sender::OnEcnFeedback(QuicTime /*event_time*/,
+                               QuicPacketNumber /*largest_acked*/,
+                               QuicByteCount /*prior_in_flight*/,
+                               QuicPacketCount newly_acked_ect,
+                               QuicPacketCount newly_acked_ce) {
+  model_.OnEcnFeedback(newly_acked_ect, newly_acked_ce);
+}
+
 void Bbr2Sender::OnEnterQuiescence(QuicTime now) {
   last_quiescence_start_ = now;
 }
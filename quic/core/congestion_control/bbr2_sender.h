@@ -88,7 +88,7 @@ class QUIC_EXPORT_PRIVATE Bbr2Sender final : public SendAlgorithmInterface {
   QuicByteCount GetSlowStartThreshold() const override { return 0; }
 
   CongestionControlType GetCongestionControlType() const override {
-    return kBBRv2;
+    return bbr3_model_ ? kBBRv3 : kBBRv2;
   }
 
   std::string GetDebugState() const override;
@@ -96,8 +96,23 @@ class QUIC_EXPORT_PRIVATE Bbr2Sender final : public SendAlgorithmInterface {
   void OnApplicationLimited(QuicByteCount bytes_in_flight) override;
 
   void PopulateConnectionStats(QuicConnectionStats* stats) const override;
+
+  QuicEcnCodepoint GetEcnCodepointToSend() const override { return ECN_ECT0; }
+
+  void OnEcnFeedback(QuicTime event_time,
+                     QuicPacketNumber largest_acked,
+                     QuicByteCount prior_in_flight,
+                     QuicPacketCount newly_acked_ect,
+                     QuicPacketCount newly_acked_ce) override;
   // End implementation of SendAlgorithmInterface.
 
+  // Switches to the parameters of the BBRv3 model: lower STARTUP and DRAIN
+  // pacing gains, a gentler PROBE_DOWN, a larger PROBE_UP cwnd gain, a pacing
+  // margin, and ECN-proportional cuts of inflight_lo. STARTUP always exits
+  // once the loss rate is too high. Must be called right after
+  // construction. Connection options applied afterwards still override these.
+  void EnableBbr3Model();
+
   const Bbr2Params& Params() const { return params_; }
 
   QuicByteCount GetMinimumCongestionWindow() const {
@@ -198,6 +213,9 @@ class QUIC_EXPORT_PRIVATE Bbr2Sender final : public SendAlgorithmInterface {
   Bbr2ProbeBwMode probe_bw_;
   Bbr2ProbeRttMode probe_rtt_;
 
+  // Whether EnableBbr3Model() has been called.
+  bool bbr3_model_ = false;
+
   // Debug only.
   bool last_sample_is_app_limited_;
 
@@ -463,6 +463,41 @@ TEST_F(Bbr2DefaultTopologyTest, SimpleTransferSmallBufferB2H2) {
   EXPECT_FALSE(sender_->ExportDebugState().last_sample_is_app_limited);
 }
 
+TEST_F(Bbr2DefaultTopologyTest, SimpleTransferBbr3) {
+  sender_->EnableBbr3Model();
+  EXPECT_EQ(kBBRv3, sender_->GetCongestionControlType());
+  DefaultTopologyParams params;
+  CreateNetwork(params);
+
+  // Verify that pacing rate is based on the initial RTT and the BBRv3 STARTUP
+  // pacing gain.
+  QuicBandwidth expected_pacing_rate = QuicBandwidth::FromBytesAndTimeDelta(
+      2.773 * kDefaultInitialCwndBytes, rtt_stats()->initial_rtt());
+  EXPECT_APPROX_EQ(expected_pacing_rate.ToBitsPerSecond(),
+                   sender_->PacingRate(0).ToBitsPerSecond(), 0.01f);
+
+  DoSimpleTransfer(12 * 1024 * 1024, QuicTime::Delta::FromSeconds(30));
+  EXPECT_TRUE(Bbr2ModeIsOneOf({Bbr2Mode::PROBE_BW, Bbr2Mode::PROBE_RTT}));
+  EXPECT_EQ(0u, sender_connection_stats().packets_lost);
+  EXPECT_APPROX_EQ(params.BottleneckBandwidth(),
+                   sender_->ExportDebugState().bandwidth_hi, 0.01f);
+  EXPECT_APPROX_EQ(params.RTT(), rtt_stats()->smoothed_rtt(), 1.0f);
+}
+
+TEST_F(Bbr2DefaultTopologyTest, SimpleTransferSmallBufferBbr3) {
+  sender_->EnableBbr3Model();
+  DefaultTopologyParams params;
+  params.switch_queue_capacity_in_bdp = 0.5;
+  CreateNetwork(params);
+
+  DoSimpleTransfer(12 * 1024 * 1024, QuicTime::Delta::FromSeconds(30));
+  EXPECT_TRUE(Bbr2ModeIsOneOf({Bbr2Mode::PROBE_BW, Bbr2Mode::PROBE_RTT}));
+  EXPECT_APPROX_EQ(params.BottleneckBandwidth(),
+                   sender_->ExportDebugState().bandwidth_hi, 0.02f);
+  EXPECT_LE(sender_loss_rate_in_packets(), 0.05);
+  EXPECT_FALSE(sender_->ExportDebugState().last_sample_is_app_limited);
+}
+
 TEST_F(Bbr2DefaultTopologyTest, SimpleTransfer2RTTAggregationBytes) {
   SetConnectionOption(kBSAO);
   DefaultTopologyParams params;
@@ -1464,6 +1499,105 @@ class Bbr2MultiSenderTest : public Bbr2SimulatorTest {
   std::vector<std::unique_ptr<simulator::SymmetricLink>> network_links_;
 };
 
+// Runs one bulk transfer at a time over the same bottleneck, by BBRv2, by
+// BBRv2 with the BBRv3 model and by Cubic, and compares their goodput,
+// queueing delay and retransmission rate.
+class Bbr3ComparisonTest : public Bbr2MultiSenderTest {
+ protected:
+  struct TransferResult {
+    QuicBandwidth goodput = QuicBandwidth::Zero();
+    // Average of latest_rtt - min_rtt, sampled every kSampleInterval.
+    QuicTime::Delta queueing_delay = QuicTime::Delta::Zero();
+    // Fraction of the bytes sent which were retransmissions.
+    float retransmission_rate = 0;
+  };
+
+  static constexpr QuicTime::Delta kSampleInterval =
+      QuicTime::Delta::FromMilliseconds(10);
+
+  void SetUpSenders() {
+    SetupBbr2Sender(sender_endpoints_[1].get())->EnableBbr3Model();
+    SetupTcpSender(sender_endpoints_[2].get(), /*reno=*/false);
+  }
+
+  TransferResult RunTransfer(size_t which, QuicByteCount transfer_size) {
+    const RttStats* rtt_stats =
+        sender_connection(which)->sent_packet_manager().GetRttStats();
+    const QuicTime start = SimulatedNow();
+    const QuicTime deadline = start + QuicTime::Delta::FromSeconds(120);
+    QuicTime::Delta total_queueing_delay = QuicTime::Delta::Zero();
+    int64_t num_samples = 0;
+
+    sender_endpoints_[which]->AddBytesToTransfer(transfer_size);
+    while (receiver_endpoints_[which]->bytes_received() < transfer_size &&
+           SimulatedNow() < deadline) {
+      simulator_.RunFor(kSampleInterval);
+      if (!rtt_stats->latest_rtt().IsZero()) {
+        total_queueing_delay =
+            total_queueing_delay + rtt_stats->latest_rtt() -
+            rtt_stats->min_rtt();
+        ++num_samples;
+      }
+    }
+    EXPECT_EQ(transfer_size, receiver_endpoints_[which]->bytes_received());
+
+    TransferResult result;
+    result.goodput = QuicBandwidth::FromBytesAndTimeDelta(
+        receiver_endpoints_[which]->bytes_received(), SimulatedNow() - start);
+    if (num_samples > 0) {
+      result.queueing_delay = QuicTime::Delta::FromMicroseconds(
+          total_queueing_delay.ToMicroseconds() / num_samples);
+    }
+    const QuicConnectionStats& stats = sender_connection_stats(which);
+    result.retransmission_rate =
+        static_cast<float>(stats.bytes_retransmitted) / stats.bytes_sent;
+    QUIC_LOG(INFO) << sender_connection(which)
+                          ->sent_packet_manager()
+                          .GetSendAlgorithm()
+                          ->GetCongestionControlType()
+                   << ": goodput " << result.goodput << ", queueing delay "
+                   << result.queueing_delay << ", retransmission rate "
+                   << 100 * result.retransmission_rate << "%";
+    return result;
+  }
+};
+
+TEST_F(Bbr3ComparisonTest, QUIC_SLOW_TEST(ShallowBuffer)) {
+  SetUpSenders();
+  MultiSenderTopologyParams params;
+  params.switch_queue_capacity_in_bdp = 0.5;
+  CreateNetwork(params);
+
+  const QuicByteCount transfer_size = 10 * 1024 * 1024;
+  const TransferResult bbr2 = RunTransfer(0, transfer_size);
+  const TransferResult bbr3 = RunTransfer(1, transfer_size);
+  const TransferResult cubic = RunTransfer(2, transfer_size);
+
+  EXPECT_GE(bbr3.goodput, 0.8 * params.BottleneckBandwidth());
+  EXPECT_GE(bbr3.goodput, 0.9 * bbr2.goodput);
+  EXPECT_LE(bbr3.retransmission_rate, 0.05);
+  EXPECT_LE(bbr3.queueing_delay, cubic.queueing_delay);
+}
+
+TEST_F(Bbr3ComparisonTest, QUIC_SLOW_TEST(DeepBuffer)) {
+  SetUpSenders();
+  MultiSenderTopologyParams params;
+  params.switch_queue_capacity_in_bdp = 10;
+  CreateNetwork(params);
+
+  const QuicByteCount transfer_size = 10 * 1024 * 1024;
+  const TransferResult bbr2 = RunTransfer(0, transfer_size);
+  const TransferResult bbr3 = RunTransfer(1, transfer_size);
+  const TransferResult cubic = RunTransfer(2, transfer_size);
+
+  EXPECT_GE(bbr3.goodput, 0.8 * params.BottleneckBandwidth());
+  EXPECT_GE(bbr3.goodput, 0.9 * bbr2.goodput);
+  EXPECT_EQ(0u, sender_connection_stats(1).packets_lost);
+  // Cubic fills the deep buffer, BBR keeps the queue near one BDP at most.
+  EXPECT_LT(bbr3.queueing_delay, cubic.queueing_delay);
+  EXPECT_LE(bbr3.queueing_delay, params.Rtt(1));
+}
+
 TEST_F(Bbr2MultiSenderTest, Bbr2VsBbr2) {
   SetupBbr2Sender(sender_endpoints_[1].get());
 
@@ -133,6 +133,14 @@ class QUIC_EXPORT_PRIVATE BbrSender : public SendAlgorithmInterface {
   std::string GetDebugState() const override;
   void OnApplicationLimited(QuicByteCount bytes_in_flight) override;
   void PopulateConnectionStats(QuicConnectionStats* stats) const override;
+  QuicEcnCodepoint GetEcnCodepointToSend() const override {
+    return ECN_NOT_ECT;
+  }
+  void OnEcnFeedback(QuicTime /*event_time*/,
+                     QuicPacketNumber /*largest_acked*/,
+                     QuicByteCount /*prior_in_flight*/,
+                     QuicPacketCount /*newly_acked_ect*/,
+                     QuicPacketCount /*newly_acked_ce*/) override {}
   // End implementation of SendAlgorithmInterface.
 
   // Gets the number of RTTs BBR remains in STARTUP phase.
@@ -77,6 +77,21 @@ LossDetectionInterface::DetectionStats GeneralLossAlgorithm::DetectLosses(
       packet_number = least_in_flight_;
     }
   }
+  if (unacked_packets.use_in_flight_index() &&
+      packet_number_space_ < NUM_PACKET_NUMBER_SPACES) {
+    // Packets before the least in flight packet of this packet number space
+    // would all be skipped below, so start from there directly.
+    const QuicPacketNumber least_in_flight_of_space =
+        unacked_packets.GetLeastInFlightPacketOfSpace(packet_number_space_);
+    if (!least_in_flight_of_space.IsInitialized()) {
+      if (packet_number <= largest_newly_acked) {
+        packet_number = largest_newly_acked + 1;
+      }
+    } else if (least_in_flight_of_space > packet_number) {
+      it += (least_in_flight_of_space - packet_number);
+      packet_number = least_in_flight_of_space;
+    }
+  }
   // Clear least_in_flight_.
   least_in_flight_.Clear();
   QUICHE_DCHECK_EQ(packet_number_space_,
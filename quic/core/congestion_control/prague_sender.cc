@@ -0,0 +1,67 @@
+// Copyright (c) 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "quic/core/congestion_control/prague_sender.h"
+
+#include <algorithm>
+
+#include "quic/platform/api/quic_logging.h"
+
+namespace quic {
+
+PragueSender::PragueSender(const QuicClock* clock,
+                           const RttStats* rtt_stats,
+                           QuicPacketCount initial_tcp_congestion_window,
+                           QuicPacketCount max_congestion_window,
+                           QuicConnectionStats* stats)
+    : TcpCubicSenderBytes(clock,
+                          rtt_stats,
+                          /*reno=*/true,
+                          initial_tcp_congestion_window,
+                          max_congestion_window,
+                          stats),
+      alpha_(1.0f),
+      ect_packets_in_round_(0),
+      ce_marks_in_round_(0) {
+  SetNumEmulatedConnections(1);
+}
+
+CongestionControlType PragueSender::GetCongestionControlType() const {
+  return kPragueBytes;
+}
+
+QuicEcnCodepoint PragueSender::GetEcnCodepointToSend() const {
+  return ECN_ECT1;
+}
+
+void PragueSender::OnEcnFeedback(QuicTime /*event_time*/,
+                                 QuicPacketNumber largest_acked,
+                                 QuicByteCount prior_in_flight,
+                                 QuicPacketCount newly_acked_ect,
+                                 QuicPacketCount newly_acked_ce) {
+  ect_packets_in_round_ += newly_acked_ect;
+  ce_marks_in_round_ += newly_acked_ce;
+  if (!round_end_.IsInitialized()) {
+    round_end_ = largest_sent_packet_number();
+  } else if (largest_acked > round_end_) {
+    if (ect_packets_in_round_ > 0) {
+      const float marked_fraction =
+          std::min(1.0f, static_cast<float>(ce_marks_in_round_) /
+                             ect_packets_in_round_);
+      alpha_ = (1 - kAlphaGain) * alpha_ + kAlphaGain * marked_fraction;
+    }
+    ect_packets_in_round_ = 0;
+    ce_marks_in_round_ = 0;
+    round_end_ = largest_sent_packet_number();
+  }
+
+  if (newly_acked_ce == 0 || !IsNewCongestionEvent(largest_acked)) {
+    return;
+  }
+  EnterRecovery(GetCongestionWindow() * (1 - alpha_ / 2), prior_in_flight);
+  QUIC_DVLOG(1) << "Incoming CE mark; alpha: " << alpha_
+                << " congestion window: " << GetCongestionWindow();
+}
+
+}  // namespace quic
@@ -0,0 +1,57 @@
+// Copyright (c) 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// A simplified TCP Prague sender for L4S: Reno congestion avoidance and loss
+// response, and a DCTCP-style response to CE marks that is proportional to
+// the fraction of packets marked.
+
+#ifndef QUICHE_QUIC_CORE_CONGESTION_CONTROL_PRAGUE_SENDER_H_
+#define QUICHE_QUIC_CORE_CONGESTION_CONTROL_PRAGUE_SENDER_H_
+
+#include "quic/core/congestion_control/tcp_cubic_sender_bytes.h"
+#include "quic/core/quic_packet_number.h"
+#include "quic/core/quic_types.h"
+#include "quic/platform/api/quic_export.h"
+
+namespace quic {
+
+class QUIC_EXPORT_PRIVATE PragueSender : public TcpCubicSenderBytes {
+ public:
+  // Gain of the moving average of the fraction of CE-marked packets.
+  static constexpr float kAlphaGain = 1.0f / 16;
+
+  PragueSender(const QuicClock* clock,
+               const RttStats* rtt_stats,
+               QuicPacketCount initial_tcp_congestion_window,
+               QuicPacketCount max_congestion_window,
+               QuicConnectionStats* stats);
+  PragueSender(const PragueSender&) = delete;
+  PragueSender& operator=(const PragueSender&) = delete;
+
+  // Start implementation of SendAlgorithmInterface.
+  CongestionControlType GetCongestionControlType() const override;
+  QuicEcnCodepoint GetEcnCodepointToSend() const override;
+  void OnEcnFeedback(QuicTime event_time,
+                     QuicPacketNumber largest_acked,
+                     QuicByteCount prior_in_flight,
+                     QuicPacketCount newly_acked_ect,
+                     QuicPacketCount newly_acked_ce) override;
+  // End implementation of SendAlgorithmInterface.
+
+  // Moving average of the fraction of ECN-capable packets that were
+  // CE-marked, updated once per round trip.
+  float alpha() const { return alpha_; }
+
+ private:
+  float alpha_;
+  // ECN-capable and CE-marked packets acked in the current round trip.
+  QuicPacketCount ect_packets_in_round_;
+  QuicPacketCount ce_marks_in_round_;
+  // The round trip ends when a packet sent after this one is acked.
+  QuicPacketNumber round_end_;
+};
+
+}  // namespace quic
+
+#endif  // QUICHE_QUIC_CORE_CONGESTION_CONTROL_PRAGUE_SENDER_H_
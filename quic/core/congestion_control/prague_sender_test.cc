@@ -0,0 +1,90 @@
+// Copyright (c) 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "quic/core/congestion_control/prague_sender.h"
+
+#include "quic/core/congestion_control/rtt_stats.h"
+#include "quic/core/quic_connection_stats.h"
+#include "quic/platform/api/quic_test.h"
+#include "quic/test_tools/mock_clock.h"
+
+namespace quic {
+namespace test {
+namespace {
+
+const QuicPacketCount kInitialCongestionWindowPackets = 10;
+const QuicPacketCount kMaxCongestionWindowPackets = 200;
+
+class PragueSenderTest : public QuicTest {
+ protected:
+  PragueSenderTest()
+      : sender_(&clock_,
+                &rtt_stats_,
+                kInitialCongestionWindowPackets,
+                kMaxCongestionWindowPackets,
+                &stats_) {}
+
+  // Sends one congestion window of packets.
+  void SendWindow() {
+    QuicByteCount bytes_in_flight = 0;
+    while (sender_.CanSend(bytes_in_flight)) {
+      sender_.OnPacketSent(clock_.Now(), bytes_in_flight,
+                           QuicPacketNumber(++packet_number_), kDefaultTCPMSS,
+                           HAS_RETRANSMITTABLE_DATA);
+      bytes_in_flight += kDefaultTCPMSS;
+    }
+  }
+
+  MockClock clock_;
+  RttStats rtt_stats_;
+  QuicConnectionStats stats_;
+  PragueSender sender_;
+  uint64_t packet_number_ = 0;
+};
+
+TEST_F(PragueSenderTest, Basics) {
+  EXPECT_EQ(kPragueBytes, sender_.GetCongestionControlType());
+  EXPECT_EQ(ECN_ECT1, sender_.GetEcnCodepointToSend());
+  EXPECT_EQ(1.0f, sender_.alpha());
+}
+
+TEST_F(PragueSenderTest, ResponseProportionalToAlpha) {
+  SendWindow();
+  const QuicByteCount initial_window = sender_.GetCongestionWindow();
+  // With the initial alpha of 1, the first CE mark halves the window.
+  sender_.OnEcnFeedback(clock_.Now(), QuicPacketNumber(1), initial_window, 1,
+                        1);
+  EXPECT_EQ(initial_window / 2, sender_.GetCongestionWindow());
+
+  // Further marks in the same window are ignored.
+  sender_.OnEcnFeedback(clock_.Now(), QuicPacketNumber(packet_number_),
+                        initial_window, 1, 1);
+  EXPECT_EQ(initial_window / 2, sender_.GetCongestionWindow());
+}
+
+TEST_F(PragueSenderTest, AlphaDecaysWithoutMarks) {
+  float alpha = sender_.alpha();
+  for (int i = 0; i < 10; ++i) {
+    SendWindow();
+    // Acks for the whole round, none of them CE-marked.
+    sender_.OnEcnFeedback(clock_.Now(), QuicPacketNumber(packet_number_),
+                          sender_.GetCongestionWindow(),
+                          sender_.GetCongestionWindow() / kDefaultTCPMSS, 0);
+    EXPECT_GE(alpha, sender_.alpha());
+    alpha = sender_.alpha();
+  }
+  EXPECT_GT(0.6f, sender_.alpha());
+
+  // A small alpha results in a small cutback.
+  SendWindow();
+  const QuicByteCount window = sender_.GetCongestionWindow();
+  sender_.OnEcnFeedback(clock_.Now(), QuicPacketNumber(packet_number_), window,
+                        1, 1);
+  EXPECT_LT(window / 2, sender_.GetCongestionWindow());
+  EXPECT_GT(window, sender_.GetCongestionWindow());
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace quic
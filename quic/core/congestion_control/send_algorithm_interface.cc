@@ -7,6 +7,7 @@
 #include "absl/base/attributes.h"
 #include "quic/core/congestion_control/bbr2_sender.h"
 #include "quic/core/congestion_control/bbr_sender.h"
+#include "quic/core/congestion_control/prague_sender.h"
 #include "quic/core/congestion_control/tcp_cubic_sender_bytes.h"
 #include "quic/core/quic_packets.h"
 #include "quic/platform/api/quic_bug_tracker.h"
@@ -36,13 +37,19 @@ SendAlgorithmInterface* SendAlgorithmInterface::Create(
                            initial_congestion_window, max_congestion_window,
                            random, stats);
     case kBBRv2:
-      return new Bbr2Sender(
+    case kBBRv3: {
+      Bbr2Sender* sender = new Bbr2Sender(
           clock->ApproximateNow(), rtt_stats, unacked_packets,
           initial_congestion_window, max_congestion_window, random, stats,
           old_send_algorithm &&
                   old_send_algorithm->GetCongestionControlType() == kBBR
               ? static_cast<BbrSender*>(old_send_algorithm)
               : nullptr);
+      if (congestion_control_type == kBBRv3) {
+        sender->EnableBbr3Model();
+      }
+      return sender;
+    }
     case kPCC:
       // PCC is currently not supported, fall back to CUBIC instead.
       ABSL_FALLTHROUGH_INTENDED;
@@ -54,6 +61,9 @@ SendAlgorithmInterface* SendAlgorithmInterface::Create(
       return new TcpCubicSenderBytes(clock, rtt_stats, true /* use Reno */,
                                      initial_congestion_window,
                                      max_congestion_window, stats);
+    case kPragueBytes:
+      return new PragueSender(clock, rtt_stats, initial_congestion_window,
+                              max_congestion_window, stats);
   }
   return nullptr;
 }
@@ -169,6 +169,22 @@ class QUIC_EXPORT_PRIVATE SendAlgorithmInterface {
 
   // Called before connection close to collect stats.
   virtual void PopulateConnectionStats(QuicConnectionStats* stats) const = 0;
+
+  // Returns the ECN codepoint to mark outgoing packets with once the path has
+  // been validated as ECN-capable, or ECN_NOT_ECT if the algorithm does not
+  // respond to CE marks.
+  virtual QuicEcnCodepoint GetEcnCodepointToSend() const = 0;
+
+  // Called before OnCongestionEvent when an ack frame with valid ECN counts
+  // newly acknowledges |newly_acked_ect| packets that were sent ECN-capable,
+  // |newly_acked_ce| of which were reported as CE-marked.  |largest_acked| is
+  // the largest packet acknowledged by the ack frame and |prior_in_flight|
+  // the bytes in flight before it was processed.
+  virtual void OnEcnFeedback(QuicTime event_time,
+                             QuicPacketNumber largest_acked,
+                             QuicByteCount prior_in_flight,
+                             QuicPacketCount newly_acked_ect,
+                             QuicPacketCount newly_acked_ce) = 0;
 };
 
 }  // namespace quic
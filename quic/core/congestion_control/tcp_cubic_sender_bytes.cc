@@ -295,8 +295,7 @@ void TcpCubicSenderBytes::OnPacketLost(QuicPacketNumber packet_number,
                                        QuicByteCount prior_in_flight) {
   // TCP NewReno (RFC6582) says that once a loss occurs, any losses in packets
   // already sent should be treated as a single loss event, since it's expected.
-  if (largest_sent_at_last_cutback_.IsInitialized() &&
-      packet_number <= largest_sent_at_last_cutback_) {
+  if (!IsNewCongestionEvent(packet_number)) {
     if (last_cutback_exited_slowstart_) {
       ++stats_->slowstart_packets_lost;
       stats_->slowstart_bytes_lost += lost_bytes;
@@ -317,33 +316,67 @@ void TcpCubicSenderBytes::OnPacketLost(QuicPacketNumber packet_number,
     ++stats_->slowstart_packets_lost;
   }
 
-  if (!no_prr_) {
-    prr_.OnPacketLost(prior_in_flight);
-  }
-
   // TODO(b/77268641): Separate out all of slow start into a separate class.
+  QuicByteCount congestion_window;
   if (slow_start_large_reduction_ && InSlowStart()) {
     QUICHE_DCHECK_LT(kDefaultTCPMSS, congestion_window_);
     if (congestion_window_ >= 2 * initial_tcp_congestion_window_) {
       min_slow_start_exit_window_ = congestion_window_ / 2;
     }
-    congestion_window_ = congestion_window_ - kDefaultTCPMSS;
+    congestion_window = congestion_window_ - kDefaultTCPMSS;
   } else if (reno_) {
-    congestion_window_ = congestion_window_ * RenoBeta();
+    congestion_window = congestion_window_ * RenoBeta();
   } else {
-    congestion_window_ =
+    congestion_window =
         cubic_.CongestionWindowAfterPacketLoss(congestion_window_);
   }
-  if (congestion_window_ < min_congestion_window_) {
-    congestion_window_ = min_congestion_window_;
+  EnterRecovery(congestion_window, prior_in_flight);
+  QUIC_DVLOG(1) << "Incoming loss; congestion window: " << congestion_window_
+                << " slowstart threshold: " << slowstart_threshold_;
+}
+
+QuicEcnCodepoint TcpCubicSenderBytes::GetEcnCodepointToSend() const {
+  return ECN_ECT0;
+}
+
+void TcpCubicSenderBytes::OnEcnFeedback(QuicTime /*event_time*/,
+                                        QuicPacketNumber largest_acked,
+                                        QuicByteCount prior_in_flight,
+                                        QuicPacketCount /*newly_acked_ect*/,
+                                        QuicPacketCount newly_acked_ce) {
+  // RFC 3168: a CE mark is responded to as a single loss, without
+  // retransmitting anything.
+  if (newly_acked_ce == 0 || !IsNewCongestionEvent(largest_acked)) {
+    return;
+  }
+  ++stats_->tcp_loss_events;
+  last_cutback_exited_slowstart_ = InSlowStart();
+  EnterRecovery(reno_ ? congestion_window_ * RenoBeta()
+                      : cubic_.CongestionWindowAfterPacketLoss(
+                            congestion_window_),
+                prior_in_flight);
+  QUIC_DVLOG(1) << "Incoming CE mark; congestion window: "
+                << congestion_window_
+                << " slowstart threshold: " << slowstart_threshold_;
+}
+
+bool TcpCubicSenderBytes::IsNewCongestionEvent(
+    QuicPacketNumber packet_number) const {
+  return !largest_sent_at_last_cutback_.IsInitialized() ||
+         packet_number > largest_sent_at_last_cutback_;
+}
+
+void TcpCubicSenderBytes::EnterRecovery(QuicByteCount congestion_window,
+                                        QuicByteCount prior_in_flight) {
+  if (!no_prr_) {
+    prr_.OnPacketLost(prior_in_flight);
   }
+  congestion_window_ = std::max(congestion_window, min_congestion_window_);
   slowstart_threshold_ = congestion_window_;
   largest_sent_at_last_cutback_ = largest_sent_packet_number_;
   // Reset packet count from congestion avoidance mode. We start counting again
   // when we're out of recovery.
   num_acked_packets_ = 0;
-  QUIC_DVLOG(1) << "Incoming loss; congestion window: " << congestion_window_
-                << " slowstart threshold: " << slowstart_threshold_;
 }
 
 QuicByteCount TcpCubicSenderBytes::GetCongestionWindow() const {
@@ -77,6 +77,12 @@ class QUIC_EXPORT_PRIVATE TcpCubicSenderBytes : public SendAlgorithmInterface {
   std::string GetDebugState() const override;
   void OnApplicationLimited(QuicByteCount bytes_in_flight) override;
   void PopulateConnectionStats(QuicConnectionStats* /*stats*/) const override {}
+  QuicEcnCodepoint GetEcnCodepointToSend() const override;
+  void OnEcnFeedback(QuicTime event_time,
+                     QuicPacketNumber largest_acked,
+                     QuicByteCount prior_in_flight,
+                     QuicPacketCount newly_acked_ect,
+                     QuicPacketCount newly_acked_ce) override;
   // End implementation of SendAlgorithmInterface.
 
   QuicByteCount min_congestion_window() const { return min_congestion_window_; }
@@ -105,6 +111,19 @@ class QUIC_EXPORT_PRIVATE TcpCubicSenderBytes : public SendAlgorithmInterface {
                          QuicTime event_time);
   void HandleRetransmissionTimeout();
 
+  // Returns true if a congestion signal for |packet_number| starts a new
+  // congestion event, i.e. |packet_number| was sent after the last cutback.
+  bool IsNewCongestionEvent(QuicPacketNumber packet_number) const;
+
+  // Enters recovery with |congestion_window| as the new congestion window and
+  // slow start threshold.
+  void EnterRecovery(QuicByteCount congestion_window,
+                     QuicByteCount prior_in_flight);
+
+  QuicPacketNumber largest_sent_packet_number() const {
+    return largest_sent_packet_number_;
+  }
+
  private:
   friend class test::TcpCubicSenderBytesPeer;
 
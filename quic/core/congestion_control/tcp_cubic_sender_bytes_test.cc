@@ -547,6 +547,38 @@ TEST_F(TcpCubicSenderBytesTest, MultipleLossesInOneWindow) {
   EXPECT_GT(post_loss_window, sender_->GetCongestionWindow());
 }
 
+TEST_F(TcpCubicSenderBytesTest, CeMarksInOneWindow) {
+  sender_->SetNumEmulatedConnections(1);
+  EXPECT_EQ(ECN_ECT0, sender_->GetEcnCodepointToSend());
+  SendAvailableSendWindow();
+  AckNPackets(2);
+  const QuicByteCount initial_window = sender_->GetCongestionWindow();
+  // ECN feedback without CE marks does not change the window.
+  sender_->OnEcnFeedback(clock_.Now(), QuicPacketNumber(1), bytes_in_flight_,
+                         1, 0);
+  EXPECT_EQ(initial_window, sender_->GetCongestionWindow());
+
+  sender_->OnEcnFeedback(clock_.Now(), QuicPacketNumber(2), bytes_in_flight_,
+                         1, 1);
+  // A CE mark is responded to like a single loss.
+  QuicByteCount expected_send_window = initial_window;
+  expected_send_window *= kRenoBeta;
+  const QuicByteCount post_ce_window = sender_->GetCongestionWindow();
+  EXPECT_EQ(expected_send_window, post_ce_window);
+  EXPECT_TRUE(sender_->InRecovery());
+  EXPECT_EQ(1u, sender_->stats_.tcp_loss_events);
+
+  // More CE marks on packets sent before the cutback are ignored.
+  sender_->OnEcnFeedback(clock_.Now(), QuicPacketNumber(packet_number_ - 1),
+                         bytes_in_flight_, 2, 2);
+  EXPECT_EQ(post_ce_window, sender_->GetCongestionWindow());
+
+  // A CE mark on a later packet decreases the window again.
+  sender_->OnEcnFeedback(clock_.Now(), QuicPacketNumber(packet_number_),
+                         bytes_in_flight_, 1, 1);
+  EXPECT_GT(post_ce_window, sender_->GetCongestionWindow());
+}
+
 TEST_F(TcpCubicSenderBytesTest, ConfigureMaxInitialWindow) {
   SetQuicReloadableFlag(quic_unified_iw_options, false);
   QuicConfig config;
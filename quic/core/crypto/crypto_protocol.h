@@ -125,6 +125,10 @@ const QuicTag kIW10 = TAG('I', 'W', '1', '0');   // Force ICWND to 10
 const QuicTag kIW20 = TAG('I', 'W', '2', '0');   // Force ICWND to 20
 const QuicTag kIW50 = TAG('I', 'W', '5', '0');   // Force ICWND to 50
 const QuicTag kB2ON = TAG('B', '2', 'O', 'N');   // Enable BBRv2
+const QuicTag kB3ON = TAG('B', '3', 'O', 'N');   // Enable BBRv2 with the
+                                                 // BBRv3 model updates
+const QuicTag kPRGE = TAG('P', 'R', 'G', 'E');   // Prague Congestion Control
+const QuicTag kECNS = TAG('E', 'C', 'N', 'S');   // Send ECN-capable packets
 const QuicTag kB2NA = TAG('B', '2', 'N', 'A');   // For BBRv2, do not add ack
                                                  // height to queueing threshold
 const QuicTag kB2NE = TAG('B', '2', 'N', 'E');   // For BBRv2, always exit
@@ -0,0 +1,95 @@
+// Copyright (c) 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "quic/core/http/quic_header_block_sink.h"
+
+#include "quic/core/http/spdy_utils.h"
+#include "quic/platform/api/quic_logging.h"
+#include "common/quiche_text_utils.h"
+
+namespace quic {
+
+QuicHeaderBlockSink::QuicHeaderBlockSink(spdy::Http2HeaderBlock* header_block)
+    : header_block_(header_block),
+      valid_(true),
+      has_content_length_(false),
+      content_length_(-1),
+      uncompressed_header_bytes_(0),
+      compressed_header_bytes_(0) {}
+
+QuicHeaderBlockSink::~QuicHeaderBlockSink() {}
+
+void QuicHeaderBlockSink::OnHeaderBlockStart() {
+  Clear();
+}
+
+void QuicHeaderBlockSink::OnHeader(absl::string_view name,
+                                   absl::string_view value) {
+  if (!valid_) {
+    return;
+  }
+
+  if (name.empty()) {
+    QUIC_DLOG(ERROR) << "Header name must not be empty.";
+    valid_ = false;
+    return;
+  }
+
+  if (quiche::QuicheTextUtils::ContainsUpperCase(name)) {
+    QUIC_DLOG(ERROR) << "Malformed header: Header name " << name
+                     << " contains upper-case characters.";
+    valid_ = false;
+    return;
+  }
+
+  header_block_->AppendValueOrAddHeader(name, value);
+
+  if (name[0] == ':') {
+    absl::string_view* pseudo_header = nullptr;
+    if (name == ":method") {
+      pseudo_header = &pseudo_headers_.method;
+    } else if (name == ":scheme") {
+      pseudo_header = &pseudo_headers_.scheme;
+    } else if (name == ":authority") {
+      pseudo_header = &pseudo_headers_.authority;
+    } else if (name == ":path") {
+      pseudo_header = &pseudo_headers_.path;
+    }
+    if (pseudo_header != nullptr) {
+      // Point into the block, which also joins a repeated field's values.
+      *pseudo_header = header_block_->find(name)->second;
+    }
+  } else if (name == "content-length") {
+    has_content_length_ = true;
+  }
+}
+
+void QuicHeaderBlockSink::OnHeaderBlockEnd(size_t uncompressed_header_bytes,
+                                           size_t compressed_header_bytes) {
+  uncompressed_header_bytes_ = uncompressed_header_bytes;
+  compressed_header_bytes_ = compressed_header_bytes;
+
+  if (valid_ && has_content_length_ &&
+      !SpdyUtils::ExtractContentLengthFromHeaders(&content_length_,
+                                                  header_block_)) {
+    valid_ = false;
+  }
+
+  if (valid_) {
+    QUIC_DVLOG(1) << "Successfully parsed headers: "
+                  << header_block_->DebugString();
+  }
+}
+
+void QuicHeaderBlockSink::Clear() {
+  header_block_->clear();
+  valid_ = true;
+  has_content_length_ = false;
+  content_length_ = -1;
+  pseudo_headers_ = RequestPseudoHeaders();
+  uncompressed_header_bytes_ = 0;
+  compressed_header_bytes_ = 0;
+}
+
+}  // namespace quic
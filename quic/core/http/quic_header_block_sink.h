@@ -0,0 +1,81 @@
+// Copyright (c) 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef QUICHE_QUIC_CORE_HTTP_QUIC_HEADER_BLOCK_SINK_H_
+#define QUICHE_QUIC_CORE_HTTP_QUIC_HEADER_BLOCK_SINK_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "absl/strings/string_view.h"
+#include "quic/platform/api/quic_export.h"
+#include "spdy/core/spdy_header_block.h"
+#include "spdy/core/spdy_headers_handler_interface.h"
+
+namespace quic {
+
+// Receives decoded request header fields, validates each name as it arrives
+// and appends the field straight to an Http2HeaderBlock, instead of
+// accumulating a QuicHeaderList and copying it afterwards.  The checks and the
+// resulting header block are the same as with
+// SpdyUtils::CopyAndValidateHeaders().
+class QUIC_EXPORT_PRIVATE QuicHeaderBlockSink
+    : public spdy::SpdyHeadersHandlerInterface {
+ public:
+  // Values of the request pseudo-header fields, empty if the field was not
+  // received.  They point into the header block and are only valid until it is
+  // modified.
+  struct QUIC_EXPORT_PRIVATE RequestPseudoHeaders {
+    absl::string_view method;
+    absl::string_view scheme;
+    absl::string_view authority;
+    absl::string_view path;
+  };
+
+  // |header_block| must outlive this object.
+  explicit QuicHeaderBlockSink(spdy::Http2HeaderBlock* header_block);
+  QuicHeaderBlockSink(const QuicHeaderBlockSink&) = delete;
+  QuicHeaderBlockSink& operator=(const QuicHeaderBlockSink&) = delete;
+  ~QuicHeaderBlockSink() override;
+
+  // From SpdyHeadersHandlerInterface.  OnHeaderBlockStart() clears the header
+  // block.  Once a header field fails validation, the rest of the block is
+  // ignored.
+  void OnHeaderBlockStart() override;
+  void OnHeader(absl::string_view name, absl::string_view value) override;
+  void OnHeaderBlockEnd(size_t uncompressed_header_bytes,
+                        size_t compressed_header_bytes) override;
+
+  // Discards the header fields received so far.
+  void Clear();
+
+  // Returns false if a header field name is empty or contains upper-case
+  // characters, or if the content-length values are invalid or inconsistent.
+  bool valid() const { return valid_; }
+  // The value of content-length, or -1 if it was not received.  Set by
+  // OnHeaderBlockEnd().
+  int64_t content_length() const { return content_length_; }
+  const RequestPseudoHeaders& pseudo_headers() const {
+    return pseudo_headers_;
+  }
+  const spdy::Http2HeaderBlock& header_block() const { return *header_block_; }
+
+  size_t uncompressed_header_bytes() const {
+    return uncompressed_header_bytes_;
+  }
+  size_t compressed_header_bytes() const { return compressed_header_bytes_; }
+
+ private:
+  spdy::Http2HeaderBlock* header_block_;  // Not owned.
+  bool valid_;
+  bool has_content_length_;
+  int64_t content_length_;
+  RequestPseudoHeaders pseudo_headers_;
+  size_t uncompressed_header_bytes_;
+  size_t compressed_header_bytes_;
+};
+
+}  // namespace quic
+
+#endif  // QUICHE_QUIC_CORE_HTTP_QUIC_HEADER_BLOCK_SINK_H_
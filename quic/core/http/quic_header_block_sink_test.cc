@@ -0,0 +1,157 @@
+// Copyright (c) 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "quic/core/http/quic_header_block_sink.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "quic/core/http/quic_header_list.h"
+#include "quic/core/http/spdy_utils.h"
+#include "quic/platform/api/quic_test.h"
+
+using spdy::Http2HeaderBlock;
+using testing::Pair;
+using testing::UnorderedElementsAre;
+
+namespace quic {
+namespace test {
+namespace {
+
+class QuicHeaderBlockSinkTest : public QuicTest {
+ protected:
+  QuicHeaderBlockSinkTest() : sink_(&header_block_) {}
+
+  void Receive(
+      const std::vector<std::pair<std::string, std::string>>& headers) {
+    sink_.OnHeaderBlockStart();
+    for (const auto& header : headers) {
+      sink_.OnHeader(header.first, header.second);
+    }
+    sink_.OnHeaderBlockEnd(/*uncompressed_header_bytes=*/100,
+                           /*compressed_header_bytes=*/50);
+  }
+
+  Http2HeaderBlock header_block_;
+  QuicHeaderBlockSink sink_;
+};
+
+TEST_F(QuicHeaderBlockSinkTest, RequestHeaders) {
+  Receive({{":method", "GET"},
+           {":scheme", "https"},
+           {":authority", "www.example.org"},
+           {":path", "/index.html"},
+           {"cookie", "a=b"},
+           {"cookie", "c=d"},
+           {"accept", "*/*"}});
+
+  EXPECT_TRUE(sink_.valid());
+  EXPECT_EQ(-1, sink_.content_length());
+  EXPECT_EQ("GET", sink_.pseudo_headers().method);
+  EXPECT_EQ("https", sink_.pseudo_headers().scheme);
+  EXPECT_EQ("www.example.org", sink_.pseudo_headers().authority);
+  EXPECT_EQ("/index.html", sink_.pseudo_headers().path);
+  EXPECT_EQ(100u, sink_.uncompressed_header_bytes());
+  EXPECT_EQ(50u, sink_.compressed_header_bytes());
+  EXPECT_THAT(header_block_,
+              UnorderedElementsAre(Pair(":method", "GET"),
+                                   Pair(":scheme", "https"),
+                                   Pair(":authority", "www.example.org"),
+                                   Pair(":path", "/index.html"),
+                                   Pair("cookie", "a=b; c=d"),
+                                   Pair("accept", "*/*")));
+}
+
+// The header block matches the one built by
+// SpdyUtils::CopyAndValidateHeaders().
+TEST_F(QuicHeaderBlockSinkTest, SameAsCopyAndValidateHeaders) {
+  const std::vector<std::pair<std::string, std::string>> headers = {
+      {":method", "POST"},         {"cookie", " part 1"},
+      {"cookie", "part 2 "},       {"joined", "value 1"},
+      {"joined", "value 2"},       {"empty", ""},
+      {"content-length", "12"},    {"content-length", "12"},
+      {"passed-through", std::string("foo\0baz", 7)}};
+  Receive(headers);
+
+  QuicHeaderList header_list;
+  header_list.OnHeaderBlockStart();
+  for (const auto& header : headers) {
+    header_list.OnHeader(header.first, header.second);
+  }
+  header_list.OnHeaderBlockEnd(0, 0);
+  int64_t content_length = -1;
+  Http2HeaderBlock expected;
+  ASSERT_TRUE(SpdyUtils::CopyAndValidateHeaders(header_list, &content_length,
+                                                &expected));
+
+  EXPECT_TRUE(sink_.valid());
+  EXPECT_EQ(content_length, sink_.content_length());
+  EXPECT_EQ(expected, header_block_);
+}
+
+TEST_F(QuicHeaderBlockSinkTest, RepeatedPseudoHeader) {
+  Receive({{":path", "/foo"}, {":path", "/bar"}});
+
+  EXPECT_TRUE(sink_.valid());
+  EXPECT_EQ(std::string("/foo\0/bar", 9), sink_.pseudo_headers().path);
+  EXPECT_TRUE(sink_.pseudo_headers().method.empty());
+}
+
+TEST_F(QuicHeaderBlockSinkTest, EmptyName) {
+  Receive({{":method", "GET"}, {"", "foo"}, {"bar", "baz"}});
+
+  EXPECT_FALSE(sink_.valid());
+  EXPECT_THAT(header_block_, UnorderedElementsAre(Pair(":method", "GET")));
+}
+
+TEST_F(QuicHeaderBlockSinkTest, UpperCaseName) {
+  Receive({{"foo", "bar"}, {"Content-Length", "5"}, {"content-length", "6"}});
+
+  EXPECT_FALSE(sink_.valid());
+  EXPECT_EQ(-1, sink_.content_length());
+  EXPECT_THAT(header_block_, UnorderedElementsAre(Pair("foo", "bar")));
+}
+
+TEST_F(QuicHeaderBlockSinkTest, InconsistentContentLengths) {
+  Receive({{"content-length", "9"}, {"content-length", "8"}});
+
+  EXPECT_FALSE(sink_.valid());
+}
+
+TEST_F(QuicHeaderBlockSinkTest, InvalidContentLength) {
+  Receive({{"content-length", "-1"}});
+
+  EXPECT_FALSE(sink_.valid());
+}
+
+TEST_F(QuicHeaderBlockSinkTest, NewHeaderBlock) {
+  Receive({{"Foo", "bar"}});
+  EXPECT_FALSE(sink_.valid());
+
+  Receive({{":method", "GET"}, {"content-length", "3"}});
+  EXPECT_TRUE(sink_.valid());
+  EXPECT_EQ(3, sink_.content_length());
+  EXPECT_EQ("GET", sink_.pseudo_headers().method);
+  EXPECT_THAT(header_block_, UnorderedElementsAre(Pair(":method", "GET"),
+                                                  Pair("content-length", "3")));
+}
+
+TEST_F(QuicHeaderBlockSinkTest, Clear) {
+  sink_.OnHeaderBlockStart();
+  sink_.OnHeader(":method", "GET");
+  sink_.OnHeader("content-length", "3");
+  sink_.Clear();
+  sink_.OnHeaderBlockEnd(0, 0);
+
+  EXPECT_TRUE(sink_.valid());
+  EXPECT_EQ(-1, sink_.content_length());
+  EXPECT_TRUE(sink_.pseudo_headers().method.empty());
+  EXPECT_TRUE(header_block_.empty());
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace quic
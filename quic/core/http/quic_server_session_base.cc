@@ -32,7 +32,8 @@ QuicServerSessionBase::QuicServerSessionBase(
       helper_(helper),
       bandwidth_resumption_enabled_(false),
       bandwidth_estimate_sent_to_client_(QuicBandwidth::Zero()),
-      last_scup_time_(QuicTime::Zero()) {}
+      last_scup_time_(QuicTime::Zero()),
+      network_params_cache_(nullptr) {}
 
 QuicServerSessionBase::~QuicServerSessionBase() {}
 
@@ -47,6 +48,7 @@ void QuicServerSessionBase::OnConfigNegotiated() {
   QuicSpdySession::OnConfigNegotiated();
 
   if (!config()->HasReceivedConnectionOptions()) {
+    MaybeAdjustNetworkParametersFromCache();
     return;
   }
 
@@ -77,15 +79,56 @@ void QuicServerSessionBase::OnConfigNegotiated() {
       if (seconds_since_estimate <= kNumSecondsPerHour) {
         connection()->ResumeConnectionState(*cached_network_params,
                                             max_bandwidth_resumption);
+        return;
       }
     }
   }
+  MaybeAdjustNetworkParametersFromCache();
+}
+
+void QuicServerSessionBase::MaybeAdjustNetworkParametersFromCache() {
+  if (network_params_cache_ == nullptr ||
+      !GetQuicReloadableFlag(quic_server_network_params_cache)) {
+    return;
+  }
+  SendAlgorithmInterface::NetworkParams params;
+  if (!network_params_cache_->GetNetworkParams(
+          connection()->peer_address().host(), connection()->clock()->WallNow(),
+          connection()->sent_packet_manager().GetCongestionWindowInBytes(),
+          &params)) {
+    return;
+  }
+  QUIC_RELOADABLE_FLAG_COUNT_N(quic_server_network_params_cache, 1, 2);
+  connection()->AdjustNetworkParameters(params);
+}
+
+void QuicServerSessionBase::RecordNetworkParamsInCache() {
+  if (network_params_cache_ == nullptr ||
+      !GetQuicReloadableFlag(quic_server_network_params_cache)) {
+    return;
+  }
+  QUIC_RELOADABLE_FLAG_COUNT_N(quic_server_network_params_cache, 2, 2);
+  const QuicSentPacketManager& sent_packet_manager =
+      connection()->sent_packet_manager();
+  // Prefer the sustained estimate, which short connections may not have had
+  // time to make.
+  const QuicSustainedBandwidthRecorder* bandwidth_recorder =
+      sent_packet_manager.SustainedBandwidthRecorder();
+  const QuicBandwidth bandwidth =
+      bandwidth_recorder != nullptr && bandwidth_recorder->HasEstimate()
+          ? bandwidth_recorder->BandwidthEstimate()
+          : sent_packet_manager.BandwidthEstimate();
+  network_params_cache_->RecordEstimate(
+      connection()->peer_address().host(), bandwidth,
+      sent_packet_manager.GetRttStats()->min_rtt(),
+      connection()->clock()->WallNow());
 }
 
 void QuicServerSessionBase::OnConnectionClosed(
     const QuicConnectionCloseFrame& frame,
     ConnectionCloseSource source) {
   QuicSession::OnConnectionClosed(frame, source);
+  RecordNetworkParamsInCache();
   // In the unlikely event we get a connection close while doing an asynchronous
   // crypto event, make sure we cancel the callback.
   if (crypto_stream_ != nullptr) {
@@ -16,6 +16,7 @@
 #include "quic/core/crypto/quic_compressed_certs_cache.h"
 #include "quic/core/http/quic_spdy_session.h"
 #include "quic/core/quic_crypto_server_stream_base.h"
+#include "quic/core/quic_network_params_cache.h"
 #include "quic/core/quic_packets.h"
 #include "quic/platform/api/quic_export.h"
 
@@ -68,6 +69,14 @@ class QUIC_EXPORT_PRIVATE QuicServerSessionBase : public QuicSpdySession {
     serving_region_ = serving_region;
   }
 
+  // Sets the cache used to seed the congestion controller of this connection
+  // from the estimates of earlier connections from the same network, and to
+  // which this connection's estimates are added when it's closed.  |cache| is
+  // not owned and must outlive the session.
+  void set_network_params_cache(QuicNetworkParamsCache* cache) {
+    network_params_cache_ = cache;
+  }
+
  protected:
   // QuicSession methods(override them with return type of QuicSpdyStream*):
   QuicCryptoServerStreamBase* GetMutableCryptoStream() override;
@@ -104,6 +113,13 @@ class QUIC_EXPORT_PRIVATE QuicServerSessionBase : public QuicSpdySession {
   // data.
   void SendSettingsToCryptoStream();
 
+  // Seeds the congestion controller from |network_params_cache_|, if there is
+  // a recent entry for the peer's network.
+  void MaybeAdjustNetworkParametersFromCache();
+
+  // Records the estimates of this connection in |network_params_cache_|.
+  void RecordNetworkParamsInCache();
+
   const QuicCryptoServerConfig* crypto_config_;
 
   // The cache which contains most recently compressed certs.
@@ -132,6 +148,9 @@ class QUIC_EXPORT_PRIVATE QuicServerSessionBase : public QuicSpdySession {
   // Number of packets sent to the peer, at the time we last sent a SCUP.
   QuicPacketNumber last_scup_packet_number_;
 
+  // Not owned.  May be nullptr.
+  QuicNetworkParamsCache* network_params_cache_;
+
   // Converts QuicBandwidth to an int32 bytes/second that can be
   // stored in CachedNetworkParameters.  TODO(jokulik): This function
   // should go away once we fix http://b//27897982
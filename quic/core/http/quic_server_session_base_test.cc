@@ -17,6 +17,7 @@
 #include "quic/core/quic_connection.h"
 #include "quic/core/quic_crypto_server_stream.h"
 #include "quic/core/quic_crypto_server_stream_base.h"
+#include "quic/core/quic_network_params_cache.h"
 #include "quic/core/quic_utils.h"
 #include "quic/core/tls_server_handshaker.h"
 #include "quic/platform/api/quic_expect_bug.h"
@@ -723,6 +724,67 @@ TEST_P(QuicServerSessionBaseTest, NoBandwidthResumptionByDefault) {
       QuicServerSessionBasePeer::IsBandwidthResumptionEnabled(session_.get()));
 }
 
+TEST_P(QuicServerSessionBaseTest, AdjustNetworkParametersFromCache) {
+  SetQuicReloadableFlag(quic_server_network_params_cache, true);
+  QuicNetworkParamsCache cache;
+  session_->set_network_params_cache(&cache);
+  const QuicTime::Delta kMinRtt = QuicTime::Delta::FromMilliseconds(37);
+  const RttStats* rtt_stats = connection_->sent_packet_manager().GetRttStats();
+
+  // Nothing is known about the client's network yet.
+  session_->OnConfigNegotiated();
+  EXPECT_NE(kMinRtt, rtt_stats->initial_rtt());
+
+  // An earlier connection from the same network seeds this one.
+  cache.RecordEstimate(connection_->peer_address().host(),
+                       QuicBandwidth::FromKBitsPerSecond(10000), kMinRtt,
+                       connection_->clock()->WallNow());
+  session_->OnConfigNegotiated();
+  EXPECT_EQ(kMinRtt, rtt_stats->initial_rtt());
+}
+
+// TcpCubicSenderBytes sets its window to bandwidth * rtt, so the cache's
+// limits on the initial window have to be applied to the bandwidth.
+TEST_P(QuicServerSessionBaseTest, AdjustNetworkParametersFromCacheWithCubic) {
+  SetQuicReloadableFlag(quic_server_network_params_cache, true);
+  QuicSentPacketManager* sent_packet_manager =
+      QuicConnectionPeer::GetSentPacketManager(connection_);
+  sent_packet_manager->SetSendAlgorithm(kCubicBytes);
+  const QuicByteCount initial_cwnd =
+      sent_packet_manager->GetCongestionWindowInBytes();
+  const QuicTime::Delta kMinRtt = QuicTime::Delta::FromMilliseconds(100);
+  const QuicIpAddress peer_host = connection_->peer_address().host();
+
+  // A slow network does not shrink the initial window, but seeds the RTT.
+  QuicNetworkParamsCache slow_cache;
+  slow_cache.RecordEstimate(
+      peer_host, QuicBandwidth::FromBytesAndTimeDelta(initial_cwnd, kMinRtt),
+      kMinRtt, connection_->clock()->WallNow());
+  session_->set_network_params_cache(&slow_cache);
+  session_->OnConfigNegotiated();
+  EXPECT_EQ(initial_cwnd, sent_packet_manager->GetCongestionWindowInBytes());
+  EXPECT_EQ(kMinRtt, sent_packet_manager->GetRttStats()->initial_rtt());
+
+  // Within the limits, the window is half the cached bandwidth-delay product.
+  QuicNetworkParamsCache cache;
+  cache.RecordEstimate(peer_host, QuicBandwidth::FromKBitsPerSecond(8000),
+                       kMinRtt, connection_->clock()->WallNow());
+  session_->set_network_params_cache(&cache);
+  session_->OnConfigNegotiated();
+  EXPECT_EQ(50000u, sent_packet_manager->GetCongestionWindowInBytes());
+
+  // A fast network seeds at most max_initial_congestion_window packets.
+  QuicNetworkParamsCache fast_cache;
+  fast_cache.set_max_initial_congestion_window(50);
+  fast_cache.RecordEstimate(peer_host,
+                            QuicBandwidth::FromKBitsPerSecond(100000), kMinRtt,
+                            connection_->clock()->WallNow());
+  session_->set_network_params_cache(&fast_cache);
+  session_->OnConfigNegotiated();
+  EXPECT_EQ(50 * kDefaultTCPMSS,
+            sent_packet_manager->GetCongestionWindowInBytes());
+}
+
 // Tests which check the lifetime management of data members of
 // QuicCryptoServerStream objects when async GetProof is in use.
 class StreamMemberLifetimeTest : public QuicServerSessionBaseTest {
@@ -1666,15 +1666,29 @@ MessageStatus QuicSpdySession::SendHttp3Datagram(
     return MESSAGE_STATUS_INTERNAL_ERROR;
   }
 
+  // Datagrams are queued per stream, so that the streams sending them take
+  // turns when the connection is congested.
+  QuicDatagramStreamId queue_flow_id = stream_id;
+  auto it = h3_datagram_flow_id_to_stream_id_map_.find(stream_id);
+  if (it != h3_datagram_flow_id_to_stream_id_map_.end()) {
+    queue_flow_id = it->second;
+  }
   QuicMemSlice slice(std::move(buffer));
-  return datagram_queue()->SendOrQueueDatagram(std::move(slice));
+  return datagram_queue()->SendOrQueueDatagram(std::move(slice), queue_flow_id);
 }
 
 void QuicSpdySession::SetMaxDatagramTimeInQueueForStreamId(
-    QuicStreamId /*stream_id*/, QuicTime::Delta max_time_in_queue) {
-  // TODO(b/184598230): implement this in a way that works for multiple sessions
-  // on a same connection.
-  datagram_queue()->SetMaxTimeInQueue(max_time_in_queue);
+    QuicStreamId stream_id, QuicTime::Delta max_time_in_queue) {
+  datagram_queue()->SetFlowMaxTimeInQueue(stream_id, max_time_in_queue);
+}
+
+void QuicSpdySession::SetDatagramUrgencyForStreamId(QuicStreamId stream_id,
+                                                    int urgency) {
+  datagram_queue()->SetFlowUrgency(stream_id, urgency);
+}
+
+void QuicSpdySession::RemoveDatagramQueueForStreamId(QuicStreamId stream_id) {
+  datagram_queue()->RemoveFlow(stream_id);
 }
 
 void QuicSpdySession::RegisterHttp3DatagramFlowId(QuicDatagramStreamId flow_id,
@@ -403,6 +403,10 @@ class QUIC_EXPORT_PRIVATE QuicSpdySession
   // This must not be used except by QuicSpdyStream::SetMaxDatagramTimeInQueue.
   void SetMaxDatagramTimeInQueueForStreamId(QuicStreamId stream_id,
                                             QuicTime::Delta max_time_in_queue);
+  // This must not be used except by QuicSpdyStream::SetDatagramUrgency.
+  void SetDatagramUrgencyForStreamId(QuicStreamId stream_id, int urgency);
+  // This must not be used except by QuicSpdyStream::OnClose.
+  void RemoveDatagramQueueForStreamId(QuicStreamId stream_id);
   // This must not be used except by
   // QuicSpdyStream::MaybeProcessReceivedWebTransportHeaders.
   void RegisterHttp3DatagramFlowId(QuicDatagramStreamId flow_id,
@@ -0,0 +1,48 @@
+// Copyright (c) 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "quic/core/http/quic_spdy_session_command_queue.h"
+
+#include "quic/core/http/quic_spdy_session.h"
+#include "quic/core/http/quic_spdy_stream.h"
+#include "quic/core/quic_versions.h"
+#include "quic/platform/api/quic_bug_tracker.h"
+
+namespace quic {
+
+QuicSpdySessionCommandQueue::QuicSpdySessionCommandQueue(
+    QuicSpdySession* session,
+    QuicEpollServer* epoll_server,
+    Visitor* visitor)
+    : QuicSessionCommandQueue(session, epoll_server, visitor) {}
+
+QuicSpdySessionCommandQueue::QuicSpdySessionCommandQueue(
+    QuicSpdySession* session,
+    QuicEpollServer* epoll_server,
+    Visitor* visitor,
+    QuicByteCount max_buffered_bytes)
+    : QuicSessionCommandQueue(session,
+                              epoll_server,
+                              visitor,
+                              max_buffered_bytes) {}
+
+QuicConsumedData QuicSpdySessionCommandQueue::WriteToStream(
+    QuicStream* stream,
+    absl::Span<QuicMemSlice> slices,
+    bool fin) {
+  if (stream->is_static()) {
+    QUIC_BUG(quic_bug_12991_1)
+        << "Data queued for static stream " << stream->id();
+    return QuicSessionCommandQueue::WriteToStream(stream, slices, fin);
+  }
+  // With HTTP/3, the only dynamic unidirectional streams are WebTransport
+  // streams, which are not QuicSpdyStreams and carry unframed data.
+  if (VersionUsesHttp3(stream->transport_version()) &&
+      stream->type() != BIDIRECTIONAL) {
+    return QuicSessionCommandQueue::WriteToStream(stream, slices, fin);
+  }
+  return static_cast<QuicSpdyStream*>(stream)->WriteBodySlices(slices, fin);
+}
+
+}  // namespace quic
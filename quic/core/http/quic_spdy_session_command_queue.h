@@ -0,0 +1,38 @@
+// Copyright (c) 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef QUICHE_QUIC_CORE_HTTP_QUIC_SPDY_SESSION_COMMAND_QUEUE_H_
+#define QUICHE_QUIC_CORE_HTTP_QUIC_SPDY_SESSION_COMMAND_QUEUE_H_
+
+#include "quic/core/quic_session_command_queue.h"
+#include "quic/platform/api/quic_export.h"
+
+namespace quic {
+
+class QuicSpdySession;
+
+// A QuicSessionCommandQueue for HTTP sessions, which writes queued data as
+// the body of its stream with QuicSpdyStream::WriteBodySlices().  With HTTP/3,
+// the data written by each QuicSpdyStream write is framed as a single DATA
+// frame.  Data must not be queued for static streams.
+class QUIC_EXPORT_PRIVATE QuicSpdySessionCommandQueue
+    : public QuicSessionCommandQueue {
+ public:
+  QuicSpdySessionCommandQueue(QuicSpdySession* session,
+                              QuicEpollServer* epoll_server,
+                              Visitor* visitor);
+  QuicSpdySessionCommandQueue(QuicSpdySession* session,
+                              QuicEpollServer* epoll_server,
+                              Visitor* visitor,
+                              QuicByteCount max_buffered_bytes);
+
+ protected:
+  QuicConsumedData WriteToStream(QuicStream* stream,
+                                 absl::Span<QuicMemSlice> slices,
+                                 bool fin) override;
+};
+
+}  // namespace quic
+
+#endif  // QUICHE_QUIC_CORE_HTTP_QUIC_SPDY_SESSION_COMMAND_QUEUE_H_
@@ -0,0 +1,158 @@
+// Copyright (c) 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "quic/core/http/quic_spdy_session_command_queue.h"
+
+#include <memory>
+#include <string>
+
+#include "absl/memory/memory.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "quic/core/http/http_encoder.h"
+#include "quic/core/http/quic_spdy_stream.h"
+#include "quic/core/quic_simple_buffer_allocator.h"
+#include "quic/core/quic_utils.h"
+#include "quic/core/quic_versions.h"
+#include "quic/platform/api/quic_epoll.h"
+#include "quic/platform/api/quic_test.h"
+#include "quic/test_tools/quic_config_peer.h"
+#include "quic/test_tools/quic_connection_peer.h"
+#include "quic/test_tools/quic_test_utils.h"
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+
+namespace quic {
+namespace test {
+namespace {
+
+const QuicByteCount kFlowControlWindow = 10 * 1024 * 1024;
+
+// Forwards OnCanWriteNewData() to the queue, as streams written through the
+// queue are expected to.
+class TestStream : public QuicSpdyStream {
+ public:
+  TestStream(QuicStreamId id, QuicSpdySession* session)
+      : QuicSpdyStream(id, session, BIDIRECTIONAL) {}
+
+  void OnBodyAvailable() override {}
+
+  void OnCanWriteNewData() override {
+    QuicSpdyStream::OnCanWriteNewData();
+    if (queue_ != nullptr) {
+      queue_->OnCanWriteNewData(id());
+    }
+  }
+
+  void set_queue(QuicSessionCommandQueue* queue) { queue_ = queue; }
+
+ private:
+  QuicSessionCommandQueue* queue_ = nullptr;
+};
+
+class QuicSpdySessionCommandQueueTest
+    : public QuicTestWithParam<ParsedQuicVersion> {
+ protected:
+  QuicSpdySessionCommandQueueTest()
+      : connection_(new NiceMock<MockQuicConnection>(
+            &helper_,
+            &alarm_factory_,
+            Perspective::IS_SERVER,
+            SupportedVersions(GetParam()))),
+        session_(connection_) {
+    session_.Initialize();
+    if (connection_->version().SupportsAntiAmplificationLimit()) {
+      QuicConnectionPeer::SetAddressValidated(connection_);
+    }
+    QuicConfigPeer::SetReceivedInitialSessionFlowControlWindow(
+        session_.config(), kFlowControlWindow);
+    QuicConfigPeer::SetReceivedInitialMaxStreamDataBytesUnidirectional(
+        session_.config(), kFlowControlWindow);
+    QuicConfigPeer::SetReceivedInitialMaxStreamDataBytesIncomingBidirectional(
+        session_.config(), kFlowControlWindow);
+    QuicConfigPeer::SetReceivedInitialMaxStreamDataBytesOutgoingBidirectional(
+        session_.config(), kFlowControlWindow);
+    QuicConfigPeer::SetReceivedMaxUnidirectionalStreams(session_.config(), 10);
+    session_.OnConfigNegotiated();
+    ON_CALL(session_, WritevData(_, _, _, _, _, _))
+        .WillByDefault(Invoke(&session_, &MockQuicSpdySession::ConsumeData));
+    queue_ = std::make_unique<QuicSpdySessionCommandQueue>(
+        &session_, &epoll_server_, /*visitor=*/nullptr);
+  }
+
+  TestStream* CreateStream() {
+    const QuicStreamId id = GetNthClientInitiatedBidirectionalStreamId(
+        connection_->transport_version(), 0);
+    auto stream = std::make_unique<TestStream>(id, &session_);
+    TestStream* stream_ptr = stream.get();
+    stream_ptr->set_queue(queue_.get());
+    session_.ActivateStream(std::move(stream));
+    return stream_ptr;
+  }
+
+  QuicMemSlice MakeSlice(absl::string_view data) {
+    return QuicMemSlice(QuicBuffer::Copy(&allocator_, data));
+  }
+
+  // Returns |body| as it is expected to be written to the stream.
+  std::string Body(absl::string_view body) {
+    if (!VersionUsesHttp3(connection_->transport_version())) {
+      return std::string(body);
+    }
+    QuicBuffer header =
+        HttpEncoder::SerializeDataFrameHeader(body.length(), &allocator_);
+    return absl::StrCat(header.AsStringView(), body);
+  }
+
+  // Outlives the session, which owns slices allocated by it.
+  SimpleBufferAllocator allocator_;
+  MockQuicConnectionHelper helper_;
+  MockAlarmFactory alarm_factory_;
+  NiceMock<MockQuicConnection>* connection_;
+  NiceMock<MockQuicSpdySession> session_;
+  QuicEpollServer epoll_server_;
+  std::unique_ptr<QuicSpdySessionCommandQueue> queue_;
+};
+
+INSTANTIATE_TEST_SUITE_P(Tests,
+                         QuicSpdySessionCommandQueueTest,
+                         ::testing::ValuesIn(AllSupportedVersions()),
+                         ::testing::PrintToStringParamName());
+
+TEST_P(QuicSpdySessionCommandQueueTest, WritesAreFramed) {
+  TestStream* stream = CreateStream();
+  EXPECT_TRUE(queue_->WriteMemSlice(stream->id(), MakeSlice("foo"), false));
+  EXPECT_TRUE(queue_->WriteMemSlice(stream->id(), MakeSlice("bar"), true));
+
+  // Both chunks are written as one DATA frame with HTTP/3.
+  const std::string data = Body("foobar");
+  EXPECT_CALL(session_,
+              WritevData(stream->id(), data.length(), 0, FIN, _, _))
+      .WillOnce(Invoke(&session_, &MockQuicSpdySession::ConsumeData));
+  queue_->ProcessCommands();
+  EXPECT_EQ(0u, queue_->buffered_bytes());
+  EXPECT_EQ(data.length(), stream->stream_bytes_written());
+  EXPECT_TRUE(stream->fin_sent());
+  EXPECT_EQ(1u, queue_->stats().stream_writes);
+  EXPECT_EQ(6u, queue_->stats().bytes_written);
+}
+
+TEST_P(QuicSpdySessionCommandQueueTest, FinOnly) {
+  TestStream* stream = CreateStream();
+  EXPECT_TRUE(queue_->WriteMemSlice(stream->id(), MakeSlice("foo"), false));
+  queue_->ProcessCommands();
+  EXPECT_EQ(Body("foo").length(), stream->stream_bytes_written());
+
+  // A FIN without data is not framed.
+  EXPECT_TRUE(queue_->WriteMemSlice(stream->id(), QuicMemSlice(), true));
+  queue_->ProcessCommands();
+  EXPECT_EQ(Body("foo").length(), stream->stream_bytes_written());
+  EXPECT_TRUE(stream->fin_sent());
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace quic
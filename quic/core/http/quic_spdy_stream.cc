@@ -248,6 +248,10 @@ QuicSpdyStream::QuicSpdyStream(QuicStreamId id, QuicSpdySession* spdy_session,
 
   if (VersionUsesHttp3(transport_version())) {
     sequencer()->set_level_triggered(true);
+    if (GetQuicReloadableFlag(quic_spdy_stream_read_in_place)) {
+      QUIC_RELOADABLE_FLAG_COUNT_N(quic_spdy_stream_read_in_place, 1, 3);
+      sequencer()->set_read_in_order_frames_in_place(true);
+    }
   }
 
   spdy_session_->OnStreamCreated(this);
@@ -283,6 +287,10 @@ QuicSpdyStream::QuicSpdyStream(PendingStream* pending,
 
   if (VersionUsesHttp3(transport_version())) {
     sequencer()->set_level_triggered(true);
+    if (GetQuicReloadableFlag(quic_spdy_stream_read_in_place)) {
+      QUIC_RELOADABLE_FLAG_COUNT_N(quic_spdy_stream_read_in_place, 2, 3);
+      sequencer()->set_read_in_order_frames_in_place(true);
+    }
   }
 
   spdy_session_->OnStreamCreated(this);
@@ -345,9 +353,7 @@ void QuicSpdyStream::WriteOrBufferBody(absl::string_view data, bool fin) {
     spdy_session_->debug_visitor()->OnDataFrameSent(id(), data.length());
   }
 
-  const bool success =
-      WriteDataFrameHeader(data.length(), /*force_write=*/true);
-  QUICHE_DCHECK(success);
+  WriteDataFrameHeader(data.length());
 
   // Write body.
   QUIC_DLOG(INFO) << ENDPOINT << "Stream " << id()
@@ -407,17 +413,13 @@ QuicConsumedData QuicSpdyStream::WritevBody(const struct iovec* iov,
   return WriteBodySlices(storage.ToSpan(), fin);
 }
 
-bool QuicSpdyStream::WriteDataFrameHeader(QuicByteCount data_length,
-                                          bool force_write) {
+void QuicSpdyStream::WriteDataFrameHeader(QuicByteCount data_length) {
   QUICHE_DCHECK(VersionUsesHttp3(transport_version()));
   QUICHE_DCHECK_GT(data_length, 0u);
   QuicBuffer header = HttpEncoder::SerializeDataFrameHeader(
       data_length,
       spdy_session_->connection()->helper()->GetStreamSendBufferAllocator());
   const bool can_write = CanWriteNewDataAfterData(header.size());
-  if (!can_write && !force_write) {
-    return false;
-  }
 
   if (spdy_session_->debug_visitor()) {
     spdy_session_->debug_visitor()->OnDataFrameSent(id(), data_length);
@@ -434,10 +436,43 @@ bool QuicSpdyStream::WriteDataFrameHeader(QuicByteCount data_length,
     QuicMemSlice header_slice(std::move(header));
     WriteMemSlices(QuicMemSliceSpan(&header_slice), false);
   } else {
-    QUICHE_DCHECK(force_write);
     WriteOrBufferData(header.AsStringView(), false, nullptr);
   }
-  return true;
+}
+
+template <typename SliceSpan>
+QuicConsumedData QuicSpdyStream::WriteDataFrame(SliceSpan slices,
+                                                QuicByteCount data_length,
+                                                bool fin) {
+  QUICHE_DCHECK(VersionUsesHttp3(transport_version()));
+  QUICHE_DCHECK_GT(data_length, 0u);
+  QuicBuffer header = HttpEncoder::SerializeDataFrameHeader(
+      data_length,
+      spdy_session_->connection()->helper()->GetStreamSendBufferAllocator());
+  const QuicByteCount header_length = header.size();
+  if (!CanWriteNewDataAfterData(header_length)) {
+    return {0, false};
+  }
+
+  if (spdy_session_->debug_visitor()) {
+    spdy_session_->debug_visitor()->OnDataFrameSent(id(), data_length);
+  }
+
+  unacked_frame_headers_offsets_.Add(
+      send_buffer().stream_offset(),
+      send_buffer().stream_offset() + header_length);
+  QUIC_DLOG(INFO) << ENDPOINT << "Stream " << id()
+                  << " is writing DATA frame of length " << data_length
+                  << " with header of length " << header_length;
+  // The header and the payload are buffered as one scatter list, so that they
+  // are sent in the same STREAM frame and nothing is copied until the frame is
+  // serialized into a packet.
+  QuicConsumedData consumed =
+      WriteMemSlicesWithPrefix(QuicMemSlice(std::move(header)), slices, fin);
+  if (consumed.bytes_consumed > 0) {
+    consumed.bytes_consumed -= header_length;
+  }
+  return consumed;
 }
 
 QuicConsumedData QuicSpdyStream::WriteBodySlices(QuicMemSliceSpan slices,
@@ -447,14 +482,7 @@ QuicConsumedData QuicSpdyStream::WriteBodySlices(QuicMemSliceSpan slices,
   }
 
   QuicConnection::ScopedPacketFlusher flusher(spdy_session_->connection());
-  if (!WriteDataFrameHeader(slices.total_length(), /*force_write=*/false)) {
-    return {0, false};
-  }
-
-  QUIC_DLOG(INFO) << ENDPOINT << "Stream " << id()
-                  << " is writing DATA frame payload of length "
-                  << slices.total_length();
-  return WriteMemSlices(slices, fin);
+  return WriteDataFrame(slices, slices.total_length(), fin);
 }
 
 QuicConsumedData QuicSpdyStream::WriteBodySlices(
@@ -465,14 +493,7 @@ QuicConsumedData QuicSpdyStream::WriteBodySlices(
   }
 
   QuicConnection::ScopedPacketFlusher flusher(spdy_session_->connection());
-  const QuicByteCount data_size = MemSliceSpanTotalSize(slices);
-  if (!WriteDataFrameHeader(data_size, /*force_write=*/false)) {
-    return {0, false};
-  }
-
-  QUIC_DLOG(INFO) << ENDPOINT << "Stream " << id()
-                  << " is writing DATA frame payload of length " << data_size;
-  return WriteMemSlices(slices, fin);
+  return WriteDataFrame(slices, MemSliceSpanTotalSize(slices), fin);
 }
 
 size_t QuicSpdyStream::Readv(const struct iovec* iov, size_t iov_len) {
@@ -563,12 +584,24 @@ void QuicSpdyStream::OnStreamHeadersPriority(
 void QuicSpdyStream::OnStreamHeaderList(bool fin,
                                         size_t frame_len,
                                         const QuicHeaderList& header_list) {
+  const bool decoded_into_sink =
+      !headers_decompressed_ && initial_headers_decoded_into_sink_;
   if (!spdy_session()->user_agent_id().has_value()) {
     std::string uaid;
-    for (const auto& kv : header_list) {
-      if (quiche::QuicheTextUtils::ToLower(kv.first) == kUserAgentHeaderName) {
-        uaid = kv.second;
-        break;
+    if (decoded_into_sink) {
+      const spdy::Http2HeaderBlock& header_block =
+          initial_headers_sink_->header_block();
+      auto it = header_block.find(kUserAgentHeaderName);
+      if (it != header_block.end()) {
+        uaid = std::string(it->second);
+      }
+    } else {
+      for (const auto& kv : header_list) {
+        if (quiche::QuicheTextUtils::ToLower(kv.first) ==
+            kUserAgentHeaderName) {
+          uaid = kv.second;
+          break;
+        }
       }
     }
     spdy_session()->SetUserAgentId(std::move(uaid));
@@ -588,6 +621,15 @@ void QuicSpdyStream::OnStreamHeaderList(bool fin,
     }
   }
   if (!headers_decompressed_) {
+    if (initial_headers_sink_ != nullptr && !decoded_into_sink) {
+      initial_headers_sink_->OnHeaderBlockStart();
+      for (const auto& kv : header_list) {
+        initial_headers_sink_->OnHeader(kv.first, kv.second);
+      }
+      initial_headers_sink_->OnHeaderBlockEnd(
+          header_list.uncompressed_header_bytes(),
+          header_list.compressed_header_bytes());
+    }
     OnInitialHeadersComplete(fin, frame_len, header_list);
   } else {
     OnTrailingHeadersComplete(fin, frame_len, header_list);
@@ -837,6 +879,20 @@ void QuicSpdyStream::OnDataAvailable() {
     return;
   }
 
+  ProcessReadableData();
+
+  // Body fragments of a frame which is read in place point into the frame,
+  // which only lives until this returns.  The sequencer then copies the
+  // unconsumed part of the frame into its buffer, but the stream might still
+  // have unread body in |body_manager_|, so that is copied as well.
+  if (sequencer()->HasUnconsumedInPlaceData() &&
+      body_manager_.HasBytesToRead()) {
+    QUIC_RELOADABLE_FLAG_COUNT_N(quic_spdy_stream_read_in_place, 3, 3);
+    body_manager_.CopyUnreadBody();
+  }
+}
+
+void QuicSpdyStream::ProcessReadableData() {
   iovec iov;
   while (session()->connection()->connected() && !reading_stopped() &&
          decoder_.error() == QUIC_NO_ERROR) {
@@ -892,6 +948,8 @@ void QuicSpdyStream::OnClose() {
   if (datagram_flow_id_.has_value()) {
     spdy_session_->UnregisterHttp3DatagramFlowId(datagram_flow_id_.value());
   }
+  // Datagrams which are still queued are of no use to the peer anymore.
+  spdy_session_->RemoveDatagramQueueForStreamId(id());
 
   if (web_transport_ != nullptr) {
     web_transport_->CloseAllAssociatedStreams();
@@ -1066,10 +1124,20 @@ bool QuicSpdyStream::OnHeadersFrameStart(QuicByteCount header_length,
 
   sequencer()->MarkConsumed(body_manager_.OnNonBody(header_length));
 
+  // The debug visitor and WebTransport read the initial headers from the
+  // QuicHeaderList.
+  QuicHeaderBlockSink* sink = nullptr;
+  if (!headers_decompressed_ && initial_headers_sink_ != nullptr &&
+      spdy_session_->debug_visitor() == nullptr &&
+      !spdy_session_->SupportsWebTransport()) {
+    sink = initial_headers_sink_;
+  }
+  initial_headers_decoded_into_sink_ = sink != nullptr;
+
   qpack_decoded_headers_accumulator_ =
       std::make_unique<QpackDecodedHeadersAccumulator>(
           id(), spdy_session_->qpack_decoder(), this,
-          spdy_session_->max_inbound_header_list_size());
+          spdy_session_->max_inbound_header_list_size(), sink);
 
   return true;
 }
@@ -1565,6 +1633,10 @@ void QuicSpdyStream::SetMaxDatagramTimeInQueue(
   spdy_session_->SetMaxDatagramTimeInQueueForStreamId(id(), max_time_in_queue);
 }
 
+void QuicSpdyStream::SetDatagramUrgency(int urgency) {
+  spdy_session_->SetDatagramUrgencyForStreamId(id(), urgency);
+}
+
 QuicDatagramContextId QuicSpdyStream::GetNextDatagramContextId() {
   QuicDatagramContextId result = datagram_next_available_context_id_;
   datagram_next_available_context_id_ += kDatagramContextIdIncrement;
@@ -21,6 +21,7 @@
 #include "absl/types/span.h"
 #include "quic/core/http/http_decoder.h"
 #include "quic/core/http/http_encoder.h"
+#include "quic/core/http/quic_header_block_sink.h"
 #include "quic/core/http/quic_header_list.h"
 #include "quic/core/http/quic_spdy_stream_body_manager.h"
 #include "quic/core/qpack/qpack_decoded_headers_accumulator.h"
@@ -160,7 +161,8 @@ class QUIC_EXPORT_PRIVATE QuicSpdyStream
   QuicConsumedData WritevBody(const struct iovec* iov, int count, bool fin);
 
   // Does the same thing as WriteOrBufferBody except this method takes
-  // memslicespan as the data input. Right now it only calls WriteMemSlices.
+  // memslicespan as the data input, and buffers the DATA frame header and the
+  // slices without copying them.  Writes nothing if the send buffer is full.
   QuicConsumedData WriteBodySlices(QuicMemSliceSpan slices, bool fin);
   QuicConsumedData WriteBodySlices(absl::Span<QuicMemSlice> slices, bool fin);
 
@@ -333,6 +335,11 @@ class QUIC_EXPORT_PRIVATE QuicSpdyStream
   // Sets max datagram time in queue.
   void SetMaxDatagramTimeInQueue(QuicTime::Delta max_time_in_queue);
 
+  // Sets the urgency of the datagrams of this stream relative to the datagrams
+  // of the other streams, from 0, the most urgent, to 7.  Datagrams of streams
+  // with the same urgency are sent in turns when they have to be queued.
+  void SetDatagramUrgency(int urgency);
+
   // Generates a new HTTP/3 datagram context ID for this stream. A datagram
   // registration visitor must be currently registered on this stream.
   QuicDatagramContextId GetNextDatagramContextId();
@@ -361,6 +368,16 @@ class QUIC_EXPORT_PRIVATE QuicSpdyStream
 
   void set_headers_decompressed(bool val) { headers_decompressed_ = val; }
 
+  // Makes |sink| receive the initial headers before OnInitialHeadersComplete()
+  // is called.  With HTTP/3, QPACK decodes the headers straight into |sink|,
+  // and OnInitialHeadersComplete() gets a QuicHeaderList without header fields,
+  // unless a debug visitor or WebTransport needs the list.  Otherwise the
+  // QuicHeaderList is also passed to |sink|.  Must be called before headers are
+  // received.  |sink| must outlive this stream.
+  void set_initial_headers_sink(QuicHeaderBlockSink* sink) {
+    initial_headers_sink_ = sink;
+  }
+
   void set_ack_listener(
       QuicReferenceCountedPointer<QuicAckListenerInterface> ack_listener) {
     ack_listener_ = std::move(ack_listener);
@@ -411,10 +428,21 @@ class QUIC_EXPORT_PRIVATE QuicSpdyStream
   void MaybeProcessSentWebTransportHeaders(spdy::SpdyHeaderBlock& headers);
   void MaybeProcessReceivedWebTransportHeaders();
 
-  // Writes HTTP/3 DATA frame header. If |force_write| is true, use
-  // WriteOrBufferData if send buffer cannot accomodate the header + data.
-  ABSL_MUST_USE_RESULT bool WriteDataFrameHeader(QuicByteCount data_length,
-                                                 bool force_write);
+  // Decodes readable data from the sequencer, and notifies the visitor of
+  // headers, body and trailers.  Called by OnDataAvailable().
+  void ProcessReadableData();
+
+  // Writes HTTP/3 DATA frame header. Uses WriteOrBufferData if send buffer
+  // cannot accomodate the header + data.
+  void WriteDataFrameHeader(QuicByteCount data_length);
+
+  // Writes an HTTP/3 DATA frame with |slices| of total length |data_length| as
+  // payload, if send buffer can accomodate the frame header.  Returns the
+  // number of payload bytes consumed.
+  template <typename SliceSpan>
+  QuicConsumedData WriteDataFrame(SliceSpan slices,
+                                  QuicByteCount data_length,
+                                  bool fin);
 
   QuicSpdySession* spdy_session_;
 
@@ -447,6 +475,10 @@ class QUIC_EXPORT_PRIVATE QuicSpdyStream
   // Headers accumulator for decoding HEADERS frame payload.
   std::unique_ptr<QpackDecodedHeadersAccumulator>
       qpack_decoded_headers_accumulator_;
+  // Receives the initial headers if not null.  Not owned.
+  QuicHeaderBlockSink* initial_headers_sink_ = nullptr;
+  // True if QPACK decodes the initial headers into |initial_headers_sink_|.
+  bool initial_headers_decoded_into_sink_ = false;
   // Visitor of the HttpDecoder.
   std::unique_ptr<HttpDecoderVisitor> http_decoder_visitor_;
   // HttpDecoder for processing raw incoming stream frames.
@@ -5,6 +5,8 @@
 #include "quic/core/http/quic_spdy_stream_body_manager.h"
 
 #include <algorithm>
+#include <cstring>
+#include <utility>
 
 #include "absl/strings/string_view.h"
 #include "quic/platform/api/quic_logging.h"
@@ -35,6 +37,26 @@ void QuicSpdyStreamBodyManager::OnBody(absl::string_view body) {
   total_body_bytes_received_ += body.length();
 }
 
+void QuicSpdyStreamBodyManager::CopyUnreadBody() {
+  size_t total_length = 0;
+  for (const Fragment& fragment : fragments_) {
+    total_length += fragment.body.length();
+  }
+  if (total_length == 0) {
+    return;
+  }
+  // The previous copy may still be referenced, so it is only released once
+  // the fragments point into the new one.
+  auto copied_body = std::make_unique<char[]>(total_length);
+  char* dest = copied_body.get();
+  for (Fragment& fragment : fragments_) {
+    memcpy(dest, fragment.body.data(), fragment.body.length());
+    fragment.body = absl::string_view(dest, fragment.body.length());
+    dest += fragment.body.length();
+  }
+  copied_body_ = std::move(copied_body);
+}
+
 size_t QuicSpdyStreamBodyManager::OnBodyConsumed(size_t num_bytes) {
   QuicByteCount bytes_to_consume = 0;
   size_t remaining_bytes = num_bytes;
@@ -5,6 +5,8 @@
 #ifndef QUICHE_QUIC_CORE_HTTP_QUIC_SPDY_STREAM_BODY_MANAGER_H_
 #define QUICHE_QUIC_CORE_HTTP_QUIC_SPDY_STREAM_BODY_MANAGER_H_
 
+#include <memory>
+
 #include "absl/base/attributes.h"
 #include "absl/strings/string_view.h"
 #include "quic/core/quic_constants.h"
@@ -67,6 +69,10 @@ class QUIC_EXPORT_PRIVATE QuicSpdyStreamBodyManager {
                                        size_t iov_len,
                                        size_t* total_bytes_read);
 
+  // Copies the body fragments which have not been read into a buffer owned by
+  // the body manager, for when the data they point to is about to go away.
+  void CopyUnreadBody();
+
   bool HasBytesToRead() const { return !fragments_.empty(); }
 
   uint64_t total_body_bytes_received() const {
@@ -85,6 +91,9 @@ class QUIC_EXPORT_PRIVATE QuicSpdyStreamBodyManager {
   };
   // Queue of body fragments and trailing non-body byte counts.
   quiche::QuicheCircularDeque<Fragment> fragments_;
+  // Body copied by CopyUnreadBody(), which fragments at the front of
+  // |fragments_| may point to.
+  std::unique_ptr<char[]> copied_body_;
   // Total body bytes received.
   QuicByteCount total_body_bytes_received_;
 };
@@ -279,6 +279,37 @@ TEST_F(QuicSpdyStreamBodyManagerTest, ReadBody) {
   }
 }
 
+TEST_F(QuicSpdyStreamBodyManagerTest, CopyUnreadBody) {
+  std::string body1 = "foobar";
+  std::string body2 = "baz";
+  EXPECT_EQ(4u, body_manager_.OnNonBody(4));
+  body_manager_.OnBody(body1);
+  EXPECT_EQ(0u, body_manager_.OnNonBody(3));
+  body_manager_.OnBody(body2);
+
+  // Read part of the first fragment, copy the rest, then copy again with an
+  // unread fragment pointing into the previous copy.
+  char buffer[3];
+  iovec iov = {buffer, 3};
+  size_t total_bytes_read = 0;
+  EXPECT_EQ(3u, body_manager_.ReadBody(&iov, 1, &total_bytes_read));
+  EXPECT_EQ("foo", absl::string_view(buffer, total_bytes_read));
+  body_manager_.CopyUnreadBody();
+  body_manager_.CopyUnreadBody();
+  body1.assign(body1.size(), 'x');
+  body2.assign(body2.size(), 'x');
+
+  iovec iovecs[2];
+  EXPECT_EQ(2u, body_manager_.PeekBody(iovecs, 2));
+  EXPECT_EQ("bar", absl::string_view(static_cast<char*>(iovecs[0].iov_base),
+                                     iovecs[0].iov_len));
+  EXPECT_EQ("baz", absl::string_view(static_cast<char*>(iovecs[1].iov_base),
+                                     iovecs[1].iov_len));
+  // Includes the second frame header.
+  EXPECT_EQ(9u, body_manager_.OnBodyConsumed(6));
+  EXPECT_FALSE(body_manager_.HasBytesToRead());
+}
+
 }  // anonymous namespace
 
 }  // namespace test
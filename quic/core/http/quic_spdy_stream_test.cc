@@ -4,6 +4,7 @@
 
 #include "quic/core/http/quic_spdy_stream.h"
 
+#include <algorithm>
 #include <cstring>
 #include <memory>
 #include <string>
@@ -14,6 +15,7 @@
 #include "absl/strings/escaping.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "quic/core/crypto/null_encrypter.h"
 #include "quic/core/http/http_encoder.h"
 #include "quic/core/http/spdy_utils.h"
@@ -186,6 +188,7 @@ class TestStream : public QuicSpdyStream {
   ~TestStream() override = default;
 
   using QuicSpdyStream::set_ack_listener;
+  using QuicSpdyStream::set_initial_headers_sink;
   using QuicStream::CloseWriteSide;
   using QuicStream::WriteOrBufferData;
 
@@ -591,6 +594,101 @@ TEST_P(QuicSpdyStreamTest, QpackProcessLargeHeaderListDiscountOverhead) {
   EXPECT_THAT(stream_->stream_error(), IsStreamError(QUIC_STREAM_NO_ERROR));
 }
 
+TEST_P(QuicSpdyStreamTest, InitialHeadersSink) {
+  Initialize(kShouldProcessData);
+  SpdyHeaderBlock header_block;
+  QuicHeaderBlockSink sink(&header_block);
+  stream_->set_initial_headers_sink(&sink);
+
+  if (UsesHttp3()) {
+    std::string headers = HeadersFrame(headers_);
+    stream_->OnStreamFrame(QuicStreamFrame(stream_->id(), false, 0, headers));
+    // QPACK decodes the headers straight into the sink.
+    EXPECT_TRUE(stream_->header_list().empty());
+  } else {
+    QuicHeaderList headers = ProcessHeaders(false, headers_);
+    EXPECT_EQ(headers, stream_->header_list());
+  }
+
+  EXPECT_TRUE(stream_->headers_decompressed());
+  EXPECT_TRUE(sink.valid());
+  EXPECT_EQ("/index.hml", sink.pseudo_headers().path);
+  EXPECT_EQ(headers_, header_block);
+
+  // Trailers are not passed to the sink.
+  stream_->ConsumeHeaderList();
+  SpdyHeaderBlock trailers;
+  trailers["key"] = "value";
+  if (UsesHttp3()) {
+    std::string data = HeadersFrame(trailers);
+    QuicStreamOffset offset = stream_->stream_bytes_read();
+    stream_->OnStreamFrame(QuicStreamFrame(stream_->id(), true, offset, data));
+  } else {
+    trailers[kFinalOffsetHeaderKey] = "0";
+    QuicHeaderList trailers_list = AsHeaderList(trailers);
+    stream_->OnStreamHeaderList(true, trailers_list.uncompressed_header_bytes(),
+                                trailers_list);
+  }
+  EXPECT_TRUE(stream_->trailers_decompressed());
+  EXPECT_EQ(headers_, header_block);
+}
+
+TEST_P(QuicSpdyStreamTest, InitialHeadersSinkWithDebugVisitor) {
+  if (!UsesHttp3()) {
+    return;
+  }
+
+  Initialize(kShouldProcessData);
+  SpdyHeaderBlock header_block;
+  QuicHeaderBlockSink sink(&header_block);
+  stream_->set_initial_headers_sink(&sink);
+  StrictMock<MockHttp3DebugVisitor> debug_visitor;
+  session_->set_debug_visitor(&debug_visitor);
+
+  // The debug visitor gets the QuicHeaderList, which is then passed to the
+  // sink.
+  std::string headers = HeadersFrame(headers_);
+  EXPECT_CALL(debug_visitor, OnHeadersFrameReceived(stream_->id(), _));
+  EXPECT_CALL(debug_visitor, OnHeadersDecoded(stream_->id(), _));
+  stream_->OnStreamFrame(QuicStreamFrame(stream_->id(), false, 0, headers));
+
+  EXPECT_FALSE(stream_->header_list().empty());
+  EXPECT_TRUE(sink.valid());
+  EXPECT_EQ(headers_, header_block);
+}
+
+TEST_P(QuicSpdyStreamTest, InitialHeadersSinkTooLarge) {
+  if (!UsesHttp3()) {
+    return;
+  }
+
+  Initialize(kShouldProcessData);
+  SpdyHeaderBlock header_block;
+  QuicHeaderBlockSink sink(&header_block);
+  stream_->set_initial_headers_sink(&sink);
+
+  // The first header field fits even with 32 bytes of overhead.
+  session_->set_max_inbound_header_list_size(40);
+  std::string headers = HeadersFrame(
+      {std::make_pair("foo", "bar"),
+       std::make_pair("foo", "too long even without the overhead")});
+
+  EXPECT_CALL(*session_,
+              MaybeSendStopSendingFrame(stream_->id(), QUIC_HEADERS_TOO_LARGE));
+  EXPECT_CALL(*session_, MaybeSendRstStreamFrame(stream_->id(),
+                                                 QUIC_HEADERS_TOO_LARGE, 0));
+  auto qpack_decoder_stream =
+      QuicSpdySessionPeer::GetQpackDecoderSendStream(session_.get());
+  // Stream type and stream cancellation.
+  EXPECT_CALL(*session_,
+              WritevData(qpack_decoder_stream->id(), _, _, NO_FIN, _, _))
+      .Times(2);
+
+  stream_->OnStreamFrame(QuicStreamFrame(stream_->id(), false, 0, headers));
+  EXPECT_THAT(stream_->stream_error(), IsStreamError(QUIC_HEADERS_TOO_LARGE));
+  EXPECT_TRUE(header_block.empty());
+}
+
 TEST_P(QuicSpdyStreamTest, ProcessHeaderListWithFin) {
   Initialize(kShouldProcessData);
 
@@ -929,6 +1027,56 @@ TEST_P(QuicSpdyStreamTest, ProcessHeadersAndBodyIncrementalReadv) {
   }
 }
 
+TEST_P(QuicSpdyStreamTest, ReadBodyInPlace) {
+  if (!UsesHttp3()) {
+    return;
+  }
+  SetQuicReloadableFlag(quic_spdy_stream_read_in_place, true);
+  Initialize(kShouldProcessData);
+  QuicStreamSequencer* sequencer = QuicStreamPeer::sequencer(stream_);
+  EXPECT_TRUE(sequencer->read_in_order_frames_in_place());
+
+  ProcessHeaders(false, headers_);
+  stream_->ConsumeHeaderList();
+  const QuicByteCount bytes_copied = sequencer->num_bytes_copied();
+
+  std::string body = "this is the body";
+  std::string data = DataFrame(body);
+  QuicStreamFrame frame(GetNthClientInitiatedBidirectionalId(0), false, 0,
+                        absl::string_view(data));
+  stream_->OnStreamFrame(frame);
+  EXPECT_EQ(body, stream_->data());
+  // The whole frame was consumed while it was read in place.
+  EXPECT_EQ(bytes_copied, sequencer->num_bytes_copied());
+}
+
+TEST_P(QuicSpdyStreamTest, ReadBodyInPlaceLeftUnread) {
+  if (!UsesHttp3()) {
+    return;
+  }
+  SetQuicReloadableFlag(quic_spdy_stream_read_in_place, true);
+  Initialize(!kShouldProcessData);
+
+  ProcessHeaders(false, headers_);
+  stream_->ConsumeHeaderList();
+
+  std::string body = "this is the body";
+  std::string data = DataFrame(body);
+  QuicStreamFrame frame(GetNthClientInitiatedBidirectionalId(0), false, 0,
+                        absl::string_view(data));
+  stream_->OnStreamFrame(frame);
+  // The body was not read, so it must not refer to the frame anymore.
+  std::fill(data.begin(), data.end(), 'x');
+
+  char buffer[2048];
+  struct iovec vec;
+  vec.iov_base = buffer;
+  vec.iov_len = ABSL_ARRAYSIZE(buffer);
+  size_t bytes_read = stream_->Readv(&vec, 1);
+  EXPECT_EQ(body.length(), bytes_read);
+  EXPECT_EQ(body, std::string(buffer, bytes_read));
+}
+
 TEST_P(QuicSpdyStreamTest, ProcessHeadersUsingReadvWithMultipleIovecs) {
   Initialize(!kShouldProcessData);
 
@@ -2002,6 +2150,27 @@ TEST_P(QuicSpdyStreamTest, HeadersAckNotReportedWriteBodySlices) {
       QuicSpdyStreamPeer::unacked_frame_headers_offsets(stream_).Empty());
 }
 
+// HTTP/3 only.
+TEST_P(QuicSpdyStreamTest, WriteBodySlicesWritesFrameHeaderWithPayload) {
+  if (!UsesHttp3()) {
+    return;
+  }
+
+  Initialize(kShouldProcessData);
+  std::string body(1000, 'x');
+  std::string data = DataFrame(body);
+  QuicMemSlice slice(
+      QuicBuffer::Copy(helper_.GetStreamSendBufferAllocator(), body));
+
+  // DATA frame header and payload are written to the session together.
+  EXPECT_CALL(*session_,
+              WritevData(stream_->id(), data.length(), 0, FIN, _, _));
+  QuicConsumedData consumed =
+      stream_->WriteBodySlices(absl::MakeSpan(&slice, 1), /*fin=*/true);
+  EXPECT_EQ(body.length(), consumed.bytes_consumed);
+  EXPECT_TRUE(consumed.fin_consumed);
+}
+
 // HTTP/3 only.
 TEST_P(QuicSpdyStreamTest, HeaderBytesNotReportedOnRetransmission) {
   if (!UsesHttp3()) {
@@ -61,6 +61,7 @@ bool SpdyUtils::ExtractContentLengthFromHeaders(int64_t* content_length,
 bool SpdyUtils::CopyAndValidateHeaders(const QuicHeaderList& header_list,
                                        int64_t* content_length,
                                        SpdyHeaderBlock* headers) {
+  bool has_content_length = false;
   for (const auto& p : header_list) {
     const std::string& name = p.first;
     if (name.empty()) {
@@ -74,10 +75,13 @@ bool SpdyUtils::CopyAndValidateHeaders(const QuicHeaderList& header_list,
       return false;
     }
 
+    if (name == "content-length") {
+      has_content_length = true;
+    }
     headers->AppendValueOrAddHeader(name, p.second);
   }
 
-  if (headers->contains("content-length") &&
+  if (has_content_length &&
       !ExtractContentLengthFromHeaders(content_length, headers)) {
     return false;
   }
@@ -15,16 +15,32 @@ QpackDecodedHeadersAccumulator::QpackDecodedHeadersAccumulator(
     QpackDecoder* qpack_decoder,
     Visitor* visitor,
     size_t max_header_list_size)
+    : QpackDecodedHeadersAccumulator(id,
+                                     qpack_decoder,
+                                     visitor,
+                                     max_header_list_size,
+                                     /*sink=*/nullptr) {}
+
+QpackDecodedHeadersAccumulator::QpackDecodedHeadersAccumulator(
+    QuicStreamId id,
+    QpackDecoder* qpack_decoder,
+    Visitor* visitor,
+    size_t max_header_list_size,
+    QuicHeaderBlockSink* sink)
     : decoder_(qpack_decoder->CreateProgressiveDecoder(id, this)),
       visitor_(visitor),
       max_header_list_size_(max_header_list_size),
       uncompressed_header_bytes_including_overhead_(0),
+      sink_(sink),
       uncompressed_header_bytes_without_overhead_(0),
       compressed_header_bytes_(0),
       header_list_size_limit_exceeded_(false),
       headers_decoded_(false),
       error_detected_(false) {
   quic_header_list_.OnHeaderBlockStart();
+  if (sink_ != nullptr) {
+    sink_->OnHeaderBlockStart();
+  }
 }
 
 void QpackDecodedHeadersAccumulator::OnHeaderDecoded(absl::string_view name,
@@ -47,6 +63,11 @@ void QpackDecodedHeadersAccumulator::OnHeaderDecoded(absl::string_view name,
   if (uncompressed_header_bytes > max_header_list_size_) {
     header_list_size_limit_exceeded_ = true;
     quic_header_list_.Clear();
+    if (sink_ != nullptr) {
+      sink_->Clear();
+    }
+  } else if (sink_ != nullptr) {
+    sink_->OnHeader(name, value);
   } else {
     quic_header_list_.OnHeader(name, value);
   }
@@ -60,6 +81,10 @@ void QpackDecodedHeadersAccumulator::OnDecodingCompleted() {
 
   quic_header_list_.OnHeaderBlockEnd(
       uncompressed_header_bytes_without_overhead_, compressed_header_bytes_);
+  if (sink_ != nullptr) {
+    sink_->OnHeaderBlockEnd(uncompressed_header_bytes_without_overhead_,
+                            compressed_header_bytes_);
+  }
 
   // Might destroy |this|.
   visitor_->OnHeadersDecoded(std::move(quic_header_list_),
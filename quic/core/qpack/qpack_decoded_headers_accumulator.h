@@ -9,6 +9,7 @@
 #include <string>
 
 #include "absl/strings/string_view.h"
+#include "quic/core/http/quic_header_block_sink.h"
 #include "quic/core/http/quic_header_list.h"
 #include "quic/core/qpack/qpack_progressive_decoder.h"
 #include "quic/core/quic_types.h"
@@ -21,7 +22,9 @@ class QpackDecoder;
 // A class that creates and owns a QpackProgressiveDecoder instance, accumulates
 // decoded headers in a QuicHeaderList, and keeps track of uncompressed and
 // compressed size so that it can be passed to
-// QuicHeaderList::OnHeaderBlockEnd().
+// QuicHeaderList::OnHeaderBlockEnd().  If constructed with a
+// QuicHeaderBlockSink, decoded headers are passed to the sink instead, and the
+// QuicHeaderList only carries the sizes.
 class QUIC_EXPORT_PRIVATE QpackDecodedHeadersAccumulator
     : public QpackProgressiveDecoder::HeadersHandlerInterface {
  public:
@@ -40,7 +43,8 @@ class QUIC_EXPORT_PRIVATE QpackDecodedHeadersAccumulator
     // constructor, then |header_list_size_limit_exceeded| will be true, and
     // |headers| will be empty but will still have the correct compressed and
     // uncompressed size
-    // information.
+    // information.  |headers| is also empty if a QuicHeaderBlockSink was
+    // passed to the QpackDecodedHeadersAccumulator constructor.
     virtual void OnHeadersDecoded(QuicHeaderList headers,
                                   bool header_list_size_limit_exceeded) = 0;
 
@@ -52,6 +56,14 @@ class QUIC_EXPORT_PRIVATE QpackDecodedHeadersAccumulator
                                  QpackDecoder* qpack_decoder,
                                  Visitor* visitor,
                                  size_t max_header_list_size);
+  // Passes decoded headers to |sink| instead of the QuicHeaderList.  |sink| is
+  // cleared if the header list size limit is exceeded.  |sink| must outlive
+  // this object.
+  QpackDecodedHeadersAccumulator(QuicStreamId id,
+                                 QpackDecoder* qpack_decoder,
+                                 Visitor* visitor,
+                                 size_t max_header_list_size,
+                                 QuicHeaderBlockSink* sink);
   virtual ~QpackDecodedHeadersAccumulator() = default;
 
   // QpackProgressiveDecoder::HeadersHandlerInterface implementation.
@@ -79,6 +91,8 @@ class QUIC_EXPORT_PRIVATE QpackDecodedHeadersAccumulator
   // Uncompressed header list size including overhead, for enforcing the limit.
   size_t uncompressed_header_bytes_including_overhead_;
   QuicHeaderList quic_header_list_;
+  // If not null, receives decoded headers instead of |quic_header_list_|.
+  QuicHeaderBlockSink* sink_;  // Not owned.
   // Uncompressed header list size with overhead,
   // for passing in to QuicHeaderList::OnHeaderBlockEnd().
   size_t uncompressed_header_bytes_without_overhead_;
@@ -245,5 +245,52 @@ TEST_F(QpackDecodedHeadersAccumulatorTest,
   qpack_decoder_.OnInsertWithoutNameReference("foo", "bar");
 }
 
+TEST_F(QpackDecodedHeadersAccumulatorTest, DecodeIntoSink) {
+  spdy::Http2HeaderBlock header_block;
+  QuicHeaderBlockSink sink(&header_block);
+  QpackDecodedHeadersAccumulator accumulator(
+      kTestStreamId, &qpack_decoder_, &visitor_, kMaxHeaderListSize, &sink);
+  std::string encoded_data(absl::HexStringToBytes("000023666f6f03626172"));
+  accumulator.Decode(encoded_data);
+
+  QuicHeaderList header_list;
+  EXPECT_CALL(visitor_, OnHeadersDecoded(_, false))
+      .WillOnce(SaveArg<0>(&header_list));
+  accumulator.EndHeaderBlock();
+
+  // Headers are only passed to the sink, but the list still carries the sizes.
+  EXPECT_TRUE(header_list.empty());
+  EXPECT_EQ(strlen("foo") + strlen("bar"),
+            header_list.uncompressed_header_bytes());
+  EXPECT_EQ(encoded_data.size(), header_list.compressed_header_bytes());
+
+  EXPECT_TRUE(sink.valid());
+  EXPECT_THAT(header_block, ElementsAre(Pair("foo", "bar")));
+  EXPECT_EQ(strlen("foo") + strlen("bar"), sink.uncompressed_header_bytes());
+  EXPECT_EQ(encoded_data.size(), sink.compressed_header_bytes());
+}
+
+TEST_F(QpackDecodedHeadersAccumulatorTest, ExceedLimitWithSink) {
+  spdy::Http2HeaderBlock header_block;
+  QuicHeaderBlockSink sink(&header_block);
+  QpackDecodedHeadersAccumulator accumulator(
+      kTestStreamId, &qpack_decoder_, &visitor_, kMaxHeaderListSize, &sink);
+  // Total length of header list exceeds kMaxHeaderListSize.
+  accumulator.Decode(absl::HexStringToBytes(
+      "0000"                                      // header block prefix
+      "23666f6f03626172"                          // header "foo: bar"
+      "26666f6f626172"                            // header key: "foobar"
+      "7d61616161616161616161616161616161616161"  // header value: 'a' 125 times
+      "616161616161616161616161616161616161616161616161616161616161616161616161"
+      "616161616161616161616161616161616161616161616161616161616161616161616161"
+      "61616161616161616161616161616161616161616161616161616161616161616161"
+      "23666f6f03626172"));  // header "foo: bar"
+
+  EXPECT_CALL(visitor_, OnHeadersDecoded(_, true));
+  accumulator.EndHeaderBlock();
+
+  EXPECT_TRUE(header_block.empty());
+}
+
 }  // namespace test
 }  // namespace quic
@@ -11,8 +11,7 @@
 namespace quic {
 
 QpackEncoderHeaderTable::QpackEncoderHeaderTable()
-    : static_index_(ObtainQpackStaticTable().GetStaticIndex()),
-      static_name_index_(ObtainQpackStaticTable().GetStaticNameIndex()) {}
+    : static_index_(ObtainQpackStaticTable().GetStaticIndex()) {}
 
 uint64_t QpackEncoderHeaderTable::InsertEntry(absl::string_view name,
                                               absl::string_view value) {
@@ -55,18 +54,17 @@ QpackEncoderHeaderTable::MatchType QpackEncoderHeaderTable::FindHeaderField(
     absl::string_view value,
     bool* is_static,
     uint64_t* index) const {
-  QpackLookupEntry query{name, value};
-
   // Look for exact match in static table.
-  auto index_it = static_index_.find(query);
-  if (index_it != static_index_.end()) {
-    *index = index_it->second;
+  const size_t static_index = static_index_.LookupNameAndValue(name, value);
+  if (static_index != spdy::HpackStaticIndex::kNotFound) {
+    *index = static_index;
     *is_static = true;
     return MatchType::kNameAndValue;
   }
 
   // Look for exact match in dynamic table.
-  index_it = dynamic_index_.find(query);
+  QpackLookupEntry query{name, value};
+  auto index_it = dynamic_index_.find(query);
   if (index_it != dynamic_index_.end()) {
     *index = index_it->second;
     *is_static = false;
@@ -74,15 +72,15 @@ QpackEncoderHeaderTable::MatchType QpackEncoderHeaderTable::FindHeaderField(
   }
 
   // Look for name match in static table.
-  auto name_index_it = static_name_index_.find(name);
-  if (name_index_it != static_name_index_.end()) {
-    *index = name_index_it->second;
+  const size_t static_name_index = static_index_.LookupName(name);
+  if (static_name_index != spdy::HpackStaticIndex::kNotFound) {
+    *index = static_name_index;
     *is_static = true;
     return MatchType::kName;
   }
 
   // Look for name match in dynamic table.
-  name_index_it = dynamic_name_index_.find(name);
+  auto name_index_it = dynamic_name_index_.find(name);
   if (name_index_it != dynamic_name_index_.end()) {
     *index = name_index_it->second;
     *is_static = false;
@@ -13,6 +13,7 @@
 #include "common/quiche_circular_deque.h"
 #include "spdy/core/hpack/hpack_entry.h"
 #include "spdy/core/hpack/hpack_header_table.h"
+#include "spdy/core/hpack/hpack_static_index.h"
 
 namespace quic {
 
@@ -265,14 +266,11 @@ class QUIC_EXPORT_PRIVATE QpackEncoderHeaderTable
 
   // Static Table
 
-  // |static_index_| and |static_name_index_| are owned by QpackStaticTable
-  // singleton.
+  // |static_index_| is owned by QpackStaticTable singleton.
 
-  // Tracks the unique static entry for a given header name and value.
-  const NameValueToEntryMap& static_index_;
-
-  // Tracks the first static entry for a given header name.
-  const NameToEntryMap& static_name_index_;
+  // Finds the unique static entry for a given header name and value, and the
+  // first static entry for a given header name.
+  const spdy::HpackStaticIndex& static_index_;
 
   // Dynamic Table
 
@@ -4,11 +4,15 @@
 
 #include "quic/core/qpack/qpack_static_table.h"
 
+#include <map>
 #include <set>
+#include <string>
+#include <vector>
 
 #include "absl/base/macros.h"
 #include "absl/strings/string_view.h"
 #include "quic/platform/api/quic_test.h"
+#include "spdy/core/hpack/hpack_static_index.h"
 
 namespace quic {
 
@@ -21,23 +25,51 @@ TEST(QpackStaticTableTest, Initialize) {
   QpackStaticTable table;
   EXPECT_FALSE(table.IsInitialized());
 
+  const spdy::HpackStaticIndex& index =
+      ObtainQpackStaticTable().GetStaticIndex();
   table.Initialize(QpackStaticTableVector().data(),
-                   QpackStaticTableVector().size());
+                   QpackStaticTableVector().size(), &index);
   EXPECT_TRUE(table.IsInitialized());
 
   const auto& static_entries = table.GetStaticEntries();
   EXPECT_EQ(QpackStaticTableVector().size(), static_entries.size());
 
   const auto& static_index = table.GetStaticIndex();
+  EXPECT_EQ(&index, &static_index);
   EXPECT_EQ(QpackStaticTableVector().size(), static_index.size());
 
-  const auto& static_name_index = table.GetStaticNameIndex();
   // Count distinct names in static table.
   std::set<absl::string_view> names;
   for (const auto& entry : static_entries) {
     names.insert(entry.name());
   }
-  EXPECT_EQ(names.size(), static_name_index.size());
+  EXPECT_EQ(names.size(), static_index.name_count());
+}
+
+// Every entry of the QPACK static table is found by name and value, and every
+// name is found at its first entry.
+TEST(QpackStaticTableTest, LookupEveryEntry) {
+  const std::vector<QpackStaticEntry>& entries = QpackStaticTableVector();
+  const spdy::HpackStaticIndex& index =
+      ObtainQpackStaticTable().GetStaticIndex();
+  ASSERT_EQ(entries.size(), index.size());
+
+  std::map<std::string, size_t> first_index_by_name;
+  for (size_t i = 0; i < entries.size(); ++i) {
+    const absl::string_view name(entries[i].name, entries[i].name_len);
+    const absl::string_view value(entries[i].value, entries[i].value_len);
+    EXPECT_EQ(i, index.LookupNameAndValue(name, value))
+        << name << ": " << value;
+    first_index_by_name.emplace(std::string(name), i);
+  }
+  EXPECT_EQ(first_index_by_name.size(), index.name_count());
+  for (const auto& name_and_index : first_index_by_name) {
+    EXPECT_EQ(name_and_index.second, index.LookupName(name_and_index.first))
+        << name_and_index.first;
+  }
+  EXPECT_EQ(spdy::HpackStaticIndex::kNotFound,
+            index.LookupNameAndValue(":method", "PATCH"));
+  EXPECT_EQ(spdy::HpackStaticIndex::kNotFound, index.LookupName("x-foo"));
 }
 
 // Test that ObtainQpackStaticTable returns the same instance every time.
@@ -141,7 +141,7 @@ EnqueuePacketResult QuicBufferedPacketStore::EnqueuePacket(
     queue.buffered_packets.push_front(std::move(new_entry));
     queue.alpns = alpns;
     queue.sni = std::string(sni);
-    connections_with_chlo_[connection_id] = false;  // Dummy value.
+    connections_with_chlo_[connection_id] = false;  // Not prioritized.
     // Set the version of buffered packets of this connection on CHLO.
     queue.version = version;
   } else {
@@ -186,12 +186,13 @@ BufferedPacketList QuicBufferedPacketStore::DeliverPackets(
 
 void QuicBufferedPacketStore::DiscardPackets(QuicConnectionId connection_id) {
   undecryptable_packets_.erase(connection_id);
-  connections_with_chlo_.erase(connection_id);
+  EraseConnectionWithChlo(connection_id);
 }
 
 void QuicBufferedPacketStore::DiscardAllPackets() {
   undecryptable_packets_.clear();
   connections_with_chlo_.clear();
+  num_prioritized_chlos_ = 0;
   expiration_alarm_->Cancel();
 }
 
@@ -205,7 +206,7 @@ void QuicBufferedPacketStore::OnExpirationTimeout() {
     QuicConnectionId connection_id = entry.first;
     visitor_->OnExpiredPackets(connection_id, std::move(entry.second));
     undecryptable_packets_.pop_front();
-    connections_with_chlo_.erase(connection_id);
+    EraseConnectionWithChlo(connection_id);
   }
   if (!undecryptable_packets_.empty()) {
     MaybeSetExpirationAlarm();
@@ -240,8 +241,17 @@ BufferedPacketList QuicBufferedPacketStore::DeliverPacketsForNextConnection(
     // Returns empty list if no CHLO has been buffered.
     return BufferedPacketList();
   }
-  *connection_id = connections_with_chlo_.front().first;
-  connections_with_chlo_.pop_front();
+  auto it = connections_with_chlo_.begin();
+  if (num_prioritized_chlos_ > 0) {
+    // The store holds at most kDefaultMaxConnectionsInStore connections, so
+    // the search is bounded.
+    while (!it->second) {
+      ++it;
+    }
+    --num_prioritized_chlos_;
+  }
+  *connection_id = it->first;
+  connections_with_chlo_.erase(it);
 
   BufferedPacketList packets = DeliverPackets(*connection_id);
   QUICHE_DCHECK(!packets.buffered_packets.empty())
@@ -254,6 +264,31 @@ bool QuicBufferedPacketStore::HasChloForConnection(
   return connections_with_chlo_.contains(connection_id);
 }
 
+bool QuicBufferedPacketStore::PrioritizeConnection(
+    QuicConnectionId connection_id) {
+  auto it = connections_with_chlo_.find(connection_id);
+  if (it == connections_with_chlo_.end()) {
+    return false;
+  }
+  if (!it->second) {
+    it->second = true;
+    ++num_prioritized_chlos_;
+  }
+  return true;
+}
+
+void QuicBufferedPacketStore::EraseConnectionWithChlo(
+    QuicConnectionId connection_id) {
+  auto it = connections_with_chlo_.find(connection_id);
+  if (it == connections_with_chlo_.end()) {
+    return;
+  }
+  if (it->second) {
+    --num_prioritized_chlos_;
+  }
+  connections_with_chlo_.erase(it);
+}
+
 bool QuicBufferedPacketStore::IngestPacketForTlsChloExtraction(
     const QuicConnectionId& connection_id,
     const ParsedQuicVersion& version,
@@ -146,6 +146,8 @@ class QUIC_NO_EXPORT QuicBufferedPacketStore {
   void OnExpirationTimeout();
 
   // Delivers buffered packets for next connection with CHLO to open.
+  // Connections prioritized by PrioritizeConnection() are delivered first, in
+  // the order their CHLOs arrived, followed by the others in arrival order.
   // Return connection id for next connection in |connection_id|
   // and all buffered packets including CHLO.
   // The returned list should at least has one packet(CHLO) if
@@ -160,6 +162,14 @@ class QUIC_NO_EXPORT QuicBufferedPacketStore {
   // Is there any CHLO buffered in the store?
   bool HasChlosBuffered() const;
 
+  // Returns the number of connections with a CHLO buffered.
+  size_t NumChlosBuffered() const { return connections_with_chlo_.size(); }
+
+  // Delivers |connection_id| ahead of connections which are not prioritized
+  // in DeliverPacketsForNextConnection().  Returns false if no CHLO is
+  // buffered for |connection_id|.
+  bool PrioritizeConnection(QuicConnectionId connection_id);
+
  private:
   friend class test::QuicBufferedPacketStorePeer;
 
@@ -184,10 +194,16 @@ class QUIC_NO_EXPORT QuicBufferedPacketStore {
   // packets staying in the store for too long.
   std::unique_ptr<QuicAlarm> expiration_alarm_;
 
+  // Removes |connection_id| from |connections_with_chlo_|, if present.
+  void EraseConnectionWithChlo(QuicConnectionId connection_id);
+
   // Keeps track of connection with CHLO buffered up already and the order they
-  // arrive.
+  // arrive.  The value is whether the connection is prioritized.
   quiche::QuicheLinkedHashMap<QuicConnectionId, bool, QuicConnectionIdHash>
       connections_with_chlo_;
+
+  // Number of prioritized connections in |connections_with_chlo_|.
+  size_t num_prioritized_chlos_ = 0;
 };
 
 }  // namespace quic
@@ -437,6 +437,34 @@ TEST_F(QuicBufferedPacketStoreTest, DiscardPacketsEmpty) {
   EXPECT_FALSE(store_.HasChlosBuffered());
 }
 
+TEST_F(QuicBufferedPacketStoreTest, DeliverPrioritizedConnectionsFirst) {
+  for (uint64_t conn_id = 1; conn_id <= 5; ++conn_id) {
+    store_.EnqueuePacket(TestConnectionId(conn_id), false, packet_,
+                         self_address_, peer_address_, true, {}, "",
+                         valid_version_);
+  }
+  // Connections without a CHLO can't be prioritized.
+  EXPECT_FALSE(store_.PrioritizeConnection(TestConnectionId(6)));
+  EXPECT_TRUE(store_.PrioritizeConnection(TestConnectionId(4)));
+  EXPECT_TRUE(store_.PrioritizeConnection(TestConnectionId(2)));
+  EXPECT_TRUE(store_.PrioritizeConnection(TestConnectionId(4)));
+  EXPECT_EQ(5u, store_.NumChlosBuffered());
+
+  // A discarded prioritized connection is no longer delivered.
+  store_.DiscardPackets(TestConnectionId(4));
+  EXPECT_EQ(4u, store_.NumChlosBuffered());
+
+  // Prioritized connections go first, then the others in arrival order.
+  QuicConnectionId delivered_conn_id;
+  for (uint64_t conn_id : {2, 1, 3, 5}) {
+    EXPECT_EQ(1u, store_.DeliverPacketsForNextConnection(&delivered_conn_id)
+                      .buffered_packets.size());
+    EXPECT_EQ(TestConnectionId(conn_id), delivered_conn_id);
+  }
+  EXPECT_FALSE(store_.HasChlosBuffered());
+  EXPECT_EQ(0u, store_.NumChlosBuffered());
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace quic
@@ -395,6 +395,9 @@ QuicConnection::QuicConnection(
       << server_connection_id << " which is invalid with version " << version();
   framer_.set_visitor(this);
   stats_.connection_creation_time = clock_->ApproximateNow();
+  if (record_latency_histograms_) {
+    stats_.latency_histograms.Allocate();
+  }
   // TODO(ianswett): Supply the NetworkChangeVisitor as a constructor argument
   // and make it required non-null, because it's always used.
   sent_packet_manager_.SetNetworkChangeVisitor(this);
@@ -1352,8 +1355,13 @@ bool QuicConnection::OnPacketHeader(const QuicPacketHeader& header) {
         quic_reset_per_packet_state_for_undecryptable_packets, 2, 2);
     receipt_time = last_received_packet_info_.receipt_time;
   }
+  QuicEcnCodepoint ecn_codepoint = ECN_NOT_ECT;
+  if (receive_ecn_ && version().HasIetfQuicFrames()) {
+    QUIC_RELOADABLE_FLAG_COUNT(quic_receive_ecn);
+    ecn_codepoint = last_received_packet_info_.ecn_codepoint;
+  }
   uber_received_packet_manager_.RecordPacketReceived(
-      last_decrypted_packet_level_, last_header_, receipt_time);
+      last_decrypted_packet_level_, last_header_, receipt_time, ecn_codepoint);
   if (EnforceAntiAmplificationLimit() && !IsHandshakeConfirmed() &&
       !header.retry_token.empty() &&
       visitor_->ValidateToken(header.retry_token)) {
@@ -1402,6 +1410,12 @@ bool QuicConnection::OnStreamFrame(const QuicStreamFrame& frame) {
   MaybeUpdateAckTimeout();
   visitor_->OnStreamFrame(frame);
   stats_.stream_bytes_received += frame.data_length;
+  if (stats_.latency_histograms &&
+      last_received_packet_info_.receipt_time.IsInitialized()) {
+    QUIC_RELOADABLE_FLAG_COUNT_N(quic_record_latency_histograms, 3, 4);
+    stats_.latency_histograms->receive_to_delivery_delay.Add(
+        clock_->Now() - last_received_packet_info_.receipt_time);
+  }
   consecutive_retransmittable_on_wire_ping_count_ = 0;
   return connected_;
 }
@@ -1509,6 +1523,23 @@ bool QuicConnection::OnAckTimestamp(QuicPacketNumber packet_number,
   return true;
 }
 
+bool QuicConnection::OnAckEcnCounts(const QuicEcnCounts& ecn_counts) {
+  QUIC_BUG_IF(quic_bug_10511_43, !connected_)
+      << "Processing ACK frame ECN counts when connection is closed. Last "
+         "frame: "
+      << most_recent_frame_type_;
+  QUIC_DVLOG(1) << ENDPOINT << "OnAckEcnCounts: " << ecn_counts;
+
+  if (GetLargestReceivedPacketWithAck().IsInitialized() &&
+      last_header_.packet_number <= GetLargestReceivedPacketWithAck()) {
+    QUIC_DLOG(INFO) << ENDPOINT << "Received an old ack frame: ignoring";
+    return true;
+  }
+
+  sent_packet_manager_.OnAckEcnCounts(ecn_counts);
+  return true;
+}
+
 bool QuicConnection::OnAckFrameEnd(QuicPacketNumber start) {
   QUIC_BUG_IF(quic_bug_12714_7, !connected_)
       << "Processing ACK frame end when connection is closed. Last frame: "
@@ -2832,7 +2863,8 @@ void QuicConnection::ProcessUdpPacket(const QuicSocketAddress& self_address,
     debug_visitor_->OnPacketReceived(self_address, peer_address, packet);
   }
   last_received_packet_info_ =
-      ReceivedPacketInfo(self_address, peer_address, packet.receipt_time());
+      ReceivedPacketInfo(self_address, peer_address, packet.receipt_time(),
+                         packet.ecn_codepoint());
   last_size_ = packet.length();
   current_packet_data_ = packet.data();
 
@@ -3417,6 +3449,10 @@ bool QuicConnection::CanWrite(HasRetransmittableData retransmittable) {
       return true;
     }
     // Cannot send packet now because delay is too far in the future.
+    if (stats_.latency_histograms) {
+      QUIC_RELOADABLE_FLAG_COUNT_N(quic_record_latency_histograms, 2, 4);
+      stats_.latency_histograms->pacing_delay.Add(delay);
+    }
     send_alarm_->Update(now + delay, kAlarmGranularity);
     QUIC_DVLOG(1) << ENDPOINT << "Delaying sending " << delay.ToMilliseconds()
                   << "ms";
@@ -3511,6 +3547,9 @@ bool QuicConnection::WritePacket(SerializedPacket* packet) {
       (send_path_response_) ? packet->peer_address : peer_address();
   // Self address is always the default self address on this code path.
   bool send_on_current_path = send_to_address == peer_address();
+  // Only packets handed directly to the writer on the current path are sent
+  // ECN-capable. Coalesced and buffered packets are not.
+  QuicEcnCodepoint ecn_codepoint = ECN_NOT_ECT;
   switch (fate) {
     case DISCARD:
       ++stats_.packets_discarded;
@@ -3562,9 +3601,23 @@ bool QuicConnection::WritePacket(SerializedPacket* packet) {
       //
       // writer_->WritePacket transfers buffer ownership back to the writer.
       packet->release_encrypted_buffer = nullptr;
-      result = writer_->WritePacket(packet->encrypted_buffer, encrypted_length,
-                                    self_address().host(), send_to_address,
-                                    per_packet_options_);
+      if (send_on_current_path && version().HasIetfQuicFrames()) {
+        ecn_codepoint = sent_packet_manager_.GetEcnCodepointToSend();
+      }
+      if (ecn_codepoint == ECN_NOT_ECT) {
+        result = writer_->WritePacket(packet->encrypted_buffer,
+                                      encrypted_length, self_address().host(),
+                                      send_to_address, per_packet_options_);
+      } else {
+        PerPacketOptions* options = per_packet_options_ != nullptr
+                                        ? per_packet_options_
+                                        : &ecn_per_packet_options_;
+        options->ecn_codepoint = ecn_codepoint;
+        result = writer_->WritePacket(packet->encrypted_buffer,
+                                      encrypted_length, self_address().host(),
+                                      send_to_address, options);
+        options->ecn_codepoint = ECN_NOT_ECT;
+      }
       // This is a work around for an issue with linux UDP GSO batch writers.
       // When sending a GSO packet with 2 segments, if the first segment is
       // larger than the path MTU, instead of EMSGSIZE, the linux kernel returns
@@ -3642,6 +3695,8 @@ bool QuicConnection::WritePacket(SerializedPacket* packet) {
       QUIC_DVLOG(1) << ENDPOINT << "Adding packet: " << packet->packet_number
                     << " to buffered packets";
       buffered_packets_.emplace_back(*packet, self_address(), send_to_address);
+      // The buffered packet is resent without ECN marking.
+      ecn_codepoint = ECN_NOT_ECT;
     }
   }
 
@@ -3738,7 +3793,8 @@ bool QuicConnection::WritePacket(SerializedPacket* packet) {
       << " while current path has peer address " << peer_address();
   const bool in_flight = sent_packet_manager_.OnPacketSent(
       packet, packet_send_time, packet->transmission_type,
-      IsRetransmittable(*packet), /*measure_rtt=*/send_on_current_path);
+      IsRetransmittable(*packet), /*measure_rtt=*/send_on_current_path,
+      ecn_codepoint);
   QUIC_BUG_IF(quic_bug_12714_25,
               default_enable_5rto_blackhole_detection_ &&
                   blackhole_detector_.IsDetectionInProgress() &&
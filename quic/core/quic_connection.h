@@ -663,6 +663,7 @@ class QUIC_EXPORT_PRIVATE QuicConnection
   bool OnAckRange(QuicPacketNumber start, QuicPacketNumber end) override;
   bool OnAckTimestamp(QuicPacketNumber packet_number,
                       QuicTime timestamp) override;
+  bool OnAckEcnCounts(const QuicEcnCounts& ecn_counts) override;
   bool OnAckFrameEnd(QuicPacketNumber start) override;
   bool OnStopWaitingFrame(const QuicStopWaitingFrame& frame) override;
   bool OnPaddingFrame(const QuicPaddingFrame& frame) override;
@@ -1428,16 +1429,27 @@ class QUIC_EXPORT_PRIVATE QuicConnection
         : received_bytes_counted(false), receipt_time(receipt_time) {}
     ReceivedPacketInfo(const QuicSocketAddress& destination_address,
                        const QuicSocketAddress& source_address,
-                       QuicTime receipt_time)
+                       QuicTime receipt_time,
+                       QuicEcnCodepoint ecn_codepoint)
         : received_bytes_counted(false),
           destination_address(destination_address),
           source_address(source_address),
-          receipt_time(receipt_time) {}
+          receipt_time(receipt_time),
+          ecn_codepoint(ecn_codepoint) {}
 
     bool received_bytes_counted;
     QuicSocketAddress destination_address;
     QuicSocketAddress source_address;
     QuicTime receipt_time;
+    QuicEcnCodepoint ecn_codepoint = ECN_NOT_ECT;
+  };
+
+  // Per packet options used to set the ECN codepoint of outgoing packets when
+  // the owner of the writer does not provide any.
+  struct QUIC_EXPORT_PRIVATE EcnPerPacketOptions : public PerPacketOptions {
+    std::unique_ptr<PerPacketOptions> Clone() const override {
+      return std::make_unique<EcnPerPacketOptions>(*this);
+    }
   };
 
   // UndecrytablePacket comprises a undecryptable packet and related
@@ -2283,6 +2295,12 @@ class QUIC_EXPORT_PRIVATE QuicConnection
   const bool reset_per_packet_state_for_undecryptable_packets_ =
       GetQuicReloadableFlag(
           quic_reset_per_packet_state_for_undecryptable_packets);
+  const bool record_latency_histograms_ =
+      GetQuicReloadableFlag(quic_record_latency_histograms);
+
+  const bool receive_ecn_ = GetQuicReloadableFlag(quic_receive_ecn);
+
+  EcnPerPacketOptions ecn_per_packet_options_;
 };
 
 }  // namespace quic
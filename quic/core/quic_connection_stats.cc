@@ -6,6 +6,49 @@
 
 namespace quic {
 
+void QuicConnectionLatencyHistograms::Merge(
+    const QuicConnectionLatencyHistograms& other) {
+  rtt.Merge(other.rtt);
+  ack_delay.Merge(other.ack_delay);
+  pacing_delay.Merge(other.pacing_delay);
+  receive_to_delivery_delay.Merge(other.receive_to_delivery_delay);
+  handshake_duration.Merge(other.handshake_duration);
+}
+
+QuicConnectionLatencyHistogramsPtr::QuicConnectionLatencyHistogramsPtr(
+    const QuicConnectionLatencyHistogramsPtr& other) {
+  *this = other;
+}
+
+QuicConnectionLatencyHistogramsPtr&
+QuicConnectionLatencyHistogramsPtr::operator=(
+    const QuicConnectionLatencyHistogramsPtr& other) {
+  if (this != &other) {
+    histograms_ =
+        other.histograms_ == nullptr
+            ? nullptr
+            : std::make_unique<QuicConnectionLatencyHistograms>(*other);
+  }
+  return *this;
+}
+
+void QuicConnectionLatencyHistogramsPtr::Allocate() {
+  if (histograms_ == nullptr) {
+    histograms_ = std::make_unique<QuicConnectionLatencyHistograms>();
+  }
+}
+
+std::ostream& operator<<(std::ostream& os,
+                         const QuicConnectionLatencyHistograms& h) {
+  os << "{ rtt: " << h.rtt;
+  os << " ack_delay: " << h.ack_delay;
+  os << " pacing_delay: " << h.pacing_delay;
+  os << " receive_to_delivery_delay: " << h.receive_to_delivery_delay;
+  os << " handshake_duration: " << h.handshake_duration;
+  os << " }";
+  return os;
+}
+
 std::ostream& operator<<(std::ostream& os, const QuicConnectionStats& s) {
   os << "{ bytes_sent: " << s.bytes_sent;
   os << " packets_sent: " << s.packets_sent;
@@ -64,6 +107,9 @@ std::ostream& operator<<(std::ostream& os, const QuicConnectionStats& s) {
   os << " address_validated_via_decrypting_packet: "
      << s.address_validated_via_decrypting_packet;
   os << " address_validated_via_token: " << s.address_validated_via_token;
+  os << " ecn_packets_received: " << s.ecn_packets_received;
+  os << " ecn_ce_marks_acked: " << s.ecn_ce_marks_acked;
+  os << " ecn_validation_failed: " << s.ecn_validation_failed;
   os << " }";
 
   return os;
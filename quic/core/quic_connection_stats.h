@@ -6,9 +6,11 @@
 #define QUICHE_QUIC_CORE_QUIC_CONNECTION_STATS_H_
 
 #include <cstdint>
+#include <memory>
 #include <ostream>
 
 #include "quic/core/quic_bandwidth.h"
+#include "quic/core/quic_latency_histogram.h"
 #include "quic/core/quic_packets.h"
 #include "quic/core/quic_time.h"
 #include "quic/core/quic_time_accumulator.h"
@@ -16,6 +18,60 @@
 
 namespace quic {
 
+// Latency distributions for a QuicConnection.  Histograms of different
+// connections can be merged to obtain process-wide distributions.
+struct QUIC_EXPORT_PRIVATE QuicConnectionLatencyHistograms {
+  QUIC_EXPORT_PRIVATE friend std::ostream& operator<<(
+      std::ostream& os,
+      const QuicConnectionLatencyHistograms& h);
+
+  // Adds all samples in |other| to this.
+  void Merge(const QuicConnectionLatencyHistograms& other);
+
+  // Latest RTT sample, recorded on every ACK that updates the RTT.
+  QuicLatencyHistogram rtt;
+  // Peer-reported ack delay of every ACK that updates the RTT.
+  QuicLatencyHistogram ack_delay;
+  // Delay imposed by the pacer each time sending is deferred.
+  QuicLatencyHistogram pacing_delay;
+  // Time from a packet's receipt time, as reported by the packet reader, until
+  // its STREAM frames have been delivered to the session.
+  QuicLatencyHistogram receive_to_delivery_delay;
+  // Time from connection creation until the handshake completes.  At most one
+  // sample per connection.
+  QuicLatencyHistogram handshake_duration;
+};
+
+// Owns the QuicConnectionLatencyHistograms of a connection, which are only
+// allocated by connections which record them.  Unlike a plain
+// std::unique_ptr it is copyable, so that QuicConnectionStats remains
+// copyable; copies own a copy of the histograms.
+class QUIC_EXPORT_PRIVATE QuicConnectionLatencyHistogramsPtr {
+ public:
+  QuicConnectionLatencyHistogramsPtr() = default;
+  QuicConnectionLatencyHistogramsPtr(
+      const QuicConnectionLatencyHistogramsPtr& other);
+  QuicConnectionLatencyHistogramsPtr& operator=(
+      const QuicConnectionLatencyHistogramsPtr& other);
+  QuicConnectionLatencyHistogramsPtr(QuicConnectionLatencyHistogramsPtr&&) =
+      default;
+  QuicConnectionLatencyHistogramsPtr& operator=(
+      QuicConnectionLatencyHistogramsPtr&&) = default;
+
+  // Allocates empty histograms, unless already allocated.
+  void Allocate();
+
+  QuicConnectionLatencyHistograms* get() const { return histograms_.get(); }
+  QuicConnectionLatencyHistograms* operator->() const {
+    return histograms_.get();
+  }
+  QuicConnectionLatencyHistograms& operator*() const { return *histograms_; }
+  explicit operator bool() const { return histograms_ != nullptr; }
+
+ private:
+  std::unique_ptr<QuicConnectionLatencyHistograms> histograms_;
+};
+
 // Structure to hold stats for a QuicConnection.
 struct QUIC_EXPORT_PRIVATE QuicConnectionStats {
   QUIC_EXPORT_PRIVATE friend std::ostream& operator<<(
@@ -220,6 +276,15 @@ struct QUIC_EXPORT_PRIVATE QuicConnectionStats {
   // Number of RETIRE_CONNECTION_ID frames sent.
   size_t num_retire_connection_id_sent = 0;
 
+  // Number of packets received with each ECN-capable codepoint, summed over
+  // all packet number spaces.
+  QuicEcnCounts ecn_packets_received;
+  // Number of sent packets the peer reported as CE-marked.
+  QuicPacketCount ecn_ce_marks_acked = 0;
+  // Whether ECN validation of the path failed, in which case no more packets
+  // are marked ECN-capable.
+  bool ecn_validation_failed = false;
+
   struct QUIC_NO_EXPORT TlsServerOperationStats {
     bool success = false;
     // If the operation is performed asynchronously, how long did it take.
@@ -234,6 +299,10 @@ struct QUIC_EXPORT_PRIVATE QuicConnectionStats {
   absl::optional<TlsServerOperationStats> tls_server_select_cert_stats;
   absl::optional<TlsServerOperationStats> tls_server_compute_signature_stats;
   absl::optional<TlsServerOperationStats> tls_server_decrypt_ticket_stats;
+
+  // Only allocated if quic_record_latency_histograms is true, so that other
+  // connections don't pay for the memory of the histograms.
+  QuicConnectionLatencyHistogramsPtr latency_histograms;
 };
 
 }  // namespace quic
@@ -15223,6 +15223,50 @@ TEST_P(QuicConnectionTest, PingNotSentAt0RTTLevelWhenInitialAvailable) {
   EXPECT_EQ(0x01010101u, writer_->final_bytes_of_last_packet());
 }
 
+TEST_P(QuicConnectionTest, LatencyHistogramsOnlyAllocatedWhenRecorded) {
+  EXPECT_EQ(GetQuicReloadableFlag(quic_record_latency_histograms),
+            static_cast<bool>(connection_.GetStats().latency_histograms));
+
+  SetQuicReloadableFlag(quic_record_latency_histograms, false);
+  TestConnection connection(TestConnectionId(), kSelfAddress, kPeerAddress,
+                            helper_.get(), alarm_factory_.get(), writer_.get(),
+                            Perspective::IS_SERVER, version());
+  EXPECT_FALSE(connection.GetStats().latency_histograms);
+
+  SetQuicReloadableFlag(quic_record_latency_histograms, true);
+  TestConnection recording_connection(
+      TestConnectionId(), kSelfAddress, kPeerAddress, helper_.get(),
+      alarm_factory_.get(), writer_.get(), Perspective::IS_SERVER, version());
+  ASSERT_TRUE(recording_connection.GetStats().latency_histograms);
+  EXPECT_TRUE(
+      recording_connection.GetStats().latency_histograms->rtt.empty());
+}
+
+TEST_P(QuicConnectionTest, MarksOutgoingPacketsWithEcnCodepoint) {
+  // Prevent packets from being coalesced, coalesced packets are never marked.
+  EXPECT_CALL(visitor_, GetHandshakeState())
+      .WillRepeatedly(Return(HANDSHAKE_CONFIRMED));
+  SendStreamDataToPeer(1, "foo", 0, NO_FIN, nullptr);
+  EXPECT_EQ(ECN_NOT_ECT, writer_->last_ecn_sent());
+
+  QuicSentPacketManagerPeer::EnableEcn(
+      QuicConnectionPeer::GetSentPacketManager(&connection_));
+  EXPECT_CALL(*send_algorithm_, GetEcnCodepointToSend())
+      .WillRepeatedly(Return(ECN_ECT1));
+  SendStreamDataToPeer(1, "bar", 3, NO_FIN, nullptr);
+  if (!version().HasIetfQuicFrames()) {
+    // Only IETF QUIC reports ECN counts, so gQUIC packets are never marked.
+    EXPECT_EQ(ECN_NOT_ECT, writer_->last_ecn_sent());
+    return;
+  }
+  EXPECT_EQ(ECN_ECT1, writer_->last_ecn_sent());
+  EXPECT_EQ(ECN_ECT1,
+            QuicConnectionPeer::GetSentPacketManager(&connection_)
+                ->unacked_packets()
+                .GetTransmissionInfo(writer_->header().packet_number)
+                .ecn_codepoint);
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace quic
@@ -8,6 +8,7 @@
 #include "quic/core/quic_session.h"
 #include "quic/core/quic_time.h"
 #include "quic/core/quic_types.h"
+#include "quic/platform/api/quic_bug_tracker.h"
 #include "quic/platform/api/quic_mem_slice_span.h"
 
 namespace quic {
@@ -26,10 +27,16 @@ QuicDatagramQueue::QuicDatagramQueue(QuicSession* session,
       observer_(std::move(observer)) {}
 
 MessageStatus QuicDatagramQueue::SendOrQueueDatagram(QuicMemSlice datagram) {
+  return SendOrQueueDatagram(std::move(datagram), kDefaultFlowId);
+}
+
+MessageStatus QuicDatagramQueue::SendOrQueueDatagram(
+    QuicMemSlice datagram,
+    QuicDatagramStreamId flow_id) {
   // If the queue is non-empty, always queue the daragram.  This ensures that
   // the datagrams are sent in the same order that they were sent by the
-  // application.
-  if (queue_.empty()) {
+  // application, and that the datagrams of more urgent flows go first.
+  if (queue_size_ == 0) {
     QuicMemSliceSpan span(&datagram);
     MessageResult result = session_->SendMessage(span);
     if (result.status != MESSAGE_STATUS_BLOCKED) {
@@ -40,26 +47,60 @@ MessageStatus QuicDatagramQueue::SendOrQueueDatagram(QuicMemSlice datagram) {
     }
   }
 
-  queue_.emplace_back(Datagram{std::move(datagram),
-                               clock_->ApproximateNow() + GetMaxTimeInQueue()});
+  Flow& flow = flows_[flow_id];
+  if (flow.queue.empty()) {
+    active_flows_[flow.urgency].push_back(flow_id);
+  }
+  const QuicTime expiry =
+      clock_->ApproximateNow() + (flow.max_time_in_queue.IsZero()
+                                      ? GetMaxTimeInQueue()
+                                      : flow.max_time_in_queue);
+  flow.queue.emplace_back(Datagram{std::move(datagram), expiry});
+  ++queue_size_;
   return MESSAGE_STATUS_BLOCKED;
 }
 
 absl::optional<MessageStatus> QuicDatagramQueue::TrySendingNextDatagram() {
-  RemoveExpiredDatagrams();
-  if (queue_.empty()) {
-    return absl::nullopt;
-  }
+  for (auto& active_flows : active_flows_) {
+    while (!active_flows.empty()) {
+      const QuicDatagramStreamId flow_id = active_flows.front();
+      auto it = flows_.find(flow_id);
+      QUICHE_DCHECK(it != flows_.end());
+      const size_t num_expired = RemoveExpiredDatagrams(&it->second);
+      const bool drained = it->second.queue.empty();
+      if (drained) {
+        active_flows.pop_front();
+        if (IsUnused(it->second)) {
+          flows_.erase(it);
+        }
+      }
+      if (num_expired > 0 || drained) {
+        // The observer may change the queue, so start over.
+        OnDatagramsDropped(num_expired);
+        continue;
+      }
 
-  QuicMemSliceSpan span(&queue_.front().datagram);
-  MessageResult result = session_->SendMessage(span);
-  if (result.status != MESSAGE_STATUS_BLOCKED) {
-    queue_.pop_front();
-    if (observer_) {
-      observer_->OnDatagramProcessed(result.status);
+      Flow& flow = it->second;
+      QuicMemSliceSpan span(&flow.queue.front().datagram);
+      MessageResult result = session_->SendMessage(span);
+      if (result.status != MESSAGE_STATUS_BLOCKED) {
+        flow.queue.pop_front();
+        --queue_size_;
+        // Let the other flows of the same urgency go next.
+        active_flows.pop_front();
+        if (!flow.queue.empty()) {
+          active_flows.push_back(flow_id);
+        } else if (IsUnused(flow)) {
+          flows_.erase(it);
+        }
+        if (observer_) {
+          observer_->OnDatagramProcessed(result.status);
+        }
+      }
+      return result.status;
     }
   }
-  return result.status;
+  return absl::nullopt;
 }
 
 size_t QuicDatagramQueue::SendDatagrams() {
@@ -88,14 +129,94 @@ QuicTime::Delta QuicDatagramQueue::GetMaxTimeInQueue() const {
                   kMinPacingWindows * kAlarmGranularity);
 }
 
-void QuicDatagramQueue::RemoveExpiredDatagrams() {
+QuicTime::Delta QuicDatagramQueue::GetFlowMaxTimeInQueue(
+    QuicDatagramStreamId flow_id) const {
+  auto it = flows_.find(flow_id);
+  if (it != flows_.end() && !it->second.max_time_in_queue.IsZero()) {
+    return it->second.max_time_in_queue;
+  }
+  return GetMaxTimeInQueue();
+}
+
+void QuicDatagramQueue::SetFlowMaxTimeInQueue(
+    QuicDatagramStreamId flow_id,
+    QuicTime::Delta max_time_in_queue) {
+  auto it = flows_.try_emplace(flow_id).first;
+  it->second.max_time_in_queue = max_time_in_queue;
+  if (IsUnused(it->second)) {
+    flows_.erase(it);
+  }
+}
+
+void QuicDatagramQueue::SetFlowUrgency(QuicDatagramStreamId flow_id,
+                                       int urgency) {
+  if (urgency < 0 || urgency > kMaxUrgency) {
+    QUIC_BUG(quic_bug_12979_1)
+        << "Invalid urgency " << urgency << " for datagram flow " << flow_id;
+    return;
+  }
+  auto it = flows_.try_emplace(flow_id).first;
+  Flow& flow = it->second;
+  if (!flow.queue.empty() && flow.urgency != urgency) {
+    DeactivateFlow(flow_id, flow.urgency);
+    active_flows_[urgency].push_back(flow_id);
+  }
+  flow.urgency = urgency;
+  if (IsUnused(flow)) {
+    flows_.erase(it);
+  }
+}
+
+void QuicDatagramQueue::RemoveFlow(QuicDatagramStreamId flow_id) {
+  auto it = flows_.find(flow_id);
+  if (it == flows_.end()) {
+    return;
+  }
+  const size_t num_dropped = it->second.queue.size();
+  if (num_dropped > 0) {
+    DeactivateFlow(flow_id, it->second.urgency);
+    queue_size_ -= num_dropped;
+  }
+  flows_.erase(it);
+  OnDatagramsDropped(num_dropped);
+}
+
+// static
+bool QuicDatagramQueue::IsUnused(const Flow& flow) {
+  return flow.queue.empty() && flow.urgency == kDefaultUrgency &&
+         flow.max_time_in_queue.IsZero();
+}
+
+size_t QuicDatagramQueue::RemoveExpiredDatagrams(Flow* flow) {
   QuicTime now = clock_->ApproximateNow();
-  while (!queue_.empty() && queue_.front().expiry <= now) {
-    queue_.pop_front();
-    if (observer_) {
-      observer_->OnDatagramProcessed(absl::nullopt);
+  size_t num_expired = 0;
+  while (!flow->queue.empty() && flow->queue.front().expiry <= now) {
+    flow->queue.pop_front();
+    ++num_expired;
+  }
+  queue_size_ -= num_expired;
+  return num_expired;
+}
+
+void QuicDatagramQueue::DeactivateFlow(QuicDatagramStreamId flow_id,
+                                       int urgency) {
+  auto& active_flows = active_flows_[urgency];
+  for (size_t i = active_flows.size(); i > 0; --i) {
+    const QuicDatagramStreamId id = active_flows.front();
+    active_flows.pop_front();
+    if (id != flow_id) {
+      active_flows.push_back(id);
     }
   }
 }
 
+void QuicDatagramQueue::OnDatagramsDropped(size_t count) {
+  if (observer_ == nullptr) {
+    return;
+  }
+  for (size_t i = 0; i < count; ++i) {
+    observer_->OnDatagramProcessed(absl::nullopt);
+  }
+}
+
 }  // namespace quic
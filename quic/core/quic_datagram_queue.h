@@ -5,8 +5,11 @@
 #ifndef QUICHE_QUIC_CORE_QUIC_DATAGRAM_QUEUE_H_
 #define QUICHE_QUIC_CORE_QUIC_DATAGRAM_QUEUE_H_
 
+#include <array>
+#include <limits>
 #include <memory>
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/types/optional.h"
 #include "quic/core/quic_time.h"
 #include "quic/core/quic_types.h"
@@ -20,6 +23,13 @@ class QuicSession;
 // Provides a way to buffer QUIC datagrams (messages) in case they cannot
 // be sent due to congestion control.  Datagrams are buffered for a limited
 // amount of time, and deleted after that time passes.
+//
+// Every datagram belongs to a flow, such as the HTTP/3 stream it is associated
+// with.  Queued datagrams are sent in order of the urgency of their flow, and
+// flows of the same urgency take turns sending one datagram each.  Datagrams
+// of a flow are sent in the order in which they were queued.  Datagrams queued
+// without a flow ID all belong to the same default flow, so a queue which is
+// only used without flow IDs is first-in-first-out.
 class QUIC_EXPORT_PRIVATE QuicDatagramQueue {
  public:
   // An interface used to monitor events on the associated `QuicDatagramQueue`.
@@ -29,25 +39,42 @@ class QUIC_EXPORT_PRIVATE QuicDatagramQueue {
 
     // Called when a datagram in the associated queue is sent or discarded.
     // Identity information for the datagram is not given, because the sending
-    // and discarding order is always first-in-first-out.
+    // and discarding order is always first-in-first-out within a flow.
     // This function is called synchronously in `QuicDatagramQueue` methods.
     // `status` is nullopt when the datagram is dropped due to being in the
-    // queue for too long.
+    // queue for too long, or due to its flow being removed.
     virtual void OnDatagramProcessed(absl::optional<MessageStatus> status) = 0;
   };
 
+  // The flow of datagrams queued without a flow ID.  This is not a valid
+  // variable-length integer, so it does not collide with HTTP/3 stream IDs.
+  static constexpr QuicDatagramStreamId kDefaultFlowId =
+      std::numeric_limits<QuicDatagramStreamId>::max();
+
+  // Flows have urgencies from 0, the most urgent, to kMaxUrgency, like HTTP/3
+  // stream priorities.
+  static constexpr int kDefaultUrgency = 3;
+  static constexpr int kMaxUrgency = 7;
+
   // |session| is not owned and must outlive this object.
   explicit QuicDatagramQueue(QuicSession* session);
 
   // |session| is not owned and must outlive this object.
   QuicDatagramQueue(QuicSession* session, std::unique_ptr<Observer> observer);
 
-  // Adds the datagram to the end of the queue.  May send it immediately; if
-  // not, MESSAGE_STATUS_BLOCKED is returned.
+  // Adds the datagram to the end of the default flow.  May send it
+  // immediately; if not, MESSAGE_STATUS_BLOCKED is returned.
   MessageStatus SendOrQueueDatagram(QuicMemSlice datagram);
 
-  // Attempts to send a single datagram from the queue.  Returns the result of
-  // SendMessage(), or nullopt if there were no unexpired datagrams to send.
+  // Adds the datagram to the end of the flow |flow_id|.  The datagram is only
+  // sent immediately if the queue is empty; if not, MESSAGE_STATUS_BLOCKED is
+  // returned.
+  MessageStatus SendOrQueueDatagram(QuicMemSlice datagram,
+                                    QuicDatagramStreamId flow_id);
+
+  // Attempts to send a single datagram from the most urgent flow which has
+  // one.  Returns the result of SendMessage(), or nullopt if there were no
+  // unexpired datagrams to send.
   absl::optional<MessageStatus> TrySendingNextDatagram();
 
   // Sends all of the unexpired datagrams until either the connection becomes
@@ -59,13 +86,32 @@ class QUIC_EXPORT_PRIVATE QuicDatagramQueue {
   // RTT-based heuristic is used.
   QuicTime::Delta GetMaxTimeInQueue() const;
 
+  // Returns the amount of time a datagram of the flow |flow_id| is allowed to
+  // be in the queue, which is GetMaxTimeInQueue() unless set explicitly using
+  // SetFlowMaxTimeInQueue().
+  QuicTime::Delta GetFlowMaxTimeInQueue(QuicDatagramStreamId flow_id) const;
+
+  // Sets the amount of time a datagram of a flow without its own limit is
+  // allowed to be in the queue.
   void SetMaxTimeInQueue(QuicTime::Delta max_time_in_queue) {
     max_time_in_queue_ = max_time_in_queue;
   }
 
-  size_t queue_size() { return queue_.size(); }
+  // Sets the amount of time datagrams queued from now on in the flow |flow_id|
+  // are allowed to be in the queue.  Zero restores the queue-wide limit.
+  void SetFlowMaxTimeInQueue(QuicDatagramStreamId flow_id,
+                             QuicTime::Delta max_time_in_queue);
+
+  // Sets the urgency of the flow |flow_id|, which must be between 0 and
+  // kMaxUrgency.  Flows have kDefaultUrgency unless set.
+  void SetFlowUrgency(QuicDatagramStreamId flow_id, int urgency);
+
+  // Drops the queued datagrams of the flow |flow_id| and forgets its settings.
+  void RemoveFlow(QuicDatagramStreamId flow_id);
 
-  bool empty() { return queue_.empty(); }
+  size_t queue_size() { return queue_size_; }
+
+  bool empty() { return queue_size_ == 0; }
 
  private:
   struct QUIC_EXPORT_PRIVATE Datagram {
@@ -73,14 +119,39 @@ class QUIC_EXPORT_PRIVATE QuicDatagramQueue {
     QuicTime expiry;
   };
 
-  // Removes expired datagrams from the front of the queue.
-  void RemoveExpiredDatagrams();
+  struct QUIC_EXPORT_PRIVATE Flow {
+    int urgency = kDefaultUrgency;
+    QuicTime::Delta max_time_in_queue = QuicTime::Delta::Zero();
+    quiche::QuicheCircularDeque<Datagram> queue;
+  };
+
+  // Returns whether |flow| has no queued datagrams or settings to remember.
+  static bool IsUnused(const Flow& flow);
+
+  // Removes expired datagrams from the front of |flow|, and returns how many
+  // were removed.
+  size_t RemoveExpiredDatagrams(Flow* flow);
+
+  // Removes |flow_id| from the list of flows with queued datagrams of
+  // |urgency|.
+  void DeactivateFlow(QuicDatagramStreamId flow_id, int urgency);
+
+  // Notifies the observer, if any, of |count| dropped datagrams.
+  void OnDatagramsDropped(size_t count);
 
   QuicSession* session_;  // Not owned.
   const QuicClock* clock_;
 
   QuicTime::Delta max_time_in_queue_ = QuicTime::Delta::Zero();
-  quiche::QuicheCircularDeque<Datagram> queue_;
+  // Flows which have queued datagrams or non-default settings.
+  absl::flat_hash_map<QuicDatagramStreamId, Flow> flows_;
+  // The IDs of the flows with queued datagrams, by urgency, in the order in
+  // which they take turns.
+  std::array<quiche::QuicheCircularDeque<QuicDatagramStreamId>,
+             kMaxUrgency + 1>
+      active_flows_;
+  // The total number of queued datagrams.
+  size_t queue_size_ = 0;
   std::unique_ptr<Observer> observer_;
 };
 
@@ -4,6 +4,7 @@
 
 #include "quic/core/quic_datagram_queue.h"
 
+#include <string>
 #include <vector>
 
 #include "absl/strings/string_view.h"
@@ -12,6 +13,7 @@
 #include "quic/core/quic_buffer_allocator.h"
 #include "quic/core/quic_time.h"
 #include "quic/core/quic_types.h"
+#include "quic/platform/api/quic_expect_bug.h"
 #include "quic/platform/api/quic_mem_slice.h"
 #include "quic/platform/api/quic_reference_counted.h"
 #include "quic/platform/api/quic_test.h"
@@ -199,6 +201,118 @@ TEST_F(QuicDatagramQueueTest, ExpireAll) {
   EXPECT_EQ(0u, queue_.SendDatagrams());
 }
 
+TEST_F(QuicDatagramQueueTest, UrgentFlowsGoFirst) {
+  EXPECT_CALL(*connection_, SendMessage(_, _, _))
+      .WillOnce(Return(MESSAGE_STATUS_BLOCKED));
+  queue_.SetFlowUrgency(4, 0);
+  queue_.SendOrQueueDatagram(CreateMemSlice("a"));
+  queue_.SendOrQueueDatagram(CreateMemSlice("b"), 8);
+  queue_.SendOrQueueDatagram(CreateMemSlice("c"), 4);
+  queue_.SendOrQueueDatagram(CreateMemSlice("d"), 4);
+  EXPECT_EQ(4u, queue_.queue_size());
+
+  std::vector<std::string> messages;
+  EXPECT_CALL(*connection_, SendMessage(_, _, _))
+      .WillRepeatedly([&messages](QuicMessageId /*id*/,
+                                  QuicMemSliceSpan message, bool /*flush*/) {
+        messages.push_back(std::string(message.GetData(0)));
+        return MESSAGE_STATUS_SUCCESS;
+      });
+  EXPECT_EQ(4u, queue_.SendDatagrams());
+  // Flow 4 is the most urgent one, the default flow and flow 8 have the
+  // default urgency.
+  EXPECT_THAT(messages, ElementsAre("c", "d", "a", "b"));
+  EXPECT_TRUE(queue_.empty());
+}
+
+TEST_F(QuicDatagramQueueTest, FlowsTakeTurns) {
+  EXPECT_CALL(*connection_, SendMessage(_, _, _))
+      .WillOnce(Return(MESSAGE_STATUS_BLOCKED));
+  queue_.SendOrQueueDatagram(CreateMemSlice("a1"), 0);
+  queue_.SendOrQueueDatagram(CreateMemSlice("a2"), 0);
+  queue_.SendOrQueueDatagram(CreateMemSlice("a3"), 0);
+  queue_.SendOrQueueDatagram(CreateMemSlice("b1"), 4);
+  queue_.SendOrQueueDatagram(CreateMemSlice("c1"), 8);
+  queue_.SendOrQueueDatagram(CreateMemSlice("c2"), 8);
+
+  std::vector<std::string> messages;
+  EXPECT_CALL(*connection_, SendMessage(_, _, _))
+      .WillRepeatedly([&messages](QuicMessageId /*id*/,
+                                  QuicMemSliceSpan message, bool /*flush*/) {
+        messages.push_back(std::string(message.GetData(0)));
+        return MESSAGE_STATUS_SUCCESS;
+      });
+  EXPECT_EQ(6u, queue_.SendDatagrams());
+  EXPECT_THAT(messages, ElementsAre("a1", "b1", "c1", "a2", "c2", "a3"));
+}
+
+TEST_F(QuicDatagramQueueTest, ChangeUrgencyOfQueuedFlow) {
+  EXPECT_CALL(*connection_, SendMessage(_, _, _))
+      .WillOnce(Return(MESSAGE_STATUS_BLOCKED));
+  queue_.SendOrQueueDatagram(CreateMemSlice("a"), 0);
+  queue_.SendOrQueueDatagram(CreateMemSlice("b"), 4);
+  queue_.SetFlowUrgency(0, 5);
+
+  std::vector<std::string> messages;
+  EXPECT_CALL(*connection_, SendMessage(_, _, _))
+      .WillRepeatedly([&messages](QuicMessageId /*id*/,
+                                  QuicMemSliceSpan message, bool /*flush*/) {
+        messages.push_back(std::string(message.GetData(0)));
+        return MESSAGE_STATUS_SUCCESS;
+      });
+  EXPECT_EQ(2u, queue_.SendDatagrams());
+  EXPECT_THAT(messages, ElementsAre("b", "a"));
+}
+
+TEST_F(QuicDatagramQueueTest, InvalidUrgency) {
+  EXPECT_QUIC_BUG(queue_.SetFlowUrgency(0, QuicDatagramQueue::kMaxUrgency + 1),
+                  "Invalid urgency");
+}
+
+TEST_F(QuicDatagramQueueTest, PerFlowExpiry) {
+  constexpr QuicTime::Delta expiry = QuicTime::Delta::FromMilliseconds(100);
+  queue_.SetMaxTimeInQueue(expiry);
+  queue_.SetFlowMaxTimeInQueue(4, 3 * expiry);
+  EXPECT_EQ(expiry, queue_.GetFlowMaxTimeInQueue(0));
+  EXPECT_EQ(3 * expiry, queue_.GetFlowMaxTimeInQueue(4));
+
+  EXPECT_CALL(*connection_, SendMessage(_, _, _))
+      .WillOnce(Return(MESSAGE_STATUS_BLOCKED));
+  queue_.SendOrQueueDatagram(CreateMemSlice("a"), 0);
+  queue_.SendOrQueueDatagram(CreateMemSlice("b"), 4);
+  helper_.AdvanceTime(2 * expiry);
+
+  std::vector<std::string> messages;
+  EXPECT_CALL(*connection_, SendMessage(_, _, _))
+      .WillRepeatedly([&messages](QuicMessageId /*id*/,
+                                  QuicMemSliceSpan message, bool /*flush*/) {
+        messages.push_back(std::string(message.GetData(0)));
+        return MESSAGE_STATUS_SUCCESS;
+      });
+  EXPECT_EQ(1u, queue_.SendDatagrams());
+  EXPECT_THAT(messages, ElementsAre("b"));
+  EXPECT_TRUE(queue_.empty());
+
+  // Zero restores the queue-wide limit.
+  queue_.SetFlowMaxTimeInQueue(4, QuicTime::Delta::Zero());
+  EXPECT_EQ(expiry, queue_.GetFlowMaxTimeInQueue(4));
+}
+
+TEST_F(QuicDatagramQueueTest, RemoveFlow) {
+  EXPECT_CALL(*connection_, SendMessage(_, _, _))
+      .WillOnce(Return(MESSAGE_STATUS_BLOCKED));
+  queue_.SendOrQueueDatagram(CreateMemSlice("a"), 0);
+  queue_.SendOrQueueDatagram(CreateMemSlice("b"), 4);
+  queue_.SendOrQueueDatagram(CreateMemSlice("c"), 4);
+  queue_.RemoveFlow(4);
+  EXPECT_EQ(1u, queue_.queue_size());
+
+  EXPECT_CALL(*connection_, SendMessage(_, _, _))
+      .WillOnce(Return(MESSAGE_STATUS_SUCCESS));
+  EXPECT_EQ(1u, queue_.SendDatagrams());
+  EXPECT_TRUE(queue_.empty());
+}
+
 class QuicDatagramQueueWithObserverTest : public QuicDatagramQueueTestBase {
  public:
   QuicDatagramQueueWithObserverTest()
@@ -292,6 +406,18 @@ TEST_F(QuicDatagramQueueWithObserverTest, ObserveExpiry) {
   EXPECT_THAT(context_->statuses, ElementsAre(absl::nullopt));
 }
 
+TEST_F(QuicDatagramQueueWithObserverTest, ObserveRemovedFlow) {
+  EXPECT_CALL(*connection_, SendMessage(_, _, _))
+      .WillOnce(Return(MESSAGE_STATUS_BLOCKED));
+  queue_.SendOrQueueDatagram(CreateMemSlice("a"), 4);
+  queue_.SendOrQueueDatagram(CreateMemSlice("b"), 4);
+  EXPECT_TRUE(context_->statuses.empty());
+
+  queue_.RemoveFlow(4);
+  EXPECT_THAT(context_->statuses, ElementsAre(absl::nullopt, absl::nullopt));
+  EXPECT_TRUE(queue_.empty());
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace quic
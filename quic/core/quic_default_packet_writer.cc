@@ -20,11 +20,14 @@ WriteResult QuicDefaultPacketWriter::WritePacket(
     const QuicSocketAddress& peer_address,
     PerPacketOptions* options) {
   QUICHE_DCHECK(!write_blocked_);
-  QUICHE_DCHECK(nullptr == options)
-      << "QuicDefaultPacketWriter does not accept any options.";
+  QUICHE_DCHECK(nullptr == options || options->release_time_delay.IsZero())
+      << "QuicDefaultPacketWriter does not support release time.";
   QuicUdpPacketInfo packet_info;
   packet_info.SetPeerAddress(peer_address);
   packet_info.SetSelfIp(self_address);
+  if (options != nullptr && options->ecn_codepoint != ECN_NOT_ECT) {
+    packet_info.SetEcnCodepoint(options->ecn_codepoint);
+  }
   WriteResult result =
       QuicUdpSocketApi().WritePacket(fd_, buffer, buf_len, packet_info);
   if (IsWriteBlockedStatus(result.status)) {
@@ -12,7 +12,9 @@
 #include "absl/strings/string_view.h"
 #include "quic/core/chlo_extractor.h"
 #include "quic/core/crypto/crypto_protocol.h"
+#include "quic/core/crypto/quic_crypto_server_config.h"
 #include "quic/core/crypto/quic_random.h"
+#include "quic/core/proto/source_address_token_proto.h"
 #include "quic/core/quic_connection_id.h"
 #include "quic/core/quic_error_codes.h"
 #include "quic/core/quic_session.h"
@@ -322,12 +324,14 @@ QuicDispatcher::QuicDispatcher(
       crypto_config_(crypto_config),
       compressed_certs_cache_(
           QuicCompressedCertsCache::kQuicCompressedCertsCacheSize),
+      network_params_cache_(nullptr),
       helper_(std::move(helper)),
       session_helper_(std::move(session_helper)),
       alarm_factory_(std::move(alarm_factory)),
       delete_sessions_alarm_(
           alarm_factory_->CreateAlarm(new DeleteSessionsAlarm(this))),
       buffered_packets_(this, helper_->GetClock(), alarm_factory_.get()),
+      admission_controller_(helper_->GetClock()),
       version_manager_(version_manager),
       last_error_(QUIC_NO_ERROR),
       new_sessions_allowed_per_event_loop_(0u),
@@ -363,17 +367,21 @@ void QuicDispatcher::ProcessPacket(const QuicSocketAddress& self_address,
                 << " bytes:" << std::endl
                 << quiche::QuicheTextUtils::HexDump(
                        absl::string_view(packet.data(), packet.length()));
+  if (GetQuicReloadableFlag(quic_dispatcher_short_header_fast_path) &&
+      TryDispatchShortHeaderPacket(self_address, peer_address, packet)) {
+    QUIC_RELOADABLE_FLAG_COUNT(quic_dispatcher_short_header_fast_path);
+    return;
+  }
   ReceivedPacketInfo packet_info(self_address, peer_address, packet);
   std::string detailed_error;
   bool retry_token_present;
-  absl::string_view retry_token;
   const QuicErrorCode error = QuicFramer::ParsePublicHeaderDispatcher(
       packet, expected_server_connection_id_length_, &packet_info.form,
       &packet_info.long_packet_type, &packet_info.version_flag,
       &packet_info.use_length_prefix, &packet_info.version_label,
       &packet_info.version, &packet_info.destination_connection_id,
-      &packet_info.source_connection_id, &retry_token_present, &retry_token,
-      &detailed_error);
+      &packet_info.source_connection_id, &retry_token_present,
+      &packet_info.retry_token, &detailed_error);
   if (error != QUIC_NO_ERROR) {
     // Packet has framing error.
     SetLastError(error);
@@ -421,6 +429,33 @@ void QuicDispatcher::ProcessPacket(const QuicSocketAddress& self_address,
   ProcessHeader(&packet_info);
 }
 
+bool QuicDispatcher::TryDispatchShortHeaderPacket(
+    const QuicSocketAddress& self_address,
+    const QuicSocketAddress& peer_address,
+    const QuicReceivedPacket& packet) {
+  // Packets from port zero are dropped by MaybeDispatchPacket(), and the
+  // expected connection ID length may still change with every packet.
+  if (peer_address.port() == 0 ||
+      should_update_expected_server_connection_id_length_) {
+    return false;
+  }
+  QuicConnectionId server_connection_id;
+  if (!QuicFramer::ParseShortHeaderDestinationConnectionId(
+          packet, expected_server_connection_id_length_,
+          &server_connection_id)) {
+    return false;
+  }
+  // Short headers carry no version, so this is what MaybeDispatchPacket()
+  // does for the packets of known sessions.
+  auto it = reference_counted_session_map_.find(server_connection_id);
+  if (it == reference_counted_session_map_.end()) {
+    return false;
+  }
+  QUICHE_DCHECK(!buffered_packets_.HasBufferedPackets(server_connection_id));
+  it->second->ProcessUdpPacket(self_address, peer_address, packet);
+  return true;
+}
+
 QuicConnectionId QuicDispatcher::MaybeReplaceServerConnectionId(
     const QuicConnectionId& server_connection_id,
     const ParsedQuicVersion& version) const {
@@ -1197,9 +1232,18 @@ void QuicDispatcher::ProcessBufferedChlos(size_t max_connections_to_create) {
       ++num_sessions_in_session_map_;
     }
     DeliverPacketsToSession(packets, insertion_result.first->second.get());
+    admission_controller_.OnChloAdmitted();
   }
 }
 
+void QuicDispatcher::OnEventLoopIterationStart() {
+  admission_controller_.OnIterationStart();
+}
+
+void QuicDispatcher::OnEventLoopIterationEnd() {
+  admission_controller_.OnIterationEnd(buffered_packets_.NumChlosBuffered());
+}
+
 bool QuicDispatcher::HasChlosBuffered() const {
   return buffered_packets_.HasChlosBuffered();
 }
@@ -1254,8 +1298,24 @@ void QuicDispatcher::ProcessChlo(const std::vector<std::string>& alpns,
       !ShouldCreateOrBufferPacketForConnection(*packet_info)) {
     return;
   }
-  if (GetQuicFlag(FLAGS_quic_allow_chlo_buffering) &&
-      new_sessions_allowed_per_event_loop_ <= 0) {
+  const bool must_buffer = GetQuicFlag(FLAGS_quic_allow_chlo_buffering) &&
+                           new_sessions_allowed_per_event_loop_ <= 0;
+  bool prioritized = false;
+  if (GetQuicReloadableFlag(quic_dispatcher_handshake_admission_control)) {
+    QUIC_RELOADABLE_FLAG_COUNT(quic_dispatcher_handshake_admission_control);
+    const bool overloaded = admission_controller_.IsOverloaded(
+        buffered_packets_.NumChlosBuffered());
+    // Only look closer at CHLOs which can't be processed right away.
+    if (overloaded || must_buffer) {
+      prioritized = ShouldPrioritizeChlo(*packet_info);
+    }
+    if (overloaded && !prioritized) {
+      admission_controller_.OnChloRejected();
+      RejectChloUnderOverload(*packet_info);
+      return;
+    }
+  }
+  if (must_buffer) {
     // Can't create new session any more. Wait till next event loop.
     QUIC_BUG_IF(quic_bug_12724_7, buffered_packets_.HasChloForConnection(
                                       packet_info->destination_connection_id));
@@ -1266,6 +1326,10 @@ void QuicDispatcher::ProcessChlo(const std::vector<std::string>& alpns,
         /*is_chlo=*/true, alpns, sni, packet_info->version);
     if (rs != EnqueuePacketResult::SUCCESS) {
       OnBufferPacketFailure(rs, packet_info->destination_connection_id);
+    } else if (prioritized) {
+      buffered_packets_.PrioritizeConnection(
+          packet_info->destination_connection_id);
+      admission_controller_.OnChloPrioritized();
     }
     return;
   }
@@ -1318,6 +1382,45 @@ void QuicDispatcher::ProcessChlo(const std::vector<std::string>& alpns,
   // buffered in the store before flag is turned off.
   DeliverPacketsToSession(packets, session_ptr);
   --new_sessions_allowed_per_event_loop_;
+  admission_controller_.OnChloAdmitted();
+}
+
+bool QuicDispatcher::ShouldPrioritizeChlo(
+    const ReceivedPacketInfo& packet_info) {
+  // Only a source address token proves that the client owns its address, it
+  // was sent in a NEW_TOKEN frame or a Retry packet.  Resumption and early
+  // data are not considered: anyone can put a pre_shared_key or early_data
+  // extension into a CHLO, and the ticket is not decrypted until a session
+  // has been created.
+  if (packet_info.retry_token.empty()) {
+    return false;
+  }
+  SourceAddressTokens tokens;
+  if (crypto_config()->ParseSourceAddressToken(
+          crypto_config()->source_address_token_boxer(),
+          packet_info.retry_token, &tokens) != HANDSHAKE_OK) {
+    return false;
+  }
+  return crypto_config()->ValidateSourceAddressTokens(
+             tokens, packet_info.peer_address.host(),
+             helper_->GetClock()->WallNow(),
+             /*cached_network_params=*/nullptr) == HANDSHAKE_OK;
+}
+
+void QuicDispatcher::RejectChloUnderOverload(
+    const ReceivedPacketInfo& packet_info) {
+  QUIC_CODE_COUNT(quic_reject_chlo_under_overload);
+  const QuicConnectionId server_connection_id =
+      packet_info.destination_connection_id;
+  StatelesslyTerminateConnection(
+      server_connection_id, packet_info.form, packet_info.version_flag,
+      packet_info.use_length_prefix, packet_info.version, QUIC_HANDSHAKE_FAILED,
+      "Server overloaded",
+      quic::QuicTimeWaitListManager::SEND_STATELESS_RESET);
+  time_wait_list_manager_->ProcessPacket(
+      packet_info.self_address, packet_info.peer_address, server_connection_id,
+      packet_info.form, packet_info.packet.length(), GetPerPacketContext());
+  buffered_packets_.DiscardPackets(server_connection_id);
 }
 
 bool QuicDispatcher::ShouldDestroySessionAsynchronously() {
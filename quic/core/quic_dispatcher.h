@@ -22,6 +22,8 @@
 #include "quic/core/quic_connection.h"
 #include "quic/core/quic_connection_id.h"
 #include "quic/core/quic_crypto_server_stream_base.h"
+#include "quic/core/quic_handshake_admission_controller.h"
+#include "quic/core/quic_network_params_cache.h"
 #include "quic/core/quic_packets.h"
 #include "quic/core/quic_process_packet_interface.h"
 #include "quic/core/quic_session.h"
@@ -146,8 +148,14 @@ class QUIC_NO_EXPORT QuicDispatcher
                             early_arrived_packets) override;
 
   // Create connections for previously buffered CHLOs as many as allowed.
+  // Prioritized CHLOs, see ShouldPrioritizeChlo(), are processed first.
   virtual void ProcessBufferedChlos(size_t max_connections_to_create);
 
+  // Called when the event loop starts and finishes processing a socket event,
+  // to let the admission controller measure how loaded the event loop is.
+  void OnEventLoopIterationStart();
+  void OnEventLoopIterationEnd();
+
   // Return true if there is CHLO buffered.
   virtual bool HasChlosBuffered() const;
 
@@ -171,6 +179,23 @@ class QUIC_NO_EXPORT QuicDispatcher
     return support_multiple_cid_per_connection_;
   }
 
+  // Decides whether new handshakes are admitted when
+  // quic_dispatcher_handshake_admission_control is enabled, and counts the
+  // decisions.
+  const QuicHandshakeAdmissionController& admission_controller() const {
+    return admission_controller_;
+  }
+  QuicHandshakeAdmissionController* mutable_admission_controller() {
+    return &admission_controller_;
+  }
+
+  // Sets the cache of network parameters per client prefix which sessions
+  // created by this dispatcher should use, if any.  |cache| is not owned, may
+  // be shared by several dispatchers, and must outlive this dispatcher.
+  void set_network_params_cache(QuicNetworkParamsCache* cache) {
+    network_params_cache_ = cache;
+  }
+
  protected:
   virtual std::unique_ptr<QuicSession> CreateQuicSession(
       QuicConnectionId server_connection_id,
@@ -184,6 +209,8 @@ class QUIC_NO_EXPORT QuicDispatcher
   // Returns true if packet is dropped or successfully dispatched (e.g.,
   // processed by existing session, processed by time wait list, etc.),
   // otherwise, returns false and the packet needs further processing.
+  // Short header packets of known sessions may be dispatched without calling
+  // this, see TryDispatchShortHeaderPacket().
   virtual bool MaybeDispatchPacket(const ReceivedPacketInfo& packet_info);
 
   // Generate a connection ID with a length that is expected by the dispatcher.
@@ -249,11 +276,24 @@ class QUIC_NO_EXPORT QuicDispatcher
   void BufferEarlyPacket(const ReceivedPacketInfo& packet_info);
 
   // Called when |packet_info| is a CHLO packet. Creates a new connection and
-  // delivers any buffered packets for that connection id.
+  // delivers any buffered packets for that connection id.  If the event loop
+  // is overloaded, the CHLO is rejected instead unless it is prioritized.
   void ProcessChlo(const std::vector<std::string>& alpns,
                    absl::string_view sni,
                    ReceivedPacketInfo* packet_info);
 
+  // Returns true if the CHLO in |packet_info| should be admitted while the
+  // event loop is overloaded, and buffered ahead of other CHLOs.  By default,
+  // these are CHLOs with an address token which is valid for the peer
+  // address.  Overrides must only rely on what the CHLO proves: resumption
+  // and early data attempts are unauthenticated at this point.
+  virtual bool ShouldPrioritizeChlo(const ReceivedPacketInfo& packet_info);
+
+  // Called instead of creating or buffering a session for the CHLO in
+  // |packet_info| when the event loop is overloaded.  By default, the
+  // connection is statelessly closed.
+  virtual void RejectChloUnderOverload(const ReceivedPacketInfo& packet_info);
+
   // Return true if dispatcher wants to destroy session outside of
   // OnConnectionClosed() call stack.
   virtual bool ShouldDestroySessionAsynchronously();
@@ -274,6 +314,10 @@ class QUIC_NO_EXPORT QuicDispatcher
     return &compressed_certs_cache_;
   }
 
+  QuicNetworkParamsCache* network_params_cache() {
+    return network_params_cache_;
+  }
+
   QuicConnectionHelperInterface* helper() { return helper_.get(); }
 
   QuicCryptoServerStreamBase::Helper* session_helper() {
@@ -295,6 +339,14 @@ class QUIC_NO_EXPORT QuicDispatcher
 
   void SetLastError(QuicErrorCode error);
 
+  // Dispatches |packet| to its session if it has a short header and the
+  // connection ID of a known session, without parsing the rest of its public
+  // header.  Returns false if the packet needs the full processing of
+  // ProcessPacket().
+  bool TryDispatchShortHeaderPacket(const QuicSocketAddress& self_address,
+                                    const QuicSocketAddress& peer_address,
+                                    const QuicReceivedPacket& packet);
+
   // Called by MaybeDispatchPacket when current packet cannot be dispatched.
   // Used by subclasses to conduct specific logic to dispatch packet. Returns
   // true if packet is successfully dispatched.
@@ -417,6 +469,9 @@ class QUIC_NO_EXPORT QuicDispatcher
   // The cache for most recently compressed certs.
   QuicCompressedCertsCache compressed_certs_cache_;
 
+  // Not owned.  May be nullptr.
+  QuicNetworkParamsCache* network_params_cache_;
+
   // The list of connections waiting to write.
   WriteBlockedList write_blocked_list_;
 
@@ -449,6 +504,8 @@ class QUIC_NO_EXPORT QuicDispatcher
   // them.
   QuicBufferedPacketStore buffered_packets_;
 
+  QuicHandshakeAdmissionController admission_controller_;
+
   // Used to get the supported versions based on flag. Does not own.
   QuicVersionManager* version_manager_;
 
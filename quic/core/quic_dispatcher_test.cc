@@ -17,6 +17,7 @@
 #include "quic/core/crypto/quic_crypto_server_config.h"
 #include "quic/core/crypto/quic_random.h"
 #include "quic/core/frames/quic_new_connection_id_frame.h"
+#include "quic/core/proto/source_address_token_proto.h"
 #include "quic/core/quic_config.h"
 #include "quic/core/quic_connection.h"
 #include "quic/core/quic_connection_id.h"
@@ -148,6 +149,15 @@ class TestDispatcher : public QuicDispatcher {
               (const ReceivedPacketInfo& packet_info),
               (override));
 
+  MOCK_METHOD(bool,
+              ShouldPrioritizeChlo,
+              (const ReceivedPacketInfo& packet_info),
+              (override));
+
+  bool DefaultShouldPrioritizeChlo(const ReceivedPacketInfo& packet_info) {
+    return QuicDispatcher::ShouldPrioritizeChlo(packet_info);
+  }
+
   struct TestQuicPerPacketContext : public QuicPerPacketContext {
     std::string custom_packet_context;
   };
@@ -1069,6 +1079,55 @@ TEST_P(QuicDispatcherTestAllVersions, MixGoodAndBadConnectionIdLengthPackets) {
   ProcessPacket(client_address, TestConnectionId(1), false, "data");
 }
 
+TEST_P(QuicDispatcherTestAllVersions, ShortHeaderPacketsWithoutFastPath) {
+  SetQuicReloadableFlag(quic_dispatcher_short_header_fast_path, false);
+  QuicSocketAddress client_address(QuicIpAddress::Loopback4(), 1);
+
+  EXPECT_CALL(*dispatcher_,
+              CreateQuicSession(TestConnectionId(1), _, client_address,
+                                Eq(ExpectedAlpn()), _, _))
+      .WillOnce(Return(ByMove(CreateSession(
+          dispatcher_.get(), config_, TestConnectionId(1), client_address,
+          &mock_helper_, &mock_alarm_factory_, &crypto_config_,
+          QuicDispatcherPeer::GetCache(dispatcher_.get()), &session1_))));
+  EXPECT_CALL(*reinterpret_cast<MockQuicConnection*>(session1_->connection()),
+              ProcessUdpPacket(_, _, _))
+      .Times(2)
+      .WillRepeatedly(
+          WithArg<2>(Invoke([this](const QuicEncryptedPacket& packet) {
+            ValidatePacket(TestConnectionId(1), packet);
+          })));
+  EXPECT_CALL(*dispatcher_,
+              ShouldCreateOrBufferPacketForConnection(
+                  ReceivedPacketInfoConnectionIdEquals(TestConnectionId(1))));
+  ProcessFirstFlight(client_address, TestConnectionId(1));
+  ProcessPacket(client_address, TestConnectionId(1), false, "data");
+}
+
+TEST_P(QuicDispatcherTestAllVersions, ShortHeaderPacketFromPortZero) {
+  QuicSocketAddress client_address(QuicIpAddress::Loopback4(), 1);
+
+  EXPECT_CALL(*dispatcher_,
+              CreateQuicSession(TestConnectionId(1), _, client_address,
+                                Eq(ExpectedAlpn()), _, _))
+      .WillOnce(Return(ByMove(CreateSession(
+          dispatcher_.get(), config_, TestConnectionId(1), client_address,
+          &mock_helper_, &mock_alarm_factory_, &crypto_config_,
+          QuicDispatcherPeer::GetCache(dispatcher_.get()), &session1_))));
+  // Only the first flight is processed, the packet from port zero is dropped.
+  EXPECT_CALL(*reinterpret_cast<MockQuicConnection*>(session1_->connection()),
+              ProcessUdpPacket(_, _, _))
+      .WillOnce(WithArg<2>(Invoke([this](const QuicEncryptedPacket& packet) {
+        ValidatePacket(TestConnectionId(1), packet);
+      })));
+  EXPECT_CALL(*dispatcher_,
+              ShouldCreateOrBufferPacketForConnection(
+                  ReceivedPacketInfoConnectionIdEquals(TestConnectionId(1))));
+  ProcessFirstFlight(client_address, TestConnectionId(1));
+  ProcessPacket(QuicSocketAddress(QuicIpAddress::Loopback4(), 0),
+                TestConnectionId(1), false, "data");
+}
+
 TEST_P(QuicDispatcherTestAllVersions, ProcessPacketWithZeroPort) {
   CreateTimeWaitListManager();
 
@@ -2736,6 +2795,163 @@ TEST_P(BufferedPacketStoreTest, ProcessBufferedChloWithDifferentVersion) {
   dispatcher_->ProcessBufferedChlos(kMaxNumSessionsToCreate);
 }
 
+class HandshakeAdmissionControlTest : public BufferedPacketStoreTest {
+ public:
+  void SetUp() override {
+    BufferedPacketStoreTest::SetUp();
+    SetQuicReloadableFlag(quic_dispatcher_handshake_admission_control, true);
+  }
+
+  // Expects a session to be created for |conn_id|, and all its buffered
+  // packets to be delivered to it.
+  void ExpectSessionCreated(QuicConnectionId conn_id) {
+    EXPECT_CALL(*dispatcher_,
+                CreateQuicSession(conn_id, _, client_addr_, _, _, _))
+        .WillOnce(Return(ByMove(CreateSession(
+            dispatcher_.get(), config_, conn_id, client_addr_, &mock_helper_,
+            &mock_alarm_factory_, &crypto_config_,
+            QuicDispatcherPeer::GetCache(dispatcher_.get()), &session1_))));
+    EXPECT_CALL(*reinterpret_cast<MockQuicConnection*>(session1_->connection()),
+                ProcessUdpPacket(_, _, _))
+        .Times(testing::AtLeast(1));
+  }
+
+  MockQuicConnectionHelper* dispatcher_helper() {
+    return static_cast<MockQuicConnectionHelper*>(
+        QuicDispatcherPeer::GetHelper(dispatcher_.get()));
+  }
+
+  bool IsInTimeWait(QuicConnectionId conn_id) {
+    return QuicDispatcherPeer::GetTimeWaitListManager(dispatcher_.get())
+        ->IsConnectionIdInTimeWait(conn_id);
+  }
+};
+
+INSTANTIATE_TEST_SUITE_P(HandshakeAdmissionControlTests,
+                         HandshakeAdmissionControlTest,
+                         ::testing::ValuesIn(CurrentSupportedVersions()),
+                         ::testing::PrintToStringParamName());
+
+// Floods the dispatcher with CHLOs.  Once the sessions allowed per event loop
+// are used up and the backlog of buffered CHLOs is too large, CHLOs are
+// rejected, except for prioritized ones, which are also processed first.
+TEST_P(HandshakeAdmissionControlTest, ChloFlood) {
+  const size_t kMaxBufferedChlos = 4;
+  dispatcher_->mutable_admission_controller()->set_max_buffered_chlos(
+      kMaxBufferedChlos);
+  const uint64_t kNumChlos = kMaxNumSessionsToCreate + 20;
+  const QuicConnectionId prioritized_id = TestConnectionId(kNumChlos - 1);
+  ON_CALL(*dispatcher_,
+          ShouldPrioritizeChlo(
+              ReceivedPacketInfoConnectionIdEquals(prioritized_id)))
+      .WillByDefault(Return(true));
+  QuicBufferedPacketStore* store =
+      QuicDispatcherPeer::GetBufferedPackets(dispatcher_.get());
+
+  for (uint64_t conn_id = 1; conn_id <= kNumChlos; ++conn_id) {
+    if (conn_id <= kMaxNumSessionsToCreate) {
+      ExpectSessionCreated(TestConnectionId(conn_id));
+    }
+    ProcessFirstFlight(TestConnectionId(conn_id));
+  }
+
+  // The first CHLOs create sessions right away, the next ones are buffered
+  // until the backlog is too large, and the remaining ones are rejected.
+  const uint64_t last_buffered_id =
+      kMaxNumSessionsToCreate + kMaxBufferedChlos + 1;
+  for (uint64_t conn_id = kMaxNumSessionsToCreate + 1; conn_id <= kNumChlos;
+       ++conn_id) {
+    const QuicConnectionId connection_id = TestConnectionId(conn_id);
+    const bool buffered =
+        conn_id <= last_buffered_id || connection_id == prioritized_id;
+    EXPECT_EQ(buffered, store->HasChloForConnection(connection_id)) << conn_id;
+    EXPECT_EQ(!buffered, IsInTimeWait(connection_id)) << conn_id;
+  }
+  const QuicHandshakeAdmissionController::Stats& stats =
+      dispatcher_->admission_controller().stats();
+  EXPECT_EQ(static_cast<uint64_t>(kMaxNumSessionsToCreate),
+            stats.chlos_admitted);
+  EXPECT_EQ(1u, stats.chlos_prioritized);
+  EXPECT_EQ(kNumChlos - last_buffered_id - 1, stats.chlos_rejected);
+
+  // The prioritized CHLO creates its session first.
+  {
+    InSequence s;
+    ExpectSessionCreated(prioritized_id);
+    for (uint64_t conn_id = kMaxNumSessionsToCreate + 1;
+         conn_id <= last_buffered_id; ++conn_id) {
+      ExpectSessionCreated(TestConnectionId(conn_id));
+    }
+  }
+  dispatcher_->ProcessBufferedChlos(kMaxNumSessionsToCreate);
+  EXPECT_FALSE(store->HasChlosBuffered());
+  EXPECT_EQ(static_cast<uint64_t>(kMaxNumSessionsToCreate) + kMaxBufferedChlos +
+                2,
+            stats.chlos_admitted);
+}
+
+// A slow event loop rejects new handshakes even if sessions could be created.
+TEST_P(HandshakeAdmissionControlTest, SlowEventLoop) {
+  dispatcher_->mutable_admission_controller()->set_max_iteration_time(
+      QuicTime::Delta::FromMilliseconds(10));
+  dispatcher_->OnEventLoopIterationStart();
+  dispatcher_helper()->AdvanceTime(QuicTime::Delta::FromMilliseconds(50));
+  dispatcher_->OnEventLoopIterationEnd();
+  const QuicHandshakeAdmissionController& controller =
+      dispatcher_->admission_controller();
+  EXPECT_EQ(QuicTime::Delta::FromMilliseconds(50),
+            controller.smoothed_iteration_time());
+  EXPECT_EQ(1u, controller.stats().overloaded_iterations);
+
+  EXPECT_CALL(*dispatcher_,
+              CreateQuicSession(TestConnectionId(1), _, _, _, _, _))
+      .Times(0);
+  ProcessFirstFlight(TestConnectionId(1));
+  EXPECT_TRUE(IsInTimeWait(TestConnectionId(1)));
+
+  ON_CALL(*dispatcher_,
+          ShouldPrioritizeChlo(
+              ReceivedPacketInfoConnectionIdEquals(TestConnectionId(2))))
+      .WillByDefault(Return(true));
+  ExpectSessionCreated(TestConnectionId(2));
+  ProcessFirstFlight(TestConnectionId(2));
+  EXPECT_EQ(1u, controller.stats().chlos_rejected);
+  EXPECT_EQ(1u, controller.stats().chlos_admitted);
+}
+
+TEST_P(HandshakeAdmissionControlTest, NotOverloaded) {
+  // Prioritization is only considered for CHLOs which can't be processed
+  // right away.
+  EXPECT_CALL(*dispatcher_, ShouldPrioritizeChlo(_)).Times(0);
+  ExpectSessionCreated(TestConnectionId(1));
+  ProcessFirstFlight(TestConnectionId(1));
+}
+
+TEST_P(HandshakeAdmissionControlTest, PrioritizeValidTokens) {
+  const QuicReceivedPacket packet("packet", 6, QuicTime::Zero());
+  ReceivedPacketInfo packet_info(server_address_, client_addr_, packet);
+  EXPECT_FALSE(dispatcher_->DefaultShouldPrioritizeChlo(packet_info));
+
+  packet_info.retry_token = "invalid token";
+  EXPECT_FALSE(dispatcher_->DefaultShouldPrioritizeChlo(packet_info));
+
+  const QuicWallTime now = dispatcher_helper()->GetClock()->WallNow();
+  const std::string token = crypto_config_.NewSourceAddressToken(
+      crypto_config_.source_address_token_boxer(), SourceAddressTokens(),
+      client_addr_.host(), QuicRandom::GetInstance(), now,
+      /*cached_network_params=*/nullptr);
+  packet_info.retry_token = token;
+  EXPECT_TRUE(dispatcher_->DefaultShouldPrioritizeChlo(packet_info));
+
+  // The token is only valid for the address it was issued to.
+  const std::string other_token = crypto_config_.NewSourceAddressToken(
+      crypto_config_.source_address_token_boxer(), SourceAddressTokens(),
+      QuicIpAddress::Loopback6(), QuicRandom::GetInstance(), now,
+      /*cached_network_params=*/nullptr);
+  packet_info.retry_token = other_token;
+  EXPECT_FALSE(dispatcher_->DefaultShouldPrioritizeChlo(packet_info));
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace quic
@@ -0,0 +1,132 @@
+// Copyright (c) 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "quic/core/quic_ecn_tracker.h"
+
+#include "absl/strings/str_cat.h"
+#include "quic/platform/api/quic_logging.h"
+
+namespace quic {
+
+void QuicEcnTracker::OnPacketSent(PacketNumberSpace packet_number_space,
+                                  QuicEcnCodepoint ecn_codepoint) {
+  switch (ecn_codepoint) {
+    case ECN_ECT0:
+      ++sent_[packet_number_space].ect0;
+      break;
+    case ECN_ECT1:
+      ++sent_[packet_number_space].ect1;
+      break;
+    case ECN_NOT_ECT:
+    case ECN_CE:
+      return;
+  }
+  if (state_ == TESTING && ++testing_packets_sent_ >= kNumTestingPackets) {
+    QUIC_DVLOG(1) << "All ECN testing packets sent";
+    state_ = UNKNOWN;
+  }
+}
+
+void QuicEcnTracker::OnPacketLost(QuicEcnCodepoint ecn_codepoint) {
+  if (ecn_codepoint == ECN_NOT_ECT ||
+      (state_ != TESTING && state_ != UNKNOWN)) {
+    return;
+  }
+  ++testing_packets_lost_;
+  if (state_ == UNKNOWN && testing_packets_lost_ >= testing_packets_sent_) {
+    QUIC_DVLOG(1) << "ECN validation failed: all testing packets were lost";
+    state_ = FAILED;
+  }
+}
+
+QuicPacketCount QuicEcnTracker::OnAckFrame(
+    PacketNumberSpace packet_number_space,
+    QuicPacketCount newly_acked_ect0,
+    QuicPacketCount newly_acked_ect1,
+    const absl::optional<QuicEcnCounts>& ecn_counts) {
+  if (state_ == FAILED) {
+    return 0;
+  }
+  const bool newly_acked_ect = newly_acked_ect0 + newly_acked_ect1 > 0;
+  if (!ecn_counts.has_value()) {
+    if (newly_acked_ect) {
+      QUIC_DVLOG(1) << "ECN validation failed: ECN-capable packets acked "
+                       "without ECN counts";
+      state_ = FAILED;
+    }
+    return 0;
+  }
+  if (!ValidateEcnCounts(packet_number_space, newly_acked_ect0,
+                         newly_acked_ect1, *ecn_counts)) {
+    QUIC_DVLOG(1) << "ECN validation failed: ECN counts " << *ecn_counts
+                  << " after " << reported_[packet_number_space]
+                  << ", newly acked ECT(0): " << newly_acked_ect0
+                  << ", ECT(1): " << newly_acked_ect1;
+    state_ = FAILED;
+    return 0;
+  }
+  const QuicPacketCount newly_ce =
+      ecn_counts->ce - reported_[packet_number_space].ce;
+  reported_[packet_number_space] = *ecn_counts;
+  if (newly_acked_ect && state_ != CAPABLE) {
+    QUIC_DVLOG(1) << "ECN validation succeeded";
+    state_ = CAPABLE;
+  }
+  return newly_ce;
+}
+
+bool QuicEcnTracker::ValidateEcnCounts(PacketNumberSpace packet_number_space,
+                                       QuicPacketCount newly_acked_ect0,
+                                       QuicPacketCount newly_acked_ect1,
+                                       const QuicEcnCounts& ecn_counts) const {
+  const QuicEcnCounts& reported = reported_[packet_number_space];
+  const QuicEcnCounts& sent = sent_[packet_number_space];
+  // ECN counts never decrease.
+  if (ecn_counts.ect0 < reported.ect0 || ecn_counts.ect1 < reported.ect1 ||
+      ecn_counts.ce < reported.ce) {
+    return false;
+  }
+  // No count can exceed the number of packets sent with the corresponding
+  // codepoint, and CE marks can only be applied to ECN-capable packets.
+  if (ecn_counts.ect0 > sent.ect0 || ecn_counts.ect1 > sent.ect1 ||
+      ecn_counts.ect0 + ecn_counts.ect1 + ecn_counts.ce >
+          sent.ect0 + sent.ect1) {
+    return false;
+  }
+  // Every newly acked ECN-capable packet must be counted, either with the
+  // codepoint it was sent with or as CE.  This detects paths that clear or
+  // rewrite the codepoint.
+  const QuicPacketCount increase_ect0 = ecn_counts.ect0 - reported.ect0;
+  const QuicPacketCount increase_ect1 = ecn_counts.ect1 - reported.ect1;
+  const QuicPacketCount increase_ce = ecn_counts.ce - reported.ce;
+  if (newly_acked_ect1 == 0 && increase_ect0 + increase_ce < newly_acked_ect0) {
+    return false;
+  }
+  if (newly_acked_ect0 == 0 && increase_ect1 + increase_ce < newly_acked_ect1) {
+    return false;
+  }
+  return increase_ect0 + increase_ect1 + increase_ce >=
+         newly_acked_ect0 + newly_acked_ect1;
+}
+
+std::string EcnTrackerStateToString(QuicEcnTracker::State state) {
+  switch (state) {
+    case QuicEcnTracker::TESTING:
+      return "TESTING";
+    case QuicEcnTracker::UNKNOWN:
+      return "UNKNOWN";
+    case QuicEcnTracker::CAPABLE:
+      return "CAPABLE";
+    case QuicEcnTracker::FAILED:
+      return "FAILED";
+  }
+  return absl::StrCat("Unknown(", static_cast<int>(state), ")");
+}
+
+std::ostream& operator<<(std::ostream& os, QuicEcnTracker::State state) {
+  os << EcnTrackerStateToString(state);
+  return os;
+}
+
+}  // namespace quic
@@ -0,0 +1,92 @@
+// Copyright (c) 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef QUICHE_QUIC_CORE_QUIC_ECN_TRACKER_H_
+#define QUICHE_QUIC_CORE_QUIC_ECN_TRACKER_H_
+
+#include <ostream>
+#include <string>
+
+#include "absl/types/optional.h"
+#include "quic/core/quic_types.h"
+#include "quic/platform/api/quic_export.h"
+
+namespace quic {
+
+// QuicEcnTracker validates that the path and the peer support ECN, as
+// described in RFC 9000 Section 13.4.2.  It counts the ECN-capable packets
+// sent in each packet number space and checks the ECN counts of ACK frames
+// against them.
+//
+// The first kNumTestingPackets packets are marked ECN-capable.  Marking then
+// stops until an ACK frame with valid ECN counts acknowledges one of them,
+// after which all packets are marked, unless validation fails.
+class QUIC_EXPORT_PRIVATE QuicEcnTracker {
+ public:
+  enum State : uint8_t {
+    // Marking the first kNumTestingPackets packets.
+    TESTING,
+    // All testing packets have been sent, waiting for them to be acked.
+    UNKNOWN,
+    // ECN counts have been validated.
+    CAPABLE,
+    // Validation failed, packets are no longer marked.
+    FAILED,
+  };
+
+  static constexpr QuicPacketCount kNumTestingPackets = 10;
+
+  QuicEcnTracker() = default;
+
+  // Whether the next packet should be sent with an ECN-capable codepoint.
+  bool ShouldMarkPackets() const {
+    return state_ == TESTING || state_ == CAPABLE;
+  }
+
+  // Called when a packet is sent in |packet_number_space| with
+  // |ecn_codepoint|.
+  void OnPacketSent(PacketNumberSpace packet_number_space,
+                    QuicEcnCodepoint ecn_codepoint);
+
+  // Called when a packet sent with |ecn_codepoint| is declared lost.
+  void OnPacketLost(QuicEcnCodepoint ecn_codepoint);
+
+  // Called when an ACK frame in |packet_number_space| increases the largest
+  // acked packet.  |newly_acked_ect0| and |newly_acked_ect1| are the number of
+  // packets it newly acknowledges that were sent with ECT(0) and ECT(1), and
+  // |ecn_counts| are its ECN counts, if present.  Returns the number of newly
+  // CE-marked packets, which is zero if validation fails.
+  QuicPacketCount OnAckFrame(PacketNumberSpace packet_number_space,
+                             QuicPacketCount newly_acked_ect0,
+                             QuicPacketCount newly_acked_ect1,
+                             const absl::optional<QuicEcnCounts>& ecn_counts);
+
+  State state() const { return state_; }
+
+ private:
+  // Returns false if the ECN counts of an ACK frame fail validation.
+  bool ValidateEcnCounts(PacketNumberSpace packet_number_space,
+                         QuicPacketCount newly_acked_ect0,
+                         QuicPacketCount newly_acked_ect1,
+                         const QuicEcnCounts& ecn_counts) const;
+
+  State state_ = TESTING;
+  // ECN-capable packets sent and declared lost before validation succeeded.
+  QuicPacketCount testing_packets_sent_ = 0;
+  QuicPacketCount testing_packets_lost_ = 0;
+  // ECN-capable packets sent in each packet number space.  |ce| is unused.
+  QuicEcnCounts sent_[NUM_PACKET_NUMBER_SPACES];
+  // The largest ECN counts reported by the peer in each packet number space.
+  QuicEcnCounts reported_[NUM_PACKET_NUMBER_SPACES];
+};
+
+QUIC_EXPORT_PRIVATE std::string EcnTrackerStateToString(
+    QuicEcnTracker::State state);
+
+QUIC_EXPORT_PRIVATE std::ostream& operator<<(std::ostream& os,
+                                             QuicEcnTracker::State state);
+
+}  // namespace quic
+
+#endif  // QUICHE_QUIC_CORE_QUIC_ECN_TRACKER_H_
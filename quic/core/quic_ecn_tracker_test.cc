@@ -0,0 +1,157 @@
+// Copyright (c) 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "quic/core/quic_ecn_tracker.h"
+
+#include "quic/platform/api/quic_test.h"
+
+namespace quic {
+namespace test {
+namespace {
+
+QuicEcnCounts MakeEcnCounts(QuicPacketCount ect0,
+                            QuicPacketCount ect1,
+                            QuicPacketCount ce) {
+  QuicEcnCounts ecn_counts;
+  ecn_counts.ect0 = ect0;
+  ecn_counts.ect1 = ect1;
+  ecn_counts.ce = ce;
+  return ecn_counts;
+}
+
+class QuicEcnTrackerTest : public QuicTest {
+ protected:
+  void SendPackets(QuicPacketCount count, QuicEcnCodepoint ecn_codepoint) {
+    for (QuicPacketCount i = 0; i < count; ++i) {
+      tracker_.OnPacketSent(APPLICATION_DATA, ecn_codepoint);
+    }
+  }
+
+  QuicEcnTracker tracker_;
+};
+
+TEST_F(QuicEcnTrackerTest, TestingPeriod) {
+  EXPECT_EQ(QuicEcnTracker::TESTING, tracker_.state());
+  EXPECT_TRUE(tracker_.ShouldMarkPackets());
+  SendPackets(QuicEcnTracker::kNumTestingPackets - 1, ECN_ECT0);
+  EXPECT_TRUE(tracker_.ShouldMarkPackets());
+  // Packets that are not ECN-capable do not count towards testing.
+  SendPackets(5, ECN_NOT_ECT);
+  EXPECT_TRUE(tracker_.ShouldMarkPackets());
+  SendPackets(1, ECN_ECT0);
+  EXPECT_EQ(QuicEcnTracker::UNKNOWN, tracker_.state());
+  EXPECT_FALSE(tracker_.ShouldMarkPackets());
+
+  EXPECT_EQ(0u, tracker_.OnAckFrame(APPLICATION_DATA, 2, 0,
+                                    MakeEcnCounts(2, 0, 0)));
+  EXPECT_EQ(QuicEcnTracker::CAPABLE, tracker_.state());
+  EXPECT_TRUE(tracker_.ShouldMarkPackets());
+}
+
+TEST_F(QuicEcnTrackerTest, CeMarks) {
+  SendPackets(4, ECN_ECT0);
+  EXPECT_EQ(1u, tracker_.OnAckFrame(APPLICATION_DATA, 2, 0,
+                                    MakeEcnCounts(1, 0, 1)));
+  EXPECT_EQ(QuicEcnTracker::CAPABLE, tracker_.state());
+  // The counts are cumulative.
+  EXPECT_EQ(0u, tracker_.OnAckFrame(APPLICATION_DATA, 1, 0,
+                                    MakeEcnCounts(2, 0, 1)));
+  EXPECT_EQ(1u, tracker_.OnAckFrame(APPLICATION_DATA, 1, 0,
+                                    MakeEcnCounts(2, 0, 2)));
+  EXPECT_EQ(QuicEcnTracker::CAPABLE, tracker_.state());
+}
+
+TEST_F(QuicEcnTrackerTest, Ect1) {
+  SendPackets(3, ECN_ECT1);
+  EXPECT_EQ(1u, tracker_.OnAckFrame(APPLICATION_DATA, 0, 3,
+                                    MakeEcnCounts(0, 2, 1)));
+  EXPECT_EQ(QuicEcnTracker::CAPABLE, tracker_.state());
+}
+
+TEST_F(QuicEcnTrackerTest, NoNewlyAckedEctPacketsWithoutCounts) {
+  SendPackets(2, ECN_NOT_ECT);
+  EXPECT_EQ(0u,
+            tracker_.OnAckFrame(APPLICATION_DATA, 0, 0, absl::nullopt));
+  EXPECT_EQ(QuicEcnTracker::TESTING, tracker_.state());
+}
+
+TEST_F(QuicEcnTrackerTest, MissingCounts) {
+  SendPackets(2, ECN_ECT0);
+  EXPECT_EQ(0u,
+            tracker_.OnAckFrame(APPLICATION_DATA, 2, 0, absl::nullopt));
+  EXPECT_EQ(QuicEcnTracker::FAILED, tracker_.state());
+  EXPECT_FALSE(tracker_.ShouldMarkPackets());
+}
+
+TEST_F(QuicEcnTrackerTest, CodepointCleared) {
+  SendPackets(2, ECN_ECT0);
+  // The path cleared the codepoint of one of the packets.
+  EXPECT_EQ(0u, tracker_.OnAckFrame(APPLICATION_DATA, 2, 0,
+                                    MakeEcnCounts(1, 0, 0)));
+  EXPECT_EQ(QuicEcnTracker::FAILED, tracker_.state());
+}
+
+TEST_F(QuicEcnTrackerTest, CodepointRewritten) {
+  SendPackets(2, ECN_ECT0);
+  // The path rewrote ECT(0) to ECT(1), so the ECT(1) count exceeds the number
+  // of packets sent with ECT(1).
+  EXPECT_EQ(0u, tracker_.OnAckFrame(APPLICATION_DATA, 2, 0,
+                                    MakeEcnCounts(0, 2, 0)));
+  EXPECT_EQ(QuicEcnTracker::FAILED, tracker_.state());
+}
+
+TEST_F(QuicEcnTrackerTest, CountsExceedPacketsSent) {
+  SendPackets(2, ECN_ECT0);
+  EXPECT_EQ(0u, tracker_.OnAckFrame(APPLICATION_DATA, 2, 0,
+                                    MakeEcnCounts(2, 0, 1)));
+  EXPECT_EQ(QuicEcnTracker::FAILED, tracker_.state());
+}
+
+TEST_F(QuicEcnTrackerTest, CountsDecrease) {
+  SendPackets(4, ECN_ECT0);
+  EXPECT_EQ(1u, tracker_.OnAckFrame(APPLICATION_DATA, 2, 0,
+                                    MakeEcnCounts(1, 0, 1)));
+  EXPECT_EQ(0u, tracker_.OnAckFrame(APPLICATION_DATA, 1, 0,
+                                    MakeEcnCounts(3, 0, 0)));
+  EXPECT_EQ(QuicEcnTracker::FAILED, tracker_.state());
+  // Nothing is reported after validation failed.
+  EXPECT_EQ(0u, tracker_.OnAckFrame(APPLICATION_DATA, 1, 0,
+                                    MakeEcnCounts(3, 0, 1)));
+}
+
+TEST_F(QuicEcnTrackerTest, PacketNumberSpaces) {
+  tracker_.OnPacketSent(INITIAL_DATA, ECN_ECT0);
+  SendPackets(2, ECN_ECT0);
+  EXPECT_EQ(0u, tracker_.OnAckFrame(INITIAL_DATA, 1, 0,
+                                    MakeEcnCounts(1, 0, 0)));
+  // Counts of different packet number spaces are independent.
+  EXPECT_EQ(0u, tracker_.OnAckFrame(APPLICATION_DATA, 2, 0,
+                                    MakeEcnCounts(2, 0, 0)));
+  EXPECT_EQ(QuicEcnTracker::CAPABLE, tracker_.state());
+}
+
+TEST_F(QuicEcnTrackerTest, AllTestingPacketsLost) {
+  SendPackets(QuicEcnTracker::kNumTestingPackets, ECN_ECT0);
+  EXPECT_EQ(QuicEcnTracker::UNKNOWN, tracker_.state());
+  for (QuicPacketCount i = 0; i < QuicEcnTracker::kNumTestingPackets - 1;
+       ++i) {
+    tracker_.OnPacketLost(ECN_ECT0);
+  }
+  EXPECT_EQ(QuicEcnTracker::UNKNOWN, tracker_.state());
+  tracker_.OnPacketLost(ECN_ECT0);
+  EXPECT_EQ(QuicEcnTracker::FAILED, tracker_.state());
+}
+
+TEST_F(QuicEcnTrackerTest, LossAfterValidation) {
+  SendPackets(3, ECN_ECT0);
+  EXPECT_EQ(0u, tracker_.OnAckFrame(APPLICATION_DATA, 1, 0,
+                                    MakeEcnCounts(1, 0, 0)));
+  tracker_.OnPacketLost(ECN_ECT0);
+  tracker_.OnPacketLost(ECN_ECT0);
+  EXPECT_EQ(QuicEcnTracker::CAPABLE, tracker_.state());
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace quic
@@ -29,6 +29,8 @@ QUIC_FLAG(FLAGS_quic_reloadable_flag_quic_abort_qpack_on_stream_reset, true)
 QUIC_FLAG(FLAGS_quic_reloadable_flag_quic_can_send_ack_frequency, true)
 // If true, allow client to enable BBRv2 on server via connection option \'B2ON\'.
 QUIC_FLAG(FLAGS_quic_reloadable_flag_quic_allow_client_enabled_bbr_v2, false)
+// If true, allow client to enable the BBRv3 variant of BBRv2 on server via connection option \'B3ON\'.
+QUIC_FLAG(FLAGS_quic_reloadable_flag_quic_allow_client_enabled_bbr_v3, false)
 // If true, allow ticket open to be ignored in TlsServerHandshaker. Also fixes TlsServerHandshaker::ResumptionAttempted when handshake hints is used.
 QUIC_FLAG(FLAGS_quic_reloadable_flag_quic_tls_allow_ignore_ticket_open, true)
 // If true, close read side but not write side in QuicSpdyStream::OnStreamReset().
@@ -125,6 +127,22 @@ QUIC_FLAG(FLAGS_quic_reloadable_flag_quic_default_to_bbr, false)
 QUIC_FLAG(FLAGS_quic_reloadable_flag_quic_fix_pacing_sender_bursts, false)
 // When true, set the initial congestion control window from connection options in QuicSentPacketManager rather than TcpCubicSenderBytes.
 QUIC_FLAG(FLAGS_quic_reloadable_flag_quic_unified_iw_options, false)
+// If true, record RTT, ack delay, pacing delay, receive-to-delivery delay and handshake duration histograms in QuicConnectionStats.
+QUIC_FLAG(FLAGS_quic_reloadable_flag_quic_record_latency_histograms, false)
+// If true, report the ECN codepoints of received packets in ACK frames.
+QUIC_FLAG(FLAGS_quic_reloadable_flag_quic_receive_ecn, false)
+// If true, send ECN-capable packets when the client requests the ECNS or PRGE connection option, and respond to CE marks.
+QUIC_FLAG(FLAGS_quic_reloadable_flag_quic_send_ecn, false)
+// If true, QuicDispatcher dispatches short header packets of known connections without parsing the rest of their public header.
+QUIC_FLAG(FLAGS_quic_reloadable_flag_quic_dispatcher_short_header_fast_path, true)
+// If true, QuicDispatcher rejects CHLOs which are not prioritized while its event loop is overloaded, and creates sessions for prioritized CHLOs first.
+QUIC_FLAG(FLAGS_quic_reloadable_flag_quic_dispatcher_handshake_admission_control, false)
+// If true, QuicUnackedPacketMap keeps track of the least in flight packet of each packet number space instead of scanning for it.
+QUIC_FLAG(FLAGS_quic_reloadable_flag_quic_unacked_map_in_flight_index, true)
+// If true, QuicServerSessionBase seeds new connections from, and records closed connections in, its QuicNetworkParamsCache, if it has one.
+QUIC_FLAG(FLAGS_quic_reloadable_flag_quic_server_network_params_cache, false)
+// If true, QuicSpdyStream reads in order stream frames in place instead of copying them into the sequencer's buffer first.
+QUIC_FLAG(FLAGS_quic_reloadable_flag_quic_spdy_stream_read_in_place, false)
 
 #endif
 
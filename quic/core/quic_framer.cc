@@ -4125,13 +4125,20 @@ bool QuicFramer::ProcessIetfAckFrame(QuicDataReader* reader,
       set_detailed_error("Unable to read ack ecn_ce_count.");
       return false;
     }
+    QuicEcnCounts ecn_counts;
+    ecn_counts.ect0 = ack_frame->ect_0_count;
+    ecn_counts.ect1 = ack_frame->ect_1_count;
+    ecn_counts.ce = ack_frame->ecn_ce_count;
+    if (!visitor_->OnAckEcnCounts(ecn_counts)) {
+      set_detailed_error("Visitor suppresses further processing of ACK frame.");
+      return false;
+    }
   } else {
     ack_frame->ecn_counters_populated = false;
     ack_frame->ect_0_count = 0;
     ack_frame->ect_1_count = 0;
     ack_frame->ecn_ce_count = 0;
   }
-  // TODO(fayang): Report ECN counts to visitor when they are actually used.
   if (!visitor_->OnAckFrameEnd(QuicPacketNumber(block_low))) {
     set_detailed_error(
         "Error occurs when visitor finishes processing the ACK frame.");
@@ -6567,6 +6574,20 @@ QuicErrorCode QuicFramer::ParsePublicHeaderDispatcher(
   return error_code;
 }
 
+// static
+bool QuicFramer::ParseShortHeaderDestinationConnectionId(
+    const QuicEncryptedPacket& packet,
+    uint8_t expected_destination_connection_id_length,
+    QuicConnectionId* destination_connection_id) {
+  if (packet.length() < 1u + expected_destination_connection_id_length ||
+      !QuicUtils::IsIetfPacketShortHeader(packet.data()[0])) {
+    return false;
+  }
+  *destination_connection_id = QuicConnectionId(
+      packet.data() + 1, expected_destination_connection_id_length);
+  return true;
+}
+
 // static
 QuicErrorCode QuicFramer::ParsePublicHeaderGoogleQuic(
     QuicDataReader* reader,
@@ -163,6 +163,10 @@ class QUIC_EXPORT_PRIVATE QuicFramerVisitorInterface {
   virtual bool OnAckTimestamp(QuicPacketNumber packet_number,
                               QuicTime timestamp) = 0;
 
+  // Called after the last ack range and before OnAckFrameEnd if the AckFrame
+  // carries ECN counts.
+  virtual bool OnAckEcnCounts(const QuicEcnCounts& ecn_counts) = 0;
+
   // Called after the last ack range in an AckFrame has been parsed.
   // |start| is the starting value of the last ack range.
   virtual bool OnAckFrameEnd(QuicPacketNumber start) = 0;
@@ -458,6 +462,18 @@ class QUIC_EXPORT_PRIVATE QuicFramer {
       absl::string_view* retry_token,
       std::string* detailed_error);
 
+  // Returns true and sets |destination_connection_id| if |packet| has an IETF
+  // short header.  Short headers do not carry the length of the destination
+  // connection ID, so it is taken to be
+  // |expected_destination_connection_id_length| bytes long.  Nothing else is
+  // parsed, which makes this cheaper than ParsePublicHeaderDispatcher() for
+  // the packets of established connections.  This can only be called on the
+  // server.
+  static bool ParseShortHeaderDestinationConnectionId(
+      const QuicEncryptedPacket& packet,
+      uint8_t expected_destination_connection_id_length,
+      QuicConnectionId* destination_connection_id);
+
   // Serializes a packet containing |frames| into |buffer|.
   // Returns the length of the packet, which must not be longer than
   // |packet_length|.  Returns 0 if it fails to serialize.
@@ -385,6 +385,16 @@ class TestQuicVisitor : public QuicFramerVisitorInterface {
     return true;
   }
 
+  bool OnAckEcnCounts(const QuicEcnCounts& ecn_counts) override {
+    QUICHE_DCHECK(!ack_frames_.empty());
+    QuicAckFrame* ack_frame = ack_frames_[ack_frames_.size() - 1].get();
+    ack_frame->ecn_counters_populated = true;
+    ack_frame->ect_0_count = ecn_counts.ect0;
+    ack_frame->ect_1_count = ecn_counts.ect1;
+    ack_frame->ecn_ce_count = ecn_counts.ce;
+    return true;
+  }
+
   bool OnAckFrameEnd(QuicPacketNumber /*start*/) override { return true; }
 
   bool OnStopWaitingFrame(const QuicStopWaitingFrame& frame) override {
@@ -1389,6 +1399,61 @@ TEST_P(QuicFramerTest, ParsePublicHeader) {
   }
 }
 
+TEST_P(QuicFramerTest, ParseShortHeaderDestinationConnectionId) {
+  // clang-format off
+  unsigned char short_header_packet[] = {
+    // type (short header, 4 byte packet number)
+    0x43,
+    // connection_id
+    0xFE, 0xDC, 0xBA, 0x98, 0x76, 0x54, 0x32, 0x10,
+    // packet number
+    0x12, 0x34, 0x56, 0x78,
+  };
+  unsigned char long_header_packet[] = {
+    // type (long header with packet type INITIAL)
+    0xC3,
+    // version
+    QUIC_VERSION_BYTES,
+    // destination connection ID length
+    0x08,
+    // destination connection ID
+    0xFE, 0xDC, 0xBA, 0x98, 0x76, 0x54, 0x32, 0x10,
+  };
+  unsigned char google_quic_packet[] = {
+    // public flags (8 byte connection_id)
+    0x28,
+    // connection_id
+    0xFE, 0xDC, 0xBA, 0x98, 0x76, 0x54, 0x32, 0x10,
+    // packet number
+    0x12, 0x34, 0x56, 0x78,
+  };
+  // clang-format on
+
+  QuicConnectionId destination_connection_id;
+  QuicEncryptedPacket short_header(AsChars(short_header_packet),
+                                   ABSL_ARRAYSIZE(short_header_packet), false);
+  EXPECT_TRUE(QuicFramer::ParseShortHeaderDestinationConnectionId(
+      short_header, kQuicDefaultConnectionIdLength,
+      &destination_connection_id));
+  EXPECT_EQ(FramerTestConnectionId(), destination_connection_id);
+
+  // The packet is too short for the expected connection ID length.
+  EXPECT_FALSE(QuicFramer::ParseShortHeaderDestinationConnectionId(
+      short_header, 20, &destination_connection_id));
+
+  QuicEncryptedPacket long_header(AsChars(long_header_packet),
+                                  ABSL_ARRAYSIZE(long_header_packet), false);
+  EXPECT_FALSE(QuicFramer::ParseShortHeaderDestinationConnectionId(
+      long_header, kQuicDefaultConnectionIdLength,
+      &destination_connection_id));
+
+  QuicEncryptedPacket google_quic(AsChars(google_quic_packet),
+                                  ABSL_ARRAYSIZE(google_quic_packet), false);
+  EXPECT_FALSE(QuicFramer::ParseShortHeaderDestinationConnectionId(
+      google_quic, kQuicDefaultConnectionIdLength,
+      &destination_connection_id));
+}
+
 TEST_P(QuicFramerTest, ParsePublicHeaderProxBadSourceConnectionIdLength) {
   if (!framer_.version().HasLengthPrefixedConnectionIds()) {
     return;
@@ -9587,6 +9652,10 @@ TEST_P(QuicFramerTest, IetfAckFrameTruncation) {
             ack_frame.packets.NumIntervals());
   EXPECT_EQ(QuicPacketNumber(kMaxIetfVarInt),
             processed_ack_frame.packets.Max());
+  EXPECT_TRUE(processed_ack_frame.ecn_counters_populated);
+  EXPECT_EQ(100u, processed_ack_frame.ect_0_count);
+  EXPECT_EQ(10000u, processed_ack_frame.ect_1_count);
+  EXPECT_EQ(1000000u, processed_ack_frame.ecn_ce_count);
 }
 
 TEST_P(QuicFramerTest, AckTruncationSmallPacket) {
@@ -0,0 +1,69 @@
+// Copyright (c) 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "quic/core/quic_handshake_admission_controller.h"
+
+#include "quic/platform/api/quic_logging.h"
+
+namespace quic {
+
+namespace {
+
+// Same gain as the smoothed RTT in RttStats.
+const float kIterationTimeAlpha = 0.125f;
+const float kOneMinusIterationTimeAlpha = 1 - kIterationTimeAlpha;
+
+}  // namespace
+
+QuicHandshakeAdmissionController::QuicHandshakeAdmissionController(
+    const QuicClock* clock)
+    : clock_(clock),
+      max_iteration_time_(kDefaultMaxIterationTime),
+      max_buffered_chlos_(kDefaultMaxBufferedChlos),
+      in_iteration_(false),
+      iteration_start_(QuicTime::Zero()),
+      smoothed_iteration_time_(QuicTime::Delta::Zero()) {}
+
+void QuicHandshakeAdmissionController::OnIterationStart() {
+  in_iteration_ = true;
+  iteration_start_ = clock_->Now();
+}
+
+void QuicHandshakeAdmissionController::OnIterationEnd(
+    size_t num_buffered_chlos) {
+  if (!in_iteration_) {
+    QUIC_DVLOG(1) << "Event loop iteration ended without starting";
+    return;
+  }
+  in_iteration_ = false;
+  const QuicTime::Delta iteration_time = clock_->Now() - iteration_start_;
+  if (smoothed_iteration_time_.IsZero()) {
+    smoothed_iteration_time_ = iteration_time;
+  } else {
+    smoothed_iteration_time_ =
+        kOneMinusIterationTimeAlpha * smoothed_iteration_time_ +
+        kIterationTimeAlpha * iteration_time;
+  }
+  if (IsOverloaded(num_buffered_chlos)) {
+    ++stats_.overloaded_iterations;
+  }
+}
+
+bool QuicHandshakeAdmissionController::IsOverloaded(
+    size_t num_buffered_chlos) const {
+  return smoothed_iteration_time_ > max_iteration_time_ ||
+         num_buffered_chlos > max_buffered_chlos_;
+}
+
+std::ostream& operator<<(
+    std::ostream& os,
+    const QuicHandshakeAdmissionController::Stats& stats) {
+  os << "{ chlos_admitted: " << stats.chlos_admitted
+     << ", chlos_prioritized: " << stats.chlos_prioritized
+     << ", chlos_rejected: " << stats.chlos_rejected
+     << ", overloaded_iterations: " << stats.overloaded_iterations << " }";
+  return os;
+}
+
+}  // namespace quic
@@ -0,0 +1,98 @@
+// Copyright (c) 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef QUICHE_QUIC_CORE_QUIC_HANDSHAKE_ADMISSION_CONTROLLER_H_
+#define QUICHE_QUIC_CORE_QUIC_HANDSHAKE_ADMISSION_CONTROLLER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+#include "quic/core/quic_clock.h"
+#include "quic/core/quic_time.h"
+#include "quic/platform/api/quic_export.h"
+
+namespace quic {
+
+// Tracks how loaded a dispatcher's event loop is, so that new handshakes can
+// be turned away before they starve established connections.  The event loop
+// is overloaded when its iterations take longer than max_iteration_time() on
+// average, or when more than max_buffered_chlos() CHLOs are waiting for a
+// session to be created.
+class QUIC_EXPORT_PRIVATE QuicHandshakeAdmissionController {
+ public:
+  // Counters of the decisions taken by the dispatcher, for monitoring.
+  struct QUIC_EXPORT_PRIVATE Stats {
+    // CHLOs which created a session, either on arrival or once buffered.
+    uint64_t chlos_admitted = 0;
+    // CHLOs which were buffered ahead of others, because they carry a valid
+    // source address token.
+    uint64_t chlos_prioritized = 0;
+    // CHLOs which were rejected because the event loop was overloaded.
+    uint64_t chlos_rejected = 0;
+    // Event loop iterations after which the event loop was overloaded.
+    uint64_t overloaded_iterations = 0;
+  };
+
+  static constexpr QuicTime::Delta kDefaultMaxIterationTime =
+      QuicTime::Delta::FromMilliseconds(20);
+  static constexpr size_t kDefaultMaxBufferedChlos = 50;
+
+  // |clock| is not owned and must outlive this object.
+  explicit QuicHandshakeAdmissionController(const QuicClock* clock);
+
+  QuicHandshakeAdmissionController(const QuicHandshakeAdmissionController&) =
+      delete;
+  QuicHandshakeAdmissionController& operator=(
+      const QuicHandshakeAdmissionController&) = delete;
+
+  // Called when the event loop starts and finishes processing a socket event.
+  // |num_buffered_chlos| is the number of CHLOs still waiting for a session.
+  void OnIterationStart();
+  void OnIterationEnd(size_t num_buffered_chlos);
+
+  // Returns true if new handshakes, other than prioritized ones, should be
+  // rejected.
+  bool IsOverloaded(size_t num_buffered_chlos) const;
+
+  void OnChloAdmitted() { ++stats_.chlos_admitted; }
+  void OnChloPrioritized() { ++stats_.chlos_prioritized; }
+  void OnChloRejected() { ++stats_.chlos_rejected; }
+
+  // The exponentially weighted moving average of the time spent per event loop
+  // iteration, or zero before the first iteration ends.
+  QuicTime::Delta smoothed_iteration_time() const {
+    return smoothed_iteration_time_;
+  }
+
+  QuicTime::Delta max_iteration_time() const { return max_iteration_time_; }
+  void set_max_iteration_time(QuicTime::Delta max_iteration_time) {
+    max_iteration_time_ = max_iteration_time;
+  }
+
+  size_t max_buffered_chlos() const { return max_buffered_chlos_; }
+  void set_max_buffered_chlos(size_t max_buffered_chlos) {
+    max_buffered_chlos_ = max_buffered_chlos;
+  }
+
+  const Stats& stats() const { return stats_; }
+
+ private:
+  const QuicClock* clock_;  // Not owned.
+  QuicTime::Delta max_iteration_time_;
+  size_t max_buffered_chlos_;
+  // Whether an iteration has started and not ended yet, and when it started.
+  bool in_iteration_;
+  QuicTime iteration_start_;
+  QuicTime::Delta smoothed_iteration_time_;
+  Stats stats_;
+};
+
+QUIC_EXPORT_PRIVATE std::ostream& operator<<(
+    std::ostream& os,
+    const QuicHandshakeAdmissionController::Stats& stats);
+
+}  // namespace quic
+
+#endif  // QUICHE_QUIC_CORE_QUIC_HANDSHAKE_ADMISSION_CONTROLLER_H_
@@ -0,0 +1,85 @@
+// Copyright (c) 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "quic/core/quic_handshake_admission_controller.h"
+
+#include "quic/platform/api/quic_test.h"
+#include "quic/test_tools/mock_clock.h"
+
+namespace quic {
+namespace test {
+namespace {
+
+class QuicHandshakeAdmissionControllerTest : public QuicTest {
+ protected:
+  QuicHandshakeAdmissionControllerTest() : controller_(&clock_) {}
+
+  void RunIteration(QuicTime::Delta duration, size_t num_buffered_chlos = 0) {
+    controller_.OnIterationStart();
+    clock_.AdvanceTime(duration);
+    controller_.OnIterationEnd(num_buffered_chlos);
+  }
+
+  MockClock clock_;
+  QuicHandshakeAdmissionController controller_;
+};
+
+TEST_F(QuicHandshakeAdmissionControllerTest, NotOverloadedInitially) {
+  EXPECT_TRUE(controller_.smoothed_iteration_time().IsZero());
+  EXPECT_FALSE(controller_.IsOverloaded(0));
+  EXPECT_EQ(0u, controller_.stats().overloaded_iterations);
+}
+
+TEST_F(QuicHandshakeAdmissionControllerTest, SmoothsIterationTime) {
+  RunIteration(QuicTime::Delta::FromMilliseconds(8));
+  EXPECT_EQ(QuicTime::Delta::FromMilliseconds(8),
+            controller_.smoothed_iteration_time());
+  RunIteration(QuicTime::Delta::FromMilliseconds(16));
+  EXPECT_EQ(QuicTime::Delta::FromMilliseconds(9),
+            controller_.smoothed_iteration_time());
+}
+
+TEST_F(QuicHandshakeAdmissionControllerTest, OverloadedBySlowIterations) {
+  controller_.set_max_iteration_time(QuicTime::Delta::FromMilliseconds(10));
+  RunIteration(QuicTime::Delta::FromMilliseconds(5));
+  EXPECT_FALSE(controller_.IsOverloaded(0));
+
+  // A single slow iteration is smoothed out.
+  RunIteration(QuicTime::Delta::FromMilliseconds(30));
+  EXPECT_FALSE(controller_.IsOverloaded(0));
+  EXPECT_EQ(0u, controller_.stats().overloaded_iterations);
+
+  // A sustained series of them is not.
+  for (int i = 0; i < 10; ++i) {
+    RunIteration(QuicTime::Delta::FromMilliseconds(30));
+  }
+  EXPECT_TRUE(controller_.IsOverloaded(0));
+  EXPECT_LT(0u, controller_.stats().overloaded_iterations);
+
+  // The event loop recovers once iterations are quick again.
+  for (int i = 0; i < 20; ++i) {
+    RunIteration(QuicTime::Delta::FromMilliseconds(1));
+  }
+  EXPECT_FALSE(controller_.IsOverloaded(0));
+}
+
+TEST_F(QuicHandshakeAdmissionControllerTest, OverloadedByBufferedChlos) {
+  controller_.set_max_buffered_chlos(10);
+  EXPECT_FALSE(controller_.IsOverloaded(10));
+  EXPECT_TRUE(controller_.IsOverloaded(11));
+
+  RunIteration(QuicTime::Delta::FromMilliseconds(1), 11);
+  EXPECT_EQ(1u, controller_.stats().overloaded_iterations);
+  RunIteration(QuicTime::Delta::FromMilliseconds(1), 0);
+  EXPECT_EQ(1u, controller_.stats().overloaded_iterations);
+}
+
+TEST_F(QuicHandshakeAdmissionControllerTest, IterationEndWithoutStart) {
+  controller_.OnIterationEnd(0);
+  EXPECT_TRUE(controller_.smoothed_iteration_time().IsZero());
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace quic
@@ -0,0 +1,356 @@
+// Copyright (c) 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "quic/core/quic_io_uring.h"
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <memory>
+
+#include "quic/platform/api/quic_logging.h"
+
+namespace quic {
+
+#if QUIC_HAS_IO_URING
+namespace {
+
+int IoUringSetup(uint32_t entries, io_uring_params* params) {
+  return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+int IoUringEnter(int ring_fd,
+                 uint32_t to_submit,
+                 uint32_t min_complete,
+                 uint32_t flags) {
+  return static_cast<int>(syscall(__NR_io_uring_enter, ring_fd, to_submit,
+                                  min_complete, flags, nullptr, 0));
+}
+
+int IoUringRegister(int ring_fd,
+                    uint32_t opcode,
+                    void* arg,
+                    uint32_t num_args) {
+  return static_cast<int>(
+      syscall(__NR_io_uring_register, ring_fd, opcode, arg, num_args));
+}
+
+template <typename T>
+T* RingPointer(void* ring, uint32_t offset) {
+  return reinterpret_cast<T*>(static_cast<char*>(ring) + offset);
+}
+
+}  // namespace
+#endif  // QUIC_HAS_IO_URING
+
+QuicIoUring::QuicIoUring()
+    : ring_fd_(-1),
+      sq_ring_(nullptr),
+      sq_ring_size_(0),
+      cq_ring_(nullptr),
+      cq_ring_size_(0),
+      sqes_(nullptr),
+      sqes_size_(0),
+      sq_head_(nullptr),
+      sq_tail_(nullptr),
+      sq_mask_(0),
+      sq_entries_(0),
+      sqe_tail_(0),
+      submitted_tail_(0),
+      cq_head_(nullptr),
+      cq_tail_(nullptr),
+      cq_mask_(0),
+      cqes_(nullptr),
+      buffer_ring_(nullptr),
+      buffer_ring_size_(0),
+      buffer_ring_mask_(0),
+      buffer_ring_tail_(0) {}
+
+QuicIoUring::~QuicIoUring() {
+  Cleanup();
+}
+
+#if QUIC_HAS_IO_URING
+
+// static
+bool QuicIoUring::IsSupported() {
+  io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  int fd = IoUringSetup(1, &params);
+  if (fd < 0) {
+    return false;
+  }
+  close(fd);
+  return true;
+}
+
+bool QuicIoUring::Initialize(uint32_t num_sqes, uint32_t num_cqes) {
+  QUICHE_DCHECK(!initialized());
+  io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  params.flags = IORING_SETUP_CQSIZE | IORING_SETUP_CLAMP;
+  params.cq_entries = std::max(num_cqes, num_sqes);
+  ring_fd_ = IoUringSetup(num_sqes, &params);
+  if (ring_fd_ < 0) {
+    QUIC_LOG_FIRST_N(WARNING, 1)
+        << "io_uring_setup failed: " << strerror(errno);
+    return false;
+  }
+
+  sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+  cq_ring_size_ =
+      params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+  const bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+  if (single_mmap) {
+    sq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+    cq_ring_size_ = sq_ring_size_;
+  }
+  sq_ring_ = mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE,
+                  MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQ_RING);
+  if (sq_ring_ == MAP_FAILED) {
+    sq_ring_ = nullptr;
+    QUIC_LOG(ERROR) << "Failed to map io_uring SQ ring: " << strerror(errno);
+    Cleanup();
+    return false;
+  }
+  if (single_mmap) {
+    cq_ring_ = sq_ring_;
+  } else {
+    cq_ring_ = mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE,
+                    MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_CQ_RING);
+    if (cq_ring_ == MAP_FAILED) {
+      cq_ring_ = nullptr;
+      QUIC_LOG(ERROR) << "Failed to map io_uring CQ ring: "
+                      << strerror(errno);
+      Cleanup();
+      return false;
+    }
+  }
+  sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+  void* sqes = mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE,
+                    MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQES);
+  if (sqes == MAP_FAILED) {
+    QUIC_LOG(ERROR) << "Failed to map io_uring SQEs: " << strerror(errno);
+    Cleanup();
+    return false;
+  }
+  sqes_ = static_cast<io_uring_sqe*>(sqes);
+
+  sq_head_ = RingPointer<uint32_t>(sq_ring_, params.sq_off.head);
+  sq_tail_ = RingPointer<uint32_t>(sq_ring_, params.sq_off.tail);
+  sq_mask_ = *RingPointer<uint32_t>(sq_ring_, params.sq_off.ring_mask);
+  sq_entries_ = params.sq_entries;
+  // SQEs are always submitted in order, so the index array is the identity.
+  uint32_t* sq_array = RingPointer<uint32_t>(sq_ring_, params.sq_off.array);
+  for (uint32_t i = 0; i < sq_entries_; ++i) {
+    sq_array[i] = i;
+  }
+  sqe_tail_ = *sq_tail_;
+  submitted_tail_ = sqe_tail_;
+
+  cq_head_ = RingPointer<uint32_t>(cq_ring_, params.cq_off.head);
+  cq_tail_ = RingPointer<uint32_t>(cq_ring_, params.cq_off.tail);
+  cq_mask_ = *RingPointer<uint32_t>(cq_ring_, params.cq_off.ring_mask);
+  cqes_ = RingPointer<io_uring_cqe>(cq_ring_, params.cq_off.cqes);
+  QUIC_DVLOG(1) << "io_uring initialized with " << params.sq_entries
+                << " SQEs and " << params.cq_entries << " CQEs";
+  return true;
+}
+
+bool QuicIoUring::IsOpSupported(uint8_t opcode) const {
+  QUICHE_DCHECK(initialized());
+  // io_uring_probe is followed by one io_uring_probe_op per opcode.
+  const size_t size = sizeof(io_uring_probe) +
+                      (IORING_OP_LAST + 1) * sizeof(io_uring_probe_op);
+  std::unique_ptr<char[]> buffer(new char[size]());
+  io_uring_probe* probe = reinterpret_cast<io_uring_probe*>(buffer.get());
+  if (IoUringRegister(ring_fd_, IORING_REGISTER_PROBE, probe,
+                      IORING_OP_LAST + 1) != 0) {
+    QUIC_LOG_FIRST_N(WARNING, 1)
+        << "Failed to probe io_uring operations: " << strerror(errno);
+    return false;
+  }
+  if (opcode > probe->last_op || opcode >= probe->ops_len) {
+    return false;
+  }
+  return probe->ops[opcode].flags & IO_URING_OP_SUPPORTED;
+}
+
+io_uring_sqe* QuicIoUring::GetSqe() {
+  const uint32_t head = __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE);
+  if (sqe_tail_ - head >= sq_entries_) {
+    return nullptr;
+  }
+  io_uring_sqe* sqe = &sqes_[sqe_tail_ & sq_mask_];
+  ++sqe_tail_;
+  memset(sqe, 0, sizeof(*sqe));
+  return sqe;
+}
+
+int QuicIoUring::Submit(uint32_t min_completions) {
+  const uint32_t to_submit = num_pending_sqes();
+  if (to_submit == 0 && min_completions == 0) {
+    return 0;
+  }
+  __atomic_store_n(sq_tail_, sqe_tail_, __ATOMIC_RELEASE);
+  const int rc =
+      IoUringEnter(ring_fd_, to_submit, min_completions,
+                   min_completions > 0 ? IORING_ENTER_GETEVENTS : 0);
+  if (rc < 0) {
+    return -errno;
+  }
+  submitted_tail_ += rc;
+  return rc;
+}
+
+const io_uring_cqe* QuicIoUring::PeekCqe() const {
+  const uint32_t head = *cq_head_;
+  if (head == __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE)) {
+    return nullptr;
+  }
+  return &cqes_[head & cq_mask_];
+}
+
+void QuicIoUring::ConsumeCqe() {
+  __atomic_store_n(cq_head_, *cq_head_ + 1, __ATOMIC_RELEASE);
+}
+
+bool QuicIoUring::RegisterBufferRing(uint16_t group_id, uint16_t num_buffers) {
+  QUICHE_DCHECK(initialized());
+  QUICHE_DCHECK(buffer_ring_ == nullptr);
+  if (num_buffers == 0 || (num_buffers & (num_buffers - 1)) != 0) {
+    QUIC_LOG(ERROR) << "Buffer ring size must be a power of 2, got "
+                    << num_buffers;
+    return false;
+  }
+  // The buffer ring must be page aligned.
+  const size_t size = num_buffers * sizeof(io_uring_buf);
+  void* ring = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                    MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+  if (ring == MAP_FAILED) {
+    QUIC_LOG(ERROR) << "Failed to map buffer ring: " << strerror(errno);
+    return false;
+  }
+  io_uring_buf_reg reg;
+  memset(&reg, 0, sizeof(reg));
+  reg.ring_addr = reinterpret_cast<uint64_t>(ring);
+  reg.ring_entries = num_buffers;
+  reg.bgid = group_id;
+  if (IoUringRegister(ring_fd_, IORING_REGISTER_PBUF_RING, &reg, 1) != 0) {
+    QUIC_LOG_FIRST_N(WARNING, 1)
+        << "Failed to register buffer ring: " << strerror(errno);
+    munmap(ring, size);
+    return false;
+  }
+  buffer_ring_ = static_cast<io_uring_buf_ring*>(ring);
+  buffer_ring_size_ = size;
+  buffer_ring_mask_ = num_buffers - 1;
+  buffer_ring_tail_ = 0;
+  return true;
+}
+
+void QuicIoUring::AddBuffer(void* buffer, uint32_t length, uint16_t buffer_id) {
+  QUICHE_DCHECK(buffer_ring_ != nullptr);
+  // The entries are indexed from the start of the ring rather than through
+  // |bufs|, whose flexible array wrapper has a non-zero size in C++.  Only
+  // addr, len and bid are written: the ring's tail overlays the reserved field
+  // of the first entry.
+  io_uring_buf* buf = reinterpret_cast<io_uring_buf*>(buffer_ring_) +
+                      (buffer_ring_tail_ & buffer_ring_mask_);
+  buf->addr = reinterpret_cast<uint64_t>(buffer);
+  buf->len = length;
+  buf->bid = buffer_id;
+  ++buffer_ring_tail_;
+}
+
+void QuicIoUring::CommitBuffers() {
+  QUICHE_DCHECK(buffer_ring_ != nullptr);
+  __atomic_store_n(&buffer_ring_->tail, buffer_ring_tail_, __ATOMIC_RELEASE);
+}
+
+#else  // QUIC_HAS_IO_URING
+
+// static
+bool QuicIoUring::IsSupported() {
+  return false;
+}
+
+bool QuicIoUring::Initialize(uint32_t /*num_sqes*/, uint32_t /*num_cqes*/) {
+  QUIC_LOG_FIRST_N(WARNING, 1) << "Built without io_uring support";
+  return false;
+}
+
+// The remaining methods require a successful Initialize().
+
+bool QuicIoUring::IsOpSupported(uint8_t /*opcode*/) const {
+  QUIC_NOTREACHED();
+  return false;
+}
+
+io_uring_sqe* QuicIoUring::GetSqe() {
+  QUIC_NOTREACHED();
+  return nullptr;
+}
+
+int QuicIoUring::Submit(uint32_t /*min_completions*/) {
+  QUIC_NOTREACHED();
+  return -ENOSYS;
+}
+
+const io_uring_cqe* QuicIoUring::PeekCqe() const {
+  QUIC_NOTREACHED();
+  return nullptr;
+}
+
+void QuicIoUring::ConsumeCqe() {
+  QUIC_NOTREACHED();
+}
+
+bool QuicIoUring::RegisterBufferRing(uint16_t /*group_id*/,
+                                     uint16_t /*num_buffers*/) {
+  QUIC_NOTREACHED();
+  return false;
+}
+
+void QuicIoUring::AddBuffer(void* /*buffer*/,
+                            uint32_t /*length*/,
+                            uint16_t /*buffer_id*/) {
+  QUIC_NOTREACHED();
+}
+
+void QuicIoUring::CommitBuffers() {
+  QUIC_NOTREACHED();
+}
+
+#endif  // QUIC_HAS_IO_URING
+
+void QuicIoUring::Cleanup() {
+  // Closing the ring also unregisters the buffer ring.
+  if (ring_fd_ >= 0) {
+    close(ring_fd_);
+    ring_fd_ = -1;
+  }
+  if (buffer_ring_ != nullptr) {
+    munmap(buffer_ring_, buffer_ring_size_);
+    buffer_ring_ = nullptr;
+  }
+  if (sqes_ != nullptr) {
+    munmap(sqes_, sqes_size_);
+    sqes_ = nullptr;
+  }
+  if (cq_ring_ != nullptr && cq_ring_ != sq_ring_) {
+    munmap(cq_ring_, cq_ring_size_);
+  }
+  cq_ring_ = nullptr;
+  if (sq_ring_ != nullptr) {
+    munmap(sq_ring_, sq_ring_size_);
+    sq_ring_ = nullptr;
+  }
+}
+
+}  // namespace quic
@@ -0,0 +1,132 @@
+// Copyright (c) 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef QUICHE_QUIC_CORE_QUIC_IO_URING_H_
+#define QUICHE_QUIC_CORE_QUIC_IO_URING_H_
+
+#if defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#endif
+#endif
+
+#include <cstddef>
+#include <cstdint>
+
+#include "quic/platform/api/quic_export.h"
+
+// QuicIoUring relies on provided buffer rings (Linux 5.19) and on multishot
+// receives filling in io_uring_recvmsg_out (Linux 6.0).  Neither is a macro,
+// so the headers are detected by IORING_RECV_MULTISHOT, which came with the
+// latter.  Without them, QuicIoUring is never supported and its users fall
+// back to recvmmsg() and sendmsg().
+#if defined(IORING_RECV_MULTISHOT)
+#define QUIC_HAS_IO_URING 1
+#else
+#define QUIC_HAS_IO_URING 0
+struct io_uring_sqe;
+struct io_uring_cqe;
+struct io_uring_buf_ring;
+#endif
+
+namespace quic {
+
+// QuicIoUring is a minimal wrapper of a Linux io_uring instance, implemented
+// with the raw system calls.  Submission queue entries (SQEs) are filled in
+// place and submitted in batches by Submit(), and completion queue entries
+// (CQEs) are reaped from the shared ring without any system call.
+//
+// It also manages at most one provided buffer ring, from which the kernel
+// picks receive buffers for SQEs that set IOSQE_BUFFER_SELECT.
+//
+// The ring fd becomes readable when CQEs are available, so it can be
+// registered with an epoll based event loop.  This class is not thread-safe.
+class QUIC_EXPORT_PRIVATE QuicIoUring {
+ public:
+  QuicIoUring();
+  QuicIoUring(const QuicIoUring&) = delete;
+  QuicIoUring& operator=(const QuicIoUring&) = delete;
+  ~QuicIoUring();
+
+  // Whether the kernel supports io_uring.  Always false if QuicIoUring was
+  // built without io_uring headers.
+  static bool IsSupported();
+
+  // Sets up the ring with room for at least |num_sqes| SQEs and |num_cqes|
+  // CQEs.  Returns false on failure, e.g. if io_uring is not supported or is
+  // disabled.
+  bool Initialize(uint32_t num_sqes, uint32_t num_cqes);
+
+  bool initialized() const { return ring_fd_ >= 0; }
+
+  // Whether the kernel supports |opcode|, as reported by
+  // IORING_REGISTER_PROBE.  Flags of the operation, such as multishot
+  // receives, are not probed.
+  bool IsOpSupported(uint8_t opcode) const;
+  int ring_fd() const { return ring_fd_; }
+
+  // Returns a zeroed SQE which is submitted by the next Submit(), or nullptr
+  // if the submission queue is full.
+  io_uring_sqe* GetSqe();
+
+  // Number of SQEs returned by GetSqe() that have not been submitted.
+  uint32_t num_pending_sqes() const { return sqe_tail_ - submitted_tail_; }
+
+  // Submits all pending SQEs, and waits for at least |min_completions| CQEs.
+  // Returns the number of SQEs submitted, or -errno on failure.
+  int Submit(uint32_t min_completions = 0);
+
+  // Returns the oldest unconsumed CQE, or nullptr if there is none.  Each CQE
+  // must be consumed with ConsumeCqe() once handled.
+  const io_uring_cqe* PeekCqe() const;
+  void ConsumeCqe();
+
+  // Registers a provided buffer ring with |num_buffers| entries, which must be
+  // a power of 2, as buffer group |group_id|.  The ring is initially empty.
+  bool RegisterBufferRing(uint16_t group_id, uint16_t num_buffers);
+
+  // Makes |buffer| available to the kernel as buffer |buffer_id| of the
+  // registered buffer group.  Buffers become visible to the kernel once
+  // CommitBuffers() is called.
+  void AddBuffer(void* buffer, uint32_t length, uint16_t buffer_id);
+  void CommitBuffers();
+
+ private:
+  void Cleanup();
+
+  int ring_fd_;
+
+  // Mapped rings.
+  void* sq_ring_;
+  size_t sq_ring_size_;
+  void* cq_ring_;
+  size_t cq_ring_size_;
+  io_uring_sqe* sqes_;
+  size_t sqes_size_;
+
+  // Pointers into the submission queue ring.
+  uint32_t* sq_head_;
+  uint32_t* sq_tail_;
+  uint32_t sq_mask_;
+  uint32_t sq_entries_;
+  // Tail of the SQEs handed out by GetSqe(), and of those submitted.
+  uint32_t sqe_tail_;
+  uint32_t submitted_tail_;
+
+  // Pointers into the completion queue ring.
+  uint32_t* cq_head_;
+  uint32_t* cq_tail_;
+  uint32_t cq_mask_;
+  io_uring_cqe* cqes_;
+
+  // The provided buffer ring, if registered.
+  io_uring_buf_ring* buffer_ring_;
+  size_t buffer_ring_size_;
+  uint16_t buffer_ring_mask_;
+  uint16_t buffer_ring_tail_;
+};
+
+}  // namespace quic
+
+#endif  // QUICHE_QUIC_CORE_QUIC_IO_URING_H_
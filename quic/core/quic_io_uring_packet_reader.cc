@@ -0,0 +1,236 @@
+// Copyright (c) 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "quic/core/quic_io_uring_packet_reader.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include "quic/platform/api/quic_bug_tracker.h"
+#include "quic/platform/api/quic_logging.h"
+#include "quic/platform/api/quic_server_stats.h"
+
+namespace quic {
+
+namespace {
+
+const size_t kNameSize = sizeof(sockaddr_storage);
+
+#if QUIC_HAS_IO_URING
+const uint16_t kBufferGroupId = 0;
+
+// Layout of a receive buffer: an io_uring_recvmsg_out header, followed by the
+// peer address, the control messages and the payload.  Buffers are rounded up
+// to cache lines, which also keeps the cmsgs aligned.
+const size_t kReceiveBufferSize =
+    (sizeof(io_uring_recvmsg_out) + kNameSize +
+     kDefaultUdpPacketControlBufferSize + kMaxIncomingPacketSize + 63) /
+    64 * 64;
+#endif
+
+}  // namespace
+
+QuicIoUringPacketReader::QuicIoUringPacketReader()
+    : fd_(-1),
+      receive_armed_(false),
+      receive_failed_(false),
+      num_receives_armed_(0) {
+  memset(&receive_msghdr_, 0, sizeof(receive_msghdr_));
+  receive_msghdr_.msg_namelen = kNameSize;
+  receive_msghdr_.msg_controllen = kDefaultUdpPacketControlBufferSize;
+}
+
+QuicIoUringPacketReader::~QuicIoUringPacketReader() = default;
+
+#if QUIC_HAS_IO_URING
+
+bool QuicIoUringPacketReader::Initialize(int fd) {
+  QUICHE_DCHECK(!ring_.initialized());
+  // Each packet is a completion, leave room for a full buffer ring.
+  if (!ring_.Initialize(/*num_sqes=*/4, /*num_cqes=*/2 * kNumReceiveBuffers) ||
+      !ring_.IsOpSupported(IORING_OP_RECVMSG) ||
+      !ring_.RegisterBufferRing(kBufferGroupId, kNumReceiveBuffers)) {
+    return false;
+  }
+  fd_ = fd;
+  receive_buffers_ =
+      std::make_unique<char[]>(kNumReceiveBuffers * kReceiveBufferSize);
+  for (uint16_t i = 0; i < kNumReceiveBuffers; ++i) {
+    ring_.AddBuffer(receive_buffer(i), kReceiveBufferSize, i);
+  }
+  ring_.CommitBuffers();
+  ArmReceive();
+  if (receive_failed_) {
+    return false;
+  }
+  // The probe does not cover IORING_RECV_MULTISHOT.  Kernels before 6.0
+  // reject it when the receive is submitted, and that error completion is
+  // posted before io_uring_enter() returns, so it is already visible here.
+  // An accepted receive posts nothing until a packet arrives.
+  const io_uring_cqe* cqe = ring_.PeekCqe();
+  if (cqe != nullptr && cqe->res < 0 && !(cqe->flags & IORING_CQE_F_MORE)) {
+    QUIC_LOG_FIRST_N(WARNING, 1)
+        << "Multishot receive not supported: " << strerror(-cqe->res);
+    ring_.ConsumeCqe();
+    receive_armed_ = false;
+    receive_failed_ = true;
+    return false;
+  }
+  return true;
+}
+
+bool QuicIoUringPacketReader::ReadAndDispatchPackets(
+    int fd,
+    int port,
+    const QuicClock& clock,
+    ProcessPacketInterface* processor,
+    QuicPacketCount* /*packets_dropped*/) {
+  QUICHE_DCHECK_EQ(fd, fd_);
+  QuicTime now = clock.Now();
+
+  int packets_read = 0;
+  while (packets_read < kNumPacketsPerReadMmsgCall) {
+    const io_uring_cqe* cqe = ring_.PeekCqe();
+    if (cqe == nullptr) {
+      break;
+    }
+    const int res = cqe->res;
+    const uint32_t flags = cqe->flags;
+    ring_.ConsumeCqe();
+
+    if (!(flags & IORING_CQE_F_MORE)) {
+      // The multishot receive terminated, e.g. because the buffer ring ran
+      // empty.  It is armed again below.
+      receive_armed_ = false;
+    }
+    if (res < 0) {
+      if (res == -EINVAL || res == -EOPNOTSUPP) {
+        QUIC_LOG_FIRST_N(ERROR, 1)
+            << "Multishot receive not supported: " << strerror(-res);
+        receive_failed_ = true;
+      } else if (res != -ENOBUFS) {
+        QUIC_LOG_FIRST_N(ERROR, 100)
+            << "Error reading packets: " << strerror(-res);
+      }
+      continue;
+    }
+    if (!(flags & IORING_CQE_F_BUFFER)) {
+      QUIC_BUG(quic_bug_12976_1) << "Receive completion without a buffer";
+      continue;
+    }
+    const uint16_t buffer_id = flags >> IORING_CQE_BUFFER_SHIFT;
+    ++packets_read;
+    DispatchReceiveBuffer(buffer_id, static_cast<uint32_t>(res), now, port,
+                          processor);
+    ring_.AddBuffer(receive_buffer(buffer_id), kReceiveBufferSize, buffer_id);
+  }
+  if (packets_read > 0) {
+    ring_.CommitBuffers();
+  }
+  if (!receive_armed_ && !receive_failed_) {
+    ArmReceive();
+  }
+
+  return ring_.PeekCqe() != nullptr;
+}
+
+char* QuicIoUringPacketReader::receive_buffer(uint16_t buffer_id) {
+  return receive_buffers_.get() + buffer_id * kReceiveBufferSize;
+}
+
+void QuicIoUringPacketReader::ArmReceive() {
+  io_uring_sqe* sqe = ring_.GetSqe();
+  if (sqe == nullptr) {
+    QUIC_BUG(quic_bug_12976_2) << "io_uring submission queue full";
+    receive_failed_ = true;
+    return;
+  }
+  sqe->opcode = IORING_OP_RECVMSG;
+  sqe->fd = fd_;
+  sqe->addr = reinterpret_cast<uint64_t>(&receive_msghdr_);
+  sqe->len = 1;
+  sqe->ioprio = IORING_RECV_MULTISHOT;
+  sqe->flags = IOSQE_BUFFER_SELECT;
+  sqe->buf_group = kBufferGroupId;
+  const int rc = ring_.Submit();
+  if (rc < 0) {
+    // Without an armed receive the ring fd never becomes readable again, so
+    // the owner has to read the socket some other way.
+    QUIC_LOG_FIRST_N(ERROR, 10)
+        << "Failed to submit io_uring receive: " << strerror(-rc);
+    receive_failed_ = true;
+    return;
+  }
+  receive_armed_ = true;
+  ++num_receives_armed_;
+}
+
+void QuicIoUringPacketReader::DispatchReceiveBuffer(
+    uint16_t buffer_id,
+    uint32_t length,
+    QuicTime now,
+    int port,
+    ProcessPacketInterface* processor) {
+  char* buffer = receive_buffer(buffer_id);
+  if (length < sizeof(io_uring_recvmsg_out) + kNameSize +
+                   kDefaultUdpPacketControlBufferSize) {
+    QUIC_BUG(quic_bug_12976_3) << "Receive buffer too short: " << length;
+    return;
+  }
+  const io_uring_recvmsg_out* out =
+      reinterpret_cast<const io_uring_recvmsg_out*>(buffer);
+  char* name = buffer + sizeof(io_uring_recvmsg_out);
+  char* control = name + kNameSize;
+  char* payload = control + kDefaultUdpPacketControlBufferSize;
+
+  if (QUIC_PREDICT_FALSE(out->flags & MSG_CTRUNC)) {
+    QUIC_BUG(quic_bug_12976_4) << "Control buffer too small. size:"
+                               << kDefaultUdpPacketControlBufferSize;
+    return;
+  }
+  if (QUIC_PREDICT_FALSE(out->flags & MSG_TRUNC)) {
+    QUIC_LOG_FIRST_N(WARNING, 100)
+        << "Received truncated QUIC packet: buffer size:"
+        << kMaxIncomingPacketSize << " packet size:" << out->payloadlen;
+    return;
+  }
+
+  sockaddr_storage peer_address;
+  memset(&peer_address, 0, sizeof(peer_address));
+  memcpy(&peer_address, name, std::min<size_t>(out->namelen, kNameSize));
+  msghdr hdr;
+  memset(&hdr, 0, sizeof(hdr));
+  hdr.msg_name = &peer_address;
+  hdr.msg_namelen = out->namelen;
+  hdr.msg_control = control;
+  hdr.msg_controllen = out->controllen;
+
+  QuicUdpPacketInfo packet_info;
+  QuicUdpSocketApi::PopulatePacketInfoFromMsgHdr(&hdr, PacketInfoInterested(),
+                                                 &packet_info);
+  DispatchPacket(BufferSpan(payload, out->payloadlen), packet_info, now, port,
+                 processor);
+}
+
+#else  // QUIC_HAS_IO_URING
+
+bool QuicIoUringPacketReader::Initialize(int /*fd*/) {
+  QUIC_LOG_FIRST_N(WARNING, 1) << "Built without io_uring support";
+  return false;
+}
+
+bool QuicIoUringPacketReader::ReadAndDispatchPackets(
+    int /*fd*/,
+    int /*port*/,
+    const QuicClock& /*clock*/,
+    ProcessPacketInterface* /*processor*/,
+    QuicPacketCount* /*packets_dropped*/) {
+  QUIC_NOTREACHED();
+  return false;
+}
+
+#endif  // QUIC_HAS_IO_URING
+
+}  // namespace quic
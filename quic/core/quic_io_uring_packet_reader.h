@@ -0,0 +1,94 @@
+// Copyright (c) 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef QUICHE_QUIC_CORE_QUIC_IO_URING_PACKET_READER_H_
+#define QUICHE_QUIC_CORE_QUIC_IO_URING_PACKET_READER_H_
+
+#include <sys/socket.h>
+
+#include <cstdint>
+#include <memory>
+
+#include "quic/core/quic_io_uring.h"
+#include "quic/core/quic_packet_reader.h"
+
+namespace quic {
+
+// QuicIoUringPacketReader is a QuicPacketReader which receives packets with a
+// single multishot IORING_OP_RECVMSG, instead of calling recvmmsg() on every
+// read event.  The kernel picks a receive buffer for each packet from a
+// provided buffer ring, and posts a completion which ReadAndDispatchPackets()
+// dispatches without any system call.  Buffers are returned to the ring once
+// the packet has been processed.
+//
+// The owner must register ring_fd() with its event loop instead of the
+// socket, and call ReadAndDispatchPackets() when it becomes readable.
+// Requires Linux 6.0 or later.  The multishot receive is canceled if the
+// thread which called Initialize() exits, so the reader should be initialized
+// on a thread that outlives it, normally the event loop thread.
+class QUIC_EXPORT_PRIVATE QuicIoUringPacketReader : public QuicPacketReader {
+ public:
+  // Number of receive buffers, which bounds the number of packets received
+  // but not yet dispatched.
+  static constexpr uint16_t kNumReceiveBuffers = 256;
+
+  QuicIoUringPacketReader();
+  ~QuicIoUringPacketReader() override;
+
+  // Sets up io_uring to receive from |fd|.  Returns false if io_uring,
+  // provided buffer rings or multishot receives are unavailable, in which
+  // case the reader must not be used.
+  bool Initialize(int fd);
+
+  // The fd of the io_uring instance, which is readable when packets have been
+  // received.
+  int ring_fd() const { return ring_.ring_fd(); }
+
+  // Dispatches up to kNumPacketsPerReadMmsgCall received packets.  |fd| must
+  // be the fd passed to Initialize().
+  bool ReadAndDispatchPackets(int fd,
+                              int port,
+                              const QuicClock& clock,
+                              ProcessPacketInterface* processor,
+                              QuicPacketCount* packets_dropped) override;
+
+  // Number of times the multishot receive was armed.
+  uint64_t num_receives_armed() const { return num_receives_armed_; }
+
+  // Whether the multishot receive failed and will not be armed again.  The
+  // owner must then read |fd| with another reader, e.g. QuicPacketReader.
+  bool receive_failed() const { return receive_failed_; }
+
+ private:
+  // Returns the start of receive buffer |buffer_id|.
+  char* receive_buffer(uint16_t buffer_id);
+
+  // Queues and submits the multishot receive.
+  void ArmReceive();
+
+  // Parses and dispatches the packet of |length| bytes in buffer |buffer_id|.
+  void DispatchReceiveBuffer(uint16_t buffer_id,
+                             uint32_t length,
+                             QuicTime now,
+                             int port,
+                             ProcessPacketInterface* processor);
+
+  int fd_;
+  bool receive_armed_;
+  // Set if the kernel does not support multishot receives, or the receive
+  // could not be submitted.
+  bool receive_failed_;
+  uint64_t num_receives_armed_;
+  // Template for the multishot receive, only msg_namelen and msg_controllen
+  // are used.
+  msghdr receive_msghdr_;
+  std::unique_ptr<char[]> receive_buffers_;
+  // Declared after |receive_buffers_|, so that the ring is torn down before
+  // the buffers are freed.
+  QuicIoUring ring_;
+};
+
+}  // namespace quic
+
+#endif  // QUICHE_QUIC_CORE_QUIC_IO_URING_PACKET_READER_H_
@@ -0,0 +1,171 @@
+// Copyright (c) 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "quic/core/quic_io_uring_packet_reader.h"
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+#include "quic/core/quic_udp_socket.h"
+#include "quic/platform/api/quic_test.h"
+#include "quic/test_tools/mock_clock.h"
+
+namespace quic {
+namespace test {
+namespace {
+
+class RecordingPacketProcessor : public ProcessPacketInterface {
+ public:
+  void ProcessPacket(const QuicSocketAddress& self_address,
+                     const QuicSocketAddress& peer_address,
+                     const QuicReceivedPacket& packet) override {
+    self_addresses.push_back(self_address);
+    peer_addresses.push_back(peer_address);
+    payloads.push_back(std::string(packet.data(), packet.length()));
+  }
+
+  std::vector<QuicSocketAddress> self_addresses;
+  std::vector<QuicSocketAddress> peer_addresses;
+  std::vector<std::string> payloads;
+};
+
+class QuicIoUringPacketReaderTest : public QuicTest {
+ protected:
+  ~QuicIoUringPacketReaderTest() override {
+    reader_.reset();
+    for (int fd : {reader_fd_, sender_fd_}) {
+      if (fd >= 0) {
+        close(fd);
+      }
+    }
+  }
+
+  // Returns false if io_uring is not supported.
+  bool Initialize() {
+    if (!QuicIoUring::IsSupported()) {
+      QUIC_LOG(WARNING) << "Test skipped since io_uring is not supported.";
+      return false;
+    }
+    reader_fd_ = CreateSocket(&reader_address_);
+    sender_fd_ = CreateSocket(&sender_address_);
+    reader_ = std::make_unique<QuicIoUringPacketReader>();
+    EXPECT_TRUE(reader_->Initialize(reader_fd_));
+    return true;
+  }
+
+  int CreateSocket(QuicSocketAddress* address) {
+    QuicUdpSocketApi socket_api;
+    int fd = socket_api.Create(AF_INET, kDefaultSocketReceiveBuffer,
+                               kDefaultSocketReceiveBuffer);
+    EXPECT_GE(fd, 0);
+    EXPECT_TRUE(
+        socket_api.Bind(fd, QuicSocketAddress(QuicIpAddress::Loopback4(), 0)));
+    EXPECT_EQ(0, address->FromSocket(fd));
+    return fd;
+  }
+
+  void SendPacket(const std::string& payload) {
+    sockaddr_storage address = reader_address_.generic_address();
+    EXPECT_EQ(static_cast<ssize_t>(payload.size()),
+              sendto(sender_fd_, payload.data(), payload.size(), 0,
+                     reinterpret_cast<sockaddr*>(&address),
+                     sizeof(sockaddr_in)));
+  }
+
+  // Reads until |num_packets| packets have been dispatched.
+  void ReadPackets(size_t num_packets) {
+    for (int i = 0; i < 1000 && processor_.payloads.size() < num_packets;
+         ++i) {
+      if (!reader_->ReadAndDispatchPackets(reader_fd_, reader_address_.port(),
+                                           clock_, &processor_, nullptr)) {
+        usleep(1000);
+      }
+    }
+    ASSERT_EQ(num_packets, processor_.payloads.size());
+  }
+
+  MockClock clock_;
+  RecordingPacketProcessor processor_;
+  QuicSocketAddress reader_address_;
+  QuicSocketAddress sender_address_;
+  int reader_fd_ = -1;
+  int sender_fd_ = -1;
+  std::unique_ptr<QuicIoUringPacketReader> reader_;
+};
+
+TEST_F(QuicIoUringPacketReaderTest, ReadPackets) {
+  if (!Initialize()) {
+    return;
+  }
+
+  SendPacket("first");
+  SendPacket("second");
+  ReadPackets(2);
+  EXPECT_EQ("first", processor_.payloads[0]);
+  EXPECT_EQ("second", processor_.payloads[1]);
+  EXPECT_EQ(sender_address_, processor_.peer_addresses[0]);
+  EXPECT_EQ(reader_address_, processor_.self_addresses[0]);
+  EXPECT_EQ(1u, reader_->num_receives_armed());
+}
+
+TEST_F(QuicIoUringPacketReaderTest, BuffersReused) {
+  if (!Initialize()) {
+    return;
+  }
+
+  const size_t kNumPackets = 4 * QuicIoUringPacketReader::kNumReceiveBuffers;
+  for (size_t i = 0; i < kNumPackets; ++i) {
+    SendPacket(std::to_string(i));
+    if (i % 100 == 99) {
+      ReadPackets(i + 1);
+    }
+  }
+  ReadPackets(kNumPackets);
+  for (size_t i = 0; i < kNumPackets; ++i) {
+    EXPECT_EQ(std::to_string(i), processor_.payloads[i]);
+  }
+}
+
+TEST_F(QuicIoUringPacketReaderTest, RearmedWhenOutOfBuffers) {
+  if (!Initialize()) {
+    return;
+  }
+
+  // Packets which arrive while all buffers are in use stay in the socket, and
+  // are received once the receive is armed again.
+  const size_t kNumPackets = QuicIoUringPacketReader::kNumReceiveBuffers + 10;
+  for (size_t i = 0; i < kNumPackets; ++i) {
+    SendPacket(std::to_string(i));
+  }
+  ReadPackets(kNumPackets);
+  EXPECT_LT(1u, reader_->num_receives_armed());
+  for (size_t i = 0; i < kNumPackets; ++i) {
+    EXPECT_EQ(std::to_string(i), processor_.payloads[i]);
+  }
+}
+
+TEST_F(QuicIoUringPacketReaderTest, InitializeFailsIfReceiveRejected) {
+  if (!QuicIoUring::IsSupported()) {
+    QUIC_LOG(WARNING) << "Test skipped since io_uring is not supported.";
+    return;
+  }
+
+  // A receive from a pipe fails as soon as it is submitted, like a multishot
+  // receive on a kernel which does not support it.
+  int pipe_fds[2];
+  ASSERT_EQ(0, pipe(pipe_fds));
+  reader_ = std::make_unique<QuicIoUringPacketReader>();
+  EXPECT_FALSE(reader_->Initialize(pipe_fds[0]));
+  EXPECT_TRUE(reader_->receive_failed());
+  reader_.reset();
+  close(pipe_fds[0]);
+  close(pipe_fds[1]);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace quic
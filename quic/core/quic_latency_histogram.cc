@@ -0,0 +1,76 @@
+// Copyright (c) 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "quic/core/quic_latency_histogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace quic {
+
+void QuicLatencyHistogram::Merge(const QuicLatencyHistogram& other) {
+  for (size_t i = 0; i < kNumBuckets; ++i) {
+    counts_[i] += other.counts_[i];
+  }
+  total_count_ += other.total_count_;
+  sum_us_ += other.sum_us_;
+  min_us_ = std::min(min_us_, other.min_us_);
+  max_us_ = std::max(max_us_, other.max_us_);
+}
+
+void QuicLatencyHistogram::Clear() {
+  *this = QuicLatencyHistogram();
+}
+
+QuicTime::Delta QuicLatencyHistogram::Percentile(double percentile) const {
+  if (total_count_ == 0) {
+    return QuicTime::Delta::Zero();
+  }
+  percentile = std::min(std::max(percentile, 0.0), 100.0);
+  const double rank =
+      std::ceil(percentile / 100.0 * static_cast<double>(total_count_));
+  const uint64_t target = std::max<uint64_t>(1, static_cast<uint64_t>(rank));
+  uint64_t seen = 0;
+  for (size_t i = 0; i < kNumBuckets; ++i) {
+    seen += counts_[i];
+    if (seen < target) {
+      continue;
+    }
+    // Report the largest value in the bucket, clamped to the observed range.
+    const uint64_t upper = i + 1 < kNumBuckets ? BucketLowerBound(i + 1) - 1
+                                               : max_us_;
+    return QuicTime::Delta::FromMicroseconds(
+        std::min(std::max(upper, min_us_), max_us_));
+  }
+  return max();
+}
+
+QuicTime::Delta QuicLatencyHistogram::Mean() const {
+  if (total_count_ == 0) {
+    return QuicTime::Delta::Zero();
+  }
+  return QuicTime::Delta::FromMicroseconds(sum_us_ / total_count_);
+}
+
+// static
+uint64_t QuicLatencyHistogram::BucketLowerBound(size_t index) {
+  if (index < kSubBucketCount) {
+    return index;
+  }
+  const size_t exponent = (index - kSubBucketCount) / kSubBucketCount;
+  const uint64_t sub_bucket = (index - kSubBucketCount) % kSubBucketCount;
+  return (kSubBucketCount + sub_bucket) << exponent;
+}
+
+std::ostream& operator<<(std::ostream& os,
+                         const QuicLatencyHistogram& histogram) {
+  os << "{ count: " << histogram.total_count() << " min: " << histogram.min()
+     << " mean: " << histogram.Mean()
+     << " p50: " << histogram.Percentile(50)
+     << " p99: " << histogram.Percentile(99) << " max: " << histogram.max()
+     << " }";
+  return os;
+}
+
+}  // namespace quic
@@ -0,0 +1,114 @@
+// Copyright (c) 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef QUICHE_QUIC_CORE_QUIC_LATENCY_HISTOGRAM_H_
+#define QUICHE_QUIC_CORE_QUIC_LATENCY_HISTOGRAM_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <ostream>
+
+#include "absl/numeric/bits.h"
+#include "quic/core/quic_time.h"
+#include "quic/platform/api/quic_export.h"
+
+namespace quic {
+
+// A fixed-memory log-linear histogram of durations, in the spirit of HDR
+// histograms.  Durations are recorded in microseconds.  Values below
+// 2^kSubBucketBits are recorded exactly; every larger power-of-two range is
+// split into 2^kSubBucketBits linear sub-buckets, which bounds the relative
+// error of reported percentiles to 2^-kSubBucketBits (12.5%).  Values of
+// 2^kMaxValueBits microseconds (about 67 seconds) or more fall into the last
+// bucket.  Adding a sample costs a count-leading-zeros and a few increments.
+class QUIC_EXPORT_PRIVATE QuicLatencyHistogram {
+ public:
+  static constexpr int kSubBucketBits = 3;
+  static constexpr int kMaxValueBits = 26;
+  static constexpr size_t kSubBucketCount = size_t{1} << kSubBucketBits;
+  static constexpr size_t kNumBuckets =
+      kSubBucketCount + (kMaxValueBits - kSubBucketBits) * kSubBucketCount;
+
+  // Records |sample|.  Negative samples are recorded as zero.
+  void Add(QuicTime::Delta sample) {
+    const int64_t sample_us = sample.ToMicroseconds();
+    const uint64_t value = sample_us < 0 ? 0 : static_cast<uint64_t>(sample_us);
+    ++counts_[BucketIndex(value)];
+    ++total_count_;
+    sum_us_ += value < kMaxValue ? value : kMaxValue;
+    if (value < min_us_) {
+      min_us_ = value;
+    }
+    if (value > max_us_) {
+      max_us_ = value;
+    }
+  }
+
+  // Adds all samples recorded in |other| to this histogram.
+  void Merge(const QuicLatencyHistogram& other);
+
+  // Removes all samples.
+  void Clear();
+
+  // Returns the smallest duration such that at least |percentile| percent of
+  // the samples are less than or equal to it, up to the bucket precision.
+  // Returns zero if the histogram is empty.
+  QuicTime::Delta Percentile(double percentile) const;
+
+  // Returns the mean of all samples, or zero if the histogram is empty.
+  QuicTime::Delta Mean() const;
+
+  QuicTime::Delta min() const {
+    return total_count_ == 0 ? QuicTime::Delta::Zero()
+                             : QuicTime::Delta::FromMicroseconds(min_us_);
+  }
+  QuicTime::Delta max() const {
+    return QuicTime::Delta::FromMicroseconds(max_us_);
+  }
+  uint64_t total_count() const { return total_count_; }
+  bool empty() const { return total_count_ == 0; }
+
+  uint32_t count_in_bucket(size_t index) const { return counts_[index]; }
+
+  // Returns the index of the bucket |value_us| falls into.
+  static size_t BucketIndex(uint64_t value_us) {
+    if (value_us < kSubBucketCount) {
+      return static_cast<size_t>(value_us);
+    }
+    if (value_us >= kMaxValue) {
+      return kNumBuckets - 1;
+    }
+    // Position of the most significant bit, at least kSubBucketBits.
+    const int msb = 63 - absl::countl_zero(value_us);
+    const size_t sub_bucket =
+        static_cast<size_t>(value_us >> (msb - kSubBucketBits)) &
+        (kSubBucketCount - 1);
+    return kSubBucketCount + (msb - kSubBucketBits) * kSubBucketCount +
+           sub_bucket;
+  }
+
+  // Returns the smallest value, in microseconds, that falls into bucket
+  // |index|.
+  static uint64_t BucketLowerBound(size_t index);
+
+ private:
+  static constexpr uint64_t kMaxValue = uint64_t{1} << kMaxValueBits;
+
+  std::array<uint32_t, kNumBuckets> counts_{};
+  uint64_t total_count_ = 0;
+  // Sum of all samples, with each sample capped at kMaxValue.
+  uint64_t sum_us_ = 0;
+  uint64_t min_us_ = std::numeric_limits<uint64_t>::max();
+  uint64_t max_us_ = 0;
+};
+
+QUIC_EXPORT_PRIVATE std::ostream& operator<<(
+    std::ostream& os,
+    const QuicLatencyHistogram& histogram);
+
+}  // namespace quic
+
+#endif  // QUICHE_QUIC_CORE_QUIC_LATENCY_HISTOGRAM_H_
@@ -0,0 +1,140 @@
+// Copyright (c) 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "quic/core/quic_latency_histogram.h"
+
+#include "quic/core/quic_connection_stats.h"
+#include "quic/platform/api/quic_test.h"
+
+namespace quic {
+namespace test {
+namespace {
+
+QuicTime::Delta Us(int64_t us) {
+  return QuicTime::Delta::FromMicroseconds(us);
+}
+
+class QuicLatencyHistogramTest : public QuicTest {
+ protected:
+  QuicLatencyHistogram histogram_;
+};
+
+TEST_F(QuicLatencyHistogramTest, Empty) {
+  EXPECT_TRUE(histogram_.empty());
+  EXPECT_EQ(0u, histogram_.total_count());
+  EXPECT_EQ(QuicTime::Delta::Zero(), histogram_.min());
+  EXPECT_EQ(QuicTime::Delta::Zero(), histogram_.max());
+  EXPECT_EQ(QuicTime::Delta::Zero(), histogram_.Mean());
+  EXPECT_EQ(QuicTime::Delta::Zero(), histogram_.Percentile(50));
+}
+
+TEST_F(QuicLatencyHistogramTest, BucketBoundaries) {
+  // Small values map to their own bucket.
+  for (uint64_t value = 0; value < QuicLatencyHistogram::kSubBucketCount;
+       ++value) {
+    EXPECT_EQ(value, QuicLatencyHistogram::BucketIndex(value));
+    EXPECT_EQ(value, QuicLatencyHistogram::BucketLowerBound(value));
+  }
+  // Every bucket's lower bound maps back to that bucket, and the value just
+  // below it maps to the previous bucket.
+  for (size_t index = 1; index < QuicLatencyHistogram::kNumBuckets; ++index) {
+    const uint64_t lower_bound = QuicLatencyHistogram::BucketLowerBound(index);
+    EXPECT_EQ(index, QuicLatencyHistogram::BucketIndex(lower_bound));
+    EXPECT_EQ(index - 1, QuicLatencyHistogram::BucketIndex(lower_bound - 1));
+  }
+  // Values beyond the range saturate.
+  EXPECT_EQ(QuicLatencyHistogram::kNumBuckets - 1,
+            QuicLatencyHistogram::BucketIndex(uint64_t{1} << 40));
+}
+
+TEST_F(QuicLatencyHistogramTest, RelativeError) {
+  for (uint64_t value = 1; value < (uint64_t{1} << 24); value = value * 3 + 1) {
+    const uint64_t lower_bound = QuicLatencyHistogram::BucketLowerBound(
+        QuicLatencyHistogram::BucketIndex(value));
+    EXPECT_LE(lower_bound, value);
+    EXPECT_LE(static_cast<double>(value - lower_bound),
+              value / static_cast<double>(
+                          QuicLatencyHistogram::kSubBucketCount));
+  }
+}
+
+TEST_F(QuicLatencyHistogramTest, Percentiles) {
+  for (int i = 1; i <= 100; ++i) {
+    histogram_.Add(QuicTime::Delta::FromMilliseconds(i));
+  }
+  EXPECT_EQ(100u, histogram_.total_count());
+  EXPECT_EQ(QuicTime::Delta::FromMilliseconds(1), histogram_.min());
+  EXPECT_EQ(QuicTime::Delta::FromMilliseconds(100), histogram_.max());
+  EXPECT_EQ(Us(50500), histogram_.Mean());
+
+  // Percentiles are accurate to the bucket precision.
+  const QuicTime::Delta p50 = histogram_.Percentile(50);
+  EXPECT_LE(QuicTime::Delta::FromMilliseconds(50), p50);
+  EXPECT_GE(QuicTime::Delta::FromMilliseconds(57), p50);
+  const QuicTime::Delta p99 = histogram_.Percentile(99);
+  EXPECT_LE(QuicTime::Delta::FromMilliseconds(99), p99);
+  EXPECT_GE(QuicTime::Delta::FromMilliseconds(100), p99);
+  EXPECT_EQ(QuicTime::Delta::FromMilliseconds(100), histogram_.Percentile(100));
+  const QuicTime::Delta p0 = histogram_.Percentile(0);
+  EXPECT_LE(QuicTime::Delta::FromMilliseconds(1), p0);
+  EXPECT_GE(Us(1125), p0);
+}
+
+TEST_F(QuicLatencyHistogramTest, NegativeAndInfiniteSamples) {
+  histogram_.Add(Us(-5));
+  histogram_.Add(QuicTime::Delta::Infinite());
+  EXPECT_EQ(2u, histogram_.total_count());
+  EXPECT_EQ(1u, histogram_.count_in_bucket(0));
+  EXPECT_EQ(1u, histogram_.count_in_bucket(
+                    QuicLatencyHistogram::kNumBuckets - 1));
+  EXPECT_EQ(QuicTime::Delta::Zero(), histogram_.min());
+}
+
+TEST_F(QuicLatencyHistogramTest, Merge) {
+  QuicLatencyHistogram other;
+  histogram_.Add(Us(10));
+  histogram_.Add(Us(20));
+  other.Add(Us(5));
+  other.Add(Us(1000));
+
+  histogram_.Merge(other);
+  EXPECT_EQ(4u, histogram_.total_count());
+  EXPECT_EQ(Us(5), histogram_.min());
+  EXPECT_EQ(Us(1000), histogram_.max());
+  EXPECT_EQ(Us(258), histogram_.Mean());
+
+  // Merging an empty histogram is a no-op.
+  histogram_.Merge(QuicLatencyHistogram());
+  EXPECT_EQ(4u, histogram_.total_count());
+  EXPECT_EQ(Us(5), histogram_.min());
+
+  histogram_.Clear();
+  EXPECT_TRUE(histogram_.empty());
+}
+
+TEST_F(QuicLatencyHistogramTest, ConnectionStatsHistograms) {
+  QuicConnectionStats stats;
+  EXPECT_FALSE(stats.latency_histograms);
+  QuicConnectionStats copy = stats;
+  EXPECT_FALSE(copy.latency_histograms);
+
+  stats.latency_histograms.Allocate();
+  stats.latency_histograms->rtt.Add(Us(10));
+  // Allocating again keeps the samples.
+  stats.latency_histograms.Allocate();
+  EXPECT_EQ(1u, stats.latency_histograms->rtt.total_count());
+
+  // Copies of the stats are snapshots of the histograms.
+  copy = stats;
+  ASSERT_TRUE(copy.latency_histograms);
+  EXPECT_NE(stats.latency_histograms.get(), copy.latency_histograms.get());
+  stats.latency_histograms->rtt.Add(Us(20));
+  EXPECT_EQ(1u, copy.latency_histograms->rtt.total_count());
+  QuicConnectionStats copy2(stats);
+  EXPECT_EQ(2u, copy2.latency_histograms->rtt.total_count());
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace quic
@@ -55,6 +55,18 @@ void QuicMsgHdr::SetIpInNextCmsg(const QuicIpAddress& self_address) {
   }
 }
 
+void QuicMsgHdr::SetEcnInNextCmsg(QuicEcnCodepoint ecn_codepoint) {
+  if (ecn_codepoint == ECN_NOT_ECT) {
+    return;
+  }
+
+  if (raw_peer_address_.ss_family == AF_INET) {
+    *GetNextCmsgData<int>(IPPROTO_IP, IP_TOS) = ecn_codepoint;
+  } else {
+    *GetNextCmsgData<int>(IPPROTO_IPV6, IPV6_TCLASS) = ecn_codepoint;
+  }
+}
+
 void* QuicMsgHdr::GetNextCmsgDataInternal(int cmsg_level,
                                           int cmsg_type,
                                           size_t data_size) {
@@ -120,6 +132,18 @@ void QuicMMsgHdr::SetIpInNextCmsg(int i, const QuicIpAddress& self_address) {
   }
 }
 
+void QuicMMsgHdr::SetEcnInNextCmsg(int i, QuicEcnCodepoint ecn_codepoint) {
+  if (ecn_codepoint == ECN_NOT_ECT) {
+    return;
+  }
+
+  if (GetPeerAddressStorage(i)->ss_family == AF_INET) {
+    *GetNextCmsgData<int>(i, IPPROTO_IP, IP_TOS) = ecn_codepoint;
+  } else {
+    *GetNextCmsgData<int>(i, IPPROTO_IPV6, IPV6_TCLASS) = ecn_codepoint;
+  }
+}
+
 void* QuicMMsgHdr::GetNextCmsgDataInternal(int i,
                                            int cmsg_level,
                                            int cmsg_type,
@@ -198,6 +222,17 @@ bool QuicLinuxSocketUtils::EnableReleaseTime(int fd, clockid_t clockid) {
   return true;
 }
 
+// static
+bool QuicLinuxSocketUtils::EnableZeroCopy(int fd) {
+  int enable = 1;
+  if (setsockopt(fd, SOL_SOCKET, SO_ZEROCOPY, &enable, sizeof(enable)) != 0) {
+    QUIC_LOG_EVERY_N_SEC(INFO, 10)
+        << "setsockopt(SOL_SOCKET,SO_ZEROCOPY) failed: " << strerror(errno);
+    return false;
+  }
+  return true;
+}
+
 // static
 bool QuicLinuxSocketUtils::GetTtlFromMsghdr(struct msghdr* hdr, int* ttl) {
   if (hdr->msg_controllen > 0) {
@@ -265,10 +300,12 @@ size_t QuicLinuxSocketUtils::SetIpInfoInCmsg(const QuicIpAddress& self_address,
 }
 
 // static
-WriteResult QuicLinuxSocketUtils::WritePacket(int fd, const QuicMsgHdr& hdr) {
+WriteResult QuicLinuxSocketUtils::WritePacket(int fd,
+                                              const QuicMsgHdr& hdr,
+                                              int flags) {
   int rc;
   do {
-    rc = GetGlobalSyscallWrapper()->Sendmsg(fd, hdr.hdr(), 0);
+    rc = GetGlobalSyscallWrapper()->Sendmsg(fd, hdr.hdr(), flags);
   } while (rc < 0 && errno == EINTR);
   if (rc >= 0) {
     return WriteResult(WRITE_STATUS_OK, rc);
@@ -40,6 +40,14 @@
 #define SO_TXTIME 61
 #endif
 
+#ifndef SO_ZEROCOPY
+#define SO_ZEROCOPY 60
+#endif
+
+#ifndef MSG_ZEROCOPY
+#define MSG_ZEROCOPY 0x4000000
+#endif
+
 namespace quic {
 
 const int kCmsgSpaceForIpv4 = CMSG_SPACE(sizeof(in_pktinfo));
@@ -55,6 +63,8 @@ const int kCmsgSpaceForTxTime = CMSG_SPACE(sizeof(uint64_t));
 
 const int kCmsgSpaceForTTL = CMSG_SPACE(sizeof(int));
 
+const int kCmsgSpaceForEcn = CMSG_SPACE(sizeof(int));
+
 // QuicMsgHdr is used to build msghdr objects that can be used send packets via
 // ::sendmsg.
 //
@@ -82,6 +92,11 @@ class QUIC_EXPORT_PRIVATE QuicMsgHdr {
   // Set IP info in the next cmsg. Both IPv4 and IPv6 are supported.
   void SetIpInNextCmsg(const QuicIpAddress& self_address);
 
+  // Set the ECN codepoint in the next cmsg, using IP_TOS or IPV6_TCLASS
+  // depending on the address family of the peer. No-op if |ecn_codepoint| is
+  // ECN_NOT_ECT.
+  void SetEcnInNextCmsg(QuicEcnCodepoint ecn_codepoint);
+
   template <typename DataType>
   DataType* GetNextCmsgData(int cmsg_level, int cmsg_type) {
     return reinterpret_cast<DataType*>(
@@ -195,6 +210,8 @@ class QUIC_EXPORT_PRIVATE QuicMMsgHdr {
 
   void SetIpInNextCmsg(int i, const QuicIpAddress& self_address);
 
+  void SetEcnInNextCmsg(int i, QuicEcnCodepoint ecn_codepoint);
+
   template <typename DataType>
   DataType* GetNextCmsgData(int i, int cmsg_level, int cmsg_type) {
     return reinterpret_cast<DataType*>(
@@ -268,6 +285,10 @@ class QUIC_EXPORT_PRIVATE QuicLinuxSocketUtils {
   // Enable release time on |fd|.
   static bool EnableReleaseTime(int fd, clockid_t clockid);
 
+  // Enable SO_ZEROCOPY on |fd|, which is required for sends with
+  // MSG_ZEROCOPY to avoid copying the payload.
+  static bool EnableZeroCopy(int fd);
+
   // If the msghdr contains an IP_TTL entry, this will set ttl to the correct
   // value and return true. Otherwise it will return false.
   static bool GetTtlFromMsghdr(struct msghdr* hdr, int* ttl);
@@ -283,8 +304,8 @@ class QUIC_EXPORT_PRIVATE QuicLinuxSocketUtils {
   static size_t SetIpInfoInCmsg(const QuicIpAddress& self_address,
                                 cmsghdr* cmsg);
 
-  // Writes the packet in |hdr| to the socket, using ::sendmsg.
-  static WriteResult WritePacket(int fd, const QuicMsgHdr& hdr);
+  // Writes the packet in |hdr| to the socket, using ::sendmsg with |flags|.
+  static WriteResult WritePacket(int fd, const QuicMsgHdr& hdr, int flags = 0);
 
   // Writes the packets in |mhdr| to the socket, using ::sendmmsg if available.
   static WriteResult WriteMultiplePackets(int fd,
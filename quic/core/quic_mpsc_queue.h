@@ -0,0 +1,107 @@
+// Copyright (c) 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef QUICHE_QUIC_CORE_QUIC_MPSC_QUEUE_H_
+#define QUICHE_QUIC_CORE_QUIC_MPSC_QUEUE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+#include "quic/platform/api/quic_export.h"
+
+namespace quic {
+
+// A lock-free queue with any number of producer threads and a single consumer
+// thread.  Producers push elements one at a time with a compare-and-swap on
+// the head of a linked list; the consumer takes all of them at once with a
+// single exchange, so that it pays for one atomic operation per batch rather
+// than per element.  Elements pushed by the same thread are consumed in the
+// order they were pushed.
+//
+// Push() returns whether the queue was empty, which lets the producer wake the
+// consumer only when it pushed the first element of a batch:
+//
+//   if (queue.Push(std::move(element))) {
+//     WakeConsumer();
+//   }
+//
+// As long as the consumer calls ConsumeAll() after every wake-up, no element
+// is left in the queue without a wake-up pending.
+template <typename T>
+class QUIC_NO_EXPORT QuicMpscQueue {
+ public:
+  QuicMpscQueue() = default;
+  QuicMpscQueue(const QuicMpscQueue&) = delete;
+  QuicMpscQueue& operator=(const QuicMpscQueue&) = delete;
+  ~QuicMpscQueue() { DeleteList(head_.exchange(nullptr)); }
+
+  // Pushes |value|.  Returns true if the queue was empty.  May be called on
+  // any thread.
+  bool Push(T value) {
+    Node* node = new Node(std::move(value));
+    // |node| may be consumed and deleted as soon as it is published, so the
+    // previous head is kept in a local.
+    Node* head = head_.load(std::memory_order_relaxed);
+    do {
+      node->next = head;
+    } while (!head_.compare_exchange_weak(head, node,
+                                          std::memory_order_release,
+                                          std::memory_order_relaxed));
+    return head == nullptr;
+  }
+
+  // Removes all elements and calls |consumer| with each of them, in the order
+  // they were pushed.  Returns the number of elements consumed.  Must only be
+  // called on the consumer thread.
+  template <typename Consumer>
+  size_t ConsumeAll(Consumer consumer) {
+    Node* head = head_.exchange(nullptr, std::memory_order_acquire);
+    // The list is newest first; reverse it.
+    Node* oldest = nullptr;
+    while (head != nullptr) {
+      Node* next = head->next;
+      head->next = oldest;
+      oldest = head;
+      head = next;
+    }
+    size_t count = 0;
+    while (oldest != nullptr) {
+      Node* next = oldest->next;
+      consumer(std::move(oldest->value));
+      delete oldest;
+      oldest = next;
+      ++count;
+    }
+    return count;
+  }
+
+  // Returns true if the queue has no elements.  Only a hint when called on a
+  // producer thread.
+  bool IsEmpty() const {
+    return head_.load(std::memory_order_relaxed) == nullptr;
+  }
+
+ private:
+  struct Node {
+    explicit Node(T value) : value(std::move(value)) {}
+
+    T value;
+    Node* next = nullptr;
+  };
+
+  static void DeleteList(Node* node) {
+    while (node != nullptr) {
+      Node* next = node->next;
+      delete node;
+      node = next;
+    }
+  }
+
+  std::atomic<Node*> head_{nullptr};
+};
+
+}  // namespace quic
+
+#endif  // QUICHE_QUIC_CORE_QUIC_MPSC_QUEUE_H_
@@ -0,0 +1,116 @@
+// Copyright (c) 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "quic/core/quic_mpsc_queue.h"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "quic/platform/api/quic_test.h"
+
+namespace quic {
+namespace test {
+namespace {
+
+TEST(QuicMpscQueueTest, ConsumesInPushOrder) {
+  QuicMpscQueue<int> queue;
+  EXPECT_TRUE(queue.IsEmpty());
+  EXPECT_TRUE(queue.Push(1));
+  EXPECT_FALSE(queue.Push(2));
+  EXPECT_FALSE(queue.Push(3));
+  EXPECT_FALSE(queue.IsEmpty());
+
+  std::vector<int> values;
+  EXPECT_EQ(3u, queue.ConsumeAll([&values](int value) {
+    values.push_back(value);
+  }));
+  EXPECT_EQ(std::vector<int>({1, 2, 3}), values);
+  EXPECT_TRUE(queue.IsEmpty());
+  EXPECT_EQ(0u, queue.ConsumeAll([](int) { ADD_FAILURE(); }));
+
+  // The next push is the first of a new batch.
+  EXPECT_TRUE(queue.Push(4));
+}
+
+TEST(QuicMpscQueueTest, MoveOnlyValues) {
+  QuicMpscQueue<std::unique_ptr<int>> queue;
+  queue.Push(std::make_unique<int>(1));
+  queue.Push(std::make_unique<int>(2));
+  int sum = 0;
+  queue.ConsumeAll([&sum](std::unique_ptr<int> value) { sum += *value; });
+  EXPECT_EQ(3, sum);
+
+  // Values left in the queue are destroyed with it.
+  queue.Push(std::make_unique<int>(3));
+}
+
+TEST(QuicMpscQueueTest, ConsumeDuringConsume) {
+  QuicMpscQueue<int> queue;
+  queue.Push(1);
+  queue.Push(2);
+  std::vector<int> values;
+  queue.ConsumeAll([&queue, &values](int value) {
+    values.push_back(value);
+    if (value == 1) {
+      // Elements pushed while consuming are consumed by the next call.
+      EXPECT_TRUE(queue.Push(3));
+      queue.ConsumeAll([&values](int value) { values.push_back(value); });
+    }
+  });
+  EXPECT_EQ(std::vector<int>({1, 3, 2}), values);
+}
+
+// Producers push increasing values while the consumer consumes them
+// concurrently; every value is consumed once, and each producer's values are
+// consumed in order.
+TEST(QuicMpscQueueTest, MultipleProducers) {
+  constexpr int kNumProducers = 4;
+  constexpr int kValuesPerProducer = 100000;
+  QuicMpscQueue<std::pair<int, int>> queue;
+  std::atomic<int> num_batches_started{0};
+
+  std::vector<std::thread> producers;
+  for (int producer = 0; producer < kNumProducers; ++producer) {
+    producers.emplace_back([&queue, &num_batches_started, producer]() {
+      for (int i = 0; i < kValuesPerProducer; ++i) {
+        if (queue.Push(std::make_pair(producer, i))) {
+          num_batches_started.fetch_add(1, std::memory_order_relaxed);
+        }
+      }
+    });
+  }
+
+  std::vector<int> next_value(kNumProducers, 0);
+  int num_consumed = 0;
+  int num_batches = 0;
+  while (num_consumed < kNumProducers * kValuesPerProducer) {
+    const size_t consumed = queue.ConsumeAll(
+        [&next_value](std::pair<int, int> producer_and_value) {
+          EXPECT_EQ(next_value[producer_and_value.first],
+                    producer_and_value.second);
+          next_value[producer_and_value.first] = producer_and_value.second + 1;
+        });
+    if (consumed > 0) {
+      ++num_batches;
+    }
+    num_consumed += consumed;
+  }
+  for (std::thread& producer : producers) {
+    producer.join();
+  }
+
+  EXPECT_TRUE(queue.IsEmpty());
+  for (int producer = 0; producer < kNumProducers; ++producer) {
+    EXPECT_EQ(kValuesPerProducer, next_value[producer]);
+  }
+  // Every batch was started by a push into an empty queue.
+  EXPECT_EQ(num_batches, num_batches_started.load());
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace quic
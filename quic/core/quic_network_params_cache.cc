@@ -0,0 +1,140 @@
+// Copyright (c) 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "quic/core/quic_network_params_cache.h"
+
+#include <algorithm>
+#include <functional>
+
+#include "quic/platform/api/quic_logging.h"
+
+namespace quic {
+
+namespace {
+
+// Number of bytes of the address kept in the prefix key.
+const size_t kIPv4PrefixBytes = 3;  // /24
+const size_t kIPv6PrefixBytes = 6;  // /48
+
+}  // namespace
+
+QuicNetworkParamsCache::QuicNetworkParamsCache(size_t max_entries)
+    : max_age_(kDefaultMaxAge),
+      max_initial_congestion_window_(kDefaultMaxInitialCongestionWindow) {
+  const size_t shard_capacity =
+      std::max<size_t>(1, (max_entries + kNumShards - 1) / kNumShards);
+  shards_.reserve(kNumShards);
+  for (size_t i = 0; i < kNumShards; ++i) {
+    shards_.push_back(std::make_unique<Shard>(shard_capacity));
+  }
+}
+
+void QuicNetworkParamsCache::RecordEstimate(const QuicIpAddress& peer_address,
+                                            QuicBandwidth bandwidth,
+                                            QuicTime::Delta min_rtt,
+                                            QuicWallTime now) {
+  if (bandwidth.IsZero() || min_rtt.IsZero()) {
+    return;
+  }
+  const std::string key = PrefixKey(peer_address);
+  if (key.empty()) {
+    return;
+  }
+  Shard* shard = GetShard(key);
+  QuicWriterMutexLock lock(&shard->lock);
+  Entry* entry = shard->cache.Lookup(key);
+  if (entry == nullptr || now.AbsoluteDifference(entry->timestamp) > max_age_) {
+    auto new_entry = std::make_unique<Entry>();
+    new_entry->bandwidth = bandwidth;
+    new_entry->min_rtt = min_rtt;
+    new_entry->timestamp = now;
+    new_entry->num_samples = 1;
+    shard->cache.Insert(key, std::move(new_entry));
+    return;
+  }
+  // Average the bandwidth of the connections from the prefix, so that a
+  // single fast or slow host doesn't decide for all of them.
+  entry->bandwidth = QuicBandwidth::FromBitsPerSecond(
+      (entry->bandwidth.ToBitsPerSecond() + bandwidth.ToBitsPerSecond()) / 2);
+  entry->min_rtt = std::min(entry->min_rtt, min_rtt);
+  entry->timestamp = now;
+  ++entry->num_samples;
+}
+
+absl::optional<QuicNetworkParamsCache::Entry> QuicNetworkParamsCache::Lookup(
+    const QuicIpAddress& peer_address,
+    QuicWallTime now) {
+  const std::string key = PrefixKey(peer_address);
+  if (key.empty()) {
+    return absl::nullopt;
+  }
+  Shard* shard = GetShard(key);
+  QuicWriterMutexLock lock(&shard->lock);
+  const Entry* entry = shard->cache.Lookup(key);
+  if (entry == nullptr || now.AbsoluteDifference(entry->timestamp) > max_age_) {
+    return absl::nullopt;
+  }
+  return *entry;
+}
+
+bool QuicNetworkParamsCache::GetNetworkParams(
+    const QuicIpAddress& peer_address,
+    QuicWallTime now,
+    QuicByteCount congestion_window,
+    SendAlgorithmInterface::NetworkParams* params) {
+  absl::optional<Entry> entry = Lookup(peer_address, now);
+  if (!entry.has_value()) {
+    return false;
+  }
+  params->bandwidth = entry->bandwidth * 0.5;
+  params->rtt = entry->min_rtt;
+  params->max_initial_congestion_window = max_initial_congestion_window_;
+  params->allow_cwnd_to_decrease = false;
+
+  const QuicByteCount cached_cwnd =
+      params->bandwidth.ToBytesPerPeriod(params->rtt);
+  const QuicByteCount max_cwnd =
+      static_cast<QuicByteCount>(max_initial_congestion_window_) *
+      kDefaultTCPMSS;
+  if (cached_cwnd < congestion_window) {
+    params->bandwidth = QuicBandwidth::Zero();
+  } else if (max_initial_congestion_window_ > 0 && cached_cwnd > max_cwnd) {
+    // Rounded up, so that bandwidth * rtt is not below the limit.
+    const int64_t rtt_us = params->rtt.ToMicroseconds();
+    params->bandwidth = QuicBandwidth::FromBitsPerSecond(
+        (max_cwnd * 8 * kNumMicrosPerSecond + rtt_us - 1) / rtt_us);
+  }
+  QUIC_DVLOG(1) << "Seeding connection from " << peer_address
+                << " with bandwidth " << params->bandwidth << " and rtt "
+                << params->rtt << " from " << entry->num_samples
+                << " samples";
+  return true;
+}
+
+size_t QuicNetworkParamsCache::Size() const {
+  size_t size = 0;
+  for (const auto& shard : shards_) {
+    QuicReaderMutexLock lock(&shard->lock);
+    size += shard->cache.Size();
+  }
+  return size;
+}
+
+// static
+std::string QuicNetworkParamsCache::PrefixKey(const QuicIpAddress& address) {
+  if (!address.IsInitialized()) {
+    return std::string();
+  }
+  const QuicIpAddress normalized = address.Normalized();
+  std::string key = normalized.ToPackedString();
+  key.resize(normalized.IsIPv4() ? kIPv4PrefixBytes : kIPv6PrefixBytes);
+  return key;
+}
+
+QuicNetworkParamsCache::Shard* QuicNetworkParamsCache::GetShard(
+    const std::string& key) const {
+  return shards_[std::hash<std::string>()(key) % kNumShards].get();
+}
+
+}  // namespace quic
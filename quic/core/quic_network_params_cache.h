@@ -0,0 +1,129 @@
+// Copyright (c) 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef QUICHE_QUIC_CORE_QUIC_NETWORK_PARAMS_CACHE_H_
+#define QUICHE_QUIC_CORE_QUIC_NETWORK_PARAMS_CACHE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/types/optional.h"
+#include "quic/core/congestion_control/send_algorithm_interface.h"
+#include "quic/core/quic_bandwidth.h"
+#include "quic/core/quic_constants.h"
+#include "quic/core/quic_lru_cache.h"
+#include "quic/core/quic_time.h"
+#include "quic/platform/api/quic_export.h"
+#include "quic/platform/api/quic_ip_address.h"
+#include "quic/platform/api/quic_mutex.h"
+
+namespace quic {
+
+// A server side cache of the bandwidth and min RTT measured by recently closed
+// connections, keyed by the /24 (IPv4) or /48 (IPv6) prefix of the client's
+// address.  It lets new connections from a known network start with a larger
+// congestion window, like bandwidth resumption does for clients which return
+// CachedNetworkParameters in their source address token, but without any
+// cooperation from the client.
+//
+// The cache is bounded and split into shards, each with its own lock, so that
+// it can be shared by the dispatchers of several threads.
+class QUIC_EXPORT_PRIVATE QuicNetworkParamsCache {
+ public:
+  // The estimates recorded for a prefix.
+  struct QUIC_EXPORT_PRIVATE Entry {
+    // Exponentially weighted average of the bandwidth estimates of the
+    // connections from the prefix, where each new estimate has a weight of
+    // one half.
+    QuicBandwidth bandwidth = QuicBandwidth::Zero();
+    // Smallest min RTT of the connections from the prefix.
+    QuicTime::Delta min_rtt = QuicTime::Delta::Zero();
+    // When the last estimate was recorded.
+    QuicWallTime timestamp = QuicWallTime::Zero();
+    // Number of estimates recorded since the entry was created.
+    uint64_t num_samples = 0;
+  };
+
+  static constexpr size_t kDefaultMaxEntries = 64 * 1024;
+  static constexpr size_t kNumShards = 16;
+  // Estimates older than this are ignored, as for bandwidth resumption.
+  static constexpr QuicTime::Delta kDefaultMaxAge =
+      QuicTime::Delta::FromSeconds(kNumSecondsPerHour);
+  // The initial congestion window set from the cache is capped at this many
+  // packets, and the recorded bandwidth is halved, because the new connection
+  // is likely from a different host sharing the prefix.
+  static constexpr int kDefaultMaxInitialCongestionWindow = 100;
+
+  explicit QuicNetworkParamsCache(size_t max_entries = kDefaultMaxEntries);
+
+  QuicNetworkParamsCache(const QuicNetworkParamsCache&) = delete;
+  QuicNetworkParamsCache& operator=(const QuicNetworkParamsCache&) = delete;
+
+  // Records the estimates of a connection from |peer_address|, typically when
+  // it's closed.  Estimates with a zero bandwidth or min RTT are ignored.
+  void RecordEstimate(const QuicIpAddress& peer_address,
+                      QuicBandwidth bandwidth,
+                      QuicTime::Delta min_rtt,
+                      QuicWallTime now);
+
+  // Returns the entry of the prefix of |peer_address|, if there is one which
+  // is not older than max_age().
+  absl::optional<Entry> Lookup(const QuicIpAddress& peer_address,
+                               QuicWallTime now);
+
+  // Fills |params| to seed a new connection from |peer_address|, whose
+  // congestion window is |congestion_window|, through
+  // QuicConnection::AdjustNetworkParameters.  Returns false if nothing
+  // recent is known about the prefix of |peer_address|.
+  //
+  // Not all senders honor max_initial_congestion_window and
+  // allow_cwnd_to_decrease, TcpCubicSenderBytes sets its window to
+  // bandwidth * rtt.  So both limits are also applied to the bandwidth: it is
+  // zero if the cached window is below |congestion_window|, so that only the
+  // RTT is seeded, and lowered if the cached window is above
+  // max_initial_congestion_window() packets.
+  bool GetNetworkParams(const QuicIpAddress& peer_address,
+                        QuicWallTime now,
+                        QuicByteCount congestion_window,
+                        SendAlgorithmInterface::NetworkParams* params);
+
+  // Returns the number of prefixes in the cache.
+  size_t Size() const;
+
+  QuicTime::Delta max_age() const { return max_age_; }
+  void set_max_age(QuicTime::Delta max_age) { max_age_ = max_age; }
+
+  int max_initial_congestion_window() const {
+    return max_initial_congestion_window_;
+  }
+  void set_max_initial_congestion_window(int max_initial_congestion_window) {
+    max_initial_congestion_window_ = max_initial_congestion_window;
+  }
+
+  // Returns the key of the prefix of |address|, or an empty string if it's not
+  // initialized.  IPv4-mapped IPv6 addresses share the key of their IPv4
+  // address.
+  static std::string PrefixKey(const QuicIpAddress& address);
+
+ private:
+  struct QUIC_EXPORT_PRIVATE Shard {
+    explicit Shard(size_t capacity) : cache(capacity) {}
+
+    mutable QuicMutex lock;
+    QuicLRUCache<std::string, Entry> cache QUIC_GUARDED_BY(lock);
+  };
+
+  Shard* GetShard(const std::string& key) const;
+
+  std::vector<std::unique_ptr<Shard>> shards_;
+  QuicTime::Delta max_age_;
+  int max_initial_congestion_window_;
+};
+
+}  // namespace quic
+
+#endif  // QUICHE_QUIC_CORE_QUIC_NETWORK_PARAMS_CACHE_H_
@@ -0,0 +1,232 @@
+// Copyright (c) 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "quic/core/quic_network_params_cache.h"
+
+#include <memory>
+
+#include "quic/platform/api/quic_logging.h"
+#include "quic/platform/api/quic_test.h"
+#include "quic/test_tools/quic_test_utils.h"
+#include "quic/test_tools/simulator/link.h"
+#include "quic/test_tools/simulator/quic_endpoint.h"
+#include "quic/test_tools/simulator/simulator.h"
+#include "quic/test_tools/simulator/switch.h"
+
+namespace quic {
+namespace test {
+namespace {
+
+const QuicBandwidth kBandwidth = QuicBandwidth::FromKBitsPerSecond(8000);
+const QuicTime::Delta kMinRtt = QuicTime::Delta::FromMilliseconds(40);
+
+QuicIpAddress Address(const char* address) {
+  QuicIpAddress ip;
+  EXPECT_TRUE(ip.FromString(address));
+  return ip;
+}
+
+class QuicNetworkParamsCacheTest : public QuicTest {
+ protected:
+  QuicNetworkParamsCacheTest()
+      : now_(QuicWallTime::FromUNIXSeconds(1600000000)) {}
+
+  QuicNetworkParamsCache cache_;
+  QuicWallTime now_;
+};
+
+TEST_F(QuicNetworkParamsCacheTest, PrefixKey) {
+  EXPECT_EQ(QuicNetworkParamsCache::PrefixKey(Address("192.0.2.1")),
+            QuicNetworkParamsCache::PrefixKey(Address("192.0.2.200")));
+  EXPECT_EQ(QuicNetworkParamsCache::PrefixKey(Address("192.0.2.1")),
+            QuicNetworkParamsCache::PrefixKey(Address("::ffff:192.0.2.7")));
+  EXPECT_NE(QuicNetworkParamsCache::PrefixKey(Address("192.0.2.1")),
+            QuicNetworkParamsCache::PrefixKey(Address("192.0.3.1")));
+
+  EXPECT_EQ(QuicNetworkParamsCache::PrefixKey(Address("2001:db8:1::1")),
+            QuicNetworkParamsCache::PrefixKey(Address("2001:db8:1:ffff::2")));
+  EXPECT_NE(QuicNetworkParamsCache::PrefixKey(Address("2001:db8:1::1")),
+            QuicNetworkParamsCache::PrefixKey(Address("2001:db8:2::1")));
+
+  EXPECT_TRUE(QuicNetworkParamsCache::PrefixKey(QuicIpAddress()).empty());
+}
+
+TEST_F(QuicNetworkParamsCacheTest, RecordAndLookup) {
+  EXPECT_FALSE(cache_.Lookup(Address("192.0.2.1"), now_).has_value());
+
+  cache_.RecordEstimate(Address("192.0.2.1"), kBandwidth, kMinRtt, now_);
+  absl::optional<QuicNetworkParamsCache::Entry> entry =
+      cache_.Lookup(Address("192.0.2.99"), now_);
+  ASSERT_TRUE(entry.has_value());
+  EXPECT_EQ(kBandwidth, entry->bandwidth);
+  EXPECT_EQ(kMinRtt, entry->min_rtt);
+  EXPECT_EQ(1u, entry->num_samples);
+  EXPECT_FALSE(cache_.Lookup(Address("192.0.3.1"), now_).has_value());
+
+  // A second connection from the prefix is averaged with the first one.
+  cache_.RecordEstimate(Address("192.0.2.2"), kBandwidth * 2,
+                        kMinRtt + QuicTime::Delta::FromMilliseconds(10), now_);
+  entry = cache_.Lookup(Address("192.0.2.1"), now_);
+  ASSERT_TRUE(entry.has_value());
+  EXPECT_EQ(kBandwidth * 1.5, entry->bandwidth);
+  EXPECT_EQ(kMinRtt, entry->min_rtt);
+  EXPECT_EQ(2u, entry->num_samples);
+  EXPECT_EQ(1u, cache_.Size());
+}
+
+TEST_F(QuicNetworkParamsCacheTest, IgnoresEmptyEstimates) {
+  cache_.RecordEstimate(Address("192.0.2.1"), QuicBandwidth::Zero(), kMinRtt,
+                        now_);
+  cache_.RecordEstimate(Address("192.0.2.1"), kBandwidth,
+                        QuicTime::Delta::Zero(), now_);
+  cache_.RecordEstimate(QuicIpAddress(), kBandwidth, kMinRtt, now_);
+  EXPECT_EQ(0u, cache_.Size());
+}
+
+TEST_F(QuicNetworkParamsCacheTest, EntriesExpire) {
+  cache_.set_max_age(QuicTime::Delta::FromSeconds(60));
+  cache_.RecordEstimate(Address("192.0.2.1"), kBandwidth, kMinRtt, now_);
+  EXPECT_TRUE(
+      cache_.Lookup(Address("192.0.2.1"), now_.Add(cache_.max_age()))
+          .has_value());
+  const QuicWallTime later =
+      now_.Add(cache_.max_age() + QuicTime::Delta::FromSeconds(1));
+  EXPECT_FALSE(cache_.Lookup(Address("192.0.2.1"), later).has_value());
+
+  // An expired entry is replaced rather than averaged.
+  cache_.RecordEstimate(Address("192.0.2.1"), kBandwidth * 4, kMinRtt * 2,
+                        later);
+  absl::optional<QuicNetworkParamsCache::Entry> entry =
+      cache_.Lookup(Address("192.0.2.1"), later);
+  ASSERT_TRUE(entry.has_value());
+  EXPECT_EQ(kBandwidth * 4, entry->bandwidth);
+  EXPECT_EQ(kMinRtt * 2, entry->min_rtt);
+  EXPECT_EQ(1u, entry->num_samples);
+}
+
+TEST_F(QuicNetworkParamsCacheTest, Bounded) {
+  QuicNetworkParamsCache cache(/*max_entries=*/64);
+  for (int i = 0; i < 1000; ++i) {
+    QuicIpAddress address = Address("10.0.0.1");
+    address = address.Normalized();
+    std::string packed = address.ToPackedString();
+    packed[1] = static_cast<char>(i >> 8);
+    packed[2] = static_cast<char>(i & 0xff);
+    ASSERT_TRUE(address.FromPackedString(packed.data(), packed.size()));
+    cache.RecordEstimate(address, kBandwidth, kMinRtt, now_);
+  }
+  EXPECT_LE(cache.Size(), 64u);
+  EXPECT_LT(0u, cache.Size());
+}
+
+TEST_F(QuicNetworkParamsCacheTest, GetNetworkParams) {
+  SendAlgorithmInterface::NetworkParams params;
+  EXPECT_FALSE(cache_.GetNetworkParams(Address("192.0.2.1"), now_,
+                                       /*congestion_window=*/0, &params));
+
+  cache_.set_max_initial_congestion_window(50);
+  cache_.RecordEstimate(Address("192.0.2.1"), kBandwidth, kMinRtt, now_);
+  ASSERT_TRUE(cache_.GetNetworkParams(Address("192.0.2.1"), now_,
+                                      /*congestion_window=*/0, &params));
+  // The bandwidth is halved since the new connection may be from another host.
+  EXPECT_EQ(kBandwidth * 0.5, params.bandwidth);
+  EXPECT_EQ(kMinRtt, params.rtt);
+  EXPECT_EQ(50, params.max_initial_congestion_window);
+  EXPECT_FALSE(params.allow_cwnd_to_decrease);
+}
+
+TEST_F(QuicNetworkParamsCacheTest, GetNetworkParamsLimitsCongestionWindow) {
+  cache_.RecordEstimate(Address("192.0.2.1"), kBandwidth, kMinRtt, now_);
+  // Half of kBandwidth over kMinRtt.
+  const QuicByteCount kCachedWindow = 20000;
+  SendAlgorithmInterface::NetworkParams params;
+
+  // The window does not shrink, but the RTT is seeded.
+  ASSERT_TRUE(cache_.GetNetworkParams(Address("192.0.2.1"), now_,
+                                      kCachedWindow + 1, &params));
+  EXPECT_TRUE(params.bandwidth.IsZero());
+  EXPECT_EQ(kMinRtt, params.rtt);
+
+  ASSERT_TRUE(cache_.GetNetworkParams(Address("192.0.2.1"), now_,
+                                      kCachedWindow, &params));
+  EXPECT_EQ(kCachedWindow, params.bandwidth.ToBytesPerPeriod(params.rtt));
+
+  // The window is capped at max_initial_congestion_window() packets.
+  cache_.set_max_initial_congestion_window(10);
+  ASSERT_TRUE(cache_.GetNetworkParams(Address("192.0.2.1"), now_,
+                                      /*congestion_window=*/0, &params));
+  EXPECT_EQ(10 * kDefaultTCPMSS, params.bandwidth.ToBytesPerPeriod(params.rtt));
+  EXPECT_EQ(kMinRtt, params.rtt);
+}
+
+// Transfers |bytes| from a server to a client on a fresh simulated
+// connection, seeding the server's congestion controller from |cache| if
+// |seed| is true, then records the connection's estimates in |cache|.
+// Returns the time it took for the client to receive all bytes.
+QuicTime::Delta TransferFromServer(QuicNetworkParamsCache* cache,
+                                   bool seed,
+                                   QuicByteCount bytes) {
+  const QuicBandwidth kLinkBandwidth =
+      QuicBandwidth::FromKBitsPerSecond(100 * 1000);
+  const QuicTime::Delta kLinkDelay = QuicTime::Delta::FromMilliseconds(25);
+  simulator::Simulator simulator;
+  simulator::Switch network_switch(&simulator, "Switch", 8,
+                                   2 * kLinkBandwidth * (4 * kLinkDelay));
+  simulator::QuicEndpoint server(&simulator, "Server", "Client",
+                                 Perspective::IS_SERVER, TestConnectionId(42));
+  simulator::QuicEndpoint client(&simulator, "Client", "Server",
+                                 Perspective::IS_CLIENT, TestConnectionId(42));
+  simulator::SymmetricLink server_link(&server, network_switch.port(1),
+                                       kLinkBandwidth, kLinkDelay);
+  simulator::SymmetricLink client_link(&client, network_switch.port(2),
+                                       kLinkBandwidth, kLinkDelay);
+
+  const QuicIpAddress client_ip = server.connection()->peer_address().host();
+  // Seeded the same way as QuicServerSessionBase does.
+  const QuicByteCount congestion_window =
+      server.connection()->sent_packet_manager().GetCongestionWindowInBytes();
+  SendAlgorithmInterface::NetworkParams params;
+  if (seed && cache->GetNetworkParams(client_ip,
+                                      simulator.GetClock()->WallNow(),
+                                      congestion_window, &params)) {
+    server.connection()->AdjustNetworkParameters(params);
+  }
+
+  const QuicTime start = simulator.GetClock()->Now();
+  server.AddBytesToTransfer(bytes);
+  const QuicTime deadline = start + QuicTime::Delta::FromSeconds(30);
+  simulator.RunUntil([&]() {
+    return client.bytes_received() >= bytes ||
+           simulator.GetClock()->Now() >= deadline;
+  });
+  EXPECT_EQ(bytes, client.bytes_received());
+
+  const QuicSentPacketManager& sent_packet_manager =
+      server.connection()->sent_packet_manager();
+  cache->RecordEstimate(client_ip, sent_packet_manager.BandwidthEstimate(),
+                        sent_packet_manager.GetRttStats()->min_rtt(),
+                        simulator.GetClock()->WallNow());
+  return simulator.GetClock()->Now() - start;
+}
+
+// Measures the time to the first 1 MB of a connection, with and without the
+// cache warmed up by an earlier connection from the same client.
+TEST_F(QuicNetworkParamsCacheTest, SeedingReducesTimeToFirstBytes) {
+  const QuicByteCount kBytes = 1024 * 1024;
+  const QuicTime::Delta cold =
+      TransferFromServer(&cache_, /*seed=*/true, kBytes);
+  ASSERT_EQ(1u, cache_.Size());
+  const QuicTime::Delta unseeded =
+      TransferFromServer(&cache_, /*seed=*/false, kBytes);
+  const QuicTime::Delta seeded =
+      TransferFromServer(&cache_, /*seed=*/true, kBytes);
+  QUIC_LOG(INFO) << "Time to first " << kBytes << " bytes: cold cache "
+                 << cold << ", cache off " << unseeded << ", cache on "
+                 << seeded;
+  EXPECT_LT(seeded, unseeded);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace quic
@@ -51,63 +51,77 @@ bool QuicPacketReader::ReadAndDispatchPackets(
   QuicTime now = clock.Now();
 
   size_t packets_read = socket_api_.ReadMultiplePackets(
-      fd,
-      BitMask64(QuicUdpPacketInfoBit::DROPPED_PACKETS,
-                QuicUdpPacketInfoBit::PEER_ADDRESS,
-                QuicUdpPacketInfoBit::V4_SELF_IP,
-                QuicUdpPacketInfoBit::V6_SELF_IP,
-                QuicUdpPacketInfoBit::RECV_TIMESTAMP, QuicUdpPacketInfoBit::TTL,
-                QuicUdpPacketInfoBit::GOOGLE_PACKET_HEADER),
-      &read_results_);
+      fd, PacketInfoInterested(), &read_results_);
   for (size_t i = 0; i < packets_read; ++i) {
     auto& result = read_results_[i];
     if (!result.ok) {
       QUIC_CODE_COUNT(quic_packet_reader_read_failure);
       continue;
     }
+    DispatchPacket(result.packet_buffer, result.packet_info, now, port,
+                   processor);
+  }
 
-    if (!result.packet_info.HasValue(QuicUdpPacketInfoBit::PEER_ADDRESS)) {
-      QUIC_BUG(quic_bug_10329_1) << "Unable to get peer socket address.";
-      continue;
-    }
+  // We may not have read all of the packets available on the socket.
+  return packets_read == kNumPacketsPerReadMmsgCall;
+}
 
-    QuicSocketAddress peer_address =
-        result.packet_info.peer_address().Normalized();
+// static
+BitMask64 QuicPacketReader::PacketInfoInterested() {
+  return BitMask64(QuicUdpPacketInfoBit::DROPPED_PACKETS,
+                   QuicUdpPacketInfoBit::PEER_ADDRESS,
+                   QuicUdpPacketInfoBit::V4_SELF_IP,
+                   QuicUdpPacketInfoBit::V6_SELF_IP,
+                   QuicUdpPacketInfoBit::RECV_TIMESTAMP,
+                   QuicUdpPacketInfoBit::TTL,
+                   QuicUdpPacketInfoBit::GOOGLE_PACKET_HEADER,
+                   QuicUdpPacketInfoBit::ECN_CODEPOINT);
+}
 
-    QuicIpAddress self_ip = GetSelfIpFromPacketInfo(
-        result.packet_info, peer_address.host().IsIPv6());
-    if (!self_ip.IsInitialized()) {
-      QUIC_BUG(quic_bug_10329_2) << "Unable to get self IP address.";
-      continue;
-    }
+// static
+void QuicPacketReader::DispatchPacket(BufferSpan packet_buffer,
+                                      const QuicUdpPacketInfo& packet_info,
+                                      QuicTime now,
+                                      int port,
+                                      ProcessPacketInterface* processor) {
+  if (!packet_info.HasValue(QuicUdpPacketInfoBit::PEER_ADDRESS)) {
+    QUIC_BUG(quic_bug_10329_1) << "Unable to get peer socket address.";
+    return;
+  }
 
-    bool has_ttl = result.packet_info.HasValue(QuicUdpPacketInfoBit::TTL);
-    int ttl = has_ttl ? result.packet_info.ttl() : 0;
-    if (!has_ttl) {
-      QUIC_CODE_COUNT(quic_packet_reader_no_ttl);
-    }
+  QuicSocketAddress peer_address = packet_info.peer_address().Normalized();
 
-    char* headers = nullptr;
-    size_t headers_length = 0;
-    if (result.packet_info.HasValue(
-            QuicUdpPacketInfoBit::GOOGLE_PACKET_HEADER)) {
-      headers = result.packet_info.google_packet_headers().buffer;
-      headers_length = result.packet_info.google_packet_headers().buffer_len;
-    } else {
-      QUIC_CODE_COUNT(quic_packet_reader_no_google_packet_header);
-    }
+  QuicIpAddress self_ip =
+      GetSelfIpFromPacketInfo(packet_info, peer_address.host().IsIPv6());
+  if (!self_ip.IsInitialized()) {
+    QUIC_BUG(quic_bug_10329_2) << "Unable to get self IP address.";
+    return;
+  }
+
+  bool has_ttl = packet_info.HasValue(QuicUdpPacketInfoBit::TTL);
+  int ttl = has_ttl ? packet_info.ttl() : 0;
+  if (!has_ttl) {
+    QUIC_CODE_COUNT(quic_packet_reader_no_ttl);
+  }
 
-    QuicReceivedPacket packet(
-        result.packet_buffer.buffer, result.packet_buffer.buffer_len, now,
-        /*owns_buffer=*/false, ttl, has_ttl, headers, headers_length,
-        /*owns_header_buffer=*/false);
+  char* headers = nullptr;
+  size_t headers_length = 0;
+  if (packet_info.HasValue(QuicUdpPacketInfoBit::GOOGLE_PACKET_HEADER)) {
+    headers = packet_info.google_packet_headers().buffer;
+    headers_length = packet_info.google_packet_headers().buffer_len;
+  } else {
+    QUIC_CODE_COUNT(quic_packet_reader_no_google_packet_header);
+  }
 
-    QuicSocketAddress self_address(self_ip, port);
-    processor->ProcessPacket(self_address, peer_address, packet);
+  QuicReceivedPacket packet(packet_buffer.buffer, packet_buffer.buffer_len,
+                            now, /*owns_buffer=*/false, ttl, has_ttl, headers,
+                            headers_length, /*owns_header_buffer=*/false);
+  if (packet_info.HasValue(QuicUdpPacketInfoBit::ECN_CODEPOINT)) {
+    packet.set_ecn_codepoint(packet_info.ecn_codepoint());
   }
 
-  // We may not have read all of the packets available on the socket.
-  return packets_read == kNumPacketsPerReadMmsgCall;
+  QuicSocketAddress self_address(self_ip, port);
+  processor->ProcessPacket(self_address, peer_address, packet);
 }
 
 // static
@@ -41,6 +41,18 @@ class QUIC_EXPORT_PRIVATE QuicPacketReader {
                                       ProcessPacketInterface* processor,
                                       QuicPacketCount* packets_dropped);
 
+ protected:
+  // The packet info read by ReadAndDispatchPackets().
+  static BitMask64 PacketInfoInterested();
+
+  // Passes the packet in |packet_buffer|, received at |now| on |port| with
+  // |packet_info|, to |processor|.
+  static void DispatchPacket(BufferSpan packet_buffer,
+                             const QuicUdpPacketInfo& packet_info,
+                             QuicTime now,
+                             int port,
+                             ProcessPacketInterface* processor);
+
  private:
   // Return the self ip from |packet_info|.
   // For dual stack sockets, |packet_info| may contain both a v4 and a v6 ip, in
@@ -335,6 +335,12 @@ class QUIC_EXPORT_PRIVATE QuicReceivedPacket : public QuicEncryptedPacket {
   // Length of packet headers.
   int headers_length() const { return headers_length_; }
 
+  // The ECN codepoint of the IP header, or ECN_NOT_ECT if it is unknown.
+  QuicEcnCodepoint ecn_codepoint() const { return ecn_codepoint_; }
+  void set_ecn_codepoint(QuicEcnCodepoint ecn_codepoint) {
+    ecn_codepoint_ = ecn_codepoint;
+  }
+
   // By default, gtest prints the raw bytes of an object. The bool data
   // member (in the base class QuicData) causes this object to have padding
   // bytes, which causes the default gtest object printer to read
@@ -352,6 +358,7 @@ class QUIC_EXPORT_PRIVATE QuicReceivedPacket : public QuicEncryptedPacket {
   int headers_length_;
   // Whether owns the buffer for packet headers.
   bool owns_header_buffer_;
+  QuicEcnCodepoint ecn_codepoint_ = ECN_NOT_ECT;
 };
 
 // SerializedPacket contains information of a serialized(encrypted) packet.
@@ -455,6 +462,8 @@ struct QUIC_EXPORT_PRIVATE ReceivedPacketInfo {
   ParsedQuicVersion version;
   QuicConnectionId destination_connection_id;
   QuicConnectionId source_connection_id;
+  // The token of IETF Initial packets, which points into |packet|.
+  absl::string_view retry_token;
 };
 
 }  // namespace quic
@@ -0,0 +1,138 @@
+// Copyright (c) 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "quic/core/quic_qlog_visitor.h"
+
+#include <algorithm>
+
+namespace quic {
+
+namespace {
+
+uint64_t ConnectionTag(const QuicConnectionId& connection_id) {
+  uint64_t tag = 0;
+  const size_t length =
+      std::min<size_t>(connection_id.length(), sizeof(tag));
+  for (size_t i = 0; i < length; ++i) {
+    tag = (tag << 8) | static_cast<uint8_t>(connection_id.data()[i]);
+  }
+  return tag;
+}
+
+}  // namespace
+
+QuicQlogVisitor::QuicQlogVisitor(const QuicConnection* connection,
+                                 QuicQlogEventRing* ring,
+                                 uint64_t max_events)
+    : connection_(connection),
+      ring_(ring),
+      max_events_(max_events),
+      connection_tag_(ConnectionTag(connection->connection_id())) {}
+
+void QuicQlogVisitor::OnPacketSent(
+    QuicPacketNumber packet_number,
+    QuicPacketLength packet_length,
+    bool /*has_crypto_handshake*/,
+    TransmissionType transmission_type,
+    EncryptionLevel encryption_level,
+    const QuicFrames& /*retransmittable_frames*/,
+    const QuicFrames& /*nonretransmittable_frames*/,
+    QuicTime sent_time) {
+  QuicQlogEvent event = NewEvent(QuicQlogEventType::kPacketSent, sent_time);
+  event.packet_number = packet_number.ToUint64();
+  event.packet_length = packet_length;
+  event.transmission_type = transmission_type;
+  event.encryption_level = encryption_level;
+  Record(event);
+}
+
+void QuicQlogVisitor::OnPacketReceived(
+    const QuicSocketAddress& /*self_address*/,
+    const QuicSocketAddress& /*peer_address*/,
+    const QuicEncryptedPacket& packet) {
+  last_received_packet_length_ = static_cast<QuicPacketLength>(
+      std::min<size_t>(packet.length(), kMaxIncomingPacketSize));
+}
+
+void QuicQlogVisitor::OnPacketHeader(const QuicPacketHeader& header,
+                                     QuicTime receive_time,
+                                     EncryptionLevel level) {
+  QuicQlogEvent event =
+      NewEvent(QuicQlogEventType::kPacketReceived, receive_time);
+  if (header.packet_number.IsInitialized()) {
+    event.packet_number = header.packet_number.ToUint64();
+  }
+  event.packet_length = last_received_packet_length_;
+  event.encryption_level = level;
+  Record(event);
+}
+
+void QuicQlogVisitor::OnIncomingAck(
+    QuicPacketNumber /*ack_packet_number*/,
+    EncryptionLevel ack_decrypted_level,
+    const QuicAckFrame& /*ack_frame*/,
+    QuicTime ack_receive_time,
+    QuicPacketNumber largest_observed,
+    bool /*rtt_updated*/,
+    QuicPacketNumber /*least_unacked_sent_packet*/) {
+  const QuicSentPacketManager& sent_packet_manager =
+      connection_->sent_packet_manager();
+  QuicQlogEvent event =
+      NewEvent(QuicQlogEventType::kAckReceived, ack_receive_time);
+  if (largest_observed.IsInitialized()) {
+    event.packet_number = largest_observed.ToUint64();
+  }
+  event.encryption_level = ack_decrypted_level;
+  event.smoothed_rtt_us =
+      sent_packet_manager.GetRttStats()->smoothed_rtt().ToMicroseconds();
+  event.congestion_window = sent_packet_manager.GetCongestionWindowInBytes();
+  event.bytes_in_flight = sent_packet_manager.GetBytesInFlight();
+  Record(event);
+}
+
+void QuicQlogVisitor::OnPacketLoss(QuicPacketNumber lost_packet_number,
+                                   EncryptionLevel encryption_level,
+                                   TransmissionType transmission_type,
+                                   QuicTime detection_time) {
+  QuicQlogEvent event =
+      NewEvent(QuicQlogEventType::kPacketLost, detection_time);
+  event.packet_number = lost_packet_number.ToUint64();
+  event.encryption_level = encryption_level;
+  event.transmission_type = transmission_type;
+  Record(event);
+}
+
+void QuicQlogVisitor::OnConnectionClosed(
+    const QuicConnectionCloseFrame& frame,
+    ConnectionCloseSource /*source*/) {
+  QuicQlogEvent event =
+      NewEvent(QuicQlogEventType::kConnectionClosed,
+               connection_->clock()->ApproximateNow());
+  event.error_code = frame.quic_error_code;
+  // Always record the close so that truncated traces are identifiable.
+  if (ring_->TryPush(event)) {
+    ++events_recorded_;
+  }
+}
+
+QuicQlogEvent QuicQlogVisitor::NewEvent(QuicQlogEventType type,
+                                        QuicTime time) const {
+  QuicQlogEvent event;
+  event.type = type;
+  event.connection_tag = connection_tag_;
+  event.time_us = (time - QuicTime::Zero()).ToMicroseconds();
+  return event;
+}
+
+void QuicQlogVisitor::Record(const QuicQlogEvent& event) {
+  if (events_recorded_ >= max_events_) {
+    ++events_over_budget_;
+    return;
+  }
+  if (ring_->TryPush(event)) {
+    ++events_recorded_;
+  }
+}
+
+}  // namespace quic
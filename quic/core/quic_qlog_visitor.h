@@ -0,0 +1,88 @@
+// Copyright (c) 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef QUICHE_QUIC_CORE_QUIC_QLOG_VISITOR_H_
+#define QUICHE_QUIC_CORE_QUIC_QLOG_VISITOR_H_
+
+#include <cstdint>
+
+#include "quic/core/quic_connection.h"
+#include "quic/core/quic_qlog_writer.h"
+#include "quic/core/quic_types.h"
+#include "quic/platform/api/quic_export.h"
+
+namespace quic {
+
+// Streams qlog events for a QuicConnection into a QuicQlogEventRing owned by a
+// QuicQlogWriter.  Unlike QuicTraceVisitor, nothing is accumulated in memory:
+// each callback copies a fixed-size event into the ring, and the connection
+// stops recording once |max_events| have been recorded.  The ring must only
+// be used by the thread the connection runs on.
+class QUIC_EXPORT_PRIVATE QuicQlogVisitor : public QuicConnectionDebugVisitor {
+ public:
+  // |connection| and |ring| must outlive this visitor.
+  QuicQlogVisitor(const QuicConnection* connection,
+                  QuicQlogEventRing* ring,
+                  uint64_t max_events);
+
+  void OnPacketSent(QuicPacketNumber packet_number,
+                    QuicPacketLength packet_length,
+                    bool has_crypto_handshake,
+                    TransmissionType transmission_type,
+                    EncryptionLevel encryption_level,
+                    const QuicFrames& retransmittable_frames,
+                    const QuicFrames& nonretransmittable_frames,
+                    QuicTime sent_time) override;
+
+  void OnPacketReceived(const QuicSocketAddress& self_address,
+                        const QuicSocketAddress& peer_address,
+                        const QuicEncryptedPacket& packet) override;
+
+  void OnPacketHeader(const QuicPacketHeader& header,
+                      QuicTime receive_time,
+                      EncryptionLevel level) override;
+
+  void OnIncomingAck(QuicPacketNumber ack_packet_number,
+                     EncryptionLevel ack_decrypted_level,
+                     const QuicAckFrame& ack_frame,
+                     QuicTime ack_receive_time,
+                     QuicPacketNumber largest_observed,
+                     bool rtt_updated,
+                     QuicPacketNumber least_unacked_sent_packet) override;
+
+  void OnPacketLoss(QuicPacketNumber lost_packet_number,
+                    EncryptionLevel encryption_level,
+                    TransmissionType transmission_type,
+                    QuicTime detection_time) override;
+
+  void OnConnectionClosed(const QuicConnectionCloseFrame& frame,
+                          ConnectionCloseSource source) override;
+
+  // Number of events recorded into the ring, excluding dropped ones.
+  uint64_t events_recorded() const { return events_recorded_; }
+
+  // Number of events skipped because the budget was exhausted.
+  uint64_t events_over_budget() const { return events_over_budget_; }
+
+ private:
+  // Returns an event of |type| pre-populated with connection-wide fields.
+  QuicQlogEvent NewEvent(QuicQlogEventType type, QuicTime time) const;
+
+  // Pushes |event| into the ring if the budget allows it.
+  void Record(const QuicQlogEvent& event);
+
+  const QuicConnection* connection_;
+  QuicQlogEventRing* ring_;
+  const uint64_t max_events_;
+  const uint64_t connection_tag_;
+  // Length of the last packet passed to OnPacketReceived(), reported with the
+  // next parsed packet header.
+  QuicPacketLength last_received_packet_length_ = 0;
+  uint64_t events_recorded_ = 0;
+  uint64_t events_over_budget_ = 0;
+};
+
+}  // namespace quic
+
+#endif  // QUICHE_QUIC_CORE_QUIC_QLOG_VISITOR_H_
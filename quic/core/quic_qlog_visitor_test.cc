@@ -0,0 +1,130 @@
+// Copyright (c) 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "quic/core/quic_qlog_visitor.h"
+
+#include <vector>
+
+#include "quic/core/quic_constants.h"
+#include "quic/platform/api/quic_test.h"
+#include "quic/test_tools/quic_test_utils.h"
+#include "quic/test_tools/simulator/quic_endpoint.h"
+#include "quic/test_tools/simulator/simulator.h"
+#include "quic/test_tools/simulator/switch.h"
+
+namespace quic {
+namespace {
+
+const QuicByteCount kTransferSize = 1000 * kMaxOutgoingPacketSize;
+const QuicTime::Delta kDelay = QuicTime::Delta::FromMilliseconds(20);
+
+class QuicQlogVisitorTest : public QuicTest {
+ protected:
+  // Runs a lossy transfer from client to server while recording qlog events
+  // for the client into a ring of |ring_capacity| with a budget of
+  // |max_events|.
+  void RunTransfer(size_t ring_capacity, uint64_t max_events) {
+    QuicConnectionId connection_id = test::TestConnectionId();
+    simulator::Simulator simulator;
+    simulator::QuicEndpoint client(&simulator, "Client", "Server",
+                                   Perspective::IS_CLIENT, connection_id);
+    simulator::QuicEndpoint server(&simulator, "Server", "Client",
+                                   Perspective::IS_SERVER, connection_id);
+
+    const QuicBandwidth kBandwidth = QuicBandwidth::FromKBitsPerSecond(1000);
+    const QuicByteCount kBdp = kBandwidth * (2 * kDelay);
+
+    // Create parameters such that some loss is observed.
+    simulator::Switch network_switch(&simulator, "Switch", 8, 0.5 * kBdp);
+    simulator::SymmetricLink client_link(&client, network_switch.port(1),
+                                         2 * kBandwidth, kDelay);
+    simulator::SymmetricLink server_link(&server, network_switch.port(2),
+                                         kBandwidth, kDelay);
+
+    ring_ = std::make_unique<QuicQlogEventRing>(ring_capacity);
+    QuicQlogVisitor visitor(client.connection(), ring_.get(), max_events);
+    client.connection()->set_debug_visitor(&visitor);
+
+    const QuicTime::Delta kDeadline =
+        3 * kBandwidth.TransferTime(kTransferSize);
+    client.AddBytesToTransfer(kTransferSize);
+    bool simulator_result = simulator.RunUntilOrTimeout(
+        [&]() { return server.bytes_received() >= kTransferSize; }, kDeadline);
+    QUICHE_CHECK(simulator_result);
+    client.connection()->set_debug_visitor(nullptr);
+
+    ring_->PopBatch(ring_->capacity(), &events_);
+    events_recorded_ = visitor.events_recorded();
+    events_over_budget_ = visitor.events_over_budget();
+    packets_sent_ = client.connection()->GetStats().packets_sent;
+    packets_lost_ = client.connection()->GetStats().packets_lost;
+  }
+
+  size_t CountEvents(QuicQlogEventType type) const {
+    size_t count = 0;
+    for (const QuicQlogEvent& event : events_) {
+      if (event.type == type) {
+        ++count;
+      }
+    }
+    return count;
+  }
+
+  std::unique_ptr<QuicQlogEventRing> ring_;
+  std::vector<QuicQlogEvent> events_;
+  uint64_t events_recorded_ = 0;
+  uint64_t events_over_budget_ = 0;
+  QuicPacketCount packets_sent_ = 0;
+  QuicPacketCount packets_lost_ = 0;
+};
+
+TEST_F(QuicQlogVisitorTest, RecordsAllEvents) {
+  RunTransfer(/*ring_capacity=*/1 << 16, /*max_events=*/1 << 16);
+
+  EXPECT_EQ(0u, ring_->dropped_events());
+  EXPECT_EQ(0u, events_over_budget_);
+  EXPECT_EQ(events_recorded_, events_.size());
+  EXPECT_EQ(packets_sent_, CountEvents(QuicQlogEventType::kPacketSent));
+  EXPECT_EQ(packets_lost_, CountEvents(QuicQlogEventType::kPacketLost));
+  EXPECT_LT(0u, packets_lost_);
+  EXPECT_LT(0u, CountEvents(QuicQlogEventType::kPacketReceived));
+  ASSERT_LT(0u, CountEvents(QuicQlogEventType::kAckReceived));
+
+  const uint64_t expected_tag = 42;
+  QuicPacketNumber last_sent;
+  for (const QuicQlogEvent& event : events_) {
+    EXPECT_EQ(expected_tag, event.connection_tag);
+    if (event.type == QuicQlogEventType::kPacketSent) {
+      // Packets are recorded in the order they are sent.
+      EXPECT_TRUE(!last_sent.IsInitialized() ||
+                  last_sent < QuicPacketNumber(event.packet_number));
+      last_sent = QuicPacketNumber(event.packet_number);
+      EXPECT_LT(0u, event.packet_length);
+    }
+    if (event.type == QuicQlogEventType::kAckReceived) {
+      EXPECT_LT(0u, event.congestion_window);
+      EXPECT_LT(0, event.smoothed_rtt_us);
+    }
+  }
+}
+
+TEST_F(QuicQlogVisitorTest, StopsAtBudget) {
+  RunTransfer(/*ring_capacity=*/1 << 16, /*max_events=*/100);
+
+  EXPECT_EQ(100u, events_recorded_);
+  EXPECT_EQ(100u, events_.size());
+  EXPECT_LT(0u, events_over_budget_);
+  EXPECT_EQ(0u, ring_->dropped_events());
+}
+
+TEST_F(QuicQlogVisitorTest, DropsWhenRingIsFull) {
+  RunTransfer(/*ring_capacity=*/64, /*max_events=*/1 << 16);
+
+  EXPECT_EQ(64u, events_recorded_);
+  EXPECT_EQ(64u, events_.size());
+  EXPECT_LT(0u, ring_->dropped_events());
+}
+
+}  // namespace
+}  // namespace quic
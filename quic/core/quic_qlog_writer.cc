@@ -0,0 +1,254 @@
+// Copyright (c) 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "quic/core/quic_qlog_writer.h"
+
+#include <algorithm>
+
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/time/time.h"
+#include "quic/core/crypto/quic_random.h"
+#include "quic/platform/api/quic_bug_tracker.h"
+#include "quic/platform/api/quic_logging.h"
+
+namespace quic {
+
+namespace {
+
+// RFC 7464 record separator.
+const char kRecordSeparator = '\x1e';
+
+size_t RoundUpToPowerOfTwo(size_t value) {
+  size_t result = 1;
+  while (result < value) {
+    result <<= 1;
+  }
+  return result;
+}
+
+const char* QlogPacketType(EncryptionLevel level) {
+  switch (level) {
+    case ENCRYPTION_INITIAL:
+      return "initial";
+    case ENCRYPTION_HANDSHAKE:
+      return "handshake";
+    case ENCRYPTION_ZERO_RTT:
+      return "0RTT";
+    case ENCRYPTION_FORWARD_SECURE:
+      return "1RTT";
+    case NUM_ENCRYPTION_LEVELS:
+      break;
+  }
+  return "unknown";
+}
+
+void AppendPacketHeader(const QuicQlogEvent& event, std::string* output) {
+  absl::StrAppend(output, "\"header\":{\"packet_type\":\"",
+                  QlogPacketType(event.encryption_level),
+                  "\",\"packet_number\":", event.packet_number, "}");
+}
+
+}  // namespace
+
+std::string QuicQlogEventTypeToString(QuicQlogEventType type) {
+  switch (type) {
+    case QuicQlogEventType::kPacketSent:
+      return "transport:packet_sent";
+    case QuicQlogEventType::kPacketReceived:
+      return "transport:packet_received";
+    case QuicQlogEventType::kPacketLost:
+      return "recovery:packet_lost";
+    case QuicQlogEventType::kAckReceived:
+      return "recovery:metrics_updated";
+    case QuicQlogEventType::kConnectionClosed:
+      return "connectivity:connection_closed";
+  }
+  return absl::StrCat("Unknown(", static_cast<int>(type), ")");
+}
+
+QuicQlogEventRing::QuicQlogEventRing(size_t capacity)
+    : events_(RoundUpToPowerOfTwo(std::max<size_t>(capacity, 1))),
+      mask_(events_.size() - 1) {}
+
+bool QuicQlogEventRing::TryPush(const QuicQlogEvent& event) {
+  const uint64_t tail = tail_.load(std::memory_order_relaxed);
+  const uint64_t head = head_.load(std::memory_order_acquire);
+  if (tail - head >= events_.size()) {
+    dropped_events_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  events_[tail & mask_] = event;
+  tail_.store(tail + 1, std::memory_order_release);
+  return true;
+}
+
+size_t QuicQlogEventRing::PopBatch(size_t max_events,
+                                   std::vector<QuicQlogEvent>* out) {
+  const uint64_t head = head_.load(std::memory_order_relaxed);
+  const uint64_t tail = tail_.load(std::memory_order_acquire);
+  const size_t num_events =
+      static_cast<size_t>(std::min<uint64_t>(tail - head, max_events));
+  for (size_t i = 0; i < num_events; ++i) {
+    out->push_back(events_[(head + i) & mask_]);
+  }
+  head_.store(head + num_events, std::memory_order_release);
+  return num_events;
+}
+
+QuicQlogWriter::QuicQlogWriter(const Options& options, QuicQlogSink* sink)
+    : options_(options), sink_(sink) {}
+
+// static
+QuicWallTime QuicQlogWriter::ReferenceTime(const QuicClock& clock) {
+  return QuicWallTime::FromUNIXMicroseconds(
+      clock.ComputeCalibrationOffset().ToMicroseconds());
+}
+
+QuicQlogWriter::~QuicQlogWriter() {
+  Stop();
+}
+
+QuicQlogEventRing* QuicQlogWriter::CreateRing() {
+  QuicWriterMutexLock lock(&rings_lock_);
+  if (rings_.size() >= options_.max_rings) {
+    QUIC_LOG_FIRST_N(WARNING, 1)
+        << "Not tracing connections: all " << options_.max_rings
+        << " qlog rings are in use";
+    return nullptr;
+  }
+  rings_.push_back(std::make_unique<QuicQlogEventRing>(options_.ring_capacity));
+  return rings_.back().get();
+}
+
+bool QuicQlogWriter::ShouldSampleConnection(QuicRandom* random) const {
+  if (options_.sampling_rate <= 0) {
+    return false;
+  }
+  if (options_.sampling_rate >= 1) {
+    return true;
+  }
+  // Use the top 53 bits to get a uniform double in [0, 1).
+  const double sample =
+      static_cast<double>(random->InsecureRandUint64() >> 11) /
+      static_cast<double>(uint64_t{1} << 53);
+  return sample < options_.sampling_rate;
+}
+
+void QuicQlogWriter::Start() {
+  if (drain_thread_ != nullptr) {
+    QUIC_BUG(quic_bug_12913_1) << "QuicQlogWriter started twice";
+    return;
+  }
+  drain_thread_ = std::make_unique<DrainThread>(this);
+  drain_thread_->Start();
+}
+
+void QuicQlogWriter::Stop() {
+  if (drain_thread_ == nullptr) {
+    return;
+  }
+  drain_thread_->Quit();
+  drain_thread_->Join();
+  drain_thread_.reset();
+}
+
+size_t QuicQlogWriter::DrainOnce() {
+  std::vector<QuicQlogEventRing*> rings;
+  {
+    QuicReaderMutexLock lock(&rings_lock_);
+    for (const auto& ring : rings_) {
+      rings.push_back(ring.get());
+    }
+  }
+
+  QuicWriterMutexLock lock(&drain_lock_);
+  buffer_.clear();
+  if (!header_written_) {
+    // Event times are QuicTime offsets, so they are written relative to the
+    // wall time of QuicTime::Zero().
+    absl::StrAppend(
+        &buffer_, std::string(1, kRecordSeparator),
+        "{\"qlog_version\":\"0.3\",\"qlog_format\":\"JSON-SEQ\","
+        "\"trace\":{\"common_fields\":{\"time_format\":\"relative\",",
+        absl::StrFormat(
+            "\"reference_time\":%.3f}}}\n",
+            options_.reference_time.ToUNIXMicroseconds() / 1000.0));
+    header_written_ = true;
+  }
+  size_t num_events = 0;
+  for (QuicQlogEventRing* ring : rings) {
+    batch_.clear();
+    num_events += ring->PopBatch(options_.max_events_per_drain, &batch_);
+    for (const QuicQlogEvent& event : batch_) {
+      SerializeEvent(event, &buffer_);
+    }
+  }
+  if (!buffer_.empty()) {
+    sink_->Write(buffer_);
+  }
+  events_written_.fetch_add(num_events, std::memory_order_relaxed);
+  return num_events;
+}
+
+// static
+void QuicQlogWriter::SerializeEvent(const QuicQlogEvent& event,
+                                    std::string* output) {
+  absl::StrAppend(output, std::string(1, kRecordSeparator),
+                  absl::StrFormat("{\"time\":%.3f,", event.time_us / 1000.0),
+                  "\"name\":\"", QuicQlogEventTypeToString(event.type),
+                  "\",\"group_id\":\"",
+                  absl::StrFormat("%016x", event.connection_tag),
+                  "\",\"data\":{");
+  switch (event.type) {
+    case QuicQlogEventType::kPacketSent:
+      AppendPacketHeader(event, output);
+      absl::StrAppend(output, ",\"raw\":{\"length\":", event.packet_length,
+                      "},\"transmission_type\":\"",
+                      TransmissionTypeToString(event.transmission_type), "\"");
+      break;
+    case QuicQlogEventType::kPacketReceived:
+      AppendPacketHeader(event, output);
+      absl::StrAppend(output, ",\"raw\":{\"length\":", event.packet_length,
+                      "}");
+      break;
+    case QuicQlogEventType::kPacketLost:
+      AppendPacketHeader(event, output);
+      absl::StrAppend(output, ",\"transmission_type\":\"",
+                      TransmissionTypeToString(event.transmission_type), "\"");
+      break;
+    case QuicQlogEventType::kAckReceived:
+      absl::StrAppend(
+          output, "\"largest_acked\":", event.packet_number,
+          absl::StrFormat(",\"smoothed_rtt\":%.3f",
+                          event.smoothed_rtt_us / 1000.0),
+          ",\"congestion_window\":", event.congestion_window,
+          ",\"bytes_in_flight\":", event.bytes_in_flight);
+      break;
+    case QuicQlogEventType::kConnectionClosed:
+      absl::StrAppend(output, "\"error_code\":", event.error_code);
+      break;
+  }
+  absl::StrAppend(output, "}}\n");
+}
+
+uint64_t QuicQlogWriter::dropped_events() const {
+  QuicReaderMutexLock lock(&rings_lock_);
+  uint64_t dropped = 0;
+  for (const auto& ring : rings_) {
+    dropped += ring->dropped_events();
+  }
+  return dropped;
+}
+
+void QuicQlogWriter::DrainThread::Run() {
+  const absl::Duration interval =
+      absl::Microseconds(writer_->options().drain_interval.ToMicroseconds());
+  while (!quitting_.WaitForNotificationWithTimeout(interval)) {
+    writer_->DrainOnce();
+  }
+  writer_->DrainOnce();
+}
+
+}  // namespace quic
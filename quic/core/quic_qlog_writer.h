@@ -0,0 +1,202 @@
+// Copyright (c) 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef QUICHE_QUIC_CORE_QUIC_QLOG_WRITER_H_
+#define QUICHE_QUIC_CORE_QUIC_QLOG_WRITER_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/notification.h"
+#include "quic/core/quic_clock.h"
+#include "quic/core/quic_time.h"
+#include "quic/core/quic_types.h"
+#include "quic/platform/api/quic_export.h"
+#include "quic/platform/api/quic_mutex.h"
+#include "quic/platform/api/quic_thread.h"
+
+namespace quic {
+
+class QuicRandom;
+
+enum class QuicQlogEventType : uint8_t {
+  kPacketSent,
+  kPacketReceived,
+  kPacketLost,
+  kAckReceived,
+  kConnectionClosed,
+};
+
+QUIC_EXPORT_PRIVATE std::string QuicQlogEventTypeToString(
+    QuicQlogEventType type);
+
+// A fixed-size, trivially copyable qlog event.  Events are recorded on the
+// connection's thread and serialized only when drained by QuicQlogWriter, so
+// recording an event never allocates.
+struct QUIC_EXPORT_PRIVATE QuicQlogEvent {
+  QuicQlogEventType type = QuicQlogEventType::kPacketSent;
+  EncryptionLevel encryption_level = ENCRYPTION_INITIAL;
+  TransmissionType transmission_type = NOT_RETRANSMISSION;
+  QuicPacketLength packet_length = 0;
+  // The first 8 bytes of the connection's server connection ID, used as the
+  // qlog group_id.
+  uint64_t connection_tag = 0;
+  // Microseconds since QuicTime::Zero().
+  int64_t time_us = 0;
+  uint64_t packet_number = 0;
+  // Only set for kAckReceived.
+  int64_t smoothed_rtt_us = 0;
+  QuicByteCount congestion_window = 0;
+  QuicByteCount bytes_in_flight = 0;
+  // Only set for kConnectionClosed.
+  uint64_t error_code = 0;
+};
+
+// A single-producer single-consumer lock-free ring of QuicQlogEvents.  Each
+// event loop thread owns one ring and is its only producer; QuicQlogWriter is
+// the only consumer.  When the ring is full new events are dropped and
+// counted rather than blocking the producer.
+class QUIC_EXPORT_PRIVATE QuicQlogEventRing {
+ public:
+  // |capacity| is rounded up to a power of two.
+  explicit QuicQlogEventRing(size_t capacity);
+  QuicQlogEventRing(const QuicQlogEventRing&) = delete;
+  QuicQlogEventRing& operator=(const QuicQlogEventRing&) = delete;
+
+  // Called by the producer.  Returns false if the event was dropped.
+  bool TryPush(const QuicQlogEvent& event);
+
+  // Called by the consumer.  Appends up to |max_events| events to |out| and
+  // returns the number appended.
+  size_t PopBatch(size_t max_events, std::vector<QuicQlogEvent>* out);
+
+  size_t capacity() const { return events_.size(); }
+
+  // Number of events dropped because the ring was full.
+  uint64_t dropped_events() const {
+    return dropped_events_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  std::vector<QuicQlogEvent> events_;
+  const uint64_t mask_;
+  // Index of the next event to be read.  Written only by the consumer.
+  std::atomic<uint64_t> head_{0};
+  // Index of the next event to be written.  Written only by the producer.
+  std::atomic<uint64_t> tail_{0};
+  std::atomic<uint64_t> dropped_events_{0};
+};
+
+// Receives serialized qlog records from QuicQlogWriter.  Called only on the
+// writer's thread (or the thread calling DrainOnce()).
+class QUIC_EXPORT_PRIVATE QuicQlogSink {
+ public:
+  virtual ~QuicQlogSink() {}
+
+  // |records| holds one or more complete JSON-SEQ (RFC 7464) records, each
+  // including the leading record separator and the trailing newline.
+  virtual void Write(absl::string_view records) = 0;
+};
+
+// Owns the per-thread event rings and drains them into a QuicQlogSink, either
+// on a background thread started via Start() or synchronously via
+// DrainOnce().  Overhead on the connection thread is bounded by the sampling
+// rate and the per-connection event budget; memory is bounded by
+// |ring_capacity| * |max_rings| events.
+class QUIC_EXPORT_PRIVATE QuicQlogWriter {
+ public:
+  struct QUIC_EXPORT_PRIVATE Options {
+    // Fraction of connections to trace, in [0, 1].
+    double sampling_rate = 0.01;
+    // Number of events each per-thread ring can hold.
+    size_t ring_capacity = 16 * 1024;
+    // Maximum number of rings that CreateRing() hands out.
+    size_t max_rings = 64;
+    // Maximum number of events a single connection may record.
+    uint64_t max_events_per_connection = 10000;
+    // Maximum number of events serialized per ring in each drain pass.
+    size_t max_events_per_drain = 4096;
+    // How often the background thread drains the rings.
+    QuicTime::Delta drain_interval = QuicTime::Delta::FromMilliseconds(100);
+    // Wall time of QuicTime::Zero() on the clock of the traced connections,
+    // written as the trace's reference_time.  Event times are relative to it.
+    // See ReferenceTime().
+    QuicWallTime reference_time = QuicWallTime::Zero();
+  };
+
+  // Returns the wall time of QuicTime::Zero() on |clock|.
+  static QuicWallTime ReferenceTime(const QuicClock& clock);
+
+  // |sink| must outlive this writer.
+  QuicQlogWriter(const Options& options, QuicQlogSink* sink);
+  QuicQlogWriter(const QuicQlogWriter&) = delete;
+  QuicQlogWriter& operator=(const QuicQlogWriter&) = delete;
+  ~QuicQlogWriter();
+
+  // Creates a ring to be used by a single event loop thread.  The ring is
+  // owned by the writer.  Returns nullptr if |max_rings| is exhausted.
+  QuicQlogEventRing* CreateRing();
+
+  // Returns true if a new connection should be traced.
+  bool ShouldSampleConnection(QuicRandom* random) const;
+
+  // Starts draining the rings on a background thread.
+  void Start();
+
+  // Stops the background thread, if any, after a final drain.
+  void Stop();
+
+  // Drains all rings into the sink.  Returns the number of events written.
+  size_t DrainOnce();
+
+  // Serializes |event| as a JSON-SEQ record and appends it to |output|.
+  static void SerializeEvent(const QuicQlogEvent& event, std::string* output);
+
+  const Options& options() const { return options_; }
+
+  uint64_t events_written() const {
+    return events_written_.load(std::memory_order_relaxed);
+  }
+
+  // Total number of events dropped across all rings.
+  uint64_t dropped_events() const;
+
+ private:
+  class DrainThread : public QuicThread {
+   public:
+    explicit DrainThread(QuicQlogWriter* writer)
+        : QuicThread("QuicQlogWriter"), writer_(writer) {}
+
+    void Quit() { quitting_.Notify(); }
+
+   protected:
+    void Run() override;
+
+   private:
+    QuicQlogWriter* writer_;
+    absl::Notification quitting_;
+  };
+
+  const Options options_;
+  QuicQlogSink* sink_;
+  mutable QuicMutex rings_lock_;
+  std::vector<std::unique_ptr<QuicQlogEventRing>> rings_
+      QUIC_GUARDED_BY(rings_lock_);
+  // Serializes DrainOnce() between the drain thread and other callers.
+  QuicMutex drain_lock_;
+  std::vector<QuicQlogEvent> batch_ QUIC_GUARDED_BY(drain_lock_);
+  std::string buffer_ QUIC_GUARDED_BY(drain_lock_);
+  bool header_written_ QUIC_GUARDED_BY(drain_lock_) = false;
+  std::atomic<uint64_t> events_written_{0};
+  std::unique_ptr<DrainThread> drain_thread_;
+};
+
+}  // namespace quic
+
+#endif  // QUICHE_QUIC_CORE_QUIC_QLOG_WRITER_H_
@@ -0,0 +1,209 @@
+// Copyright (c) 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "quic/core/quic_qlog_writer.h"
+
+#include <string>
+#include <vector>
+
+#include "absl/strings/str_split.h"
+#include "quic/platform/api/quic_test.h"
+#include "quic/test_tools/quic_test_utils.h"
+
+namespace quic {
+namespace test {
+namespace {
+
+class RecordingSink : public QuicQlogSink {
+ public:
+  void Write(absl::string_view records) override {
+    output_.append(records.data(), records.size());
+  }
+
+  // Returns the records written so far, without separators.
+  std::vector<std::string> Records() const {
+    std::vector<std::string> records;
+    for (absl::string_view record : absl::StrSplit(output_, '\x1e')) {
+      if (!record.empty()) {
+        records.emplace_back(record);
+      }
+    }
+    return records;
+  }
+
+ private:
+  std::string output_;
+};
+
+QuicQlogEvent PacketSentEvent(uint64_t packet_number) {
+  QuicQlogEvent event;
+  event.type = QuicQlogEventType::kPacketSent;
+  event.encryption_level = ENCRYPTION_FORWARD_SECURE;
+  event.transmission_type = NOT_RETRANSMISSION;
+  event.packet_length = 1200;
+  event.connection_tag = 0x1234;
+  event.time_us = 1500;
+  event.packet_number = packet_number;
+  return event;
+}
+
+class QuicQlogWriterTest : public QuicTest {};
+
+TEST_F(QuicQlogWriterTest, RingRoundsUpCapacity) {
+  QuicQlogEventRing ring(5);
+  EXPECT_EQ(8u, ring.capacity());
+}
+
+TEST_F(QuicQlogWriterTest, RingPushAndPop) {
+  QuicQlogEventRing ring(4);
+  for (uint64_t i = 1; i <= 4; ++i) {
+    EXPECT_TRUE(ring.TryPush(PacketSentEvent(i)));
+  }
+  EXPECT_FALSE(ring.TryPush(PacketSentEvent(5)));
+  EXPECT_EQ(1u, ring.dropped_events());
+
+  std::vector<QuicQlogEvent> events;
+  EXPECT_EQ(3u, ring.PopBatch(3, &events));
+  ASSERT_EQ(3u, events.size());
+  EXPECT_EQ(1u, events[0].packet_number);
+  EXPECT_EQ(3u, events[2].packet_number);
+
+  // Popping frees up space, including across the wrap-around point.
+  for (uint64_t i = 6; i <= 8; ++i) {
+    EXPECT_TRUE(ring.TryPush(PacketSentEvent(i)));
+  }
+  events.clear();
+  EXPECT_EQ(4u, ring.PopBatch(10, &events));
+  ASSERT_EQ(4u, events.size());
+  EXPECT_EQ(4u, events[0].packet_number);
+  EXPECT_EQ(8u, events[3].packet_number);
+  EXPECT_EQ(0u, ring.PopBatch(10, &events));
+}
+
+TEST_F(QuicQlogWriterTest, SerializePacketSent) {
+  std::string output;
+  QuicQlogWriter::SerializeEvent(PacketSentEvent(7), &output);
+  EXPECT_EQ(
+      "\x1e{\"time\":1.500,\"name\":\"transport:packet_sent\","
+      "\"group_id\":\"0000000000001234\",\"data\":{\"header\":{"
+      "\"packet_type\":\"1RTT\",\"packet_number\":7},\"raw\":{\"length\":1200}"
+      ",\"transmission_type\":\"NOT_RETRANSMISSION\"}}\n",
+      output);
+}
+
+TEST_F(QuicQlogWriterTest, SerializeMetricsUpdated) {
+  QuicQlogEvent event;
+  event.type = QuicQlogEventType::kAckReceived;
+  event.time_us = 2000;
+  event.packet_number = 10;
+  event.smoothed_rtt_us = 25250;
+  event.congestion_window = 14520;
+  event.bytes_in_flight = 2400;
+  std::string output;
+  QuicQlogWriter::SerializeEvent(event, &output);
+  EXPECT_EQ(
+      "\x1e{\"time\":2.000,\"name\":\"recovery:metrics_updated\","
+      "\"group_id\":\"0000000000000000\",\"data\":{\"largest_acked\":10,"
+      "\"smoothed_rtt\":25.250,\"congestion_window\":14520,"
+      "\"bytes_in_flight\":2400}}\n",
+      output);
+}
+
+TEST_F(QuicQlogWriterTest, DrainOnce) {
+  RecordingSink sink;
+  QuicQlogWriter::Options options;
+  options.ring_capacity = 16;
+  options.max_rings = 2;
+  options.max_events_per_drain = 3;
+  QuicQlogWriter writer(options, &sink);
+
+  QuicQlogEventRing* ring1 = writer.CreateRing();
+  QuicQlogEventRing* ring2 = writer.CreateRing();
+  ASSERT_NE(nullptr, ring1);
+  ASSERT_NE(nullptr, ring2);
+  EXPECT_EQ(nullptr, writer.CreateRing());
+
+  for (uint64_t i = 1; i <= 4; ++i) {
+    ring1->TryPush(PacketSentEvent(i));
+  }
+  ring2->TryPush(PacketSentEvent(100));
+
+  // At most |max_events_per_drain| events are taken from each ring.
+  EXPECT_EQ(4u, writer.DrainOnce());
+  EXPECT_EQ(1u, writer.DrainOnce());
+  EXPECT_EQ(0u, writer.DrainOnce());
+  EXPECT_EQ(5u, writer.events_written());
+  EXPECT_EQ(0u, writer.dropped_events());
+
+  std::vector<std::string> records = sink.Records();
+  ASSERT_EQ(6u, records.size());
+  // The first record is the qlog header.
+  EXPECT_NE(std::string::npos, records[0].find("\"qlog_format\":\"JSON-SEQ\""));
+  for (size_t i = 1; i < records.size(); ++i) {
+    EXPECT_NE(std::string::npos, records[i].find("transport:packet_sent"));
+    EXPECT_EQ('\n', records[i].back());
+  }
+}
+
+TEST_F(QuicQlogWriterTest, HeaderHasReferenceTime) {
+  RecordingSink sink;
+  QuicQlogWriter::Options options;
+  options.reference_time = QuicWallTime::FromUNIXMicroseconds(1634567890123456);
+  QuicQlogWriter writer(options, &sink);
+  EXPECT_EQ(0u, writer.DrainOnce());
+
+  // Event times are offsets from QuicTime::Zero(), so the trace is relative
+  // to its wall time.
+  std::vector<std::string> records = sink.Records();
+  ASSERT_EQ(1u, records.size());
+  EXPECT_EQ(
+      "{\"qlog_version\":\"0.3\",\"qlog_format\":\"JSON-SEQ\","
+      "\"trace\":{\"common_fields\":{\"time_format\":\"relative\","
+      "\"reference_time\":1634567890123.456}}}\n",
+      records[0]);
+}
+
+TEST_F(QuicQlogWriterTest, DrainThread) {
+  RecordingSink sink;
+  QuicQlogWriter::Options options;
+  options.drain_interval = QuicTime::Delta::FromMilliseconds(1);
+  QuicQlogWriter writer(options, &sink);
+  QuicQlogEventRing* ring = writer.CreateRing();
+  ASSERT_NE(nullptr, ring);
+
+  writer.Start();
+  for (uint64_t i = 1; i <= 100; ++i) {
+    ring->TryPush(PacketSentEvent(i));
+  }
+  // Stopping performs a final drain.
+  writer.Stop();
+  EXPECT_EQ(100u, writer.events_written() + writer.dropped_events());
+  EXPECT_EQ(writer.events_written() + 1, sink.Records().size());
+}
+
+TEST_F(QuicQlogWriterTest, Sampling) {
+  RecordingSink sink;
+  SimpleRandom random;
+  QuicQlogWriter::Options options;
+
+  options.sampling_rate = 0;
+  EXPECT_FALSE(QuicQlogWriter(options, &sink).ShouldSampleConnection(&random));
+  options.sampling_rate = 1;
+  EXPECT_TRUE(QuicQlogWriter(options, &sink).ShouldSampleConnection(&random));
+
+  options.sampling_rate = 0.1;
+  QuicQlogWriter writer(options, &sink);
+  int sampled = 0;
+  for (int i = 0; i < 10000; ++i) {
+    if (writer.ShouldSampleConnection(&random)) {
+      ++sampled;
+    }
+  }
+  EXPECT_LT(800, sampled);
+  EXPECT_GT(1200, sampled);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace quic
@@ -70,7 +70,8 @@ void QuicReceivedPacketManager::SetFromConfig(const QuicConfig& config,
 
 void QuicReceivedPacketManager::RecordPacketReceived(
     const QuicPacketHeader& header,
-    QuicTime receipt_time) {
+    QuicTime receipt_time,
+    QuicEcnCodepoint ecn_codepoint) {
   const QuicPacketNumber packet_number = header.packet_number;
   QUICHE_DCHECK(IsAwaitingPacket(packet_number))
       << " packet_number:" << packet_number;
@@ -99,6 +100,28 @@ void QuicReceivedPacketManager::RecordPacketReceived(
   }
   ack_frame_.packets.Add(packet_number);
 
+  if (ecn_codepoint != ECN_NOT_ECT) {
+    // ECN counts are cumulative, and once populated are sent in every ack
+    // frame of this packet number space.
+    ack_frame_.ecn_counters_populated = true;
+    switch (ecn_codepoint) {
+      case ECN_ECT0:
+        ++ack_frame_.ect_0_count;
+        ++stats_->ecn_packets_received.ect0;
+        break;
+      case ECN_ECT1:
+        ++ack_frame_.ect_1_count;
+        ++stats_->ecn_packets_received.ect1;
+        break;
+      case ECN_CE:
+        ++ack_frame_.ecn_ce_count;
+        ++stats_->ecn_packets_received.ce;
+        break;
+      case ECN_NOT_ECT:
+        break;
+    }
+  }
+
   if (save_timestamps_) {
     // The timestamp format only handles packets in time order.
     if (!ack_frame_.received_packet_times.empty() &&
@@ -56,7 +56,7 @@ class QuicReceivedPacketManagerTest : public QuicTest {
   void RecordPacketReceipt(uint64_t packet_number, QuicTime receipt_time) {
     QuicPacketHeader header;
     header.packet_number = QuicPacketNumber(packet_number);
-    received_manager_.RecordPacketReceived(header, receipt_time);
+    received_manager_.RecordPacketReceived(header, receipt_time, ECN_NOT_ECT);
   }
 
   bool HasPendingAck() {
@@ -90,9 +90,9 @@ class QuicReceivedPacketManagerTest : public QuicTest {
 TEST_F(QuicReceivedPacketManagerTest, DontWaitForPacketsBefore) {
   QuicPacketHeader header;
   header.packet_number = QuicPacketNumber(2u);
-  received_manager_.RecordPacketReceived(header, QuicTime::Zero());
+  received_manager_.RecordPacketReceived(header, QuicTime::Zero(), ECN_NOT_ECT);
   header.packet_number = QuicPacketNumber(7u);
-  received_manager_.RecordPacketReceived(header, QuicTime::Zero());
+  received_manager_.RecordPacketReceived(header, QuicTime::Zero(), ECN_NOT_ECT);
   EXPECT_TRUE(received_manager_.IsAwaitingPacket(QuicPacketNumber(3u)));
   EXPECT_TRUE(received_manager_.IsAwaitingPacket(QuicPacketNumber(6u)));
   received_manager_.DontWaitForPacketsBefore(QuicPacketNumber(4));
@@ -105,7 +105,7 @@ TEST_F(QuicReceivedPacketManagerTest, GetUpdatedAckFrame) {
   header.packet_number = QuicPacketNumber(2u);
   QuicTime two_ms = QuicTime::Zero() + QuicTime::Delta::FromMilliseconds(2);
   EXPECT_FALSE(received_manager_.ack_frame_updated());
-  received_manager_.RecordPacketReceived(header, two_ms);
+  received_manager_.RecordPacketReceived(header, two_ms, ECN_NOT_ECT);
   EXPECT_TRUE(received_manager_.ack_frame_updated());
 
   QuicFrame ack = received_manager_.GetUpdatedAckFrame(QuicTime::Zero());
@@ -128,11 +128,11 @@ TEST_F(QuicReceivedPacketManagerTest, GetUpdatedAckFrame) {
   EXPECT_EQ(1u, ack.ack_frame->received_packet_times.size());
 
   header.packet_number = QuicPacketNumber(999u);
-  received_manager_.RecordPacketReceived(header, two_ms);
+  received_manager_.RecordPacketReceived(header, two_ms, ECN_NOT_ECT);
   header.packet_number = QuicPacketNumber(4u);
-  received_manager_.RecordPacketReceived(header, two_ms);
+  received_manager_.RecordPacketReceived(header, two_ms, ECN_NOT_ECT);
   header.packet_number = QuicPacketNumber(1000u);
-  received_manager_.RecordPacketReceived(header, two_ms);
+  received_manager_.RecordPacketReceived(header, two_ms, ECN_NOT_ECT);
   EXPECT_TRUE(received_manager_.ack_frame_updated());
   ack = received_manager_.GetUpdatedAckFrame(two_ms);
   received_manager_.ResetAckStates();
@@ -155,6 +155,31 @@ TEST_F(QuicReceivedPacketManagerTest, UpdateReceivedConnectionStats) {
   EXPECT_EQ(1u, stats_.packets_reordered);
 }
 
+TEST_F(QuicReceivedPacketManagerTest, EcnCounts) {
+  QuicPacketHeader header;
+  header.packet_number = QuicPacketNumber(1u);
+  received_manager_.RecordPacketReceived(header, QuicTime::Zero(), ECN_NOT_ECT);
+  QuicFrame ack = received_manager_.GetUpdatedAckFrame(QuicTime::Zero());
+  EXPECT_FALSE(ack.ack_frame->ecn_counters_populated);
+
+  header.packet_number = QuicPacketNumber(2u);
+  received_manager_.RecordPacketReceived(header, QuicTime::Zero(), ECN_ECT0);
+  header.packet_number = QuicPacketNumber(3u);
+  received_manager_.RecordPacketReceived(header, QuicTime::Zero(), ECN_ECT0);
+  header.packet_number = QuicPacketNumber(4u);
+  received_manager_.RecordPacketReceived(header, QuicTime::Zero(), ECN_CE);
+  header.packet_number = QuicPacketNumber(5u);
+  received_manager_.RecordPacketReceived(header, QuicTime::Zero(), ECN_ECT1);
+  ack = received_manager_.GetUpdatedAckFrame(QuicTime::Zero());
+  EXPECT_TRUE(ack.ack_frame->ecn_counters_populated);
+  EXPECT_EQ(2u, ack.ack_frame->ect_0_count);
+  EXPECT_EQ(1u, ack.ack_frame->ect_1_count);
+  EXPECT_EQ(1u, ack.ack_frame->ecn_ce_count);
+  EXPECT_EQ(2u, stats_.ecn_packets_received.ect0);
+  EXPECT_EQ(1u, stats_.ecn_packets_received.ect1);
+  EXPECT_EQ(1u, stats_.ecn_packets_received.ce);
+}
+
 TEST_F(QuicReceivedPacketManagerTest, LimitAckRanges) {
   received_manager_.set_max_ack_ranges(10);
   EXPECT_FALSE(received_manager_.ack_frame_updated());
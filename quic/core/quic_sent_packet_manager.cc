@@ -118,7 +118,9 @@ QuicSentPacketManager::QuicSentPacketManager(
       pto_multiplier_without_rtt_samples_(3),
       num_ptos_for_path_degrading_(0),
       ignore_pings_(false),
-      ignore_ack_delay_(false) {
+      ignore_ack_delay_(false),
+      send_ecn_(GetQuicReloadableFlag(quic_send_ecn)),
+      ecn_enabled_(false) {
   SetSendAlgorithm(congestion_control_type);
   if (pto_enabled_) {
     QUIC_RELOADABLE_FLAG_COUNT_N(quic_default_on_pto, 1, 2);
@@ -245,14 +247,29 @@ void QuicSentPacketManager::SetFromConfig(const QuicConfig& config) {
     QUIC_RELOADABLE_FLAG_COUNT(quic_allow_client_enabled_bbr_v2);
     SetSendAlgorithm(kBBRv2);
   }
+  if (GetQuicReloadableFlag(quic_allow_client_enabled_bbr_v3) &&
+      config.HasClientRequestedIndependentOption(kB3ON, perspective)) {
+    QUIC_RELOADABLE_FLAG_COUNT(quic_allow_client_enabled_bbr_v3);
+    SetSendAlgorithm(kBBRv3);
+  }
 
-  if (config.HasClientRequestedIndependentOption(kRENO, perspective)) {
+  if (send_ecn_ &&
+      config.HasClientRequestedIndependentOption(kPRGE, perspective)) {
+    QUIC_RELOADABLE_FLAG_COUNT_N(quic_send_ecn, 1, 2);
+    SetSendAlgorithm(kPragueBytes);
+    ecn_enabled_ = true;
+  } else if (config.HasClientRequestedIndependentOption(kRENO, perspective)) {
     SetSendAlgorithm(kRenoBytes);
   } else if (config.HasClientRequestedIndependentOption(kBYTE, perspective) ||
              (GetQuicReloadableFlag(quic_default_to_bbr) &&
               config.HasClientRequestedIndependentOption(kQBIC, perspective))) {
     SetSendAlgorithm(kCubicBytes);
   }
+  if (send_ecn_ && !ecn_enabled_ &&
+      config.HasClientRequestedIndependentOption(kECNS, perspective)) {
+    QUIC_RELOADABLE_FLAG_COUNT_N(quic_send_ecn, 2, 2);
+    ecn_enabled_ = true;
+  }
 
   // Initial window.
   if (GetQuicReloadableFlag(quic_unified_iw_options)) {
@@ -341,7 +358,9 @@ void QuicSentPacketManager::SetFromConfig(const QuicConfig& config) {
 void QuicSentPacketManager::ApplyConnectionOptions(
     const QuicTagVector& connection_options) {
   absl::optional<CongestionControlType> cc_type;
-  if (ContainsQuicTag(connection_options, kB2ON)) {
+  if (ContainsQuicTag(connection_options, kB3ON)) {
+    cc_type = kBBRv3;
+  } else if (ContainsQuicTag(connection_options, kB2ON)) {
     cc_type = kBBRv2;
   } else if (ContainsQuicTag(connection_options, kTBBR)) {
     cc_type = kBBR;
@@ -802,7 +821,8 @@ bool QuicSentPacketManager::OnPacketSent(
     QuicTime sent_time,
     TransmissionType transmission_type,
     HasRetransmittableData has_retransmittable_data,
-    bool measure_rtt) {
+    bool measure_rtt,
+    QuicEcnCodepoint ecn_codepoint) {
   const SerializedPacket& packet = *mutable_packet;
   QuicPacketNumber packet_number = packet.packet_number;
   QUICHE_DCHECK_LE(FirstSendingPacketNumber(), packet_number);
@@ -848,12 +868,26 @@ bool QuicSentPacketManager::OnPacketSent(
       }
     }
   }
+  const EncryptionLevel encryption_level = packet.encryption_level;
   unacked_packets_.AddSentPacket(mutable_packet, transmission_type, sent_time,
                                  in_flight, measure_rtt);
+  if (ecn_codepoint != ECN_NOT_ECT) {
+    unacked_packets_.GetMutableTransmissionInfo(packet_number)->ecn_codepoint =
+        ecn_codepoint;
+    ecn_tracker_.OnPacketSent(
+        unacked_packets_.GetPacketNumberSpace(encryption_level), ecn_codepoint);
+  }
   // Reset the retransmission timer anytime a pending packet is sent.
   return in_flight;
 }
 
+QuicEcnCodepoint QuicSentPacketManager::GetEcnCodepointToSend() const {
+  if (!ecn_enabled_ || !ecn_tracker_.ShouldMarkPackets()) {
+    return ECN_NOT_ECT;
+  }
+  return send_algorithm_->GetEcnCodepointToSend();
+}
+
 QuicSentPacketManager::RetransmissionTimeoutMode
 QuicSentPacketManager::OnRetransmissionTimeout() {
   QUICHE_DCHECK(unacked_packets_.HasInFlightPackets() ||
@@ -1168,6 +1202,7 @@ void QuicSentPacketManager::InvokeLossDetection(QuicTime time) {
     QuicTransmissionInfo* info =
         unacked_packets_.GetMutableTransmissionInfo(packet.packet_number);
     ++stats_->packets_lost;
+    ecn_tracker_.OnPacketLost(info->ecn_codepoint);
     if (debug_delegate_ != nullptr) {
       debug_delegate_->OnPacketLoss(packet.packet_number,
                                     info->encryption_level, LOSS_RETRANSMISSION,
@@ -1208,6 +1243,11 @@ bool QuicSentPacketManager::MaybeUpdateRTT(QuicPacketNumber largest_acked,
   QuicTime::Delta send_delta = ack_receive_time - transmission_info.sent_time;
   const bool min_rtt_available = !rtt_stats_.min_rtt().IsZero();
   rtt_stats_.UpdateRtt(send_delta, ack_delay_time, ack_receive_time);
+  if (stats_->latency_histograms) {
+    QUIC_RELOADABLE_FLAG_COUNT_N(quic_record_latency_histograms, 1, 4);
+    stats_->latency_histograms->rtt.Add(rtt_stats_.latest_rtt());
+    stats_->latency_histograms->ack_delay.Add(ack_delay_time);
+  }
 
   if (!min_rtt_available && !rtt_stats_.min_rtt().IsZero()) {
     loss_algorithm_->OnMinRttAvailable();
@@ -1458,7 +1498,8 @@ const QuicTime::Delta QuicSentPacketManager::GetProbeTimeoutDelay(
 
 QuicTime::Delta QuicSentPacketManager::GetSlowStartDuration() const {
   if (send_algorithm_->GetCongestionControlType() == kBBR ||
-      send_algorithm_->GetCongestionControlType() == kBBRv2) {
+      send_algorithm_->GetCongestionControlType() == kBBRv2 ||
+      send_algorithm_->GetCongestionControlType() == kBBRv3) {
     return stats_->slowstart_duration.GetTotalElapsedTime(
         clock_->ApproximateNow());
   }
@@ -1544,6 +1585,7 @@ void QuicSentPacketManager::OnAckFrameStart(QuicPacketNumber largest_acked,
       MaybeUpdateRTT(largest_acked, ack_delay_time, ack_receive_time);
   last_ack_frame_.ack_delay_time = ack_delay_time;
   acked_packets_iter_ = last_ack_frame_.packets.rbegin();
+  last_ack_ecn_counts_.reset();
 }
 
 void QuicSentPacketManager::OnAckRange(QuicPacketNumber start,
@@ -1584,6 +1626,10 @@ void QuicSentPacketManager::OnAckRange(QuicPacketNumber start,
   } while (start < end);
 }
 
+void QuicSentPacketManager::OnAckEcnCounts(const QuicEcnCounts& ecn_counts) {
+  last_ack_ecn_counts_ = ecn_counts;
+}
+
 void QuicSentPacketManager::OnAckTimestamp(QuicPacketNumber packet_number,
                                            QuicTime timestamp) {
   last_ack_frame_.received_packet_times.push_back({packet_number, timestamp});
@@ -1600,6 +1646,13 @@ AckResult QuicSentPacketManager::OnAckFrameEnd(
     QuicPacketNumber ack_packet_number,
     EncryptionLevel ack_decrypted_level) {
   QuicByteCount prior_bytes_in_flight = unacked_packets_.bytes_in_flight();
+  const PacketNumberSpace ack_packet_number_space =
+      unacked_packets_.GetPacketNumberSpace(ack_decrypted_level);
+  const QuicPacketNumber prior_largest_acked =
+      unacked_packets_.GetLargestAckedOfPacketNumberSpace(
+          ack_packet_number_space);
+  QuicPacketCount newly_acked_ect0 = 0;
+  QuicPacketCount newly_acked_ect1 = 0;
   // Reverse packets_acked_ so that it is in ascending order.
   std::reverse(packets_acked_.begin(), packets_acked_.end());
   for (AckedPacket& acked_packet : packets_acked_) {
@@ -1660,12 +1713,39 @@ AckResult QuicSentPacketManager::OnAckFrameEnd(
       // Unackable packets are skipped earlier.
       largest_newly_acked_ = acked_packet.packet_number;
     }
+    if (info->ecn_codepoint == ECN_ECT0) {
+      ++newly_acked_ect0;
+    } else if (info->ecn_codepoint == ECN_ECT1) {
+      ++newly_acked_ect1;
+    }
     unacked_packets_.MaybeUpdateLargestAckedOfPacketNumberSpace(
         packet_number_space, acked_packet.packet_number);
     MarkPacketHandled(acked_packet.packet_number, info, ack_receive_time,
                       last_ack_frame_.ack_delay_time,
                       acked_packet.receive_timestamp);
   }
+  const QuicPacketNumber largest_acked =
+      unacked_packets_.GetLargestAckedOfPacketNumberSpace(
+          ack_packet_number_space);
+  if (ecn_enabled_ && largest_acked.IsInitialized() &&
+      (!prior_largest_acked.IsInitialized() ||
+       largest_acked > prior_largest_acked)) {
+    // Only ack frames that increase the largest acked are used for ECN
+    // validation, since the counts of reordered ack frames may be stale.
+    const QuicPacketCount newly_acked_ce =
+        ecn_tracker_.OnAckFrame(ack_packet_number_space, newly_acked_ect0,
+                                newly_acked_ect1, last_ack_ecn_counts_);
+    stats_->ecn_ce_marks_acked += newly_acked_ce;
+    stats_->ecn_validation_failed =
+        ecn_tracker_.state() == QuicEcnTracker::FAILED;
+    if (newly_acked_ect0 + newly_acked_ect1 > 0 &&
+        !stats_->ecn_validation_failed) {
+      send_algorithm_->OnEcnFeedback(ack_receive_time, largest_acked,
+                                     prior_bytes_in_flight,
+                                     newly_acked_ect0 + newly_acked_ect1,
+                                     newly_acked_ce);
+    }
+  }
   const bool acked_new_packet = !packets_acked_.empty();
   PostProcessNewlyAckedPackets(ack_packet_number, ack_decrypted_level,
                                last_ack_frame_, ack_receive_time, rtt_updated_,
@@ -14,11 +14,13 @@
 #include <utility>
 #include <vector>
 
+#include "absl/types/optional.h"
 #include "quic/core/congestion_control/pacing_sender.h"
 #include "quic/core/congestion_control/rtt_stats.h"
 #include "quic/core/congestion_control/send_algorithm_interface.h"
 #include "quic/core/congestion_control/uber_loss_algorithm.h"
 #include "quic/core/proto/cached_network_parameters_proto.h"
+#include "quic/core/quic_ecn_tracker.h"
 #include "quic/core/quic_packets.h"
 #include "quic/core/quic_sustained_bandwidth_recorder.h"
 #include "quic/core/quic_time.h"
@@ -197,13 +199,18 @@ class QUIC_EXPORT_PRIVATE QuicSentPacketManager {
 
   // Called when we have sent bytes to the peer.  This informs the manager both
   // the number of bytes sent and if they were retransmitted and if this packet
-  // is used for rtt measuring.  Returns true if the sender should reset the
-  // retransmission timer.
+  // is used for rtt measuring.  |ecn_codepoint| is the ECN codepoint the packet
+  // was sent with.  Returns true if the sender should reset the retransmission
+  // timer.
   bool OnPacketSent(SerializedPacket* mutable_packet,
                     QuicTime sent_time,
                     TransmissionType transmission_type,
                     HasRetransmittableData has_retransmittable_data,
-                    bool measure_rtt);
+                    bool measure_rtt,
+                    QuicEcnCodepoint ecn_codepoint = ECN_NOT_ECT);
+
+  // Returns the ECN codepoint the next packet should be sent with.
+  QuicEcnCodepoint GetEcnCodepointToSend() const;
 
   bool CanSendAckFrequency() const;
 
@@ -322,6 +329,9 @@ class QUIC_EXPORT_PRIVATE QuicSentPacketManager {
   // the timestamp field is set.  Otherwise, the timestamp is ignored.
   void OnAckTimestamp(QuicPacketNumber packet_number, QuicTime timestamp);
 
+  // Called when the ECN counts of an ack frame are processed.
+  void OnAckEcnCounts(const QuicEcnCounts& ecn_counts);
+
   // Called when an ack frame is parsed completely.
   AckResult OnAckFrameEnd(QuicTime ack_receive_time,
                           QuicPacketNumber ack_packet_number,
@@ -410,6 +420,8 @@ class QUIC_EXPORT_PRIVATE QuicSentPacketManager {
     return &uber_loss_algorithm_;
   }
 
+  const QuicEcnTracker& ecn_tracker() const { return ecn_tracker_; }
+
   // Sets the send algorithm to the given congestion control type and points the
   // pacing sender at |send_algorithm_|. Can be called any number of times.
   void SetSendAlgorithm(CongestionControlType congestion_control_type);
@@ -748,6 +760,18 @@ class QUIC_EXPORT_PRIVATE QuicSentPacketManager {
 
   // Whether to ignore the ack_delay in received ACKs.
   bool ignore_ack_delay_;
+
+  // Latched value of the quic_send_ecn flag.
+  const bool send_ecn_;
+
+  // Whether packets are sent ECN-capable, as negotiated by connection options.
+  bool ecn_enabled_;
+
+  // Validates the ECN counts reported by the peer.
+  QuicEcnTracker ecn_tracker_;
+
+  // ECN counts of the ack frame being processed, if any.
+  absl::optional<QuicEcnCounts> last_ack_ecn_counts_;
 };
 
 }  // namespace quic
@@ -282,6 +282,16 @@ class QuicSentPacketManagerTest : public QuicTest {
                           HAS_RETRANSMITTABLE_DATA, true);
   }
 
+  void SendEcnDataPacket(uint64_t packet_number,
+                         QuicEcnCodepoint ecn_codepoint) {
+    EXPECT_CALL(*send_algorithm_,
+                OnPacketSent(_, BytesInFlight(),
+                             QuicPacketNumber(packet_number), _, _));
+    SerializedPacket packet(CreateDataPacket(packet_number));
+    manager_.OnPacketSent(&packet, clock_.Now(), NOT_RETRANSMISSION,
+                          HAS_RETRANSMITTABLE_DATA, true, ecn_codepoint);
+  }
+
   void SendPingPacket(uint64_t packet_number,
                       EncryptionLevel encryption_level) {
     EXPECT_CALL(*send_algorithm_,
@@ -1902,6 +1912,28 @@ TEST_F(QuicSentPacketManagerTest, NegotiateCongestionControlFromOptions) {
                             ->GetCongestionControlType());
 }
 
+TEST_F(QuicSentPacketManagerTest, NegotiateBbr3FromOptions) {
+  QuicConfig config;
+  QuicTagVector options;
+  options.push_back(kB3ON);
+  QuicConfigPeer::SetReceivedConnectionOptions(&config, options);
+
+  // B3ON is ignored unless the flag is enabled.
+  SetQuicReloadableFlag(quic_allow_client_enabled_bbr_v3, false);
+  const SendAlgorithmInterface* mock_sender =
+      QuicSentPacketManagerPeer::GetSendAlgorithm(manager_);
+  EXPECT_CALL(*send_algorithm_, SetFromConfig(_, _));
+  EXPECT_CALL(*network_change_visitor_, OnCongestionChange());
+  manager_.SetFromConfig(config);
+  EXPECT_EQ(mock_sender, QuicSentPacketManagerPeer::GetSendAlgorithm(manager_));
+
+  SetQuicReloadableFlag(quic_allow_client_enabled_bbr_v3, true);
+  EXPECT_CALL(*network_change_visitor_, OnCongestionChange());
+  manager_.SetFromConfig(config);
+  EXPECT_EQ(kBBRv3, QuicSentPacketManagerPeer::GetSendAlgorithm(manager_)
+                        ->GetCongestionControlType());
+}
+
 TEST_F(QuicSentPacketManagerTest, NegotiateClientCongestionControlFromOptions) {
   QuicConfig config;
   QuicTagVector options;
@@ -4832,6 +4864,82 @@ TEST_F(QuicSentPacketManagerTest, BuildAckFrequencyFrameWithSRTT) {
                      QuicTime::Delta::FromMilliseconds(1u)));
 }
 
+TEST_F(QuicSentPacketManagerTest, EcnValidationSucceeds) {
+  QuicSentPacketManagerPeer::EnableEcn(&manager_);
+  EXPECT_CALL(*send_algorithm_, GetEcnCodepointToSend())
+      .WillRepeatedly(Return(ECN_ECT0));
+  EXPECT_EQ(ECN_ECT0, manager_.GetEcnCodepointToSend());
+  SendEcnDataPacket(1, ECN_ECT0);
+  SendEcnDataPacket(2, ECN_ECT0);
+
+  // Both packets are acked and reported, one of them as CE-marked.  The
+  // feedback reaches the send algorithm.
+  uint64_t acked[] = {1, 2};
+  ExpectAcksAndLosses(true, acked, ABSL_ARRAYSIZE(acked), nullptr, 0);
+  EXPECT_CALL(*send_algorithm_, OnEcnFeedback(_, QuicPacketNumber(2), _,
+                                              /*newly_acked_ect=*/2,
+                                              /*newly_acked_ce=*/1));
+  manager_.OnAckFrameStart(QuicPacketNumber(2), QuicTime::Delta::Infinite(),
+                           clock_.Now());
+  manager_.OnAckRange(QuicPacketNumber(1), QuicPacketNumber(3));
+  QuicEcnCounts ecn_counts;
+  ecn_counts.ect0 = 1;
+  ecn_counts.ce = 1;
+  manager_.OnAckEcnCounts(ecn_counts);
+  EXPECT_EQ(PACKETS_NEWLY_ACKED,
+            manager_.OnAckFrameEnd(clock_.Now(), QuicPacketNumber(1),
+                                   ENCRYPTION_INITIAL));
+  EXPECT_EQ(QuicEcnTracker::CAPABLE, manager_.ecn_tracker().state());
+  EXPECT_EQ(1u, stats_.ecn_ce_marks_acked);
+  EXPECT_FALSE(stats_.ecn_validation_failed);
+  EXPECT_EQ(ECN_ECT0, manager_.GetEcnCodepointToSend());
+}
+
+TEST_F(QuicSentPacketManagerTest, EcnValidationFailsWithoutEcnCounts) {
+  QuicSentPacketManagerPeer::EnableEcn(&manager_);
+  SendEcnDataPacket(1, ECN_ECT0);
+
+  // The ack has no ECN counts, so the path or the peer drops ECN.  The send
+  // algorithm gets no feedback.
+  ExpectAck(1);
+  EXPECT_CALL(*send_algorithm_, OnEcnFeedback(_, _, _, _, _)).Times(0);
+  manager_.OnAckFrameStart(QuicPacketNumber(1), QuicTime::Delta::Infinite(),
+                           clock_.Now());
+  manager_.OnAckRange(QuicPacketNumber(1), QuicPacketNumber(2));
+  EXPECT_EQ(PACKETS_NEWLY_ACKED,
+            manager_.OnAckFrameEnd(clock_.Now(), QuicPacketNumber(1),
+                                   ENCRYPTION_INITIAL));
+  EXPECT_EQ(QuicEcnTracker::FAILED, manager_.ecn_tracker().state());
+  EXPECT_TRUE(stats_.ecn_validation_failed);
+  EXPECT_EQ(ECN_NOT_ECT, manager_.GetEcnCodepointToSend());
+}
+
+TEST_F(QuicSentPacketManagerTest, EcnValidationFailsWithRewrittenCodepoint) {
+  QuicSentPacketManagerPeer::EnableEcn(&manager_);
+  SendEcnDataPacket(1, ECN_ECT0);
+
+  // The packet was sent with ECT(0) but is reported as ECT(1).
+  ExpectAck(1);
+  EXPECT_CALL(*send_algorithm_, OnEcnFeedback(_, _, _, _, _)).Times(0);
+  manager_.OnAckFrameStart(QuicPacketNumber(1), QuicTime::Delta::Infinite(),
+                           clock_.Now());
+  manager_.OnAckRange(QuicPacketNumber(1), QuicPacketNumber(2));
+  QuicEcnCounts ecn_counts;
+  ecn_counts.ect1 = 1;
+  manager_.OnAckEcnCounts(ecn_counts);
+  EXPECT_EQ(PACKETS_NEWLY_ACKED,
+            manager_.OnAckFrameEnd(clock_.Now(), QuicPacketNumber(1),
+                                   ENCRYPTION_INITIAL));
+  EXPECT_EQ(QuicEcnTracker::FAILED, manager_.ecn_tracker().state());
+  EXPECT_TRUE(stats_.ecn_validation_failed);
+  EXPECT_EQ(0u, stats_.ecn_ce_marks_acked);
+}
+
+TEST_F(QuicSentPacketManagerTest, NoEcnCodepointUnlessEnabled) {
+  EXPECT_CALL(*send_algorithm_, GetEcnCodepointToSend()).Times(0);
+  EXPECT_EQ(ECN_NOT_ECT, manager_.GetEcnCodepointToSend());
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace quic
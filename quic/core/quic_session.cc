@@ -51,6 +51,19 @@ class ClosedStreamsCleanUpDelegate : public QuicAlarm::Delegate {
 #define ENDPOINT \
   (perspective() == Perspective::IS_SERVER ? "Server: " : "Client: ")
 
+// Records the median and 99th percentile of a QuicLatencyHistogram.
+#define RECORD_PERCENTILES_IN_US(histogram, stat_name)                       \
+  do {                                                                       \
+    if (!(histogram).empty()) {                                              \
+      QUIC_SERVER_HISTOGRAM_TIMES(                                           \
+          stat_name "_p50", (histogram).Percentile(50).ToMicroseconds(), 1,  \
+          10000000, 50, "Per-connection median, in microseconds.");          \
+      QUIC_SERVER_HISTOGRAM_TIMES(                                           \
+          stat_name "_p99", (histogram).Percentile(99).ToMicroseconds(), 1,  \
+          10000000, 50, "Per-connection 99th percentile, in microseconds."); \
+    }                                                                        \
+  } while (0)
+
 QuicSession::QuicSession(
     QuicConnection* connection,
     Visitor* owner,
@@ -405,12 +418,36 @@ void QuicSession::RecordConnectionCloseAtServer(QuicErrorCode error,
   }
 }
 
+// static
+void QuicSession::RecordLatencyHistogramsAtServer(
+    const QuicConnectionLatencyHistograms& histograms) {
+  RECORD_PERCENTILES_IN_US(histograms.rtt, "quic_server_rtt");
+  RECORD_PERCENTILES_IN_US(histograms.ack_delay, "quic_server_ack_delay");
+  RECORD_PERCENTILES_IN_US(histograms.pacing_delay,
+                           "quic_server_pacing_delay");
+  RECORD_PERCENTILES_IN_US(histograms.receive_to_delivery_delay,
+                           "quic_server_receive_to_delivery_delay");
+  if (!histograms.handshake_duration.empty()) {
+    QUIC_SERVER_HISTOGRAM_TIMES(
+        "quic_server_handshake_duration",
+        histograms.handshake_duration.max().ToMicroseconds(), 1, 10000000, 50,
+        "Time from connection creation to handshake completion, in "
+        "microseconds.");
+  }
+}
+
 void QuicSession::OnConnectionClosed(const QuicConnectionCloseFrame& frame,
                                      ConnectionCloseSource source) {
   QUICHE_DCHECK(!connection_->connected());
   if (perspective() == Perspective::IS_SERVER) {
     RecordConnectionCloseAtServer(frame.quic_error_code, source);
   }
+  if (perspective() == Perspective::IS_SERVER &&
+      connection_->GetStats().latency_histograms) {
+    QUIC_RELOADABLE_FLAG_COUNT_N(quic_record_latency_histograms, 4, 4);
+    RecordLatencyHistogramsAtServer(
+        *connection_->GetStats().latency_histograms);
+  }
 
   if (on_closed_frame_.quic_error_code == QUIC_NO_ERROR) {
     // Save all of the connection close information
@@ -1651,14 +1688,23 @@ void QuicSession::SetDefaultEncryptionLevel(EncryptionLevel level) {
     case ENCRYPTION_FORWARD_SECURE:
       QUIC_BUG_IF(quic_bug_12435_8, !config_.negotiated())
           << ENDPOINT << "Handshake confirmed without parameter negotiation.";
-      connection()->mutable_stats().handshake_completion_time =
-          connection()->clock()->ApproximateNow();
+      RecordHandshakeCompletionTime();
       break;
     default:
       QUIC_BUG(quic_bug_10866_7) << "Unknown encryption level: " << level;
   }
 }
 
+void QuicSession::RecordHandshakeCompletionTime() {
+  QuicConnectionStats& stats = connection()->mutable_stats();
+  stats.handshake_completion_time = connection()->clock()->ApproximateNow();
+  if (stats.latency_histograms &&
+      stats.latency_histograms->handshake_duration.empty()) {
+    stats.latency_histograms->handshake_duration.Add(
+        stats.handshake_completion_time - stats.connection_creation_time);
+  }
+}
+
 void QuicSession::OnTlsHandshakeComplete() {
   QUICHE_DCHECK_EQ(PROTOCOL_TLS1_3, connection_->version().handshake_protocol);
   QUIC_BUG_IF(quic_bug_12435_9,
@@ -1666,8 +1712,7 @@ void QuicSession::OnTlsHandshakeComplete() {
       << ENDPOINT << "Handshake completes without cipher suite negotiation.";
   QUIC_BUG_IF(quic_bug_12435_10, !config_.negotiated())
       << ENDPOINT << "Handshake completes without parameter negotiation.";
-  connection()->mutable_stats().handshake_completion_time =
-      connection()->clock()->ApproximateNow();
+  RecordHandshakeCompletionTime();
   if (connection()->version().UsesTls() &&
       perspective_ == Perspective::IS_SERVER) {
     // Server sends HANDSHAKE_DONE to signal confirmation of the handshake
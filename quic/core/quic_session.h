@@ -510,6 +510,11 @@ class QUIC_EXPORT_PRIVATE QuicSession
   // Caller does not own the returned stream.
   QuicStream* GetOrCreateStream(const QuicStreamId stream_id);
 
+  // Find stream with |id|, returns nullptr if the stream does not exist or
+  // closed. static streams and zombie streams are not considered active
+  // streams.
+  QuicStream* GetActiveStream(QuicStreamId id) const;
+
   // Mark a stream as draining.
   void StreamDraining(QuicStreamId id, bool unidirectional);
 
@@ -535,6 +540,11 @@ class QUIC_EXPORT_PRIVATE QuicSession
   static void RecordConnectionCloseAtServer(QuicErrorCode error,
                                             ConnectionCloseSource source);
 
+  // Exports percentiles of |histograms| through the server stats histograms,
+  // should only be called from server's perspective.
+  static void RecordLatencyHistogramsAtServer(
+      const QuicConnectionLatencyHistograms& histograms);
+
   inline QuicTransportVersion transport_version() const {
     return connection_->transport_version();
   }
@@ -775,14 +785,12 @@ class QUIC_EXPORT_PRIVATE QuicSession
     connection()->SetLossDetectionTuner(std::move(tuner));
   }
 
-  // Find stream with |id|, returns nullptr if the stream does not exist or
-  // closed. static streams and zombie streams are not considered active
-  // streams.
-  QuicStream* GetActiveStream(QuicStreamId id) const;
-
  private:
   friend class test::QuicSessionPeer;
 
+  // Sets the handshake completion time of the connection stats to now.
+  void RecordHandshakeCompletionTime();
+
   // Called in OnConfigNegotiated when we receive a new stream level flow
   // control window in a negotiated config. Closes the connection if invalid.
   void OnNewStreamFlowControlWindow(QuicStreamOffset new_window);
@@ -0,0 +1,332 @@
+// Copyright (c) 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "quic/core/quic_session_command_queue.h"
+
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <utility>
+
+#include "quic/core/quic_connection.h"
+#include "quic/core/quic_session.h"
+#include "quic/core/quic_stream.h"
+#include "quic/platform/api/quic_bug_tracker.h"
+#include "quic/platform/api/quic_logging.h"
+
+namespace quic {
+
+QuicSessionCommandQueue::QuicSessionCommandQueue(QuicSession* session,
+                                                 QuicEpollServer* epoll_server,
+                                                 Visitor* visitor)
+    : QuicSessionCommandQueue(session,
+                              epoll_server,
+                              visitor,
+                              kDefaultMaxBufferedBytes) {}
+
+QuicSessionCommandQueue::QuicSessionCommandQueue(
+    QuicSession* session,
+    QuicEpollServer* epoll_server,
+    Visitor* visitor,
+    QuicByteCount max_buffered_bytes)
+    : session_(session),
+      epoll_server_(epoll_server),
+      visitor_(visitor),
+      wake_fd_(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)),
+      max_buffered_bytes_(max_buffered_bytes) {
+  if (wake_fd_ < 0) {
+    QUIC_BUG(quic_bug_12990_1)
+        << "Failed to create eventfd: " << strerror(errno);
+    return;
+  }
+  epoll_server_->RegisterFDForRead(wake_fd_, this);
+}
+
+QuicSessionCommandQueue::~QuicSessionCommandQueue() {
+  if (wake_fd_ >= 0) {
+    if (epoll_server_ != nullptr) {
+      epoll_server_->UnregisterFD(wake_fd_);
+    }
+    close(wake_fd_);
+  }
+}
+
+bool QuicSessionCommandQueue::WriteMemSlice(QuicStreamId stream_id,
+                                            QuicMemSlice data,
+                                            bool fin) {
+  Command command;
+  command.type = Command::kWrite;
+  command.stream_id = stream_id;
+  command.data = std::move(data);
+  command.fin = fin;
+  return Push(std::move(command));
+}
+
+bool QuicSessionCommandQueue::ResetStream(QuicStreamId stream_id,
+                                          QuicRstStreamErrorCode error) {
+  Command command;
+  command.type = Command::kResetStream;
+  command.stream_id = stream_id;
+  command.stream_error = error;
+  return Push(std::move(command));
+}
+
+bool QuicSessionCommandQueue::CloseConnection(QuicErrorCode error,
+                                              std::string details) {
+  Command command;
+  command.type = Command::kCloseConnection;
+  command.connection_error = error;
+  command.details = std::move(details);
+  return Push(std::move(command));
+}
+
+bool QuicSessionCommandQueue::IsBlocked() const {
+  return buffered_bytes() > max_buffered_bytes_;
+}
+
+bool QuicSessionCommandQueue::IsClosed() const {
+  return closed_.load(std::memory_order_acquire);
+}
+
+QuicByteCount QuicSessionCommandQueue::buffered_bytes() const {
+  return buffered_bytes_.load(std::memory_order_relaxed);
+}
+
+bool QuicSessionCommandQueue::Push(Command command) {
+  if (IsClosed()) {
+    return false;
+  }
+  const QuicByteCount length = command.data.length();
+  if (length > 0 &&
+      buffered_bytes_.fetch_add(length, std::memory_order_relaxed) + length >
+          max_buffered_bytes_) {
+    // Set before the command is pushed, so that the session thread sees it
+    // when it consumes the command.
+    producer_blocked_.store(true, std::memory_order_relaxed);
+  }
+  if (queue_.Push(std::move(command)) && wake_fd_ >= 0) {
+    const uint64_t value = 1;
+    if (write(wake_fd_, &value, sizeof(value)) < 0 && errno != EAGAIN) {
+      QUIC_LOG_FIRST_N(ERROR, 10)
+          << "Failed to wake session thread: " << strerror(errno);
+    }
+  }
+  return true;
+}
+
+void QuicSessionCommandQueue::ProcessCommands() {
+  if (!IsClosed() && !session_->connection()->connected()) {
+    Close();
+  }
+  if (IsClosed()) {
+    DropAll();
+    return;
+  }
+
+  QuicConnection::ScopedPacketFlusher flusher(session_->connection());
+  const size_t num_commands = queue_.ConsumeAll(
+      [this](Command command) { ProcessCommand(std::move(command)); });
+  if (num_commands > 0) {
+    ++stats_.batches;
+    stats_.commands += num_commands;
+  }
+  // Streams which were blocked in an earlier batch are retried as well.
+  FlushStreams();
+  if (IsClosed()) {
+    DropAll();
+    return;
+  }
+  MaybeNotifyWritable();
+}
+
+void QuicSessionCommandQueue::OnCanWriteNewData(QuicStreamId stream_id) {
+  if (flushing_ || IsClosed()) {
+    return;
+  }
+  auto it = pending_writes_.find(stream_id);
+  if (it == pending_writes_.end()) {
+    return;
+  }
+  if (!FlushStream(stream_id, &it->second)) {
+    return;
+  }
+  if (IsClosed()) {
+    DropAll();
+    return;
+  }
+  pending_writes_.erase(it);
+  MaybeNotifyWritable();
+}
+
+void QuicSessionCommandQueue::Close() {
+  if (closed_.exchange(true, std::memory_order_acq_rel)) {
+    return;
+  }
+  if (flushing_) {
+    // Called by the session during a write; the data being written is dropped
+    // once the write returns.
+    return;
+  }
+  DropAll();
+}
+
+void QuicSessionCommandQueue::OnRegistration(QuicEpollServer* /*eps*/,
+                                             int /*fd*/,
+                                             int /*event_mask*/) {}
+
+void QuicSessionCommandQueue::OnModification(int /*fd*/, int /*event_mask*/) {}
+
+void QuicSessionCommandQueue::OnEvent(int fd, QuicEpollEvent* /*event*/) {
+  QUICHE_DCHECK_EQ(wake_fd_, fd);
+  // Reset the eventfd before consuming the queue, so that a command pushed
+  // after this point wakes the session thread again.
+  uint64_t value;
+  if (read(wake_fd_, &value, sizeof(value)) < 0 && errno != EAGAIN) {
+    QUIC_LOG_FIRST_N(ERROR, 10)
+        << "Failed to read eventfd: " << strerror(errno);
+  }
+  ++stats_.wake_ups;
+  ProcessCommands();
+}
+
+void QuicSessionCommandQueue::OnUnregistration(int /*fd*/, bool /*replaced*/) {
+}
+
+void QuicSessionCommandQueue::OnShutdown(QuicEpollServer* eps, int fd) {
+  eps->UnregisterFD(fd);
+  epoll_server_ = nullptr;
+}
+
+std::string QuicSessionCommandQueue::Name() const {
+  return "QuicSessionCommandQueue";
+}
+
+QuicConsumedData QuicSessionCommandQueue::WriteToStream(
+    QuicStream* stream,
+    absl::Span<QuicMemSlice> slices,
+    bool fin) {
+  return stream->WriteMemSlices(slices, fin);
+}
+
+void QuicSessionCommandQueue::ProcessCommand(Command command) {
+  if (IsClosed()) {
+    // An earlier command in the batch closed the connection.
+    DropBytes(command.data.length());
+    return;
+  }
+  switch (command.type) {
+    case Command::kWrite: {
+      PendingWrites& pending = pending_writes_[command.stream_id];
+      if (pending.fin) {
+        QUIC_DLOG(ERROR) << "Dropping data queued after FIN on stream "
+                         << command.stream_id;
+        DropBytes(command.data.length());
+        return;
+      }
+      if (command.data.length() > 0) {
+        pending.bytes += command.data.length();
+        pending.slices.push_back(std::move(command.data));
+      }
+      pending.fin = command.fin;
+      return;
+    }
+    case Command::kResetStream: {
+      auto it = pending_writes_.find(command.stream_id);
+      if (it != pending_writes_.end()) {
+        DropBytes(it->second.bytes);
+        pending_writes_.erase(it);
+      }
+      if (session_->GetActiveStream(command.stream_id) != nullptr) {
+        session_->ResetStream(command.stream_id, command.stream_error);
+      }
+      return;
+    }
+    case Command::kCloseConnection:
+      if (session_->connection()->connected()) {
+        session_->connection()->CloseConnection(
+            command.connection_error, command.details,
+            ConnectionCloseBehavior::SEND_CONNECTION_CLOSE_PACKET);
+      }
+      Close();
+      return;
+  }
+}
+
+bool QuicSessionCommandQueue::FlushStream(QuicStreamId stream_id,
+                                          PendingWrites* pending) {
+  QuicStream* stream = session_->GetActiveStream(stream_id);
+  if (stream == nullptr || stream->write_side_closed() ||
+      stream->fin_buffered()) {
+    QUIC_DVLOG(1) << "Dropping " << pending->bytes
+                  << " bytes queued for closed stream " << stream_id;
+    DropBytes(pending->bytes);
+    return true;
+  }
+  if (pending->bytes == 0 && !pending->fin) {
+    return true;
+  }
+  if (pending->bytes > 0 && !stream->CanWriteNewData()) {
+    return false;
+  }
+
+  flushing_ = true;
+  const QuicConsumedData consumed =
+      WriteToStream(stream, absl::MakeSpan(pending->slices), pending->fin);
+  flushing_ = false;
+  ++stats_.stream_writes;
+  // WriteMemSlices() and WriteBodySlices() buffer either all of the data or
+  // none of it.
+  if (consumed.bytes_consumed == 0 && pending->bytes > 0) {
+    return IsClosed();
+  }
+  stats_.bytes_written += pending->bytes;
+  buffered_bytes_.fetch_sub(pending->bytes, std::memory_order_relaxed);
+  pending->bytes = 0;
+  return true;
+}
+
+void QuicSessionCommandQueue::FlushStreams() {
+  for (auto it = pending_writes_.begin(); it != pending_writes_.end();) {
+    if (!FlushStream(it->first, &it->second)) {
+      ++it;
+      continue;
+    }
+    if (IsClosed()) {
+      // The write closed the connection; the caller drops the rest.
+      return;
+    }
+    pending_writes_.erase(it++);
+  }
+}
+
+void QuicSessionCommandQueue::DropAll() {
+  for (const auto& stream_and_pending : pending_writes_) {
+    DropBytes(stream_and_pending.second.bytes);
+  }
+  pending_writes_.clear();
+  queue_.ConsumeAll(
+      [this](Command command) { DropBytes(command.data.length()); });
+}
+
+void QuicSessionCommandQueue::DropBytes(QuicByteCount bytes) {
+  if (bytes == 0) {
+    return;
+  }
+  stats_.bytes_dropped += bytes;
+  buffered_bytes_.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+void QuicSessionCommandQueue::MaybeNotifyWritable() {
+  if (buffered_bytes() > max_buffered_bytes_ / 2 ||
+      !producer_blocked_.exchange(false, std::memory_order_relaxed)) {
+    return;
+  }
+  if (visitor_ != nullptr) {
+    visitor_->OnQueueWritable();
+  }
+}
+
+}  // namespace quic
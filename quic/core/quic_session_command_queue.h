@@ -0,0 +1,217 @@
+// Copyright (c) 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef QUICHE_QUIC_CORE_QUIC_SESSION_COMMAND_QUEUE_H_
+#define QUICHE_QUIC_CORE_QUIC_SESSION_COMMAND_QUEUE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/types/span.h"
+#include "quic/core/quic_error_codes.h"
+#include "quic/core/quic_mpsc_queue.h"
+#include "quic/core/quic_types.h"
+#include "quic/platform/api/quic_epoll.h"
+#include "quic/platform/api/quic_export.h"
+#include "quic/platform/api/quic_mem_slice.h"
+
+namespace quic {
+
+class QuicSession;
+class QuicStream;
+
+// Lets threads other than the one running a QuicSession write to its streams,
+// reset them and close the connection.  QuicSession, QuicStream and
+// QuicConnection are single threaded, so commands are passed to the session
+// thread through a lock-free queue, and the session thread is woken by an
+// eventfd registered on its epoll server.  Only the first command pushed into
+// an empty queue writes to the eventfd, and the session thread drains all
+// queued commands at once, writing consecutive data for a stream with a single
+// WriteToStream() call in a single packet flusher scope.  HTTP sessions use
+// QuicSpdySessionCommandQueue, which writes the data as message bodies.
+//
+// Data which a stream cannot accept because its send buffer is full is kept
+// by the queue until the stream can accept more.  Producers are expected to
+// stop writing while IsBlocked() returns true, until the visitor is notified
+// by OnQueueWritable() that the queue has drained.
+//
+// The queue must be created and destroyed on the session thread, and must
+// outlive all calls on producer threads.  For example:
+//
+//   // On the session thread.
+//   auto queue = std::make_unique<QuicSessionCommandQueue>(
+//       session, epoll_server, visitor);
+//
+//   // On a worker thread.
+//   queue->WriteMemSlice(stream_id, std::move(body_chunk), /*fin=*/false);
+//   if (queue->IsBlocked()) {
+//     // Wait for the visitor to be notified.
+//   }
+class QUIC_EXPORT_PRIVATE QuicSessionCommandQueue
+    : public QuicEpollCallbackInterface {
+ public:
+  // Notified on the session thread.
+  class QUIC_EXPORT_PRIVATE Visitor {
+   public:
+    virtual ~Visitor() {}
+
+    // Called when the bytes buffered by the queue fall to half of
+    // max_buffered_bytes(), after a producer pushed them past it.
+    virtual void OnQueueWritable() = 0;
+  };
+
+  struct QUIC_EXPORT_PRIVATE Stats {
+    // Times the session thread was woken by a producer.
+    uint64_t wake_ups = 0;
+    // Calls to ProcessCommands() which found at least one command.
+    uint64_t batches = 0;
+    uint64_t commands = 0;
+    // Calls to WriteToStream().
+    uint64_t stream_writes = 0;
+    QuicByteCount bytes_written = 0;
+    // Bytes dropped because their stream or the connection was closed or
+    // reset before they could be written.
+    QuicByteCount bytes_dropped = 0;
+  };
+
+  static constexpr QuicByteCount kDefaultMaxBufferedBytes = 8 * 1024 * 1024;
+
+  // |session| and |epoll_server| must outlive the queue.  |visitor| may be
+  // nullptr.  Producers are blocked while more than |max_buffered_bytes| are
+  // buffered.
+  QuicSessionCommandQueue(QuicSession* session,
+                          QuicEpollServer* epoll_server,
+                          Visitor* visitor);
+  QuicSessionCommandQueue(QuicSession* session,
+                          QuicEpollServer* epoll_server,
+                          Visitor* visitor,
+                          QuicByteCount max_buffered_bytes);
+  QuicSessionCommandQueue(const QuicSessionCommandQueue&) = delete;
+  QuicSessionCommandQueue& operator=(const QuicSessionCommandQueue&) = delete;
+  ~QuicSessionCommandQueue() override;
+
+  // Methods which may be called on any thread.  Each returns false if the
+  // queue is closed, in which case the command is dropped.
+
+  // Queues |data| to be written to stream |stream_id|, followed by a FIN if
+  // |fin| is true.  |data| may be empty if |fin| is true.  Data for a stream
+  // is written in the order it is queued by any one thread.
+  bool WriteMemSlice(QuicStreamId stream_id, QuicMemSlice data, bool fin);
+  // Queues a reset of stream |stream_id|.  Data queued for the stream and not
+  // yet written by the time the reset is processed is dropped.
+  bool ResetStream(QuicStreamId stream_id, QuicRstStreamErrorCode error);
+  // Queues closing the connection with a CONNECTION_CLOSE frame.  All queued
+  // commands not yet processed are dropped.
+  bool CloseConnection(QuicErrorCode error, std::string details);
+
+  // Returns true if producers should stop writing until OnQueueWritable().
+  bool IsBlocked() const;
+  // Returns true once the queue is closed.
+  bool IsClosed() const;
+  // Bytes queued by producers and not yet written to their streams.
+  QuicByteCount buffered_bytes() const;
+
+  // Methods which must be called on the session thread.
+
+  // Processes all queued commands.  Called when the queue is woken.
+  void ProcessCommands();
+  // Writes data queued for stream |stream_id|, if any, if the stream can
+  // accept it.  Streams written through the queue should call this from
+  // QuicStream::OnCanWriteNewData(), otherwise data which could not be
+  // written because the send buffer of the stream was full is only retried
+  // when more commands are queued.
+  void OnCanWriteNewData(QuicStreamId stream_id);
+  // Closes the queue, dropping all queued commands.  Called when the
+  // connection is closed, or else by the next ProcessCommands().
+  void Close();
+
+  QuicByteCount max_buffered_bytes() const { return max_buffered_bytes_; }
+  const Stats& stats() const { return stats_; }
+
+  // QuicEpollCallbackInterface implementation.
+  void OnRegistration(QuicEpollServer* eps,
+                      int fd,
+                      int event_mask) override;
+  void OnModification(int fd, int event_mask) override;
+  void OnEvent(int fd, QuicEpollEvent* event) override;
+  void OnUnregistration(int fd, bool replaced) override;
+  void OnShutdown(QuicEpollServer* eps, int fd) override;
+  std::string Name() const override;
+
+ protected:
+  // Writes |slices| to |stream|, followed by a FIN if |fin| is true, and
+  // returns what was consumed.  The default calls QuicStream::WriteMemSlices(),
+  // which writes the raw bytes; QuicSpdySessionCommandQueue overrides it to
+  // write HTTP message bodies.
+  virtual QuicConsumedData WriteToStream(QuicStream* stream,
+                                         absl::Span<QuicMemSlice> slices,
+                                         bool fin);
+
+ private:
+  struct Command {
+    enum Type {
+      kWrite,
+      kResetStream,
+      kCloseConnection,
+    };
+
+    Type type = kWrite;
+    QuicStreamId stream_id = 0;
+    QuicMemSlice data;
+    bool fin = false;
+    QuicRstStreamErrorCode stream_error = QUIC_STREAM_NO_ERROR;
+    QuicErrorCode connection_error = QUIC_NO_ERROR;
+    std::string details;
+  };
+
+  // Data queued for a stream and not yet written.
+  struct PendingWrites {
+    std::vector<QuicMemSlice> slices;
+    QuicByteCount bytes = 0;
+    bool fin = false;
+  };
+
+  // Pushes |command|, waking the session thread if the queue was empty.
+  bool Push(Command command);
+  void ProcessCommand(Command command);
+  // Writes |pending| to stream |stream_id|.  Returns true if it was written
+  // or dropped, false if the stream cannot accept it yet.
+  bool FlushStream(QuicStreamId stream_id, PendingWrites* pending);
+  void FlushStreams();
+  // Drops all pending writes and queued commands.
+  void DropAll();
+  // Drops |bytes| queued bytes which will not be written.
+  void DropBytes(QuicByteCount bytes);
+  void MaybeNotifyWritable();
+
+  QuicSession* session_;
+  QuicEpollServer* epoll_server_;
+  Visitor* visitor_;
+  // The eventfd which wakes the session thread, or -1.
+  int wake_fd_;
+  // Read by producers, so it cannot change once the queue is created.
+  const QuicByteCount max_buffered_bytes_;
+
+  QuicMpscQueue<Command> queue_;
+  std::atomic<QuicByteCount> buffered_bytes_{0};
+  std::atomic<bool> closed_{false};
+  // Set by a producer which pushed the buffered bytes past
+  // max_buffered_bytes_, and cleared by the session thread when it notifies
+  // the visitor.
+  std::atomic<bool> producer_blocked_{false};
+
+  // Members below are only accessed on the session thread.
+  absl::flat_hash_map<QuicStreamId, PendingWrites> pending_writes_;
+  // True while data is written to streams, so that OnCanWriteNewData() called
+  // by a stream during a write doesn't write it again.
+  bool flushing_ = false;
+  Stats stats_;
+};
+
+}  // namespace quic
+
+#endif  // QUICHE_QUIC_CORE_QUIC_SESSION_COMMAND_QUEUE_H_
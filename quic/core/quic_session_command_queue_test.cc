@@ -0,0 +1,311 @@
+// Copyright (c) 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "quic/core/quic_session_command_queue.h"
+
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "absl/memory/memory.h"
+#include "absl/strings/string_view.h"
+#include "quic/core/crypto/null_encrypter.h"
+#include "quic/core/quic_buffer_allocator.h"
+#include "quic/core/quic_stream.h"
+#include "quic/core/quic_utils.h"
+#include "quic/platform/api/quic_epoll.h"
+#include "quic/platform/api/quic_flags.h"
+#include "quic/platform/api/quic_test.h"
+#include "quic/test_tools/quic_config_peer.h"
+#include "quic/test_tools/quic_test_utils.h"
+
+using testing::_;
+using testing::AnyNumber;
+using testing::Invoke;
+using testing::NiceMock;
+
+namespace quic {
+namespace test {
+namespace {
+
+// Forwards OnCanWriteNewData() to the queue, as streams written through the
+// queue are expected to.
+class TestStream : public QuicStream {
+ public:
+  TestStream(QuicStreamId id, QuicSession* session)
+      : QuicStream(id, session, /*is_static=*/false, BIDIRECTIONAL) {}
+
+  void OnDataAvailable() override {}
+
+  void OnCanWriteNewData() override {
+    if (queue_ != nullptr) {
+      queue_->OnCanWriteNewData(id());
+    }
+  }
+
+  void set_queue(QuicSessionCommandQueue* queue) { queue_ = queue; }
+
+ private:
+  QuicSessionCommandQueue* queue_ = nullptr;
+};
+
+const QuicByteCount kFlowControlWindow = 10 * 1024 * 1024;
+
+class MockVisitor : public QuicSessionCommandQueue::Visitor {
+ public:
+  MOCK_METHOD(void, OnQueueWritable, (), (override));
+};
+
+class QuicSessionCommandQueueTest : public QuicTest {
+ protected:
+  QuicSessionCommandQueueTest()
+      : connection_(new NiceMock<MockQuicConnection>(&helper_,
+                                                     &alarm_factory_,
+                                                     Perspective::IS_SERVER)),
+        session_(connection_) {
+    session_.Initialize();
+    connection_->SetEncrypter(
+        ENCRYPTION_FORWARD_SECURE,
+        std::make_unique<NullEncrypter>(connection_->perspective()));
+    QuicConfigPeer::SetReceivedInitialSessionFlowControlWindow(
+        session_.config(), kFlowControlWindow);
+    QuicConfigPeer::SetReceivedInitialMaxStreamDataBytesIncomingBidirectional(
+        session_.config(), kFlowControlWindow);
+    QuicConfigPeer::SetReceivedInitialMaxStreamDataBytesOutgoingBidirectional(
+        session_.config(), kFlowControlWindow);
+    session_.OnConfigNegotiated();
+    queue_ = std::make_unique<QuicSessionCommandQueue>(
+        &session_, &epoll_server_, &visitor_);
+  }
+
+  TestStream* CreateStream(int n) {
+    const QuicStreamId id = GetNthServerInitiatedBidirectionalStreamId(
+        connection_->transport_version(), n);
+    auto stream = std::make_unique<TestStream>(id, &session_);
+    TestStream* stream_ptr = stream.get();
+    stream_ptr->set_queue(queue_.get());
+    session_.ActivateStream(std::move(stream));
+    return stream_ptr;
+  }
+
+  QuicMemSlice MakeSlice(absl::string_view data) {
+    return QuicMemSlice(QuicBuffer::Copy(&allocator_, data));
+  }
+
+  // Makes the session send buffered stream data as if the connection could
+  // send all of it.
+  void ConsumeAllWrites() {
+    ON_CALL(session_, WritevData(_, _, _, _, _, _))
+        .WillByDefault(Invoke(&session_, &MockQuicSession::ConsumeData));
+  }
+
+  // Outlives the session, which owns slices allocated by it.
+  SimpleBufferAllocator allocator_;
+  MockQuicConnectionHelper helper_;
+  MockAlarmFactory alarm_factory_;
+  NiceMock<MockQuicConnection>* connection_;
+  NiceMock<MockQuicSession> session_;
+  QuicEpollServer epoll_server_;
+  testing::StrictMock<MockVisitor> visitor_;
+  std::unique_ptr<QuicSessionCommandQueue> queue_;
+};
+
+TEST_F(QuicSessionCommandQueueTest, WritesAreBatched) {
+  TestStream* stream = CreateStream(0);
+  EXPECT_TRUE(queue_->WriteMemSlice(stream->id(), MakeSlice("foo"), false));
+  EXPECT_TRUE(queue_->WriteMemSlice(stream->id(), MakeSlice("bar"), false));
+  EXPECT_TRUE(queue_->WriteMemSlice(stream->id(), QuicMemSlice(), true));
+  EXPECT_EQ(6u, queue_->buffered_bytes());
+  EXPECT_EQ(0u, stream->BufferedDataBytes());
+
+  queue_->ProcessCommands();
+  EXPECT_EQ(0u, queue_->buffered_bytes());
+  EXPECT_EQ(6u, stream->BufferedDataBytes());
+  EXPECT_TRUE(stream->fin_buffered());
+  EXPECT_EQ(1u, queue_->stats().batches);
+  EXPECT_EQ(3u, queue_->stats().commands);
+  EXPECT_EQ(1u, queue_->stats().stream_writes);
+  EXPECT_EQ(6u, queue_->stats().bytes_written);
+
+  // Data after the FIN is dropped.
+  EXPECT_TRUE(queue_->WriteMemSlice(stream->id(), MakeSlice("baz"), false));
+  queue_->ProcessCommands();
+  EXPECT_EQ(6u, stream->BufferedDataBytes());
+  EXPECT_EQ(3u, queue_->stats().bytes_dropped);
+  EXPECT_EQ(0u, queue_->buffered_bytes());
+}
+
+TEST_F(QuicSessionCommandQueueTest, WakesSessionThread) {
+  TestStream* stream = CreateStream(0);
+  const QuicStreamId id = stream->id();
+  std::thread producer([this, id]() {
+    for (int i = 0; i < 10; ++i) {
+      queue_->WriteMemSlice(id, MakeSlice("0123456789"), i == 9);
+    }
+  });
+  epoll_server_.set_timeout_in_us(10 * 1000);
+  for (int i = 0; i < 1000 && !stream->fin_buffered(); ++i) {
+    epoll_server_.WaitForEventsAndExecuteCallbacks();
+  }
+  producer.join();
+
+  EXPECT_TRUE(stream->fin_buffered());
+  EXPECT_EQ(100u, stream->BufferedDataBytes());
+  EXPECT_LE(1u, queue_->stats().wake_ups);
+  EXPECT_EQ(10u, queue_->stats().commands);
+}
+
+TEST_F(QuicSessionCommandQueueTest, MultipleProducers) {
+  constexpr int kNumProducers = 4;
+  constexpr int kWritesPerProducer = 1000;
+  const std::string data(100, 'a');
+  ConsumeAllWrites();
+  std::vector<TestStream*> streams;
+  for (int i = 0; i < kNumProducers; ++i) {
+    streams.push_back(CreateStream(i));
+  }
+
+  std::vector<std::thread> producers;
+  for (TestStream* stream : streams) {
+    const QuicStreamId id = stream->id();
+    producers.emplace_back([this, id, &data]() {
+      for (int i = 0; i < kWritesPerProducer; ++i) {
+        queue_->WriteMemSlice(id, MakeSlice(data),
+                              i == kWritesPerProducer - 1);
+      }
+    });
+  }
+  epoll_server_.set_timeout_in_us(10 * 1000);
+  for (int i = 0; i < 10000 && queue_->stats().commands <
+                                   kNumProducers * kWritesPerProducer;
+       ++i) {
+    epoll_server_.WaitForEventsAndExecuteCallbacks();
+  }
+  for (std::thread& producer : producers) {
+    producer.join();
+  }
+
+  EXPECT_EQ(kNumProducers * kWritesPerProducer, queue_->stats().commands);
+  EXPECT_EQ(kNumProducers * kWritesPerProducer * data.size(),
+            queue_->stats().bytes_written);
+  EXPECT_EQ(0u, queue_->buffered_bytes());
+  for (TestStream* stream : streams) {
+    EXPECT_EQ(kWritesPerProducer * data.size(), stream->stream_bytes_written());
+    EXPECT_TRUE(stream->fin_sent());
+  }
+}
+
+TEST_F(QuicSessionCommandQueueTest, BlockedStreamIsRetried) {
+  TestStream* stream = CreateStream(0);
+  const QuicByteCount threshold =
+      GetQuicFlag(FLAGS_quic_buffered_data_threshold);
+  // Fills the send buffer of the stream, which doesn't send anything.
+  queue_->WriteMemSlice(stream->id(), MakeSlice(std::string(threshold, 'a')),
+                        false);
+  queue_->ProcessCommands();
+  EXPECT_FALSE(stream->CanWriteNewData());
+
+  queue_->WriteMemSlice(stream->id(), MakeSlice("foo"), false);
+  queue_->WriteMemSlice(stream->id(), MakeSlice("bar"), true);
+  queue_->ProcessCommands();
+  EXPECT_EQ(threshold, stream->BufferedDataBytes());
+  EXPECT_EQ(6u, queue_->buffered_bytes());
+
+  // The stream notifies the queue once it has sent its buffered data.
+  ConsumeAllWrites();
+  stream->OnCanWrite();
+  EXPECT_EQ(0u, queue_->buffered_bytes());
+  EXPECT_EQ(threshold + 6, stream->stream_bytes_written());
+  EXPECT_TRUE(stream->fin_sent());
+}
+
+TEST_F(QuicSessionCommandQueueTest, BackPressure) {
+  queue_ = std::make_unique<QuicSessionCommandQueue>(
+      &session_, &epoll_server_, &visitor_, /*max_buffered_bytes=*/1000);
+  TestStream* stream = CreateStream(0);
+  const QuicByteCount threshold =
+      GetQuicFlag(FLAGS_quic_buffered_data_threshold);
+  queue_->WriteMemSlice(stream->id(), MakeSlice(std::string(threshold, 'a')),
+                        false);
+  EXPECT_TRUE(queue_->IsBlocked());
+  // The stream takes all of the data, so the queue is writable again.
+  EXPECT_CALL(visitor_, OnQueueWritable());
+  queue_->ProcessCommands();
+  EXPECT_FALSE(queue_->IsBlocked());
+  testing::Mock::VerifyAndClearExpectations(&visitor_);
+
+  // Now the stream is blocked, and the queue holds the data.
+  queue_->WriteMemSlice(stream->id(), MakeSlice(std::string(600, 'b')), false);
+  EXPECT_FALSE(queue_->IsBlocked());
+  queue_->WriteMemSlice(stream->id(), MakeSlice(std::string(600, 'c')), false);
+  EXPECT_TRUE(queue_->IsBlocked());
+  queue_->ProcessCommands();
+  EXPECT_TRUE(queue_->IsBlocked());
+
+  EXPECT_CALL(visitor_, OnQueueWritable());
+  ConsumeAllWrites();
+  stream->OnCanWrite();
+  EXPECT_FALSE(queue_->IsBlocked());
+  EXPECT_EQ(0u, queue_->buffered_bytes());
+}
+
+TEST_F(QuicSessionCommandQueueTest, ResetStreamDropsPendingData) {
+  TestStream* stream = CreateStream(0);
+  const QuicByteCount threshold =
+      GetQuicFlag(FLAGS_quic_buffered_data_threshold);
+  queue_->WriteMemSlice(stream->id(), MakeSlice(std::string(threshold, 'a')),
+                        false);
+  queue_->ProcessCommands();
+  // The stream is blocked, so "foo" is held by the queue when the reset is
+  // processed.
+  queue_->WriteMemSlice(stream->id(), MakeSlice("foo"), false);
+  queue_->ProcessCommands();
+  queue_->ResetStream(stream->id(), QUIC_STREAM_CANCELLED);
+  EXPECT_CALL(session_, MaybeSendRstStreamFrame(stream->id(), _, _));
+  queue_->ProcessCommands();
+  EXPECT_TRUE(stream->rst_sent());
+  EXPECT_EQ(0u, queue_->buffered_bytes());
+  EXPECT_EQ(3u, queue_->stats().bytes_dropped);
+  EXPECT_FALSE(queue_->IsClosed());
+}
+
+TEST_F(QuicSessionCommandQueueTest, CloseConnection) {
+  TestStream* stream = CreateStream(0);
+  EXPECT_TRUE(queue_->CloseConnection(QUIC_INTERNAL_ERROR, "worker failed"));
+  EXPECT_TRUE(queue_->WriteMemSlice(stream->id(), MakeSlice("foo"), false));
+  EXPECT_CALL(*connection_,
+              CloseConnection(QUIC_INTERNAL_ERROR, "worker failed", _))
+      .WillOnce(Invoke(connection_,
+                       &MockQuicConnection::ReallyCloseConnection));
+  EXPECT_CALL(*connection_, SendConnectionClosePacket(_, _, _))
+      .Times(AnyNumber());
+  queue_->ProcessCommands();
+
+  EXPECT_TRUE(queue_->IsClosed());
+  EXPECT_EQ(0u, stream->BufferedDataBytes());
+  EXPECT_EQ(3u, queue_->stats().bytes_dropped);
+  EXPECT_EQ(0u, queue_->buffered_bytes());
+  EXPECT_FALSE(queue_->WriteMemSlice(stream->id(), MakeSlice("bar"), false));
+}
+
+TEST_F(QuicSessionCommandQueueTest, ConnectionClosedByPeer) {
+  TestStream* stream = CreateStream(0);
+  const QuicStreamId id = stream->id();
+  queue_->WriteMemSlice(id, MakeSlice("foo"), false);
+  EXPECT_CALL(*connection_, SendConnectionClosePacket(_, _, _))
+      .Times(AnyNumber());
+  connection_->ReallyCloseConnection(
+      QUIC_PEER_GOING_AWAY, "bye",
+      ConnectionCloseBehavior::SILENT_CLOSE);
+  queue_->ProcessCommands();
+
+  EXPECT_TRUE(queue_->IsClosed());
+  EXPECT_EQ(3u, queue_->stats().bytes_dropped);
+  EXPECT_FALSE(queue_->WriteMemSlice(id, MakeSlice("bar"), false));
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace quic
@@ -768,6 +768,23 @@ QuicConsumedData QuicStream::WriteMemSlices(absl::Span<QuicMemSlice> span,
   return WriteMemSlicesInner(MemSliceSpanWrapper(span), fin);
 }
 
+QuicConsumedData QuicStream::WriteMemSlicesWithPrefix(QuicMemSlice prefix,
+                                                      QuicMemSliceSpan span,
+                                                      bool fin) {
+  MemSliceSpanWrapper wrapper(span);
+  wrapper.set_prefix(&prefix);
+  return WriteMemSlicesInner(wrapper, fin);
+}
+
+QuicConsumedData QuicStream::WriteMemSlicesWithPrefix(
+    QuicMemSlice prefix,
+    absl::Span<QuicMemSlice> span,
+    bool fin) {
+  MemSliceSpanWrapper wrapper(span);
+  wrapper.set_prefix(&prefix);
+  return WriteMemSlicesInner(wrapper, fin);
+}
+
 QuicConsumedData QuicStream::WriteMemSlicesInner(MemSliceSpanWrapper span,
                                                  bool fin) {
   QuicConsumedData consumed_data(0, false);
@@ -408,6 +408,17 @@ class QUIC_EXPORT_PRIVATE QuicStream
   // buffered_data_threshold_ even after writing |length| bytes.
   bool CanWriteNewDataAfterData(QuicByteCount length) const;
 
+  // Like WriteMemSlices(), but moves |prefix| into the send buffer ahead of
+  // |span|, so that framing and payload are buffered as one scatter list and
+  // handed to the session in a single write.  The returned bytes_consumed
+  // includes the length of |prefix|.
+  QuicConsumedData WriteMemSlicesWithPrefix(QuicMemSlice prefix,
+                                            QuicMemSliceSpan span,
+                                            bool fin);
+  QuicConsumedData WriteMemSlicesWithPrefix(QuicMemSlice prefix,
+                                            absl::Span<QuicMemSlice> span,
+                                            bool fin);
+
   // Called when upper layer can write new data.
   virtual void OnCanWriteNewData() {}
 
@@ -470,24 +481,38 @@ class QUIC_EXPORT_PRIVATE QuicStream
   friend class test::QuicStreamPeer;
   friend class QuicStreamUtils;
 
-  // Wraps around either QuicMemSliceSpan or absl::Span<QuicMemSlice>.
+  // Wraps around either QuicMemSliceSpan or absl::Span<QuicMemSlice>, and an
+  // optional slice saved ahead of them.
   // TODO(vasilvv): delete this after QuicMemSliceSpan is gone.
   class QUIC_EXPORT_PRIVATE MemSliceSpanWrapper {
    public:
     explicit MemSliceSpanWrapper(QuicMemSliceSpan span) : old_(span) {}
     explicit MemSliceSpanWrapper(absl::Span<QuicMemSlice> span) : new_(span) {}
 
-    bool empty() { return old_.has_value() ? old_->empty() : new_.empty(); }
+    void set_prefix(QuicMemSlice* prefix) { prefix_ = prefix; }
+
+    bool empty() {
+      if (prefix_ != nullptr && !prefix_->empty()) {
+        return false;
+      }
+      return old_.has_value() ? old_->empty() : new_.empty();
+    }
     QuicByteCount SaveTo(QuicStreamSendBuffer& send_buffer) {
+      QuicByteCount saved = 0;
+      if (prefix_ != nullptr && !prefix_->empty()) {
+        saved = prefix_->length();
+        send_buffer.SaveMemSlice(std::move(*prefix_));
+      }
       if (old_.has_value()) {
-        return send_buffer.SaveMemSliceSpan(*old_);
+        return saved + send_buffer.SaveMemSliceSpan(*old_);
       }
-      return send_buffer.SaveMemSliceSpan(new_);
+      return saved + send_buffer.SaveMemSliceSpan(new_);
     }
 
    private:
     absl::optional<QuicMemSliceSpan> old_;
     absl::Span<QuicMemSlice> new_;
+    QuicMemSlice* prefix_ = nullptr;
   };
 
   QuicStream(QuicStreamId id,
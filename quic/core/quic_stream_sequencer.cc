@@ -6,6 +6,7 @@
 
 #include <algorithm>
 #include <cstddef>
+#include <cstring>
 #include <limits>
 #include <string>
 #include <utility>
@@ -36,7 +37,10 @@ QuicStreamSequencer::QuicStreamSequencer(StreamInterface* quic_stream)
       num_frames_received_(0),
       num_duplicate_frames_received_(0),
       ignore_read_data_(false),
-      level_triggered_(false) {}
+      level_triggered_(false),
+      read_in_order_frames_in_place_(false),
+      num_bytes_copied_(0),
+      num_bytes_read_in_place_(0) {}
 
 QuicStreamSequencer::~QuicStreamSequencer() {
   if (stream_ == nullptr) {
@@ -73,12 +77,25 @@ void QuicStreamSequencer::OnFrameData(QuicStreamOffset byte_offset,
                                       size_t data_len,
                                       const char* data_buffer) {
   highest_offset_ = std::max(highest_offset_, byte_offset + data_len);
+  absl::string_view data(data_buffer, data_len);
+  bool stream_notified = false;
+  if (read_in_order_frames_in_place_ && data_len > 0 && !blocked_ &&
+      !ignore_read_data_ &&
+      buffered_frames_.CanConsumeInPlace(byte_offset, data_len)) {
+    data = ReadInPlace(data);
+    if (data.empty()) {
+      return;
+    }
+    // The frame's payload does not outlive this call, so the rest of it has
+    // to be buffered.
+    byte_offset = buffered_frames_.BytesConsumed();
+    stream_notified = true;
+  }
   const size_t previous_readable_bytes = buffered_frames_.ReadableBytes();
   size_t bytes_written;
   std::string error_details;
   QuicErrorCode result = buffered_frames_.OnStreamData(
-      byte_offset, absl::string_view(data_buffer, data_len), &bytes_written,
-      &error_details);
+      byte_offset, data, &bytes_written, &error_details);
   if (result != QUIC_NO_ERROR) {
     std::string details =
         absl::StrCat("Stream ", stream_->id(), ": ",
@@ -88,6 +105,7 @@ void QuicStreamSequencer::OnFrameData(QuicStreamOffset byte_offset,
     stream_->OnUnrecoverableError(result, details);
     return;
   }
+  num_bytes_copied_ += bytes_written;
 
   if (bytes_written == 0) {
     ++num_duplicate_frames_received_;
@@ -95,7 +113,7 @@ void QuicStreamSequencer::OnFrameData(QuicStreamOffset byte_offset,
     return;
   }
 
-  if (blocked_) {
+  if (blocked_ || stream_notified) {
     return;
   }
 
@@ -122,6 +140,29 @@ void QuicStreamSequencer::OnFrameData(QuicStreamOffset byte_offset,
   }
 }
 
+absl::string_view QuicStreamSequencer::ReadInPlace(absl::string_view data) {
+  QUICHE_DCHECK(in_place_data_.empty());
+  in_place_data_ = data;
+  // Nothing was readable before, so the stream is notified in both edge and
+  // level triggered mode.
+  stream_->OnDataAvailable();
+  const absl::string_view unconsumed = in_place_data_;
+  in_place_data_ = absl::string_view();
+  num_bytes_read_in_place_ += data.size() - unconsumed.size();
+  return unconsumed;
+}
+
+void QuicStreamSequencer::MarkConsumedInPlace(size_t num_bytes) {
+  QUICHE_DCHECK_LE(num_bytes, in_place_data_.size());
+  if (!buffered_frames_.MarkConsumedInPlace(num_bytes)) {
+    QUIC_BUG(quic_bug_10858_3)
+        << "Failed to consume " << num_bytes << " bytes in place. "
+        << DebugString();
+    return;
+  }
+  in_place_data_.remove_prefix(num_bytes);
+}
+
 bool QuicStreamSequencer::CloseStreamAtOffset(QuicStreamOffset offset) {
   const QuicStreamOffset kMaxOffset =
       std::numeric_limits<QuicStreamOffset>::max();
@@ -176,17 +217,36 @@ void QuicStreamSequencer::MaybeCloseStream() {
 
 int QuicStreamSequencer::GetReadableRegions(iovec* iov, size_t iov_len) const {
   QUICHE_DCHECK(!blocked_);
+  if (!in_place_data_.empty()) {
+    QUICHE_DCHECK_GT(iov_len, 0u);
+    iov[0].iov_base = const_cast<char*>(in_place_data_.data());
+    iov[0].iov_len = in_place_data_.size();
+    return 1;
+  }
   return buffered_frames_.GetReadableRegions(iov, iov_len);
 }
 
 bool QuicStreamSequencer::GetReadableRegion(iovec* iov) const {
   QUICHE_DCHECK(!blocked_);
+  if (!in_place_data_.empty()) {
+    return GetReadableRegions(iov, 1) == 1;
+  }
   return buffered_frames_.GetReadableRegion(iov);
 }
 
 bool QuicStreamSequencer::PeekRegion(QuicStreamOffset offset,
                                      iovec* iov) const {
   QUICHE_DCHECK(!blocked_);
+  if (!in_place_data_.empty()) {
+    const QuicStreamOffset consumed = buffered_frames_.BytesConsumed();
+    if (offset < consumed || offset - consumed >= in_place_data_.size()) {
+      return false;
+    }
+    const size_t offset_in_frame = offset - consumed;
+    iov->iov_base = const_cast<char*>(in_place_data_.data()) + offset_in_frame;
+    iov->iov_len = in_place_data_.size() - offset_in_frame;
+    return true;
+  }
   return buffered_frames_.PeekRegion(offset, iov);
 }
 
@@ -201,6 +261,18 @@ void QuicStreamSequencer::Read(std::string* buffer) {
 
 size_t QuicStreamSequencer::Readv(const struct iovec* iov, size_t iov_len) {
   QUICHE_DCHECK(!blocked_);
+  if (!in_place_data_.empty()) {
+    size_t bytes_read = 0;
+    for (size_t i = 0; i < iov_len && !in_place_data_.empty(); ++i) {
+      const size_t bytes_to_copy =
+          std::min(iov[i].iov_len, in_place_data_.size());
+      memcpy(iov[i].iov_base, in_place_data_.data(), bytes_to_copy);
+      MarkConsumedInPlace(bytes_to_copy);
+      bytes_read += bytes_to_copy;
+    }
+    stream_->AddBytesConsumed(bytes_read);
+    return bytes_read;
+  }
   std::string error_details;
   size_t bytes_read;
   QuicErrorCode read_error =
@@ -217,11 +289,11 @@ size_t QuicStreamSequencer::Readv(const struct iovec* iov, size_t iov_len) {
 }
 
 bool QuicStreamSequencer::HasBytesToRead() const {
-  return buffered_frames_.HasBytesToRead();
+  return !in_place_data_.empty() || buffered_frames_.HasBytesToRead();
 }
 
 size_t QuicStreamSequencer::ReadableBytes() const {
-  return buffered_frames_.ReadableBytes();
+  return in_place_data_.size() + buffered_frames_.ReadableBytes();
 }
 
 bool QuicStreamSequencer::IsClosed() const {
@@ -230,7 +302,15 @@ bool QuicStreamSequencer::IsClosed() const {
 
 void QuicStreamSequencer::MarkConsumed(size_t num_bytes_consumed) {
   QUICHE_DCHECK(!blocked_);
-  bool result = buffered_frames_.MarkConsumed(num_bytes_consumed);
+  bool result;
+  if (!in_place_data_.empty()) {
+    result = num_bytes_consumed <= in_place_data_.size();
+    if (result) {
+      MarkConsumedInPlace(num_bytes_consumed);
+    }
+  } else {
+    result = buffered_frames_.MarkConsumed(num_bytes_consumed);
+  }
   if (!result) {
     QUIC_BUG(quic_bug_10858_2)
         << "Invalid argument to MarkConsumed."
@@ -273,7 +353,12 @@ void QuicStreamSequencer::ReleaseBufferIfEmpty() {
 
 void QuicStreamSequencer::FlushBufferedFrames() {
   QUICHE_DCHECK(ignore_read_data_);
-  size_t bytes_flushed = buffered_frames_.FlushBufferedFrames();
+  size_t bytes_flushed = 0;
+  if (!in_place_data_.empty()) {
+    bytes_flushed = in_place_data_.size();
+    MarkConsumedInPlace(bytes_flushed);
+  }
+  bytes_flushed += buffered_frames_.FlushBufferedFrames();
   QUIC_DVLOG(1) << "Flushing buffered data at offset "
                 << buffered_frames_.BytesConsumed() << " length "
                 << bytes_flushed << " for stream " << stream_->id();
@@ -282,7 +367,7 @@ void QuicStreamSequencer::FlushBufferedFrames() {
 }
 
 size_t QuicStreamSequencer::NumBytesBuffered() const {
-  return buffered_frames_.BytesBuffered();
+  return in_place_data_.size() + buffered_frames_.BytesBuffered();
 }
 
 QuicStreamOffset QuicStreamSequencer::NumBytesConsumed() const {
@@ -9,6 +9,7 @@
 #include <map>
 #include <string>
 
+#include "absl/strings/string_view.h"
 #include "quic/core/quic_packets.h"
 #include "quic/core/quic_stream_sequencer_buffer.h"
 #include "quic/core/quic_types.h"
@@ -155,6 +156,35 @@ class QUIC_EXPORT_PRIVATE QuicStreamSequencer {
 
   bool level_triggered() const { return level_triggered_; }
 
+  // If true, a frame which arrives in order while nothing is buffered is read
+  // straight from the frame's payload, which points into the decrypted packet:
+  // the stream is notified while the frame is being processed, and
+  // GetReadableRegions() and PeekRegion() return the payload itself.  Only the
+  // bytes which are not consumed by the time OnDataAvailable() returns are
+  // copied into the buffer, so a stream enabling this must not hold on to
+  // regions of unconsumed data across OnDataAvailable() calls.
+  void set_read_in_order_frames_in_place(bool read_in_order_frames_in_place) {
+    read_in_order_frames_in_place_ = read_in_order_frames_in_place;
+  }
+
+  bool read_in_order_frames_in_place() const {
+    return read_in_order_frames_in_place_;
+  }
+
+  // Whether the stream is being notified of a frame which is read in place,
+  // and part of it has not been consumed yet.  That part is copied into the
+  // buffer once OnDataAvailable() returns.
+  bool HasUnconsumedInPlaceData() const { return !in_place_data_.empty(); }
+
+  // Number of received bytes which were copied into the buffer.
+  QuicByteCount num_bytes_copied() const { return num_bytes_copied_; }
+
+  // Number of received bytes which were read or discarded without being
+  // copied into the buffer.
+  QuicByteCount num_bytes_read_in_place() const {
+    return num_bytes_read_in_place_;
+  }
+
   void set_stream(StreamInterface* stream) { stream_ = stream; }
 
   // Returns string describing internal state.
@@ -181,6 +211,13 @@ class QUIC_EXPORT_PRIVATE QuicStreamSequencer {
                    size_t data_len,
                    const char* data_buffer);
 
+  // Notifies the stream of the in-order |data| and lets it read the data in
+  // place.  Returns the part of |data| which has not been consumed.
+  absl::string_view ReadInPlace(absl::string_view data);
+
+  // Consumes |num_bytes| of |in_place_data_|.
+  void MarkConsumedInPlace(size_t num_bytes);
+
   // The stream which owns this sequencer.
   StreamInterface* stream_;
 
@@ -210,6 +247,16 @@ class QUIC_EXPORT_PRIVATE QuicStreamSequencer {
   // If false, only call OnDataAvailable() when it becomes newly unblocked.
   // Otherwise, call OnDataAvailable() when number of readable bytes changes.
   bool level_triggered_;
+
+  // See set_read_in_order_frames_in_place().
+  bool read_in_order_frames_in_place_;
+
+  // The unconsumed payload of the frame being read in place, which is only
+  // non-empty while the stream is being notified of the frame.
+  absl::string_view in_place_data_;
+
+  QuicByteCount num_bytes_copied_;
+  QuicByteCount num_bytes_read_in_place_;
 };
 
 }  // namespace quic
@@ -444,6 +444,24 @@ bool QuicStreamSequencerBuffer::MarkConsumed(size_t bytes_consumed) {
   return true;
 }
 
+bool QuicStreamSequencerBuffer::CanConsumeInPlace(QuicStreamOffset offset,
+                                                  size_t size) const {
+  return num_bytes_buffered_ == 0 && offset == total_bytes_read_ &&
+         size <= max_buffer_capacity_bytes_;
+}
+
+bool QuicStreamSequencerBuffer::MarkConsumedInPlace(size_t bytes_consumed) {
+  if (!CanConsumeInPlace(total_bytes_read_, bytes_consumed)) {
+    return false;
+  }
+  // Nothing is buffered, so the only received range is the one which has
+  // been read, and it is extended without touching the blocks.
+  bytes_received_.AddOptimizedForAppend(total_bytes_read_,
+                                        total_bytes_read_ + bytes_consumed);
+  total_bytes_read_ += bytes_consumed;
+  return true;
+}
+
 size_t QuicStreamSequencerBuffer::FlushBufferedFrames() {
   size_t prev_total_bytes_read = total_bytes_read_;
   total_bytes_read_ = NextExpectedByte();
@@ -143,6 +143,16 @@ class QUIC_EXPORT_PRIVATE QuicStreamSequencerBuffer {
   // Pre-requisite: bytes_consumed <= available bytes to read.
   bool MarkConsumed(size_t bytes_consumed);
 
+  // Returns true if [offset, offset + size) is the next data to be read,
+  // nothing is buffered and the data fits in the buffer, so that it can be
+  // consumed straight from the caller's memory.
+  bool CanConsumeInPlace(QuicStreamOffset offset, size_t size) const;
+
+  // Records |bytes_consumed| bytes starting at BytesConsumed() as received and
+  // consumed without buffering them.
+  // Pre-requisite: CanConsumeInPlace(BytesConsumed(), bytes_consumed).
+  bool MarkConsumedInPlace(size_t bytes_consumed);
+
   // Deletes and records as consumed any buffered data and clear the buffer.
   // (To be called only after sequencer's StopReading has been called.)
   size_t FlushBufferedFrames();
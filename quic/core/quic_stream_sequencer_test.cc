@@ -775,6 +775,79 @@ TEST_F(QuicStreamSequencerTest, ReceiveFinLessThanHighestOffset) {
   OnFinFrame(0u, "");
 }
 
+TEST_F(QuicStreamSequencerTest, ReadInOrderFramesInPlace) {
+  sequencer_->set_read_in_order_frames_in_place(true);
+  const char* first = "abc";
+  const char* second = "def";
+  // The stream reads the frames' payloads directly.
+  EXPECT_CALL(stream_, AddBytesConsumed(3)).Times(2);
+  EXPECT_CALL(stream_, OnDataAvailable()).WillOnce(testing::Invoke([&]() {
+    iovec iov;
+    ASSERT_TRUE(sequencer_->GetReadableRegion(&iov));
+    EXPECT_EQ(first, iov.iov_base);
+    EXPECT_EQ(3u, sequencer_->ReadableBytes());
+    sequencer_->MarkConsumed(iov.iov_len);
+  }));
+  OnFrame(0, first);
+  EXPECT_EQ(3u, sequencer_->NumBytesConsumed());
+  EXPECT_CALL(stream_, OnDataAvailable()).WillOnce(testing::Invoke([&]() {
+    iovec iov;
+    ASSERT_TRUE(sequencer_->PeekRegion(3, &iov));
+    EXPECT_EQ(second, iov.iov_base);
+    EXPECT_FALSE(sequencer_->PeekRegion(2, &iov));
+    EXPECT_FALSE(sequencer_->PeekRegion(6, &iov));
+    ConsumeData(3);
+  }));
+  OnFrame(3, second);
+
+  EXPECT_EQ(6u, sequencer_->NumBytesConsumed());
+  EXPECT_EQ(0u, NumBufferedBytes());
+  EXPECT_FALSE(sequencer_->HasBytesToRead());
+  EXPECT_EQ(0u, sequencer_->num_bytes_copied());
+  EXPECT_EQ(6u, sequencer_->num_bytes_read_in_place());
+}
+
+TEST_F(QuicStreamSequencerTest, UnconsumedInPlaceDataIsBuffered) {
+  sequencer_->set_read_in_order_frames_in_place(true);
+  EXPECT_CALL(stream_, AddBytesConsumed(1));
+  EXPECT_CALL(stream_, OnDataAvailable()).WillOnce(testing::Invoke([this]() {
+    ConsumeData(1);
+  }));
+  OnFrame(0, "abc");
+  EXPECT_EQ(1u, sequencer_->num_bytes_read_in_place());
+  EXPECT_EQ(2u, sequencer_->num_bytes_copied());
+  EXPECT_EQ(2u, NumBufferedBytes());
+  EXPECT_TRUE(VerifyReadableRegion({"bc"}));
+
+  // The next frame is buffered behind the unconsumed data.
+  OnFrame(3, "def");
+  EXPECT_EQ(5u, sequencer_->num_bytes_copied());
+  EXPECT_TRUE(VerifyReadableRegion({"bcdef"}));
+}
+
+TEST_F(QuicStreamSequencerTest, OutOfOrderFramesAreNotReadInPlace) {
+  sequencer_->set_read_in_order_frames_in_place(true);
+  OnFrame(3, "def");
+  EXPECT_CALL(stream_, OnDataAvailable());
+  OnFrame(0, "abc");
+  EXPECT_EQ(6u, sequencer_->num_bytes_copied());
+  EXPECT_EQ(0u, sequencer_->num_bytes_read_in_place());
+  EXPECT_TRUE(VerifyReadableRegion({"abcdef"}));
+}
+
+TEST_F(QuicStreamSequencerTest, StopReadingWhileReadingInPlace) {
+  sequencer_->set_read_in_order_frames_in_place(true);
+  EXPECT_CALL(stream_, AddBytesConsumed(3));
+  EXPECT_CALL(stream_, OnFinRead());
+  EXPECT_CALL(stream_, OnDataAvailable()).WillOnce(testing::Invoke([this]() {
+    sequencer_->StopReading();
+  }));
+  OnFinFrame(0, "abc");
+  EXPECT_EQ(3u, sequencer_->NumBytesConsumed());
+  EXPECT_EQ(0u, sequencer_->num_bytes_copied());
+  EXPECT_TRUE(sequencer_->IsClosed());
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace quic
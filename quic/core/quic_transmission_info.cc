@@ -15,7 +15,8 @@ QuicTransmissionInfo::QuicTransmissionInfo()
       in_flight(false),
       state(OUTSTANDING),
       has_crypto_handshake(false),
-      has_ack_frequency(false) {}
+      has_ack_frequency(false),
+      ecn_codepoint(ECN_NOT_ECT) {}
 
 QuicTransmissionInfo::QuicTransmissionInfo(EncryptionLevel level,
                                            TransmissionType transmission_type,
@@ -30,7 +31,8 @@ QuicTransmissionInfo::QuicTransmissionInfo(EncryptionLevel level,
       in_flight(false),
       state(OUTSTANDING),
       has_crypto_handshake(has_crypto_handshake),
-      has_ack_frequency(has_ack_frequency) {}
+      has_ack_frequency(has_ack_frequency),
+      ecn_codepoint(ECN_NOT_ECT) {}
 
 QuicTransmissionInfo::QuicTransmissionInfo(const QuicTransmissionInfo& other) =
     default;
@@ -46,6 +48,7 @@ std::string QuicTransmissionInfo::DebugString() const {
       ", in_flight: ", in_flight, ", state: ", state,
       ", has_crypto_handshake: ", has_crypto_handshake,
       ", has_ack_frequency: ", has_ack_frequency,
+      ", ecn_codepoint: ", EcnCodepointToString(ecn_codepoint),
       ", first_sent_after_loss: ", first_sent_after_loss.ToString(),
       ", largest_acked: ", largest_acked.ToString(),
       ", retransmittable_frames: ", QuicFramesToString(retransmittable_frames),
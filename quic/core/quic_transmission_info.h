@@ -48,6 +48,8 @@ struct QUIC_EXPORT_PRIVATE QuicTransmissionInfo {
   bool has_crypto_handshake;
   // True if the packet contains ack frequency frame.
   bool has_ack_frequency;
+  // The ECN codepoint the packet was sent with.
+  QuicEcnCodepoint ecn_codepoint;
   // Records the first sent packet after this packet was detected lost. Zero if
   // this packet has not been detected lost. This is used to keep lost packet
   // for another RTT (for potential spurious loss detection)
@@ -382,6 +382,31 @@ std::ostream& operator<<(std::ostream& os, const KeyUpdateReason reason) {
   return os;
 }
 
+std::string EcnCodepointToString(QuicEcnCodepoint ecn_codepoint) {
+  switch (ecn_codepoint) {
+    RETURN_STRING_LITERAL(ECN_NOT_ECT);
+    RETURN_STRING_LITERAL(ECN_ECT1);
+    RETURN_STRING_LITERAL(ECN_ECT0);
+    RETURN_STRING_LITERAL(ECN_CE);
+  }
+  return absl::StrCat("Unknown(", static_cast<int>(ecn_codepoint), ")");
+}
+
+std::ostream& operator<<(std::ostream& os, QuicEcnCodepoint ecn_codepoint) {
+  os << EcnCodepointToString(ecn_codepoint);
+  return os;
+}
+
+bool operator==(const QuicEcnCounts& lhs, const QuicEcnCounts& rhs) {
+  return lhs.ect0 == rhs.ect0 && lhs.ect1 == rhs.ect1 && lhs.ce == rhs.ce;
+}
+
+std::ostream& operator<<(std::ostream& os, const QuicEcnCounts& ecn_counts) {
+  os << "{ ect0: " << ecn_counts.ect0 << ", ect1: " << ecn_counts.ect1
+     << ", ce: " << ecn_counts.ce << " }";
+  return os;
+}
+
 #undef RETURN_STRING_LITERAL  // undef for jumbo builds
 
 }  // namespace quic
@@ -454,6 +454,8 @@ enum CongestionControlType {
   kPCC,
   kGoogCC,
   kBBRv2,
+  kPragueBytes,
+  kBBRv3,
 };
 
 // EncryptionLevel enumerates the stages of encryption that a QUIC connection
@@ -817,6 +819,35 @@ struct QUIC_NO_EXPORT QuicOwnedPacketBuffer : public QuicPacketBuffer {
   }
 };
 
+// The ECN codepoint in the two least significant bits of the IP TOS or IPv6
+// Traffic Class field, see RFC 3168.  The values are those of the field.
+enum QuicEcnCodepoint : uint8_t {
+  ECN_NOT_ECT = 0,
+  ECN_ECT1 = 1,
+  ECN_ECT0 = 2,
+  ECN_CE = 3,
+};
+
+QUIC_EXPORT_PRIVATE std::string EcnCodepointToString(
+    QuicEcnCodepoint ecn_codepoint);
+
+QUIC_EXPORT_PRIVATE std::ostream& operator<<(std::ostream& os,
+                                             QuicEcnCodepoint ecn_codepoint);
+
+// Number of packets received with each ECN-capable codepoint, as reported in
+// the ECN counts of IETF ACK frames.
+struct QUIC_EXPORT_PRIVATE QuicEcnCounts {
+  QuicPacketCount ect0 = 0;
+  QuicPacketCount ect1 = 0;
+  QuicPacketCount ce = 0;
+};
+
+QUIC_EXPORT_PRIVATE bool operator==(const QuicEcnCounts& lhs,
+                                    const QuicEcnCounts& rhs);
+
+QUIC_EXPORT_PRIVATE std::ostream& operator<<(std::ostream& os,
+                                             const QuicEcnCounts& ecn_counts);
+
 // These values must remain stable as they are uploaded to UMA histograms.
 enum class KeyUpdateReason {
   kInvalid = 0,
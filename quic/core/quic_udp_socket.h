@@ -15,6 +15,8 @@
 #include "quic/platform/api/quic_ip_address.h"
 #include "quic/platform/api/quic_socket_address.h"
 
+struct msghdr;
+
 namespace quic {
 
 #if defined(_WIN32)
@@ -35,6 +37,7 @@ enum class QuicUdpPacketInfoBit : uint8_t {
   RECV_TIMESTAMP,        // Read
   TTL,                   // Read & Write
   GOOGLE_PACKET_HEADER,  // Read
+  ECN_CODEPOINT,         // Read & Write
   NUM_BITS,
 };
 static_assert(static_cast<size_t>(QuicUdpPacketInfoBit::NUM_BITS) <=
@@ -143,6 +146,16 @@ class QUIC_EXPORT_PRIVATE QuicUdpPacketInfo {
     bitmask_.Set(QuicUdpPacketInfoBit::GOOGLE_PACKET_HEADER);
   }
 
+  QuicEcnCodepoint ecn_codepoint() const {
+    QUICHE_DCHECK(HasValue(QuicUdpPacketInfoBit::ECN_CODEPOINT));
+    return ecn_codepoint_;
+  }
+
+  void SetEcnCodepoint(QuicEcnCodepoint ecn_codepoint) {
+    ecn_codepoint_ = ecn_codepoint;
+    bitmask_.Set(QuicUdpPacketInfoBit::ECN_CODEPOINT);
+  }
+
  private:
   BitMask64 bitmask_;
   QuicPacketCount dropped_packets_;
@@ -152,6 +165,7 @@ class QUIC_EXPORT_PRIVATE QuicUdpPacketInfo {
   QuicWallTime receive_timestamp_ = QuicWallTime::Zero();
   int ttl_;
   BufferSpan google_packet_headers_;
+  QuicEcnCodepoint ecn_codepoint_ = ECN_NOT_ECT;
 };
 
 // QuicUdpSocketApi provides a minimal set of apis for sending and receiving
@@ -186,6 +200,9 @@ class QUIC_EXPORT_PRIVATE QuicUdpSocketApi {
   bool EnableReceiveTimestamp(QuicUdpSocketFd fd);
   bool EnableReceiveTtlForV4(QuicUdpSocketFd fd);
   bool EnableReceiveTtlForV6(QuicUdpSocketFd fd);
+  // Enables receiving of the ECN codepoint of IPv4 packets and, if
+  // |address_family| is AF_INET6, of IPv6 packets.
+  bool EnableReceiveEcn(QuicUdpSocketFd fd, int address_family);
 
   // Wait for |fd| to become readable, up to |timeout|.
   // Return true if |fd| is readable upon return.
@@ -238,6 +255,13 @@ class QUIC_EXPORT_PRIVATE QuicUdpSocketApi {
                           size_t packet_buffer_len,
                           const QuicUdpPacketInfo& packet_info);
 
+  // Populates |packet_info| from the peer address and control messages of
+  // |hdr|, as filled in by a recvmsg() style call.  Used by readers that
+  // receive packets without going through ReadPacket(), e.g. with io_uring.
+  static void PopulatePacketInfoFromMsgHdr(msghdr* hdr,
+                                           BitMask64 packet_info_interested,
+                                           QuicUdpPacketInfo* packet_info);
+
  protected:
   bool SetupSocket(QuicUdpSocketFd fd,
                    int address_family,
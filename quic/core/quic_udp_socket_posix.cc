@@ -27,6 +27,10 @@
 #define QUIC_UDP_SOCKET_SUPPORT_TTL 1
 #endif
 
+#if defined(__linux__)
+#define QUIC_UDP_SOCKET_SUPPORT_ECN 1
+#endif
+
 namespace quic {
 namespace {
 
@@ -55,6 +59,7 @@ const size_t kMinCmsgSpaceForRead =
     + CMSG_SPACE(sizeof(in_pktinfo))   // V4 Self IP
     + CMSG_SPACE(sizeof(in6_pktinfo))  // V6 Self IP
     + kCmsgSpaceForRecvTimestamp + CMSG_SPACE(sizeof(int))  // TTL
+    + CMSG_SPACE(sizeof(int))                                // TOS or TCLASS
     + kCmsgSpaceForGooglePacketHeader;
 
 QuicUdpSocketFd CreateNonblockingSocket(int address_family) {
@@ -186,6 +191,25 @@ void PopulatePacketInfoFromControlMessage(struct cmsghdr* cmsg,
     return;
   }
 
+#if defined(QUIC_UDP_SOCKET_SUPPORT_ECN)
+  // IP_TOS carries a single byte, IPV6_TCLASS an int.
+  if (cmsg->cmsg_level == IPPROTO_IP && cmsg->cmsg_type == IP_TOS) {
+    if (packet_info_interested.IsSet(QuicUdpPacketInfoBit::ECN_CODEPOINT)) {
+      packet_info->SetEcnCodepoint(static_cast<QuicEcnCodepoint>(
+          *(reinterpret_cast<uint8_t*>(CMSG_DATA(cmsg))) & 0x3));
+    }
+    return;
+  }
+
+  if (cmsg->cmsg_level == IPPROTO_IPV6 && cmsg->cmsg_type == IPV6_TCLASS) {
+    if (packet_info_interested.IsSet(QuicUdpPacketInfoBit::ECN_CODEPOINT)) {
+      packet_info->SetEcnCodepoint(static_cast<QuicEcnCodepoint>(
+          *(reinterpret_cast<int*>(CMSG_DATA(cmsg))) & 0x3));
+    }
+    return;
+  }
+#endif
+
   if (packet_info_interested.IsSet(
           QuicUdpPacketInfoBit::GOOGLE_PACKET_HEADER)) {
     BufferSpan google_packet_headers;
@@ -362,6 +386,25 @@ bool QuicUdpSocketApi::EnableReceiveTtlForV6(QuicUdpSocketFd fd) {
 #endif
 }
 
+bool QuicUdpSocketApi::EnableReceiveEcn(QuicUdpSocketFd fd,
+                                        int address_family) {
+#if defined(QUIC_UDP_SOCKET_SUPPORT_ECN)
+  int get_ecn = 1;
+  // IPv4 packets received by a dual-stack IPv6 socket are reported with
+  // IP_TOS, so IP_RECVTOS is set on both.
+  if (setsockopt(fd, IPPROTO_IP, IP_RECVTOS, &get_ecn, sizeof(get_ecn)) != 0) {
+    return false;
+  }
+  return address_family != AF_INET6 ||
+         0 == setsockopt(fd, IPPROTO_IPV6, IPV6_RECVTCLASS, &get_ecn,
+                         sizeof(get_ecn));
+#else
+  (void)fd;
+  (void)address_family;
+  return false;
+#endif
+}
+
 bool QuicUdpSocketApi::WaitUntilReadable(QuicUdpSocketFd fd,
                                          QuicTime::Delta timeout) {
   fd_set read_fds;
@@ -527,19 +570,8 @@ size_t QuicUdpSocketApi::ReadMultiplePackets(QuicUdpSocketFd fd,
     (*results)[i].ok = true;
     (*results)[i].packet_buffer.buffer_len = hdrs[i].msg_len;
 
-    QuicUdpPacketInfo* packet_info = &(*results)[i].packet_info;
-    if (packet_info_interested.IsSet(QuicUdpPacketInfoBit::PEER_ADDRESS)) {
-      packet_info->SetPeerAddress(
-          QuicSocketAddress(packet_data_array[i].raw_peer_address));
-    }
-
-    if (hdr.msg_controllen > 0) {
-      for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&hdr); cmsg != nullptr;
-           cmsg = CMSG_NXTHDR(&hdr, cmsg)) {
-        PopulatePacketInfoFromControlMessage(cmsg, packet_info,
-                                             packet_info_interested);
-      }
-    }
+    PopulatePacketInfoFromMsgHdr(&hdr, packet_info_interested,
+                                 &(*results)[i].packet_info);
   }
   return packets_read;
 #else
@@ -559,6 +591,25 @@ size_t QuicUdpSocketApi::ReadMultiplePackets(QuicUdpSocketFd fd,
 #endif
 }
 
+// static
+void QuicUdpSocketApi::PopulatePacketInfoFromMsgHdr(
+    msghdr* hdr,
+    BitMask64 packet_info_interested,
+    QuicUdpPacketInfo* packet_info) {
+  if (packet_info_interested.IsSet(QuicUdpPacketInfoBit::PEER_ADDRESS)) {
+    packet_info->SetPeerAddress(QuicSocketAddress(
+        *reinterpret_cast<const sockaddr_storage*>(hdr->msg_name)));
+  }
+
+  if (hdr->msg_controllen > 0) {
+    for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(hdr); cmsg != nullptr;
+         cmsg = CMSG_NXTHDR(hdr, cmsg)) {
+      PopulatePacketInfoFromControlMessage(cmsg, packet_info,
+                                           packet_info_interested);
+    }
+  }
+}
+
 WriteResult QuicUdpSocketApi::WritePacket(
     QuicUdpSocketFd fd,
     const char* packet_buffer,
@@ -623,6 +674,23 @@ WriteResult QuicUdpSocketApi::WritePacket(
   }
 #endif
 
+#if defined(QUIC_UDP_SOCKET_SUPPORT_ECN)
+  // Set the ECN codepoint.
+  if (packet_info.HasValue(QuicUdpPacketInfoBit::ECN_CODEPOINT) &&
+      packet_info.ecn_codepoint() != ECN_NOT_ECT) {
+    int cmsg_level =
+        packet_info.peer_address().host().IsIPv4() ? IPPROTO_IP : IPPROTO_IPV6;
+    int cmsg_type =
+        packet_info.peer_address().host().IsIPv4() ? IP_TOS : IPV6_TCLASS;
+    if (!NextCmsg(&hdr, control_buffer, sizeof(control_buffer), cmsg_level,
+                  cmsg_type, sizeof(int), &cmsg)) {
+      QUIC_LOG_FIRST_N(ERROR, 100) << "Not enough buffer to set ECN.";
+      return WriteResult(WRITE_STATUS_ERROR, EINVAL);
+    }
+    *reinterpret_cast<int*>(CMSG_DATA(cmsg)) = packet_info.ecn_codepoint();
+  }
+#endif
+
   int rc;
   do {
     rc = sendmsg(fd, &hdr, 0);
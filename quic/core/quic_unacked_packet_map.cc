@@ -124,7 +124,12 @@ QuicUnackedPacketMap::QuicUnackedPacketMap(Perspective perspective)
                                        {QuicTime::Zero()}},
       last_crypto_packet_sent_time_(QuicTime::Zero()),
       session_notifier_(nullptr),
-      supports_multiple_packet_number_spaces_(false) {
+      supports_multiple_packet_number_spaces_(false),
+      use_in_flight_index_(
+          GetQuicReloadableFlag(quic_unacked_map_in_flight_index)) {
+  if (use_in_flight_index_) {
+    QUIC_RELOADABLE_FLAG_COUNT(quic_unacked_map_in_flight_index);
+  }
 }
 
 QuicUnackedPacketMap::~QuicUnackedPacketMap() {
@@ -174,6 +179,10 @@ void QuicUnackedPacketMap::AddSentPacket(SerializedPacket* mutable_packet,
     largest_sent_retransmittable_packets_[packet_number_space] = packet_number;
     last_inflight_packet_sent_time_ = sent_time;
     last_inflight_packets_sent_time_[packet_number_space] = sent_time;
+    if (use_in_flight_index_ &&
+        !least_in_flight_packets_[packet_number_space].IsInitialized()) {
+      least_in_flight_packets_[packet_number_space] = packet_number;
+    }
   }
   unacked_packets_.push_back(std::move(info));
   // Swap the retransmittable frames to avoid allocations.
@@ -315,9 +324,33 @@ void QuicUnackedPacketMap::RemoveFromInFlight(QuicTransmissionInfo* info) {
     }
 
     info->in_flight = false;
+    if (use_in_flight_index_) {
+      const QuicPacketNumber least_in_flight =
+          least_in_flight_packets_[packet_number_space];
+      if (least_in_flight.IsInitialized() &&
+          !unacked_packets_[least_in_flight - least_unacked_].in_flight) {
+        AdvanceLeastInFlightPacket(packet_number_space);
+      }
+    }
   }
 }
 
+void QuicUnackedPacketMap::AdvanceLeastInFlightPacket(
+    PacketNumberSpace packet_number_space) {
+  QuicPacketNumber& least_in_flight =
+      least_in_flight_packets_[packet_number_space];
+  const QuicPacketNumber end = least_unacked_ + unacked_packets_.size();
+  for (++least_in_flight; least_in_flight < end; ++least_in_flight) {
+    const QuicTransmissionInfo& info =
+        unacked_packets_[least_in_flight - least_unacked_];
+    if (info.in_flight &&
+        GetPacketNumberSpace(info.encryption_level) == packet_number_space) {
+      return;
+    }
+  }
+  least_in_flight.Clear();
+}
+
 void QuicUnackedPacketMap::RemoveFromInFlight(QuicPacketNumber packet_number) {
   QUICHE_DCHECK_GE(packet_number, least_unacked_);
   QUICHE_DCHECK_LT(packet_number, least_unacked_ + unacked_packets_.size());
@@ -590,9 +623,35 @@ QuicUnackedPacketMap::GetLargestSentRetransmittableOfPacketNumberSpace(
   return largest_sent_retransmittable_packets_[packet_number_space];
 }
 
+QuicPacketNumber QuicUnackedPacketMap::GetLeastInFlightPacketOfSpace(
+    PacketNumberSpace packet_number_space) const {
+  QUICHE_DCHECK(use_in_flight_index_);
+  if (packet_number_space >= NUM_PACKET_NUMBER_SPACES) {
+    QUIC_BUG(quic_bug_10518_9)
+        << "Invalid packet number space: " << packet_number_space;
+    return QuicPacketNumber();
+  }
+  return least_in_flight_packets_[packet_number_space];
+}
+
 const QuicTransmissionInfo*
 QuicUnackedPacketMap::GetFirstInFlightTransmissionInfo() const {
   QUICHE_DCHECK(HasInFlightPackets());
+  if (use_in_flight_index_) {
+    QuicPacketNumber least_in_flight;
+    for (const QuicPacketNumber packet_number : least_in_flight_packets_) {
+      if (packet_number.IsInitialized() &&
+          (!least_in_flight.IsInitialized() ||
+           packet_number < least_in_flight)) {
+        least_in_flight = packet_number;
+      }
+    }
+    if (least_in_flight.IsInitialized()) {
+      return &unacked_packets_[least_in_flight - least_unacked_];
+    }
+    QUICHE_DCHECK(false);
+    return nullptr;
+  }
   for (auto it = begin(); it != end(); ++it) {
     if (it->in_flight) {
       return &(*it);
@@ -605,8 +664,14 @@ QuicUnackedPacketMap::GetFirstInFlightTransmissionInfo() const {
 const QuicTransmissionInfo*
 QuicUnackedPacketMap::GetFirstInFlightTransmissionInfoOfSpace(
     PacketNumberSpace packet_number_space) const {
-  // TODO(fayang): Optimize this part if arm 1st PTO with first in flight sent
-  // time works.
+  if (use_in_flight_index_) {
+    const QuicPacketNumber least_in_flight =
+        GetLeastInFlightPacketOfSpace(packet_number_space);
+    if (!least_in_flight.IsInitialized()) {
+      return nullptr;
+    }
+    return &unacked_packets_[least_in_flight - least_unacked_];
+  }
   for (auto it = begin(); it != end(); ++it) {
     if (it->in_flight &&
         GetPacketNumberSpace(it->encryption_level) == packet_number_space) {
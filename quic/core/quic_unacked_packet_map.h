@@ -220,6 +220,12 @@ class QUIC_EXPORT_PRIVATE QuicUnackedPacketMap {
   QuicTime GetLastInFlightPacketSentTime(
       PacketNumberSpace packet_number_space) const;
 
+  // Returns the least packet number in flight in |packet_number_space|, or an
+  // uninitialized packet number if there is none.  Only available if
+  // use_in_flight_index() is true.
+  QuicPacketNumber GetLeastInFlightPacketOfSpace(
+      PacketNumberSpace packet_number_space) const;
+
   // Returns TransmissionInfo of the first in flight packet.
   const QuicTransmissionInfo* GetFirstInFlightTransmissionInfo() const;
 
@@ -230,6 +236,8 @@ class QUIC_EXPORT_PRIVATE QuicUnackedPacketMap {
 
   void SetSessionNotifier(SessionNotifierInterface* session_notifier);
 
+  bool use_in_flight_index() const { return use_in_flight_index_; }
+
   void EnableMultiplePacketNumberSpacesSupport();
 
   // Returns a bitfield of retransmittable frames of last packet in
@@ -278,6 +286,10 @@ class QUIC_EXPORT_PRIVATE QuicUnackedPacketMap {
   bool IsPacketUseless(QuicPacketNumber packet_number,
                        const QuicTransmissionInfo& info) const;
 
+  // Moves least_in_flight_packets_[packet_number_space] forward to the next
+  // packet in flight in that space, if any.
+  void AdvanceLeastInFlightPacket(PacketNumberSpace packet_number_space);
+
   const Perspective perspective_;
 
   QuicPacketNumber largest_sent_packet_;
@@ -331,6 +343,15 @@ class QUIC_EXPORT_PRIVATE QuicUnackedPacketMap {
 
   // Latched value of the quic_simple_inflight_time flag.
   bool simple_inflight_time_;
+
+  // Latched value of the quic_unacked_map_in_flight_index flag.
+  const bool use_in_flight_index_;
+
+  // The least packet number in flight per packet number space, uninitialized
+  // if nothing is in flight in that space.  Packets are sent in increasing
+  // packet number order and only ever leave flight, so these only move
+  // forward, and each packet is stepped over at most once.
+  QuicPacketNumber least_in_flight_packets_[NUM_PACKET_NUMBER_SPACES];
 };
 
 }  // namespace quic
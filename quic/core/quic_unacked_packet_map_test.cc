@@ -11,6 +11,7 @@
 #include "quic/core/quic_packet_number.h"
 #include "quic/core/quic_transmission_info.h"
 #include "quic/core/quic_utils.h"
+#include "quic/platform/api/quic_flags.h"
 #include "quic/platform/api/quic_test.h"
 #include "quic/test_tools/quic_test_utils.h"
 #include "quic/test_tools/quic_unacked_packet_map_peer.h"
@@ -657,6 +658,78 @@ TEST_P(QuicUnackedPacketMapTest, LargestSentPacketMultiplePacketNumberSpaces) {
   EXPECT_FALSE(unacked_packets_.GetLastPacketContent() & (1 << ACK_FRAME));
 }
 
+TEST_P(QuicUnackedPacketMapTest, InFlightIndex) {
+  SetQuicReloadableFlag(quic_unacked_map_in_flight_index, true);
+  QuicUnackedPacketMap unacked_packets(GetParam());
+  unacked_packets.SetSessionNotifier(&notifier_);
+  unacked_packets.EnableMultiplePacketNumberSpacesSupport();
+  ASSERT_TRUE(unacked_packets.use_in_flight_index());
+  const EncryptionLevel kLevels[] = {ENCRYPTION_INITIAL, ENCRYPTION_HANDSHAKE,
+                                     ENCRYPTION_FORWARD_SECURE};
+  const uint64_t kNumPackets = 30;
+  for (uint64_t i = 1; i <= kNumPackets; ++i) {
+    SerializedPacket packet(CreateRetransmittablePacket(i));
+    packet.encryption_level = kLevels[(i * i) % ABSL_ARRAYSIZE(kLevels)];
+    unacked_packets.AddSentPacket(&packet, NOT_RETRANSMISSION, now_, true,
+                                  true);
+  }
+
+  // Finds the first packet in flight of |space| by walking the whole map.
+  auto scan = [&unacked_packets](PacketNumberSpace space) {
+    QuicPacketNumber packet_number = unacked_packets.GetLeastUnacked();
+    for (auto it = unacked_packets.begin(); it != unacked_packets.end();
+         ++it, ++packet_number) {
+      if (it->in_flight &&
+          unacked_packets.GetPacketNumberSpace(it->encryption_level) ==
+              space) {
+        return packet_number;
+      }
+    }
+    return QuicPacketNumber();
+  };
+
+  // Remove packets from flight out of order, and check the index against a
+  // scan of the map after every removal.
+  for (uint64_t i = 0; i < kNumPackets; ++i) {
+    const QuicPacketNumber packet_number(1 + (i * 7) % kNumPackets);
+    unacked_packets.RemoveFromInFlight(packet_number);
+    unacked_packets.RemoveObsoletePackets();
+    for (PacketNumberSpace space :
+         {INITIAL_DATA, HANDSHAKE_DATA, APPLICATION_DATA}) {
+      const QuicPacketNumber expected = scan(space);
+      EXPECT_EQ(expected, unacked_packets.GetLeastInFlightPacketOfSpace(space))
+          << "after removing " << packet_number << " from "
+          << PacketNumberSpaceToString(space);
+      const QuicTransmissionInfo* info =
+          unacked_packets.GetFirstInFlightTransmissionInfoOfSpace(space);
+      if (expected.IsInitialized()) {
+        EXPECT_EQ(&unacked_packets.GetTransmissionInfo(expected), info);
+      } else {
+        EXPECT_EQ(nullptr, info);
+      }
+    }
+    if (unacked_packets.HasInFlightPackets()) {
+      const QuicTransmissionInfo* first =
+          unacked_packets.GetFirstInFlightTransmissionInfo();
+      ASSERT_NE(nullptr, first);
+      EXPECT_TRUE(first->in_flight);
+      for (auto it = unacked_packets.begin(); &*it != first; ++it) {
+        EXPECT_FALSE(it->in_flight);
+      }
+    }
+  }
+  EXPECT_FALSE(unacked_packets.HasInFlightPackets());
+
+  // A new packet becomes the least in flight of its space.
+  SerializedPacket packet(CreateRetransmittablePacket(kNumPackets + 1));
+  packet.encryption_level = ENCRYPTION_FORWARD_SECURE;
+  unacked_packets.AddSentPacket(&packet, NOT_RETRANSMISSION, now_, true, true);
+  EXPECT_EQ(QuicPacketNumber(kNumPackets + 1),
+            unacked_packets.GetLeastInFlightPacketOfSpace(APPLICATION_DATA));
+  EXPECT_FALSE(unacked_packets.GetLeastInFlightPacketOfSpace(INITIAL_DATA)
+                   .IsInitialized());
+}
+
 TEST_P(QuicUnackedPacketMapTest, ReserveInitialCapacityTest) {
   QuicUnackedPacketMap unacked_packets(GetParam());
   ASSERT_EQ(QuicUnackedPacketMapPeer::GetCapacity(unacked_packets), 0u);
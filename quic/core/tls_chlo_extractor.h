@@ -98,6 +98,9 @@ class QUIC_NO_EXPORT TlsChloExtractor
                       QuicTime /*timestamp*/) override {
     return true;
   }
+  bool OnAckEcnCounts(const QuicEcnCounts& /*ecn_counts*/) override {
+    return true;
+  }
   bool OnAckFrameEnd(QuicPacketNumber /*start*/) override { return true; }
   bool OnStopWaitingFrame(const QuicStopWaitingFrame& /*frame*/) override {
     return true;
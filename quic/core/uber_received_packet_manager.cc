@@ -50,14 +50,16 @@ const QuicFrame UberReceivedPacketManager::GetUpdatedAckFrame(
 void UberReceivedPacketManager::RecordPacketReceived(
     EncryptionLevel decrypted_packet_level,
     const QuicPacketHeader& header,
-    QuicTime receipt_time) {
+    QuicTime receipt_time,
+    QuicEcnCodepoint ecn_codepoint) {
   if (!supports_multiple_packet_number_spaces_) {
-    received_packet_managers_[0].RecordPacketReceived(header, receipt_time);
+    received_packet_managers_[0].RecordPacketReceived(header, receipt_time,
+                                                      ecn_codepoint);
     return;
   }
   received_packet_managers_[QuicUtils::GetPacketNumberSpace(
                                 decrypted_packet_level)]
-      .RecordPacketReceived(header, receipt_time);
+      .RecordPacketReceived(header, receipt_time, ecn_codepoint);
 }
 
 void UberReceivedPacketManager::DontWaitForPacketsBefore(
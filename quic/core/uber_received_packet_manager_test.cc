@@ -62,7 +62,7 @@ class UberReceivedPacketManagerTest : public QuicTest {
     QuicPacketHeader header;
     header.packet_number = QuicPacketNumber(packet_number);
     manager_->RecordPacketReceived(decrypted_packet_level, header,
-                                   receipt_time);
+                                   receipt_time, ECN_NOT_ECT);
   }
 
   bool HasPendingAck() {
@@ -122,6 +122,7 @@ void MasqueClientSession::SendPacket(
     absl::string_view packet,
     const QuicSocketAddress& target_server_address,
     EncapsulatedClientSession* encapsulated_client_session) {
+  ++datagram_stats_.inner_packets_sent;
   if (masque_mode_ == MasqueMode::kLegacy) {
     compression_engine_.CompressAndSendPacket(packet, client_connection_id,
                                               server_connection_id,
@@ -199,6 +200,7 @@ void MasqueClientSession::OnConnectionClosed(
     const QuicConnectionCloseFrame& frame,
     ConnectionCloseSource source) {
   QuicSpdyClientSession::OnConnectionClosed(frame, source);
+  QUIC_DLOG(INFO) << "Datagram stats " << datagram_stats_;
   // Close all encapsulated sessions.
   for (const auto& client_state : connect_udp_client_states_) {
     client_state.encapsulated_client_session()->CloseConnection(
@@ -81,7 +81,9 @@ class QUIC_NO_EXPORT MasqueClientSession : public QuicSpdyClientSession {
   // From QuicSpdySession.
   bool OnSettingsFrame(const SettingsFrame& frame) override;
 
-  // Send encapsulated packet.
+  // Send encapsulated packet. Callers should send packets within a
+  // MasqueDatagramBatch on this session's connection, so that they are
+  // coalesced.
   void SendPacket(QuicConnectionId client_connection_id,
                   QuicConnectionId server_connection_id,
                   absl::string_view packet,
@@ -104,6 +106,9 @@ class QUIC_NO_EXPORT MasqueClientSession : public QuicSpdyClientSession {
       QuicConnectionId client_connection_id,
       EncapsulatedClientSession* encapsulated_client_session);
 
+  const MasqueDatagramStats& datagram_stats() const { return datagram_stats_; }
+  MasqueDatagramStats* mutable_datagram_stats() { return &datagram_stats_; }
+
  private:
   // State that the MasqueClientSession keeps for each CONNECT-UDP request.
   class QUIC_NO_EXPORT ConnectUdpClientState
@@ -175,6 +180,7 @@ class QUIC_NO_EXPORT MasqueClientSession : public QuicSpdyClientSession {
       client_connection_id_registrations_;
   Owner* owner_;  // Unowned;
   MasqueCompressionEngine compression_engine_;
+  MasqueDatagramStats datagram_stats_;
 };
 
 }  // namespace quic
@@ -3,6 +3,10 @@
 // found in the LICENSE file.
 
 #include "quic/masque/masque_encapsulated_epoll_client.h"
+
+#include <string>
+#include <vector>
+
 #include "quic/core/quic_utils.h"
 #include "quic/masque/masque_client_session.h"
 #include "quic/masque/masque_encapsulated_client_session.h"
@@ -14,7 +18,9 @@ namespace quic {
 namespace {
 
 // Custom packet writer that allows getting all of a connection's outgoing
-// packets.
+// packets.  It is a batch writer, so that the packets the connection writes
+// in one go are sent together, and their DATAGRAM frames are coalesced into
+// as few packets of the MASQUE connection as they fit in.
 class MasquePacketWriter : public QuicPacketWriter {
  public:
   explicit MasquePacketWriter(MasqueEncapsulatedEpollClient* client)
@@ -25,14 +31,15 @@ class MasquePacketWriter : public QuicPacketWriter {
                           const QuicSocketAddress& peer_address,
                           PerPacketOptions* /*options*/) override {
     QUICHE_DCHECK(peer_address.IsInitialized());
-    QUIC_DVLOG(1) << "MasquePacketWriter trying to write " << buf_len
+    QUIC_DVLOG(1) << "MasquePacketWriter buffering " << buf_len
                   << " bytes to " << peer_address;
-    absl::string_view packet(buffer, buf_len);
-    client_->masque_client()->masque_client_session()->SendPacket(
-        client_->session()->connection()->client_connection_id(),
-        client_->session()->connection()->connection_id(), packet, peer_address,
-        client_->masque_encapsulated_client_session());
-    return WriteResult(WRITE_STATUS_OK, buf_len);
+    buffered_packets_.push_back(
+        BufferedPacket{std::string(buffer, buf_len), peer_address});
+    if (buffered_packets_.size() >= kMaxBufferedPackets) {
+      return Flush();
+    }
+    // Like other batch writers, report buffered packets as zero bytes written.
+    return WriteResult(WRITE_STATUS_OK, 0);
   }
 
   bool IsWriteBlocked() const override { return false; }
@@ -46,17 +53,47 @@ class MasquePacketWriter : public QuicPacketWriter {
 
   bool SupportsReleaseTime() const override { return false; }
 
-  bool IsBatchMode() const override { return false; }
+  bool IsBatchMode() const override { return true; }
   QuicPacketBuffer GetNextWriteLocation(
       const QuicIpAddress& /*self_address*/,
       const QuicSocketAddress& /*peer_address*/) override {
     return {nullptr, nullptr};
   }
 
-  WriteResult Flush() override { return WriteResult(WRITE_STATUS_OK, 0); }
+  WriteResult Flush() override {
+    if (buffered_packets_.empty()) {
+      return WriteResult(WRITE_STATUS_OK, 0);
+    }
+    std::vector<BufferedPacket> packets;
+    packets.swap(buffered_packets_);
+    MasqueClientSession* masque_session =
+        client_->masque_client()->masque_client_session();
+    MasqueDatagramBatch batch(masque_session->connection(),
+                              masque_session->mutable_datagram_stats());
+    int bytes_written = 0;
+    for (const BufferedPacket& packet : packets) {
+      QUIC_DVLOG(1) << "MasquePacketWriter writing " << packet.packet.size()
+                    << " bytes to " << packet.peer_address;
+      masque_session->SendPacket(
+          client_->session()->connection()->client_connection_id(),
+          client_->session()->connection()->connection_id(), packet.packet,
+          packet.peer_address, client_->masque_encapsulated_client_session());
+      bytes_written += packet.packet.size();
+    }
+    return WriteResult(WRITE_STATUS_OK, bytes_written);
+  }
 
  private:
+  // Flush when this many packets are buffered.
+  static constexpr size_t kMaxBufferedPackets = 16;
+
+  struct BufferedPacket {
+    std::string packet;
+    QuicSocketAddress peer_address;
+  };
+
   MasqueEncapsulatedEpollClient* client_;  // Unowned.
+  std::vector<BufferedPacket> buffered_packets_;
 };
 
 // Custom network helper that allows injecting a custom packet writer in order
@@ -145,7 +145,8 @@ void MasqueServerSession::OnMessageLost(QuicMessageId message_id) {
 void MasqueServerSession::OnConnectionClosed(
     const QuicConnectionCloseFrame& frame, ConnectionCloseSource source) {
   QuicSimpleServerSession::OnConnectionClosed(frame, source);
-  QUIC_DLOG(INFO) << "Closing connection for " << connection_id();
+  QUIC_DLOG(INFO) << "Closing connection for " << connection_id()
+                  << " with datagram stats " << datagram_stats_;
   masque_server_backend_->RemoveBackendClient(connection_id());
   // Clearing this state will close all sockets.
   connect_udp_server_states_.clear();
@@ -323,6 +324,8 @@ void MasqueServerSession::HandlePacketFromServer(
     const ReceivedPacketInfo& packet_info) {
   QUIC_DVLOG(1) << "MasqueServerSession received " << packet_info;
   if (masque_mode_ == MasqueMode::kLegacy) {
+    MasqueDatagramBatch batch(connection(), &datagram_stats_);
+    ++datagram_stats_.inner_packets_sent;
     compression_engine_.CompressAndSendPacket(
         packet_info.packet.AsStringPiece(),
         packet_info.destination_connection_id, packet_info.source_connection_id,
@@ -367,6 +370,8 @@ void MasqueServerSession::OnEvent(QuicUdpSocketFd fd, QuicEpollEvent* event) {
   BitMask64 packet_info_interested(QuicUdpPacketInfoBit::PEER_ADDRESS);
   char packet_buffer[kMaxIncomingPacketSize];
   char control_buffer[kDefaultUdpPacketControlBufferSize];
+  // Coalesce the DATAGRAM frames of the packets read in one go.
+  MasqueDatagramBatch batch(connection(), &datagram_stats_);
   while (true) {
     QuicUdpSocketApi::ReadPacketResult read_result;
     read_result.packet_buffer = {packet_buffer, sizeof(packet_buffer)};
@@ -398,6 +403,7 @@ void MasqueServerSession::OnEvent(QuicUdpSocketFd fd, QuicEpollEvent* event) {
       return;
     }
     // The packet is valid, send it to the client in a DATAGRAM frame.
+    ++datagram_stats_.inner_packets_sent;
     MessageStatus message_status = it->stream()->SendHttp3Datagram(
         it->context_id(),
         absl::string_view(read_result.packet_buffer.buffer,
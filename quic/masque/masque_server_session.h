@@ -80,6 +80,8 @@ class QUIC_NO_EXPORT MasqueServerSession
 
   QuicEpollServer* epoll_server() const { return epoll_server_; }
 
+  const MasqueDatagramStats& datagram_stats() const { return datagram_stats_; }
+
  private:
   // State that the MasqueServerSession keeps for each CONNECT-UDP request.
   class QUIC_NO_EXPORT ConnectUdpServerState
@@ -143,6 +145,7 @@ class QUIC_NO_EXPORT MasqueServerSession
   QuicEpollServer* epoll_server_;               // Unowned.
   MasqueCompressionEngine compression_engine_;
   MasqueMode masque_mode_;
+  MasqueDatagramStats datagram_stats_;
   std::list<ConnectUdpServerState> connect_udp_server_states_;
   bool masque_initialized_ = false;
 };
@@ -43,4 +43,34 @@ std::ostream& operator<<(std::ostream& os, const MasqueMode& masque_mode) {
   return os;
 }
 
+double MasqueDatagramStats::OuterPacketsPerInnerPacket() const {
+  if (inner_packets_sent == 0) {
+    return 0;
+  }
+  return static_cast<double>(outer_packets_sent) / inner_packets_sent;
+}
+
+std::ostream& operator<<(std::ostream& os, const MasqueDatagramStats& stats) {
+  os << "{ inner_packets_sent: " << stats.inner_packets_sent
+     << " outer_packets_sent: " << stats.outer_packets_sent
+     << " outer_packets_per_inner_packet: "
+     << stats.OuterPacketsPerInnerPacket() << " }";
+  return os;
+}
+
+MasqueDatagramBatch::MasqueDatagramBatch(QuicConnection* connection,
+                                         MasqueDatagramStats* stats)
+    : connection_(connection),
+      stats_(stats),
+      packets_sent_before_(connection->GetStats().packets_sent) {
+  flusher_.emplace(connection);
+}
+
+MasqueDatagramBatch::~MasqueDatagramBatch() {
+  // Flush first, so that the packets it sends are counted.
+  flusher_.reset();
+  stats_->outer_packets_sent +=
+      connection_->GetStats().packets_sent - packets_sent_before_;
+}
+
 }  // namespace quic
@@ -5,7 +5,9 @@
 #ifndef QUICHE_QUIC_MASQUE_MASQUE_UTILS_H_
 #define QUICHE_QUIC_MASQUE_MASQUE_UTILS_H_
 
+#include "absl/types/optional.h"
 #include "quic/core/quic_config.h"
+#include "quic/core/quic_connection.h"
 #include "quic/core/quic_types.h"
 #include "quic/core/quic_versions.h"
 
@@ -37,6 +39,42 @@ QUIC_NO_EXPORT std::string MasqueModeToString(MasqueMode masque_mode);
 QUIC_NO_EXPORT std::ostream& operator<<(std::ostream& os,
                                         const MasqueMode& masque_mode);
 
+// Counts the encapsulated packets sent in DATAGRAM frames and the packets of
+// the MASQUE connection that carried them, to measure how many of the former
+// get coalesced into each of the latter.
+struct QUIC_NO_EXPORT MasqueDatagramStats {
+  // Encapsulated packets sent.
+  uint64_t inner_packets_sent = 0;
+  // Packets sent by the MASQUE connection during MasqueDatagramBatch
+  // lifetimes, including the ones that only carry other frames.
+  uint64_t outer_packets_sent = 0;
+
+  // Returns outer_packets_sent / inner_packets_sent, or 0 if no encapsulated
+  // packets were sent.
+  double OuterPacketsPerInnerPacket() const;
+};
+
+QUIC_NO_EXPORT std::ostream& operator<<(std::ostream& os,
+                                        const MasqueDatagramStats& stats);
+
+// Coalesces the DATAGRAM frames sent on |connection| while it is alive into as
+// few packets as they fit in, and adds the number of packets that were sent to
+// |stats|.  Batches must not be nested.
+class QUIC_NO_EXPORT MasqueDatagramBatch {
+ public:
+  MasqueDatagramBatch(QuicConnection* connection, MasqueDatagramStats* stats);
+  ~MasqueDatagramBatch();
+
+  MasqueDatagramBatch(const MasqueDatagramBatch&) = delete;
+  MasqueDatagramBatch& operator=(const MasqueDatagramBatch&) = delete;
+
+ private:
+  QuicConnection* connection_;  // Unowned.
+  MasqueDatagramStats* stats_;  // Unowned.
+  const QuicPacketCount packets_sent_before_;
+  absl::optional<QuicConnection::ScopedPacketFlusher> flusher_;
+};
+
 }  // namespace quic
 
 #endif  // QUICHE_QUIC_MASQUE_MASQUE_UTILS_H_
@@ -13,8 +13,17 @@
 #include "absl/cleanup/cleanup.h"
 #include "quic/platform/api/quic_bug_tracker.h"
 #include "quic/platform/api/quic_logging.h"
+#include "quic/qbone/bonnet/tun_device_offload.h"
 #include "quic/qbone/platform/kernel_interface.h"
 
+// Added in Linux 6.2.
+#ifndef TUN_F_USO4
+#define TUN_F_USO4 0x20
+#endif
+#ifndef TUN_F_USO6
+#define TUN_F_USO6 0x40
+#endif
+
 ABSL_FLAG(std::string,
           qbone_client_tun_device_path,
           "/dev/net/tun",
@@ -97,6 +106,18 @@ int TunDevice::GetFileDescriptor() const {
   return file_descriptor_;
 }
 
+std::vector<int> TunDevice::GetQueueFileDescriptors() const {
+  std::vector<int> file_descriptors;
+  if (file_descriptor_ == kInvalidFd) {
+    return file_descriptors;
+  }
+  file_descriptors.push_back(file_descriptor_);
+  file_descriptors.insert(file_descriptors.end(),
+                          extra_queue_file_descriptors_.begin(),
+                          extra_queue_file_descriptors_.end());
+  return file_descriptors;
+}
+
 bool TunDevice::OpenDevice() {
   if (file_descriptor_ != kInvalidFd) {
     CloseDevice();
@@ -114,6 +135,9 @@ bool TunDevice::OpenDevice() {
   // routing associated with the interface, which makes the meaning of the
   // 'persist' bit ambiguous.
   if_request.ifr_flags = IFF_TUN | IFF_MULTI_QUEUE | IFF_NO_PI;
+  if (vnet_header_enabled_) {
+    if_request.ifr_flags |= IFF_VNET_HDR;
+  }
 
   // When the device is running with IFF_MULTI_QUEUE set, each call to open will
   // create a queue which can be used to read/write packets from/to the device.
@@ -141,6 +165,11 @@ bool TunDevice::OpenDevice() {
     return successfully_opened;
   }
 
+  // The vnet header size and the offloads apply to all the queues.
+  if (vnet_header_enabled_ && !EnableOffloads(fd)) {
+    return successfully_opened;
+  }
+
   if (kernel_.ioctl(
           fd, TUNSETPERSIST,
           persist_ ? reinterpret_cast<void*>(&if_request) : nullptr) != 0) {
@@ -148,6 +177,21 @@ bool TunDevice::OpenDevice() {
     return successfully_opened;
   }
 
+  for (int i = 1; i < num_queues_; ++i) {
+    int queue_fd = kernel_.open(tun_device_path.c_str(), O_RDWR);
+    if (queue_fd < 0) {
+      QUIC_PLOG(WARNING) << "Failed to open " << tun_device_path
+                         << " for queue " << i;
+      return successfully_opened;
+    }
+    extra_queue_file_descriptors_.push_back(queue_fd);
+    if (kernel_.ioctl(queue_fd, TUNSETIFF,
+                      reinterpret_cast<void*>(&if_request)) != 0) {
+      QUIC_PLOG(WARNING) << "Failed to TUNSETIFF on fd(" << queue_fd << ")";
+      return successfully_opened;
+    }
+  }
+
   successfully_opened = true;
   return successfully_opened;
 }
@@ -181,6 +225,9 @@ bool TunDevice::CheckFeatures(int tun_device_fd) {
     return false;
   }
   unsigned int required_features = IFF_TUN | IFF_NO_PI;
+  if (vnet_header_enabled_) {
+    required_features |= IFF_VNET_HDR;
+  }
   if ((required_features & actual_features) != required_features) {
     QUIC_LOG(WARNING)
         << "Required feature does not exist. required_features: 0x" << std::hex
@@ -191,6 +238,31 @@ bool TunDevice::CheckFeatures(int tun_device_fd) {
   return true;
 }
 
+bool TunDevice::EnableOffloads(int tun_device_fd) {
+  int header_size = kTunVnetHeaderSize;
+  if (kernel_.ioctl(tun_device_fd, TUNSETVNETHDRSZ, &header_size) != 0) {
+    QUIC_PLOG(WARNING) << "Failed to TUNSETVNETHDRSZ on fd(" << tun_device_fd
+                       << ")";
+    return false;
+  }
+  // TUNSETOFFLOAD takes the offloads as its argument rather than a pointer.
+  const uintptr_t offloads =
+      TUN_F_CSUM | TUN_F_TSO4 | TUN_F_TSO6 | TUN_F_TSO_ECN;
+  if (kernel_.ioctl(tun_device_fd, TUNSETOFFLOAD,
+                    reinterpret_cast<void*>(offloads | TUN_F_USO4 |
+                                            TUN_F_USO6)) == 0) {
+    return true;
+  }
+  // Kernels before 6.2 don't support UDP segmentation offload.
+  if (kernel_.ioctl(tun_device_fd, TUNSETOFFLOAD,
+                    reinterpret_cast<void*>(offloads)) != 0) {
+    QUIC_PLOG(WARNING) << "Failed to TUNSETOFFLOAD on fd(" << tun_device_fd
+                       << ")";
+    return false;
+  }
+  return true;
+}
+
 bool TunDevice::NetdeviceIoctl(int request, void* argp) {
   int fd = kernel_.socket(AF_INET6, SOCK_DGRAM, 0);
   if (fd < 0) {
@@ -208,6 +280,10 @@ bool TunDevice::NetdeviceIoctl(int request, void* argp) {
 }
 
 void TunDevice::CloseDevice() {
+  for (int fd : extra_queue_file_descriptors_) {
+    kernel_.close(fd);
+  }
+  extra_queue_file_descriptors_.clear();
   if (file_descriptor_ != kInvalidFd) {
     kernel_.close(file_descriptor_);
     file_descriptor_ = kInvalidFd;
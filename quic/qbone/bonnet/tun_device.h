@@ -58,6 +58,24 @@ class TunDevice : public TunDeviceInterface {
   // This returns -1 when the TUN device is in an invalid state.
   int GetFileDescriptor() const override;
 
+  // Sets the number of queues to open on the next Init().  Each queue has its
+  // own file descriptor, so that packets can be read and written by as many
+  // threads, and the kernel spreads the flows sent to the device across them.
+  void set_num_queues(int num_queues) { num_queues_ = num_queues; }
+
+  // If set before Init(), the device is opened with IFF_VNET_HDR and TCP and
+  // UDP segmentation offloads are enabled, so that the kernel hands it packets
+  // of up to 64KB.  Every packet read from or written to the device is then
+  // preceded by a TunVnetHeader, see TunDevicePacketExchanger.
+  void set_vnet_header_enabled(bool vnet_header_enabled) {
+    vnet_header_enabled_ = vnet_header_enabled;
+  }
+
+  // Gets the file descriptors of all the queues of the device, the first of
+  // which is GetFileDescriptor().  This is empty when the TUN device is in an
+  // invalid state.
+  std::vector<int> GetQueueFileDescriptors() const;
+
  private:
   // Creates or reopens the tun device.
   bool OpenDevice();
@@ -68,6 +86,9 @@ class TunDevice : public TunDeviceInterface {
   // Checks if the required kernel features exists.
   bool CheckFeatures(int tun_device_fd);
 
+  // Sets the vnet header size and enables the offloads of the device.
+  bool EnableOffloads(int tun_device_fd);
+
   // Opens a socket and makes netdevice ioctl call
   bool NetdeviceIoctl(int request, void* argp);
 
@@ -75,7 +96,11 @@ class TunDevice : public TunDeviceInterface {
   const int mtu_;
   const bool persist_;
   const bool setup_tun_;
+  int num_queues_ = 1;
+  bool vnet_header_enabled_ = false;
   int file_descriptor_;
+  // The file descriptors of the queues beyond the first.
+  std::vector<int> extra_queue_file_descriptors_;
   KernelInterface& kernel_;
 };
 
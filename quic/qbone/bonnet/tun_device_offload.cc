@@ -0,0 +1,319 @@
+// Copyright (c) 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "quic/qbone/bonnet/tun_device_offload.h"
+
+#include <netinet/in.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#include "absl/strings/str_cat.h"
+#include "quic/qbone/platform/internet_checksum.h"
+#include "common/quiche_endian.h"
+
+namespace quic {
+
+namespace {
+
+constexpr size_t kIPv4HeaderSize = 20;
+constexpr size_t kIPv6HeaderSize = 40;
+constexpr size_t kTcpHeaderSize = 20;
+constexpr size_t kUdpHeaderSize = 8;
+
+// Offsets of the fields rewritten in each segment.
+constexpr size_t kIPv4TotalLengthOffset = 2;
+constexpr size_t kIPv4IdOffset = 4;
+constexpr size_t kIPv4ProtocolOffset = 9;
+constexpr size_t kIPv4ChecksumOffset = 10;
+constexpr size_t kIPv4SourceOffset = 12;
+constexpr size_t kIPv6PayloadLengthOffset = 4;
+constexpr size_t kIPv6NextHeaderOffset = 6;
+constexpr size_t kIPv6SourceOffset = 8;
+constexpr size_t kTcpSequenceOffset = 4;
+constexpr size_t kTcpDataOffsetOffset = 12;
+constexpr size_t kTcpFlagsOffset = 13;
+constexpr size_t kTcpChecksumOffset = 16;
+constexpr size_t kUdpLengthOffset = 4;
+constexpr size_t kUdpChecksumOffset = 6;
+
+constexpr uint8_t kTcpFin = 0x01;
+constexpr uint8_t kTcpPsh = 0x08;
+constexpr uint8_t kTcpCwr = 0x80;
+
+uint16_t Read16(const char* data) {
+  uint16_t value;
+  memcpy(&value, data, sizeof(value));
+  return quiche::QuicheEndian::NetToHost16(value);
+}
+
+void Write16(char* data, uint16_t value) {
+  value = quiche::QuicheEndian::HostToNet16(value);
+  memcpy(data, &value, sizeof(value));
+}
+
+uint32_t Read32(const char* data) {
+  uint32_t value;
+  memcpy(&value, data, sizeof(value));
+  return quiche::QuicheEndian::NetToHost32(value);
+}
+
+void Write32(char* data, uint32_t value) {
+  value = quiche::QuicheEndian::HostToNet32(value);
+  memcpy(data, &value, sizeof(value));
+}
+
+// Stores |checksum|, which is in network order already, at |data|.
+void WriteChecksum(char* data, uint16_t checksum) {
+  memcpy(data, &checksum, sizeof(checksum));
+}
+
+// The parts of an IP packet needed to segment it.
+struct IpHeaderInfo {
+  bool ipv6;
+  size_t ip_header_size;
+  uint8_t protocol;
+  // Offset and size of the source address, which is followed by the
+  // destination address.
+  size_t address_offset;
+  size_t address_size;
+};
+
+bool ParseIpHeader(const char* packet,
+                   size_t length,
+                   IpHeaderInfo* info,
+                   std::string* error) {
+  if (length < 1) {
+    *error = "Empty packet";
+    return false;
+  }
+  const uint8_t version = static_cast<uint8_t>(packet[0]) >> 4;
+  if (version == 4) {
+    info->ipv6 = false;
+    info->ip_header_size = (static_cast<uint8_t>(packet[0]) & 0x0f) * 4;
+    if (info->ip_header_size < kIPv4HeaderSize ||
+        length < info->ip_header_size) {
+      *error = "Truncated IPv4 header";
+      return false;
+    }
+    info->protocol = packet[kIPv4ProtocolOffset];
+    info->address_offset = kIPv4SourceOffset;
+    info->address_size = 4;
+    return true;
+  }
+  if (version == 6) {
+    if (length < kIPv6HeaderSize) {
+      *error = "Truncated IPv6 header";
+      return false;
+    }
+    info->ipv6 = true;
+    info->ip_header_size = kIPv6HeaderSize;
+    // Extension headers are not supported, the kernel doesn't offload
+    // packets with them.
+    info->protocol = packet[kIPv6NextHeaderOffset];
+    info->address_offset = kIPv6SourceOffset;
+    info->address_size = 16;
+    return true;
+  }
+  *error = absl::StrCat("Unknown IP version ", static_cast<int>(version));
+  return false;
+}
+
+// Sets the checksum of the TCP or UDP segment in |packet|.
+void SetTransportChecksum(char* packet,
+                          size_t length,
+                          const IpHeaderInfo& info) {
+  const size_t transport_size = length - info.ip_header_size;
+  char* transport = packet + info.ip_header_size;
+  const size_t checksum_offset =
+      info.protocol == IPPROTO_TCP ? kTcpChecksumOffset : kUdpChecksumOffset;
+  WriteChecksum(transport + checksum_offset, 0);
+
+  InternetChecksum checksum;
+  // The source and destination addresses.
+  checksum.Update(packet + info.address_offset, 2 * info.address_size);
+  // The rest of the IPv4 and IPv6 pseudo-headers add up to the same sum for
+  // segments shorter than 64KB.
+  char pseudo_header[4] = {0, static_cast<char>(info.protocol)};
+  Write16(pseudo_header + 2, static_cast<uint16_t>(transport_size));
+  checksum.Update(pseudo_header, sizeof(pseudo_header));
+  checksum.Update(transport, transport_size);
+  uint16_t value = checksum.Value();
+  if (value == 0 && info.protocol == IPPROTO_UDP) {
+    // Zero means no checksum in UDP over IPv4.
+    value = 0xffff;
+  }
+  WriteChecksum(transport + checksum_offset, value);
+}
+
+void SetIPv4HeaderChecksum(char* packet, size_t ip_header_size) {
+  WriteChecksum(packet + kIPv4ChecksumOffset, 0);
+  InternetChecksum checksum;
+  checksum.Update(packet, ip_header_size);
+  WriteChecksum(packet + kIPv4ChecksumOffset, checksum.Value());
+}
+
+// Completes the partial checksum the kernel left to the device, as described
+// by |csum_start| and |csum_offset|.
+bool CompleteChecksum(char* packet,
+                      size_t length,
+                      size_t csum_start,
+                      size_t csum_offset,
+                      std::string* error) {
+  if (csum_start + csum_offset + sizeof(uint16_t) > length) {
+    *error = absl::StrCat("Checksum offset ", csum_start, "+", csum_offset,
+                          " is out of bounds of a ", length, " byte packet");
+    return false;
+  }
+  // The checksum field holds the sum of the pseudo-header, so summing it with
+  // the rest of the data gives the full checksum.
+  InternetChecksum checksum;
+  checksum.Update(packet + csum_start, length - csum_start);
+  uint16_t value = checksum.Value();
+  WriteChecksum(packet + csum_start + csum_offset, value == 0 ? 0xffff : value);
+  return true;
+}
+
+}  // namespace
+
+bool SegmentTunOffloadPacket(char* packet,
+                             size_t length,
+                             std::vector<char>* buffer,
+                             std::vector<absl::string_view>* segments,
+                             std::string* error) {
+  segments->clear();
+  if (length < kTunVnetHeaderSize) {
+    *error = absl::StrCat("Packet of ", length,
+                          " bytes is shorter than the vnet header");
+    return false;
+  }
+  TunVnetHeader header;
+  memcpy(&header, packet, sizeof(header));
+  packet += kTunVnetHeaderSize;
+  length -= kTunVnetHeaderSize;
+
+  const uint8_t gso_type =
+      header.gso_type & static_cast<uint8_t>(~kTunVnetGsoEcn);
+  if (gso_type == kTunVnetGsoNone) {
+    if ((header.flags & kTunVnetNeedsChecksum) &&
+        !CompleteChecksum(packet, length, header.csum_start,
+                          header.csum_offset, error)) {
+      return false;
+    }
+    segments->push_back(absl::string_view(packet, length));
+    return true;
+  }
+
+  uint8_t expected_protocol;
+  switch (gso_type) {
+    case kTunVnetGsoTcpV4:
+    case kTunVnetGsoTcpV6:
+      expected_protocol = IPPROTO_TCP;
+      break;
+    case kTunVnetGsoUdpL4:
+      expected_protocol = IPPROTO_UDP;
+      break;
+    default:
+      *error =
+          absl::StrCat("Unsupported GSO type ", static_cast<int>(gso_type));
+      return false;
+  }
+  IpHeaderInfo info;
+  if (!ParseIpHeader(packet, length, &info, error)) {
+    return false;
+  }
+  if (info.protocol != expected_protocol ||
+      (gso_type == kTunVnetGsoTcpV4 && info.ipv6) ||
+      (gso_type == kTunVnetGsoTcpV6 && !info.ipv6)) {
+    *error = absl::StrCat("GSO type ", static_cast<int>(gso_type),
+                          " does not match IP protocol ",
+                          static_cast<int>(info.protocol));
+    return false;
+  }
+  size_t transport_header_size = kUdpHeaderSize;
+  if (info.protocol == IPPROTO_TCP) {
+    if (length < info.ip_header_size + kTcpHeaderSize) {
+      *error = "Truncated TCP header";
+      return false;
+    }
+    const uint8_t data_offset =
+        packet[info.ip_header_size + kTcpDataOffsetOffset];
+    transport_header_size = (data_offset >> 4) * 4;
+  }
+  const size_t headers_size = info.ip_header_size + transport_header_size;
+  if (transport_header_size < kUdpHeaderSize || headers_size > length) {
+    *error = "Truncated transport header";
+    return false;
+  }
+  const size_t segment_size = header.gso_size;
+  if (segment_size == 0) {
+    *error = "GSO packet with zero gso_size";
+    return false;
+  }
+
+  const size_t payload_size = length - headers_size;
+  const size_t num_segments =
+      std::max<size_t>(1, (payload_size + segment_size - 1) / segment_size);
+  const size_t required_size = payload_size + num_segments * headers_size;
+  if (buffer->size() < required_size) {
+    buffer->resize(required_size);
+  }
+
+  const uint16_t ip_id = info.ipv6 ? 0 : Read16(packet + kIPv4IdOffset);
+  const uint32_t tcp_sequence =
+      info.protocol == IPPROTO_TCP
+          ? Read32(packet + info.ip_header_size + kTcpSequenceOffset)
+          : 0;
+  const uint8_t tcp_flags =
+      info.protocol == IPPROTO_TCP
+          ? packet[info.ip_header_size + kTcpFlagsOffset]
+          : 0;
+  char* output = buffer->data();
+  for (size_t i = 0, payload_offset = 0; i < num_segments; ++i) {
+    const size_t segment_payload_size =
+        std::min(segment_size, payload_size - payload_offset);
+    const size_t segment_length = headers_size + segment_payload_size;
+    memcpy(output, packet, headers_size);
+    memcpy(output + headers_size, packet + headers_size + payload_offset,
+           segment_payload_size);
+
+    if (info.ipv6) {
+      Write16(output + kIPv6PayloadLengthOffset,
+              static_cast<uint16_t>(segment_length - kIPv6HeaderSize));
+    } else {
+      Write16(output + kIPv4TotalLengthOffset,
+              static_cast<uint16_t>(segment_length));
+      Write16(output + kIPv4IdOffset, static_cast<uint16_t>(ip_id + i));
+      SetIPv4HeaderChecksum(output, info.ip_header_size);
+    }
+
+    char* transport = output + info.ip_header_size;
+    if (info.protocol == IPPROTO_TCP) {
+      Write32(transport + kTcpSequenceOffset,
+              tcp_sequence + static_cast<uint32_t>(payload_offset));
+      uint8_t flags = tcp_flags;
+      if (i + 1 < num_segments) {
+        // FIN and PSH belong to the last segment only.
+        flags &= ~(kTcpFin | kTcpPsh);
+      }
+      if (i > 0) {
+        // CWR is only set on the first segment.
+        flags &= ~kTcpCwr;
+      }
+      transport[kTcpFlagsOffset] = static_cast<char>(flags);
+    } else {
+      Write16(transport + kUdpLengthOffset,
+              static_cast<uint16_t>(segment_length - info.ip_header_size));
+    }
+    SetTransportChecksum(output, segment_length, info);
+
+    segments->push_back(absl::string_view(output, segment_length));
+    output += segment_length;
+    payload_offset += segment_payload_size;
+  }
+  return true;
+}
+
+}  // namespace quic
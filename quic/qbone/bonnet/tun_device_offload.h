@@ -0,0 +1,63 @@
+// Copyright (c) 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef QUICHE_QUIC_QBONE_BONNET_TUN_DEVICE_OFFLOAD_H_
+#define QUICHE_QUIC_QBONE_BONNET_TUN_DEVICE_OFFLOAD_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+
+namespace quic {
+
+// The virtio_net_hdr which precedes every packet read from or written to a TUN
+// device opened with IFF_VNET_HDR.  <linux/virtio_net.h> can't be included in
+// C++ code, since it uses |class| as a field name.  The fields are in host
+// byte order.
+struct TunVnetHeader {
+  uint8_t flags;
+  uint8_t gso_type;
+  uint16_t hdr_len;
+  uint16_t gso_size;
+  uint16_t csum_start;
+  uint16_t csum_offset;
+};
+
+constexpr size_t kTunVnetHeaderSize = sizeof(TunVnetHeader);
+
+// TunVnetHeader::flags
+constexpr uint8_t kTunVnetNeedsChecksum = 1;  // VIRTIO_NET_HDR_F_NEEDS_CSUM
+
+// TunVnetHeader::gso_type
+constexpr uint8_t kTunVnetGsoNone = 0;    // VIRTIO_NET_HDR_GSO_NONE
+constexpr uint8_t kTunVnetGsoTcpV4 = 1;   // VIRTIO_NET_HDR_GSO_TCPV4
+constexpr uint8_t kTunVnetGsoTcpV6 = 4;   // VIRTIO_NET_HDR_GSO_TCPV6
+constexpr uint8_t kTunVnetGsoUdpL4 = 5;   // VIRTIO_NET_HDR_GSO_UDP_L4
+constexpr uint8_t kTunVnetGsoEcn = 0x80;  // VIRTIO_NET_HDR_GSO_ECN
+
+// The largest packet the kernel hands to a TUN device with TSO enabled,
+// excluding the TunVnetHeader.
+constexpr size_t kTunMaxOffloadPacketSize = 65535;
+
+// Splits |packet|, which was read from a TUN device opened with IFF_VNET_HDR
+// and starts with a TunVnetHeader, into the IP packets it stands for:
+//  - A packet without GSO is returned as is, after completing its checksum if
+//    the kernel left that to the device.  This is done in place.
+//  - A TCP or UDP GSO packet is segmented into packets with gso_size bytes of
+//    payload each, with their IP and transport headers and checksums fixed
+//    up.  The segments are written to |buffer|, which is only grown.
+// |segments| is set to the resulting packets.  Returns false and sets |error|
+// if the packet is malformed or uses an unsupported offload.
+bool SegmentTunOffloadPacket(char* packet,
+                             size_t length,
+                             std::vector<char>* buffer,
+                             std::vector<absl::string_view>* segments,
+                             std::string* error);
+
+}  // namespace quic
+
+#endif  // QUICHE_QUIC_QBONE_BONNET_TUN_DEVICE_OFFLOAD_H_
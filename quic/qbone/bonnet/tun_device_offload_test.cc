@@ -0,0 +1,248 @@
+// Copyright (c) 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "quic/qbone/bonnet/tun_device_offload.h"
+
+#include <netinet/in.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "quic/platform/api/quic_test.h"
+#include "quic/qbone/platform/internet_checksum.h"
+
+namespace quic {
+namespace {
+
+uint16_t ReadUint16(const char* data) {
+  return (static_cast<uint8_t>(data[0]) << 8) | static_cast<uint8_t>(data[1]);
+}
+
+uint32_t ReadUint32(const char* data) {
+  return (static_cast<uint32_t>(ReadUint16(data)) << 16) |
+         ReadUint16(data + 2);
+}
+
+void WriteUint16(char* data, uint16_t value) {
+  data[0] = static_cast<char>(value >> 8);
+  data[1] = static_cast<char>(value);
+}
+
+// Builds a packet read from a TUN device: a TunVnetHeader followed by an IP
+// packet with a 20 byte TCP header or an 8 byte UDP header, and |payload|.
+std::string MakePacket(const TunVnetHeader& header,
+                       bool ipv6,
+                       uint8_t protocol,
+                       const std::string& payload) {
+  const size_t ip_header_size = ipv6 ? 40 : 20;
+  const size_t transport_header_size = protocol == IPPROTO_TCP ? 20 : 8;
+  std::string packet(sizeof(header) + ip_header_size + transport_header_size,
+                     '\0');
+  memcpy(&packet[0], &header, sizeof(header));
+  char* ip = &packet[sizeof(header)];
+  const size_t ip_length =
+      ip_header_size + transport_header_size + payload.size();
+  if (ipv6) {
+    ip[0] = 0x60;
+    WriteUint16(ip + 4, ip_length - ip_header_size);
+    ip[6] = protocol;
+    ip[7] = 64;
+    // Source fd00::1 and destination fd00::2.
+    ip[8] = ip[24] = static_cast<char>(0xfd);
+    ip[23] = 1;
+    ip[39] = 2;
+  } else {
+    ip[0] = 0x45;
+    WriteUint16(ip + 2, ip_length);
+    WriteUint16(ip + 4, 0x1234);
+    ip[8] = 64;
+    ip[9] = protocol;
+    // Source 10.0.0.1 and destination 10.0.0.2.
+    ip[12] = ip[16] = 10;
+    ip[15] = 1;
+    ip[19] = 2;
+    InternetChecksum checksum;
+    checksum.Update(ip, ip_header_size);
+    const uint16_t value = checksum.Value();
+    memcpy(ip + 10, &value, sizeof(value));
+  }
+  char* transport = ip + ip_header_size;
+  WriteUint16(transport, 443);
+  WriteUint16(transport + 2, 12345);
+  if (protocol == IPPROTO_TCP) {
+    WriteUint16(transport + 4, 0x1000);  // Sequence number 0x10000000.
+    transport[12] = 5 << 4;
+    // CWR, PSH, ACK and FIN.
+    transport[13] = static_cast<char>(0x80 | 0x08 | 0x10 | 0x01);
+  } else {
+    WriteUint16(transport + 4, transport_header_size + payload.size());
+  }
+  return packet + payload;
+}
+
+// Verifies the checksums of the IP |packet|.
+void ExpectValidChecksums(absl::string_view packet) {
+  const bool ipv6 = (packet[0] >> 4) == 6;
+  const size_t ip_header_size = ipv6 ? 40 : 20;
+  if (!ipv6) {
+    InternetChecksum checksum;
+    checksum.Update(packet.data(), ip_header_size);
+    EXPECT_EQ(0, checksum.Value());
+  }
+  InternetChecksum checksum;
+  checksum.Update(packet.data() + (ipv6 ? 8 : 12), ipv6 ? 32 : 8);
+  char pseudo_header[4] = {0, packet[ipv6 ? 6 : 9]};
+  WriteUint16(pseudo_header + 2, packet.size() - ip_header_size);
+  checksum.Update(pseudo_header, sizeof(pseudo_header));
+  checksum.Update(packet.data() + ip_header_size,
+                  packet.size() - ip_header_size);
+  EXPECT_EQ(0, checksum.Value());
+}
+
+class TunDeviceOffloadTest : public QuicTest {
+ protected:
+  bool Segment(std::string* packet) {
+    return SegmentTunOffloadPacket(&(*packet)[0], packet->size(), &buffer_,
+                                   &segments_, &error_);
+  }
+
+  std::vector<char> buffer_;
+  std::vector<absl::string_view> segments_;
+  std::string error_;
+};
+
+TEST_F(TunDeviceOffloadTest, PacketWithoutOffload) {
+  TunVnetHeader header = {};
+  std::string packet =
+      MakePacket(header, /*ipv6=*/false, IPPROTO_UDP, "payload");
+  ASSERT_TRUE(Segment(&packet));
+  ASSERT_EQ(1u, segments_.size());
+  EXPECT_EQ(packet.substr(kTunVnetHeaderSize), segments_[0]);
+  // The packet is returned in place.
+  EXPECT_EQ(packet.data() + kTunVnetHeaderSize, segments_[0].data());
+}
+
+TEST_F(TunDeviceOffloadTest, CompletesChecksum) {
+  TunVnetHeader header = {};
+  header.flags = kTunVnetNeedsChecksum;
+  header.csum_start = 20;
+  header.csum_offset = 6;
+  std::string packet =
+      MakePacket(header, /*ipv6=*/false, IPPROTO_UDP, "payload");
+  // The kernel leaves the sum of the pseudo-header in the checksum field.
+  InternetChecksum pseudo_header_checksum;
+  pseudo_header_checksum.Update(&packet[kTunVnetHeaderSize + 12], 8);
+  const char length_and_protocol[4] = {0, IPPROTO_UDP, 0, 15};
+  pseudo_header_checksum.Update(length_and_protocol, 4);
+  const uint16_t sum = ~pseudo_header_checksum.Value();
+  memcpy(&packet[kTunVnetHeaderSize + 26], &sum, sizeof(sum));
+
+  ASSERT_TRUE(Segment(&packet));
+  ASSERT_EQ(1u, segments_.size());
+  ExpectValidChecksums(segments_[0]);
+}
+
+TEST_F(TunDeviceOffloadTest, SegmentsTcpV4) {
+  TunVnetHeader header = {};
+  header.gso_type = kTunVnetGsoTcpV4;
+  header.gso_size = 100;
+  const std::string payload =
+      std::string(100, 'a') + std::string(100, 'b') + std::string(50, 'c');
+  std::string packet =
+      MakePacket(header, /*ipv6=*/false, IPPROTO_TCP, payload);
+  ASSERT_TRUE(Segment(&packet));
+  ASSERT_EQ(3u, segments_.size());
+
+  for (size_t i = 0; i < segments_.size(); ++i) {
+    absl::string_view segment = segments_[i];
+    const size_t payload_size = i < 2 ? 100 : 50;
+    ASSERT_EQ(40 + payload_size, segment.size());
+    EXPECT_EQ(segment.size(), ReadUint16(segment.data() + 2));
+    EXPECT_EQ(0x1234 + i, ReadUint16(segment.data() + 4));
+    EXPECT_EQ(0x10000000 + 100 * i, ReadUint32(segment.data() + 24));
+    EXPECT_EQ(payload.substr(100 * i, payload_size), segment.substr(40));
+    ExpectValidChecksums(segment);
+  }
+  // CWR is only kept on the first segment, FIN and PSH on the last one.
+  EXPECT_EQ(0x80 | 0x10, static_cast<uint8_t>(segments_[0][33]));
+  EXPECT_EQ(0x10, static_cast<uint8_t>(segments_[1][33]));
+  EXPECT_EQ(0x10 | 0x08 | 0x01, static_cast<uint8_t>(segments_[2][33]));
+}
+
+TEST_F(TunDeviceOffloadTest, SegmentsTcpV6) {
+  TunVnetHeader header = {};
+  header.gso_type = kTunVnetGsoTcpV6 | kTunVnetGsoEcn;
+  header.gso_size = 1000;
+  const std::string payload(2000, 'a');
+  std::string packet = MakePacket(header, /*ipv6=*/true, IPPROTO_TCP, payload);
+  ASSERT_TRUE(Segment(&packet));
+  ASSERT_EQ(2u, segments_.size());
+  for (absl::string_view segment : segments_) {
+    ASSERT_EQ(1060u, segment.size());
+    EXPECT_EQ(1020u, ReadUint16(segment.data() + 4));
+    ExpectValidChecksums(segment);
+  }
+}
+
+TEST_F(TunDeviceOffloadTest, SegmentsUdp) {
+  TunVnetHeader header = {};
+  header.gso_type = kTunVnetGsoUdpL4;
+  header.gso_size = 1200;
+  const std::string payload(3000, 'a');
+  std::string packet = MakePacket(header, /*ipv6=*/true, IPPROTO_UDP, payload);
+  ASSERT_TRUE(Segment(&packet));
+  ASSERT_EQ(3u, segments_.size());
+  const size_t payload_sizes[] = {1200, 1200, 600};
+  for (size_t i = 0; i < segments_.size(); ++i) {
+    absl::string_view segment = segments_[i];
+    ASSERT_EQ(48 + payload_sizes[i], segment.size());
+    EXPECT_EQ(8 + payload_sizes[i], ReadUint16(segment.data() + 44));
+    ExpectValidChecksums(segment);
+  }
+}
+
+TEST_F(TunDeviceOffloadTest, ReusesBuffer) {
+  TunVnetHeader header = {};
+  header.gso_type = kTunVnetGsoUdpL4;
+  header.gso_size = 100;
+  std::string packet =
+      MakePacket(header, /*ipv6=*/false, IPPROTO_UDP, std::string(300, 'a'));
+  std::string copy = packet;
+  ASSERT_TRUE(Segment(&packet));
+  const char* first_segment = segments_[0].data();
+  ASSERT_TRUE(Segment(&copy));
+  EXPECT_EQ(first_segment, segments_[0].data());
+}
+
+TEST_F(TunDeviceOffloadTest, RejectsMalformedPackets) {
+  std::string short_packet(kTunVnetHeaderSize - 1, '\0');
+  EXPECT_FALSE(Segment(&short_packet));
+
+  TunVnetHeader header = {};
+  header.gso_type = 3;  // VIRTIO_NET_HDR_GSO_UDP, i.e. UFO.
+  header.gso_size = 100;
+  std::string packet =
+      MakePacket(header, /*ipv6=*/false, IPPROTO_UDP, std::string(300, 'a'));
+  EXPECT_FALSE(Segment(&packet));
+
+  header.gso_type = kTunVnetGsoTcpV4;
+  packet =
+      MakePacket(header, /*ipv6=*/false, IPPROTO_UDP, std::string(300, 'a'));
+  EXPECT_FALSE(Segment(&packet));
+
+  header.gso_size = 0;
+  packet =
+      MakePacket(header, /*ipv6=*/false, IPPROTO_TCP, std::string(300, 'a'));
+  EXPECT_FALSE(Segment(&packet));
+
+  header = {};
+  header.flags = kTunVnetNeedsChecksum;
+  header.csum_start = 1000;
+  packet = MakePacket(header, /*ipv6=*/false, IPPROTO_UDP, "payload");
+  EXPECT_FALSE(Segment(&packet));
+}
+
+}  // namespace
+}  // namespace quic
@@ -7,6 +7,7 @@
 #include <utility>
 
 #include "absl/strings/str_cat.h"
+#include "quic/qbone/bonnet/tun_device_offload.h"
 
 namespace quic {
 
@@ -32,7 +33,19 @@ bool TunDevicePacketExchanger::WritePacket(const char* packet,
     return false;
   }
 
-  int result = kernel_->write(fd_, packet, size);
+  int result;
+  if (vnet_header_enabled_) {
+    // No offloads are requested for the packets written to the device.
+    TunVnetHeader header = {};
+    iovec iov[2] = {{&header, sizeof(header)},
+                    {const_cast<char*>(packet), size}};
+    result = kernel_->writev(fd_, iov, 2);
+    if (result > 0) {
+      result -= kTunVnetHeaderSize;
+    }
+  } else {
+    result = kernel_->write(fd_, packet, size);
+  }
   if (result == -1) {
     if (errno == EWOULDBLOCK || errno == EAGAIN) {
       // The tunnel is blocked. Note that this does not mean the receive buffer
@@ -53,6 +66,9 @@ std::unique_ptr<QuicData> TunDevicePacketExchanger::ReadPacket(
     bool* blocked,
     std::string* error) {
   *blocked = false;
+  if (next_segment_ < segments_.size()) {
+    return NextSegment();
+  }
   if (fd_ < 0) {
     *error = absl::StrCat("Invalid file descriptor of the TUN device: ", fd_);
     stats_->OnReadError(error);
@@ -60,8 +76,14 @@ std::unique_ptr<QuicData> TunDevicePacketExchanger::ReadPacket(
   }
   // Reading on a TUN device returns a packet at a time. If the packet is longer
   // than the buffer, it's truncated.
-  auto read_buffer = std::make_unique<char[]>(mtu_);
-  int result = kernel_->read(fd_, read_buffer.get(), mtu_);
+  const size_t read_size = vnet_header_enabled_
+                               ? kTunVnetHeaderSize + kTunMaxOffloadPacketSize
+                               : mtu_;
+  if (read_buffer_size_ != read_size) {
+    read_buffer_ = std::make_unique<char[]>(read_size);
+    read_buffer_size_ = read_size;
+  }
+  int result = kernel_->read(fd_, read_buffer_.get(), read_size);
   // Note that 0 means end of file, but we're talking about a TUN device - there
   // is no end of file. Therefore 0 also indicates error.
   if (result <= 0) {
@@ -72,14 +94,34 @@ std::unique_ptr<QuicData> TunDevicePacketExchanger::ReadPacket(
     }
     return nullptr;
   }
+  if (vnet_header_enabled_) {
+    if (!SegmentTunOffloadPacket(read_buffer_.get(), result, &segment_buffer_,
+                                 &segments_, error)) {
+      stats_->OnReadError(error);
+      return nullptr;
+    }
+    next_segment_ = 0;
+    return NextSegment();
+  }
   stats_->OnPacketRead(result);
-  return std::make_unique<QuicData>(read_buffer.release(), result, true);
+  return std::make_unique<QuicData>(read_buffer_.get(), result);
+}
+
+std::unique_ptr<QuicData> TunDevicePacketExchanger::NextSegment() {
+  absl::string_view segment = segments_[next_segment_++];
+  stats_->OnPacketRead(segment.size());
+  return std::make_unique<QuicData>(segment.data(), segment.size());
 }
 
 void TunDevicePacketExchanger::set_file_descriptor(int fd) {
   fd_ = fd;
 }
 
+void TunDevicePacketExchanger::set_vnet_header_enabled(
+    bool vnet_header_enabled) {
+  vnet_header_enabled_ = vnet_header_enabled;
+}
+
 const TunDevicePacketExchanger::StatsInterface*
 TunDevicePacketExchanger::stats_interface() const {
   return stats_;
@@ -5,6 +5,10 @@
 #ifndef QUICHE_QUIC_QBONE_BONNET_TUN_DEVICE_PACKET_EXCHANGER_H_
 #define QUICHE_QUIC_QBONE_BONNET_TUN_DEVICE_PACKET_EXCHANGER_H_
 
+#include <memory>
+#include <vector>
+
+#include "absl/strings/string_view.h"
 #include "quic/core/quic_packets.h"
 #include "quic/qbone/platform/kernel_interface.h"
 #include "quic/qbone/qbone_client_interface.h"
@@ -50,6 +54,12 @@ class TunDevicePacketExchanger : public QbonePacketExchanger {
 
   void set_file_descriptor(int fd);
 
+  // Enables the TunVnetHeader on packets read from and written to the TUN
+  // device, which must have been opened with IFF_VNET_HDR.  Packets the kernel
+  // offloaded to the device are then segmented into the IP packets they stand
+  // for, so that one read can deliver up to 64KB of TCP or UDP data.
+  void set_vnet_header_enabled(bool vnet_header_enabled);
+
   ABSL_MUST_USE_RESULT const StatsInterface* stats_interface() const;
 
  private:
@@ -63,9 +73,23 @@ class TunDevicePacketExchanger : public QbonePacketExchanger {
                    bool* blocked,
                    std::string* error) override;
 
+  // Returns the next of |segments_| and counts it as read.
+  std::unique_ptr<QuicData> NextSegment();
+
   int fd_ = -1;
   size_t mtu_;
   KernelInterface* kernel_;
+  bool vnet_header_enabled_ = false;
+
+  // Packets are read into this buffer, which is reused for every read since
+  // QbonePacketExchanger delivers each packet before reading the next one.
+  std::unique_ptr<char[]> read_buffer_;
+  size_t read_buffer_size_ = 0;
+  // The packets from the last read which remain to be delivered, and the
+  // buffer holding them if they were segmented.
+  std::vector<char> segment_buffer_;
+  std::vector<absl::string_view> segments_;
+  size_t next_segment_ = 0;
 
   StatsInterface* stats_;
 };
@@ -4,8 +4,12 @@
 
 #include "quic/qbone/bonnet/tun_device_packet_exchanger.h"
 
+#include <netinet/in.h>
+#include <sys/uio.h>
+
 #include "quic/platform/api/quic_test.h"
 #include "quic/qbone/bonnet/mock_packet_exchanger_stats_interface.h"
+#include "quic/qbone/bonnet/tun_device_offload.h"
 #include "quic/qbone/mock_qbone_client.h"
 #include "quic/qbone/platform/mock_kernel.h"
 
@@ -18,6 +22,7 @@ const int kFd = 15;
 
 using ::testing::_;
 using ::testing::Invoke;
+using ::testing::Return;
 using ::testing::StrEq;
 using ::testing::StrictMock;
 
@@ -117,5 +122,85 @@ TEST_F(TunDevicePacketExchangerTest,
   EXPECT_TRUE(exchanger_.ReadAndDeliverPacket(&mock_client_));
 }
 
+TEST_F(TunDevicePacketExchangerTest, ReadPacketReusesTheReadBuffer) {
+  std::string packet = "fake_packet";
+  void* first_buffer = nullptr;
+  EXPECT_CALL(mock_kernel_, read(kFd, _, kMtu))
+      .Times(2)
+      .WillRepeatedly(
+          Invoke([packet, &first_buffer](int fd, void* buf, size_t count) {
+            if (first_buffer == nullptr) {
+              first_buffer = buf;
+            }
+            EXPECT_EQ(first_buffer, buf);
+            memcpy(buf, packet.data(), packet.size());
+            return packet.size();
+          }));
+  EXPECT_CALL(mock_client_, ProcessPacketFromNetwork(StrEq(packet))).Times(2);
+  EXPECT_CALL(mock_stats_, OnPacketRead(_)).Times(2);
+  EXPECT_TRUE(exchanger_.ReadAndDeliverPacket(&mock_client_));
+  EXPECT_TRUE(exchanger_.ReadAndDeliverPacket(&mock_client_));
+}
+
+TEST_F(TunDevicePacketExchangerTest, ReadPacketSegmentsOffloadedPacket) {
+  exchanger_.set_vnet_header_enabled(true);
+  // A UDP over IPv6 packet with two 100 byte segments.
+  TunVnetHeader header = {};
+  header.gso_type = kTunVnetGsoUdpL4;
+  header.gso_size = 100;
+  std::string packet(kTunVnetHeaderSize + 48, '\0');
+  memcpy(&packet[0], &header, sizeof(header));
+  packet[kTunVnetHeaderSize] = 0x60;
+  packet[kTunVnetHeaderSize + 6] = IPPROTO_UDP;
+  packet += std::string(100, 'a') + std::string(100, 'b');
+
+  EXPECT_CALL(mock_kernel_,
+              read(kFd, _, kTunVnetHeaderSize + kTunMaxOffloadPacketSize))
+      .WillOnce(Invoke([packet](int fd, void* buf, size_t count) {
+        memcpy(buf, packet.data(), packet.size());
+        return packet.size();
+      }));
+  std::vector<std::string> segments;
+  EXPECT_CALL(mock_client_, ProcessPacketFromNetwork(_))
+      .Times(2)
+      .WillRepeatedly(Invoke([&segments](absl::string_view segment) {
+        segments.push_back(std::string(segment));
+      }));
+  EXPECT_CALL(mock_stats_, OnPacketRead(148)).Times(2);
+  // Both segments are delivered from a single read.
+  EXPECT_TRUE(exchanger_.ReadAndDeliverPacket(&mock_client_));
+  EXPECT_TRUE(exchanger_.ReadAndDeliverPacket(&mock_client_));
+  ASSERT_EQ(2u, segments.size());
+  EXPECT_EQ(std::string(100, 'a'), segments[0].substr(48));
+  EXPECT_EQ(std::string(100, 'b'), segments[1].substr(48));
+}
+
+TEST_F(TunDevicePacketExchangerTest, ReadPacketReturnsNullOnMalformedPacket) {
+  exchanger_.set_vnet_header_enabled(true);
+  EXPECT_CALL(mock_kernel_, read(kFd, _, _))
+      .WillOnce(Return(kTunVnetHeaderSize - 1));
+  EXPECT_CALL(mock_visitor_, OnReadError(_));
+  EXPECT_CALL(mock_stats_, OnReadError(_)).Times(1);
+  EXPECT_FALSE(exchanger_.ReadAndDeliverPacket(&mock_client_));
+}
+
+TEST_F(TunDevicePacketExchangerTest, WritePacketPrependsVnetHeader) {
+  exchanger_.set_vnet_header_enabled(true);
+  std::string packet = "fake packet";
+  EXPECT_CALL(mock_kernel_, writev(kFd, _, 2))
+      .WillOnce(Invoke([packet](int fd, const struct iovec* iov, int iovcnt) {
+        EXPECT_EQ(kTunVnetHeaderSize, iov[0].iov_len);
+        EXPECT_EQ(std::string(kTunVnetHeaderSize, '\0'),
+                  std::string(static_cast<const char*>(iov[0].iov_base),
+                              iov[0].iov_len));
+        EXPECT_EQ(packet,
+                  std::string(static_cast<const char*>(iov[1].iov_base),
+                              iov[1].iov_len));
+        return iov[0].iov_len + iov[1].iov_len;
+      }));
+  EXPECT_CALL(mock_stats_, OnPacketWritten(packet.size())).Times(1);
+  exchanger_.WritePacketToNetwork(packet.data(), packet.size());
+}
+
 }  // namespace
 }  // namespace quic
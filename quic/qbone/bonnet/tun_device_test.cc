@@ -9,6 +9,7 @@
 #include <sys/ioctl.h>
 
 #include "quic/platform/api/quic_test.h"
+#include "quic/qbone/bonnet/tun_device_offload.h"
 #include "quic/qbone/platform/mock_kernel.h"
 
 namespace quic {
@@ -207,5 +208,83 @@ TEST_F(TunDeviceTest, FailToUp) {
   EXPECT_FALSE(tun_device.Up());
 }
 
+TEST_F(TunDeviceTest, OpensQueues) {
+  SetInitExpectations(/* mtu = */ 1500, /* persist = */ false);
+  EXPECT_CALL(mock_kernel_, ioctl(_, TUNSETPERSIST, _)).Times(1);
+  TunDevice tun_device(kDeviceName, 1500, false, true, &mock_kernel_);
+  tun_device.set_num_queues(3);
+  EXPECT_TRUE(tun_device.Init());
+  std::vector<int> file_descriptors = tun_device.GetQueueFileDescriptors();
+  ASSERT_EQ(3u, file_descriptors.size());
+  EXPECT_EQ(tun_device.GetFileDescriptor(), file_descriptors[0]);
+
+  // Closing the device closes all the queues.
+  tun_device.CloseDevice();
+  EXPECT_TRUE(tun_device.GetQueueFileDescriptors().empty());
+  ExpectDown(false);
+}
+
+TEST_F(TunDeviceTest, FailToOpenQueue) {
+  SetInitExpectations(/* mtu = */ 1500, /* persist = */ false);
+  // The first queue is opened, but not the second one.
+  EXPECT_CALL(mock_kernel_, open(StrEq("/dev/net/tun"), _))
+      .WillOnce(Invoke([this](Unused, Unused) {
+        EXPECT_CALL(mock_kernel_, close(next_fd_)).WillOnce(Return(0));
+        return next_fd_++;
+      }))
+      .WillOnce(Return(-1));
+  TunDevice tun_device(kDeviceName, 1500, false, true, &mock_kernel_);
+  tun_device.set_num_queues(3);
+  EXPECT_FALSE(tun_device.Init());
+  EXPECT_TRUE(tun_device.GetQueueFileDescriptors().empty());
+  ExpectDown(false);
+}
+
+TEST_F(TunDeviceTest, EnablesOffloads) {
+  SetInitExpectations(/* mtu = */ 1500, /* persist = */ false);
+  EXPECT_CALL(mock_kernel_, ioctl(_, TUNGETFEATURES, _))
+      .WillOnce(Invoke([](Unused, Unused, void* argp) {
+        auto* actual_features = reinterpret_cast<int*>(argp);
+        *actual_features = kSupportedFeatures | IFF_VNET_HDR;
+        return 0;
+      }));
+  EXPECT_CALL(mock_kernel_, ioctl(_, TUNSETIFF, _))
+      .WillOnce(Invoke([](Unused, Unused, void* argp) {
+        auto* ifr = reinterpret_cast<struct ifreq*>(argp);
+        EXPECT_EQ(IFF_TUN | IFF_MULTI_QUEUE | IFF_NO_PI | IFF_VNET_HDR,
+                  ifr->ifr_flags);
+        return 0;
+      }));
+  EXPECT_CALL(mock_kernel_, ioctl(_, TUNSETVNETHDRSZ, _))
+      .WillOnce(Invoke([](Unused, Unused, void* argp) {
+        EXPECT_EQ(static_cast<int>(kTunVnetHeaderSize),
+                  *reinterpret_cast<int*>(argp));
+        return 0;
+      }));
+  // UDP segmentation offload isn't supported by the kernel.
+  const uintptr_t offloads =
+      TUN_F_CSUM | TUN_F_TSO4 | TUN_F_TSO6 | TUN_F_TSO_ECN;
+  EXPECT_CALL(mock_kernel_,
+              ioctl(_, TUNSETOFFLOAD,
+                    reinterpret_cast<void*>(offloads | 0x20 | 0x40)))
+      .WillOnce(Return(-1));
+  EXPECT_CALL(mock_kernel_,
+              ioctl(_, TUNSETOFFLOAD, reinterpret_cast<void*>(offloads)))
+      .WillOnce(Return(0));
+  TunDevice tun_device(kDeviceName, 1500, false, true, &mock_kernel_);
+  tun_device.set_vnet_header_enabled(true);
+  EXPECT_TRUE(tun_device.Init());
+  ExpectDown(false);
+}
+
+TEST_F(TunDeviceTest, VnetHeaderNotSupported) {
+  SetInitExpectations(/* mtu = */ 1500, /* persist = */ false);
+  TunDevice tun_device(kDeviceName, 1500, false, true, &mock_kernel_);
+  tun_device.set_vnet_header_enabled(true);
+  EXPECT_FALSE(tun_device.Init());
+  EXPECT_EQ(tun_device.GetFileDescriptor(), -1);
+  ExpectDown(false);
+}
+
 }  // namespace
 }  // namespace quic
@@ -6,6 +6,10 @@
 
 #include <netinet/ip6.h>
 
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+
 #include "absl/strings/string_view.h"
 #include "quic/qbone/platform/internet_checksum.h"
 #include "common/quiche_endian.h"
@@ -42,46 +46,60 @@ void CreateIcmpPacket(in6_addr src,
                       absl::string_view body,
                       const std::function<void(absl::string_view)>& cb) {
   const size_t body_size = std::min(body.size(), kICMPv6BodyMaxSize);
+  // Only the part of the packet that is used gets written, so there is no
+  // need to initialize it.
+  ICMPv6Packet icmp_packet;
+  memcpy(icmp_packet.body, body.data(), body_size);
+  cb(CreateIcmpPacketInPlace(src, dst, icmp_header,
+                             reinterpret_cast<char*>(&icmp_packet), body_size));
+}
+
+absl::string_view CreateIcmpPacketInPlace(in6_addr src,
+                                          in6_addr dst,
+                                          const icmp6_hdr& icmp_header,
+                                          char* buffer,
+                                          size_t body_size) {
+  body_size = std::min(body_size, kICMPv6BodyMaxSize);
   const size_t payload_size = kICMPv6HeaderSize + body_size;
 
-  ICMPv6Packet icmp_packet{};
+  ip6_hdr ip_header{};
   // Set version to 6.
-  icmp_packet.ip_header.ip6_vfc = 0x6 << 4;
+  ip_header.ip6_vfc = 0x6 << 4;
   // Set the payload size, protocol and TTL.
-  icmp_packet.ip_header.ip6_plen =
-      quiche::QuicheEndian::HostToNet16(payload_size);
-  icmp_packet.ip_header.ip6_nxt = IPPROTO_ICMPV6;
-  icmp_packet.ip_header.ip6_hops = kIcmpTtl;
+  ip_header.ip6_plen = quiche::QuicheEndian::HostToNet16(payload_size);
+  ip_header.ip6_nxt = IPPROTO_ICMPV6;
+  ip_header.ip6_hops = kIcmpTtl;
   // Set the source address to the specified self IP.
-  icmp_packet.ip_header.ip6_src = src;
-  icmp_packet.ip_header.ip6_dst = dst;
+  ip_header.ip6_src = src;
+  ip_header.ip6_dst = dst;
 
-  icmp_packet.icmp_header = icmp_header;
+  icmp6_hdr icmp_response_header = icmp_header;
   // Per RFC 4443 Section 2.3, set checksum field to 0 prior to computing it
-  icmp_packet.icmp_header.icmp6_cksum = 0;
+  icmp_response_header.icmp6_cksum = 0;
 
   IPv6PseudoHeader pseudo_header{};
   pseudo_header.payload_size = quiche::QuicheEndian::HostToNet32(payload_size);
 
   InternetChecksum checksum;
   // Pseudoheader.
-  checksum.Update(icmp_packet.ip_header.ip6_src.s6_addr, kIPv6AddressSize);
-  checksum.Update(icmp_packet.ip_header.ip6_dst.s6_addr, kIPv6AddressSize);
+  checksum.Update(ip_header.ip6_src.s6_addr, kIPv6AddressSize);
+  checksum.Update(ip_header.ip6_dst.s6_addr, kIPv6AddressSize);
   checksum.Update(reinterpret_cast<char*>(&pseudo_header),
                   sizeof(pseudo_header));
   // ICMP header.
-  checksum.Update(reinterpret_cast<const char*>(&icmp_packet.icmp_header),
-                  sizeof(icmp_packet.icmp_header));
+  checksum.Update(reinterpret_cast<const char*>(&icmp_response_header),
+                  sizeof(icmp_response_header));
   // Body.
-  checksum.Update(body.data(), body_size);
-  icmp_packet.icmp_header.icmp6_cksum = checksum.Value();
-
-  memcpy(icmp_packet.body, body.data(), body_size);
+  checksum.Update(buffer + offsetof(ICMPv6Packet, body), body_size);
+  icmp_response_header.icmp6_cksum = checksum.Value();
 
-  const char* packet = reinterpret_cast<char*>(&icmp_packet);
-  const size_t packet_size = offsetof(ICMPv6Packet, body) + body_size;
+  // |buffer| isn't necessarily aligned, so the headers are copied into it.
+  memcpy(buffer + offsetof(ICMPv6Packet, ip_header), &ip_header,
+         sizeof(ip_header));
+  memcpy(buffer + offsetof(ICMPv6Packet, icmp_header), &icmp_response_header,
+         sizeof(icmp_response_header));
 
-  cb(absl::string_view(packet, packet_size));
+  return absl::string_view(buffer, offsetof(ICMPv6Packet, body) + body_size);
 }
 
 }  // namespace quic
@@ -24,6 +24,16 @@ void CreateIcmpPacket(in6_addr src,
                       absl::string_view body,
                       const std::function<void(absl::string_view)>& cb);
 
+// Same as above, but builds the packet in place in |buffer|: the first
+// sizeof(ip6_hdr) + sizeof(icmp6_hdr) bytes of |buffer| are overwritten with
+// the headers, and the |body_size| bytes that follow them are the body, which
+// is truncated to fit into the minimum IPv6 MTU.  Returns the packet.
+absl::string_view CreateIcmpPacketInPlace(in6_addr src,
+                                          in6_addr dst,
+                                          const icmp6_hdr& icmp_header,
+                                          char* buffer,
+                                          size_t body_size);
+
 }  // namespace quic
 
 #endif  // QUICHE_QUIC_QBONE_PLATFORM_ICMP_PACKET_H_
@@ -7,6 +7,7 @@
 #include <netinet/ip6.h>
 
 #include <cstdint>
+#include <string>
 
 #include "absl/strings/string_view.h"
 #include "quic/platform/api/quic_test.h"
@@ -125,4 +126,32 @@ TEST(IcmpPacketTest, NonZeroChecksumIsIgnored) {
                    });
 }
 
+TEST(IcmpPacketTest, CreatesPacketInPlace) {
+  QuicIpAddress src;
+  ASSERT_TRUE(src.FromString(kReferenceSourceAddress));
+  in6_addr src_addr;
+  memcpy(src_addr.s6_addr, src.ToPackedString().data(), sizeof(in6_addr));
+
+  QuicIpAddress dst;
+  ASSERT_TRUE(dst.FromString(kReferenceDestinationAddress));
+  in6_addr dst_addr;
+  memcpy(dst_addr.s6_addr, dst.ToPackedString().data(), sizeof(in6_addr));
+
+  icmp6_hdr icmp_header{};
+  icmp_header.icmp6_type = ICMP6_ECHO_REQUEST;
+  icmp_header.icmp6_id = 0x82cb;
+  icmp_header.icmp6_seq = 0x0100;
+
+  // The body follows room for the headers, at an odd offset to make sure that
+  // the buffer doesn't need to be aligned.
+  std::string buffer(1 + sizeof(ip6_hdr) + sizeof(icmp6_hdr), '\0');
+  buffer.append(reinterpret_cast<const char*>(kReferenceICMPMessageBody), 56);
+  absl::string_view packet =
+      CreateIcmpPacketInPlace(src_addr, dst_addr, icmp_header, &buffer[1], 56);
+  EXPECT_EQ(&buffer[1], packet.data());
+  EXPECT_EQ(packet,
+            absl::string_view(
+                reinterpret_cast<const char*>(kReferenceICMPPacket), 104));
+}
+
 }  // namespace quic
@@ -4,15 +4,33 @@
 
 #include "quic/qbone/platform/internet_checksum.h"
 
+#include <cstring>
+
 namespace quic {
 
 void InternetChecksum::Update(const char* data, size_t size) {
-  const char* current;
-  for (current = data; current + 1 < data + size; current += 2) {
-    accumulator_ += *reinterpret_cast<const uint16_t*>(current);
+  // The one's complement sum doesn't depend on the width of the words that
+  // are added up, as long as the carries are folded back in, so the data is
+  // summed eight bytes at a time, in two four byte halves to leave room for
+  // the carries in the accumulator.
+  const char* current = data;
+  const char* const end = data + size;
+  for (; current + 8 <= end; current += 8) {
+    uint64_t word;
+    memcpy(&word, current, sizeof(word));
+    accumulator_ += (word & 0xffffffffu) + (word >> 32);
+  }
+  for (; current + 1 < end; current += 2) {
+    uint16_t word;
+    memcpy(&word, current, sizeof(word));
+    accumulator_ += word;
   }
-  if (current < data + size) {
-    accumulator_ += *reinterpret_cast<const uint8_t*>(current);
+  if (current < end) {
+    // The last odd byte is padded with a zero byte.
+    uint8_t padded[2] = {*reinterpret_cast<const uint8_t*>(current), 0};
+    uint16_t word;
+    memcpy(&word, padded, sizeof(word));
+    accumulator_ += word;
   }
 }
 
@@ -21,7 +39,20 @@ void InternetChecksum::Update(const uint8_t* data, size_t size) {
 }
 
 uint16_t InternetChecksum::Value() const {
-  uint32_t total = accumulator_;
+  uint64_t total = accumulator_;
+  while (total & ~uint64_t{0xffff}) {
+    total = (total >> 16u) + (total & 0xffffu);
+  }
+  return ~static_cast<uint16_t>(total);
+}
+
+// static
+uint16_t InternetChecksum::IncrementalUpdate(uint16_t checksum,
+                                             uint16_t old_word,
+                                             uint16_t new_word) {
+  // HC' = ~(~HC + ~m + m')
+  uint32_t total = static_cast<uint16_t>(~checksum) +
+                   static_cast<uint16_t>(~old_word) + new_word;
   while (total & 0xffff0000u) {
     total = (total >> 16u) + (total & 0xffffu);
   }
@@ -23,8 +23,18 @@ class InternetChecksum {
 
   uint16_t Value() const;
 
+  // Returns |checksum|, a value previously computed by Value(), updated for
+  // one of the two-byte words it covers changing from |old_word| to
+  // |new_word|, as described in RFC 1624 Section 3.  The words are in the
+  // byte order they have in the data, like the checksum itself.
+  static uint16_t IncrementalUpdate(uint16_t checksum,
+                                    uint16_t old_word,
+                                    uint16_t new_word);
+
  private:
-  uint32_t accumulator_ = 0;
+  // Sums the data in up to eight byte words, which are folded into two byte
+  // words by Value().  This can't overflow for less than 16GB of data.
+  uint64_t accumulator_ = 0;
 };
 
 }  // namespace quic
@@ -4,6 +4,9 @@
 
 #include "quic/qbone/platform/internet_checksum.h"
 
+#include <cstring>
+#include <string>
+
 #include "quic/platform/api/quic_test.h"
 
 namespace quic {
@@ -63,5 +66,72 @@ TEST(InternetChecksumTest, ChecksumRequiringMultipleCarriesInLittleEndian) {
   EXPECT_EQ(0xff, result_bytes[1]);
 }
 
+// Sums the data two bytes at a time, as described in RFC 1071.
+uint16_t ReferenceChecksum(const std::string& data) {
+  uint32_t sum = 0;
+  for (size_t i = 0; i < data.size(); i += 2) {
+    uint8_t word[2] = {static_cast<uint8_t>(data[i]),
+                       i + 1 < data.size() ? static_cast<uint8_t>(data[i + 1])
+                                           : uint8_t{0}};
+    uint16_t value;
+    memcpy(&value, word, sizeof(value));
+    sum += value;
+    sum = (sum >> 16) + (sum & 0xffff);
+  }
+  return ~static_cast<uint16_t>(sum);
+}
+
+TEST(InternetChecksumTest, MatchesReferenceForAllSizes) {
+  std::string data;
+  for (int i = 0; i < 300; ++i) {
+    data.push_back(static_cast<char>(0xff - i * 7));
+  }
+  for (size_t size = 0; size <= data.size(); ++size) {
+    const std::string prefix = data.substr(0, size);
+    InternetChecksum checksum;
+    checksum.Update(prefix.data(), prefix.size());
+    EXPECT_EQ(ReferenceChecksum(prefix), checksum.Value()) << size;
+  }
+}
+
+TEST(InternetChecksumTest, SplitUpdates) {
+  const std::string data(1499, '\xff');
+  InternetChecksum checksum;
+  // Every update but the last one covers an even number of bytes.
+  checksum.Update(data.data(), 6);
+  checksum.Update(data.data() + 6, 2);
+  checksum.Update(data.data() + 8, 1490);
+  checksum.Update(data.data() + 1498, 1);
+  EXPECT_EQ(ReferenceChecksum(data), checksum.Value());
+}
+
+TEST(InternetChecksumTest, LargeData) {
+  const std::string data(1 << 20, '\xff');
+  InternetChecksum checksum;
+  checksum.Update(data.data(), data.size());
+  EXPECT_EQ(ReferenceChecksum(data), checksum.Value());
+}
+
+TEST(InternetChecksumTest, IncrementalUpdate) {
+  uint8_t data[] = {0x45, 0x00, 0x00, 0x54, 0x12, 0x34, 0x40, 0x00,
+                    0x40, 0x01, 0x00, 0x00, 0x0a, 0x00, 0x00, 0x01,
+                    0x0a, 0x00, 0x00, 0x02};
+  InternetChecksum checksum;
+  checksum.Update(data, sizeof(data));
+  const uint16_t original = checksum.Value();
+
+  // Decrement the TTL, which shares a word with the protocol.
+  uint16_t old_word;
+  memcpy(&old_word, data + 8, sizeof(old_word));
+  data[8]--;
+  uint16_t new_word;
+  memcpy(&new_word, data + 8, sizeof(new_word));
+
+  InternetChecksum updated;
+  updated.Update(data, sizeof(data));
+  EXPECT_EQ(updated.Value(),
+            InternetChecksum::IncrementalUpdate(original, old_word, new_word));
+}
+
 }  // namespace
 }  // namespace quic
@@ -46,6 +46,10 @@ class MockKernel : public KernelInterface {
               (int, int, int, const void*, socklen_t),
               (override));
   MOCK_METHOD(ssize_t, write, (int fd, const void*, size_t count), (override));
+  MOCK_METHOD(ssize_t,
+              writev,
+              (int fd, const struct iovec*, int iovcnt),
+              (override));
 };
 
 }  // namespace quic
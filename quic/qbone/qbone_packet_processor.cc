@@ -61,6 +61,12 @@ QbonePacketProcessor::Filter::FilterPacket(Direction direction,
 
 void QbonePacketProcessor::ProcessPacket(std::string* packet,
                                          Direction direction) {
+  ProcessPacket(absl::MakeSpan(*packet), /*headroom=*/0, direction);
+}
+
+void QbonePacketProcessor::ProcessPacket(absl::Span<char> packet,
+                                         size_t headroom,
+                                         Direction direction) {
   if (QUIC_PREDICT_FALSE(!IsValid())) {
     QUIC_BUG(quic_bug_11024_1)
         << "QuicPacketProcessor is invoked in an invalid state.";
@@ -75,14 +81,15 @@ void QbonePacketProcessor::ProcessPacket(std::string* packet,
   ProcessingResult result = ProcessIPv6HeaderAndFilter(
       packet, direction, &transport_protocol, &transport_data, &icmp_header);
 
+  const absl::string_view packet_view(packet.data(), packet.size());
   switch (result) {
     case ProcessingResult::OK:
       switch (direction) {
         case Direction::FROM_OFF_NETWORK:
-          output_->SendPacketToNetwork(*packet);
+          output_->SendPacketToNetwork(packet_view);
           break;
         case Direction::FROM_NETWORK:
-          output_->SendPacketToClient(*packet);
+          output_->SendPacketToClient(packet_view);
           break;
       }
       stats_->OnPacketForwarded(direction);
@@ -94,24 +101,26 @@ void QbonePacketProcessor::ProcessPacket(std::string* packet,
       stats_->OnPacketDeferred(direction);
       break;
     case ProcessingResult::ICMP:
-      SendIcmpResponse(&icmp_header, *packet, direction);
+      SendIcmpResponse(&icmp_header, packet, headroom, direction);
       stats_->OnPacketDroppedWithIcmp(direction);
       break;
     case ProcessingResult::ICMP_AND_TCP_RESET:
-      SendIcmpResponse(&icmp_header, *packet, direction);
+      // The ICMP response is built in front of the packet, which stays intact
+      // for the TCP reset.
+      SendIcmpResponse(&icmp_header, packet, headroom, direction);
       stats_->OnPacketDroppedWithIcmp(direction);
-      SendTcpReset(*packet, direction);
+      SendTcpReset(packet_view, direction);
       stats_->OnPacketDroppedWithTcpReset(direction);
       break;
     case ProcessingResult::TCP_RESET:
-      SendTcpReset(*packet, direction);
+      SendTcpReset(packet_view, direction);
       stats_->OnPacketDroppedWithTcpReset(direction);
       break;
   }
 }
 
 QbonePacketProcessor::ProcessingResult
-QbonePacketProcessor::ProcessIPv6HeaderAndFilter(std::string* packet,
+QbonePacketProcessor::ProcessIPv6HeaderAndFilter(absl::Span<char> packet,
                                                  Direction direction,
                                                  uint8_t* transport_protocol,
                                                  char** transport_data,
@@ -120,10 +129,10 @@ QbonePacketProcessor::ProcessIPv6HeaderAndFilter(std::string* packet,
       packet, direction, transport_protocol, transport_data, icmp_header);
 
   if (result == ProcessingResult::OK) {
-    char* packet_data = &*packet->begin();
+    char* packet_data = packet.data();
     size_t header_size = *transport_data - packet_data;
     // Sanity-check the bounds.
-    if (packet_data >= *transport_data || header_size > packet->size() ||
+    if (packet_data >= *transport_data || header_size > packet.size() ||
         header_size < kIPv6HeaderSize) {
       QUIC_BUG(quic_bug_11024_2)
           << "Invalid pointers encountered in "
@@ -132,21 +141,21 @@ QbonePacketProcessor::ProcessIPv6HeaderAndFilter(std::string* packet,
     }
 
     result = filter_->FilterPacket(
-        direction, *packet,
-        absl::string_view(*transport_data, packet->size() - header_size),
+        direction, absl::string_view(packet_data, packet.size()),
+        absl::string_view(*transport_data, packet.size() - header_size),
         icmp_header, output_);
   }
 
   // Do not send ICMP error messages in response to ICMP errors.
   if (result == ProcessingResult::ICMP) {
-    const uint8_t* header = reinterpret_cast<const uint8_t*>(packet->data());
+    const uint8_t* header = reinterpret_cast<const uint8_t*>(packet.data());
 
     constexpr size_t kIPv6NextHeaderOffset = 6;
     constexpr size_t kIcmpMessageTypeOffset = kIPv6HeaderSize + 0;
     constexpr size_t kIcmpMessageTypeMaxError = 127;
     if (
         // Check size.
-        packet->size() >= (kIPv6HeaderSize + kICMPv6HeaderSize) &&
+        packet.size() >= (kIPv6HeaderSize + kICMPv6HeaderSize) &&
         // Check that the packet is in fact ICMP.
         header[kIPv6NextHeaderOffset] == IPPROTO_ICMPV6 &&
         // Check that ICMP message type is an error.
@@ -159,19 +168,19 @@ QbonePacketProcessor::ProcessIPv6HeaderAndFilter(std::string* packet,
 }
 
 QbonePacketProcessor::ProcessingResult QbonePacketProcessor::ProcessIPv6Header(
-    std::string* packet,
+    absl::Span<char> packet,
     Direction direction,
     uint8_t* transport_protocol,
     char** transport_data,
     icmp6_hdr* icmp_header) {
   // Check if the packet is big enough to have IPv6 header.
-  if (packet->size() < kIPv6HeaderSize) {
+  if (packet.size() < kIPv6HeaderSize) {
     QUIC_DVLOG(1) << "Dropped malformed packet: IPv6 header too short";
     return ProcessingResult::SILENT_DROP;
   }
 
   // Check version field.
-  ip6_hdr* header = reinterpret_cast<ip6_hdr*>(&*packet->begin());
+  ip6_hdr* header = reinterpret_cast<ip6_hdr*>(packet.data());
   if (header->ip6_vfc >> 4 != 6) {
     QUIC_DVLOG(1) << "Dropped malformed packet: IP version is not IPv6";
     return ProcessingResult::SILENT_DROP;
@@ -180,7 +189,7 @@ QbonePacketProcessor::ProcessingResult QbonePacketProcessor::ProcessIPv6Header(
   // Check payload size.
   const size_t declared_payload_size =
       quiche::QuicheEndian::NetToHost16(header->ip6_plen);
-  const size_t actual_payload_size = packet->size() - kIPv6HeaderSize;
+  const size_t actual_payload_size = packet.size() - kIPv6HeaderSize;
   if (declared_payload_size != actual_payload_size) {
     QUIC_DVLOG(1)
         << "Dropped malformed packet: incorrect packet length specified";
@@ -230,7 +239,7 @@ QbonePacketProcessor::ProcessingResult QbonePacketProcessor::ProcessIPv6Header(
     case IPPROTO_UDP:
     case IPPROTO_ICMPV6:
       *transport_protocol = header->ip6_nxt;
-      *transport_data = (&*packet->begin()) + kIPv6HeaderSize;
+      *transport_data = packet.data() + kIPv6HeaderSize;
       break;
     default:
       icmp_header->icmp6_type = ICMP6_PARAM_PROB;
@@ -242,13 +251,24 @@ QbonePacketProcessor::ProcessingResult QbonePacketProcessor::ProcessIPv6Header(
 }
 
 void QbonePacketProcessor::SendIcmpResponse(icmp6_hdr* icmp_header,
-                                            absl::string_view original_packet,
+                                            absl::Span<char> original_packet,
+                                            size_t headroom,
                                             Direction original_direction) {
   in6_addr dst;
   // TODO(b/70339814): ensure this is actually a unicast address.
   memcpy(dst.s6_addr, &original_packet[8], kIPv6AddressSize);
 
-  CreateIcmpPacket(self_ip_, dst, *icmp_header, original_packet,
+  if (headroom >= kTotalICMPv6HeaderSize) {
+    SendResponse(original_direction,
+                 CreateIcmpPacketInPlace(
+                     self_ip_, dst, *icmp_header,
+                     original_packet.data() - kTotalICMPv6HeaderSize,
+                     original_packet.size()));
+    return;
+  }
+  CreateIcmpPacket(self_ip_, dst, *icmp_header,
+                   absl::string_view(original_packet.data(),
+                                     original_packet.size()),
                    [this, original_direction](absl::string_view packet) {
                      SendResponse(original_direction, packet);
                    });
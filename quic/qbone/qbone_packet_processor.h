@@ -9,6 +9,7 @@
 #include <netinet/ip6.h>
 
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "quic/core/quic_types.h"
 #include "quic/platform/api/quic_ip_address.h"
 
@@ -145,6 +146,14 @@ class QbonePacketProcessor {
   // modified in the process, by having the TTL field decreased.
   void ProcessPacket(std::string* packet, Direction direction);
 
+  // Same as above, but processes |packet| in place, so that the caller can
+  // keep it in a buffer of its own.  If at least kTotalICMPv6HeaderSize bytes
+  // of |headroom| in front of |packet| are writable, ICMP responses are built
+  // there, in front of the packet they quote, instead of into a copy of it.
+  void ProcessPacket(absl::Span<char> packet,
+                     size_t headroom,
+                     Direction direction);
+
   void set_filter(std::unique_ptr<Filter> filter) {
     filter_ = std::move(filter);
   }
@@ -160,14 +169,17 @@ class QbonePacketProcessor {
   // Processes the header and returns what should be done with the packet.
   // After that, calls an external packet filter if registered.  TTL of the
   // packet may be decreased in the process.
-  ProcessingResult ProcessIPv6HeaderAndFilter(std::string* packet,
+  ProcessingResult ProcessIPv6HeaderAndFilter(absl::Span<char> packet,
                                               Direction direction,
                                               uint8_t* transport_protocol,
                                               char** transport_data,
                                               icmp6_hdr* icmp_header);
 
+  // Builds the response in the |headroom| in front of |original_packet| if
+  // there is enough of it.
   void SendIcmpResponse(icmp6_hdr* icmp_header,
-                        absl::string_view original_packet,
+                        absl::Span<char> original_packet,
+                        size_t headroom,
                         Direction original_direction);
 
   void SendTcpReset(absl::string_view original_packet,
@@ -188,7 +200,7 @@ class QbonePacketProcessor {
  private:
   // Performs basic sanity and permission checks on the packet, and decreases
   // the TTL.
-  ProcessingResult ProcessIPv6Header(std::string* packet,
+  ProcessingResult ProcessIPv6Header(absl::Span<char> packet,
                                      Direction direction,
                                      uint8_t* transport_protocol,
                                      char** transport_data,
@@ -283,5 +283,57 @@ TEST_F(QbonePacketProcessorTest, FilterHelperFunctions) {
   ASSERT_EQ(1, filter->called());
 }
 
+TEST_F(QbonePacketProcessorTest, ProcessesPacketInPlace) {
+  std::string buffer(kReferenceClientPacket);
+  const char* packet_data = buffer.data();
+  EXPECT_CALL(stats_, OnPacketForwarded(Direction::FROM_OFF_NETWORK));
+  EXPECT_CALL(output_, SendPacketToNetwork(_))
+      .WillOnce([packet_data](absl::string_view packet) {
+        EXPECT_EQ(packet_data, packet.data());
+        // The hop limit is decremented in place.
+        EXPECT_EQ(49, packet[7]);
+      });
+  processor_->ProcessPacket(absl::MakeSpan(buffer), /*headroom=*/0,
+                            Direction::FROM_OFF_NETWORK);
+}
+
+TEST_F(QbonePacketProcessorTest, BuildsIcmpResponseInHeadroom) {
+  std::string buffer = std::string(kTotalICMPv6HeaderSize, '\0');
+  buffer.append(std::string(kReferenceNetworkPacket));
+  const char* buffer_data = buffer.data();
+  EXPECT_CALL(stats_, OnPacketDroppedWithIcmp(Direction::FROM_OFF_NETWORK));
+  EXPECT_CALL(output_, SendPacketToClient(IsIcmpMessage(ICMP6_DST_UNREACH)))
+      .WillOnce([buffer_data](absl::string_view packet) {
+        EXPECT_EQ(buffer_data, packet.data());
+        EXPECT_EQ(kReferenceNetworkPacket,
+                  packet.substr(kTotalICMPv6HeaderSize));
+      });
+  processor_->ProcessPacket(
+      absl::MakeSpan(&buffer[kTotalICMPv6HeaderSize],
+                     kReferenceNetworkPacket.size()),
+      kTotalICMPv6HeaderSize, Direction::FROM_OFF_NETWORK);
+}
+
+TEST_F(QbonePacketProcessorTest, IcmpResponseMatchesWithAndWithoutHeadroom) {
+  std::string packet(kReferenceNetworkPacket);
+  packet[7] = 1;
+  std::string copied_response;
+  EXPECT_CALL(stats_, OnPacketDroppedWithIcmp(Direction::FROM_NETWORK))
+      .Times(2);
+  EXPECT_CALL(output_, SendPacketToNetwork(IsIcmpMessage(ICMP6_TIME_EXCEEDED)))
+      .WillOnce([&copied_response](absl::string_view response) {
+        copied_response = std::string(response);
+      })
+      .WillOnce([&copied_response](absl::string_view response) {
+        EXPECT_EQ(copied_response, response);
+      });
+  SendPacketFromNetwork(packet);
+
+  std::string buffer = std::string(kTotalICMPv6HeaderSize, '\0') + packet;
+  processor_->ProcessPacket(
+      absl::MakeSpan(&buffer[kTotalICMPv6HeaderSize], packet.size()),
+      kTotalICMPv6HeaderSize, Direction::FROM_NETWORK);
+}
+
 }  // namespace
 }  // namespace quic
@@ -4,6 +4,7 @@
 
 #include "quic/qbone/qbone_server_session.h"
 
+#include <cstring>
 #include <utility>
 
 #include "absl/strings/string_view.h"
@@ -74,15 +75,27 @@ bool QboneServerSession::SendClientRequest(const QboneClientRequest& request) {
 }
 
 void QboneServerSession::ProcessPacketFromNetwork(absl::string_view packet) {
-  std::string buffer = std::string(packet);
-  processor_.ProcessPacket(&buffer,
-                           QbonePacketProcessor::Direction::FROM_NETWORK);
+  ProcessPacketInBuffer(packet, QbonePacketProcessor::Direction::FROM_NETWORK);
 }
 
 void QboneServerSession::ProcessPacketFromPeer(absl::string_view packet) {
-  std::string buffer = std::string(packet);
-  processor_.ProcessPacket(&buffer,
-                           QbonePacketProcessor::Direction::FROM_OFF_NETWORK);
+  ProcessPacketInBuffer(packet,
+                        QbonePacketProcessor::Direction::FROM_OFF_NETWORK);
+}
+
+void QboneServerSession::ProcessPacketInBuffer(
+    absl::string_view packet,
+    QbonePacketProcessor::Direction direction) {
+  // The processor hands its output over synchronously, and none of it comes
+  // back to the processor, so the buffer is free again once it returns.
+  const size_t buffer_size = kTotalICMPv6HeaderSize + packet.size();
+  if (packet_buffer_.size() < buffer_size) {
+    packet_buffer_.resize(buffer_size);
+  }
+  char* packet_data = packet_buffer_.data() + kTotalICMPv6HeaderSize;
+  memcpy(packet_data, packet.data(), packet.size());
+  processor_.ProcessPacket(absl::MakeSpan(packet_data, packet.size()),
+                           kTotalICMPv6HeaderSize, direction);
 }
 
 void QboneServerSession::SendPacketToClient(absl::string_view packet) {
@@ -5,6 +5,8 @@
 #ifndef QUICHE_QUIC_QBONE_QBONE_SERVER_SESSION_H_
 #define QUICHE_QUIC_QBONE_QBONE_SERVER_SESSION_H_
 
+#include <vector>
+
 #include "absl/strings/string_view.h"
 #include "quic/core/quic_crypto_server_stream_base.h"
 #include "quic/core/quic_crypto_stream.h"
@@ -77,6 +79,10 @@ class QUIC_EXPORT_PRIVATE QboneServerSession
   QbonePacketProcessor processor_;
 
  private:
+  // Copies |packet| into |packet_buffer_| and processes it there.
+  void ProcessPacketInBuffer(absl::string_view packet,
+                             QbonePacketProcessor::Direction direction);
+
   // Config for QUIC crypto server stream, used by the server.
   const QuicCryptoServerConfig* quic_crypto_server_config_;
   // Used by QUIC crypto server stream to track most recently compressed certs.
@@ -87,6 +93,9 @@ class QUIC_EXPORT_PRIVATE QboneServerSession
   QboneServerControlStream::Handler* handler_;
   // The unowned control stream.
   QboneServerControlStream* control_stream_;
+  // Reused for every packet handed to |processor_|, with room for the headers
+  // of an ICMP response in front of the packet.
+  std::vector<char> packet_buffer_;
 };
 
 }  // namespace quic
@@ -0,0 +1,129 @@
+// Copyright (c) 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Benchmarks for static table lookups, as done by the HPACK and QPACK encoders
+// for every header field, with HpackStaticIndex and with the hash maps it
+// replaced.
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/hash/hash.h"
+#include "absl/strings/string_view.h"
+#include "benchmark/benchmark.h"
+#include "quic/core/qpack/qpack_static_table.h"
+#include "quic/test_tools/benchmarks/quic_benchmark_allocation_counter.h"
+#include "spdy/core/hpack/hpack_constants.h"
+#include "spdy/core/hpack/hpack_static_index.h"
+#include "spdy/core/hpack/hpack_static_table.h"
+
+namespace quic {
+namespace test {
+namespace {
+
+using Header = std::pair<std::string, std::string>;
+
+// Header fields of a typical request and response, of which some are in the
+// static table, some only have their name in it and some are not in it.
+std::vector<Header> MakeHeaders() {
+  return {{":method", "GET"},
+          {":scheme", "https"},
+          {":path", "/index.html"},
+          {":authority", "www.example.com"},
+          {"accept", "*/*"},
+          {"accept-encoding", "gzip, deflate, br"},
+          {"user-agent", "Mozilla/5.0"},
+          {"cookie", "id=1234"},
+          {":status", "200"},
+          {"content-type", "text/html; charset=utf-8"},
+          {"cache-control", "private"},
+          {"x-request-id", "5f0c7b2a"}};
+}
+
+void LookUpHeaders(benchmark::State& state,
+                   const spdy::HpackStaticIndex& index) {
+  const std::vector<Header> headers = MakeHeaders();
+
+  QuicBenchmarkAllocationReporter reporter(&state);
+  for (auto _ : state) {
+    for (const Header& header : headers) {
+      size_t result = index.LookupNameAndValue(header.first, header.second);
+      if (result == spdy::HpackStaticIndex::kNotFound) {
+        result = index.LookupName(header.first);
+      }
+      benchmark::DoNotOptimize(result);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * headers.size());
+}
+
+// The maps HpackStaticTable used to build from the static entries.
+class StaticTableMaps {
+ public:
+  explicit StaticTableMaps(const std::vector<QpackStaticEntry>& entries) {
+    for (size_t i = 0; i < entries.size(); ++i) {
+      const absl::string_view name(entries[i].name, entries[i].name_len);
+      const absl::string_view value(entries[i].value, entries[i].value_len);
+      name_value_index_.insert({{name, value}, i});
+      name_index_.insert({name, i});
+    }
+  }
+
+  size_t Lookup(absl::string_view name, absl::string_view value) const {
+    auto name_value_it = name_value_index_.find(std::make_pair(name, value));
+    if (name_value_it != name_value_index_.end()) {
+      return name_value_it->second;
+    }
+    auto name_it = name_index_.find(name);
+    if (name_it != name_index_.end()) {
+      return name_it->second;
+    }
+    return spdy::HpackStaticIndex::kNotFound;
+  }
+
+ private:
+  absl::flat_hash_map<std::pair<absl::string_view, absl::string_view>, size_t>
+      name_value_index_;
+  absl::flat_hash_map<absl::string_view, size_t> name_index_;
+};
+
+void LookUpHeaders(benchmark::State& state, const StaticTableMaps& maps) {
+  const std::vector<Header> headers = MakeHeaders();
+
+  QuicBenchmarkAllocationReporter reporter(&state);
+  for (auto _ : state) {
+    for (const Header& header : headers) {
+      benchmark::DoNotOptimize(maps.Lookup(header.first, header.second));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * headers.size());
+}
+
+void BM_HpackStaticIndex(benchmark::State& state) {
+  LookUpHeaders(state, spdy::ObtainHpackStaticTable().GetStaticIndex());
+}
+BENCHMARK(BM_HpackStaticIndex);
+
+void BM_HpackStaticTableMaps(benchmark::State& state) {
+  const StaticTableMaps maps(spdy::HpackStaticTableVector());
+  LookUpHeaders(state, maps);
+}
+BENCHMARK(BM_HpackStaticTableMaps);
+
+void BM_QpackStaticIndex(benchmark::State& state) {
+  LookUpHeaders(state, ObtainQpackStaticTable().GetStaticIndex());
+}
+BENCHMARK(BM_QpackStaticIndex);
+
+void BM_QpackStaticTableMaps(benchmark::State& state) {
+  const StaticTableMaps maps(QpackStaticTableVector());
+  LookUpHeaders(state, maps);
+}
+BENCHMARK(BM_QpackStaticTableMaps);
+
+}  // namespace
+}  // namespace test
+}  // namespace quic
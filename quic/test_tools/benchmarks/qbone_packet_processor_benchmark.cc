@@ -0,0 +1,140 @@
+// Copyright (c) 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Benchmarks for QbonePacketProcessor::ProcessPacket and InternetChecksum.
+
+#include <netinet/in.h>
+
+#include <cstring>
+#include <memory>
+#include <string>
+
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "benchmark/benchmark.h"
+#include "quic/platform/api/quic_ip_address.h"
+#include "quic/qbone/platform/internet_checksum.h"
+#include "quic/qbone/qbone_packet_processor.h"
+#include "quic/test_tools/benchmarks/quic_benchmark_allocation_counter.h"
+
+namespace quic {
+namespace test {
+namespace {
+
+using Direction = QbonePacketProcessor::Direction;
+
+// Size of the UDP packets sent by the client.
+const size_t kPacketSize = 1280;
+
+class DiscardingOutput : public QbonePacketProcessor::OutputInterface,
+                         public QbonePacketProcessor::StatsInterface {
+ public:
+  void SendPacketToClient(absl::string_view packet) override {
+    benchmark::DoNotOptimize(packet.data());
+  }
+  void SendPacketToNetwork(absl::string_view packet) override {
+    benchmark::DoNotOptimize(packet.data());
+  }
+
+  void OnPacketForwarded(Direction /*direction*/) override {}
+  void OnPacketDroppedSilently(Direction /*direction*/) override {}
+  void OnPacketDroppedWithIcmp(Direction /*direction*/) override {}
+  void OnPacketDroppedWithTcpReset(Direction /*direction*/) override {}
+  void OnPacketDeferred(Direction /*direction*/) override {}
+};
+
+// Returns a UDP packet of kPacketSize bytes from fd00:0:0:1::1, the client,
+// to fd00:0:0:5::1, with the given hop limit.
+std::string MakeClientPacket(uint8_t hop_limit) {
+  std::string packet(kPacketSize, '\0');
+  packet[0] = 0x60;
+  const size_t payload_size = kPacketSize - kIPv6HeaderSize;
+  packet[4] = static_cast<char>(payload_size >> 8);
+  packet[5] = static_cast<char>(payload_size & 0xff);
+  packet[6] = IPPROTO_UDP;
+  packet[7] = static_cast<char>(hop_limit);
+  packet[8] = packet[24] = static_cast<char>(0xfd);
+  packet[15] = 1;
+  packet[23] = 1;
+  packet[31] = 5;
+  packet[39] = 1;
+  return packet;
+}
+
+class ProcessorFixture {
+ public:
+  ProcessorFixture() {
+    QuicIpAddress self_ip;
+    QuicIpAddress client_ip;
+    self_ip.FromString("fd00:0:0:4::1");
+    client_ip.FromString("fd00:0:0:1::1");
+    processor_ = std::make_unique<QbonePacketProcessor>(
+        self_ip, client_ip, /*client_ip_subnet_length=*/62, &output_,
+        &output_);
+  }
+
+  QbonePacketProcessor* processor() { return processor_.get(); }
+
+ private:
+  DiscardingOutput output_;
+  std::unique_ptr<QbonePacketProcessor> processor_;
+};
+
+// Processes a packet from the client with the given hop limit, which is
+// forwarded if it's larger than one and answered with an ICMP message
+// otherwise.  If state.range(0) is non-zero, the packet is processed in place
+// in a reused buffer with headroom for ICMP responses, otherwise it's copied
+// into a new string for every packet first.  The "pps" counter reports the
+// processed packets per second.
+void ProcessPacket(benchmark::State& state, uint8_t hop_limit) {
+  ProcessorFixture fixture;
+  const std::string packet = MakeClientPacket(hop_limit);
+  std::string buffer(kTotalICMPv6HeaderSize + packet.size(), '\0');
+  char* packet_data = &buffer[kTotalICMPv6HeaderSize];
+  const bool in_place = state.range(0) != 0;
+
+  QuicBenchmarkAllocationReporter reporter(&state);
+  for (auto _ : state) {
+    if (in_place) {
+      memcpy(packet_data, packet.data(), packet.size());
+      fixture.processor()->ProcessPacket(
+          absl::MakeSpan(packet_data, packet.size()), kTotalICMPv6HeaderSize,
+          Direction::FROM_OFF_NETWORK);
+    } else {
+      std::string copy(packet);
+      fixture.processor()->ProcessPacket(&copy, Direction::FROM_OFF_NETWORK);
+    }
+  }
+  state.counters["pps"] = benchmark::Counter(
+      static_cast<double>(state.iterations()), benchmark::Counter::kIsRate);
+  state.SetBytesProcessed(state.iterations() * packet.size());
+}
+
+void BM_ForwardPacket(benchmark::State& state) {
+  ProcessPacket(state, /*hop_limit=*/64);
+}
+BENCHMARK(BM_ForwardPacket)->Arg(0)->Arg(1);
+
+void BM_RejectPacketWithIcmp(benchmark::State& state) {
+  ProcessPacket(state, /*hop_limit=*/1);
+}
+BENCHMARK(BM_RejectPacketWithIcmp)->Arg(0)->Arg(1);
+
+// Computes the checksum of state.range(0) bytes.
+void BM_InternetChecksum(benchmark::State& state) {
+  const std::string data(state.range(0), 'a');
+
+  QuicBenchmarkAllocationReporter reporter(&state);
+  for (auto _ : state) {
+    InternetChecksum checksum;
+    checksum.Update(data.data(), data.size());
+    benchmark::DoNotOptimize(checksum.Value());
+  }
+  state.SetBytesProcessed(state.iterations() * data.size());
+}
+BENCHMARK(BM_InternetChecksum)->Arg(40)->Arg(1280)->Arg(65535);
+
+}  // namespace
+}  // namespace test
+}  // namespace quic
@@ -0,0 +1,117 @@
+// Copyright (c) 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Benchmarks for the AEAD encrypters and decrypters used by IETF QUIC.
+
+#include <string>
+
+#include "absl/strings/string_view.h"
+#include "benchmark/benchmark.h"
+#include "quic/core/crypto/aes_128_gcm_decrypter.h"
+#include "quic/core/crypto/aes_128_gcm_encrypter.h"
+#include "quic/core/crypto/aes_256_gcm_decrypter.h"
+#include "quic/core/crypto/aes_256_gcm_encrypter.h"
+#include "quic/core/crypto/chacha20_poly1305_tls_decrypter.h"
+#include "quic/core/crypto/chacha20_poly1305_tls_encrypter.h"
+#include "quic/core/crypto/quic_crypter.h"
+#include "quic/core/quic_constants.h"
+#include "quic/test_tools/benchmarks/quic_benchmark_allocation_counter.h"
+
+namespace quic {
+namespace test {
+namespace {
+
+// Associated data of the size of a short header with an 8-byte connection ID
+// and a 4-byte packet number.
+const size_t kAssociatedDataLength = 13;
+
+void InitializeCrypter(QuicCrypter* crypter) {
+  crypter->SetKey(std::string(crypter->GetKeySize(), 'k'));
+  crypter->SetIV(std::string(crypter->GetIVSize(), 'i'));
+  crypter->SetHeaderProtectionKey(std::string(crypter->GetKeySize(), 'h'));
+}
+
+// Encrypts a state.range(0) byte payload per iteration.
+template <class Encrypter>
+void BM_EncryptPacket(benchmark::State& state) {
+  Encrypter encrypter;
+  InitializeCrypter(&encrypter);
+  const std::string associated_data(kAssociatedDataLength, 'a');
+  const std::string plaintext(state.range(0), 'p');
+  char output[kMaxOutgoingPacketSize];
+  size_t output_length;
+  uint64_t packet_number = 0;
+
+  QuicBenchmarkAllocationReporter reporter(&state);
+  for (auto _ : state) {
+    encrypter.EncryptPacket(++packet_number, associated_data, plaintext,
+                            output, &output_length, sizeof(output));
+    benchmark::DoNotOptimize(output);
+  }
+  state.SetBytesProcessed(state.iterations() * plaintext.size());
+}
+
+// Decrypts a state.range(0) byte payload per iteration.
+template <class Encrypter, class Decrypter>
+void BM_DecryptPacket(benchmark::State& state) {
+  Encrypter encrypter;
+  InitializeCrypter(&encrypter);
+  Decrypter decrypter;
+  InitializeCrypter(&decrypter);
+  const std::string associated_data(kAssociatedDataLength, 'a');
+  const std::string plaintext(state.range(0), 'p');
+  char ciphertext[kMaxOutgoingPacketSize];
+  size_t ciphertext_length;
+  encrypter.EncryptPacket(1, associated_data, plaintext, ciphertext,
+                          &ciphertext_length, sizeof(ciphertext));
+  char output[kMaxOutgoingPacketSize];
+  size_t output_length;
+
+  QuicBenchmarkAllocationReporter reporter(&state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(decrypter.DecryptPacket(
+        1, associated_data, absl::string_view(ciphertext, ciphertext_length),
+        output, &output_length, sizeof(output)));
+  }
+  state.SetBytesProcessed(state.iterations() * plaintext.size());
+}
+
+// Generates a header protection mask per iteration.
+template <class Encrypter>
+void BM_GenerateHeaderProtectionMask(benchmark::State& state) {
+  Encrypter encrypter;
+  InitializeCrypter(&encrypter);
+  const std::string sample(16, 's');
+
+  QuicBenchmarkAllocationReporter reporter(&state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(encrypter.GenerateHeaderProtectionMask(sample));
+  }
+}
+
+BENCHMARK_TEMPLATE(BM_EncryptPacket, Aes128GcmEncrypter)->Arg(64)->Arg(1350);
+BENCHMARK_TEMPLATE(BM_EncryptPacket, Aes256GcmEncrypter)->Arg(64)->Arg(1350);
+BENCHMARK_TEMPLATE(BM_EncryptPacket, ChaCha20Poly1305TlsEncrypter)
+    ->Arg(64)
+    ->Arg(1350);
+
+BENCHMARK_TEMPLATE(BM_DecryptPacket, Aes128GcmEncrypter, Aes128GcmDecrypter)
+    ->Arg(64)
+    ->Arg(1350);
+BENCHMARK_TEMPLATE(BM_DecryptPacket, Aes256GcmEncrypter, Aes256GcmDecrypter)
+    ->Arg(64)
+    ->Arg(1350);
+BENCHMARK_TEMPLATE(BM_DecryptPacket,
+                   ChaCha20Poly1305TlsEncrypter,
+                   ChaCha20Poly1305TlsDecrypter)
+    ->Arg(64)
+    ->Arg(1350);
+
+BENCHMARK_TEMPLATE(BM_GenerateHeaderProtectionMask, Aes128GcmEncrypter);
+BENCHMARK_TEMPLATE(BM_GenerateHeaderProtectionMask,
+                   ChaCha20Poly1305TlsEncrypter);
+
+}  // namespace
+}  // namespace test
+}  // namespace quic
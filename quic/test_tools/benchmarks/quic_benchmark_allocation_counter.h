@@ -0,0 +1,55 @@
+// Copyright (c) 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef QUICHE_QUIC_TEST_TOOLS_BENCHMARKS_QUIC_BENCHMARK_ALLOCATION_COUNTER_H_
+#define QUICHE_QUIC_TEST_TOOLS_BENCHMARKS_QUIC_BENCHMARK_ALLOCATION_COUNTER_H_
+
+#include <cstdint>
+
+#include "benchmark/benchmark.h"
+
+namespace quic {
+namespace test {
+
+// Returns the number of calls to the global operator new made by this process
+// so far.  The count is maintained by replacements of the global operator new
+// and operator delete in quic_benchmark_allocation_counter.cc, so that file
+// must only be linked into benchmark binaries.
+uint64_t GetBenchmarkAllocationCount();
+
+// Reports the number of heap allocations per iteration of a benchmark as the
+// "allocs/op" counter.  Create it right before the benchmark loop; the count
+// is reported when it goes out of scope, e.g.
+//
+//   void BM_Foo(benchmark::State& state) {
+//     Foo foo;
+//     QuicBenchmarkAllocationReporter reporter(&state);
+//     for (auto _ : state) {
+//       foo.Bar();
+//     }
+//   }
+class QuicBenchmarkAllocationReporter {
+ public:
+  explicit QuicBenchmarkAllocationReporter(benchmark::State* state)
+      : state_(state), start_count_(GetBenchmarkAllocationCount()) {}
+  QuicBenchmarkAllocationReporter(const QuicBenchmarkAllocationReporter&) =
+      delete;
+  QuicBenchmarkAllocationReporter& operator=(
+      const QuicBenchmarkAllocationReporter&) = delete;
+
+  ~QuicBenchmarkAllocationReporter() {
+    state_->counters["allocs/op"] = benchmark::Counter(
+        static_cast<double>(GetBenchmarkAllocationCount() - start_count_),
+        benchmark::Counter::kAvgIterations);
+  }
+
+ private:
+  benchmark::State* state_;
+  const uint64_t start_count_;
+};
+
+}  // namespace test
+}  // namespace quic
+
+#endif  // QUICHE_QUIC_TEST_TOOLS_BENCHMARKS_QUIC_BENCHMARK_ALLOCATION_COUNTER_H_
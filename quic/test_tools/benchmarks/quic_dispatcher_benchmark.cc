@@ -0,0 +1,132 @@
+// Copyright (c) 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Benchmarks for the per-packet work QuicDispatcher does to find the session
+// of a short header packet: parsing the public header and looking up the
+// destination connection ID in the session map.
+
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "benchmark/benchmark.h"
+#include "quic/core/crypto/quic_random.h"
+#include "quic/core/quic_connection_id.h"
+#include "quic/core/quic_constants.h"
+#include "quic/core/quic_dispatcher.h"
+#include "quic/core/quic_framer.h"
+#include "quic/core/quic_packets.h"
+#include "quic/core/quic_time.h"
+#include "quic/core/quic_utils.h"
+#include "quic/platform/api/quic_socket_address.h"
+#include "quic/test_tools/benchmarks/quic_benchmark_allocation_counter.h"
+
+namespace quic {
+namespace test {
+namespace {
+
+// Number of distinct packets the benchmarks cycle through, which are sent to
+// sessions picked at random so that lookups don't hit the same cache lines.
+const size_t kNumPackets = 4096;
+// Size of the short header packets.
+const size_t kPacketSize = 1350;
+
+// A session map with |num_sessions| random connection IDs, and short header
+// packets for some of them.  The sessions themselves are null, only the map is
+// needed.
+class SessionMapFixture {
+ public:
+  explicit SessionMapFixture(size_t num_sessions) {
+    QuicRandom* random = QuicRandom::GetInstance();
+    std::vector<QuicConnectionId> connection_ids;
+    connection_ids.reserve(num_sessions);
+    session_map_.reserve(num_sessions);
+    for (size_t i = 0; i < num_sessions; ++i) {
+      connection_ids.push_back(QuicUtils::CreateRandomConnectionId(random));
+      session_map_.emplace(connection_ids.back(), nullptr);
+    }
+    for (size_t i = 0; i < kNumPackets; ++i) {
+      const QuicConnectionId& connection_id =
+          connection_ids[random->RandUint64() % num_sessions];
+      std::string packet(kPacketSize, '\0');
+      // Short header with a 4 byte packet number.
+      packet[0] = 0x43;
+      memcpy(&packet[1], connection_id.data(), connection_id.length());
+      packet_data_.push_back(std::move(packet));
+    }
+    for (const std::string& data : packet_data_) {
+      packets_.push_back(std::make_unique<QuicReceivedPacket>(
+          data.data(), data.size(), QuicTime::Zero()));
+    }
+  }
+
+  const QuicDispatcher::ReferenceCountedSessionMap& session_map() const {
+    return session_map_;
+  }
+  const QuicReceivedPacket& packet(size_t i) const {
+    return *packets_[i % kNumPackets];
+  }
+
+ private:
+  QuicDispatcher::ReferenceCountedSessionMap session_map_;
+  std::vector<std::string> packet_data_;
+  std::vector<std::unique_ptr<QuicReceivedPacket>> packets_;
+};
+
+// Finds the session of short header packets among state.range(1) sessions.
+// If state.range(0) is non-zero, the destination connection ID is read with
+// QuicFramer::ParseShortHeaderDestinationConnectionId(), as the dispatcher's
+// fast path does, otherwise the whole public header is parsed into a
+// ReceivedPacketInfo with QuicFramer::ParsePublicHeaderDispatcher().  Reports
+// the time per packet, and the lookups per second as the "pps" counter.
+void BM_FindSession(benchmark::State& state) {
+  const bool fast_path = state.range(0) != 0;
+  SessionMapFixture fixture(state.range(1));
+  const QuicSocketAddress self_address(QuicIpAddress::Loopback6(), 443);
+  const QuicSocketAddress peer_address(QuicIpAddress::Loopback6(), 12345);
+  size_t i = 0;
+  size_t found = 0;
+
+  QuicBenchmarkAllocationReporter reporter(&state);
+  for (auto _ : state) {
+    const QuicReceivedPacket& packet = fixture.packet(i++);
+    if (fast_path) {
+      QuicConnectionId connection_id;
+      if (QuicFramer::ParseShortHeaderDestinationConnectionId(
+              packet, kQuicDefaultConnectionIdLength, &connection_id)) {
+        found += fixture.session_map().count(connection_id);
+      }
+    } else {
+      ReceivedPacketInfo packet_info(self_address, peer_address, packet);
+      std::string detailed_error;
+      bool retry_token_present;
+      absl::string_view retry_token;
+      const QuicErrorCode error = QuicFramer::ParsePublicHeaderDispatcher(
+          packet, kQuicDefaultConnectionIdLength, &packet_info.form,
+          &packet_info.long_packet_type, &packet_info.version_flag,
+          &packet_info.use_length_prefix, &packet_info.version_label,
+          &packet_info.version, &packet_info.destination_connection_id,
+          &packet_info.source_connection_id, &retry_token_present,
+          &retry_token, &detailed_error);
+      if (error == QUIC_NO_ERROR) {
+        found += fixture.session_map().count(
+            packet_info.destination_connection_id);
+      }
+    }
+  }
+  if (found != static_cast<size_t>(state.iterations())) {
+    state.SkipWithError("Failed to find the session of a packet");
+  }
+  state.counters["pps"] = benchmark::Counter(
+      static_cast<double>(state.iterations()), benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_FindSession)
+    ->ArgsProduct({{0, 1}, {1000, 1000000}})
+    ->ArgNames({"fast_path", "sessions"});
+
+}  // namespace
+}  // namespace test
+}  // namespace quic
@@ -0,0 +1,148 @@
+// Copyright (c) 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Benchmarks for QuicFramer::ProcessPacket and QuicFramer::BuildDataPacket.
+
+#include <memory>
+#include <string>
+
+#include "benchmark/benchmark.h"
+#include "quic/core/crypto/null_decrypter.h"
+#include "quic/core/crypto/null_encrypter.h"
+#include "quic/core/quic_constants.h"
+#include "quic/core/quic_framer.h"
+#include "quic/core/quic_packets.h"
+#include "quic/core/quic_time.h"
+#include "quic/core/quic_utils.h"
+#include "quic/core/quic_versions.h"
+#include "quic/test_tools/benchmarks/quic_benchmark_allocation_counter.h"
+#include "quic/test_tools/quic_test_utils.h"
+
+namespace quic {
+namespace test {
+namespace {
+
+// Size of the stream data in a full-sized 1-RTT packet.
+const size_t kStreamDataLength = 1300;
+
+// A client framer which serializes 1-RTT packets and a server framer which
+// parses them, both using null encryption.
+class FramerPair {
+ public:
+  FramerPair()
+      : version_(ParsedQuicVersion::RFCv1()),
+        client_framer_({version_}, QuicTime::Zero(), Perspective::IS_CLIENT,
+                       kQuicDefaultConnectionIdLength),
+        server_framer_({version_}, QuicTime::Zero(), Perspective::IS_SERVER,
+                       kQuicDefaultConnectionIdLength) {
+    client_framer_.SetEncrypter(
+        ENCRYPTION_FORWARD_SECURE,
+        std::make_unique<NullEncrypter>(Perspective::IS_CLIENT));
+    server_framer_.InstallDecrypter(
+        ENCRYPTION_FORWARD_SECURE,
+        std::make_unique<NullDecrypter>(Perspective::IS_SERVER));
+    server_framer_.set_visitor(&visitor_);
+    header_.destination_connection_id = TestConnectionId();
+    header_.packet_number_length = PACKET_4BYTE_PACKET_NUMBER;
+    header_.packet_number = QuicPacketNumber(1);
+  }
+
+  // Serializes and encrypts |frames| into |buffer|, returning the length of
+  // the encrypted packet.
+  size_t SerializePacket(const QuicFrames& frames, char* buffer) {
+    char plaintext[kMaxOutgoingPacketSize];
+    const size_t length = client_framer_.BuildDataPacket(
+        header_, frames, plaintext, kMaxOutgoingPacketSize,
+        ENCRYPTION_FORWARD_SECURE);
+    QuicPacket packet(version_.transport_version, plaintext, length,
+                      /*owns_buffer=*/false, header_);
+    return client_framer_.EncryptPayload(ENCRYPTION_FORWARD_SECURE,
+                                         header_.packet_number, packet, buffer,
+                                         kMaxOutgoingPacketSize);
+  }
+
+  QuicStreamId stream_id() const {
+    return QuicUtils::GetFirstBidirectionalStreamId(version_.transport_version,
+                                                    Perspective::IS_CLIENT);
+  }
+
+  QuicFramer* server_framer() { return &server_framer_; }
+
+ private:
+  const ParsedQuicVersion version_;
+  QuicFramer client_framer_;
+  QuicFramer server_framer_;
+  NoOpFramerVisitor visitor_;
+  QuicPacketHeader header_;
+};
+
+// Parses a full-sized packet carrying a single STREAM frame.
+void BM_ProcessStreamPacket(benchmark::State& state) {
+  FramerPair framers;
+  const std::string data(kStreamDataLength, 'a');
+  QuicFrames frames = {
+      QuicFrame(QuicStreamFrame(framers.stream_id(), false, 0, data))};
+  char buffer[kMaxOutgoingPacketSize];
+  const size_t length = framers.SerializePacket(frames, buffer);
+  const QuicEncryptedPacket packet(buffer, length);
+
+  QuicBenchmarkAllocationReporter reporter(&state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(framers.server_framer()->ProcessPacket(packet));
+  }
+  state.SetBytesProcessed(state.iterations() * length);
+}
+BENCHMARK(BM_ProcessStreamPacket);
+
+// Parses a packet carrying an ACK frame with state.range(0) ack ranges.
+void BM_ProcessAckPacket(benchmark::State& state) {
+  FramerPair framers;
+  QuicAckFrame ack_frame = MakeAckFrameWithAckBlocks(state.range(0), 0);
+  ack_frame.ack_delay_time = QuicTime::Delta::FromMilliseconds(1);
+  QuicFrames frames = {QuicFrame(&ack_frame)};
+  char buffer[kMaxOutgoingPacketSize];
+  const size_t length = framers.SerializePacket(frames, buffer);
+  const QuicEncryptedPacket packet(buffer, length);
+
+  QuicBenchmarkAllocationReporter reporter(&state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(framers.server_framer()->ProcessPacket(packet));
+  }
+}
+BENCHMARK(BM_ProcessAckPacket)->Arg(1)->Arg(32)->Arg(256);
+
+// Serializes and encrypts a full-sized packet carrying a single STREAM frame.
+void BM_BuildStreamPacket(benchmark::State& state) {
+  FramerPair framers;
+  const std::string data(kStreamDataLength, 'a');
+  QuicFrames frames = {
+      QuicFrame(QuicStreamFrame(framers.stream_id(), false, 0, data))};
+  char buffer[kMaxOutgoingPacketSize];
+
+  QuicBenchmarkAllocationReporter reporter(&state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(framers.SerializePacket(frames, buffer));
+  }
+}
+BENCHMARK(BM_BuildStreamPacket);
+
+// Serializes and encrypts a packet carrying an ACK frame with state.range(0)
+// ack ranges.
+void BM_BuildAckPacket(benchmark::State& state) {
+  FramerPair framers;
+  QuicAckFrame ack_frame = MakeAckFrameWithAckBlocks(state.range(0), 0);
+  ack_frame.ack_delay_time = QuicTime::Delta::FromMilliseconds(1);
+  QuicFrames frames = {QuicFrame(&ack_frame)};
+  char buffer[kMaxOutgoingPacketSize];
+
+  QuicBenchmarkAllocationReporter reporter(&state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(framers.SerializePacket(frames, buffer));
+  }
+}
+BENCHMARK(BM_BuildAckPacket)->Arg(1)->Arg(32)->Arg(256);
+
+}  // namespace
+}  // namespace test
+}  // namespace quic
@@ -0,0 +1,157 @@
+// Copyright (c) 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Benchmarks for the per-event cost of connection instrumentation, latency
+// histograms and qlog event recording, and for the cost of qlog tracing on
+// whole connections with tracing off, sampled and on.
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "benchmark/benchmark.h"
+#include "quic/core/quic_bandwidth.h"
+#include "quic/core/quic_latency_histogram.h"
+#include "quic/core/quic_qlog_visitor.h"
+#include "quic/core/quic_qlog_writer.h"
+#include "quic/core/quic_time.h"
+#include "quic/test_tools/benchmarks/quic_benchmark_allocation_counter.h"
+#include "quic/test_tools/quic_test_utils.h"
+#include "quic/test_tools/simulator/link.h"
+#include "quic/test_tools/simulator/quic_endpoint.h"
+#include "quic/test_tools/simulator/simulator.h"
+
+namespace quic {
+namespace test {
+namespace {
+
+void BM_LatencyHistogramAdd(benchmark::State& state) {
+  QuicLatencyHistogram histogram;
+  int64_t sample_us = 0;
+
+  QuicBenchmarkAllocationReporter reporter(&state);
+  for (auto _ : state) {
+    histogram.Add(QuicTime::Delta::FromMicroseconds(sample_us));
+    sample_us = (sample_us + 997) % 1000000;
+  }
+  benchmark::DoNotOptimize(histogram.total_count());
+}
+BENCHMARK(BM_LatencyHistogramAdd);
+
+// Records an event into a qlog ring, draining the ring whenever it fills up
+// as the writer thread would.
+void BM_QlogRecordEvent(benchmark::State& state) {
+  QuicQlogEventRing ring(1024);
+  QuicQlogEvent event;
+  event.type = QuicQlogEventType::kPacketSent;
+  event.packet_length = 1350;
+  std::vector<QuicQlogEvent> batch;
+  batch.reserve(ring.capacity());
+
+  QuicBenchmarkAllocationReporter reporter(&state);
+  for (auto _ : state) {
+    ++event.packet_number;
+    if (!ring.TryPush(event)) {
+      batch.clear();
+      ring.PopBatch(ring.capacity(), &batch);
+      ring.TryPush(event);
+    }
+  }
+}
+BENCHMARK(BM_QlogRecordEvent);
+
+// Serializes a qlog event, as done on the writer thread.
+void BM_QlogSerializeEvent(benchmark::State& state) {
+  QuicQlogEvent event;
+  event.type = QuicQlogEventType::kPacketSent;
+  event.packet_length = 1350;
+  event.connection_tag = 0x0123456789abcdef;
+  std::string output;
+
+  QuicBenchmarkAllocationReporter reporter(&state);
+  for (auto _ : state) {
+    output.clear();
+    ++event.packet_number;
+    QuicQlogWriter::SerializeEvent(event, &output);
+    benchmark::DoNotOptimize(output.data());
+  }
+}
+BENCHMARK(BM_QlogSerializeEvent);
+
+const QuicByteCount kTransferSize = 1024 * 1024;
+
+class DiscardingQlogSink : public QuicQlogSink {
+ public:
+  void Write(absl::string_view records) override {
+    benchmark::DoNotOptimize(records.data());
+  }
+};
+
+// Transfers kTransferSize bytes over a new simulated connection per iteration,
+// tracing state.range(0) percent of the connections with QuicQlogVisitor while
+// a QuicQlogWriter drains and serializes the events on its own thread.  0 is
+// tracing off and 100 is tracing on.  Reports the packets sent per second as
+// the "pps" counter.
+void BM_QlogConnectionOverhead(benchmark::State& state) {
+  DiscardingQlogSink sink;
+  QuicQlogWriter::Options options;
+  options.sampling_rate = state.range(0) / 100.0;
+  options.ring_capacity = 64 * 1024;
+  options.drain_interval = QuicTime::Delta::FromMilliseconds(10);
+  QuicQlogWriter writer(options, &sink);
+  QuicQlogEventRing* ring = writer.CreateRing();
+  writer.Start();
+  SimpleRandom random;
+  uint64_t packets_sent = 0;
+  uint64_t connections_traced = 0;
+
+  QuicBenchmarkAllocationReporter reporter(&state);
+  for (auto _ : state) {
+    simulator::Simulator simulator;
+    simulator::QuicEndpoint sender(&simulator, "Sender", "Receiver",
+                                   Perspective::IS_CLIENT,
+                                   TestConnectionId(42));
+    simulator::QuicEndpoint receiver(&simulator, "Receiver", "Sender",
+                                     Perspective::IS_SERVER,
+                                     TestConnectionId(42));
+    simulator::SymmetricLink link(&sender, &receiver,
+                                  QuicBandwidth::FromKBitsPerSecond(100 * 1000),
+                                  QuicTime::Delta::FromMilliseconds(10));
+    std::unique_ptr<QuicQlogVisitor> visitor;
+    if (writer.ShouldSampleConnection(&random)) {
+      visitor = std::make_unique<QuicQlogVisitor>(
+          sender.connection(), ring, options.max_events_per_connection);
+      sender.connection()->set_debug_visitor(visitor.get());
+      ++connections_traced;
+    }
+
+    sender.AddBytesToTransfer(kTransferSize);
+    simulator.RunUntilOrTimeout(
+        [&receiver]() { return receiver.bytes_received() >= kTransferSize; },
+        QuicTime::Delta::FromSeconds(10));
+    if (receiver.bytes_received() < kTransferSize) {
+      state.SkipWithError("Transfer did not complete");
+      break;
+    }
+    packets_sent += sender.connection()->GetStats().packets_sent;
+    sender.connection()->set_debug_visitor(nullptr);
+  }
+  writer.Stop();
+  state.counters["pps"] =
+      benchmark::Counter(packets_sent, benchmark::Counter::kIsRate);
+  state.counters["traced"] = benchmark::Counter(
+      connections_traced, benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_QlogConnectionOverhead)
+    ->Arg(0)
+    ->Arg(1)
+    ->Arg(100)
+    ->ArgName("sampling_pct")
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace
+}  // namespace test
+}  // namespace quic
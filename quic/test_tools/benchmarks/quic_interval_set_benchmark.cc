@@ -0,0 +1,87 @@
+// Copyright (c) 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Benchmarks for QuicIntervalSet operations, as used to track received packet
+// numbers and acked stream data.
+
+#include <cstdint>
+
+#include "benchmark/benchmark.h"
+#include "quic/core/quic_interval_set.h"
+#include "quic/test_tools/benchmarks/quic_benchmark_allocation_counter.h"
+
+namespace quic {
+namespace test {
+namespace {
+
+// Returns a set of |num_intervals| disjoint intervals [2i, 2i + 1).
+QuicIntervalSet<uint64_t> MakeSetWithGaps(int num_intervals) {
+  QuicIntervalSet<uint64_t> set;
+  for (int i = 0; i < num_intervals; ++i) {
+    set.AddOptimizedForAppend(2 * i, 2 * i + 1);
+  }
+  return set;
+}
+
+// Appends adjacent intervals, which coalesce into a single interval.
+void BM_AddAdjacent(benchmark::State& state) {
+  QuicIntervalSet<uint64_t> set;
+  uint64_t next = 0;
+
+  QuicBenchmarkAllocationReporter reporter(&state);
+  for (auto _ : state) {
+    set.Add(next, next + 1);
+    ++next;
+  }
+  benchmark::DoNotOptimize(set.Size());
+}
+BENCHMARK(BM_AddAdjacent);
+
+// Same as above, using AddOptimizedForAppend().
+void BM_AddOptimizedForAppend(benchmark::State& state) {
+  QuicIntervalSet<uint64_t> set;
+  uint64_t next = 0;
+
+  QuicBenchmarkAllocationReporter reporter(&state);
+  for (auto _ : state) {
+    set.AddOptimizedForAppend(next, next + 1);
+    ++next;
+  }
+  benchmark::DoNotOptimize(set.Size());
+}
+BENCHMARK(BM_AddOptimizedForAppend);
+
+// Fills a gap in the middle of a set with state.range(0) intervals, then
+// restores the gap.
+void BM_FillGap(benchmark::State& state) {
+  const int num_intervals = state.range(0);
+  QuicIntervalSet<uint64_t> set = MakeSetWithGaps(num_intervals);
+  const uint64_t gap = num_intervals | 1;
+
+  QuicBenchmarkAllocationReporter reporter(&state);
+  for (auto _ : state) {
+    set.Add(gap, gap + 1);
+    set.Difference(gap, gap + 1);
+  }
+  benchmark::DoNotOptimize(set.Size());
+}
+BENCHMARK(BM_FillGap)->Arg(1)->Arg(32)->Arg(256);
+
+// Looks up values in a set with state.range(0) intervals.
+void BM_Contains(benchmark::State& state) {
+  const int num_intervals = state.range(0);
+  const QuicIntervalSet<uint64_t> set = MakeSetWithGaps(num_intervals);
+  uint64_t value = 0;
+
+  QuicBenchmarkAllocationReporter reporter(&state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(set.Contains(value));
+    value = (value + 7) % (2 * num_intervals);
+  }
+}
+BENCHMARK(BM_Contains)->Arg(1)->Arg(32)->Arg(256);
+
+}  // namespace
+}  // namespace test
+}  // namespace quic
@@ -0,0 +1,112 @@
+// Copyright (c) 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Benchmarks for initializing QuicMemoryCacheBackend from a cache directory,
+// with the cache files read into memory or memory mapped.
+
+#include <malloc.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+#include "quic/test_tools/benchmarks/quic_benchmark_allocation_counter.h"
+#include "quic/tools/quic_memory_cache_backend.h"
+
+namespace quic {
+namespace test {
+namespace {
+
+const int kNumFiles = 64;
+const size_t kBodySize = 1024 * 1024;
+
+// Returns the number of bytes allocated on the heap.
+size_t HeapBytesInUse() {
+  struct mallinfo2 info = mallinfo2();
+  return info.uordblks + info.hblkhd;
+}
+
+// A cache directory with kNumFiles responses of kBodySize bytes each, which is
+// deleted when the benchmark completes.
+class CacheDirectory {
+ public:
+  CacheDirectory() {
+    const char* tmp_dir = getenv("TEST_TMPDIR");
+    std::string directory_template =
+        std::string(tmp_dir != nullptr ? tmp_dir : "/tmp") +
+        "/quic_memory_cache_backend_benchmark.XXXXXX";
+    if (mkdtemp(&directory_template[0]) == nullptr) {
+      return;
+    }
+    directory_ = directory_template;
+    const std::string host_directory =
+        absl::StrCat(directory_, "/www.example.com");
+    mkdir(host_directory.c_str(), 0700);
+    const std::string contents = absl::StrCat(
+        "HTTP/1.1 200 OK\r\nContent-Length: ", kBodySize,
+        "\r\nContent-Type: application/octet-stream\r\n\r\n",
+        std::string(kBodySize, 'a'));
+    for (int i = 0; i < kNumFiles; ++i) {
+      files_.push_back(absl::StrCat(host_directory, "/", i));
+      FILE* file = fopen(files_.back().c_str(), "w");
+      fwrite(contents.data(), 1, contents.size(), file);
+      fclose(file);
+    }
+    files_.push_back(host_directory);
+  }
+
+  ~CacheDirectory() {
+    for (const std::string& file : files_) {
+      remove(file.c_str());
+    }
+    if (!directory_.empty()) {
+      rmdir(directory_.c_str());
+    }
+  }
+
+  const std::string& directory() const { return directory_; }
+
+ private:
+  std::string directory_;
+  // The files and subdirectories of |directory_|, in deletion order.
+  std::vector<std::string> files_;
+};
+
+// Initializes a QuicMemoryCacheBackend from kNumFiles files of kBodySize bytes
+// each.  If state.range(0) is non-zero, the files are memory mapped.  Reports
+// the heap memory held by an initialized backend as the "heap_MB" counter.
+void BM_InitializeBackend(benchmark::State& state) {
+  CacheDirectory cache_directory;
+  if (cache_directory.directory().empty()) {
+    state.SkipWithError("Failed to create the cache directory");
+    return;
+  }
+  {
+    const size_t heap_before = HeapBytesInUse();
+    QuicMemoryCacheBackend backend;
+    backend.set_map_cache_files(state.range(0) != 0);
+    backend.InitializeBackend(cache_directory.directory());
+    state.counters["heap_MB"] =
+        (static_cast<double>(HeapBytesInUse()) - heap_before) / (1024 * 1024);
+  }
+
+  QuicBenchmarkAllocationReporter reporter(&state);
+  for (auto _ : state) {
+    QuicMemoryCacheBackend backend;
+    backend.set_map_cache_files(state.range(0) != 0);
+    backend.InitializeBackend(cache_directory.directory());
+    benchmark::DoNotOptimize(backend.GetResponse("www.example.com", "/0"));
+  }
+  state.SetBytesProcessed(state.iterations() * kNumFiles * kBodySize);
+}
+BENCHMARK(BM_InitializeBackend)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+
+}  // namespace
+}  // namespace test
+}  // namespace quic
@@ -0,0 +1,136 @@
+// Copyright (c) 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Benchmarks for serializing stream data with QuicPacketCreator.
+
+#include <memory>
+#include <string>
+
+#include "benchmark/benchmark.h"
+#include "quic/core/crypto/null_encrypter.h"
+#include "quic/core/quic_constants.h"
+#include "quic/core/quic_data_writer.h"
+#include "quic/core/quic_framer.h"
+#include "quic/core/quic_packet_creator.h"
+#include "quic/core/quic_packets.h"
+#include "quic/core/quic_stream_frame_data_producer.h"
+#include "quic/core/quic_time.h"
+#include "quic/core/quic_utils.h"
+#include "quic/core/quic_versions.h"
+#include "quic/platform/api/quic_logging.h"
+#include "quic/test_tools/benchmarks/quic_benchmark_allocation_counter.h"
+#include "quic/test_tools/quic_test_utils.h"
+
+namespace quic {
+namespace test {
+namespace {
+
+// Drops serialized packets on the floor.
+class DiscardingDelegate : public QuicPacketCreator::DelegateInterface {
+ public:
+  QuicPacketBuffer GetPacketBuffer() override { return {nullptr, nullptr}; }
+  void OnSerializedPacket(SerializedPacket serialized_packet) override {
+    bytes_serialized_ += serialized_packet.encrypted_length;
+  }
+  void OnUnrecoverableError(QuicErrorCode /*error*/,
+                            const std::string& error_details) override {
+    QUIC_LOG(FATAL) << "Unrecoverable error: " << error_details;
+  }
+  bool ShouldGeneratePacket(HasRetransmittableData /*retransmittable*/,
+                            IsHandshake /*handshake*/) override {
+    return true;
+  }
+  const QuicFrames MaybeBundleAckOpportunistically() override {
+    return QuicFrames();
+  }
+  SerializedPacketFate GetSerializedPacketFate(
+      bool /*is_mtu_discovery*/,
+      EncryptionLevel /*encryption_level*/) override {
+    return SEND_TO_WRITER;
+  }
+
+  QuicByteCount bytes_serialized() const { return bytes_serialized_; }
+
+ private:
+  QuicByteCount bytes_serialized_ = 0;
+};
+
+// Provides an endless stream of constant bytes.
+class ConstantDataProducer : public QuicStreamFrameDataProducer {
+ public:
+  ConstantDataProducer() : data_(kMaxOutgoingPacketSize, 'a') {}
+
+  WriteStreamDataResult WriteStreamData(QuicStreamId /*id*/,
+                                        QuicStreamOffset /*offset*/,
+                                        QuicByteCount data_length,
+                                        QuicDataWriter* writer) override {
+    return writer->WriteBytes(data_.data(), data_length) ? WRITE_SUCCESS
+                                                         : WRITE_FAILED;
+  }
+  bool WriteCryptoData(EncryptionLevel /*level*/,
+                       QuicStreamOffset /*offset*/,
+                       QuicByteCount /*data_length*/,
+                       QuicDataWriter* /*writer*/) override {
+    return false;
+  }
+
+ private:
+  const std::string data_;
+};
+
+class PacketCreatorFixture {
+ public:
+  PacketCreatorFixture()
+      : version_(ParsedQuicVersion::RFCv1()),
+        framer_({version_}, QuicTime::Zero(), Perspective::IS_CLIENT,
+                kQuicDefaultConnectionIdLength),
+        creator_(TestConnectionId(), &framer_, &delegate_) {
+    framer_.set_data_producer(&producer_);
+    creator_.SetEncrypter(
+        ENCRYPTION_FORWARD_SECURE,
+        std::make_unique<NullEncrypter>(Perspective::IS_CLIENT));
+    creator_.set_encryption_level(ENCRYPTION_FORWARD_SECURE);
+  }
+
+  // Writes |write_length| bytes of stream data and flushes the creator.
+  void WriteStreamData(size_t write_length) {
+    creator_.AttachPacketFlusher();
+    const QuicConsumedData consumed = creator_.ConsumeData(
+        QuicUtils::GetFirstBidirectionalStreamId(version_.transport_version,
+                                                 Perspective::IS_CLIENT),
+        write_length, offset_, NO_FIN);
+    creator_.Flush();
+    offset_ += consumed.bytes_consumed;
+  }
+
+  QuicByteCount bytes_serialized() const {
+    return delegate_.bytes_serialized();
+  }
+
+ private:
+  const ParsedQuicVersion version_;
+  DiscardingDelegate delegate_;
+  ConstantDataProducer producer_;
+  QuicFramer framer_;
+  QuicPacketCreator creator_;
+  QuicStreamOffset offset_ = 0;
+};
+
+// Writes state.range(0) bytes of stream data per iteration.  Writes larger
+// than a packet take the ConsumeDataFastPath() path.
+void BM_ConsumeData(benchmark::State& state) {
+  PacketCreatorFixture fixture;
+  const size_t write_length = state.range(0);
+
+  QuicBenchmarkAllocationReporter reporter(&state);
+  for (auto _ : state) {
+    fixture.WriteStreamData(write_length);
+  }
+  state.SetBytesProcessed(fixture.bytes_serialized());
+}
+BENCHMARK(BM_ConsumeData)->Arg(100)->Arg(1000)->Arg(16 * 1024);
+
+}  // namespace
+}  // namespace test
+}  // namespace quic
@@ -0,0 +1,228 @@
+// Copyright (c) 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Benchmarks for the per-request header work of QuicSimpleServerStream:
+// decoding and validating the request headers and looking up the response in
+// QuicMemoryCacheBackend.
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "benchmark/benchmark.h"
+#include "quic/core/http/http_encoder.h"
+#include "quic/core/http/quic_header_block_sink.h"
+#include "quic/core/http/quic_header_list.h"
+#include "quic/core/http/quic_spdy_stream.h"
+#include "quic/core/http/spdy_utils.h"
+#include "quic/core/qpack/qpack_encoder.h"
+#include "quic/core/quic_utils.h"
+#include "quic/core/quic_versions.h"
+#include "quic/test_tools/benchmarks/quic_benchmark_allocation_counter.h"
+#include "quic/test_tools/qpack/qpack_test_utils.h"
+#include "quic/test_tools/quic_test_utils.h"
+#include "quic/tools/quic_memory_cache_backend.h"
+#include "spdy/core/spdy_header_block.h"
+
+namespace quic {
+namespace test {
+namespace {
+
+using testing::NiceMock;
+
+// Headers of a typical browser GET request.
+const std::vector<std::pair<std::string, std::string>>& RequestHeaders() {
+  static const auto* headers =
+      new std::vector<std::pair<std::string, std::string>>{
+          {":method", "GET"},
+          {":scheme", "https"},
+          {":authority", "www.example.org:443"},
+          {":path", "/static/js/app.js"},
+          {"user-agent",
+           "Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 (KHTML, like "
+           "Gecko) Chrome/94.0.4606.81 Safari/537.36"},
+          {"accept", "*/*"},
+          {"accept-encoding", "gzip, deflate, br"},
+          {"accept-language", "en-US,en;q=0.9"},
+          {"referer", "https://www.example.org/index.html"},
+          {"sec-fetch-dest", "script"},
+          {"sec-fetch-mode", "no-cors"},
+          {"sec-fetch-site", "same-origin"},
+          {"cookie", "session=0123456789abcdef0123456789abcdef"},
+          {"cookie", "preferences=compact"},
+      };
+  return *headers;
+}
+
+QuicHeaderList MakeHeaderList() {
+  QuicHeaderList header_list;
+  header_list.OnHeaderBlockStart();
+  for (const auto& header : RequestHeaders()) {
+    header_list.OnHeader(header.first, header.second);
+  }
+  header_list.OnHeaderBlockEnd(0, 0);
+  return header_list;
+}
+
+// A request stream which validates its initial headers into an
+// Http2HeaderBlock as QuicSimpleServerStream does, either by copying them
+// from the QuicHeaderList with SpdyUtils::CopyAndValidateHeaders(), or as they
+// are decoded with a QuicHeaderBlockSink.
+class RequestStream : public QuicSpdyStream {
+ public:
+  RequestStream(QuicStreamId id, QuicSpdySession* session, bool use_sink)
+      : QuicSpdyStream(id, session, BIDIRECTIONAL),
+        use_sink_(use_sink),
+        request_headers_sink_(&request_headers_) {
+    if (use_sink_) {
+      set_initial_headers_sink(&request_headers_sink_);
+    }
+  }
+
+  void OnInitialHeadersComplete(bool fin,
+                                size_t frame_len,
+                                const QuicHeaderList& header_list) override {
+    QuicSpdyStream::OnInitialHeadersComplete(fin, frame_len, header_list);
+    if (use_sink_) {
+      valid_ = request_headers_sink_.valid();
+    } else {
+      int64_t content_length = -1;
+      valid_ = SpdyUtils::CopyAndValidateHeaders(header_list, &content_length,
+                                                 &request_headers_);
+    }
+    ConsumeHeaderList();
+  }
+
+  void OnBodyAvailable() override {}
+
+  bool valid() const { return valid_; }
+  const spdy::Http2HeaderBlock& request_headers() const {
+    return request_headers_;
+  }
+
+ private:
+  const bool use_sink_;
+  bool valid_ = false;
+  spdy::Http2HeaderBlock request_headers_;
+  QuicHeaderBlockSink request_headers_sink_;
+};
+
+// Returns the request headers in an HTTP/3 HEADERS frame, QPACK-encoded
+// without the dynamic table, as browsers mostly send them.
+std::string RequestHeadersFrame(QuicSpdySession* session) {
+  spdy::Http2HeaderBlock headers;
+  for (const auto& header : RequestHeaders()) {
+    headers.AppendValueOrAddHeader(header.first, header.second);
+  }
+  NoopQpackStreamSenderDelegate encoder_stream_sender_delegate;
+  QpackEncoder qpack_encoder(session);
+  qpack_encoder.set_qpack_stream_sender_delegate(
+      &encoder_stream_sender_delegate);
+  std::string payload =
+      qpack_encoder.EncodeHeaderList(/* stream_id = */ 0, headers, nullptr);
+  std::unique_ptr<char[]> frame_header;
+  QuicByteCount frame_header_length =
+      HttpEncoder::SerializeHeadersFrameHeader(payload.length(), &frame_header);
+  return absl::StrCat(
+      absl::string_view(frame_header.get(), frame_header_length), payload);
+}
+
+class BenchmarkRequestHandler
+    : public QuicSimpleServerBackend::RequestHandler {
+ public:
+  QuicConnectionId connection_id() const override {
+    return EmptyQuicConnectionId();
+  }
+  QuicStreamId stream_id() const override { return 0; }
+  std::string peer_host() const override { return "127.0.0.1"; }
+  void OnResponseBackendComplete(
+      const QuicBackendResponse* response) override {
+    benchmark::DoNotOptimize(response);
+  }
+};
+
+// Copies and validates the request headers with
+// SpdyUtils::CopyAndValidateHeaders() as QuicSimpleServerStream does.  Most of
+// the time goes to allocating the copied header block.
+void BM_CopyAndValidateHeaders(benchmark::State& state) {
+  const QuicHeaderList header_list = MakeHeaderList();
+
+  QuicBenchmarkAllocationReporter reporter(&state);
+  for (auto _ : state) {
+    int64_t content_length = -1;
+    spdy::SpdyHeaderBlock headers;
+    if (!SpdyUtils::CopyAndValidateHeaders(header_list, &content_length,
+                                           &headers)) {
+      state.SkipWithError("Invalid headers");
+      return;
+    }
+    benchmark::DoNotOptimize(headers);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_CopyAndValidateHeaders);
+
+// Looks up the response to the request in a QuicMemoryCacheBackend with
+// state.range(0) responses.
+void BM_FetchResponseFromBackend(benchmark::State& state) {
+  QuicMemoryCacheBackend backend;
+  for (int64_t i = 0; i < state.range(0); ++i) {
+    backend.AddSimpleResponse("www.example.org", absl::StrCat("/resource/", i),
+                              200, "body");
+  }
+  backend.AddSimpleResponse("www.example.org", "/static/js/app.js", 200,
+                            "body");
+  spdy::SpdyHeaderBlock request_headers;
+  for (const auto& header : RequestHeaders()) {
+    request_headers.AppendValueOrAddHeader(header.first, header.second);
+  }
+  BenchmarkRequestHandler handler;
+  const std::string request_body;
+
+  QuicBenchmarkAllocationReporter reporter(&state);
+  for (auto _ : state) {
+    backend.FetchResponseFromBackend(request_headers, request_body, &handler);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_FetchResponseFromBackend)->Arg(10)->Arg(10000);
+
+// Receives the request headers in a HEADERS frame on a new HTTP/3 request
+// stream and validates them into an Http2HeaderBlock, through a QuicHeaderList
+// and SpdyUtils::CopyAndValidateHeaders() if state.range(0) is 0, and with a
+// QuicHeaderBlockSink otherwise.  Includes creating the stream.
+void BM_ReceiveRequestHeaders(benchmark::State& state) {
+  MockQuicConnectionHelper helper;
+  MockAlarmFactory alarm_factory;
+  auto* connection = new NiceMock<MockQuicConnection>(
+      &helper, &alarm_factory, Perspective::IS_SERVER,
+      ParsedQuicVersionVector{ParsedQuicVersion::RFCv1()});
+  NiceMock<MockQuicSpdySession> session(connection);
+  session.Initialize();
+  const std::string frame = RequestHeadersFrame(&session);
+  const QuicStreamId id = GetNthClientInitiatedBidirectionalStreamId(
+      connection->transport_version(), 0);
+  const bool use_sink = state.range(0) != 0;
+
+  QuicBenchmarkAllocationReporter reporter(&state);
+  for (auto _ : state) {
+    RequestStream stream(id, &session, use_sink);
+    stream.OnStreamFrame(QuicStreamFrame(id, /*fin=*/false, 0, frame));
+    if (!stream.valid()) {
+      state.SkipWithError("Invalid headers");
+      return;
+    }
+    benchmark::DoNotOptimize(stream.request_headers());
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ReceiveRequestHeaders)->Arg(0)->Arg(1);
+
+}  // namespace
+}  // namespace test
+}  // namespace quic
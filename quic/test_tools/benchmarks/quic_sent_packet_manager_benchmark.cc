@@ -0,0 +1,116 @@
+// Copyright (c) 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Benchmarks for ACK processing in QuicSentPacketManager.
+
+#include <cstdint>
+
+#include "benchmark/benchmark.h"
+#include "quic/core/crypto/quic_random.h"
+#include "quic/core/quic_connection_stats.h"
+#include "quic/core/quic_packets.h"
+#include "quic/core/quic_sent_packet_manager.h"
+#include "quic/core/quic_time.h"
+#include "quic/core/session_notifier_interface.h"
+#include "quic/test_tools/benchmarks/quic_benchmark_allocation_counter.h"
+#include "quic/test_tools/mock_clock.h"
+
+namespace quic {
+namespace test {
+namespace {
+
+const QuicStreamId kStreamId = 4;
+const QuicPacketLength kPacketLength = 1350;
+
+// A session notifier for which frames stop being outstanding once their
+// packet is acked or lost, so that the unacked packet map stays small.
+class NoOpSessionNotifier : public SessionNotifierInterface {
+ public:
+  bool OnFrameAcked(const QuicFrame& /*frame*/,
+                    QuicTime::Delta /*ack_delay_time*/,
+                    QuicTime /*receive_timestamp*/) override {
+    return true;
+  }
+  void OnStreamFrameRetransmitted(const QuicStreamFrame& /*frame*/) override {}
+  void OnFrameLost(const QuicFrame& /*frame*/) override {}
+  void RetransmitFrames(const QuicFrames& /*frames*/,
+                        TransmissionType /*type*/) override {}
+  bool IsFrameOutstanding(const QuicFrame& /*frame*/) const override {
+    return false;
+  }
+  bool HasUnackedCryptoData() const override { return false; }
+  bool HasUnackedStreamData() const override { return false; }
+};
+
+class SentPacketManagerFixture {
+ public:
+  SentPacketManagerFixture()
+      : manager_(Perspective::IS_SERVER,
+                 &clock_,
+                 QuicRandom::GetInstance(),
+                 &stats_,
+                 kCubicBytes) {
+    clock_.AdvanceTime(QuicTime::Delta::FromSeconds(1));
+    manager_.SetSessionNotifier(&notifier_);
+  }
+
+  void SendPacket() {
+    SerializedPacket packet(++last_sent_packet_number_,
+                            PACKET_4BYTE_PACKET_NUMBER, nullptr, kPacketLength,
+                            false, false);
+    packet.encryption_level = ENCRYPTION_FORWARD_SECURE;
+    packet.retransmittable_frames.push_back(
+        QuicFrame(QuicStreamFrame(kStreamId, false, stream_offset_,
+                                  kPacketLength)));
+    stream_offset_ += kPacketLength;
+    manager_.OnPacketSent(&packet, clock_.Now(), NOT_RETRANSMISSION,
+                          HAS_RETRANSMITTABLE_DATA, true);
+  }
+
+  // Sends 2 * |num_ranges| - 1 packets and acks every other one of them, so
+  // that the ACK frame has |num_ranges| ranges.
+  void SendAndAckPackets(int num_ranges) {
+    const QuicPacketNumber first = last_sent_packet_number_ + 1;
+    for (int i = 0; i < 2 * num_ranges - 1; ++i) {
+      SendPacket();
+    }
+    clock_.AdvanceTime(QuicTime::Delta::FromMilliseconds(1));
+    manager_.OnAckFrameStart(last_sent_packet_number_, QuicTime::Delta::Zero(),
+                             clock_.Now());
+    // Ranges are reported from the largest to the smallest.
+    for (int i = num_ranges - 1; i >= 0; --i) {
+      const QuicPacketNumber acked = first + 2 * i;
+      manager_.OnAckRange(acked, acked + 1);
+    }
+    manager_.OnAckFrameEnd(clock_.Now(), ++last_received_packet_number_,
+                           ENCRYPTION_FORWARD_SECURE);
+  }
+
+ private:
+  MockClock clock_;
+  QuicConnectionStats stats_;
+  NoOpSessionNotifier notifier_;
+  QuicSentPacketManager manager_;
+  QuicPacketNumber last_sent_packet_number_ = QuicPacketNumber(0);
+  QuicPacketNumber last_received_packet_number_ = QuicPacketNumber(0);
+  QuicStreamOffset stream_offset_ = 0;
+};
+
+// Sends packets and processes an ACK frame with state.range(0) ranges per
+// iteration.  Packets in the gaps between ranges are eventually declared lost.
+void BM_SendAndAckPackets(benchmark::State& state) {
+  SentPacketManagerFixture fixture;
+  const int num_ranges = state.range(0);
+
+  QuicBenchmarkAllocationReporter reporter(&state);
+  for (auto _ : state) {
+    fixture.SendAndAckPackets(num_ranges);
+  }
+  state.SetItemsProcessed(state.iterations() * num_ranges);
+}
+BENCHMARK(BM_SendAndAckPackets)->Arg(1)->Arg(32)->Arg(256);
+
+}  // namespace
+}  // namespace test
+}  // namespace quic
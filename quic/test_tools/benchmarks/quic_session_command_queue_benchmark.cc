@@ -0,0 +1,266 @@
+// Copyright (c) 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Benchmarks for writing to a QuicSession from other threads with
+// QuicSessionCommandQueue, compared with a mutex-protected queue which wakes
+// the session thread on every write.
+
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "absl/types/span.h"
+#include "benchmark/benchmark.h"
+#include "quic/core/quic_buffer_allocator.h"
+#include "quic/core/quic_session_command_queue.h"
+#include "quic/core/quic_stream.h"
+#include "quic/platform/api/quic_epoll.h"
+#include "quic/platform/api/quic_mem_slice.h"
+#include "quic/test_tools/benchmarks/quic_benchmark_allocation_counter.h"
+#include "quic/test_tools/quic_test_utils.h"
+
+namespace quic {
+namespace test {
+namespace {
+
+class BenchmarkStream : public QuicStream {
+ public:
+  BenchmarkStream(QuicStreamId id, QuicSession* session)
+      : QuicStream(id, session, /*is_static=*/false, BIDIRECTIONAL) {}
+
+  void OnDataAvailable() override {}
+};
+
+// Discards the data written to streams, so that the benchmarks measure the
+// handoff to the session thread rather than the stream send buffers.
+class DiscardingCommandQueue : public QuicSessionCommandQueue {
+ public:
+  using QuicSessionCommandQueue::QuicSessionCommandQueue;
+
+  // Number of writes to streams so far.  May be read on any thread.
+  uint64_t num_stream_writes() const {
+    return num_stream_writes_.load(std::memory_order_acquire);
+  }
+
+ protected:
+  QuicConsumedData WriteToStream(QuicStream* /*stream*/,
+                                 absl::Span<QuicMemSlice> slices,
+                                 bool fin) override {
+    QuicByteCount bytes = 0;
+    for (QuicMemSlice& slice : slices) {
+      bytes += slice.length();
+      slice.Reset();
+    }
+    num_stream_writes_.fetch_add(1, std::memory_order_release);
+    return QuicConsumedData(bytes, fin);
+  }
+
+ private:
+  std::atomic<uint64_t> num_stream_writes_{0};
+};
+
+// The approach QuicSessionCommandQueue replaces: every write takes a mutex and
+// writes to an eventfd.
+class MutexCommandQueue : public QuicEpollCallbackInterface {
+ public:
+  explicit MutexCommandQueue(QuicEpollServer* epoll_server)
+      : epoll_server_(epoll_server),
+        wake_fd_(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) {
+    epoll_server_->RegisterFDForRead(wake_fd_, this);
+  }
+  ~MutexCommandQueue() override {
+    epoll_server_->UnregisterFD(wake_fd_);
+    close(wake_fd_);
+  }
+
+  void WriteMemSlice(QuicStreamId stream_id, QuicMemSlice data) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      writes_.emplace_back(stream_id, std::move(data));
+    }
+    const uint64_t value = 1;
+    benchmark::DoNotOptimize(write(wake_fd_, &value, sizeof(value)));
+  }
+
+  void OnRegistration(QuicEpollServer* /*eps*/,
+                      int /*fd*/,
+                      int /*event_mask*/) override {}
+  void OnModification(int /*fd*/, int /*event_mask*/) override {}
+  void OnEvent(int /*fd*/, QuicEpollEvent* /*event*/) override {
+    uint64_t value;
+    benchmark::DoNotOptimize(read(wake_fd_, &value, sizeof(value)));
+    std::deque<std::pair<QuicStreamId, QuicMemSlice>> writes;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      writes.swap(writes_);
+    }
+    for (auto& write : writes) {
+      benchmark::DoNotOptimize(write.second.length());
+    }
+  }
+  void OnUnregistration(int /*fd*/, bool /*replaced*/) override {}
+  void OnShutdown(QuicEpollServer* /*eps*/, int /*fd*/) override {}
+  std::string Name() const override { return "MutexCommandQueue"; }
+
+ private:
+  QuicEpollServer* epoll_server_;
+  int wake_fd_;
+  std::mutex mutex_;
+  std::deque<std::pair<QuicStreamId, QuicMemSlice>> writes_;
+};
+
+// A server session with one stream per producer thread, and a session thread
+// running its epoll server.
+class SessionThread {
+ public:
+  explicit SessionThread(int num_streams)
+      : connection_(new testing::NiceMock<MockQuicConnection>(
+            &helper_, &alarm_factory_, Perspective::IS_SERVER)),
+        session_(connection_),
+        queue_(&session_, &epoll_server_, /*visitor=*/nullptr),
+        mutex_queue_(&epoll_server_) {
+    session_.Initialize();
+    for (int i = 0; i < num_streams; ++i) {
+      const QuicStreamId id = GetNthServerInitiatedBidirectionalStreamId(
+          connection_->transport_version(), i);
+      session_.ActivateStream(std::make_unique<BenchmarkStream>(id, &session_));
+      stream_ids_.push_back(id);
+    }
+    epoll_server_.set_timeout_in_us(1000);
+    thread_ = std::thread([this]() {
+      while (!done_.load(std::memory_order_relaxed)) {
+        epoll_server_.WaitForEventsAndExecuteCallbacks();
+      }
+    });
+  }
+  ~SessionThread() { Stop(); }
+
+  // Stops the session thread.  The session may be accessed on the calling
+  // thread afterwards.
+  void Stop() {
+    if (thread_.joinable()) {
+      done_.store(true, std::memory_order_relaxed);
+      thread_.join();
+    }
+  }
+
+  QuicMemSlice MakeSlice(size_t length) {
+    return QuicMemSlice(QuicBuffer(&allocator_, length));
+  }
+
+  QuicStreamId stream_id(int i) const { return stream_ids_[i]; }
+  DiscardingCommandQueue* queue() { return &queue_; }
+  MutexCommandQueue* mutex_queue() { return &mutex_queue_; }
+
+ private:
+  SimpleBufferAllocator allocator_;
+  MockQuicConnectionHelper helper_;
+  MockAlarmFactory alarm_factory_;
+  testing::NiceMock<MockQuicConnection>* connection_;
+  testing::NiceMock<MockQuicSession> session_;
+  QuicEpollServer epoll_server_;
+  DiscardingCommandQueue queue_;
+  MutexCommandQueue mutex_queue_;
+  std::vector<QuicStreamId> stream_ids_;
+  std::atomic<bool> done_{false};
+  std::thread thread_;
+};
+
+SessionThread* session_thread = nullptr;
+
+// Each benchmark thread writes state.range(0)-byte chunks to its own stream
+// through QuicSessionCommandQueue, waiting while the queue is blocked.
+void BM_CommandQueueWrites(benchmark::State& state) {
+  if (state.thread_index() == 0) {
+    session_thread = new SessionThread(state.threads());
+  }
+  const size_t chunk_length = state.range(0);
+
+  QuicBenchmarkAllocationReporter reporter(&state);
+  for (auto _ : state) {
+    DiscardingCommandQueue* queue = session_thread->queue();
+    while (queue->IsBlocked()) {
+      std::this_thread::yield();
+    }
+    queue->WriteMemSlice(session_thread->stream_id(state.thread_index()),
+                         session_thread->MakeSlice(chunk_length),
+                         /*fin=*/false);
+  }
+  state.SetBytesProcessed(state.iterations() * chunk_length);
+
+  if (state.thread_index() == 0) {
+    session_thread->Stop();
+    const QuicSessionCommandQueue::Stats& stats =
+        session_thread->queue()->stats();
+    state.counters["commands/batch"] =
+        stats.batches == 0
+            ? 0.0
+            : static_cast<double>(stats.commands) / stats.batches;
+    delete session_thread;
+    session_thread = nullptr;
+  }
+}
+BENCHMARK(BM_CommandQueueWrites)
+    ->Arg(1024)
+    ->Arg(16 * 1024)
+    ->Threads(1)
+    ->Threads(4)
+    ->UseRealTime();
+
+// Like BM_CommandQueueWrites, with a mutex-protected queue which writes to an
+// eventfd for every chunk.
+void BM_MutexQueueWrites(benchmark::State& state) {
+  if (state.thread_index() == 0) {
+    session_thread = new SessionThread(state.threads());
+  }
+  const size_t chunk_length = state.range(0);
+
+  QuicBenchmarkAllocationReporter reporter(&state);
+  for (auto _ : state) {
+    session_thread->mutex_queue()->WriteMemSlice(
+        session_thread->stream_id(state.thread_index()),
+        session_thread->MakeSlice(chunk_length));
+  }
+  state.SetBytesProcessed(state.iterations() * chunk_length);
+
+  if (state.thread_index() == 0) {
+    delete session_thread;
+    session_thread = nullptr;
+  }
+}
+BENCHMARK(BM_MutexQueueWrites)
+    ->Arg(1024)
+    ->Arg(16 * 1024)
+    ->Threads(1)
+    ->Threads(4)
+    ->UseRealTime();
+
+// Writes one chunk at a time and waits until the session thread has written
+// it to the stream, measuring the latency of waking the session thread.
+void BM_WakeUpLatency(benchmark::State& state) {
+  SessionThread thread(/*num_streams=*/1);
+  DiscardingCommandQueue* queue = thread.queue();
+
+  QuicBenchmarkAllocationReporter reporter(&state);
+  for (auto _ : state) {
+    const uint64_t num_stream_writes = queue->num_stream_writes();
+    queue->WriteMemSlice(thread.stream_id(0), thread.MakeSlice(1),
+                         /*fin=*/false);
+    while (queue->num_stream_writes() == num_stream_writes) {
+    }
+  }
+}
+BENCHMARK(BM_WakeUpLatency)->UseRealTime();
+
+}  // namespace
+}  // namespace test
+}  // namespace quic
@@ -0,0 +1,68 @@
+// Copyright (c) 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Benchmarks for the QUIC network simulator, running MultiFlowScenarios as a
+// congestion control sweep would.  Each scenario runs on a single thread, see
+// MultiFlowScenario::RunInParallel() for running a sweep on several.
+
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "quic/core/quic_bandwidth.h"
+#include "quic/core/quic_time.h"
+#include "quic/test_tools/benchmarks/quic_benchmark_allocation_counter.h"
+#include "quic/test_tools/simulator/multi_flow_scenario.h"
+
+namespace quic {
+namespace test {
+namespace {
+
+const QuicTime::Delta kSimulatedDuration = QuicTime::Delta::FromSeconds(2);
+
+simulator::MultiFlowScenario::Params ScenarioParams(int64_t num_flows,
+                                                    int64_t bandwidth_mbps) {
+  simulator::MultiFlowScenario::Params params;
+  params.bottleneck_bandwidth =
+      QuicBandwidth::FromKBitsPerSecond(1000 * bandwidth_mbps);
+  params.duration = kSimulatedDuration;
+  params.warmup = QuicTime::Delta::Zero();
+  params.flows.resize(num_flows);
+  for (int64_t i = 0; i < num_flows; ++i) {
+    params.flows[i].congestion_control_type = i % 2 == 0 ? kBBRv2 : kCubicBytes;
+  }
+  return params;
+}
+
+// Runs a scenario with state.range(0) flows, alternately BBRv2 and Cubic, over
+// a bottleneck of state.range(1) Mbit/s.  Reports the simulated seconds per
+// wall second as the "sim_s" counter, and the packets delivered per wall
+// second as the "pps" counter.
+void BM_MultiFlowScenario(benchmark::State& state) {
+  const simulator::MultiFlowScenario::Params params =
+      ScenarioParams(state.range(0), state.range(1));
+  QuicByteCount bytes_received = 0;
+
+  QuicBenchmarkAllocationReporter reporter(&state);
+  for (auto _ : state) {
+    simulator::MultiFlowScenario scenario(params);
+    simulator::MultiFlowScenario::Results results = scenario.Run();
+    for (const auto& flow : results.flows) {
+      bytes_received += flow.bytes_received;
+    }
+  }
+  state.counters["sim_s"] = benchmark::Counter(
+      kSimulatedDuration.ToSeconds() * static_cast<double>(state.iterations()),
+      benchmark::Counter::kIsRate);
+  state.counters["pps"] =
+      benchmark::Counter(static_cast<double>(bytes_received) / 1350,
+                         benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_MultiFlowScenario)
+    ->ArgsProduct({{1, 4}, {100, 1000}})
+    ->ArgNames({"flows", "mbps"})
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace
+}  // namespace test
+}  // namespace quic
@@ -0,0 +1,167 @@
+// Copyright (c) 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Benchmarks for writing large HTTP/3 response bodies with QuicSpdyStream and
+// serializing them into STREAM frames.
+
+#include <algorithm>
+#include <memory>
+#include <string>
+
+#include "absl/types/span.h"
+#include "benchmark/benchmark.h"
+#include "quic/core/http/quic_spdy_stream.h"
+#include "quic/core/quic_buffer_allocator.h"
+#include "quic/core/quic_data_writer.h"
+#include "quic/core/quic_utils.h"
+#include "quic/core/quic_versions.h"
+#include "quic/platform/api/quic_mem_slice.h"
+#include "quic/test_tools/benchmarks/quic_benchmark_allocation_counter.h"
+#include "quic/test_tools/quic_config_peer.h"
+#include "quic/test_tools/quic_test_utils.h"
+
+namespace quic {
+namespace test {
+namespace {
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+
+// Size of the stream data in a full-sized 1-RTT packet.
+const size_t kFrameLength = 1300;
+
+const QuicByteCount kFlowControlWindow = 16 * 1024 * 1024;
+
+class BenchmarkStream : public QuicSpdyStream {
+ public:
+  BenchmarkStream(QuicStreamId id, QuicSpdySession* session)
+      : QuicSpdyStream(id, session, BIDIRECTIONAL) {}
+
+  void OnBodyAvailable() override {}
+};
+
+// A server session whose writes serialize the stream data into
+// |kFrameLength|-byte STREAM frames, the way QuicPacketCreator pulls it from
+// the stream's send buffer.
+class BenchmarkSession {
+ public:
+  BenchmarkSession()
+      : connection_(new NiceMock<MockQuicConnection>(
+            &helper_, &alarm_factory_, Perspective::IS_SERVER,
+            ParsedQuicVersionVector{ParsedQuicVersion::RFCv1()})),
+        session_(connection_) {
+    ON_CALL(session_, WritevData(_, _, _, _, _, _))
+        .WillByDefault(Invoke(this, &BenchmarkSession::WritevData));
+    session_.Initialize();
+    QuicConfigPeer::SetReceivedInitialSessionFlowControlWindow(
+        session_.config(), kFlowControlWindow);
+    QuicConfigPeer::SetReceivedInitialMaxStreamDataBytesIncomingBidirectional(
+        session_.config(), kFlowControlWindow);
+    QuicConfigPeer::SetReceivedInitialMaxStreamDataBytesOutgoingBidirectional(
+        session_.config(), kFlowControlWindow);
+    QuicConfigPeer::SetReceivedInitialMaxStreamDataBytesUnidirectional(
+        session_.config(), kFlowControlWindow);
+    QuicConfigPeer::SetReceivedMaxUnidirectionalStreams(session_.config(), 10);
+    session_.OnConfigNegotiated();
+
+    auto stream = std::make_unique<BenchmarkStream>(
+        GetNthClientInitiatedBidirectionalStreamId(
+            connection_->transport_version(), 0),
+        &session_);
+    stream_ = stream.get();
+    session_.ActivateStream(std::move(stream));
+  }
+
+  // Acks all data written to the stream so far, freeing the send buffer, and
+  // extends the flow control send windows as a peer reading the data would.
+  void AckAll() {
+    const QuicStreamOffset written = stream_->stream_bytes_written();
+    QuicByteCount newly_acked_length = 0;
+    stream_->OnStreamFrameAcked(acked_offset_, written - acked_offset_,
+                                /*fin_acked=*/false, QuicTime::Delta::Zero(),
+                                QuicTime::Zero(), &newly_acked_length);
+    acked_offset_ = written;
+    stream_->OnWindowUpdateFrame(QuicWindowUpdateFrame(
+        kInvalidControlFrameId, stream_->id(), written + kFlowControlWindow));
+    session_.flow_controller()->UpdateSendWindowOffset(
+        session_.flow_controller()->bytes_sent() + kFlowControlWindow);
+  }
+
+  BenchmarkStream* stream() { return stream_; }
+  QuicBufferAllocator* allocator() { return &allocator_; }
+  uint64_t num_writes() const { return num_writes_; }
+
+ private:
+  QuicConsumedData WritevData(QuicStreamId id,
+                              size_t write_length,
+                              QuicStreamOffset offset,
+                              StreamSendingState state,
+                              TransmissionType /*type*/,
+                              absl::optional<EncryptionLevel> /*level*/) {
+    QuicStream* stream = session_.GetOrCreateStream(id);
+    if (stream == stream_) {
+      ++num_writes_;
+    }
+    char buffer[kFrameLength];
+    for (size_t written = 0; written < write_length;) {
+      const size_t length = std::min(kFrameLength, write_length - written);
+      QuicDataWriter writer(length, buffer);
+      stream->WriteStreamData(offset + written, length, &writer);
+      benchmark::DoNotOptimize(buffer);
+      written += length;
+    }
+    return QuicConsumedData(write_length, state != NO_FIN);
+  }
+
+  SimpleBufferAllocator allocator_;
+  MockQuicConnectionHelper helper_;
+  MockAlarmFactory alarm_factory_;
+  NiceMock<MockQuicConnection>* connection_;
+  NiceMock<MockQuicSpdySession> session_;
+  BenchmarkStream* stream_;
+  QuicStreamOffset acked_offset_ = 0;
+  uint64_t num_writes_ = 0;
+};
+
+// Writes state.range(0)-byte chunks of a response body in buffers owned by the
+// application with QuicSpdyStream::WriteBodySlices().  Reports the number of
+// writes to the session per chunk as the "writes/chunk" counter.
+void BM_WriteBodySlices(benchmark::State& state) {
+  BenchmarkSession session;
+  const size_t chunk_length = state.range(0);
+
+  QuicBenchmarkAllocationReporter reporter(&state);
+  for (auto _ : state) {
+    QuicMemSlice slice(QuicBuffer(session.allocator(), chunk_length));
+    session.stream()->WriteBodySlices(absl::MakeSpan(&slice, 1),
+                                      /*fin=*/false);
+    session.AckAll();
+  }
+  state.SetBytesProcessed(state.iterations() * chunk_length);
+  state.counters["writes/chunk"] = benchmark::Counter(
+      session.num_writes(), benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_WriteBodySlices)->Arg(16 * 1024)->Arg(256 * 1024);
+
+// Like BM_WriteBodySlices, with the chunks copied into the send buffer by
+// QuicSpdyStream::WriteOrBufferBody().
+void BM_WriteOrBufferBody(benchmark::State& state) {
+  BenchmarkSession session;
+  const std::string chunk(state.range(0), 'a');
+
+  QuicBenchmarkAllocationReporter reporter(&state);
+  for (auto _ : state) {
+    session.stream()->WriteOrBufferBody(chunk, /*fin=*/false);
+    session.AckAll();
+  }
+  state.SetBytesProcessed(state.iterations() * chunk.length());
+  state.counters["writes/chunk"] = benchmark::Counter(
+      session.num_writes(), benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_WriteOrBufferBody)->Arg(16 * 1024)->Arg(256 * 1024);
+
+}  // namespace
+}  // namespace test
+}  // namespace quic
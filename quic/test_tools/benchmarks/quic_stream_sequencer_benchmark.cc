@@ -0,0 +1,85 @@
+// Copyright (c) 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Benchmarks for receiving a bulk download with QuicStreamSequencer, with and
+// without reading in-order frames in place.
+
+#include <string>
+
+#include "absl/strings/string_view.h"
+#include "benchmark/benchmark.h"
+#include "quic/core/frames/quic_stream_frame.h"
+#include "quic/core/quic_stream_sequencer.h"
+#include "quic/core/quic_versions.h"
+#include "quic/platform/api/quic_iovec.h"
+#include "quic/test_tools/benchmarks/quic_benchmark_allocation_counter.h"
+
+namespace quic {
+namespace test {
+namespace {
+
+// Size of the stream data in a full-sized 1-RTT packet.
+const size_t kFrameLength = 1300;
+
+// A stream which consumes all readable data in place, like a client which
+// hashes or forwards the response body.
+class ConsumingStream : public QuicStreamSequencer::StreamInterface {
+ public:
+  void OnDataAvailable() override {
+    iovec iovs[8];
+    const int num_regions = sequencer_->GetReadableRegions(iovs, 8);
+    size_t readable = 0;
+    for (int i = 0; i < num_regions; ++i) {
+      benchmark::DoNotOptimize(iovs[i].iov_base);
+      readable += iovs[i].iov_len;
+    }
+    sequencer_->MarkConsumed(readable);
+  }
+  void OnFinRead() override {}
+  void AddBytesConsumed(QuicByteCount /*bytes*/) override {}
+  void Reset(QuicRstStreamErrorCode /*error*/) override {}
+  void OnUnrecoverableError(QuicErrorCode /*error*/,
+                            const std::string& /*details*/) override {}
+  void OnUnrecoverableError(QuicErrorCode /*error*/,
+                            QuicIetfTransportErrorCodes /*ietf_error*/,
+                            const std::string& /*details*/) override {}
+  QuicStreamId id() const override { return 0; }
+  ParsedQuicVersion version() const override {
+    return ParsedQuicVersion::RFCv1();
+  }
+
+  void set_sequencer(QuicStreamSequencer* sequencer) { sequencer_ = sequencer; }
+
+ private:
+  QuicStreamSequencer* sequencer_ = nullptr;
+};
+
+// Receives in-order STREAM frames which are consumed as they arrive.  If
+// state.range(0) is non-zero, the frames are read in place.  Reports the
+// number of bytes copied into the sequencer's buffer per byte received as the
+// "copies/byte" counter.
+void BM_ReceiveInOrderFrames(benchmark::State& state) {
+  ConsumingStream stream;
+  QuicStreamSequencer sequencer(&stream);
+  stream.set_sequencer(&sequencer);
+  sequencer.set_read_in_order_frames_in_place(state.range(0) != 0);
+  const std::string data(kFrameLength, 'a');
+  QuicStreamOffset offset = 0;
+
+  QuicBenchmarkAllocationReporter reporter(&state);
+  for (auto _ : state) {
+    sequencer.OnStreamFrame(
+        QuicStreamFrame(/*stream_id=*/0, /*fin=*/false, offset, data));
+    offset += kFrameLength;
+  }
+  state.SetBytesProcessed(offset);
+  state.counters["copies/byte"] =
+      offset == 0 ? 0.0
+                  : static_cast<double>(sequencer.num_bytes_copied()) / offset;
+}
+BENCHMARK(BM_ReceiveInOrderFrames)->Arg(0)->Arg(1);
+
+}  // namespace
+}  // namespace test
+}  // namespace quic
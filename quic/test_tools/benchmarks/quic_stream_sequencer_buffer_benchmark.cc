@@ -0,0 +1,87 @@
+// Copyright (c) 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Benchmarks for buffering and reading stream data with
+// QuicStreamSequencerBuffer.
+
+#include <string>
+
+#include "absl/strings/string_view.h"
+#include "benchmark/benchmark.h"
+#include "quic/core/quic_constants.h"
+#include "quic/core/quic_error_codes.h"
+#include "quic/core/quic_stream_sequencer_buffer.h"
+#include "quic/platform/api/quic_iovec.h"
+#include "quic/test_tools/benchmarks/quic_benchmark_allocation_counter.h"
+
+namespace quic {
+namespace test {
+namespace {
+
+// Size of the stream data in a full-sized 1-RTT packet.
+const size_t kFrameLength = 1300;
+// Number of frames buffered before they are read.
+const size_t kFramesPerRead = 16;
+
+// Buffers kFramesPerRead frames and then reads them with a single Readv() per
+// iteration.  If state.range(0) is non-zero, each pair of frames arrives out
+// of order.
+void BM_BufferAndReadFrames(benchmark::State& state) {
+  const bool reorder = state.range(0) != 0;
+  QuicStreamSequencerBuffer buffer(kStreamReceiveWindowLimit);
+  const std::string data(kFrameLength, 'a');
+  char output[kFramesPerRead * kFrameLength];
+  QuicStreamOffset offset = 0;
+  size_t bytes_buffered;
+  size_t bytes_read;
+  std::string error_details;
+
+  QuicBenchmarkAllocationReporter reporter(&state);
+  for (auto _ : state) {
+    for (size_t i = 0; i < kFramesPerRead; ++i) {
+      const size_t index = reorder ? i ^ 1 : i;
+      buffer.OnStreamData(offset + index * kFrameLength, data, &bytes_buffered,
+                          &error_details);
+    }
+    iovec iov = {output, sizeof(output)};
+    buffer.Readv(&iov, 1, &bytes_read, &error_details);
+    benchmark::DoNotOptimize(output);
+    offset += bytes_read;
+  }
+  state.SetBytesProcessed(offset);
+}
+BENCHMARK(BM_BufferAndReadFrames)->Arg(0)->Arg(1);
+
+// Buffers kFramesPerRead frames and consumes them in place with
+// GetReadableRegions() and MarkConsumed().
+void BM_BufferAndConsumeFrames(benchmark::State& state) {
+  QuicStreamSequencerBuffer buffer(kStreamReceiveWindowLimit);
+  const std::string data(kFrameLength, 'a');
+  QuicStreamOffset offset = 0;
+  size_t bytes_buffered;
+  std::string error_details;
+
+  QuicBenchmarkAllocationReporter reporter(&state);
+  for (auto _ : state) {
+    for (size_t i = 0; i < kFramesPerRead; ++i) {
+      buffer.OnStreamData(offset + i * kFrameLength, data, &bytes_buffered,
+                          &error_details);
+    }
+    iovec iovs[8];
+    const int num_regions = buffer.GetReadableRegions(iovs, 8);
+    size_t readable = 0;
+    for (int i = 0; i < num_regions; ++i) {
+      benchmark::DoNotOptimize(iovs[i].iov_base);
+      readable += iovs[i].iov_len;
+    }
+    buffer.MarkConsumed(readable);
+    offset += readable;
+  }
+  state.SetBytesProcessed(offset);
+}
+BENCHMARK(BM_BufferAndConsumeFrames);
+
+}  // namespace
+}  // namespace test
+}  // namespace quic
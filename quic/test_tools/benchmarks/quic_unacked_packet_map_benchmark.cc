@@ -0,0 +1,128 @@
+// Copyright (c) 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Benchmarks for the per-ACK work of QuicUnackedPacketMap and
+// GeneralLossAlgorithm on connections with a large bandwidth-delay product.
+
+#include <cstdint>
+#include <memory>
+
+#include "benchmark/benchmark.h"
+#include "quic/core/congestion_control/general_loss_algorithm.h"
+#include "quic/core/congestion_control/rtt_stats.h"
+#include "quic/core/frames/quic_stream_frame.h"
+#include "quic/core/quic_packets.h"
+#include "quic/core/quic_time.h"
+#include "quic/core/quic_unacked_packet_map.h"
+#include "quic/platform/api/quic_flags.h"
+#include "quic/test_tools/benchmarks/quic_benchmark_allocation_counter.h"
+
+namespace quic {
+namespace test {
+namespace {
+
+const QuicStreamId kStreamId = 4;
+const QuicPacketLength kPacketLength = 1350;
+
+// A window of packets in flight, the first of which was lost and
+// retransmitted at the end of the window.  Until the retransmission is acked,
+// the lost packet stays at the front of the unacked packet map, so every
+// packet acked in the meantime stays in the map too.
+class HighBdpFixture {
+ public:
+  explicit HighBdpFixture(QuicPacketCount window)
+      : unacked_packets_(Perspective::IS_SERVER),
+        now_(QuicTime::Zero() + QuicTime::Delta::FromSeconds(1)),
+        next_to_ack_(2),
+        retransmission_(window + 1) {
+    unacked_packets_.EnableMultiplePacketNumberSpacesSupport();
+    loss_algorithm_.Initialize(APPLICATION_DATA, nullptr);
+    for (QuicPacketCount i = 0; i < window; ++i) {
+      SendPacket();
+    }
+    unacked_packets_.RemoveFromInFlight(QuicPacketNumber(1));
+    unacked_packets_.GetMutableTransmissionInfo(QuicPacketNumber(1))
+        ->first_sent_after_loss = retransmission_;
+    SendPacket();
+  }
+
+  // Returns true once all packets sent before the retransmission are acked.
+  bool done() const { return next_to_ack_ >= retransmission_; }
+
+  // Acks the next packet in order, detects losses and finds the first packet
+  // in flight as done when arming the PTO alarm, then sends a new packet to
+  // keep the window full.
+  void AckNextPacket() {
+    const QuicPacketNumber acked = next_to_ack_++;
+    unacked_packets_.RemoveFromInFlight(acked);
+    unacked_packets_.IncreaseLargestAcked(acked);
+    unacked_packets_.MaybeUpdateLargestAckedOfPacketNumberSpace(
+        APPLICATION_DATA, acked);
+    AckedPacketVector packets_acked;
+    packets_acked.push_back(
+        AckedPacket(acked, kPacketLength, QuicTime::Zero()));
+    LostPacketVector packets_lost;
+    loss_algorithm_.DetectLosses(unacked_packets_, now_, rtt_stats_, acked,
+                                 packets_acked, &packets_lost);
+    benchmark::DoNotOptimize(
+        unacked_packets_.GetFirstInFlightTransmissionInfoOfSpace(
+            APPLICATION_DATA));
+    unacked_packets_.RemoveObsoletePackets();
+    SendPacket();
+  }
+
+ private:
+  void SendPacket() {
+    SerializedPacket packet(++last_sent_packet_number_,
+                            PACKET_4BYTE_PACKET_NUMBER, nullptr, kPacketLength,
+                            false, false);
+    packet.encryption_level = ENCRYPTION_FORWARD_SECURE;
+    packet.retransmittable_frames.push_back(
+        QuicFrame(QuicStreamFrame(kStreamId, false, stream_offset_,
+                                  kPacketLength)));
+    stream_offset_ += kPacketLength;
+    unacked_packets_.AddSentPacket(&packet, NOT_RETRANSMISSION, now_, true,
+                                   true);
+  }
+
+  QuicUnackedPacketMap unacked_packets_;
+  GeneralLossAlgorithm loss_algorithm_;
+  RttStats rtt_stats_;
+  QuicTime now_;
+  QuicPacketNumber next_to_ack_;
+  const QuicPacketNumber retransmission_;
+  QuicPacketNumber last_sent_packet_number_ = QuicPacketNumber(0);
+  QuicStreamOffset stream_offset_ = 0;
+};
+
+// Acks packets one at a time with state.range(1) packets in flight, behind a
+// lost packet awaiting its retransmission's ACK.  If state.range(0) is
+// non-zero, the unacked packet map keeps its index of the least packet in
+// flight, otherwise it's scanned for.  Reports the time per ACK, and the ACKs
+// processed per second as the "pps" counter.
+void BM_AckBehindLostPacket(benchmark::State& state) {
+  SetQuicReloadableFlag(quic_unacked_map_in_flight_index,
+                        state.range(0) != 0);
+  const QuicPacketCount window = state.range(1);
+  std::unique_ptr<HighBdpFixture> fixture;
+
+  QuicBenchmarkAllocationReporter reporter(&state);
+  for (auto _ : state) {
+    if (fixture == nullptr || fixture->done()) {
+      state.PauseTiming();
+      fixture = std::make_unique<HighBdpFixture>(window);
+      state.ResumeTiming();
+    }
+    fixture->AckNextPacket();
+  }
+  state.counters["pps"] = benchmark::Counter(
+      static_cast<double>(state.iterations()), benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_AckBehindLostPacket)
+    ->ArgsProduct({{0, 1}, {1000, 100000}})
+    ->ArgNames({"index", "window"});
+
+}  // namespace
+}  // namespace test
+}  // namespace quic
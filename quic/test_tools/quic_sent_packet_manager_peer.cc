@@ -214,5 +214,11 @@ bool QuicSentPacketManagerPeer::UsePacketThresholdForRuntPackets(
       .use_packet_threshold_for_runt_packets();
 }
 
+// static
+void QuicSentPacketManagerPeer::EnableEcn(
+    QuicSentPacketManager* sent_packet_manager) {
+  sent_packet_manager->ecn_enabled_ = true;
+}
+
 }  // namespace test
 }  // namespace quic
@@ -98,6 +98,9 @@ class QuicSentPacketManagerPeer {
 
   static bool UsePacketThresholdForRuntPackets(
       QuicSentPacketManager* sent_packet_manager);
+
+  // Enables ECN as if negotiated via the ECNS connection option.
+  static void EnableEcn(QuicSentPacketManager* sent_packet_manager);
 };
 
 }  // namespace test
@@ -282,6 +282,8 @@ MockFramerVisitor::MockFramerVisitor() {
 
   ON_CALL(*this, OnCryptoFrame(_)).WillByDefault(testing::Return(true));
 
+  ON_CALL(*this, OnAckEcnCounts(_)).WillByDefault(testing::Return(true));
+
   ON_CALL(*this, OnStopWaitingFrame(_)).WillByDefault(testing::Return(true));
 
   ON_CALL(*this, OnPaddingFrame(_)).WillByDefault(testing::Return(true));
@@ -356,6 +358,10 @@ bool NoOpFramerVisitor::OnAckTimestamp(QuicPacketNumber /*packet_number*/,
   return true;
 }
 
+bool NoOpFramerVisitor::OnAckEcnCounts(const QuicEcnCounts& /*ecn_counts*/) {
+  return true;
+}
+
 bool NoOpFramerVisitor::OnAckFrameEnd(QuicPacketNumber /*start*/) {
   return true;
 }
@@ -1405,9 +1411,10 @@ WriteResult TestPacketWriter::WritePacket(const char* buffer,
                                           size_t buf_len,
                                           const QuicIpAddress& self_address,
                                           const QuicSocketAddress& peer_address,
-                                          PerPacketOptions* /*options*/) {
+                                          PerPacketOptions* options) {
   last_write_source_address_ = self_address;
   last_write_peer_address_ = peer_address;
+  last_ecn_sent_ = options == nullptr ? ECN_NOT_ECT : options->ecn_codepoint;
   // If the buffer is allocated from the pool, return it back to the pool.
   // Note the buffer content doesn't change.
   if (packet_buffer_pool_index_.find(const_cast<char*>(buffer)) !=
@@ -357,6 +357,7 @@ class MockFramerVisitor : public QuicFramerVisitorInterface {
               (QuicPacketNumber, QuicPacketNumber),
               (override));
   MOCK_METHOD(bool, OnAckTimestamp, (QuicPacketNumber, QuicTime), (override));
+  MOCK_METHOD(bool, OnAckEcnCounts, (const QuicEcnCounts&), (override));
   MOCK_METHOD(bool, OnAckFrameEnd, (QuicPacketNumber), (override));
   MOCK_METHOD(bool,
               OnStopWaitingFrame,
@@ -482,6 +483,7 @@ class NoOpFramerVisitor : public QuicFramerVisitorInterface {
   bool OnAckRange(QuicPacketNumber start, QuicPacketNumber end) override;
   bool OnAckTimestamp(QuicPacketNumber packet_number,
                       QuicTime timestamp) override;
+  bool OnAckEcnCounts(const QuicEcnCounts& ecn_counts) override;
   bool OnAckFrameEnd(QuicPacketNumber start) override;
   bool OnStopWaitingFrame(const QuicStopWaitingFrame& frame) override;
   bool OnPaddingFrame(const QuicPaddingFrame& frame) override;
@@ -1436,6 +1438,15 @@ class MockSendAlgorithm : public SendAlgorithmInterface {
               PopulateConnectionStats,
               (QuicConnectionStats*),
               (const, override));
+  MOCK_METHOD(QuicEcnCodepoint, GetEcnCodepointToSend, (), (const, override));
+  MOCK_METHOD(void,
+              OnEcnFeedback,
+              (QuicTime,
+               QuicPacketNumber,
+               QuicByteCount,
+               QuicPacketCount,
+               QuicPacketCount),
+              (override));
 };
 
 class MockLossAlgorithm : public LossDetectionInterface {
@@ -1634,7 +1645,9 @@ class MockReceivedPacketManager : public QuicReceivedPacketManager {
 
   MOCK_METHOD(void,
               RecordPacketReceived,
-              (const QuicPacketHeader& header, QuicTime receipt_time),
+              (const QuicPacketHeader& header,
+               QuicTime receipt_time,
+               QuicEcnCodepoint ecn_codepoint),
               (override));
   MOCK_METHOD(bool, IsMissing, (QuicPacketNumber packet_number), (override));
   MOCK_METHOD(bool,
@@ -2247,6 +2260,8 @@ class TestPacketWriter : public QuicPacketWriter {
     return last_write_peer_address_;
   }
 
+  QuicEcnCodepoint last_ecn_sent() const { return last_ecn_sent_; }
+
  private:
   char* AllocPacketBuffer();
 
@@ -2290,6 +2305,8 @@ class TestPacketWriter : public QuicPacketWriter {
   // The soruce/peer address passed into WritePacket().
   QuicIpAddress last_write_source_address_;
   QuicSocketAddress last_write_peer_address_;
+  // The ECN codepoint in the PerPacketOptions passed into WritePacket().
+  QuicEcnCodepoint last_ecn_sent_ = ECN_NOT_ECT;
   int write_error_code_{0};
 };
 
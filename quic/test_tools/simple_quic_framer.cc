@@ -112,6 +112,10 @@ class SimpleFramerVisitor : public QuicFramerVisitorInterface {
     return true;
   }
 
+  bool OnAckEcnCounts(const QuicEcnCounts& /*ecn_counts*/) override {
+    return true;
+  }
+
   bool OnAckFrameEnd(QuicPacketNumber /*start*/) override { return true; }
 
   bool OnStopWaitingFrame(const QuicStopWaitingFrame& frame) override {
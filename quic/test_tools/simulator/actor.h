@@ -5,6 +5,8 @@
 #ifndef QUICHE_QUIC_TEST_TOOLS_SIMULATOR_ACTOR_H_
 #define QUICHE_QUIC_TEST_TOOLS_SIMULATOR_ACTOR_H_
 
+#include <cstddef>
+#include <limits>
 #include <string>
 
 #include "quic/core/quic_clock.h"
@@ -52,6 +54,13 @@ class Actor {
   std::string name_;
 
  private:
+  friend class Simulator;
+
+  // Position of the actor in the schedule of the simulator, or
+  // kNotScheduled.  Maintained by the simulator.
+  static constexpr size_t kNotScheduled = std::numeric_limits<size_t>::max();
+  size_t schedule_index_ = kNotScheduled;
+
   // Since the Actor object registers itself with a simulator using a pointer to
   // itself, do not allow it to be moved.
   Actor(Actor&&) = delete;
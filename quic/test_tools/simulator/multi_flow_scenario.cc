@@ -0,0 +1,416 @@
+// Copyright (c) 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "quic/test_tools/simulator/multi_flow_scenario.h"
+
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <utility>
+
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "quic/core/congestion_control/send_algorithm_interface.h"
+#include "quic/core/quic_config.h"
+#include "quic/core/quic_connection_stats.h"
+#include "quic/core/quic_constants.h"
+#include "quic/core/quic_sent_packet_manager.h"
+#include "quic/platform/api/quic_flags.h"
+#include "quic/platform/api/quic_logging.h"
+#include "quic/platform/api/quic_thread.h"
+#include "quic/test_tools/quic_config_peer.h"
+#include "quic/test_tools/quic_connection_peer.h"
+
+namespace quic {
+namespace simulator {
+
+namespace {
+
+// Completion of finite flows is checked this often.
+const QuicTime::Delta kCompletionCheckInterval =
+    QuicTime::Delta::FromMilliseconds(1);
+
+// Lets the receivers, which only send acks, track enough packets not to close
+// the connection due to too many outstanding packets.
+const size_t kMaxTrackedPackets = 1000000;
+
+void RaiseMaxTrackedPacketCount() {
+  if (GetQuicFlag(FLAGS_quic_max_tracked_packet_count) < kMaxTrackedPackets) {
+    SetQuicFlag(FLAGS_quic_max_tracked_packet_count, kMaxTrackedPackets);
+  }
+}
+
+// Runs the scenarios of |params| which haven't been claimed by other threads
+// yet, each in turn.
+class ScenarioThread : public QuicThread {
+ public:
+  ScenarioThread(const std::vector<MultiFlowScenario::Params>* params,
+                 std::vector<MultiFlowScenario::Results>* results,
+                 std::atomic<size_t>* next_scenario)
+      : QuicThread("MultiFlowScenario"),
+        params_(params),
+        results_(results),
+        next_scenario_(next_scenario) {}
+
+  void Run() override {
+    for (size_t i = (*next_scenario_)++; i < params_->size();
+         i = (*next_scenario_)++) {
+      MultiFlowScenario scenario((*params_)[i]);
+      (*results_)[i] = scenario.Run();
+    }
+  }
+
+ private:
+  const std::vector<MultiFlowScenario::Params>* params_;
+  std::vector<MultiFlowScenario::Results>* results_;
+  std::atomic<size_t>* next_scenario_;
+};
+
+const char* CongestionControlTypeName(CongestionControlType type) {
+  switch (type) {
+    case kCubicBytes:
+      return "cubic";
+    case kRenoBytes:
+      return "reno";
+    case kBBR:
+      return "bbr";
+    case kPCC:
+      return "pcc";
+    case kGoogCC:
+      return "goog_cc";
+    case kBBRv2:
+      return "bbr2";
+    case kPragueBytes:
+      return "prague";
+    case kBBRv3:
+      return "bbr3";
+  }
+  return "unknown";
+}
+
+double Ratio(uint64_t numerator, uint64_t denominator) {
+  return denominator == 0 ? 0.0
+                          : static_cast<double>(numerator) / denominator;
+}
+
+}  // namespace
+
+MultiFlowScenario::QueueMonitor::QueueMonitor(MultiFlowScenario* scenario)
+    : scenario_(scenario) {}
+
+void MultiFlowScenario::QueueMonitor::OnPacketDequeued() {
+  if (!scenario_->measuring_) {
+    return;
+  }
+  scenario_->queueing_delay_.Add(
+      scenario_->bottleneck_queue()->last_dequeued_packet_delay());
+}
+
+MultiFlowScenario::MultiFlowScenario(const Params& params)
+    : params_(params),
+      simulator_(&random_),
+      start_time_(simulator_.GetClock()->Now()),
+      access_bandwidth_(params.access_bandwidth.IsZero()
+                            ? params.bottleneck_bandwidth * 10
+                            : params.access_bandwidth),
+      measuring_(false),
+      queue_monitor_(this) {
+  random_.set_seed(params_.random_seed);
+  RaiseMaxTrackedPacketCount();
+
+  QuicTime::Delta min_rtt = QuicTime::Delta::Infinite();
+  for (const FlowParams& flow_params : params_.flows) {
+    min_rtt = std::min(min_rtt, flow_params.rtt);
+  }
+  if (params_.flows.empty()) {
+    min_rtt = 2 * params_.bottleneck_delay;
+  }
+  const QuicByteCount buffer_size = std::max<QuicByteCount>(
+      kMaxOutgoingPacketSize,
+      params_.buffer_size_in_bdp *
+          (params_.bottleneck_bandwidth * min_rtt));
+  // Port 1 leads to the receivers, port i + 2 to the sender of flow i.
+  switch_ = std::make_unique<Switch>(&simulator_, "Switch",
+                                     params_.flows.size() + 1, buffer_size);
+  bottleneck_queue()->set_listener_interface(&queue_monitor_);
+
+  std::vector<QuicEndpointBase*> receivers;
+  flows_.resize(params_.flows.size());
+  for (size_t i = 0; i < params_.flows.size(); ++i) {
+    SetUpFlow(i, params_.flows[i]);
+    receivers.push_back(flows_[i].receiver.get());
+  }
+  receiver_multiplexer_ =
+      std::make_unique<QuicEndpointMultiplexer>("Receivers", receivers);
+
+  Endpoint* bottleneck_input = switch_->port(1);
+  if (params_.policer.has_value()) {
+    policer_ = std::make_unique<TrafficPolicer>(
+        &simulator_, "Policer", params_.policer->bucket_size,
+        params_.policer->bucket_size, params_.policer->target_bandwidth,
+        bottleneck_input);
+    bottleneck_input = policer_.get();
+  }
+  if (params_.loss_probability > 0) {
+    loss_filter_ = std::make_unique<RandomLossFilter>(
+        &simulator_, "Random loss", bottleneck_input,
+        params_.loss_probability);
+    bottleneck_input = loss_filter_.get();
+  }
+  bottleneck_link_ = std::make_unique<SymmetricLink>(
+      bottleneck_input, receiver_multiplexer_.get(),
+      params_.bottleneck_bandwidth, params_.bottleneck_delay);
+}
+
+MultiFlowScenario::~MultiFlowScenario() {}
+
+void MultiFlowScenario::SetUpFlow(size_t index,
+                                  const FlowParams& flow_params) {
+  Flow& flow = flows_[index];
+  const std::string sender_name = absl::StrCat("Sender", index + 1);
+  const std::string receiver_name = absl::StrCat("Receiver", index + 1);
+  flow.sender = std::make_unique<QuicEndpoint>(
+      &simulator_, sender_name, receiver_name, Perspective::IS_CLIENT,
+      test::TestConnectionId(42 + index));
+  flow.receiver = std::make_unique<QuicEndpoint>(
+      &simulator_, receiver_name, sender_name, Perspective::IS_SERVER,
+      test::TestConnectionId(42 + index));
+
+  QUIC_LOG_IF(WARNING, flow_params.rtt < 2 * params_.bottleneck_delay)
+      << "RTT of flow " << index << " is shorter than the bottleneck link";
+  const QuicTime::Delta access_delay =
+      std::max(QuicTime::Delta::Zero(),
+               QuicTime::Delta::FromMicroseconds(
+                   flow_params.rtt.ToMicroseconds() / 2) -
+                   params_.bottleneck_delay);
+  flow.access_link = std::make_unique<SymmetricLink>(
+      flow.sender.get(), switch_->port(index + 2), access_bandwidth_,
+      access_delay);
+
+  QuicConnection* connection = flow.sender->connection();
+  QuicSentPacketManager* sent_packet_manager =
+      test::QuicConnectionPeer::GetSentPacketManager(connection);
+  // Ownership of the send algorithm is taken by the sent packet manager.
+  SendAlgorithmInterface* send_algorithm = SendAlgorithmInterface::Create(
+      connection->clock(), sent_packet_manager->GetRttStats(),
+      &sent_packet_manager->unacked_packets(),
+      flow_params.congestion_control_type, &random_,
+      test::QuicConnectionPeer::GetStats(connection),
+      kInitialCongestionWindow, nullptr);
+  if (!flow_params.connection_options.empty()) {
+    QuicConfig config;
+    test::QuicConfigPeer::SetReceivedConnectionOptions(
+        &config, flow_params.connection_options);
+    send_algorithm->SetFromConfig(config, Perspective::IS_SERVER);
+  }
+  sent_packet_manager->SetSendAlgorithm(send_algorithm);
+}
+
+void MultiFlowScenario::StartFlow(size_t index) {
+  const QuicByteCount bytes = params_.flows[index].bytes_to_transfer;
+  // A bulk flow can't send more than its access link carries.
+  flows_[index].sender->AddBytesToTransfer(
+      bytes > 0 ? bytes : access_bandwidth_ * params_.duration);
+}
+
+void MultiFlowScenario::StartMeasurement() {
+  measuring_ = true;
+  for (Flow& flow : flows_) {
+    flow.bytes_received_at_warmup = flow.receiver->bytes_received();
+  }
+}
+
+void MultiFlowScenario::RunUntil(QuicTime time) {
+  auto has_pending_finite_flows = [this]() {
+    for (size_t i = 0; i < flows_.size(); ++i) {
+      if (params_.flows[i].bytes_to_transfer > 0 &&
+          !flows_[i].completion_time.has_value()) {
+        return true;
+      }
+    }
+    return false;
+  };
+
+  while (simulator_.GetClock()->Now() < time) {
+    const QuicTime now = simulator_.GetClock()->Now();
+    if (!has_pending_finite_flows()) {
+      simulator_.RunFor(time - now);
+      return;
+    }
+    simulator_.RunFor(std::min(time - now, kCompletionCheckInterval));
+    for (size_t i = 0; i < flows_.size(); ++i) {
+      const FlowParams& flow_params = params_.flows[i];
+      Flow& flow = flows_[i];
+      if (flow_params.bytes_to_transfer > 0 &&
+          !flow.completion_time.has_value() &&
+          flow.receiver->bytes_received() >= flow_params.bytes_to_transfer) {
+        flow.completion_time = simulator_.GetClock()->Now() - start_time_ -
+                               flow_params.start_time;
+      }
+    }
+  }
+}
+
+MultiFlowScenario::Results MultiFlowScenario::Run() {
+  // Flows are started and the measurement period begins in time order.  The
+  // measurement starts before flows starting at the same time.
+  std::multimap<QuicTime::Delta, int> events;
+  events.emplace(std::min(params_.warmup, params_.duration), -1);
+  for (size_t i = 0; i < params_.flows.size(); ++i) {
+    if (params_.flows[i].start_time < params_.duration) {
+      events.emplace(params_.flows[i].start_time, i);
+    }
+  }
+  for (const auto& event : events) {
+    RunUntil(start_time_ + event.first);
+    if (event.second < 0) {
+      StartMeasurement();
+    } else {
+      StartFlow(event.second);
+    }
+  }
+  RunUntil(start_time_ + params_.duration);
+  return CollectResults();
+}
+
+MultiFlowScenario::Results MultiFlowScenario::CollectResults() {
+  Results results;
+  results.name = params_.name;
+  results.random_seed = params_.random_seed;
+  results.queueing_delay = queueing_delay_;
+
+  const QuicTime::Delta measurement_time =
+      params_.duration - std::min(params_.warmup, params_.duration);
+  std::vector<double> goodputs;
+  QuicByteCount total_bytes_sent = 0;
+  QuicByteCount total_bytes_retransmitted = 0;
+  for (size_t i = 0; i < flows_.size(); ++i) {
+    const Flow& flow = flows_[i];
+    const QuicConnectionStats& stats = flow.sender->connection()->GetStats();
+    FlowResult flow_result;
+    flow_result.congestion_control_type =
+        params_.flows[i].congestion_control_type;
+    flow_result.bytes_received = flow.receiver->bytes_received();
+    if (!measurement_time.IsZero()) {
+      flow_result.goodput = QuicBandwidth::FromBytesAndTimeDelta(
+          flow_result.bytes_received - flow.bytes_received_at_warmup,
+          measurement_time);
+    }
+    flow_result.retransmission_rate =
+        Ratio(stats.bytes_retransmitted, stats.bytes_sent);
+    const RttStats* rtt_stats =
+        flow.sender->connection()->sent_packet_manager().GetRttStats();
+    flow_result.min_rtt = rtt_stats->min_rtt();
+    flow_result.smoothed_rtt = rtt_stats->smoothed_rtt();
+    flow_result.completion_time = flow.completion_time;
+
+    goodputs.push_back(flow_result.goodput.ToBitsPerSecond());
+    results.throughput = results.throughput + flow_result.goodput;
+    total_bytes_sent += stats.bytes_sent;
+    total_bytes_retransmitted += stats.bytes_retransmitted;
+    results.flows.push_back(flow_result);
+  }
+  results.jain_fairness = JainFairnessIndex(goodputs);
+  results.utilization = Ratio(results.throughput.ToBitsPerSecond(),
+                              params_.bottleneck_bandwidth.ToBitsPerSecond());
+  results.retransmission_rate =
+      Ratio(total_bytes_retransmitted, total_bytes_sent);
+  return results;
+}
+
+// static
+std::vector<MultiFlowScenario::Results> MultiFlowScenario::RunInParallel(
+    const std::vector<Params>& params,
+    int num_threads) {
+  // Flags are only read by the threads.
+  RaiseMaxTrackedPacketCount();
+
+  std::vector<Results> results(params.size());
+  std::atomic<size_t> next_scenario(0);
+  std::vector<std::unique_ptr<ScenarioThread>> threads;
+  const size_t thread_count =
+      std::min(params.size(), static_cast<size_t>(std::max(num_threads, 1)));
+  for (size_t i = 0; i < thread_count; ++i) {
+    threads.push_back(
+        std::make_unique<ScenarioThread>(&params, &results, &next_scenario));
+    threads.back()->Start();
+  }
+  for (auto& thread : threads) {
+    thread->Join();
+  }
+  return results;
+}
+
+// static
+double MultiFlowScenario::JainFairnessIndex(const std::vector<double>& values) {
+  double sum = 0;
+  double sum_of_squares = 0;
+  for (double value : values) {
+    sum += value;
+    sum_of_squares += value * value;
+  }
+  if (sum_of_squares == 0) {
+    return 0.0;
+  }
+  return sum * sum / (values.size() * sum_of_squares);
+}
+
+std::string MultiFlowScenario::Results::ToJson() const {
+  std::string json = absl::StrFormat(
+      "{\"name\":\"%s\",\"random_seed\":%d,\"jain_fairness\":%.4f,"
+      "\"throughput_bps\":%d,\"utilization\":%.4f,"
+      "\"queueing_delay_p50_us\":%d,\"queueing_delay_p99_us\":%d,"
+      "\"queueing_delay_max_us\":%d,\"retransmission_rate\":%.6f,"
+      "\"flows\":[",
+      name, random_seed, jain_fairness, throughput.ToBitsPerSecond(),
+      utilization, queueing_delay.Percentile(50).ToMicroseconds(),
+      queueing_delay.Percentile(99).ToMicroseconds(),
+      queueing_delay.max().ToMicroseconds(), retransmission_rate);
+  for (size_t i = 0; i < flows.size(); ++i) {
+    const FlowResult& flow = flows[i];
+    absl::StrAppendFormat(
+        &json,
+        "%s{\"congestion_control\":\"%s\",\"goodput_bps\":%d,"
+        "\"bytes_received\":%d,\"retransmission_rate\":%.6f,"
+        "\"min_rtt_us\":%d,\"smoothed_rtt_us\":%d",
+        i == 0 ? "" : ",",
+        CongestionControlTypeName(flow.congestion_control_type),
+        flow.goodput.ToBitsPerSecond(), flow.bytes_received,
+        flow.retransmission_rate, flow.min_rtt.ToMicroseconds(),
+        flow.smoothed_rtt.ToMicroseconds());
+    if (flow.completion_time.has_value()) {
+      absl::StrAppendFormat(&json, ",\"completion_time_us\":%d",
+                            flow.completion_time->ToMicroseconds());
+    }
+    absl::StrAppend(&json, "}");
+  }
+  absl::StrAppend(&json, "]}");
+  return json;
+}
+
+std::ostream& operator<<(std::ostream& os,
+                         const MultiFlowScenario::Results& results) {
+  os << results.name << ": throughput " << results.throughput
+     << ", utilization " << results.utilization << ", Jain fairness "
+     << results.jain_fairness << ", queueing delay p50 "
+     << results.queueing_delay.Percentile(50) << " p99 "
+     << results.queueing_delay.Percentile(99) << ", retransmission rate "
+     << results.retransmission_rate << "\n";
+  for (size_t i = 0; i < results.flows.size(); ++i) {
+    const MultiFlowScenario::FlowResult& flow = results.flows[i];
+    os << "  flow " << i + 1 << " ("
+       << CongestionControlTypeName(flow.congestion_control_type)
+       << "): goodput " << flow.goodput << ", retransmission rate "
+       << flow.retransmission_rate << ", min RTT " << flow.min_rtt
+       << ", smoothed RTT " << flow.smoothed_rtt;
+    if (flow.completion_time.has_value()) {
+      os << ", completed in " << *flow.completion_time;
+    }
+    os << "\n";
+  }
+  return os;
+}
+
+}  // namespace simulator
+}  // namespace quic
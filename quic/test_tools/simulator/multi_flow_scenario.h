@@ -0,0 +1,221 @@
+// Copyright (c) 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef QUICHE_QUIC_TEST_TOOLS_SIMULATOR_MULTI_FLOW_SCENARIO_H_
+#define QUICHE_QUIC_TEST_TOOLS_SIMULATOR_MULTI_FLOW_SCENARIO_H_
+
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "absl/types/optional.h"
+#include "quic/core/quic_bandwidth.h"
+#include "quic/core/quic_latency_histogram.h"
+#include "quic/core/quic_tag.h"
+#include "quic/core/quic_time.h"
+#include "quic/core/quic_types.h"
+#include "quic/test_tools/quic_test_utils.h"
+#include "quic/test_tools/simulator/link.h"
+#include "quic/test_tools/simulator/queue.h"
+#include "quic/test_tools/simulator/quic_endpoint.h"
+#include "quic/test_tools/simulator/random_loss_filter.h"
+#include "quic/test_tools/simulator/simulator.h"
+#include "quic/test_tools/simulator/switch.h"
+#include "quic/test_tools/simulator/traffic_policer.h"
+
+namespace quic {
+namespace simulator {
+
+// Runs a number of bulk or finite QUIC flows with possibly different
+// congestion controllers and RTTs through a single bottleneck, and measures
+// how fairly and efficiently they share it.  The topology is:
+//
+//   Sender 1 ---+
+//               |    access links, one per flow, with the delay
+//   Sender 2 ---+    set by the RTT of the flow
+//      ...      |
+//   Sender N ---+
+//               |
+//             Switch  <-- bottleneck queue, buffer_size_in_bdp BDPs
+//               |
+//          [ Policer ]  <-- optional
+//               |
+//        [ Random loss ]  <-- optional, loss_probability
+//               |
+//               |  <-- bottleneck link
+//               |
+//   Receivers 1 to N
+//
+// Only data packets are policed and lost; ACKs are passed through.
+//
+// For example, to compare BBRv2 with Cubic on a shallow buffer:
+//
+//   MultiFlowScenario::Params params;
+//   params.name = "bbr2_vs_cubic";
+//   params.buffer_size_in_bdp = 0.5;
+//   params.flows.resize(2);
+//   params.flows[0].congestion_control_type = kBBRv2;
+//   params.flows[1].congestion_control_type = kCubicBytes;
+//   MultiFlowScenario::Results results = MultiFlowScenario(params).Run();
+//   std::cout << results.ToJson() << std::endl;
+class MultiFlowScenario {
+ public:
+  struct FlowParams {
+    CongestionControlType congestion_control_type = kBBRv2;
+    // Applied to the congestion controller as if received from the peer.
+    QuicTagVector connection_options;
+    // Round trip propagation delay.  Must be at least twice the bottleneck
+    // link delay.
+    QuicTime::Delta rtt = QuicTime::Delta::FromMilliseconds(40);
+    // When the flow starts sending, relative to the start of the scenario.
+    QuicTime::Delta start_time = QuicTime::Delta::Zero();
+    // Bytes to send.  If zero, the flow sends as fast as it can until the end
+    // of the scenario.
+    QuicByteCount bytes_to_transfer = 0;
+  };
+
+  // The policer has a token bucket per receiver, so each flow is policed to
+  // |target_bandwidth| separately.
+  struct PolicerParams {
+    QuicBandwidth target_bandwidth = QuicBandwidth::Zero();
+    QuicByteCount bucket_size = 0;
+  };
+
+  struct Params {
+    std::string name = "scenario";
+    std::vector<FlowParams> flows;
+    QuicBandwidth bottleneck_bandwidth =
+        QuicBandwidth::FromKBitsPerSecond(20 * 1000);
+    // One way delay of the bottleneck link.
+    QuicTime::Delta bottleneck_delay = QuicTime::Delta::FromMilliseconds(5);
+    // Bandwidth of the access links.  If zero, ten times the bottleneck
+    // bandwidth.
+    QuicBandwidth access_bandwidth = QuicBandwidth::Zero();
+    // Size of the bottleneck queue, in BDPs of the bottleneck bandwidth and
+    // the shortest flow RTT.
+    double buffer_size_in_bdp = 1.0;
+    absl::optional<PolicerParams> policer;
+    // Probability that a data packet is lost after the bottleneck queue.
+    double loss_probability = 0.0;
+    QuicTime::Delta duration = QuicTime::Delta::FromSeconds(30);
+    // Throughput and queueing delay are only measured after this, so that
+    // startup doesn't skew the steady state results.
+    QuicTime::Delta warmup = QuicTime::Delta::FromSeconds(5);
+    // Seed of the simulator's random generator.  Runs with the same
+    // parameters and seed have the same results.
+    uint64_t random_seed = 1;
+  };
+
+  struct FlowResult {
+    CongestionControlType congestion_control_type = kBBRv2;
+    // Stream bytes received during the measurement period, i.e. after the
+    // warmup, per second.
+    QuicBandwidth goodput = QuicBandwidth::Zero();
+    // Stream bytes received over the whole scenario.
+    QuicByteCount bytes_received = 0;
+    // Bytes retransmitted divided by bytes sent.
+    double retransmission_rate = 0.0;
+    QuicTime::Delta min_rtt = QuicTime::Delta::Zero();
+    QuicTime::Delta smoothed_rtt = QuicTime::Delta::Zero();
+    // Time from the start of a finite flow to the receipt of its last byte,
+    // if it completed.
+    absl::optional<QuicTime::Delta> completion_time;
+  };
+
+  struct Results {
+    std::string name;
+    uint64_t random_seed = 0;
+    std::vector<FlowResult> flows;
+    // Jain's fairness index of the goodputs of the flows, from 1/N when one
+    // flow gets all the bandwidth to 1 when all get the same.
+    double jain_fairness = 0.0;
+    // Sum of the goodputs, and its ratio to the bottleneck bandwidth.
+    QuicBandwidth throughput = QuicBandwidth::Zero();
+    double utilization = 0.0;
+    // Time packets leaving the bottleneck queue during the measurement period
+    // spent in it.
+    QuicLatencyHistogram queueing_delay;
+    // Bytes retransmitted by all flows divided by bytes sent.
+    double retransmission_rate = 0.0;
+
+    // Returns the results as a single line JSON object, with bandwidths in
+    // bits per second and durations in microseconds.
+    std::string ToJson() const;
+  };
+
+  explicit MultiFlowScenario(const Params& params);
+  MultiFlowScenario(const MultiFlowScenario&) = delete;
+  MultiFlowScenario& operator=(const MultiFlowScenario&) = delete;
+  ~MultiFlowScenario();
+
+  // Runs the scenario for params.duration.  May only be called once.
+  Results Run();
+
+  // Runs a scenario for each element of |params| on |num_threads| threads,
+  // and returns their results in the same order.  Scenarios share no state,
+  // so the results are the same as if they were run one after the other.
+  static std::vector<Results> RunInParallel(const std::vector<Params>& params,
+                                            int num_threads);
+
+  // Returns Jain's fairness index of |values|, (sum x)^2 / (n * sum x^2), or
+  // zero if all values are zero.
+  static double JainFairnessIndex(const std::vector<double>& values);
+
+  Simulator* simulator() { return &simulator_; }
+  Queue* bottleneck_queue() { return switch_->port_queue(1); }
+
+ private:
+  // Records the queueing delay of each packet leaving the bottleneck queue.
+  class QueueMonitor : public Queue::ListenerInterface {
+   public:
+    explicit QueueMonitor(MultiFlowScenario* scenario);
+
+    void OnPacketDequeued() override;
+
+   private:
+    MultiFlowScenario* scenario_;
+  };
+
+  struct Flow {
+    std::unique_ptr<QuicEndpoint> sender;
+    std::unique_ptr<QuicEndpoint> receiver;
+    std::unique_ptr<SymmetricLink> access_link;
+    // Bytes received at the start of the measurement period.
+    QuicByteCount bytes_received_at_warmup = 0;
+    absl::optional<QuicTime::Delta> completion_time;
+  };
+
+  void SetUpFlow(size_t index, const FlowParams& flow_params);
+  void StartFlow(size_t index);
+  void StartMeasurement();
+  // Runs the simulation until |time|, noting when finite flows complete.
+  void RunUntil(QuicTime time);
+  Results CollectResults();
+
+  const Params params_;
+  test::SimpleRandom random_;
+  Simulator simulator_;
+  const QuicTime start_time_;
+  const QuicBandwidth access_bandwidth_;
+  bool measuring_;
+
+  std::unique_ptr<Switch> switch_;
+  std::vector<Flow> flows_;
+  std::unique_ptr<TrafficPolicer> policer_;
+  std::unique_ptr<RandomLossFilter> loss_filter_;
+  std::unique_ptr<QuicEndpointMultiplexer> receiver_multiplexer_;
+  std::unique_ptr<SymmetricLink> bottleneck_link_;
+  QueueMonitor queue_monitor_;
+  QuicLatencyHistogram queueing_delay_;
+};
+
+std::ostream& operator<<(std::ostream& os,
+                         const MultiFlowScenario::Results& results);
+
+}  // namespace simulator
+}  // namespace quic
+
+#endif  // QUICHE_QUIC_TEST_TOOLS_SIMULATOR_MULTI_FLOW_SCENARIO_H_
@@ -0,0 +1,223 @@
+// Copyright (c) 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Runs MultiFlowScenarios for every combination of the buffer sizes, loss
+// probabilities and random seeds given on the command line, and prints the
+// results of each as a line of JSON, to compare congestion controllers on
+// the QUIC simulator.
+//
+// Some usage examples:
+//
+// BBRv2 against Cubic, on shallow and deep buffers:
+//   multi_flow_scenario --congestion_control=bbr2,cubic
+//       --buffer_size_in_bdp=0.5,1,4,16
+//
+// Four BBRv3 flows with a mix of RTTs, under random loss:
+//   multi_flow_scenario --congestion_control=bbr3,bbr3,bbr3,bbr3
+//       --rtt_ms=10,40,80,160 --loss_probability=0,0.001,0.01
+//
+// Each flow policed to 10 Mbit/s on a 20 Mbit/s bottleneck, with 5 seeds run
+// on 5 threads:
+//   multi_flow_scenario --congestion_control=bbr2,bbr2 --policer_mbps=10
+//       --seeds=5 --threads=5
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_split.h"
+#include "quic/core/quic_tag.h"
+#include "quic/platform/api/quic_flags.h"
+#include "quic/test_tools/simulator/multi_flow_scenario.h"
+
+DEFINE_QUIC_COMMAND_LINE_FLAG(
+    std::string,
+    congestion_control,
+    "bbr2,cubic",
+    "Comma separated congestion controllers of the flows, one per flow: "
+    "cubic, reno, bbr, bbr2 or bbr3.");
+
+DEFINE_QUIC_COMMAND_LINE_FLAG(
+    std::string,
+    rtt_ms,
+    "40",
+    "Comma separated round trip propagation delays of the flows, in "
+    "milliseconds. If there are fewer than flows, the last one is repeated.");
+
+DEFINE_QUIC_COMMAND_LINE_FLAG(
+    std::string,
+    connection_options,
+    "",
+    "Connection options applied to the congestion controllers of all flows, "
+    "as ASCII tags separated by commas, e.g. \"BBQ1,B2HR\"");
+
+DEFINE_QUIC_COMMAND_LINE_FLAG(int32_t,
+                              bottleneck_mbps,
+                              20,
+                              "Bottleneck bandwidth in Mbit/s.");
+
+DEFINE_QUIC_COMMAND_LINE_FLAG(int32_t,
+                              bottleneck_delay_ms,
+                              5,
+                              "One way delay of the bottleneck link.");
+
+DEFINE_QUIC_COMMAND_LINE_FLAG(
+    std::string,
+    buffer_size_in_bdp,
+    "1",
+    "Comma separated bottleneck buffer sizes to run, in BDPs of the shortest "
+    "RTT.");
+
+DEFINE_QUIC_COMMAND_LINE_FLAG(
+    std::string,
+    loss_probability,
+    "0",
+    "Comma separated probabilities of random loss at the bottleneck to run.");
+
+DEFINE_QUIC_COMMAND_LINE_FLAG(
+    int32_t,
+    policer_mbps,
+    0,
+    "If non-zero, each flow is policed to this many Mbit/s.");
+
+DEFINE_QUIC_COMMAND_LINE_FLAG(int32_t,
+                              duration_seconds,
+                              30,
+                              "Simulated duration of each scenario.");
+
+DEFINE_QUIC_COMMAND_LINE_FLAG(
+    int32_t,
+    warmup_seconds,
+    5,
+    "Simulated time after which throughput and queueing delay are measured.");
+
+DEFINE_QUIC_COMMAND_LINE_FLAG(int32_t,
+                              seeds,
+                              1,
+                              "Number of random seeds to run each scenario "
+                              "with, starting at 1.");
+
+DEFINE_QUIC_COMMAND_LINE_FLAG(int32_t,
+                              threads,
+                              1,
+                              "Number of scenarios run in parallel.");
+
+namespace {
+
+bool ParseCongestionControl(const std::string& name,
+                            quic::CongestionControlType* type) {
+  if (name == "cubic") {
+    *type = quic::kCubicBytes;
+  } else if (name == "reno") {
+    *type = quic::kRenoBytes;
+  } else if (name == "bbr") {
+    *type = quic::kBBR;
+  } else if (name == "bbr2") {
+    *type = quic::kBBRv2;
+  } else if (name == "bbr3") {
+    *type = quic::kBBRv3;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+bool ParseDoubles(const std::string& list, std::vector<double>* values) {
+  for (absl::string_view item : absl::StrSplit(list, ',')) {
+    double value;
+    if (!absl::SimpleAtod(item, &value)) {
+      return false;
+    }
+    values->push_back(value);
+  }
+  return !values->empty();
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  const char* usage = "Usage: multi_flow_scenario [options]";
+  std::vector<std::string> non_option_args =
+      quic::QuicParseCommandLineFlags(usage, argc, argv);
+  if (!non_option_args.empty()) {
+    quic::QuicPrintCommandLineFlagHelp(usage);
+    exit(0);
+  }
+
+  std::vector<double> rtts_ms;
+  std::vector<double> buffer_sizes;
+  std::vector<double> loss_probabilities;
+  if (!ParseDoubles(GetQuicFlag(FLAGS_rtt_ms), &rtts_ms) ||
+      !ParseDoubles(GetQuicFlag(FLAGS_buffer_size_in_bdp), &buffer_sizes) ||
+      !ParseDoubles(GetQuicFlag(FLAGS_loss_probability),
+                    &loss_probabilities)) {
+    std::cerr << "Invalid number list" << std::endl;
+    return 1;
+  }
+
+  quic::QuicTagVector connection_options;
+  const std::string connection_options_string =
+      GetQuicFlag(FLAGS_connection_options);
+  if (!connection_options_string.empty()) {
+    connection_options = quic::ParseQuicTagVector(connection_options_string);
+  }
+
+  quic::simulator::MultiFlowScenario::Params base_params;
+  std::vector<std::string> congestion_controls =
+      absl::StrSplit(GetQuicFlag(FLAGS_congestion_control), ',');
+  for (size_t i = 0; i < congestion_controls.size(); ++i) {
+    quic::simulator::MultiFlowScenario::FlowParams flow;
+    if (!ParseCongestionControl(congestion_controls[i],
+                                &flow.congestion_control_type)) {
+      std::cerr << "Unknown congestion control: " << congestion_controls[i]
+                << std::endl;
+      return 1;
+    }
+    flow.rtt = quic::QuicTime::Delta::FromMicroseconds(
+        1000 * rtts_ms[std::min(i, rtts_ms.size() - 1)]);
+    flow.connection_options = connection_options;
+    base_params.flows.push_back(flow);
+  }
+  base_params.bottleneck_bandwidth = quic::QuicBandwidth::FromKBitsPerSecond(
+      1000 * GetQuicFlag(FLAGS_bottleneck_mbps));
+  base_params.bottleneck_delay = quic::QuicTime::Delta::FromMilliseconds(
+      GetQuicFlag(FLAGS_bottleneck_delay_ms));
+  if (GetQuicFlag(FLAGS_policer_mbps) > 0) {
+    quic::simulator::MultiFlowScenario::PolicerParams policer;
+    policer.target_bandwidth = quic::QuicBandwidth::FromKBitsPerSecond(
+        1000 * GetQuicFlag(FLAGS_policer_mbps));
+    // One RTT worth of tokens at the policed rate.
+    policer.bucket_size =
+        policer.target_bandwidth * base_params.flows.front().rtt;
+    base_params.policer = policer;
+  }
+  base_params.duration = quic::QuicTime::Delta::FromSeconds(
+      GetQuicFlag(FLAGS_duration_seconds));
+  base_params.warmup = quic::QuicTime::Delta::FromSeconds(
+      GetQuicFlag(FLAGS_warmup_seconds));
+
+  std::vector<quic::simulator::MultiFlowScenario::Params> scenarios;
+  for (double buffer_size : buffer_sizes) {
+    for (double loss_probability : loss_probabilities) {
+      for (int seed = 1; seed <= GetQuicFlag(FLAGS_seeds); ++seed) {
+        quic::simulator::MultiFlowScenario::Params params = base_params;
+        params.name =
+            absl::StrCat(GetQuicFlag(FLAGS_congestion_control), "/buffer_",
+                         buffer_size, "/loss_", loss_probability);
+        params.buffer_size_in_bdp = buffer_size;
+        params.loss_probability = loss_probability;
+        params.random_seed = seed;
+        scenarios.push_back(params);
+      }
+    }
+  }
+  for (const auto& results : quic::simulator::MultiFlowScenario::RunInParallel(
+           scenarios, GetQuicFlag(FLAGS_threads))) {
+    std::cout << results.ToJson() << std::endl;
+  }
+  return 0;
+}
@@ -0,0 +1,178 @@
+// Copyright (c) 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "quic/test_tools/simulator/multi_flow_scenario.h"
+
+#include "quic/platform/api/quic_logging.h"
+#include "quic/platform/api/quic_test.h"
+
+namespace quic {
+namespace simulator {
+namespace {
+
+const QuicBandwidth kBottleneckBandwidth =
+    QuicBandwidth::FromKBitsPerSecond(10 * 1000);
+
+class MultiFlowScenarioTest : public QuicTest {
+ protected:
+  MultiFlowScenarioTest() {
+    params_.bottleneck_bandwidth = kBottleneckBandwidth;
+    params_.duration = QuicTime::Delta::FromSeconds(20);
+    params_.warmup = QuicTime::Delta::FromSeconds(5);
+  }
+
+  void AddFlow(CongestionControlType congestion_control_type,
+               QuicTime::Delta rtt = QuicTime::Delta::FromMilliseconds(40)) {
+    MultiFlowScenario::FlowParams flow;
+    flow.congestion_control_type = congestion_control_type;
+    flow.rtt = rtt;
+    params_.flows.push_back(flow);
+  }
+
+  MultiFlowScenario::Results Run() {
+    MultiFlowScenario scenario(params_);
+    MultiFlowScenario::Results results = scenario.Run();
+    QUIC_LOG(INFO) << results;
+    QUIC_LOG(INFO) << results.ToJson();
+    return results;
+  }
+
+  MultiFlowScenario::Params params_;
+};
+
+TEST_F(MultiFlowScenarioTest, JainFairnessIndex) {
+  EXPECT_EQ(0.0, MultiFlowScenario::JainFairnessIndex({}));
+  EXPECT_EQ(0.0, MultiFlowScenario::JainFairnessIndex({0, 0}));
+  EXPECT_DOUBLE_EQ(1.0, MultiFlowScenario::JainFairnessIndex({5, 5, 5}));
+  EXPECT_DOUBLE_EQ(0.25, MultiFlowScenario::JainFairnessIndex({7, 0, 0, 0}));
+  EXPECT_DOUBLE_EQ(0.9, MultiFlowScenario::JainFairnessIndex({1, 2}));
+}
+
+TEST_F(MultiFlowScenarioTest, SingleFlowFillsBottleneck) {
+  AddFlow(kBBRv2);
+  MultiFlowScenario::Results results = Run();
+  ASSERT_EQ(1u, results.flows.size());
+  EXPECT_DOUBLE_EQ(1.0, results.jain_fairness);
+  EXPECT_GT(results.utilization, 0.9);
+  EXPECT_LE(results.utilization, 1.0);
+  EXPECT_LT(results.retransmission_rate, 0.01);
+  EXPECT_FALSE(results.queueing_delay.empty());
+  // BBRv2 keeps the queue well below the buffer size of one BDP.
+  EXPECT_LT(results.queueing_delay.Percentile(99),
+            QuicTime::Delta::FromMilliseconds(40));
+}
+
+TEST_F(MultiFlowScenarioTest, FlowsWithSameRttShareFairly) {
+  for (int i = 0; i < 4; ++i) {
+    AddFlow(kBBRv2);
+  }
+  MultiFlowScenario::Results results = Run();
+  ASSERT_EQ(4u, results.flows.size());
+  EXPECT_GT(results.jain_fairness, 0.9);
+  EXPECT_GT(results.utilization, 0.9);
+}
+
+TEST_F(MultiFlowScenarioTest, LateFlowAndFiniteFlow) {
+  AddFlow(kCubicBytes);
+  MultiFlowScenario::FlowParams finite_flow;
+  finite_flow.congestion_control_type = kBBRv2;
+  finite_flow.start_time = QuicTime::Delta::FromSeconds(2);
+  finite_flow.bytes_to_transfer = 1024 * 1024;
+  params_.flows.push_back(finite_flow);
+
+  MultiFlowScenario::Results results = Run();
+  ASSERT_EQ(2u, results.flows.size());
+  EXPECT_FALSE(results.flows[0].completion_time.has_value());
+  ASSERT_TRUE(results.flows[1].completion_time.has_value());
+  EXPECT_EQ(1024u * 1024u, results.flows[1].bytes_received);
+  // The finite flow completed before the measurement period, so the bulk flow
+  // has the bottleneck to itself afterwards.
+  EXPECT_LT(*results.flows[1].completion_time,
+            params_.warmup - finite_flow.start_time);
+  EXPECT_TRUE(results.flows[1].goodput.IsZero());
+  EXPECT_GT(results.utilization, 0.9);
+}
+
+TEST_F(MultiFlowScenarioTest, RandomLoss) {
+  AddFlow(kBBRv2);
+  params_.loss_probability = 0.01;
+  MultiFlowScenario::Results results = Run();
+  EXPECT_GT(results.retransmission_rate, 0.005);
+  EXPECT_LT(results.retransmission_rate, 0.02);
+  // BBRv2 tolerates 1% random loss.
+  EXPECT_GT(results.utilization, 0.8);
+}
+
+TEST_F(MultiFlowScenarioTest, Policer) {
+  AddFlow(kBBRv2);
+  MultiFlowScenario::PolicerParams policer;
+  policer.target_bandwidth = kBottleneckBandwidth * 0.5;
+  policer.bucket_size = 100 * 1000;
+  params_.policer = policer;
+  MultiFlowScenario::Results results = Run();
+  EXPECT_LT(results.throughput, kBottleneckBandwidth * 0.55);
+  EXPECT_GT(results.throughput, kBottleneckBandwidth * 0.4);
+}
+
+TEST_F(MultiFlowScenarioTest, Deterministic) {
+  AddFlow(kBBRv2);
+  AddFlow(kCubicBytes, QuicTime::Delta::FromMilliseconds(80));
+  params_.loss_probability = 0.001;
+  params_.duration = QuicTime::Delta::FromSeconds(8);
+  params_.warmup = QuicTime::Delta::FromSeconds(2);
+  const std::string first = Run().ToJson();
+  EXPECT_EQ(first, Run().ToJson());
+
+  params_.random_seed = 2;
+  EXPECT_NE(first, Run().ToJson());
+}
+
+TEST_F(MultiFlowScenarioTest, RunInParallel) {
+  AddFlow(kBBRv2);
+  AddFlow(kCubicBytes);
+  params_.loss_probability = 0.001;
+  params_.duration = QuicTime::Delta::FromSeconds(4);
+  params_.warmup = QuicTime::Delta::FromSeconds(1);
+  std::vector<MultiFlowScenario::Params> scenarios;
+  for (uint64_t seed = 1; seed <= 3; ++seed) {
+    params_.random_seed = seed;
+    scenarios.push_back(params_);
+  }
+
+  std::vector<MultiFlowScenario::Results> results =
+      MultiFlowScenario::RunInParallel(scenarios, 2);
+  ASSERT_EQ(scenarios.size(), results.size());
+  for (size_t i = 0; i < scenarios.size(); ++i) {
+    EXPECT_EQ(MultiFlowScenario(scenarios[i]).Run().ToJson(),
+              results[i].ToJson());
+  }
+}
+
+TEST_F(MultiFlowScenarioTest, ToJson) {
+  MultiFlowScenario::Results results;
+  results.name = "test";
+  results.random_seed = 7;
+  results.jain_fairness = 0.5;
+  results.throughput = QuicBandwidth::FromBitsPerSecond(1000);
+  results.queueing_delay.Add(QuicTime::Delta::FromMicroseconds(5));
+  MultiFlowScenario::FlowResult flow;
+  flow.congestion_control_type = kCubicBytes;
+  flow.goodput = QuicBandwidth::FromBitsPerSecond(1000);
+  flow.bytes_received = 3000;
+  flow.completion_time = QuicTime::Delta::FromMilliseconds(2);
+  results.flows.push_back(flow);
+  EXPECT_EQ(
+      "{\"name\":\"test\",\"random_seed\":7,\"jain_fairness\":0.5000,"
+      "\"throughput_bps\":1000,\"utilization\":0.0000,"
+      "\"queueing_delay_p50_us\":5,\"queueing_delay_p99_us\":5,"
+      "\"queueing_delay_max_us\":5,\"retransmission_rate\":0.000000,"
+      "\"flows\":[{\"congestion_control\":\"cubic\",\"goodput_bps\":1000,"
+      "\"bytes_received\":3000,\"retransmission_rate\":0.000000,"
+      "\"min_rtt_us\":0,\"smoothed_rtt_us\":0,\"completion_time_us\":2000}]}",
+      results.ToJson());
+}
+
+}  // namespace
+}  // namespace simulator
+}  // namespace quic
@@ -21,6 +21,7 @@ Queue::Queue(Simulator* simulator, std::string name, QuicByteCount capacity)
       current_bundle_(0),
       current_bundle_bytes_(0),
       tx_port_(nullptr),
+      last_dequeued_packet_delay_(QuicTime::Delta::Zero()),
       listener_(nullptr) {
   aggregation_timeout_alarm_.reset(simulator_->GetAlarmFactory()->CreateAlarm(
       new AggregationAlarmDelegate(this)));
@@ -43,7 +44,7 @@ void Queue::AcceptPacket(std::unique_ptr<Packet> packet) {
   }
 
   bytes_queued_ += packet->size;
-  queue_.emplace_back(std::move(packet), current_bundle_);
+  queue_.emplace_back(std::move(packet), current_bundle_, clock_->Now());
 
   if (IsAggregationEnabled()) {
     current_bundle_bytes_ += queue_.front().packet->size;
@@ -63,6 +64,7 @@ void Queue::Act() {
   if (tx_port_->TimeUntilAvailable().IsZero()) {
     QUICHE_DCHECK(bytes_queued_ >= queue_.front().packet->size);
     bytes_queued_ -= queue_.front().packet->size;
+    last_dequeued_packet_delay_ = clock_->Now() - queue_.front().enqueue_time;
 
     tx_port_->AcceptPacket(std::move(queue_.front().packet));
     queue_.pop_front();
@@ -94,8 +96,9 @@ void Queue::AggregationAlarmDelegate::OnAlarm() {
 }
 
 Queue::EnqueuedPacket::EnqueuedPacket(std::unique_ptr<Packet> packet,
-                                      AggregationBundleNumber bundle)
-    : packet(std::move(packet)), bundle(bundle) {}
+                                      AggregationBundleNumber bundle,
+                                      QuicTime enqueue_time)
+    : packet(std::move(packet)), bundle(bundle), enqueue_time(enqueue_time) {}
 
 Queue::EnqueuedPacket::EnqueuedPacket(EnqueuedPacket&& other) = default;
 
@@ -38,6 +38,11 @@ class Queue : public Actor, public UnconstrainedPortInterface {
   inline QuicByteCount capacity() const { return capacity_; }
   inline QuicByteCount bytes_queued() const { return bytes_queued_; }
   inline QuicPacketCount packets_queued() const { return queue_.size(); }
+  // Time the most recently dequeued packet spent in the queue.  Meant to be
+  // read from ListenerInterface::OnPacketDequeued().
+  inline QuicTime::Delta last_dequeued_packet_delay() const {
+    return last_dequeued_packet_delay_;
+  }
 
   inline void set_listener_interface(ListenerInterface* listener) {
     listener_ = listener;
@@ -64,12 +69,14 @@ class Queue : public Actor, public UnconstrainedPortInterface {
   // outside of the current bundle are allowed to leave the queue.
   struct EnqueuedPacket {
     EnqueuedPacket(std::unique_ptr<Packet> packet,
-                   AggregationBundleNumber bundle);
+                   AggregationBundleNumber bundle,
+                   QuicTime enqueue_time);
     EnqueuedPacket(EnqueuedPacket&& other);
     ~EnqueuedPacket();
 
     std::unique_ptr<Packet> packet;
     AggregationBundleNumber bundle;
+    QuicTime enqueue_time;
   };
 
   // Alarm handler for aggregation timeout.
@@ -111,6 +118,7 @@ class Queue : public Actor, public UnconstrainedPortInterface {
 
   ConstrainedPortInterface* tx_port_;
   quiche::QuicheCircularDeque<EnqueuedPacket> queue_;
+  QuicTime::Delta last_dequeued_packet_delay_;
 
   ListenerInterface* listener_;
 };
@@ -94,6 +94,7 @@ void QuicEndpointBase::AcceptPacket(std::unique_ptr<Packet> packet) {
   }
   if (drop_next_packet_) {
     drop_next_packet_ = false;
+    simulator_->ReleasePacket(std::move(packet));
     return;
   }
 
@@ -101,6 +102,7 @@ void QuicEndpointBase::AcceptPacket(std::unique_ptr<Packet> packet) {
                                      packet->contents.size(), clock_->Now());
   connection_->ProcessUdpPacket(connection_->self_address(),
                                 connection_->peer_address(), received_packet);
+  simulator_->ReleasePacket(std::move(packet));
 }
 
 UnconstrainedPortInterface* QuicEndpointBase::GetRxPort() {
@@ -133,7 +135,7 @@ WriteResult QuicEndpointBase::Writer::WritePacket(
     const QuicSocketAddress& /*peer_address*/,
     PerPacketOptions* options) {
   QUICHE_DCHECK(!IsWriteBlocked());
-  QUICHE_DCHECK(options == nullptr);
+  QUICHE_DCHECK(options == nullptr || options->release_time_delay.IsZero());
   QUICHE_DCHECK(buf_len <= kMaxOutgoingPacketSize);
 
   // Instead of losing a packet, become write-blocked when the egress queue is
@@ -144,12 +146,12 @@ WriteResult QuicEndpointBase::Writer::WritePacket(
     return WriteResult(WRITE_STATUS_BLOCKED, 0);
   }
 
-  auto packet = std::make_unique<Packet>();
+  std::unique_ptr<Packet> packet = endpoint_->simulator()->NewPacket();
   packet->source = endpoint_->name();
   packet->destination = endpoint_->peer_name_;
   packet->tx_timestamp = endpoint_->clock_->Now();
 
-  packet->contents = std::string(buffer, buf_len);
+  packet->contents.assign(buffer, buf_len);
   packet->size = buf_len;
 
   endpoint_->nic_tx_queue_.AcceptPacket(std::move(packet));
@@ -0,0 +1,39 @@
+// Copyright (c) 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "quic/test_tools/simulator/random_loss_filter.h"
+
+#include <limits>
+
+#include "quic/test_tools/simulator/simulator.h"
+
+namespace quic {
+namespace simulator {
+
+RandomLossFilter::RandomLossFilter(Simulator* simulator,
+                                   std::string name,
+                                   Endpoint* input,
+                                   double loss_probability)
+    : PacketFilter(simulator, name, input),
+      loss_probability_(loss_probability),
+      packets_dropped_(0) {}
+
+RandomLossFilter::~RandomLossFilter() {}
+
+bool RandomLossFilter::FilterPacket(const Packet& /*packet*/) {
+  if (loss_probability_ <= 0) {
+    return true;
+  }
+  const double random =
+      static_cast<double>(simulator_->GetRandomGenerator()->RandUint64()) /
+      std::numeric_limits<uint64_t>::max();
+  if (random < loss_probability_) {
+    ++packets_dropped_;
+    return false;
+  }
+  return true;
+}
+
+}  // namespace simulator
+}  // namespace quic
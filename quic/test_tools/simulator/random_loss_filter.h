@@ -0,0 +1,42 @@
+// Copyright (c) 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef QUICHE_QUIC_TEST_TOOLS_SIMULATOR_RANDOM_LOSS_FILTER_H_
+#define QUICHE_QUIC_TEST_TOOLS_SIMULATOR_RANDOM_LOSS_FILTER_H_
+
+#include <cstdint>
+
+#include "quic/test_tools/simulator/packet_filter.h"
+
+namespace quic {
+namespace simulator {
+
+// Drops each packet passing from the input to the output independently with
+// probability |loss_probability|, using the simulator's random generator, to
+// model non-congestive loss such as wireless corruption.
+class RandomLossFilter : public PacketFilter {
+ public:
+  RandomLossFilter(Simulator* simulator,
+                   std::string name,
+                   Endpoint* input,
+                   double loss_probability);
+  RandomLossFilter(const RandomLossFilter&) = delete;
+  RandomLossFilter& operator=(const RandomLossFilter&) = delete;
+  ~RandomLossFilter() override;
+
+  double loss_probability() const { return loss_probability_; }
+  uint64_t packets_dropped() const { return packets_dropped_; }
+
+ protected:
+  bool FilterPacket(const Packet& packet) override;
+
+ private:
+  const double loss_probability_;
+  uint64_t packets_dropped_;
+};
+
+}  // namespace simulator
+}  // namespace quic
+
+#endif  // QUICHE_QUIC_TEST_TOOLS_SIMULATOR_RANDOM_LOSS_FILTER_H_
@@ -16,7 +16,8 @@ Simulator::Simulator(QuicRandom* random_generator)
     : random_generator_(random_generator),
       alarm_factory_(this, "Default Alarm Manager"),
       run_for_should_stop_(false),
-      enable_random_delays_(false) {
+      enable_random_delays_(false),
+      next_sequence_(0) {
   run_for_alarm_.reset(
       alarm_factory_.CreateAlarm(new RunForDelegate(&run_for_should_stop_)));
 }
@@ -42,63 +43,111 @@ QuicWallTime Simulator::Clock::WallNow() const {
       (now_ - QuicTime::Zero()).ToMicroseconds());
 }
 
+namespace {
+
+// Maximum number of packets kept by Simulator::ReleasePacket() for reuse.
+const size_t kMaxPooledPackets = 4096;
+
+}  // namespace
+
 void Simulator::AddActor(Actor* actor) {
-  auto emplace_times_result =
-      scheduled_times_.insert(std::make_pair(actor, QuicTime::Infinite()));
   auto emplace_names_result = actor_names_.insert(actor->name());
 
-  // Ensure that the object was actually placed into the map.
-  QUICHE_DCHECK(emplace_times_result.second);
+  // Ensure that the object was actually placed into the set.
   QUICHE_DCHECK(emplace_names_result.second);
+  QUICHE_DCHECK_EQ(actor->schedule_index_, Actor::kNotScheduled);
 }
 
 void Simulator::RemoveActor(Actor* actor) {
-  auto scheduled_time_it = scheduled_times_.find(actor);
   auto actor_names_it = actor_names_.find(actor->name());
-  QUICHE_DCHECK(scheduled_time_it != scheduled_times_.end());
   QUICHE_DCHECK(actor_names_it != actor_names_.end());
 
-  QuicTime scheduled_time = scheduled_time_it->second;
-  if (scheduled_time != QuicTime::Infinite()) {
+  if (actor->schedule_index_ != Actor::kNotScheduled) {
     Unschedule(actor);
   }
 
-  scheduled_times_.erase(scheduled_time_it);
   actor_names_.erase(actor_names_it);
 }
 
 void Simulator::Schedule(Actor* actor, QuicTime new_time) {
-  auto scheduled_time_it = scheduled_times_.find(actor);
-  QUICHE_DCHECK(scheduled_time_it != scheduled_times_.end());
-  QuicTime scheduled_time = scheduled_time_it->second;
-
-  if (scheduled_time <= new_time) {
+  const size_t index = actor->schedule_index_;
+  if (index != Actor::kNotScheduled) {
+    if (schedule_[index].time <= new_time) {
+      return;
+    }
+    // Moving an actor to an earlier time keeps it in the heap, but it goes
+    // after the actors already scheduled for |new_time|.
+    schedule_[index].time = new_time;
+    schedule_[index].sequence = next_sequence_++;
+    SiftUp(index);
     return;
   }
 
-  if (scheduled_time != QuicTime::Infinite()) {
-    Unschedule(actor);
-  }
-
-  scheduled_time_it->second = new_time;
-  schedule_.insert(std::make_pair(new_time, actor));
+  schedule_.push_back({new_time, next_sequence_++, actor});
+  actor->schedule_index_ = schedule_.size() - 1;
+  SiftUp(schedule_.size() - 1);
 }
 
 void Simulator::Unschedule(Actor* actor) {
-  auto scheduled_time_it = scheduled_times_.find(actor);
-  QUICHE_DCHECK(scheduled_time_it != scheduled_times_.end());
-  QuicTime scheduled_time = scheduled_time_it->second;
-
-  QUICHE_DCHECK(scheduled_time != QuicTime::Infinite());
-  auto range = schedule_.equal_range(scheduled_time);
-  for (auto it = range.first; it != range.second; ++it) {
-    if (it->second == actor) {
-      schedule_.erase(it);
-      scheduled_time_it->second = QuicTime::Infinite();
-      return;
+  QUICHE_DCHECK_NE(actor->schedule_index_, Actor::kNotScheduled);
+  QUICHE_DCHECK_EQ(schedule_[actor->schedule_index_].actor, actor);
+  RemoveFromSchedule(actor->schedule_index_);
+}
+
+void Simulator::PlaceInSchedule(size_t index, const ScheduledActor& entry) {
+  schedule_[index] = entry;
+  entry.actor->schedule_index_ = index;
+}
+
+void Simulator::SiftUp(size_t index) {
+  const ScheduledActor entry = schedule_[index];
+  while (index > 0) {
+    const size_t parent = (index - 1) / 2;
+    if (!(entry < schedule_[parent])) {
+      break;
     }
+    PlaceInSchedule(index, schedule_[parent]);
+    index = parent;
   }
-  QUICHE_DCHECK(false);
+  PlaceInSchedule(index, entry);
+}
+
+void Simulator::SiftDown(size_t index) {
+  const ScheduledActor entry = schedule_[index];
+  const size_t size = schedule_.size();
+  while (true) {
+    size_t child = 2 * index + 1;
+    if (child >= size) {
+      break;
+    }
+    if (child + 1 < size && schedule_[child + 1] < schedule_[child]) {
+      ++child;
+    }
+    if (!(schedule_[child] < entry)) {
+      break;
+    }
+    PlaceInSchedule(index, schedule_[child]);
+    index = child;
+  }
+  PlaceInSchedule(index, entry);
+}
+
+void Simulator::RemoveFromSchedule(size_t index) {
+  schedule_[index].actor->schedule_index_ = Actor::kNotScheduled;
+  const size_t last = schedule_.size() - 1;
+  if (index != last) {
+    const ScheduledActor moved = schedule_[last];
+    schedule_.pop_back();
+    PlaceInSchedule(index, moved);
+    // The entry moved from the end may belong either above or below |index|.
+    if (index > 0 && moved < schedule_[(index - 1) / 2]) {
+      SiftUp(index);
+    } else {
+      SiftDown(index);
+    }
+    return;
+  }
+  schedule_.pop_back();
 }
 
 const QuicClock* Simulator::GetClock() const {
@@ -121,6 +170,21 @@ QuicAlarmFactory* Simulator::GetAlarmFactory() {
   return &alarm_factory_;
 }
 
+std::unique_ptr<Packet> Simulator::NewPacket() {
+  if (packet_pool_.empty()) {
+    return std::make_unique<Packet>();
+  }
+  std::unique_ptr<Packet> packet = std::move(packet_pool_.back());
+  packet_pool_.pop_back();
+  return packet;
+}
+
+void Simulator::ReleasePacket(std::unique_ptr<Packet> packet) {
+  if (packet_pool_.size() < kMaxPooledPackets) {
+    packet_pool_.push_back(std::move(packet));
+  }
+}
+
 Simulator::RunForDelegate::RunForDelegate(bool* run_for_should_stop)
     : run_for_should_stop_(run_for_should_stop) {}
 
@@ -146,13 +210,12 @@ void Simulator::RunFor(QuicTime::Delta time_span) {
 }
 
 void Simulator::HandleNextScheduledActor() {
-  const auto current_event_it = schedule_.begin();
-  QuicTime event_time = current_event_it->first;
-  Actor* actor = current_event_it->second;
+  QuicTime event_time = schedule_.front().time;
+  Actor* actor = schedule_.front().actor;
   QUIC_DVLOG(3) << "At t = " << event_time.ToDebuggingValue() << ", calling "
                 << actor->name();
 
-  Unschedule(actor);
+  RemoveFromSchedule(0);
 
   if (clock_.Now() > event_time) {
     QUIC_BUG(quic_bug_10150_1)
@@ -5,9 +5,10 @@
 #ifndef QUICHE_QUIC_TEST_TOOLS_SIMULATOR_SIMULATOR_H_
 #define QUICHE_QUIC_TEST_TOOLS_SIMULATOR_SIMULATOR_H_
 
-#include <map>
+#include <cstdint>
+#include <memory>
+#include <vector>
 
-#include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "quic/core/quic_connection.h"
 #include "quic/core/quic_simple_buffer_allocator.h"
@@ -15,6 +16,7 @@
 #include "quic/platform/api/quic_containers.h"
 #include "quic/test_tools/simulator/actor.h"
 #include "quic/test_tools/simulator/alarm_factory.h"
+#include "quic/test_tools/simulator/port.h"
 
 namespace quic {
 namespace simulator {
@@ -47,6 +49,13 @@ class Simulator : public QuicConnectionHelperInterface {
 
   QuicAlarmFactory* GetAlarmFactory();
 
+  // Returns a packet for the caller to fill in, reusing one released by
+  // ReleasePacket() if possible, so that its strings keep their capacity and
+  // sending a packet usually needs no allocation.
+  std::unique_ptr<Packet> NewPacket();
+  // Returns a packet which has reached its destination to the pool.
+  void ReleasePacket(std::unique_ptr<Packet> packet);
+
   inline void set_random_generator(QuicRandom* random) {
     random_generator_ = random;
   }
@@ -108,6 +117,26 @@ class Simulator : public QuicConnectionHelperInterface {
   // notifies the actor.
   void HandleNextScheduledActor();
 
+  // An entry of the schedule.  Actors scheduled for the same time are ordered
+  // by |sequence|, i.e. in the order they were scheduled.
+  struct ScheduledActor {
+    QuicTime time;
+    uint64_t sequence;
+    Actor* actor;
+
+    bool operator<(const ScheduledActor& other) const {
+      return time < other.time ||
+             (time == other.time && sequence < other.sequence);
+    }
+  };
+
+  // Helpers maintaining the heap property of |schedule_| and the
+  // schedule_index_ of the actors in it.
+  void PlaceInSchedule(size_t index, const ScheduledActor& entry);
+  void SiftUp(size_t index);
+  void SiftDown(size_t index);
+  void RemoveFromSchedule(size_t index);
+
   Clock clock_;
   QuicRandom* random_generator_;
   SimpleBufferAllocator buffer_allocator_;
@@ -122,18 +151,22 @@ class Simulator : public QuicConnectionHelperInterface {
   // order to avoid synchronization issues.
   bool enable_random_delays_;
 
-  // Schedule of when the actors will be executed via an Act() call.  The
+  // Schedule of when the actors will be executed via an Act() call, as a
+  // binary min-heap.  Each scheduled actor knows its index in the heap, so
+  // that it can be rescheduled or unscheduled in logarithmic time.  The
   // schedule is subject to the following invariants:
   // - An actor cannot be scheduled for a later time than it's currently in the
   //   schedule.
   // - An actor is removed from schedule either immediately before Act() is
   //   called or by explicitly calling Unschedule().
-  // - Each Actor appears in the map at most once.
-  std::multimap<QuicTime, Actor*> schedule_;
-  // For each actor, maintain the time it is scheduled at.  The value for
-  // unscheduled actors is QuicTime::Infinite().
-  absl::flat_hash_map<Actor*, QuicTime> scheduled_times_;
+  // - Each Actor appears in the heap at most once.
+  std::vector<ScheduledActor> schedule_;
+  // Sequence number of the next actor scheduled.
+  uint64_t next_sequence_;
   absl::flat_hash_set<std::string> actor_names_;
+
+  // Packets released by the endpoints, to be reused by NewPacket().
+  std::vector<std::unique_ptr<Packet>> packet_pool_;
 };
 
 template <class TerminationPredicate>
@@ -4,9 +4,14 @@
 
 #include "quic/test_tools/simulator/simulator.h"
 
+#include <algorithm>
+#include <memory>
+#include <string>
 #include <utility>
+#include <vector>
 
 #include "absl/container/node_hash_map.h"
+#include "absl/strings/str_cat.h"
 #include "quic/platform/api/quic_containers.h"
 #include "quic/platform/api/quic_logging.h"
 #include "quic/platform/api/quic_test.h"
@@ -360,6 +365,48 @@ TEST_F(SimulatorTest, OnePacketQueue) {
   ASSERT_EQ(packets_received, counter.packets());
 }
 
+// Records the time each packet leaving the queue has spent in it.
+class QueueDelayRecorder : public Queue::ListenerInterface {
+ public:
+  explicit QueueDelayRecorder(Queue* queue) : queue_(queue) {}
+
+  void OnPacketDequeued() override {
+    delays_.push_back(queue_->last_dequeued_packet_delay());
+  }
+
+  const std::vector<QuicTime::Delta>& delays() const { return delays_; }
+
+ private:
+  Queue* queue_;
+  std::vector<QuicTime::Delta> delays_;
+};
+
+// Verify that the queue reports the time packets have spent waiting for the
+// link, rather than the time needed to drain what is left behind them.
+TEST_F(SimulatorTest, QueueDelay) {
+  const QuicBandwidth bandwidth = QuicBandwidth::FromKBytesPerSecond(1000);
+  Simulator simulator;
+  Queue queue(&simulator, "Queue", 10000);
+  CounterPort counter;
+  OneWayLink link(&simulator, "Link", &counter, bandwidth,
+                  QuicTime::Delta::FromMilliseconds(1));
+  queue.set_tx_port(&link);
+  QueueDelayRecorder recorder(&queue);
+  queue.set_listener_interface(&recorder);
+
+  for (int i = 0; i < 3; ++i) {
+    auto packet = std::make_unique<Packet>();
+    packet->size = 1000;
+    queue.AcceptPacket(std::move(packet));
+  }
+  simulator.RunUntil([]() { return false; });
+
+  ASSERT_EQ(3u, recorder.delays().size());
+  EXPECT_EQ(QuicTime::Delta::Zero(), recorder.delays()[0]);
+  EXPECT_EQ(bandwidth.TransferTime(1000), recorder.delays()[1]);
+  EXPECT_EQ(bandwidth.TransferTime(2000), recorder.delays()[2]);
+}
+
 // Simulate a network where three endpoints are connected to a switch and they
 // are sending traffic in circle (1 -> 2, 2 -> 3, 3 -> 1).
 TEST_F(SimulatorTest, SwitchedNetwork) {
@@ -592,6 +639,96 @@ TEST_F(SimulatorTest, RunFor) {
   EXPECT_EQ(33, counter.get_value());
 }
 
+// An actor which records the order in which actors act.
+class OrderRecorder : public Actor {
+ public:
+  OrderRecorder(Simulator* simulator,
+                std::string name,
+                std::vector<std::string>* order)
+      : Actor(simulator, name), order_(order) {}
+
+  void Act() override { order_->push_back(name_); }
+
+  using Actor::Schedule;
+  using Actor::Unschedule;
+
+ private:
+  std::vector<std::string>* order_;
+};
+
+// Actors scheduled for the same time act in the order they were scheduled,
+// and rescheduling only ever moves an actor to an earlier time.
+TEST_F(SimulatorTest, ScheduleOrder) {
+  Simulator simulator;
+  std::vector<std::string> order;
+  OrderRecorder a(&simulator, "a", &order);
+  OrderRecorder b(&simulator, "b", &order);
+  OrderRecorder c(&simulator, "c", &order);
+  OrderRecorder d(&simulator, "d", &order);
+  const QuicTime start = simulator.GetClock()->Now();
+  const QuicTime::Delta second = QuicTime::Delta::FromSeconds(1);
+
+  a.Schedule(start + 2 * second);
+  b.Schedule(start + 2 * second);
+  c.Schedule(start + 3 * second);
+  d.Schedule(start + second);
+  // Ignored, since |b| is already scheduled for an earlier time.
+  b.Schedule(start + 4 * second);
+  // Moves |c| after |a| and |b|.
+  c.Schedule(start + 2 * second);
+  d.Unschedule();
+
+  simulator.RunFor(5 * second);
+  EXPECT_EQ((std::vector<std::string>{"a", "b", "c"}), order);
+}
+
+// Many actors scheduled and unscheduled at random act in time order.
+TEST_F(SimulatorTest, ScheduleManyActors) {
+  test::SimpleRandom random;
+  Simulator simulator(&random);
+  std::vector<std::string> order;
+  std::vector<std::unique_ptr<OrderRecorder>> actors;
+  std::vector<std::pair<QuicTime, std::string>> expected;
+  const QuicTime start = simulator.GetClock()->Now();
+  for (int i = 0; i < 1000; ++i) {
+    actors.push_back(std::make_unique<OrderRecorder>(
+        &simulator, absl::StrCat("actor", i), &order));
+    const QuicTime time =
+        start + QuicTime::Delta::FromMicroseconds(1 + random.RandUint64() % 50);
+    actors.back()->Schedule(time);
+    if (i % 3 == 0) {
+      actors.back()->Unschedule();
+    } else {
+      expected.emplace_back(time, actors.back()->name());
+    }
+  }
+  std::stable_sort(expected.begin(), expected.end(),
+                   [](const std::pair<QuicTime, std::string>& lhs,
+                      const std::pair<QuicTime, std::string>& rhs) {
+                     return lhs.first < rhs.first;
+                   });
+
+  simulator.RunFor(QuicTime::Delta::FromMilliseconds(1));
+  ASSERT_EQ(expected.size(), order.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    EXPECT_EQ(expected[i].second, order[i]);
+  }
+}
+
+TEST_F(SimulatorTest, PacketPool) {
+  Simulator simulator;
+  std::unique_ptr<Packet> packet = simulator.NewPacket();
+  packet->contents = std::string(1000, 'a');
+  Packet* const packet_pointer = packet.get();
+  simulator.ReleasePacket(std::move(packet));
+
+  packet = simulator.NewPacket();
+  EXPECT_EQ(packet_pointer, packet.get());
+  EXPECT_GE(packet->contents.capacity(), 1000u);
+  // The pool is empty again.
+  EXPECT_NE(packet_pointer, simulator.NewPacket().get());
+}
+
 class MockPacketFilter : public PacketFilter {
  public:
   MockPacketFilter(Simulator* simulator, std::string name, Endpoint* endpoint)
@@ -5,7 +5,11 @@
 #ifndef QUICHE_QUIC_TOOLS_QUIC_BACKEND_RESPONSE_H_
 #define QUICHE_QUIC_TOOLS_QUIC_BACKEND_RESPONSE_H_
 
+#include <memory>
+#include <utility>
+
 #include "absl/strings/string_view.h"
+#include "quic/tools/quic_mapped_file.h"
 #include "quic/tools/quic_url.h"
 #include "spdy/core/spdy_protocol.h"
 
@@ -57,7 +61,15 @@ class QuicBackendResponse {
   SpecialResponseType response_type() const { return response_type_; }
   const spdy::Http2HeaderBlock& headers() const { return headers_; }
   const spdy::Http2HeaderBlock& trailers() const { return trailers_; }
-  const absl::string_view body() const { return absl::string_view(body_); }
+  const absl::string_view body() const {
+    return mapped_body_file_ != nullptr ? mapped_body_
+                                        : absl::string_view(body_);
+  }
+  // The file the body is mapped from, or nullptr if the body is held in
+  // memory.
+  const QuicMappedFile* mapped_body_file() const {
+    return mapped_body_file_.get();
+  }
 
   void AddEarlyHints(const spdy::Http2HeaderBlock& headers) {
     spdy::Http2HeaderBlock hints = headers.Clone();
@@ -78,6 +90,13 @@ class QuicBackendResponse {
   void set_body(absl::string_view body) {
     body_.assign(body.data(), body.size());
   }
+  // Sets the body to |body|, which must be a part of |file|.  The body is not
+  // copied, the response holds a reference to |file| instead.
+  void set_mapped_body(std::shared_ptr<const QuicMappedFile> file,
+                       absl::string_view body) {
+    mapped_body_file_ = std::move(file);
+    mapped_body_ = body;
+  }
 
  private:
   std::vector<spdy::Http2HeaderBlock> early_hints_;
@@ -85,6 +104,8 @@ class QuicBackendResponse {
   spdy::Http2HeaderBlock headers_;
   spdy::Http2HeaderBlock trailers_;
   std::string body_;
+  std::shared_ptr<const QuicMappedFile> mapped_body_file_;
+  absl::string_view mapped_body_;
 };
 
 }  // namespace quic
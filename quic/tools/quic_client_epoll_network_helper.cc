@@ -222,6 +222,7 @@ int QuicClientEpollNetworkHelper::CreateUDPSocket(
 
   *overflow_supported = api.EnableDroppedPacketCount(fd);
   api.EnableReceiveTimestamp(fd);
+  api.EnableReceiveEcn(fd, server_address.host().AddressFamilyToInt());
   return fd;
 }
 }  // namespace quic
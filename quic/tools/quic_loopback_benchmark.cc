@@ -0,0 +1,404 @@
+// Copyright (c) 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "quic/tools/quic_loopback_benchmark.h"
+
+#include <sys/resource.h>
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/str_cat.h"
+#include "quic/core/batch_writer/quic_batch_writer_buffer.h"
+#include "quic/core/batch_writer/quic_gso_batch_writer.h"
+#include "quic/core/batch_writer/quic_sendmmsg_batch_writer.h"
+#include "quic/core/batch_writer/quic_zero_copy_batch_writer.h"
+#include "quic/core/crypto/quic_crypto_server_config.h"
+#include "quic/core/http/quic_spdy_client_stream.h"
+#include "quic/core/quic_config.h"
+#include "quic/core/quic_connection_stats.h"
+#include "quic/core/quic_constants.h"
+#include "quic/core/quic_error_codes.h"
+#include "quic/core/quic_packet_writer.h"
+#include "quic/core/quic_server_id.h"
+#include "quic/platform/api/quic_epoll.h"
+#include "quic/platform/api/quic_ip_address.h"
+#include "quic/platform/api/quic_logging.h"
+#include "quic/platform/api/quic_socket_address.h"
+#include "quic/test_tools/crypto_test_utils.h"
+#include "quic/test_tools/server_thread.h"
+#include "quic/tools/fake_proof_verifier.h"
+#include "quic/tools/quic_client.h"
+#include "quic/tools/quic_memory_cache_backend.h"
+#include "quic/tools/quic_server.h"
+#include "net/quic/platform/impl/quic_epoll_clock.h"
+
+namespace quic {
+
+namespace {
+
+const char kServerHostname[] = "test.example.com";
+const char kPath[] = "/benchmark";
+
+using Options = QuicLoopbackBenchmark::Options;
+using Results = QuicLoopbackBenchmark::Results;
+using ServerWriter = QuicLoopbackBenchmark::ServerWriter;
+
+// A QuicServer which writes packets using the writer selected in the options.
+class BenchmarkServer : public QuicServer {
+ public:
+  BenchmarkServer(std::unique_ptr<ProofSource> proof_source,
+                  const QuicConfig& config,
+                  const ParsedQuicVersionVector& supported_versions,
+                  QuicSimpleServerBackend* backend,
+                  ServerWriter writer)
+      : QuicServer(std::move(proof_source),
+                   config,
+                   QuicCryptoServerConfig::ConfigOptions(),
+                   supported_versions,
+                   backend,
+                   kQuicDefaultConnectionIdLength),
+        writer_(writer) {
+    set_use_io_uring(writer == ServerWriter::kIoUring);
+  }
+
+ protected:
+  QuicPacketWriter* CreateWriter(int fd) override {
+    switch (writer_) {
+      case ServerWriter::kDefault:
+        break;
+      case ServerWriter::kSendmmsg:
+        return new QuicSendmmsgBatchWriter(
+            std::make_unique<QuicBatchWriterBuffer>(), fd);
+      case ServerWriter::kGso:
+        return new QuicGsoBatchWriter(fd);
+      case ServerWriter::kIoUring:
+        // Only reached if io_uring is unavailable.
+        break;
+      case ServerWriter::kZeroCopy: {
+        auto* writer = new QuicZeroCopyBatchWriter(fd);
+        if (!writer->Initialize()) {
+          QUIC_LOG(WARNING) << "SO_ZEROCOPY unavailable, copying all sends";
+        }
+        return writer;
+      }
+    }
+    return QuicServer::CreateWriter(fd);
+  }
+
+ private:
+  const ServerWriter writer_;
+};
+
+// The state of one client connection.
+struct BenchmarkConnection {
+  std::unique_ptr<QuicClient> client;
+  QuicTime connect_start = QuicTime::Zero();
+  bool handshake_confirmed = false;
+  int requests_sent = 0;
+  // Send times of outstanding requests, keyed by stream ID.
+  absl::flat_hash_map<QuicStreamId, QuicTime> outstanding_requests;
+  // Set if a response was incomplete or not a 200.
+  std::string response_error;
+};
+
+// Records the latency and size of every complete response of a connection.
+class ResponseRecorder : public QuicSpdyClientBase::ResponseListener {
+ public:
+  ResponseRecorder(const QuicClock* clock,
+                   QuicByteCount expected_body_size,
+                   BenchmarkConnection* connection,
+                   Results* results)
+      : clock_(clock),
+        expected_body_size_(expected_body_size),
+        connection_(connection),
+        results_(results) {}
+
+  void OnCompleteResponse(QuicStreamId id,
+                          const spdy::Http2HeaderBlock& response_headers,
+                          const std::string& response_body) override {
+    auto it = connection_->outstanding_requests.find(id);
+    if (it == connection_->outstanding_requests.end()) {
+      return;
+    }
+    results_->request_latency.Add(clock_->Now() - it->second);
+    connection_->outstanding_requests.erase(it);
+    ++results_->requests_completed;
+    results_->body_bytes_received += response_body.size();
+
+    auto status = response_headers.find(":status");
+    if (status == response_headers.end() || status->second != "200") {
+      connection_->response_error =
+          absl::StrCat("Unexpected response headers on stream ", id, ": ",
+                       response_headers.DebugString());
+    } else if (response_body.size() != expected_body_size_) {
+      connection_->response_error =
+          absl::StrCat("Stream ", id, " received ", response_body.size(),
+                       " body bytes, expected ", expected_body_size_);
+    }
+  }
+
+ private:
+  const QuicClock* clock_;
+  const QuicByteCount expected_body_size_;
+  BenchmarkConnection* connection_;
+  Results* results_;
+};
+
+void SetFlowControlWindows(const Options& options, QuicConfig* config) {
+  if (options.stream_flow_control_window > 0) {
+    config->SetInitialStreamFlowControlWindowToSend(
+        options.stream_flow_control_window);
+  }
+  if (options.session_flow_control_window > 0) {
+    config->SetInitialSessionFlowControlWindowToSend(
+        options.session_flow_control_window);
+  }
+}
+
+QuicTime::Delta GetProcessCpuTime() {
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) {
+    return QuicTime::Delta::Zero();
+  }
+  return QuicTime::Delta::FromMicroseconds(
+      (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * kNumMicrosPerSecond +
+      usage.ru_utime.tv_usec + usage.ru_stime.tv_usec);
+}
+
+// Returns false and sets |error_details| if |connection| has failed.
+bool CheckConnection(const BenchmarkConnection& connection,
+                     std::string* error_details) {
+  if (!connection.response_error.empty()) {
+    *error_details = connection.response_error;
+    return false;
+  }
+  if (!connection.client->connected()) {
+    *error_details = absl::StrCat(
+        "Connection closed with error: ",
+        QuicErrorCodeToString(connection.client->session()->error()), " ",
+        connection.client->session()->error_details());
+    return false;
+  }
+  return true;
+}
+
+// Connects all clients to |server_address| and runs the requests, all on the
+// current thread.  Process CPU time is sampled here rather than in
+// QuicLoopbackBenchmark::Run() so that server startup is not included.
+bool RunClients(const Options& options,
+                const QuicSocketAddress& server_address,
+                Results* results,
+                std::string* error_details) {
+  QuicEpollServer epoll_server;
+  epoll_server.set_timeout_in_us(50 * 1000);
+  QuicEpollClock clock(&epoll_server);
+  const QuicTime start = clock.Now();
+  const QuicTime::Delta cpu_start = GetProcessCpuTime();
+
+  QuicConfig config;
+  SetFlowControlWindows(options, &config);
+  config.SetConnectionOptionsToSend(options.connection_options);
+
+  std::vector<std::unique_ptr<BenchmarkConnection>> connections;
+  for (int i = 0; i < options.num_connections; ++i) {
+    auto connection = std::make_unique<BenchmarkConnection>();
+    connection->client = std::make_unique<QuicClient>(
+        server_address,
+        QuicServerId(kServerHostname, server_address.port(), false),
+        ParsedQuicVersionVector{options.version}, config, &epoll_server,
+        std::make_unique<FakeProofVerifier>(), nullptr);
+    connection->client->set_response_listener(
+        std::make_unique<ResponseRecorder>(&clock, options.response_size,
+                                           connection.get(), results));
+    if (!connection->client->Initialize()) {
+      *error_details = "Failed to initialize client";
+      return false;
+    }
+    connections.push_back(std::move(connection));
+  }
+
+  const QuicTime handshake_start = clock.Now();
+  const QuicTime deadline = handshake_start + options.timeout;
+  for (auto& connection : connections) {
+    connection->connect_start = clock.Now();
+    connection->client->StartConnect();
+  }
+
+  while (results->handshakes_completed < options.num_connections) {
+    if (clock.Now() > deadline) {
+      *error_details = "Timed out waiting for handshakes";
+      return false;
+    }
+    epoll_server.WaitForEventsAndExecuteCallbacks();
+    for (auto& connection : connections) {
+      if (connection->handshake_confirmed) {
+        continue;
+      }
+      if (!CheckConnection(*connection, error_details)) {
+        return false;
+      }
+      if (connection->client->session()->GetHandshakeState() >=
+          HANDSHAKE_CONFIRMED) {
+        connection->handshake_confirmed = true;
+        results->handshake_latency.Add(clock.Now() -
+                                       connection->connect_start);
+        ++results->handshakes_completed;
+      }
+    }
+  }
+  results->handshake_time = clock.Now() - handshake_start;
+
+  spdy::Http2HeaderBlock headers;
+  headers[":method"] = "GET";
+  headers[":scheme"] = "https";
+  headers[":authority"] = kServerHostname;
+  headers[":path"] = kPath;
+
+  const uint64_t total_requests = static_cast<uint64_t>(
+                                      options.num_connections) *
+                                  options.requests_per_connection;
+  const QuicTime transfer_start = clock.Now();
+  while (results->requests_completed < total_requests) {
+    for (auto& connection : connections) {
+      while (connection->requests_sent < options.requests_per_connection &&
+             connection->outstanding_requests.size() <
+                 static_cast<size_t>(
+                     options.concurrent_streams_per_connection)) {
+        QuicSpdyClientStream* stream =
+            connection->client->CreateClientStream();
+        if (stream == nullptr) {
+          // Blocked by the peer's stream limit.
+          break;
+        }
+        connection->outstanding_requests.emplace(stream->id(), clock.Now());
+        ++connection->requests_sent;
+        stream->SendRequest(headers.Clone(), "", /*fin=*/true);
+      }
+    }
+    if (clock.Now() > deadline) {
+      *error_details = absl::StrCat("Timed out after ",
+                                    results->requests_completed, " of ",
+                                    total_requests, " requests");
+      return false;
+    }
+    epoll_server.WaitForEventsAndExecuteCallbacks();
+    for (auto& connection : connections) {
+      if (!CheckConnection(*connection, error_details)) {
+        return false;
+      }
+    }
+  }
+  if (total_requests > 0) {
+    results->transfer_time = clock.Now() - transfer_start;
+  }
+
+  for (auto& connection : connections) {
+    const QuicConnectionStats& stats =
+        connection->client->client_session()->connection()->GetStats();
+    results->bytes_received += stats.bytes_received;
+    results->packets_received += stats.packets_received;
+    connection->client->Disconnect();
+  }
+  results->total_time = clock.Now() - start;
+  results->cpu_time = GetProcessCpuTime() - cpu_start;
+  return true;
+}
+
+double PerSecond(double count, QuicTime::Delta time) {
+  return time.IsZero() ? 0 : count / time.ToMicroseconds() * 1e6;
+}
+
+}  // namespace
+
+double QuicLoopbackBenchmark::Results::HandshakesPerSecond() const {
+  return PerSecond(handshakes_completed, handshake_time);
+}
+
+double QuicLoopbackBenchmark::Results::RequestsPerSecond() const {
+  return PerSecond(requests_completed, transfer_time);
+}
+
+double QuicLoopbackBenchmark::Results::GoodputBitsPerSecond() const {
+  return PerSecond(body_bytes_received * 8.0, transfer_time);
+}
+
+double QuicLoopbackBenchmark::Results::CpuNanosPerByte() const {
+  return body_bytes_received == 0
+             ? 0
+             : cpu_time.ToMicroseconds() * 1000.0 / body_bytes_received;
+}
+
+double QuicLoopbackBenchmark::Results::CpuMillisPerGigabit() const {
+  return body_bytes_received == 0
+             ? 0
+             : cpu_time.ToMicroseconds() / 1000.0 /
+                   (body_bytes_received * 8.0 / 1e9);
+}
+
+double QuicLoopbackBenchmark::Results::CpuNanosPerPacket() const {
+  return packets_received == 0
+             ? 0
+             : cpu_time.ToMicroseconds() * 1000.0 / packets_received;
+}
+
+QuicLoopbackBenchmark::QuicLoopbackBenchmark(const Options& options)
+    : options_(options) {}
+
+bool QuicLoopbackBenchmark::Run(Results* results, std::string* error_details) {
+  *results = Results();
+  QuicEnableVersion(options_.version);
+
+  QuicMemoryCacheBackend backend;
+  backend.AddSimpleResponse(kServerHostname, kPath, 200,
+                            std::string(options_.response_size, 'a'));
+
+  QuicConfig server_config;
+  SetFlowControlWindows(options_, &server_config);
+  test::ServerThread server_thread(
+      new BenchmarkServer(test::crypto_test_utils::ProofSourceForTesting(),
+                          server_config, {options_.version}, &backend,
+                          options_.server_writer),
+      QuicSocketAddress(QuicIpAddress::Loopback4(), 0));
+  server_thread.Initialize();
+  if (server_thread.GetPort() == 0) {
+    *error_details = "Failed to start the server";
+    return false;
+  }
+  server_thread.Start();
+
+  const bool success = RunClients(
+      options_,
+      QuicSocketAddress(QuicIpAddress::Loopback4(), server_thread.GetPort()),
+      results, error_details);
+
+  server_thread.Quit();
+  server_thread.Join();
+  return success;
+}
+
+std::ostream& operator<<(std::ostream& os, const Results& results) {
+  os << "handshakes: " << results.handshakes_completed << " in "
+     << results.handshake_time << " (" << results.HandshakesPerSecond()
+     << "/s)\n";
+  os << "handshake latency: " << results.handshake_latency << "\n";
+  os << "requests: " << results.requests_completed << " in "
+     << results.transfer_time << " (" << results.RequestsPerSecond()
+     << "/s)\n";
+  os << "request latency: " << results.request_latency << "\n";
+  os << "goodput: " << results.GoodputBitsPerSecond() / 1e9 << " Gbit/s ("
+     << results.body_bytes_received << " body bytes, "
+     << results.bytes_received << " bytes, " << results.packets_received
+     << " packets received)\n";
+  os << "cpu: " << results.cpu_time << " in " << results.total_time << " ("
+     << results.CpuNanosPerByte() << " ns/byte, "
+     << results.CpuMillisPerGigabit() << " ms/Gbit, "
+     << results.CpuNanosPerPacket() << " ns/packet)\n";
+  return os;
+}
+
+}  // namespace quic
@@ -0,0 +1,116 @@
+// Copyright (c) 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Runs a QuicServer backed by a QuicMemoryCacheBackend and a set of QuicClients
+// in the same process, connected over loopback, and measures handshake rate,
+// request latency, throughput and CPU cost.  No network access is needed.
+
+#ifndef QUICHE_QUIC_TOOLS_QUIC_LOOPBACK_BENCHMARK_H_
+#define QUICHE_QUIC_TOOLS_QUIC_LOOPBACK_BENCHMARK_H_
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+#include "quic/core/quic_latency_histogram.h"
+#include "quic/core/quic_tag.h"
+#include "quic/core/quic_time.h"
+#include "quic/core/quic_types.h"
+#include "quic/core/quic_versions.h"
+#include "quic/platform/api/quic_export.h"
+
+namespace quic {
+
+class QUIC_EXPORT_PRIVATE QuicLoopbackBenchmark {
+ public:
+  // Packet writer used by the server.
+  enum class ServerWriter {
+    kDefault,   // QuicDefaultPacketWriter, one sendmsg() per packet.
+    kSendmmsg,  // QuicSendmmsgBatchWriter.
+    kGso,       // QuicGsoBatchWriter, UDP generic segmentation offload.
+    kIoUring,   // QuicIoUringBatchWriter, and an io_uring packet reader.
+    kZeroCopy,  // QuicZeroCopyBatchWriter, GSO with MSG_ZEROCOPY.
+  };
+
+  struct QUIC_EXPORT_PRIVATE Options {
+    ParsedQuicVersion version = ParsedQuicVersion::RFCv1();
+    // Number of client connections, all of which are established
+    // concurrently.
+    int num_connections = 1;
+    // Number of GET requests sent on each connection.  If zero, connections
+    // are closed as soon as the handshake is confirmed, which measures the
+    // handshake rate only.
+    int requests_per_connection = 100;
+    // Maximum number of requests outstanding at once on each connection.
+    int concurrent_streams_per_connection = 1;
+    // Size of each response body.
+    QuicByteCount response_size = 1024 * 1024;
+    // Connection options sent by the clients, e.g. kTBBR to use BBR.  The
+    // server applies the congestion control requested by the client.
+    QuicTagVector connection_options;
+    ServerWriter server_writer = ServerWriter::kDefault;
+    // Stream and session flow control windows advertised by both endpoints.
+    // If zero, the QuicServer and QuicClient defaults are used.
+    QuicByteCount stream_flow_control_window = 0;
+    QuicByteCount session_flow_control_window = 0;
+    // The run fails if it takes longer than this.
+    QuicTime::Delta timeout = QuicTime::Delta::FromSeconds(300);
+  };
+
+  struct QUIC_EXPORT_PRIVATE Results {
+    int handshakes_completed = 0;
+    // Wall time from the first connection attempt to the last confirmed
+    // handshake.
+    QuicTime::Delta handshake_time = QuicTime::Delta::Zero();
+    QuicLatencyHistogram handshake_latency;
+
+    uint64_t requests_completed = 0;
+    // Wall time from the first request to the last complete response.
+    QuicTime::Delta transfer_time = QuicTime::Delta::Zero();
+    QuicLatencyHistogram request_latency;
+    // Response body bytes received by all clients.
+    QuicByteCount body_bytes_received = 0;
+    // UDP payload bytes received by all clients, including headers and
+    // retransmissions.
+    QuicByteCount bytes_received = 0;
+    // UDP packets received by all clients.
+    QuicPacketCount packets_received = 0;
+
+    // User and system CPU time used by the whole process, i.e. by both the
+    // server and the clients, over the duration of the run.
+    QuicTime::Delta cpu_time = QuicTime::Delta::Zero();
+    QuicTime::Delta total_time = QuicTime::Delta::Zero();
+
+    double HandshakesPerSecond() const;
+    double RequestsPerSecond() const;
+    // Goodput, in bits per second of response body.
+    double GoodputBitsPerSecond() const;
+    // CPU nanoseconds spent per byte of response body.
+    double CpuNanosPerByte() const;
+    // CPU milliseconds spent per gigabit of response body.
+    double CpuMillisPerGigabit() const;
+    // CPU nanoseconds spent per packet received by the clients.
+    double CpuNanosPerPacket() const;
+  };
+
+  explicit QuicLoopbackBenchmark(const Options& options);
+  QuicLoopbackBenchmark(const QuicLoopbackBenchmark&) = delete;
+  QuicLoopbackBenchmark& operator=(const QuicLoopbackBenchmark&) = delete;
+
+  // Starts the server, runs all clients to completion and fills in |results|.
+  // Returns false and sets |error_details| if the server could not be
+  // started, or if a connection failed or the run timed out.
+  bool Run(Results* results, std::string* error_details);
+
+ private:
+  const Options options_;
+};
+
+QUIC_EXPORT_PRIVATE std::ostream& operator<<(
+    std::ostream& os,
+    const QuicLoopbackBenchmark::Results& results);
+
+}  // namespace quic
+
+#endif  // QUICHE_QUIC_TOOLS_QUIC_LOOPBACK_BENCHMARK_H_
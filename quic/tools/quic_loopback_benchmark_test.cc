@@ -0,0 +1,80 @@
+// Copyright (c) 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "quic/tools/quic_loopback_benchmark.h"
+
+#include <string>
+
+#include "quic/platform/api/quic_test.h"
+
+namespace quic {
+namespace test {
+namespace {
+
+class QuicLoopbackBenchmarkTest : public QuicTest {};
+
+TEST_F(QuicLoopbackBenchmarkTest, Requests) {
+  QuicLoopbackBenchmark::Options options;
+  options.num_connections = 2;
+  options.requests_per_connection = 5;
+  options.concurrent_streams_per_connection = 2;
+  options.response_size = 10000;
+  options.timeout = QuicTime::Delta::FromSeconds(30);
+
+  QuicLoopbackBenchmark benchmark(options);
+  QuicLoopbackBenchmark::Results results;
+  std::string error_details;
+  ASSERT_TRUE(benchmark.Run(&results, &error_details)) << error_details;
+
+  EXPECT_EQ(2, results.handshakes_completed);
+  EXPECT_EQ(2u, results.handshake_latency.total_count());
+  EXPECT_EQ(10u, results.requests_completed);
+  EXPECT_EQ(10u, results.request_latency.total_count());
+  EXPECT_EQ(100000u, results.body_bytes_received);
+  EXPECT_LT(results.body_bytes_received, results.bytes_received);
+  EXPECT_LT(0, results.RequestsPerSecond());
+  EXPECT_LT(0, results.GoodputBitsPerSecond());
+}
+
+TEST_F(QuicLoopbackBenchmarkTest, IoUringServer) {
+  // Falls back to the default reader and writer if io_uring is unavailable.
+  QuicLoopbackBenchmark::Options options;
+  options.num_connections = 2;
+  options.requests_per_connection = 3;
+  options.response_size = 100000;
+  options.server_writer = QuicLoopbackBenchmark::ServerWriter::kIoUring;
+  options.timeout = QuicTime::Delta::FromSeconds(30);
+
+  QuicLoopbackBenchmark benchmark(options);
+  QuicLoopbackBenchmark::Results results;
+  std::string error_details;
+  ASSERT_TRUE(benchmark.Run(&results, &error_details)) << error_details;
+
+  EXPECT_EQ(6u, results.requests_completed);
+  EXPECT_EQ(600000u, results.body_bytes_received);
+  EXPECT_LT(0u, results.packets_received);
+  EXPECT_LT(0, results.CpuNanosPerPacket());
+}
+
+TEST_F(QuicLoopbackBenchmarkTest, HandshakesOnly) {
+  QuicLoopbackBenchmark::Options options;
+  options.num_connections = 3;
+  options.requests_per_connection = 0;
+  options.timeout = QuicTime::Delta::FromSeconds(30);
+
+  QuicLoopbackBenchmark benchmark(options);
+  QuicLoopbackBenchmark::Results results;
+  std::string error_details;
+  ASSERT_TRUE(benchmark.Run(&results, &error_details)) << error_details;
+
+  EXPECT_EQ(3, results.handshakes_completed);
+  EXPECT_LT(0, results.HandshakesPerSecond());
+  EXPECT_EQ(0u, results.requests_completed);
+  EXPECT_TRUE(results.transfer_time.IsZero());
+  EXPECT_EQ(0, results.RequestsPerSecond());
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace quic
@@ -0,0 +1,100 @@
+// Copyright (c) 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "quic/tools/quic_mapped_file.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <utility>
+
+#include "quic/core/quic_buffer_allocator.h"
+#include "quic/platform/api/quic_bug_tracker.h"
+#include "quic/platform/api/quic_logging.h"
+
+namespace quic {
+
+namespace {
+
+// Holds a reference to a QuicMappedFile on behalf of a QuicMemSlice.  The
+// slice releases its buffer through Delete(), which drops the reference.
+class MappedSliceReference : public QuicBufferAllocator {
+ public:
+  explicit MappedSliceReference(std::shared_ptr<const QuicMappedFile> file)
+      : file_(std::move(file)) {}
+
+  char* New(size_t /*size*/) override {
+    QUIC_BUG(quic_bug_12977_1) << "Mapped file slices can't allocate.";
+    return nullptr;
+  }
+
+  char* New(size_t size, bool /*flag_enable*/) override { return New(size); }
+
+  void Delete(char* /*buffer*/) override { delete this; }
+
+ private:
+  std::shared_ptr<const QuicMappedFile> file_;
+};
+
+}  // namespace
+
+// static
+std::shared_ptr<QuicMappedFile> QuicMappedFile::Map(
+    const std::string& file_name) {
+  int fd = open(file_name.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    QUIC_LOG(ERROR) << "Failed to open " << file_name << ": "
+                    << strerror(errno);
+    return nullptr;
+  }
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0) {
+    QUIC_LOG(ERROR) << "Failed to stat " << file_name << ": "
+                    << strerror(errno);
+    close(fd);
+    return nullptr;
+  }
+  const size_t size = static_cast<size_t>(file_stat.st_size);
+  void* data = nullptr;
+  if (size > 0) {
+    data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) {
+      QUIC_LOG(ERROR) << "Failed to map " << file_name << ": "
+                      << strerror(errno);
+      close(fd);
+      return nullptr;
+    }
+  }
+  // The mapping stays valid after the file is closed.
+  close(fd);
+  return std::shared_ptr<QuicMappedFile>(
+      new QuicMappedFile(static_cast<const char*>(data), size));
+}
+
+QuicMappedFile::QuicMappedFile(const char* data, size_t size)
+    : data_(data), size_(size) {}
+
+QuicMappedFile::~QuicMappedFile() {
+  if (data_ != nullptr) {
+    munmap(const_cast<char*>(data_), size_);
+  }
+}
+
+QuicMemSlice QuicMappedFile::MakeSlice(absl::string_view data) const {
+  QUICHE_DCHECK(!data.empty());
+  QUICHE_DCHECK(data.data() >= data_ &&
+                data.data() + data.size() <= data_ + size_);
+  // The slice is never written to, QuicMemSlice only exposes const data.
+  return QuicMemSlice(
+      QuicUniqueBufferPtr(
+          const_cast<char*>(data.data()),
+          QuicBufferDeleter(new MappedSliceReference(shared_from_this()))),
+      data.size());
+}
+
+}  // namespace quic
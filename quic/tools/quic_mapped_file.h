@@ -0,0 +1,55 @@
+// Copyright (c) 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef QUICHE_QUIC_TOOLS_QUIC_MAPPED_FILE_H_
+#define QUICHE_QUIC_TOOLS_QUIC_MAPPED_FILE_H_
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+#include "absl/strings/string_view.h"
+#include "quic/platform/api/quic_export.h"
+#include "quic/platform/api/quic_mem_slice.h"
+
+namespace quic {
+
+// A read-only memory mapping of a file, used by QuicMemoryCacheBackend to
+// serve response bodies without reading them into memory.  The pages of the
+// file are only loaded when they are first accessed, and may be evicted by
+// the kernel under memory pressure.
+//
+// QuicMemSlices created by MakeSlice() hold a reference to the mapping, so the
+// file stays mapped until every stream which sent a part of it has released
+// its slice, i.e. until the data is acked or the stream is closed.
+class QUIC_EXPORT_PRIVATE QuicMappedFile
+    : public std::enable_shared_from_this<QuicMappedFile> {
+ public:
+  // Maps |file_name| into memory.  Returns nullptr on failure.
+  static std::shared_ptr<QuicMappedFile> Map(const std::string& file_name);
+
+  QuicMappedFile(const QuicMappedFile&) = delete;
+  QuicMappedFile& operator=(const QuicMappedFile&) = delete;
+  ~QuicMappedFile();
+
+  // The contents of the file.
+  absl::string_view contents() const {
+    return absl::string_view(data_, size_);
+  }
+
+  // Returns a QuicMemSlice referencing |data|, which must be a non-empty part
+  // of contents().  The slice keeps the file mapped until it is released.
+  QuicMemSlice MakeSlice(absl::string_view data) const;
+
+ private:
+  QuicMappedFile(const char* data, size_t size);
+
+  // Start of the mapping, or nullptr for an empty file, which can't be mapped.
+  const char* data_;
+  size_t size_;
+};
+
+}  // namespace quic
+
+#endif  // QUICHE_QUIC_TOOLS_QUIC_MAPPED_FILE_H_
@@ -0,0 +1,81 @@
+// Copyright (c) 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "quic/tools/quic_mapped_file.h"
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <memory>
+#include <string>
+
+#include "quic/platform/api/quic_test.h"
+
+namespace quic {
+namespace test {
+namespace {
+
+class QuicMappedFileTest : public QuicTest {
+ protected:
+  ~QuicMappedFileTest() override {
+    if (!file_name_.empty()) {
+      unlink(file_name_.c_str());
+    }
+  }
+
+  // Writes |contents| to a temporary file and returns its name.
+  const std::string& CreateFile(const std::string& contents) {
+    const char* tmp_dir = getenv("TEST_TMPDIR");
+    std::string file_template =
+        std::string(tmp_dir != nullptr ? tmp_dir : "/tmp") +
+        "/quic_mapped_file_test.XXXXXX";
+    int fd = mkstemp(&file_template[0]);
+    EXPECT_GE(fd, 0);
+    EXPECT_EQ(static_cast<ssize_t>(contents.size()),
+              write(fd, contents.data(), contents.size()));
+    close(fd);
+    file_name_ = file_template;
+    return file_name_;
+  }
+
+  std::string file_name_;
+};
+
+TEST_F(QuicMappedFileTest, Map) {
+  std::shared_ptr<QuicMappedFile> file =
+      QuicMappedFile::Map(CreateFile("hello mapped file"));
+  ASSERT_NE(nullptr, file);
+  EXPECT_EQ("hello mapped file", file->contents());
+}
+
+TEST_F(QuicMappedFileTest, MapEmptyFile) {
+  std::shared_ptr<QuicMappedFile> file = QuicMappedFile::Map(CreateFile(""));
+  ASSERT_NE(nullptr, file);
+  EXPECT_TRUE(file->contents().empty());
+}
+
+TEST_F(QuicMappedFileTest, MapMissingFile) {
+  EXPECT_EQ(nullptr, QuicMappedFile::Map("/nonexistent/quic_mapped_file"));
+}
+
+TEST_F(QuicMappedFileTest, SliceKeepsFileMapped) {
+  std::shared_ptr<QuicMappedFile> file =
+      QuicMappedFile::Map(CreateFile("headers\n\nbody"));
+  ASSERT_NE(nullptr, file);
+  std::weak_ptr<QuicMappedFile> weak_file = file;
+  QuicMemSlice slice = file->MakeSlice(file->contents().substr(9));
+  EXPECT_EQ(file->contents().data() + 9, slice.data());
+
+  // The slice still references the mapping after the file is released.
+  file.reset();
+  EXPECT_FALSE(weak_file.expired());
+  EXPECT_EQ("body", slice.AsStringView());
+
+  slice.Reset();
+  EXPECT_TRUE(weak_file.expired());
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace quic
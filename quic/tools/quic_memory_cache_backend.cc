@@ -36,21 +36,36 @@ void QuicMemoryCacheBackend::ResourceFile::Read() {
     return;
   }
   file_contents_ = *maybe_file_contents;
+  contents_ = file_contents_;
+  ParseContents();
+}
 
+void QuicMemoryCacheBackend::ResourceFile::Map() {
+  mapped_file_ = QuicMappedFile::Map(file_name_);
+  if (mapped_file_ == nullptr) {
+    QUIC_LOG(DFATAL) << "Failed to map file for the memory cache backend: "
+                     << file_name_;
+    return;
+  }
+  contents_ = mapped_file_->contents();
+  ParseContents();
+}
+
+void QuicMemoryCacheBackend::ResourceFile::ParseContents() {
   // First read the headers.
   size_t start = 0;
-  while (start < file_contents_.length()) {
-    size_t pos = file_contents_.find("\n", start);
+  while (start < contents_.length()) {
+    size_t pos = contents_.find("\n", start);
     if (pos == std::string::npos) {
       QUIC_LOG(DFATAL) << "Headers invalid or empty, ignoring: " << file_name_;
       return;
     }
     size_t len = pos - start;
     // Support both dos and unix line endings for convenience.
-    if (file_contents_[pos - 1] == '\r') {
+    if (contents_[pos - 1] == '\r') {
       len -= 1;
     }
-    absl::string_view line(file_contents_.data() + start, len);
+    absl::string_view line(contents_.data() + start, len);
     start = pos + 1;
     // Headers end with an empty line.
     if (line.empty()) {
@@ -107,8 +122,7 @@ void QuicMemoryCacheBackend::ResourceFile::Read() {
     }
   }
 
-  body_ = absl::string_view(file_contents_.data() + start,
-                            file_contents_.size() - start);
+  body_ = contents_.substr(start);
 }
 
 void QuicMemoryCacheBackend::ResourceFile::SetHostPathFromBase(
@@ -147,7 +161,7 @@ void QuicMemoryCacheBackend::ResourceFile::HandleXOriginalUrl() {
 
 const QuicBackendResponse* QuicMemoryCacheBackend::GetResponse(
     absl::string_view host, absl::string_view path) const {
-  QuicWriterMutexLock lock(&response_mutex_);
+  QuicReaderMutexLock lock(&response_mutex_);
 
   auto it = responses_.find(GetKey(host, path));
   if (it == responses_.end()) {
@@ -215,6 +229,20 @@ void QuicMemoryCacheBackend::AddResponse(absl::string_view host,
                   std::vector<spdy::Http2HeaderBlock>());
 }
 
+void QuicMemoryCacheBackend::AddMappedResponse(
+    absl::string_view host, absl::string_view path,
+    Http2HeaderBlock response_headers,
+    std::shared_ptr<const QuicMappedFile> file,
+    absl::string_view response_body) {
+  auto new_response = std::make_unique<QuicBackendResponse>();
+  new_response->set_response_type(QuicBackendResponse::REGULAR_RESPONSE);
+  new_response->set_headers(std::move(response_headers));
+  if (file != nullptr) {
+    new_response->set_mapped_body(std::move(file), response_body);
+  }
+  AddResponseToCache(host, path, std::move(new_response));
+}
+
 void QuicMemoryCacheBackend::AddResponseWithEarlyHints(
     absl::string_view host, absl::string_view path,
     spdy::Http2HeaderBlock response_headers, absl::string_view response_body,
@@ -275,10 +303,17 @@ bool QuicMemoryCacheBackend::InitializeBackend(
     }
 
     resource_file->SetHostPathFromBase(base);
-    resource_file->Read();
-
-    AddResponse(resource_file->host(), resource_file->path(),
-                resource_file->spdy_headers().Clone(), resource_file->body());
+    if (map_cache_files_) {
+      resource_file->Map();
+      AddMappedResponse(resource_file->host(), resource_file->path(),
+                        resource_file->spdy_headers().Clone(),
+                        resource_file->mapped_file(), resource_file->body());
+    } else {
+      resource_file->Read();
+      AddResponse(resource_file->host(), resource_file->path(),
+                  resource_file->spdy_headers().Clone(),
+                  resource_file->body());
+    }
 
     resource_files.push_back(std::move(resource_file));
   }
@@ -336,16 +371,10 @@ void QuicMemoryCacheBackend::FetchResponseFromBackend(
     quic_response = GetResponse(authority->second, path->second);
   }
 
-  std::string request_url;
-  if (authority != request_headers.end()) {
-    request_url = std::string(authority->second);
-  }
-  if (path != request_headers.end()) {
-    request_url += std::string(path->second);
-  }
   QUIC_DVLOG(1)
       << "Fetching QUIC response from backend in-memory cache for url "
-      << request_url;
+      << (authority != request_headers.end() ? authority->second : "")
+      << (path != request_headers.end() ? path->second : "");
   quic_stream->OnResponseBackendComplete(quic_response);
 }
 
@@ -408,6 +437,20 @@ void QuicMemoryCacheBackend::AddResponseImpl(
     SpecialResponseType response_type, Http2HeaderBlock response_headers,
     absl::string_view response_body, Http2HeaderBlock response_trailers,
     const std::vector<spdy::Http2HeaderBlock>& early_hints) {
+  auto new_response = std::make_unique<QuicBackendResponse>();
+  new_response->set_response_type(response_type);
+  new_response->set_headers(std::move(response_headers));
+  new_response->set_body(response_body);
+  new_response->set_trailers(std::move(response_trailers));
+  for (auto& headers : early_hints) {
+    new_response->AddEarlyHints(headers);
+  }
+  AddResponseToCache(host, path, std::move(new_response));
+}
+
+void QuicMemoryCacheBackend::AddResponseToCache(
+    absl::string_view host, absl::string_view path,
+    std::unique_ptr<QuicBackendResponse> response) {
   QuicWriterMutexLock lock(&response_mutex_);
 
   QUICHE_DCHECK(!host.empty())
@@ -418,25 +461,14 @@ void QuicMemoryCacheBackend::AddResponseImpl(
         << "Response for '" << key << "' already exists!";
     return;
   }
-  auto new_response = std::make_unique<QuicBackendResponse>();
-  new_response->set_response_type(response_type);
-  new_response->set_headers(std::move(response_headers));
-  new_response->set_body(response_body);
-  new_response->set_trailers(std::move(response_trailers));
-  for (auto& headers : early_hints) {
-    new_response->AddEarlyHints(headers);
-  }
   QUIC_DVLOG(1) << "Add response with key " << key;
-  responses_[key] = std::move(new_response);
+  responses_[key] = std::move(response);
 }
 
 std::string QuicMemoryCacheBackend::GetKey(absl::string_view host,
                                            absl::string_view path) const {
-  std::string host_string = std::string(host);
-  size_t port = host_string.find(':');
-  if (port != std::string::npos)
-    host_string = std::string(host_string.c_str(), port);
-  return host_string + std::string(path);
+  // Called for every request; builds the key with a single allocation.
+  return absl::StrCat(host.substr(0, host.find(':')), path);
 }
 
 void QuicMemoryCacheBackend::MaybeAddServerPushResources(
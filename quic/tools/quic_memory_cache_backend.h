@@ -16,6 +16,7 @@
 #include "quic/platform/api/quic_containers.h"
 #include "quic/platform/api/quic_mutex.h"
 #include "quic/tools/quic_backend_response.h"
+#include "quic/tools/quic_mapped_file.h"
 #include "quic/tools/quic_simple_server_backend.h"
 #include "quic/tools/quic_url.h"
 #include "spdy/core/spdy_framer.h"
@@ -40,6 +41,11 @@ class QuicMemoryCacheBackend : public QuicSimpleServerBackend {
 
     void Read();
 
+    // Like Read(), but maps the file into memory instead of reading it.  Only
+    // the pages holding the headers are loaded, the body is loaded on demand
+    // when it is sent.
+    void Map();
+
     // |base| is |file_name_| with |cache_directory| prefix stripped.
     void SetHostPathFromBase(absl::string_view base);
 
@@ -53,14 +59,24 @@ class QuicMemoryCacheBackend : public QuicSimpleServerBackend {
 
     absl::string_view body() { return body_; }
 
+    // The mapping created by Map(), or nullptr if the file was read.
+    const std::shared_ptr<QuicMappedFile>& mapped_file() {
+      return mapped_file_;
+    }
+
     const std::vector<absl::string_view>& push_urls() { return push_urls_; }
 
    private:
+    // Parses the headers in |contents_| and sets |body_| to the rest of it.
+    void ParseContents();
     void HandleXOriginalUrl();
     absl::string_view RemoveScheme(absl::string_view url);
 
     std::string file_name_;
     std::string file_contents_;
+    std::shared_ptr<QuicMappedFile> mapped_file_;
+    // Either |file_contents_| or the contents of |mapped_file_|.
+    absl::string_view contents_;
     absl::string_view body_;
     spdy::Http2HeaderBlock spdy_headers_;
     absl::string_view x_original_url_;
@@ -111,6 +127,14 @@ class QuicMemoryCacheBackend : public QuicSimpleServerBackend {
                    absl::string_view response_body,
                    spdy::Http2HeaderBlock response_trailers);
 
+  // Add a response whose body is a part of a memory mapped file.  The body is
+  // not copied, the response holds a reference to |file| instead.
+  void AddMappedResponse(absl::string_view host,
+                         absl::string_view path,
+                         spdy::Http2HeaderBlock response_headers,
+                         std::shared_ptr<const QuicMappedFile> file,
+                         absl::string_view response_body);
+
   // Add a response, with 103 Early Hints, to the cache.
   void AddResponseWithEarlyHints(
       absl::string_view host,
@@ -142,6 +166,14 @@ class QuicMemoryCacheBackend : public QuicSimpleServerBackend {
 
   void EnableWebTransport();
 
+  // If true, InitializeBackend() maps the cache files into memory rather than
+  // reading them, and responses are sent straight from the mappings.  This
+  // keeps large caches out of the heap and speeds up initialization, at the
+  // cost of page faults on the first requests for each file.
+  void set_map_cache_files(bool map_cache_files) {
+    map_cache_files_ = map_cache_files;
+  }
+
   // Find all the server push resources associated with |request_url|.
   // TODO(b/171463363): Remove.
   std::list<QuicBackendResponse::ServerPushInfo> GetServerPushResources(
@@ -171,6 +203,12 @@ class QuicMemoryCacheBackend : public QuicSimpleServerBackend {
                        spdy::Http2HeaderBlock response_trailers,
                        const std::vector<spdy::Http2HeaderBlock>& early_hints);
 
+  // Adds |response| to |responses_|, unless there is already a response for
+  // |host| and |path|.
+  void AddResponseToCache(absl::string_view host,
+                          absl::string_view path,
+                          std::unique_ptr<QuicBackendResponse> response);
+
   std::string GetKey(absl::string_view host, absl::string_view path) const;
 
   // Add some server push urls with given responses for specified
@@ -210,6 +248,7 @@ class QuicMemoryCacheBackend : public QuicSimpleServerBackend {
   bool cache_initialized_;
 
   bool enable_webtransport_ = false;
+  bool map_cache_files_ = false;
 };
 
 }  // namespace quic
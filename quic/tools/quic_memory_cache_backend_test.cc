@@ -89,6 +89,26 @@ TEST_F(QuicMemoryCacheBackendTest, ReadsCacheDir) {
   EXPECT_LT(0U, response->body().length());
 }
 
+TEST_F(QuicMemoryCacheBackendTest, MapsCacheDir) {
+  QuicMemoryCacheBackend read_cache;
+  read_cache.InitializeBackend(CacheDirectory());
+  cache_.set_map_cache_files(true);
+  cache_.InitializeBackend(CacheDirectory());
+
+  for (const char* path : {"/index.html", "/site_map.html"}) {
+    const Response* read_response =
+        read_cache.GetResponse("test.example.com", path);
+    const Response* mapped_response =
+        cache_.GetResponse("test.example.com", path);
+    ASSERT_TRUE(read_response);
+    ASSERT_TRUE(mapped_response);
+    EXPECT_EQ(nullptr, read_response->mapped_body_file());
+    EXPECT_NE(nullptr, mapped_response->mapped_body_file());
+    EXPECT_EQ(read_response->headers(), mapped_response->headers());
+    EXPECT_EQ(read_response->body(), mapped_response->body());
+  }
+}
+
 TEST_F(QuicMemoryCacheBackendTest, ReadsCacheDirWithServerPushResource) {
   cache_.InitializeBackend(CacheDirectory() + "_with_push");
   std::list<ServerPushInfo> resources =
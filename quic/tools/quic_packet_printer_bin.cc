@@ -129,6 +129,10 @@ class QuicPacketPrinter : public QuicFramerVisitorInterface {
               << timestamp.ToDebuggingValue() << ")";
     return true;
   }
+  bool OnAckEcnCounts(const QuicEcnCounts& ecn_counts) override {
+    std::cerr << "OnAckEcnCounts: " << ecn_counts;
+    return true;
+  }
   bool OnAckFrameEnd(QuicPacketNumber start) override {
     std::cerr << "OnAckFrameEnd, start: " << start;
     return true;
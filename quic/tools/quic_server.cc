@@ -15,6 +15,7 @@
 #include <memory>
 
 #include "quic/core/crypto/crypto_handshake.h"
+#include "quic/core/batch_writer/quic_io_uring_batch_writer.h"
 #include "quic/core/crypto/quic_random.h"
 #include "quic/core/quic_clock.h"
 #include "quic/core/quic_crypto_stream.h"
@@ -23,6 +24,7 @@
 #include "quic/core/quic_dispatcher.h"
 #include "quic/core/quic_epoll_alarm_factory.h"
 #include "quic/core/quic_epoll_connection_helper.h"
+#include "quic/core/quic_io_uring_packet_reader.h"
 #include "quic/core/quic_packet_reader.h"
 #include "quic/core/quic_packets.h"
 #include "quic/platform/api/quic_flags.h"
@@ -37,6 +39,8 @@ namespace quic {
 namespace {
 
 const int kEpollFlags = EPOLLIN | EPOLLOUT | EPOLLET;
+// io_uring fds are readable when completions are available.
+const int kIoUringEpollFlags = EPOLLIN | EPOLLET;
 const char kSourceAddressTokenSecret[] = "secret";
 
 }  // namespace
@@ -79,6 +83,9 @@ QuicServer::QuicServer(
       crypto_config_options_(crypto_config_options),
       version_manager_(supported_versions),
       packet_reader_(new QuicPacketReader()),
+      use_io_uring_(false),
+      io_uring_reader_(nullptr),
+      io_uring_writer_(nullptr),
       quic_simple_server_backend_(quic_simple_server_backend),
       expected_server_connection_id_length_(
           expected_server_connection_id_length) {
@@ -124,6 +131,7 @@ bool QuicServer::CreateUDPSocketAndListen(const QuicSocketAddress& address) {
 
   overflow_supported_ = socket_api.EnableDroppedPacketCount(fd_);
   socket_api.EnableReceiveTimestamp(fd_);
+  socket_api.EnableReceiveEcn(fd_, address.host().AddressFamilyToInt());
 
   sockaddr_storage addr = address.generic_address();
   int rc = bind(fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
@@ -142,13 +150,49 @@ bool QuicServer::CreateUDPSocketAndListen(const QuicSocketAddress& address) {
     port_ = address.port();
   }
 
-  epoll_server_.RegisterFD(fd_, this, kEpollFlags);
+  if (use_io_uring_ && !InitializeIoUring()) {
+    QUIC_LOG(WARNING) << "io_uring unavailable, falling back to recvmmsg";
+    use_io_uring_ = false;
+  }
   dispatcher_.reset(CreateQuicDispatcher());
-  dispatcher_->InitializeWithWriter(CreateWriter(fd_));
+  dispatcher_->set_network_params_cache(&network_params_cache_);
+  if (use_io_uring_) {
+    // The socket itself is only accessed through io_uring.
+    epoll_server_.RegisterFD(io_uring_reader_->ring_fd(), this,
+                             kIoUringEpollFlags);
+    epoll_server_.RegisterFD(io_uring_writer_->ring_fd(), this,
+                             kIoUringEpollFlags);
+    dispatcher_->InitializeWithWriter(io_uring_writer_);
+  } else {
+    epoll_server_.RegisterFD(fd_, this, kEpollFlags);
+    dispatcher_->InitializeWithWriter(CreateWriter(fd_));
+  }
+
+  return true;
+}
 
+bool QuicServer::InitializeIoUring() {
+  auto reader = std::make_unique<QuicIoUringPacketReader>();
+  auto writer = std::make_unique<QuicIoUringBatchWriter>(fd_);
+  if (!reader->Initialize(fd_) || !writer->Initialize()) {
+    return false;
+  }
+  io_uring_reader_ = reader.get();
+  packet_reader_ = std::move(reader);
+  io_uring_writer_ = writer.release();
   return true;
 }
 
+void QuicServer::FallBackToRecvmmsg() {
+  QUIC_LOG(WARNING) << "io_uring receive failed, falling back to recvmmsg";
+  epoll_server_.UnregisterFD(io_uring_reader_->ring_fd());
+  io_uring_reader_ = nullptr;
+  packet_reader_ = std::make_unique<QuicPacketReader>();
+  // Sends are still written with io_uring, and the writer's ring fd signals
+  // when it is unblocked, so only EPOLLIN is needed on the socket.
+  epoll_server_.RegisterFD(fd_, this, kIoUringEpollFlags);
+}
+
 QuicPacketWriter* QuicServer::CreateWriter(int fd) {
   return new QuicDefaultPacketWriter(fd);
 }
@@ -183,6 +227,14 @@ void QuicServer::Shutdown() {
     dispatcher_->Shutdown();
   }
 
+  if (io_uring_reader_ != nullptr) {
+    epoll_server_.UnregisterFD(io_uring_reader_->ring_fd());
+    io_uring_reader_ = nullptr;
+  }
+  if (io_uring_writer_ != nullptr) {
+    epoll_server_.UnregisterFD(io_uring_writer_->ring_fd());
+    io_uring_writer_ = nullptr;
+  }
   epoll_server_.Shutdown();
 
   close(fd_);
@@ -190,12 +242,23 @@ void QuicServer::Shutdown() {
 }
 
 void QuicServer::OnEvent(int fd, QuicEpollEvent* event) {
-  QUICHE_DCHECK_EQ(fd, fd_);
   event->out_ready_mask = 0;
 
+  if (io_uring_writer_ != nullptr && fd == io_uring_writer_->ring_fd()) {
+    // Sends completed, which may have unblocked the writer.
+    io_uring_writer_->ProcessCompletions();
+    if (dispatcher_->HasPendingWrites()) {
+      dispatcher_->OnCanWrite();
+    }
+    return;
+  }
+  QUICHE_DCHECK(fd == fd_ || (io_uring_reader_ != nullptr &&
+                              fd == io_uring_reader_->ring_fd()));
+
   if (event->in_events & EPOLLIN) {
     QUIC_DVLOG(1) << "EPOLLIN";
 
+    dispatcher_->OnEventLoopIterationStart();
     dispatcher_->ProcessBufferedChlos(kNumSessionsToCreatePerSocketEvent);
 
     bool more_to_read = true;
@@ -203,8 +266,15 @@ void QuicServer::OnEvent(int fd, QuicEpollEvent* event) {
       more_to_read = packet_reader_->ReadAndDispatchPackets(
           fd_, port_, QuicEpollClock(&epoll_server_), dispatcher_.get(),
           overflow_supported_ ? &packets_dropped_ : nullptr);
+      if (io_uring_reader_ != nullptr && io_uring_reader_->receive_failed()) {
+        FallBackToRecvmmsg();
+        // Read the packets already queued on the socket.
+        more_to_read = true;
+      }
     }
 
+    dispatcher_->OnEventLoopIterationEnd();
+
     if (dispatcher_->HasChlosBuffered()) {
       // Register EPOLLIN event to consume buffered CHLO(s).
       event->out_ready_mask |= EPOLLIN;
@@ -18,6 +18,7 @@
 #include "quic/core/quic_config.h"
 #include "quic/core/quic_epoll_connection_helper.h"
 #include "quic/core/quic_framer.h"
+#include "quic/core/quic_network_params_cache.h"
 #include "quic/core/quic_packet_writer.h"
 #include "quic/core/quic_udp_socket.h"
 #include "quic/core/quic_version_manager.h"
@@ -33,6 +34,8 @@ class QuicServerPeer;
 }  // namespace test
 
 class QuicDispatcher;
+class QuicIoUringBatchWriter;
+class QuicIoUringPacketReader;
 class QuicPacketReader;
 
 class QuicServer : public QuicSpdyServerBase,
@@ -85,6 +88,17 @@ class QuicServer : public QuicSpdyServerBase,
     crypto_config_.set_pre_shared_key(key);
   }
 
+  // If true, packets are read with a multishot io_uring receive and written
+  // with a QuicIoUringBatchWriter, which overrides CreateWriter().  Falls back
+  // to the default reader and writer if io_uring is unavailable, and to the
+  // default reader if the multishot receive fails later on.  Must be called
+  // before CreateUDPSocketAndListen().
+  void set_use_io_uring(bool use_io_uring) { use_io_uring_ = use_io_uring; }
+
+  // Whether io_uring is used, which may be false after
+  // CreateUDPSocketAndListen() even if it was requested.
+  bool use_io_uring() const { return use_io_uring_; }
+
   bool overflow_supported() { return overflow_supported_; }
 
   QuicPacketCount packets_dropped() { return packets_dropped_; }
@@ -121,6 +135,19 @@ class QuicServer : public QuicSpdyServerBase,
   // Initialize the internal state of the server.
   void Initialize();
 
+  // Creates the io_uring reader and writer for |fd_|.  Returns false if
+  // io_uring is unavailable.
+  bool InitializeIoUring();
+
+  // Replaces the io_uring reader with a QuicPacketReader, and registers |fd_|
+  // with the epoll server instead of the reader's ring fd.
+  void FallBackToRecvmmsg();
+
+  // Network parameters of recently closed connections per client prefix,
+  // used to seed new connections.  Declared before |dispatcher_| so that it
+  // outlives the sessions.
+  QuicNetworkParamsCache network_params_cache_;
+
   // Accepts data from the framer and demuxes clients to sessions.
   std::unique_ptr<QuicDispatcher> dispatcher_;
   // Frames incoming packets and hands them to the dispatcher.
@@ -160,6 +187,14 @@ class QuicServer : public QuicSpdyServerBase,
   // space than allowed on the stack.
   std::unique_ptr<QuicPacketReader> packet_reader_;
 
+  // Whether packets are read and written with io_uring.
+  bool use_io_uring_;
+  // Set if |use_io_uring_|, until Shutdown().  |io_uring_reader_| is owned by
+  // |packet_reader_|, and |io_uring_writer_| by the dispatcher.
+  // |io_uring_reader_| is also cleared by FallBackToRecvmmsg().
+  QuicIoUringPacketReader* io_uring_reader_;
+  QuicIoUringBatchWriter* io_uring_writer_;
+
   QuicSimpleServerBackend* quic_simple_server_backend_;  // unowned.
 
   // Connection ID length expected to be read on incoming IETF short headers.
@@ -65,6 +65,7 @@ std::unique_ptr<QuicSession> QuicSimpleDispatcher::CreateQuicSession(
   auto session = std::make_unique<QuicSimpleServerSession>(
       config(), GetSupportedVersions(), connection, this, session_helper(),
       crypto_config(), compressed_certs_cache(), quic_simple_server_backend_);
+  session->set_network_params_cache(network_params_cache());
   session->Initialize();
   return session;
 }
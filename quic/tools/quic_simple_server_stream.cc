@@ -11,13 +11,14 @@
 #include "absl/strings/numbers.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "quic/core/http/quic_spdy_stream.h"
-#include "quic/core/http/spdy_utils.h"
 #include "quic/core/http/web_transport_http3.h"
 #include "quic/core/quic_utils.h"
 #include "quic/platform/api/quic_bug_tracker.h"
 #include "quic/platform/api/quic_flags.h"
 #include "quic/platform/api/quic_logging.h"
+#include "quic/platform/api/quic_mem_slice.h"
 #include "quic/tools/quic_simple_server_session.h"
 #include "spdy/core/spdy_protocol.h"
 
@@ -32,9 +33,11 @@ QuicSimpleServerStream::QuicSimpleServerStream(
     QuicSimpleServerBackend* quic_simple_server_backend)
     : QuicSpdyServerStreamBase(id, session, type),
       content_length_(-1),
+      request_headers_sink_(&request_headers_),
       generate_bytes_length_(0),
       quic_simple_server_backend_(quic_simple_server_backend) {
   QUICHE_DCHECK(quic_simple_server_backend_);
+  set_initial_headers_sink(&request_headers_sink_);
 }
 
 QuicSimpleServerStream::QuicSimpleServerStream(
@@ -44,9 +47,11 @@ QuicSimpleServerStream::QuicSimpleServerStream(
     QuicSimpleServerBackend* quic_simple_server_backend)
     : QuicSpdyServerStreamBase(pending, session, type),
       content_length_(-1),
+      request_headers_sink_(&request_headers_),
       generate_bytes_length_(0),
       quic_simple_server_backend_(quic_simple_server_backend) {
   QUICHE_DCHECK(quic_simple_server_backend_);
+  set_initial_headers_sink(&request_headers_sink_);
 }
 
 QuicSimpleServerStream::~QuicSimpleServerStream() {
@@ -58,8 +63,9 @@ void QuicSimpleServerStream::OnInitialHeadersComplete(
     size_t frame_len,
     const QuicHeaderList& header_list) {
   QuicSpdyStream::OnInitialHeadersComplete(fin, frame_len, header_list);
-  if (!SpdyUtils::CopyAndValidateHeaders(header_list, &content_length_,
-                                         &request_headers_)) {
+  // QuicSpdyStream has already passed the headers to |request_headers_sink_|.
+  content_length_ = request_headers_sink_.content_length();
+  if (!request_headers_sink_.valid()) {
     QUIC_DVLOG(1) << "Invalid headers";
     SendErrorResponse();
   }
@@ -68,9 +74,8 @@ void QuicSimpleServerStream::OnInitialHeadersComplete(
     // CONNECT and other CONNECT-like methods (such as CONNECT-UDP) require
     // sending the response right after parsing the headers even though the FIN
     // bit has not been received on the request stream.
-    auto it = request_headers_.find(":method");
-    if (it != request_headers_.end() &&
-        absl::StartsWith(it->second, "CONNECT")) {
+    if (absl::StartsWith(request_headers_sink_.pseudo_headers().method,
+                         "CONNECT")) {
       SendResponse();
     }
   }
@@ -313,6 +318,7 @@ void QuicSimpleServerStream::OnResponseBackendComplete(
 
   QUIC_DVLOG(1) << "Stream " << id() << " sending response.";
   SendHeadersAndBodyAndTrailers(response->headers().Clone(), response->body(),
+                                response->mapped_body_file(),
                                 response->trailers().Clone());
 }
 
@@ -383,6 +389,16 @@ void QuicSimpleServerStream::SendHeadersAndBodyAndTrailers(
     Http2HeaderBlock response_headers,
     absl::string_view body,
     Http2HeaderBlock response_trailers) {
+  SendHeadersAndBodyAndTrailers(std::move(response_headers), body,
+                                /*body_file=*/nullptr,
+                                std::move(response_trailers));
+}
+
+void QuicSimpleServerStream::SendHeadersAndBodyAndTrailers(
+    Http2HeaderBlock response_headers,
+    absl::string_view body,
+    const QuicMappedFile* body_file,
+    Http2HeaderBlock response_trailers) {
   // Send the headers, with a FIN if there's nothing else to send.
   bool send_fin = (body.empty() && response_trailers.empty());
   QUIC_DLOG(INFO) << "Stream " << id() << " writing headers (fin = " << send_fin
@@ -399,7 +415,17 @@ void QuicSimpleServerStream::SendHeadersAndBodyAndTrailers(
   send_fin = response_trailers.empty();
   QUIC_DLOG(INFO) << "Stream " << id() << " writing body (fin = " << send_fin
                   << ") with size: " << body.size();
-  if (!body.empty() || send_fin) {
+  if (body_file != nullptr && !body.empty() &&
+      CanWriteNewBodyData(body.size())) {
+    // Send the body straight from the mapped file, which stays mapped until
+    // the stream releases the slice.
+    QuicMemSlice slice = body_file->MakeSlice(body);
+    QuicConsumedData consumed =
+        WriteBodySlices(absl::Span<QuicMemSlice>(&slice, 1), send_fin);
+    QUIC_BUG_IF(quic_bug_12978_1, consumed.bytes_consumed != body.size())
+        << "Stream " << id() << " only consumed " << consumed.bytes_consumed
+        << " of " << body.size() << " mapped body bytes";
+  } else if (!body.empty() || send_fin) {
     WriteOrBufferBody(body, send_fin);
   }
   if (send_fin) {
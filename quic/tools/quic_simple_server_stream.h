@@ -6,9 +6,11 @@
 #define QUICHE_QUIC_TOOLS_QUIC_SIMPLE_SERVER_STREAM_H_
 
 #include "absl/strings/string_view.h"
+#include "quic/core/http/quic_header_block_sink.h"
 #include "quic/core/http/quic_spdy_server_stream_base.h"
 #include "quic/core/quic_packets.h"
 #include "quic/tools/quic_backend_response.h"
+#include "quic/tools/quic_mapped_file.h"
 #include "quic/tools/quic_simple_server_backend.h"
 #include "spdy/core/spdy_framer.h"
 
@@ -82,6 +84,12 @@ class QuicSimpleServerStream : public QuicSpdyServerStreamBase,
   void SendHeadersAndBodyAndTrailers(spdy::Http2HeaderBlock response_headers,
                                      absl::string_view body,
                                      spdy::Http2HeaderBlock response_trailers);
+  // Like above, but if |body_file| is not null, |body| is a part of it and is
+  // sent without being copied into the stream's send buffer.
+  void SendHeadersAndBodyAndTrailers(spdy::Http2HeaderBlock response_headers,
+                                     absl::string_view body,
+                                     const QuicMappedFile* body_file,
+                                     spdy::Http2HeaderBlock response_trailers);
 
   spdy::Http2HeaderBlock* request_headers() { return &request_headers_; }
 
@@ -96,6 +104,8 @@ class QuicSimpleServerStream : public QuicSpdyServerStreamBase,
   std::string body_;
 
  private:
+  // Validates the request headers into |request_headers_| as they are decoded.
+  QuicHeaderBlockSink request_headers_sink_;
   uint64_t generate_bytes_length_;
   // Whether response headers have already been sent.
   bool response_sent_ = false;
@@ -4,17 +4,22 @@
 
 #include "quic/tools/quic_simple_server_stream.h"
 
+#include <stdlib.h>
+#include <unistd.h>
+
 #include <list>
 #include <memory>
 #include <utility>
 
 #include "absl/base/macros.h"
 #include "absl/memory/memory.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 #include "absl/types/optional.h"
 #include "quic/core/crypto/null_encrypter.h"
 #include "quic/core/http/http_encoder.h"
 #include "quic/core/http/spdy_utils.h"
+#include "quic/core/qpack/qpack_encoder.h"
 #include "quic/core/quic_error_codes.h"
 #include "quic/core/quic_simple_buffer_allocator.h"
 #include "quic/core/quic_types.h"
@@ -23,6 +28,7 @@
 #include "quic/platform/api/quic_socket_address.h"
 #include "quic/platform/api/quic_test.h"
 #include "quic/test_tools/crypto_test_utils.h"
+#include "quic/test_tools/qpack/qpack_test_utils.h"
 #include "quic/test_tools/quic_config_peer.h"
 #include "quic/test_tools/quic_connection_peer.h"
 #include "quic/test_tools/quic_session_peer.h"
@@ -30,6 +36,7 @@
 #include "quic/test_tools/quic_stream_peer.h"
 #include "quic/test_tools/quic_test_utils.h"
 #include "quic/tools/quic_backend_response.h"
+#include "quic/tools/quic_mapped_file.h"
 #include "quic/tools/quic_memory_cache_backend.h"
 #include "quic/tools/quic_simple_server_session.h"
 
@@ -286,6 +293,23 @@ class QuicSimpleServerStreamTest : public QuicTestWithParam<ParsedQuicVersion> {
     return VersionUsesHttp3(connection_->transport_version());
   }
 
+  // Returns a HEADERS frame with |headers| QPACK-encoded without using the
+  // dynamic table.
+  std::string HeadersFrame(const spdy::Http2HeaderBlock& headers) {
+    NoopQpackStreamSenderDelegate encoder_stream_sender_delegate;
+    QpackEncoder qpack_encoder(&session_);
+    qpack_encoder.set_qpack_stream_sender_delegate(
+        &encoder_stream_sender_delegate);
+    std::string payload = qpack_encoder.EncodeHeaderList(
+        /* stream_id = */ 0, headers, nullptr);
+    std::unique_ptr<char[]> frame_header;
+    QuicByteCount frame_header_length =
+        HttpEncoder::SerializeHeadersFrameHeader(payload.length(),
+                                                 &frame_header);
+    return absl::StrCat(
+        absl::string_view(frame_header.get(), frame_header_length), payload);
+  }
+
   spdy::Http2HeaderBlock response_headers_;
   MockQuicConnectionHelper helper_;
   MockAlarmFactory alarm_factory_;
@@ -523,6 +547,49 @@ TEST_P(QuicSimpleServerStreamTest, SendResponseWithValidHeaders) {
   EXPECT_TRUE(stream_->write_side_closed());
 }
 
+TEST_P(QuicSimpleServerStreamTest, SendMappedResponse) {
+  spdy::Http2HeaderBlock* request_headers = stream_->mutable_headers();
+  (*request_headers)[":path"] = "/bar";
+  (*request_headers)[":authority"] = "www.google.com";
+  (*request_headers)[":method"] = "GET";
+
+  response_headers_[":status"] = "200";
+  response_headers_["content-length"] = "5";
+  std::string body = "Yummm";
+
+  const char* tmp_dir = getenv("TEST_TMPDIR");
+  std::string file_name = std::string(tmp_dir != nullptr ? tmp_dir : "/tmp") +
+                          "/quic_simple_server_stream_test.XXXXXX";
+  int fd = mkstemp(&file_name[0]);
+  ASSERT_GE(fd, 0);
+  ASSERT_EQ(static_cast<ssize_t>(body.size()),
+            write(fd, body.data(), body.size()));
+  close(fd);
+  std::shared_ptr<QuicMappedFile> file = QuicMappedFile::Map(file_name);
+  unlink(file_name.c_str());
+  ASSERT_NE(nullptr, file);
+
+  QuicBuffer header = HttpEncoder::SerializeDataFrameHeader(
+      body.length(), SimpleBufferAllocator::Get());
+
+  memory_cache_backend_.AddMappedResponse("www.google.com", "/bar",
+                                          std::move(response_headers_), file,
+                                          file->contents());
+  QuicStreamPeer::SetFinReceived(stream_);
+
+  // The body is sent from the mapped file the same way as a copied body.
+  InSequence s;
+  EXPECT_CALL(*stream_, WriteHeadersMock(false));
+  if (UsesHttp3()) {
+    EXPECT_CALL(session_, WritevData(_, header.size(), _, NO_FIN, _, _));
+  }
+  EXPECT_CALL(session_, WritevData(_, body.length(), _, FIN, _, _));
+
+  stream_->DoSendResponse();
+  EXPECT_FALSE(QuicStreamPeer::read_side_closed(stream_));
+  EXPECT_TRUE(stream_->write_side_closed());
+}
+
 TEST_P(QuicSimpleServerStreamTest, SendResponseWithEarlyHints) {
   std::string host = "www.google.com";
   std::string request_path = "/foo";
@@ -750,6 +817,50 @@ TEST_P(QuicSimpleServerStreamTest, InvalidHeadersWithFin) {
   stream_->OnStreamFrame(frame);
 }
 
+// With HTTP/3, QPACK decodes the request headers straight into the header
+// block.
+TEST_P(QuicSimpleServerStreamTest, ReceiveHeadersFrame) {
+  if (!UsesHttp3()) {
+    return;
+  }
+
+  spdy::Http2HeaderBlock request_headers;
+  request_headers[":authority"] = "www.google.com";
+  request_headers[":path"] = "/";
+  request_headers[":method"] = "POST";
+  request_headers["content-length"] = "11";
+  stream_->OnStreamFrame(QuicStreamFrame(stream_->id(), /*fin=*/false,
+                                         /*offset=*/0,
+                                         HeadersFrame(request_headers)));
+
+  EXPECT_EQ(request_headers, *stream_->mutable_headers());
+  EXPECT_EQ(11, stream_->content_length());
+  EXPECT_FALSE(stream_->send_error_response_was_called());
+}
+
+TEST_P(QuicSimpleServerStreamTest, ReceiveHeadersFrameWithInvalidHeader) {
+  if (!UsesHttp3()) {
+    return;
+  }
+
+  EXPECT_CALL(session_, WritevData(_, _, _, _, _, _))
+      .WillRepeatedly(
+          Invoke(&session_, &MockQuicSimpleServerSession::ConsumeData));
+  spdy::Http2HeaderBlock request_headers;
+  request_headers[":authority"] = "www.google.com";
+  request_headers[":path"] = "/";
+  request_headers[":method"] = "GET";
+  // QUIC requires lower-case header names.
+  request_headers["InVaLiD-HeAdEr"] = "Well that's just wrong!";
+  EXPECT_CALL(*stream_, WriteHeadersMock(/*fin=*/false));
+  stream_->OnStreamFrame(QuicStreamFrame(stream_->id(), /*fin=*/true,
+                                         /*offset=*/0,
+                                         HeadersFrame(request_headers)));
+
+  EXPECT_TRUE(stream_->send_error_response_was_called());
+  EXPECT_TRUE(stream_->write_side_closed());
+}
+
 TEST_P(QuicSimpleServerStreamTest, ConnectSendsResponseBeforeFinReceived) {
   EXPECT_CALL(session_, WritevData(_, _, _, _, _, _))
       .WillRepeatedly(
@@ -26,6 +26,13 @@ DEFINE_QUIC_COMMAND_LINE_FLAG(
     "construction to seed the cache. Cache directory can be "
     "generated using `wget -p --save-headers <url>`");
 
+DEFINE_QUIC_COMMAND_LINE_FLAG(
+    bool,
+    map_response_cache_files,
+    false,
+    "If true, the files in --quic_response_cache_dir are memory mapped instead "
+    "of being read into memory, and responses are sent from the mappings.");
+
 DEFINE_QUIC_COMMAND_LINE_FLAG(
     bool,
     generate_dynamic_responses,
@@ -60,6 +67,8 @@ QuicToyServer::MemoryCacheBackendFactory::CreateBackend() {
     memory_cache_backend->GenerateDynamicResponses();
   }
   if (!GetQuicFlag(FLAGS_quic_response_cache_dir).empty()) {
+    memory_cache_backend->set_map_cache_files(
+        GetQuicFlag(FLAGS_map_response_cache_files));
     memory_cache_backend->InitializeBackend(
         GetQuicFlag(FLAGS_quic_response_cache_dir));
   }
@@ -53,7 +53,7 @@ class QUICHE_EXPORT_PRIVATE HpackEntry {
 
   // Getters for std::string members traditionally return const std::string&.
   // However, HpackHeaderTable uses string_view as keys in the maps
-  // static_name_index_ and dynamic_name_index_.  If HpackEntry::name() returned
+  // dynamic_index_ and dynamic_name_index_.  If HpackEntry::name() returned
   // const std::string&, then
   //   dynamic_name_index_.insert(std::make_pair(entry.name(), index));
   // would silently create a dangling reference: make_pair infers type from the
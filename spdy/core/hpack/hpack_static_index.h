@@ -0,0 +1,294 @@
+// Copyright (c) 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef QUICHE_SPDY_CORE_HPACK_HPACK_STATIC_INDEX_H_
+#define QUICHE_SPDY_CORE_HPACK_HPACK_STATIC_INDEX_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+#include "absl/strings/string_view.h"
+#include "common/platform/api/quiche_export.h"
+#include "common/platform/api/quiche_logging.h"
+#include "spdy/core/hpack/hpack_constants.h"
+
+namespace spdy {
+
+// Index of a static header table, such as the HPACK or the QPACK static table,
+// for looking up entries by name and value or by name.  The index is built at
+// compile time from a constexpr array of HpackStaticEntry, as two perfect hash
+// tables, so that a lookup hashes its key once, reads one slot and compares
+// one entry.
+//
+// The hash tables use hash and displace: keys are divided into buckets by one
+// part of their hash, and the keys of each bucket are mapped to distinct slots
+// by the rest of their hash and a displacement chosen for the bucket.
+class QUICHE_EXPORT_PRIVATE HpackStaticIndex {
+ public:
+  // Returned by lookups which find no entry.
+  static constexpr size_t kNotFound = std::numeric_limits<size_t>::max();
+  // Largest number of entries an index can have.
+  static constexpr size_t kMaxEntries = 128;
+
+  // |entries| must outlive the index.
+  constexpr HpackStaticIndex(const HpackStaticEntry* entries, size_t count)
+      : entries_(entries), count_(count) {
+    if (count_ > kMaxEntries) {
+      BuildFailed();
+    }
+    uint64_t entry_name_hashes[kMaxEntries] = {};
+    uint64_t name_value_hashes[kMaxEntries] = {};
+    uint64_t name_hashes[kMaxEntries] = {};
+    size_t name_value_keys[kMaxEntries] = {};
+    size_t name_keys[kMaxEntries] = {};
+    size_t name_value_key_count = 0;
+    size_t name_key_count = 0;
+    for (size_t i = 0; i < count_; ++i) {
+      const HpackStaticEntry& entry = entries_[i];
+      entry_name_hashes[i] = HashName(entry.name, entry.name_len);
+      bool name_seen = false;
+      bool name_value_seen = false;
+      for (size_t j = 0; j < i; ++j) {
+        if (entry_name_hashes[j] == entry_name_hashes[i] &&
+            Equal(entries_[j].name, entries_[j].name_len, entry.name,
+                  entry.name_len)) {
+          name_seen = true;
+          name_value_seen =
+              name_value_seen || Equal(entries_[j].value, entries_[j].value_len,
+                                       entry.value, entry.value_len);
+        }
+      }
+      // Lookups find the first entry with a given key.
+      if (!name_value_seen) {
+        name_value_hashes[name_value_key_count] = HashNameAndValue(
+            entry.name, entry.name_len, entry.value, entry.value_len);
+        name_value_keys[name_value_key_count++] = i;
+      }
+      if (!name_seen) {
+        name_hashes[name_key_count] = entry_name_hashes[i];
+        name_keys[name_key_count++] = i;
+      }
+    }
+    name_count_ = name_key_count;
+    BuildTable(name_value_hashes, name_value_keys, name_value_key_count,
+               name_value_table_);
+    BuildTable(name_hashes, name_keys, name_key_count, name_table_);
+  }
+
+  // Returns the index into the static table of the entry with |name| and
+  // |value|, or kNotFound if there is none.
+  size_t LookupNameAndValue(absl::string_view name,
+                            absl::string_view value) const {
+    const size_t index = Probe(
+        name_value_table_,
+        HashNameAndValue(name.data(), name.size(), value.data(), value.size()));
+    if (index == kNotFound) {
+      return kNotFound;
+    }
+    const HpackStaticEntry& entry = entries_[index];
+    return name == absl::string_view(entry.name, entry.name_len) &&
+                   value == absl::string_view(entry.value, entry.value_len)
+               ? index
+               : kNotFound;
+  }
+
+  // Returns the index into the static table of the first entry with |name|,
+  // or kNotFound if there is none.
+  size_t LookupName(absl::string_view name) const {
+    const size_t index =
+        Probe(name_table_, HashName(name.data(), name.size()));
+    if (index == kNotFound) {
+      return kNotFound;
+    }
+    const HpackStaticEntry& entry = entries_[index];
+    return name == absl::string_view(entry.name, entry.name_len) ? index
+                                                                 : kNotFound;
+  }
+
+  // Number of entries in the static table.
+  size_t size() const { return count_; }
+  // Number of distinct names in the static table.
+  size_t name_count() const { return name_count_; }
+
+ private:
+  // The load factor of the tables is at most one half, which leaves many
+  // displacements for each bucket to choose from.
+  static constexpr size_t kSlotCount = 2 * kMaxEntries;
+  static constexpr size_t kBucketCount = kMaxEntries / 2;
+  static constexpr size_t kMaxDisplacement =
+      std::numeric_limits<uint8_t>::max();
+
+  struct Table {
+    uint8_t displacements[kBucketCount] = {};
+    // One plus the index of the entry in each slot, or zero if it is empty.
+    uint8_t slots[kSlotCount] = {};
+  };
+
+  // Hashes are computed eight bytes at a time, with a multiply and shift per
+  // word, followed by the MurmurHash3 finalizer so that all bits of the result
+  // depend on all bytes of the key.  Lengths are hashed before the bytes they
+  // refer to, which separates the name from the value and lets the last word
+  // overlap the previous one.
+  static constexpr uint64_t kSeed = UINT64_C(0x243f6a8885a308d3);
+  static constexpr uint64_t kMultiplier = UINT64_C(0x9e3779b97f4a7c15);
+
+  static constexpr uint64_t Mix(uint64_t hash, uint64_t word) {
+    hash = (hash ^ word) * kMultiplier;
+    return hash ^ (hash >> 29);
+  }
+  static constexpr uint64_t Byte(const char* data, size_t offset) {
+    return static_cast<uint8_t>(data[offset]);
+  }
+  // Load32() and Load64() return bytes in little endian order.  Compilers turn
+  // them into single loads.
+  static constexpr uint64_t Load32(const char* data) {
+    return Byte(data, 0) | Byte(data, 1) << 8 | Byte(data, 2) << 16 |
+           Byte(data, 3) << 24;
+  }
+  static constexpr uint64_t Load64(const char* data) {
+    return Load32(data) | Load32(data + 4) << 32;
+  }
+  static constexpr uint64_t HashBytes(uint64_t hash,
+                                      const char* data,
+                                      size_t length) {
+    hash = Mix(hash, length);
+    if (length >= 8) {
+      const char* last_word = data + length - 8;
+      for (; data < last_word; data += 8) {
+        hash = Mix(hash, Load64(data));
+      }
+      return Mix(hash, Load64(last_word));
+    }
+    if (length >= 4) {
+      return Mix(hash, Load32(data) | Load32(data + length - 4) << 32);
+    }
+    if (length > 0) {
+      return Mix(hash, Byte(data, 0) | Byte(data, length / 2) << 8 |
+                           Byte(data, length - 1) << 16);
+    }
+    return hash;
+  }
+  static constexpr uint64_t Finish(uint64_t hash) {
+    hash ^= hash >> 33;
+    hash *= UINT64_C(0xff51afd7ed558ccd);
+    hash ^= hash >> 33;
+    hash *= UINT64_C(0xc4ceb9fe1a85ec53);
+    hash ^= hash >> 33;
+    return hash;
+  }
+  static constexpr uint64_t HashName(const char* name, size_t name_length) {
+    return Finish(HashBytes(kSeed, name, name_length));
+  }
+  static constexpr uint64_t HashNameAndValue(const char* name,
+                                             size_t name_length,
+                                             const char* value,
+                                             size_t value_length) {
+    return Finish(
+        HashBytes(HashBytes(kSeed, name, name_length), value, value_length));
+  }
+
+  static constexpr size_t Bucket(uint64_t hash) {
+    return (hash >> 32) % kBucketCount;
+  }
+  static constexpr size_t Slot(uint64_t hash, size_t displacement) {
+    return (static_cast<uint32_t>(hash) + displacement * ((hash >> 48) | 1)) %
+           kSlotCount;
+  }
+
+  static size_t Probe(const Table& table, uint64_t hash) {
+    const uint8_t slot =
+        table.slots[Slot(hash, table.displacements[Bucket(hash)])];
+    return static_cast<size_t>(slot) - 1;  // kNotFound if the slot is empty.
+  }
+
+  static constexpr bool Equal(const char* a,
+                              size_t a_length,
+                              const char* b,
+                              size_t b_length) {
+    if (a_length != b_length) {
+      return false;
+    }
+    for (size_t i = 0; i < a_length; ++i) {
+      if (a[i] != b[i]) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Places the |key_count| keys with |hashes| in |table|, where |keys| are
+  // the indices of their entries.  Buckets are placed from the largest, which
+  // are the hardest to place, to the smallest.
+  static constexpr void BuildTable(const uint64_t* hashes,
+                                   const size_t* keys,
+                                   size_t key_count,
+                                   Table& table) {
+    // Group the keys by bucket.
+    size_t bucket_starts[kBucketCount + 1] = {};
+    for (size_t k = 0; k < key_count; ++k) {
+      ++bucket_starts[Bucket(hashes[k]) + 1];
+    }
+    size_t max_bucket_size = 0;
+    for (size_t b = 0; b < kBucketCount; ++b) {
+      if (bucket_starts[b + 1] > max_bucket_size) {
+        max_bucket_size = bucket_starts[b + 1];
+      }
+      bucket_starts[b + 1] += bucket_starts[b];
+    }
+    size_t bucket_fill[kBucketCount] = {};
+    size_t keys_by_bucket[kMaxEntries] = {};
+    for (size_t k = 0; k < key_count; ++k) {
+      const size_t b = Bucket(hashes[k]);
+      keys_by_bucket[bucket_starts[b] + bucket_fill[b]++] = k;
+    }
+
+    for (size_t size = max_bucket_size; size > 0; --size) {
+      for (size_t b = 0; b < kBucketCount; ++b) {
+        const size_t begin = bucket_starts[b];
+        const size_t end = bucket_starts[b + 1];
+        if (end - begin != size) {
+          continue;
+        }
+        bool placed = false;
+        for (size_t d = 0; d <= kMaxDisplacement && !placed; ++d) {
+          placed = true;
+          for (size_t i = begin; i < end && placed; ++i) {
+            const size_t slot = Slot(hashes[keys_by_bucket[i]], d);
+            placed = table.slots[slot] == 0;
+            for (size_t j = begin; j < i && placed; ++j) {
+              placed = slot != Slot(hashes[keys_by_bucket[j]], d);
+            }
+          }
+          if (placed) {
+            table.displacements[b] = static_cast<uint8_t>(d);
+            for (size_t i = begin; i < end; ++i) {
+              const size_t k = keys_by_bucket[i];
+              table.slots[Slot(hashes[k], d)] =
+                  static_cast<uint8_t>(keys[k] + 1);
+            }
+          }
+        }
+        if (!placed) {
+          BuildFailed();
+        }
+      }
+    }
+  }
+
+  // Not constexpr, so that a table which cannot be indexed fails to compile.
+  static void BuildFailed() {
+    QUICHE_LOG(FATAL) << "Failed to build the index of a static table.";
+  }
+
+  const HpackStaticEntry* entries_;
+  size_t count_;
+  size_t name_count_ = 0;
+  Table name_value_table_;
+  Table name_table_;
+};
+
+}  // namespace spdy
+
+#endif  // QUICHE_SPDY_CORE_HPACK_HPACK_STATIC_INDEX_H_
@@ -0,0 +1,111 @@
+// Copyright (c) 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "spdy/core/hpack/hpack_static_index.h"
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/base/macros.h"
+#include "absl/strings/string_view.h"
+#include "common/platform/api/quiche_test.h"
+#include "spdy/core/hpack/hpack_constants.h"
+#include "spdy/core/hpack/hpack_static_table.h"
+
+namespace spdy {
+namespace test {
+namespace {
+
+#define STATIC_ENTRY(name, value) \
+  { name, ABSL_ARRAYSIZE(name) - 1, value, ABSL_ARRAYSIZE(value) - 1 }
+
+constexpr HpackStaticEntry kEntries[] = {
+    STATIC_ENTRY("foo", "bar"),  // 0
+    STATIC_ENTRY("foo", "baz"),  // 1
+    STATIC_ENTRY("foo", "bar"),  // 2
+    STATIC_ENTRY("", ""),        // 3
+    STATIC_ENTRY("fo", "obar"),  // 4
+};
+
+constexpr HpackStaticIndex kIndex(kEntries, ABSL_ARRAYSIZE(kEntries));
+
+#undef STATIC_ENTRY
+
+TEST(HpackStaticIndexTest, LookupFindsFirstEntry) {
+  EXPECT_EQ(ABSL_ARRAYSIZE(kEntries), kIndex.size());
+  EXPECT_EQ(3u, kIndex.name_count());
+
+  EXPECT_EQ(0u, kIndex.LookupNameAndValue("foo", "bar"));
+  EXPECT_EQ(1u, kIndex.LookupNameAndValue("foo", "baz"));
+  EXPECT_EQ(3u, kIndex.LookupNameAndValue("", ""));
+  EXPECT_EQ(4u, kIndex.LookupNameAndValue("fo", "obar"));
+
+  EXPECT_EQ(0u, kIndex.LookupName("foo"));
+  EXPECT_EQ(3u, kIndex.LookupName(""));
+  EXPECT_EQ(4u, kIndex.LookupName("fo"));
+}
+
+TEST(HpackStaticIndexTest, LookupMisses) {
+  EXPECT_EQ(HpackStaticIndex::kNotFound, kIndex.LookupNameAndValue("foo", ""));
+  EXPECT_EQ(HpackStaticIndex::kNotFound,
+            kIndex.LookupNameAndValue("foob", "ar"));
+  EXPECT_EQ(HpackStaticIndex::kNotFound, kIndex.LookupNameAndValue("", "foo"));
+  EXPECT_EQ(HpackStaticIndex::kNotFound, kIndex.LookupName("bar"));
+  EXPECT_EQ(HpackStaticIndex::kNotFound, kIndex.LookupName("foo "));
+  EXPECT_EQ(HpackStaticIndex::kNotFound, kIndex.LookupName("FOO"));
+}
+
+// Every entry of the HPACK static table is found, and every name is found at
+// its first entry.
+TEST(HpackStaticIndexTest, HpackStaticTable) {
+  const std::vector<HpackStaticEntry>& entries = HpackStaticTableVector();
+  const HpackStaticIndex& index = ObtainHpackStaticTable().GetStaticIndex();
+  ASSERT_EQ(entries.size(), index.size());
+
+  std::map<std::string, size_t> first_index_by_name;
+  for (size_t i = 0; i < entries.size(); ++i) {
+    const absl::string_view name(entries[i].name, entries[i].name_len);
+    const absl::string_view value(entries[i].value, entries[i].value_len);
+    EXPECT_EQ(i, index.LookupNameAndValue(name, value))
+        << name << ": " << value;
+    first_index_by_name.emplace(std::string(name), i);
+  }
+  EXPECT_EQ(first_index_by_name.size(), index.name_count());
+  for (const auto& name_and_index : first_index_by_name) {
+    EXPECT_EQ(name_and_index.second, index.LookupName(name_and_index.first))
+        << name_and_index.first;
+  }
+
+  EXPECT_EQ(HpackStaticIndex::kNotFound,
+            index.LookupNameAndValue(":method", "PUT"));
+  EXPECT_EQ(HpackStaticIndex::kNotFound, index.LookupName("x-forwarded-for"));
+}
+
+// The HPACK static table is the same as the one used by the HTTP/2 decoder.
+TEST(HpackStaticIndexTest, MatchesDecoderStaticTable) {
+  std::vector<std::pair<absl::string_view, absl::string_view>> spec_entries;
+
+#define STATIC_TABLE_ENTRY(name, value, index)                                 \
+  EXPECT_EQ(spec_entries.size() + 1, static_cast<size_t>(index));              \
+  spec_entries.emplace_back(name, value);
+
+#include "http2/hpack/hpack_static_table_entries.inc"
+
+#undef STATIC_TABLE_ENTRY
+
+  const std::vector<HpackStaticEntry>& entries = HpackStaticTableVector();
+  ASSERT_EQ(spec_entries.size(), entries.size());
+  for (size_t i = 0; i < entries.size(); ++i) {
+    EXPECT_EQ(spec_entries[i].first,
+              absl::string_view(entries[i].name, entries[i].name_len));
+    EXPECT_EQ(spec_entries[i].second,
+              absl::string_view(entries[i].value, entries[i].value_len));
+  }
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace spdy
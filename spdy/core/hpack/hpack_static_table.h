@@ -7,6 +7,7 @@
 
 #include "common/platform/api/quiche_export.h"
 #include "spdy/core/hpack/hpack_header_table.h"
+#include "spdy/core/hpack/hpack_static_index.h"
 
 namespace spdy {
 
@@ -18,16 +19,19 @@ constexpr size_t kStaticTableSize = 61;
 // HpackStaticTable provides |static_entries_| and |static_index_| for HPACK
 // encoding and decoding contexts.  Once initialized, an instance is read only
 // and may be accessed only through its const interface.  Such an instance may
-// be shared accross multiple HPACK contexts.
+// be shared accross multiple HPACK contexts.  The index is built at compile
+// time, so only the entries are built at runtime.
 class QUICHE_EXPORT_PRIVATE HpackStaticTable {
  public:
   HpackStaticTable();
   ~HpackStaticTable();
 
-  // Prepares HpackStaticTable by filling up static_entries_ and static_index_
-  // from an array of struct HpackStaticEntry.  Must be called exactly once.
+  // Prepares HpackStaticTable by filling up static_entries_ from an array of
+  // struct HpackStaticEntry, and setting static_index_ to |static_index|,
+  // which must index the same array.  Must be called exactly once.
   void Initialize(const HpackStaticEntry* static_entry_table,
-                  size_t static_entry_count);
+                  size_t static_entry_count,
+                  const HpackStaticIndex* static_index);
 
   // Returns whether Initialize() has been called.
   bool IsInitialized() const;
@@ -36,19 +40,11 @@ class QUICHE_EXPORT_PRIVATE HpackStaticTable {
   const HpackHeaderTable::StaticEntryTable& GetStaticEntries() const {
     return static_entries_;
   }
-  const HpackHeaderTable::NameValueToEntryMap& GetStaticIndex() const {
-    return static_index_;
-  }
-  const HpackHeaderTable::NameToEntryMap& GetStaticNameIndex() const {
-    return static_name_index_;
-  }
+  const HpackStaticIndex& GetStaticIndex() const { return *static_index_; }
 
  private:
   HpackHeaderTable::StaticEntryTable static_entries_;
-  // The following two members have string_views that point to strings stored in
-  // |static_entries_|.
-  HpackHeaderTable::NameValueToEntryMap static_index_;
-  HpackHeaderTable::NameToEntryMap static_name_index_;
+  const HpackStaticIndex* static_index_ = nullptr;
 };
 
 }  // namespace spdy
@@ -10,6 +10,7 @@
 #include "absl/strings/string_view.h"
 #include "common/platform/api/quiche_test.h"
 #include "spdy/core/hpack/hpack_constants.h"
+#include "spdy/core/hpack/hpack_static_index.h"
 
 namespace spdy {
 
@@ -27,26 +28,25 @@ class HpackStaticTableTest : public QuicheTest {
 // Check that an initialized instance has the right number of entries.
 TEST_F(HpackStaticTableTest, Initialize) {
   EXPECT_FALSE(table_.IsInitialized());
+  const HpackStaticIndex& index = ObtainHpackStaticTable().GetStaticIndex();
   table_.Initialize(HpackStaticTableVector().data(),
-                    HpackStaticTableVector().size());
+                    HpackStaticTableVector().size(), &index);
   EXPECT_TRUE(table_.IsInitialized());
 
   const HpackHeaderTable::StaticEntryTable& static_entries =
       table_.GetStaticEntries();
   EXPECT_EQ(kStaticTableSize, static_entries.size());
 
-  const HpackHeaderTable::NameValueToEntryMap& static_index =
-      table_.GetStaticIndex();
+  const HpackStaticIndex& static_index = table_.GetStaticIndex();
+  EXPECT_EQ(&index, &static_index);
   EXPECT_EQ(kStaticTableSize, static_index.size());
 
-  const HpackHeaderTable::NameToEntryMap& static_name_index =
-      table_.GetStaticNameIndex();
   // Count distinct names in static table.
   std::set<absl::string_view> names;
   for (const auto& entry : static_entries) {
     names.insert(entry.name());
   }
-  EXPECT_EQ(names.size(), static_name_index.size());
+  EXPECT_EQ(names.size(), static_index.name_count());
 }
 
 // Test that ObtainHpackStaticTable returns the same instance every time.